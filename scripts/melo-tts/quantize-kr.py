@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# Copyright    2025  Xiaomi Corp.
+
+"""
+Convert the MeloTTS Korean model and its BERT model (ja_bert) to int8 and
+float16.
+
+Usage:
+
+  ./quantize-kr.py \
+    --model ./model_korean_ja_bert.onnx \
+    --ja-bert-model ./ja_bert.onnx
+
+It generates the following files in the directory of each model:
+
+  - <name>.int8.onnx   dynamically quantized, float32 inputs and outputs
+  - <name>.fp16.onnx   float16 weights and computation
+
+Meta data of the original model, e.g., is_melo_tts, language, add_blank,
+is copied to the converted models, with an extra key "precision".
+
+Use --fp16-keep-io-types=0 to also convert the float inputs and outputs
+to float16. sherpa-onnx converts them on the fly, so you can save the
+casts at the boundary of the model if your hardware supports float16.
+
+A mixed precision setup, e.g., the int8 BERT with the fp16 VITS model, can
+be compared with ./bin/sherpa-onnx-offline-tts-precision-benchmark
+"""
+
+import argparse
+from pathlib import Path
+
+import onnx
+from onnxruntime.quantization import QuantType, quantize_dynamic
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+
+    parser.add_argument(
+        "--model",
+        type=str,
+        default="",
+        help="Path to the MeloTTS Korean model",
+    )
+
+    parser.add_argument(
+        "--ja-bert-model",
+        type=str,
+        default="",
+        help="Path to the BERT model of MeloTTS Korean",
+    )
+
+    parser.add_argument(
+        "--fp16-keep-io-types",
+        type=int,
+        default=1,
+        help="1 to keep float32 inputs and outputs in the fp16 models",
+    )
+
+    return parser.parse_args()
+
+
+# Ops that must stay in float32 in the fp16 VITS model.
+#
+# The random ops sample the noise of the flow and the duration predictor.
+# The others compute the alignment from durations, where float16 is not
+# precise enough for long sentences.
+FP16_OP_BLOCK_LIST = [
+    "RandomNormalLike",
+    "RandomUniformLike",
+    "RandomNormal",
+    "RandomUniform",
+    "Range",
+    "CumSum",
+    "Ceil",
+    "Exp",
+    "Softplus",
+]
+
+
+def copy_meta_data(src: str, dst: str, precision: str):
+    meta_data = {m.key: m.value for m in onnx.load(src).metadata_props}
+    meta_data["precision"] = precision
+
+    model = onnx.load(dst)
+    while len(model.metadata_props):
+        model.metadata_props.pop()
+
+    for key, value in meta_data.items():
+        meta = model.metadata_props.add()
+        meta.key = key
+        meta.value = str(value)
+
+    onnx.save(model, dst)
+
+
+def export_int8(filename: Path):
+    dst = str(filename.with_suffix(".int8.onnx"))
+    quantize_dynamic(
+        model_input=str(filename),
+        model_output=dst,
+        # Conv layers of the decoder are kept in float32. ConvInteger
+        # is slow on most CPUs and hurts the quality of the audio.
+        op_types_to_quantize=["MatMul", "Gemm", "Attention"],
+        weight_type=QuantType.QUInt8,
+    )
+    copy_meta_data(str(filename), dst, "int8")
+    print(f"Saved to {dst}")
+
+
+def export_fp16(filename: Path, keep_io_types: bool, op_block_list):
+    from onnxconverter_common import float16
+
+    dst = str(filename.with_suffix(".fp16.onnx"))
+    model = onnx.load(str(filename))
+    model = float16.convert_float_to_float16(
+        model,
+        keep_io_types=keep_io_types,
+        op_block_list=op_block_list,
+    )
+    onnx.save(model, dst)
+    copy_meta_data(str(filename), dst, "fp16")
+    print(f"Saved to {dst}")
+
+
+def main():
+    args = get_args()
+    print(vars(args))
+
+    if not args.model and not args.ja_bert_model:
+        raise ValueError("Please provide --model and/or --ja-bert-model")
+
+    keep_io_types = bool(args.fp16_keep_io_types)
+
+    if args.model:
+        filename = Path(args.model)
+        if not filename.is_file():
+            raise ValueError(f"{filename} does not exist")
+
+        export_int8(filename)
+        export_fp16(filename, keep_io_types, FP16_OP_BLOCK_LIST)
+
+    if args.ja_bert_model:
+        filename = Path(args.ja_bert_model)
+        if not filename.is_file():
+            raise ValueError(f"{filename} does not exist")
+
+        export_int8(filename)
+        # Inputs of BERT are int64, so only its output is affected by
+        # keep_io_types
+        export_fp16(filename, keep_io_types, [])
+
+
+if __name__ == "__main__":
+    main()
@@ -32,6 +32,7 @@
 #include "sherpa-onnx/csrc/speaker-embedding-manager.h"
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
@@ -60,6 +61,32 @@ struct SherpaOnnxDisplay {
 
 #define SHERPA_ONNX_OR(x, y) (x ? x : y)
 
+// config can be NULL, in which case the default options are returned.
+static sherpa_onnx::SessionConfig GetSessionConfig(
+    const SherpaOnnxSessionConfig *p) {
+  sherpa_onnx::SessionConfig ans;
+  if (!p) {
+    return ans;
+  }
+
+  const SherpaOnnxSessionConfig &config = *p;
+  ans.graph_optimization_level =
+      SHERPA_ONNX_OR(config.graph_optimization_level, "all");
+  if (ans.graph_optimization_level.empty()) {
+    ans.graph_optimization_level = "all";
+  }
+
+  ans.optimized_model_cache_dir =
+      SHERPA_ONNX_OR(config.optimized_model_cache_dir, "");
+  ans.intra_op_num_threads = config.intra_op_num_threads;
+  ans.inter_op_num_threads = config.inter_op_num_threads;
+  ans.allow_spinning = !config.disable_spinning;
+  ans.thread_affinity = SHERPA_ONNX_OR(config.thread_affinity, "");
+  ans.profile_prefix = SHERPA_ONNX_OR(config.profile_prefix, "");
+
+  return ans;
+}
+
 static sherpa_onnx::OnlineRecognizerConfig GetOnlineRecognizerConfig(
     const SherpaOnnxOnlineRecognizerConfig *config) {
   sherpa_onnx::OnlineRecognizerConfig recognizer_config;
@@ -101,6 +128,7 @@ static sherpa_onnx::OnlineRecognizerConfig GetOnlineRecognizerConfig(
     recognizer_config.model_config.provider_config.provider = "cpu";
   }
 
+
   recognizer_config.model_config.model_type =
       SHERPA_ONNX_OR(config->model_config.model_type, "");
   recognizer_config.model_config.debug =
@@ -175,8 +203,17 @@ static sherpa_onnx::OnlineRecognizerConfig GetOnlineRecognizerConfig(
 
 const SherpaOnnxOnlineRecognizer *SherpaOnnxCreateOnlineRecognizer(
     const SherpaOnnxOnlineRecognizerConfig *config) {
+  return SherpaOnnxCreateOnlineRecognizerWithSessionConfig(config, nullptr);
+}
+
+const SherpaOnnxOnlineRecognizer *
+SherpaOnnxCreateOnlineRecognizerWithSessionConfig(
+    const SherpaOnnxOnlineRecognizerConfig *config,
+    const SherpaOnnxSessionConfig *session_config) {
   sherpa_onnx::OnlineRecognizerConfig recognizer_config =
       GetOnlineRecognizerConfig(config);
+  recognizer_config.model_config.provider_config.session_config =
+      GetSessionConfig(session_config);
 
   if (!recognizer_config.Validate()) {
     SHERPA_ONNX_LOGE("Errors in config!");
@@ -434,6 +471,7 @@ static sherpa_onnx::OfflineRecognizerConfig GetOfflineRecognizerConfig(
     recognizer_config.model_config.provider = "cpu";
   }
 
+
   recognizer_config.model_config.model_type =
       SHERPA_ONNX_OR(config->model_config.model_type, "");
   recognizer_config.model_config.modeling_unit =
@@ -524,8 +562,17 @@ static sherpa_onnx::OfflineRecognizerConfig GetOfflineRecognizerConfig(
 
 const SherpaOnnxOfflineRecognizer *SherpaOnnxCreateOfflineRecognizer(
     const SherpaOnnxOfflineRecognizerConfig *config) {
+  return SherpaOnnxCreateOfflineRecognizerWithSessionConfig(config, nullptr);
+}
+
+const SherpaOnnxOfflineRecognizer *
+SherpaOnnxCreateOfflineRecognizerWithSessionConfig(
+    const SherpaOnnxOfflineRecognizerConfig *config,
+    const SherpaOnnxSessionConfig *session_config) {
   sherpa_onnx::OfflineRecognizerConfig recognizer_config =
       GetOfflineRecognizerConfig(config);
+  recognizer_config.model_config.session_config =
+      GetSessionConfig(session_config);
 
   if (!recognizer_config.Validate()) {
     SHERPA_ONNX_LOGE("Errors in config");
@@ -752,6 +799,7 @@ static sherpa_onnx::KeywordSpotterConfig GetKeywordSpotterConfig(
     spotter_config.model_config.provider_config.provider = "cpu";
   }
 
+
   spotter_config.model_config.model_type =
       SHERPA_ONNX_OR(config->model_config.model_type, "");
   spotter_config.model_config.debug =
@@ -786,7 +834,16 @@ static sherpa_onnx::KeywordSpotterConfig GetKeywordSpotterConfig(
 
 const SherpaOnnxKeywordSpotter *SherpaOnnxCreateKeywordSpotter(
     const SherpaOnnxKeywordSpotterConfig *config) {
+  return SherpaOnnxCreateKeywordSpotterWithSessionConfig(config, nullptr);
+}
+
+const SherpaOnnxKeywordSpotter *
+SherpaOnnxCreateKeywordSpotterWithSessionConfig(
+    const SherpaOnnxKeywordSpotterConfig *config,
+    const SherpaOnnxSessionConfig *session_config) {
   auto spotter_config = GetKeywordSpotterConfig(config);
+  spotter_config.model_config.provider_config.session_config =
+      GetSessionConfig(session_config);
   if (!spotter_config.Validate()) {
     SHERPA_ONNX_LOGE("Errors in config!");
     return nullptr;
@@ -1172,6 +1229,7 @@ static sherpa_onnx::OfflineTtsConfig GetOfflineTtsConfig(
     tts_config.model.provider = "cpu";
   }
 
+
   tts_config.rule_fsts = SHERPA_ONNX_OR(config->rule_fsts, "");
   tts_config.rule_fars = SHERPA_ONNX_OR(config->rule_fars, "");
   tts_config.max_num_sentences = SHERPA_ONNX_OR(config->max_num_sentences, 1);
@@ -1190,7 +1248,14 @@ static sherpa_onnx::OfflineTtsConfig GetOfflineTtsConfig(
 
 const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
     const SherpaOnnxOfflineTtsConfig *config) {
+  return SherpaOnnxCreateOfflineTtsWithSessionConfig(config, nullptr);
+}
+
+const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTtsWithSessionConfig(
+    const SherpaOnnxOfflineTtsConfig *config,
+    const SherpaOnnxSessionConfig *session_config) {
   auto tts_config = GetOfflineTtsConfig(config);
+  tts_config.model.session_config = GetSessionConfig(session_config);
 
   if (!tts_config.Validate()) {
     SHERPA_ONNX_LOGE("Errors in config");
@@ -1216,17 +1281,29 @@ int32_t SherpaOnnxOfflineTtsNumSpeakers(const SherpaOnnxOfflineTts *tts) {
   return tts->impl->NumSpeakers();
 }
 
+struct SherpaOnnxOfflineTtsCancellationToken {
+  std::shared_ptr<sherpa_onnx::OfflineTtsCancellationToken> impl;
+};
+
+// The trace is not a member of SherpaOnnxGeneratedAudio so that the layout
+// of the public struct is not changed.
+struct SherpaOnnxGeneratedAudioWithTrace : public SherpaOnnxGeneratedAudio {
+  std::string trace;
+};
+
 static const SherpaOnnxGeneratedAudio *SherpaOnnxOfflineTtsGenerateInternal(
     const SherpaOnnxOfflineTts *tts, const char *text, int32_t sid, float speed,
-    std::function<int32_t(const float *, int32_t, float)> callback) {
+    std::function<int32_t(const float *, int32_t, float)> callback,
+    const sherpa_onnx::OfflineTtsRequestOptions *options = nullptr) {
   sherpa_onnx::GeneratedAudio audio =
-      tts->impl->Generate(text, sid, speed, callback);
+      options ? tts->impl->Generate(text, sid, speed, callback, *options)
+              : tts->impl->Generate(text, sid, speed, callback);
 
   if (audio.samples.empty()) {
     return nullptr;
   }
 
-  SherpaOnnxGeneratedAudio *ans = new SherpaOnnxGeneratedAudio;
+  auto ans = new SherpaOnnxGeneratedAudioWithTrace;
 
   float *samples = new float[audio.samples.size()];
   std::copy(audio.samples.begin(), audio.samples.end(), samples);
@@ -1234,6 +1311,7 @@ static const SherpaOnnxGeneratedAudio *SherpaOnnxOfflineTtsGenerateInternal(
   ans->samples = samples;
   ans->n = audio.samples.size();
   ans->sample_rate = audio.sample_rate;
+  ans->trace = std::move(audio.trace);
 
   return ans;
 }
@@ -1291,8 +1369,66 @@ void SherpaOnnxDestroyOfflineTtsGeneratedAudio(
     const SherpaOnnxGeneratedAudio *p) {
   if (p) {
     delete[] p->samples;
-    delete p;
+    delete static_cast<const SherpaOnnxGeneratedAudioWithTrace *>(p);
+  }
+}
+
+const char *SherpaOnnxGeneratedAudioGetTrace(
+    const SherpaOnnxGeneratedAudio *p) {
+  return static_cast<const SherpaOnnxGeneratedAudioWithTrace *>(p)
+      ->trace.c_str();
+}
+
+const SherpaOnnxOfflineTtsCancellationToken *
+SherpaOnnxCreateOfflineTtsCancellationToken() {
+  auto token = new SherpaOnnxOfflineTtsCancellationToken;
+  token->impl = std::make_shared<sherpa_onnx::OfflineTtsCancellationToken>();
+  return token;
+}
+
+void SherpaOnnxDestroyOfflineTtsCancellationToken(
+    const SherpaOnnxOfflineTtsCancellationToken *token) {
+  // Running requests hold their own reference to the token
+  delete token;
+}
+
+void SherpaOnnxOfflineTtsCancel(
+    const SherpaOnnxOfflineTtsCancellationToken *token) {
+  if (token) {
+    token->impl->Cancel();
+  }
+}
+
+int32_t SherpaOnnxOfflineTtsIsCancelled(
+    const SherpaOnnxOfflineTtsCancellationToken *token) {
+  return token && token->impl->IsCancelled();
+}
+
+const SherpaOnnxGeneratedAudio *SherpaOnnxOfflineTtsGenerateWithOptions(
+    const SherpaOnnxOfflineTts *tts, const char *text, int32_t sid, float speed,
+    const SherpaOnnxOfflineTtsRequestOptions *options,
+    SherpaOnnxGeneratedAudioProgressCallbackWithArg callback, void *arg) {
+  sherpa_onnx::OfflineTtsRequestOptions request_options;
+  if (options) {
+    request_options.priority =
+        options->priority == 1 ? sherpa_onnx::OfflineTtsPriority::kBatch
+                               : sherpa_onnx::OfflineTtsPriority::kInteractive;
+    request_options.SetTimeout(options->timeout_ms);
+    if (options->cancellation) {
+      request_options.cancellation = options->cancellation->impl;
+    }
+  }
+
+  std::function<int32_t(const float *, int32_t, float)> wrapper;
+  if (callback) {
+    wrapper = [callback, arg](const float *samples, int32_t n,
+                              float progress) {
+      return callback(samples, n, progress, arg);
+    };
   }
+
+  return SherpaOnnxOfflineTtsGenerateInternal(tts, text, sid, speed, wrapper,
+                                              &request_options);
 }
 #else
 const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
@@ -1301,6 +1437,13 @@ const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
   return nullptr;
 }
 
+const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTtsWithSessionConfig(
+    const SherpaOnnxOfflineTtsConfig *config,
+    const SherpaOnnxSessionConfig *session_config) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
 void SherpaOnnxDestroyOfflineTts(const SherpaOnnxOfflineTts *tts) {
   SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
 }
@@ -1357,6 +1500,42 @@ void SherpaOnnxDestroyOfflineTtsGeneratedAudio(
   SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
 }
 
+const char *SherpaOnnxGeneratedAudioGetTrace(
+    const SherpaOnnxGeneratedAudio *p) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return "";
+}
+
+const SherpaOnnxOfflineTtsCancellationToken *
+SherpaOnnxCreateOfflineTtsCancellationToken() {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
+void SherpaOnnxDestroyOfflineTtsCancellationToken(
+    const SherpaOnnxOfflineTtsCancellationToken *token) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+}
+
+void SherpaOnnxOfflineTtsCancel(
+    const SherpaOnnxOfflineTtsCancellationToken *token) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+}
+
+int32_t SherpaOnnxOfflineTtsIsCancelled(
+    const SherpaOnnxOfflineTtsCancellationToken *token) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return 0;
+}
+
+const SherpaOnnxGeneratedAudio *SherpaOnnxOfflineTtsGenerateWithOptions(
+    const SherpaOnnxOfflineTts *tts, const char *text, int32_t sid, float speed,
+    const SherpaOnnxOfflineTtsRequestOptions *options,
+    SherpaOnnxGeneratedAudioProgressCallbackWithArg callback, void *arg) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
 #endif  // SHERPA_ONNX_ENABLE_TTS == 1
 
 int32_t SherpaOnnxWriteWave(const float *samples, int32_t n,
@@ -1471,11 +1650,8 @@ SherpaOnnxSpokenLanguageIdentificationCreateOfflineStream(
   return stream;
 }
 
-const SherpaOnnxSpokenLanguageIdentificationResult *
-SherpaOnnxSpokenLanguageIdentificationCompute(
-    const SherpaOnnxSpokenLanguageIdentification *slid,
-    const SherpaOnnxOfflineStream *s) {
-  std::string lang = slid->impl->Compute(s->impl.get());
+static const SherpaOnnxSpokenLanguageIdentificationResult *
+ToSpokenLanguageIdentificationResult(const std::string &lang) {
   char *c_lang = new char[lang.size() + 1];
   std::copy(lang.begin(), lang.end(), c_lang);
   c_lang[lang.size()] = '\0';
@@ -1485,6 +1661,14 @@ SherpaOnnxSpokenLanguageIdentificationCompute(
   return r;
 }
 
+const SherpaOnnxSpokenLanguageIdentificationResult *
+SherpaOnnxSpokenLanguageIdentificationCompute(
+    const SherpaOnnxSpokenLanguageIdentification *slid,
+    const SherpaOnnxOfflineStream *s) {
+  std::string lang = slid->impl->Compute(s->impl.get());
+  return ToSpokenLanguageIdentificationResult(lang);
+}
+
 void SherpaOnnxDestroySpokenLanguageIdentificationResult(
     const SherpaOnnxSpokenLanguageIdentificationResult *r) {
   if (r) {
@@ -1493,6 +1677,42 @@ void SherpaOnnxDestroySpokenLanguageIdentificationResult(
   }
 }
 
+const SherpaOnnxSpokenLanguageIdentificationResult *const *
+SherpaOnnxSpokenLanguageIdentificationComputeBatch(
+    const SherpaOnnxSpokenLanguageIdentification *slid,
+    const SherpaOnnxOfflineStream **streams, int32_t n) {
+  if (n <= 0) {
+    return nullptr;
+  }
+
+  std::vector<sherpa_onnx::OfflineStream *> ss(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ss[i] = streams[i]->impl.get();
+  }
+
+  std::vector<std::string> langs = slid->impl->ComputeBatch(ss.data(), n);
+
+  auto ans = new const SherpaOnnxSpokenLanguageIdentificationResult *[n];
+  for (int32_t i = 0; i != n; ++i) {
+    ans[i] = ToSpokenLanguageIdentificationResult(langs[i]);
+  }
+
+  return ans;
+}
+
+void SherpaOnnxDestroySpokenLanguageIdentificationBatchResult(
+    const SherpaOnnxSpokenLanguageIdentificationResult *const *r, int32_t n) {
+  if (!r) {
+    return;
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    SherpaOnnxDestroySpokenLanguageIdentificationResult(r[i]);
+  }
+
+  delete[] r;
+}
+
 struct SherpaOnnxSpeakerEmbeddingExtractor {
   std::unique_ptr<sherpa_onnx::SpeakerEmbeddingExtractor> impl;
 };
@@ -1792,12 +2012,8 @@ const SherpaOnnxOfflineStream *SherpaOnnxAudioTaggingCreateOfflineStream(
   return stream;
 }
 
-const SherpaOnnxAudioEvent *const *SherpaOnnxAudioTaggingCompute(
-    const SherpaOnnxAudioTagging *tagger, const SherpaOnnxOfflineStream *s,
-    int32_t top_k) {
-  std::vector<sherpa_onnx::AudioEvent> events =
-      tagger->impl->Compute(s->impl.get(), top_k);
-
+static const SherpaOnnxAudioEvent *const *ToAudioEvents(
+    const std::vector<sherpa_onnx::AudioEvent> &events) {
   int32_t n = static_cast<int32_t>(events.size());
   SherpaOnnxAudioEvent **ans = new SherpaOnnxAudioEvent *[n + 1];
   ans[n] = nullptr;
@@ -1822,6 +2038,15 @@ const SherpaOnnxAudioEvent *const *SherpaOnnxAudioTaggingCompute(
   return ans;
 }
 
+const SherpaOnnxAudioEvent *const *SherpaOnnxAudioTaggingCompute(
+    const SherpaOnnxAudioTagging *tagger, const SherpaOnnxOfflineStream *s,
+    int32_t top_k) {
+  std::vector<sherpa_onnx::AudioEvent> events =
+      tagger->impl->Compute(s->impl.get(), top_k);
+
+  return ToAudioEvents(events);
+}
+
 void SherpaOnnxAudioTaggingFreeResults(
     const SherpaOnnxAudioEvent *const *events) {
   auto p = events;
@@ -1838,6 +2063,42 @@ void SherpaOnnxAudioTaggingFreeResults(
   delete[] events;
 }
 
+const SherpaOnnxAudioEvent *const *const *SherpaOnnxAudioTaggingComputeBatch(
+    const SherpaOnnxAudioTagging *tagger,
+    const SherpaOnnxOfflineStream **streams, int32_t n, int32_t top_k) {
+  if (n <= 0) {
+    return nullptr;
+  }
+
+  std::vector<sherpa_onnx::OfflineStream *> ss(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ss[i] = streams[i]->impl.get();
+  }
+
+  std::vector<std::vector<sherpa_onnx::AudioEvent>> events =
+      tagger->impl->ComputeBatch(ss.data(), n, top_k);
+
+  auto ans = new const SherpaOnnxAudioEvent *const *[n];
+  for (int32_t i = 0; i != n; ++i) {
+    ans[i] = ToAudioEvents(events[i]);
+  }
+
+  return ans;
+}
+
+void SherpaOnnxAudioTaggingFreeBatchResults(
+    const SherpaOnnxAudioEvent *const *const *p, int32_t n) {
+  if (!p) {
+    return;
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    SherpaOnnxAudioTaggingFreeResults(p[i]);
+  }
+
+  delete[] p;
+}
+
 struct SherpaOnnxOfflinePunctuation {
   std::unique_ptr<sherpa_onnx::OfflinePunctuation> impl;
 };
@@ -1886,6 +2147,41 @@ const char *SherpaOfflinePunctuationAddPunct(
 
 void SherpaOfflinePunctuationFreeText(const char *text) { delete[] text; }
 
+const char *const *SherpaOfflinePunctuationAddPunctBatch(
+    const SherpaOnnxOfflinePunctuation *punct, const char *const *texts,
+    int32_t n) {
+  std::vector<std::string> input;
+  input.reserve(n);
+  for (int32_t i = 0; i != n; ++i) {
+    input.emplace_back(texts[i] ? texts[i] : "");
+  }
+
+  std::vector<std::string> output = punct->impl->AddPunctuationBatch(input);
+
+  char **ans = new char *[n + 1];
+  ans[n] = nullptr;
+
+  for (int32_t i = 0; i != n; ++i) {
+    const auto &text = output[i];
+    ans[i] = new char[text.size() + 1];
+    std::copy(text.begin(), text.end(), ans[i]);
+    ans[i][text.size()] = '\0';
+  }
+
+  return ans;
+}
+
+void SherpaOfflinePunctuationFreeTextBatch(const char *const *texts) {
+  auto p = texts;
+
+  while (p && p[0]) {
+    delete[] p[0];
+    ++p;
+  }
+
+  delete[] texts;
+}
+
 struct SherpaOnnxOnlinePunctuation {
   std::unique_ptr<sherpa_onnx::OnlinePunctuation> impl;
 };
@@ -2340,6 +2636,28 @@ void SherpaOnnxOfflineSpeakerDiarizationDestroyResult(
 
 #endif
 
+void SherpaOnnxEnableTracing(int32_t record_events) {
+  sherpa_onnx::Tracer::Get().Enable(record_events != 0);
+}
+
+void SherpaOnnxDisableTracing() { sherpa_onnx::Tracer::Get().Disable(); }
+
+void SherpaOnnxResetTracing() { sherpa_onnx::Tracer::Get().Reset(); }
+
+const char *SherpaOnnxGetTraceStatsJson() {
+  std::string json = sherpa_onnx::Tracer::Get().ToJson();
+  char *pJson = new char[json.size() + 1];
+  std::copy(json.begin(), json.end(), pJson);
+  pJson[json.size()] = 0;
+  return pJson;
+}
+
+void SherpaOnnxDestroyTraceStatsJson(const char *s) { delete[] s; }
+
+int32_t SherpaOnnxWriteChromeTrace(const char *filename) {
+  return sherpa_onnx::Tracer::Get().WriteChromeTrace(filename);
+}
+
 #ifdef __OHOS__
 
 const SherpaOnnxOfflineSpeechDenoiser *
@@ -73,6 +73,37 @@ SHERPA_ONNX_API typedef struct SherpaOnnxOnlineZipformer2CtcModelConfig {
   const char *model;
 } SherpaOnnxOnlineZipformer2CtcModelConfig;
 
+// Options for onnxruntime sessions. A zero-initialized struct gives the
+// default behavior.
+//
+// It is not a member of the model configs so that the layout of existing
+// structs is not changed. Pass it to the SherpaOnnxCreate*WithSessionConfig()
+// functions instead.
+SHERPA_ONNX_API typedef struct SherpaOnnxSessionConfig {
+  // disabled, basic, extended, or all. NULL or empty means all.
+  const char *graph_optimization_level;
+
+  // If not NULL or empty, save the optimized model in ORT format to this
+  // existing and writable directory and load it at the next startup.
+  // Used only for Whisper, VITS and Kokoro.
+  const char *optimized_model_cache_dir;
+
+  // 0 means to use num_threads
+  int32_t intra_op_num_threads;
+  int32_t inter_op_num_threads;
+
+  // 1 to let idle threads of onnxruntime sleep instead of spinning
+  int32_t disable_spinning;
+
+  // e.g., "1;2;3" for 4 threads. See session.intra_op_thread_affinities
+  // of onnxruntime. NULL or empty to let onnxruntime decide.
+  const char *thread_affinity;
+
+  // If not NULL or empty, enable the profiler of onnxruntime. The result of
+  // each session is saved to <profile_prefix>_<timestamp>.json
+  const char *profile_prefix;
+} SherpaOnnxSessionConfig;
+
 SHERPA_ONNX_API typedef struct SherpaOnnxOnlineModelConfig {
   SherpaOnnxOnlineTransducerModelConfig transducer;
   SherpaOnnxOnlineParaformerModelConfig paraformer;
@@ -216,6 +247,16 @@ SHERPA_ONNX_API const SherpaOnnxOnlineRecognizer *
 SherpaOnnxCreateOnlineRecognizer(
     const SherpaOnnxOnlineRecognizerConfig *config);
 
+/// Like SherpaOnnxCreateOnlineRecognizer(), but onnxruntime sessions of the
+/// models are created with the given options.
+///
+/// @param session_config  It can be NULL, which is the same as
+///                        SherpaOnnxCreateOnlineRecognizer().
+SHERPA_ONNX_API const SherpaOnnxOnlineRecognizer *
+SherpaOnnxCreateOnlineRecognizerWithSessionConfig(
+    const SherpaOnnxOnlineRecognizerConfig *config,
+    const SherpaOnnxSessionConfig *session_config);
+
 /// Free a pointer returned by SherpaOnnxCreateOnlineRecognizer()
 ///
 /// @param p A pointer returned by SherpaOnnxCreateOnlineRecognizer()
@@ -485,6 +526,16 @@ SHERPA_ONNX_API const SherpaOnnxOfflineRecognizer *
 SherpaOnnxCreateOfflineRecognizer(
     const SherpaOnnxOfflineRecognizerConfig *config);
 
+/// Like SherpaOnnxCreateOfflineRecognizer(), but onnxruntime sessions of the
+/// models are created with the given options.
+///
+/// @param session_config  It can be NULL, which is the same as
+///                        SherpaOnnxCreateOfflineRecognizer().
+SHERPA_ONNX_API const SherpaOnnxOfflineRecognizer *
+SherpaOnnxCreateOfflineRecognizerWithSessionConfig(
+    const SherpaOnnxOfflineRecognizerConfig *config,
+    const SherpaOnnxSessionConfig *session_config);
+
 /// @param config  Config for the recognizer.
 SHERPA_ONNX_API void SherpaOnnxOfflineRecognizerSetConfig(
     const SherpaOnnxOfflineRecognizer *recognizer,
@@ -693,6 +744,16 @@ SHERPA_ONNX_API typedef struct SherpaOnnxKeywordSpotter
 SHERPA_ONNX_API const SherpaOnnxKeywordSpotter *SherpaOnnxCreateKeywordSpotter(
     const SherpaOnnxKeywordSpotterConfig *config);
 
+/// Like SherpaOnnxCreateKeywordSpotter(), but onnxruntime sessions of the
+/// models are created with the given options.
+///
+/// @param session_config  It can be NULL, which is the same as
+///                        SherpaOnnxCreateKeywordSpotter().
+SHERPA_ONNX_API const SherpaOnnxKeywordSpotter *
+SherpaOnnxCreateKeywordSpotterWithSessionConfig(
+    const SherpaOnnxKeywordSpotterConfig *config,
+    const SherpaOnnxSessionConfig *session_config);
+
 /// Free a pointer returned by SherpaOnnxCreateKeywordSpotter()
 ///
 /// @param p A pointer returned by SherpaOnnxCreateKeywordSpotter()
@@ -1005,6 +1066,14 @@ SHERPA_ONNX_API typedef struct SherpaOnnxOfflineTts SherpaOnnxOfflineTts;
 SHERPA_ONNX_API const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
     const SherpaOnnxOfflineTtsConfig *config);
 
+// Like SherpaOnnxCreateOfflineTts(), but onnxruntime sessions of the
+// models are created with the given options. session_config can be NULL,
+// which is the same as SherpaOnnxCreateOfflineTts().
+SHERPA_ONNX_API const SherpaOnnxOfflineTts *
+SherpaOnnxCreateOfflineTtsWithSessionConfig(
+    const SherpaOnnxOfflineTtsConfig *config,
+    const SherpaOnnxSessionConfig *session_config);
+
 // Free the pointer returned by SherpaOnnxCreateOfflineTts()
 SHERPA_ONNX_API void SherpaOnnxDestroyOfflineTts(
     const SherpaOnnxOfflineTts *tts);
@@ -1055,6 +1124,64 @@ SherpaOnnxOfflineTtsGenerateWithCallbackWithArg(
 SHERPA_ONNX_API void SherpaOnnxDestroyOfflineTtsGeneratedAudio(
     const SherpaOnnxGeneratedAudio *p);
 
+// Return per-stage timings of the request that generated p as a JSON
+// string. It is an empty string if tracing is disabled.
+// See SherpaOnnxEnableTracing()
+//
+// The returned pointer is valid until p is destroyed. Do not free it.
+SHERPA_ONNX_API const char *SherpaOnnxGeneratedAudioGetTrace(
+    const SherpaOnnxGeneratedAudio *p);
+
+// A cancellation token is used to stop a request from another thread, e.g.,
+// when the client disconnects.
+SHERPA_ONNX_API typedef struct SherpaOnnxOfflineTtsCancellationToken
+    SherpaOnnxOfflineTtsCancellationToken;
+
+// The user has to use SherpaOnnxDestroyOfflineTtsCancellationToken() to free
+// the returned pointer to avoid memory leak.
+SHERPA_ONNX_API const SherpaOnnxOfflineTtsCancellationToken *
+SherpaOnnxCreateOfflineTtsCancellationToken();
+
+// It can be called while a request using the token is running.
+SHERPA_ONNX_API void SherpaOnnxDestroyOfflineTtsCancellationToken(
+    const SherpaOnnxOfflineTtsCancellationToken *token);
+
+// Drop queued work of the requests using this token and terminate their
+// running models. It is thread-safe.
+SHERPA_ONNX_API void SherpaOnnxOfflineTtsCancel(
+    const SherpaOnnxOfflineTtsCancellationToken *token);
+
+// Return 1 if SherpaOnnxOfflineTtsCancel() has been called for the token.
+// Return 0 otherwise.
+SHERPA_ONNX_API int32_t SherpaOnnxOfflineTtsIsCancelled(
+    const SherpaOnnxOfflineTtsCancellationToken *token);
+
+SHERPA_ONNX_API typedef struct SherpaOnnxOfflineTtsRequestOptions {
+  // 0 for interactive requests, 1 for batch requests. Queued work of
+  // interactive requests runs first.
+  int32_t priority;
+
+  // Work that has not started within timeout_ms milliseconds is dropped.
+  // If it is <= 0, there is no deadline.
+  int32_t timeout_ms;
+
+  // Optional. It can be NULL.
+  const SherpaOnnxOfflineTtsCancellationToken *cancellation;
+} SherpaOnnxOfflineTtsRequestOptions;
+
+// Like SherpaOnnxOfflineTtsGenerateWithProgressCallbackWithArg(), but the
+// request has a priority, a deadline and can be cancelled.
+//
+// Once the request is cancelled or it passes its deadline, the callback is
+// no longer called and the audio generated so far is returned.
+//
+// options and callback can be NULL.
+SHERPA_ONNX_API const SherpaOnnxGeneratedAudio *
+SherpaOnnxOfflineTtsGenerateWithOptions(
+    const SherpaOnnxOfflineTts *tts, const char *text, int32_t sid, float speed,
+    const SherpaOnnxOfflineTtsRequestOptions *options,
+    SherpaOnnxGeneratedAudioProgressCallbackWithArg callback, void *arg);
+
 // Write the generated audio to a wave file.
 // The saved wave file contains a single channel and has 16-bit samples.
 //
@@ -1155,6 +1282,26 @@ SherpaOnnxSpokenLanguageIdentificationCompute(
 SHERPA_ONNX_API void SherpaOnnxDestroySpokenLanguageIdentificationResult(
     const SherpaOnnxSpokenLanguageIdentificationResult *r);
 
+/// Identify the languages of n streams with a single batched inference.
+///
+/// @param slid A pointer returned by
+///             SherpaOnnxCreateSpokenLanguageIdentification()
+/// @param streams A pointer array containing n pointers returned by
+///                SherpaOnnxSpokenLanguageIdentificationCreateOfflineStream()
+/// @param n Number of entries in the given streams.
+/// @return Return an array of n pointers. The i-th entry is the result of
+///         streams[i]. The user has to invoke
+///         SherpaOnnxDestroySpokenLanguageIdentificationBatchResult()
+///         to free the returned pointer to avoid memory leak. Return NULL
+///         if n <= 0.
+SHERPA_ONNX_API const SherpaOnnxSpokenLanguageIdentificationResult *const *
+SherpaOnnxSpokenLanguageIdentificationComputeBatch(
+    const SherpaOnnxSpokenLanguageIdentification *slid,
+    const SherpaOnnxOfflineStream **streams, int32_t n);
+
+SHERPA_ONNX_API void SherpaOnnxDestroySpokenLanguageIdentificationBatchResult(
+    const SherpaOnnxSpokenLanguageIdentificationResult *const *r, int32_t n);
+
 // ============================================================
 // For speaker embedding extraction
 // ============================================================
@@ -1411,6 +1558,24 @@ SherpaOnnxAudioTaggingCompute(const SherpaOnnxAudioTagging *tagger,
 SHERPA_ONNX_API void SherpaOnnxAudioTaggingFreeResults(
     const SherpaOnnxAudioEvent *const *p);
 
+// Compute the events of n streams with a single batched inference.
+//
+// Return an array of n entries. The i-th entry is the result of
+// streams[i], which has the same format as the return value of
+// SherpaOnnxAudioTaggingCompute().
+//
+// Return NULL if n <= 0.
+//
+// The user has to use SherpaOnnxAudioTaggingFreeBatchResults()
+// to free the returned pointer to avoid memory leak
+SHERPA_ONNX_API const SherpaOnnxAudioEvent *const *const *
+SherpaOnnxAudioTaggingComputeBatch(const SherpaOnnxAudioTagging *tagger,
+                                   const SherpaOnnxOfflineStream **streams,
+                                   int32_t n, int32_t top_k);
+
+SHERPA_ONNX_API void SherpaOnnxAudioTaggingFreeBatchResults(
+    const SherpaOnnxAudioEvent *const *const *p, int32_t n);
+
 // ============================================================
 // For punctuation
 // ============================================================
@@ -1446,6 +1611,24 @@ SHERPA_ONNX_API const char *SherpaOfflinePunctuationAddPunct(
 
 SHERPA_ONNX_API void SherpaOfflinePunctuationFreeText(const char *text);
 
+// Add punctuations to each of the n input texts.
+//
+// It is much faster than calling SherpaOfflinePunctuationAddPunct() for
+// each text since segments of different texts are processed together.
+//
+// @return Return an array of pointers `ans`.
+// - ans[i] contains the result for texts[i], 0 <= i < n
+// - ans[n] is NULL
+//
+// The user has to invoke SherpaOfflinePunctuationFreeTextBatch()
+// to free the returned pointer to avoid memory leak
+SHERPA_ONNX_API const char *const *SherpaOfflinePunctuationAddPunctBatch(
+    const SherpaOnnxOfflinePunctuation *punct, const char *const *texts,
+    int32_t n);
+
+SHERPA_ONNX_API void SherpaOfflinePunctuationFreeTextBatch(
+    const char *const *texts);
+
 SHERPA_ONNX_API typedef struct SherpaOnnxOnlinePunctuationModelConfig {
   const char *cnn_bilstm;
   const char *bpe_vocab;
@@ -1710,6 +1893,37 @@ SherpaOnnxOfflineSpeechDenoiserRun(const SherpaOnnxOfflineSpeechDenoiser *sd,
 SHERPA_ONNX_API void SherpaOnnxDestroyDenoisedAudio(
     const SherpaOnnxDenoisedAudio *p);
 
+// =========================================================================
+// For tracing
+// =========================================================================
+
+// Start to time stages of TTS and ASR requests, e.g., g2p, encoder, etc.
+// Tracing is disabled by default.
+//
+// @param record_events If not 0, each timed stage is also kept as an event
+//                      for SherpaOnnxWriteChromeTrace()
+SHERPA_ONNX_API void SherpaOnnxEnableTracing(int32_t record_events);
+
+SHERPA_ONNX_API void SherpaOnnxDisableTracing();
+
+// Clear the stats and the events
+SHERPA_ONNX_API void SherpaOnnxResetTracing();
+
+// Return the count, total, mean, max, p50, p90 and p99 in milliseconds of
+// each stage run in this process since the last reset as a JSON string.
+//
+// The user has to use SherpaOnnxDestroyTraceStatsJson() to free the
+// returned pointer to avoid memory leak.
+SHERPA_ONNX_API const char *SherpaOnnxGetTraceStatsJson();
+
+SHERPA_ONNX_API void SherpaOnnxDestroyTraceStatsJson(const char *s);
+
+// Write the recorded events to a file in the Chrome trace event format.
+// It can be viewed with chrome://tracing or https://ui.perfetto.dev
+//
+// Return 1 if the write succeeded; return 0 on failure.
+SHERPA_ONNX_API int32_t SherpaOnnxWriteChromeTrace(const char *filename);
+
 #ifdef __OHOS__
 
 // It is for HarmonyOS
@@ -410,6 +410,7 @@ GeneratedAudio OfflineTts::Generate(const std::string &text,
   GeneratedAudio ans;
   ans.samples = std::vector<float>{audio->samples, audio->samples + audio->n};
   ans.sample_rate = audio->sample_rate;
+  ans.trace = SherpaOnnxGeneratedAudioGetTrace(audio);
 
   SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio);
   return ans;
@@ -391,6 +391,9 @@ struct OfflineTtsConfig {
 struct GeneratedAudio {
   std::vector<float> samples;  // in the range [-1, 1]
   int32_t sample_rate;
+
+  // Per-stage timings in JSON. Empty if tracing is disabled.
+  std::string trace;
 };
 
 // Return 1 to continue generating
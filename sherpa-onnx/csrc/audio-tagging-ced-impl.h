@@ -6,6 +6,8 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -55,6 +57,15 @@ class AudioTaggingCEDImpl : public AudioTaggingImpl {
 
   std::vector<AudioEvent> Compute(OfflineStream *s,
                                   int32_t top_k = -1) const override {
+    return ComputeBatch(&s, 1, top_k)[0];
+  }
+
+  std::vector<std::vector<AudioEvent>> ComputeBatch(
+      OfflineStream **ss, int32_t n, int32_t top_k = -1) const override {
+    if (n <= 0) {
+      return {};
+    }
+
     if (top_k < 0) {
       top_k = config_.top_k;
     }
@@ -65,25 +76,74 @@ class AudioTaggingCEDImpl : public AudioTaggingImpl {
       top_k = num_event_classes;
     }
 
+    // CED models do not accept the number of frames of each stream, so
+    // padding would change the results. We batch only streams with the
+    // same number of frames, which is the common case for fixed-length
+    // clips.
+    std::vector<int32_t> num_frames(n);
+    std::vector<int32_t> order(n);
+    for (int32_t i = 0; i != n; ++i) {
+      num_frames[i] = ss[i]->NumFrames();
+      order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+      return num_frames[a] < num_frames[b];
+    });
+
+    std::vector<std::vector<AudioEvent>> ans(n);
+    std::vector<OfflineStream *> batch;
+
+    for (int32_t begin = 0; begin < n;) {
+      int32_t end = begin + 1;
+      while (end < n && num_frames[order[end]] == num_frames[order[begin]]) {
+        ++end;
+      }
+
+      batch.clear();
+      for (int32_t i = begin; i != end; ++i) {
+        batch.push_back(ss[order[i]]);
+      }
+
+      Ort::Value probs = Forward(batch.data(), batch.size());
+      const float *p = probs.GetTensorData<float>();
+
+      for (int32_t i = begin; i != end; ++i) {
+        ans[order[i]] =
+            GetTopKEvents(p + (i - begin) * num_event_classes, top_k);
+      }
+
+      begin = end;
+    }
+
+    return ans;
+  }
+
+ private:
+  // All streams must have the same number of frames.
+  // Return a tensor of shape (n, num_event_classes)
+  Ort::Value Forward(OfflineStream **ss, int32_t n) const {
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
     // WARNING(fangjun): It is fixed to 64 for CED models
     int32_t feat_dim = 64;
-    std::vector<float> f = s->GetFrames();
+    assert(ss[0]->FeatureDim() == feat_dim);
 
-    int32_t num_frames = f.size() / feat_dim;
-    assert(feat_dim * num_frames == static_cast<int32_t>(f.size()));
+    std::vector<float> f;
+    std::vector<int64_t> unused_num_frames;
+    int32_t num_frames = GetBatchFrames(ss, n, 0, &f, &unused_num_frames);
 
-    std::array<int64_t, 3> shape = {1, num_frames, feat_dim};
+    std::array<int64_t, 3> shape = {n, num_frames, feat_dim};
 
     Ort::Value x = Ort::Value::CreateTensor(memory_info, f.data(), f.size(),
                                             shape.data(), shape.size());
 
-    Ort::Value probs = model_.Forward(std::move(x));
-
-    const float *p = probs.GetTensorData<float>();
+    return model_.Forward(std::move(x));
+  }
 
+  std::vector<AudioEvent> GetTopKEvents(const float *p, int32_t top_k) const {
+    int32_t num_event_classes = model_.NumEventClasses();
     std::vector<int32_t> top_k_indexes = TopkIndex(p, num_event_classes, top_k);
 
     std::vector<AudioEvent> ans(top_k);
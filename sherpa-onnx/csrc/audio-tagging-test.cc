@@ -0,0 +1,109 @@
+// sherpa-onnx/csrc/audio-tagging-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/audio-tagging.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
+namespace sherpa_onnx {
+
+// A chirp with some noise so that different lengths give different events
+static std::vector<float> GenerateAudio(int32_t num_samples, float f0) {
+  std::vector<float> ans(num_samples);
+  uint32_t seed = 20250101 + num_samples;
+  float phase = 0;
+  for (int32_t i = 0; i != num_samples; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    float noise = static_cast<float>(seed >> 8) / (1 << 24) - 0.5f;
+
+    float f = f0 + 2000.0f * i / num_samples;
+    phase += 2 * M_PI * f / 16000;
+    ans[i] = 0.3f * std::sin(phase) + 0.05f * noise;
+  }
+  return ans;
+}
+
+// Check that ComputeBatch() gives the same events as Compute() for streams
+// of different lengths
+static void TestBatchMatchesSingle(const AudioTaggingConfig &config) {
+  AudioTagging tagger(config);
+
+  // Two streams have the same length so that they are in the same batch
+  // even for CED, which batches only streams with the same number of frames
+  std::vector<int32_t> lengths = {16000, 40000, 16000, 64000};
+  std::vector<float> f0 = {200, 500, 900, 300};
+
+  std::vector<std::unique_ptr<OfflineStream>> streams;
+  std::vector<OfflineStream *> ss;
+  for (int32_t i = 0; i != static_cast<int32_t>(lengths.size()); ++i) {
+    std::vector<float> samples = GenerateAudio(lengths[i], f0[i]);
+
+    streams.push_back(tagger.CreateStream());
+    streams.back()->AcceptWaveform(16000, samples.data(), samples.size());
+    ss.push_back(streams.back().get());
+  }
+
+  int32_t top_k = 5;
+  std::vector<std::vector<AudioEvent>> batch =
+      tagger.ComputeBatch(ss.data(), ss.size(), top_k);
+  ASSERT_EQ(batch.size(), ss.size());
+
+  for (int32_t i = 0; i != static_cast<int32_t>(ss.size()); ++i) {
+    std::vector<AudioEvent> single = tagger.Compute(ss[i], top_k);
+    ASSERT_EQ(single.size(), batch[i].size());
+
+    EXPECT_EQ(single[0].index, batch[i][0].index) << "stream " << i;
+    for (int32_t k = 0; k != static_cast<int32_t>(single.size()); ++k) {
+      EXPECT_NEAR(single[k].prob, batch[i][k].prob, 2e-3)
+          << "stream " << i << ", k " << k;
+    }
+  }
+
+  EXPECT_TRUE(tagger.ComputeBatch(ss.data(), 0, top_k).empty());
+  EXPECT_TRUE(tagger.ComputeBatch(nullptr, 0, top_k).empty());
+}
+
+TEST(AudioTagging, ZipformerBatch) {
+  std::string dir = "./sherpa-onnx-zipformer-small-audio-tagging-2024-04-15";
+  if (!FileExists(dir + "/model.int8.onnx")) {
+    SHERPA_ONNX_LOGE("%s/model.int8.onnx does not exist. Skipping test",
+                     dir.c_str());
+    return;
+  }
+
+  AudioTaggingConfig config;
+  config.model.zipformer.model = dir + "/model.int8.onnx";
+  config.labels = dir + "/class_labels_indices.csv";
+
+  TestBatchMatchesSingle(config);
+}
+
+TEST(AudioTagging, CedBatch) {
+  std::string dir = "./sherpa-onnx-ced-mini-audio-tagging-2024-04-19";
+  if (!FileExists(dir + "/model.int8.onnx")) {
+    SHERPA_ONNX_LOGE("%s/model.int8.onnx does not exist. Skipping test",
+                     dir.c_str());
+    return;
+  }
+
+  AudioTaggingConfig config;
+  config.model.ced = dir + "/model.int8.onnx";
+  config.labels = dir + "/class_labels_indices.csv";
+
+  TestBatchMatchesSingle(config);
+}
+
+}  // namespace sherpa_onnx
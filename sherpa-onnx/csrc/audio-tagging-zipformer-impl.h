@@ -6,6 +6,7 @@
 
 #include <assert.h>
 
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -55,6 +56,15 @@ class AudioTaggingZipformerImpl : public AudioTaggingImpl {
 
   std::vector<AudioEvent> Compute(OfflineStream *s,
                                   int32_t top_k = -1) const override {
+    return ComputeBatch(&s, 1, top_k)[0];
+  }
+
+  std::vector<std::vector<AudioEvent>> ComputeBatch(
+      OfflineStream **ss, int32_t n, int32_t top_k = -1) const override {
+    if (n <= 0) {
+      return {};
+    }
+
     if (top_k < 0) {
       top_k = config_.top_k;
     }
@@ -70,27 +80,41 @@ class AudioTaggingZipformerImpl : public AudioTaggingImpl {
 
     // WARNING(fangjun): It is fixed to 80 for all models from icefall
     int32_t feat_dim = 80;
-    std::vector<float> f = s->GetFrames();
-
-    int32_t num_frames = f.size() / feat_dim;
+    assert(ss[0]->FeatureDim() == feat_dim);
 
-    assert(feat_dim * num_frames == static_cast<int32_t>(f.size()));
+    // Frames beyond the end of a stream are masked by x_length. We use
+    // log(1e-10) as padding, as in the transducer recognizer.
+    std::vector<float> f;
+    std::vector<int64_t> x_length_vec;
+    int32_t max_num_frames =
+        GetBatchFrames(ss, n, -23.025850929940457f, &f, &x_length_vec);
 
-    std::array<int64_t, 3> shape = {1, num_frames, feat_dim};
+    std::array<int64_t, 3> shape = {n, max_num_frames, feat_dim};
 
     Ort::Value x = Ort::Value::CreateTensor(memory_info, f.data(), f.size(),
                                             shape.data(), shape.size());
 
-    int64_t x_length_scalar = num_frames;
-    std::array<int64_t, 1> x_length_shape = {1};
-    Ort::Value x_length =
-        Ort::Value::CreateTensor(memory_info, &x_length_scalar, 1,
-                                 x_length_shape.data(), x_length_shape.size());
+    std::array<int64_t, 1> x_length_shape = {n};
+    Ort::Value x_length = Ort::Value::CreateTensor(
+        memory_info, x_length_vec.data(), n, x_length_shape.data(),
+        x_length_shape.size());
 
+    // (n, num_event_classes)
     Ort::Value probs = model_.Forward(std::move(x), std::move(x_length));
 
     const float *p = probs.GetTensorData<float>();
 
+    std::vector<std::vector<AudioEvent>> ans(n);
+    for (int32_t i = 0; i != n; ++i) {
+      ans[i] = GetTopKEvents(p + i * num_event_classes, top_k);
+    }
+
+    return ans;
+  }
+
+ private:
+  std::vector<AudioEvent> GetTopKEvents(const float *p, int32_t top_k) const {
+    int32_t num_event_classes = model_.NumEventClasses();
     std::vector<int32_t> top_k_indexes = TopkIndex(p, num_event_classes, top_k);
 
     std::vector<AudioEvent> ans(top_k);
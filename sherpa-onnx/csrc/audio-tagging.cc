@@ -5,6 +5,7 @@
 #include "sherpa-onnx/csrc/audio-tagging.h"
 
 #include <string>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -84,4 +85,9 @@ std::vector<AudioEvent> AudioTagging::Compute(OfflineStream *s,
   return impl_->Compute(s, top_k);
 }
 
+std::vector<std::vector<AudioEvent>> AudioTagging::ComputeBatch(
+    OfflineStream **ss, int32_t n, int32_t top_k /*= -1*/) const {
+  return impl_->ComputeBatch(ss, n, top_k);
+}
+
 }  // namespace sherpa_onnx
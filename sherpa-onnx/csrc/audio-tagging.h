@@ -65,6 +65,13 @@ class AudioTagging {
   // Return top_k AudioEvent. ans[0].prob is the largest of all returned events.
   std::vector<AudioEvent> Compute(OfflineStream *s, int32_t top_k = -1) const;
 
+  // Compute the events of n streams with a single batched inference.
+  // ans[i] is the same as Compute(ss[i], top_k), up to numerical
+  // differences caused by batching. Return an empty vector if n <= 0.
+  std::vector<std::vector<AudioEvent>> ComputeBatch(OfflineStream **ss,
+                                                    int32_t n,
+                                                    int32_t top_k = -1) const;
+
  private:
   std::unique_ptr<AudioTaggingImpl> impl_;
 };
@@ -0,0 +1,136 @@
+// sherpa-onnx/csrc/batch-fbank-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/batch-fbank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "kaldi-native-fbank/csrc/online-feature.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> GenerateSamples(int32_t n) {
+  std::mt19937 gen(20250106);
+  std::uniform_real_distribution<float> dist(-0.3, 0.3);
+
+  std::vector<float> x(n);
+  for (auto &f : x) {
+    f = dist(gen);
+  }
+
+  // digital silence in the middle to test the log floor
+  for (int32_t i = n / 3; i < n / 2; ++i) {
+    x[i] = 0;
+  }
+
+  return x;
+}
+
+// The options used by OfflineStream for most models
+static knf::FbankOptions AsrOptions(bool snip_edges) {
+  knf::FbankOptions opts;
+  opts.frame_opts.dither = 0;
+  opts.frame_opts.snip_edges = snip_edges;
+  opts.mel_opts.num_bins = 80;
+  opts.mel_opts.high_freq = -400;
+  return opts;
+}
+
+// The options used by OfflineStream for CED
+static knf::FbankOptions CedOptions() {
+  knf::FbankOptions opts;
+  opts.frame_opts.frame_length_ms = 32;
+  opts.frame_opts.dither = 0;
+  opts.frame_opts.preemph_coeff = 0;
+  opts.frame_opts.remove_dc_offset = false;
+  opts.frame_opts.window_type = "hann";
+  opts.frame_opts.snip_edges = false;
+  opts.mel_opts.num_bins = 64;
+  opts.mel_opts.low_freq = 0;
+  opts.mel_opts.high_freq = 8000;
+  opts.use_log_fbank = false;
+  return opts;
+}
+
+static void ExpectSameAsOnlineFbank(const knf::FbankOptions &opts,
+                                    const std::vector<float> &x) {
+  knf::OnlineFbank fbank(opts);
+  fbank.AcceptWaveform(16000, x.data(), x.size());
+  fbank.InputFinished();
+
+  BatchFbank batch_fbank(opts);
+  int32_t num_frames = batch_fbank.NumFrames(x.size());
+  int32_t dim = batch_fbank.Dim();
+
+  ASSERT_EQ(num_frames, fbank.NumFramesReady()) << x.size();
+  ASSERT_EQ(dim, fbank.Dim());
+
+  std::vector<float> y(num_frames * dim);
+  batch_fbank.Compute(x.data(), x.size(), y.data());
+
+  for (int32_t t = 0; t != num_frames; ++t) {
+    const float *expected = fbank.GetFrame(t);
+    for (int32_t i = 0; i != dim; ++i) {
+      float tol = 1e-4 * std::max(1.0f, std::fabs(expected[i]));
+      ASSERT_NEAR(y[t * dim + i], expected[i], tol)
+          << x.size() << ", " << t << ", " << i;
+    }
+  }
+}
+
+TEST(BatchFbank, SameAsOnlineFbank) {
+  // Lengths around the frame length and more than one block of frames
+  const int32_t lengths[] = {1, 100, 399, 400, 401, 16000 * 3 + 37};
+
+  for (bool snip_edges : {false, true}) {
+    auto opts = AsrOptions(snip_edges);
+    ASSERT_TRUE(BatchFbank::IsSupported(opts));
+
+    for (int32_t n : lengths) {
+      ExpectSameAsOnlineFbank(opts, GenerateSamples(n));
+    }
+  }
+
+  auto opts = CedOptions();
+  ASSERT_TRUE(BatchFbank::IsSupported(opts));
+  for (int32_t n : lengths) {
+    ExpectSameAsOnlineFbank(opts, GenerateSamples(n));
+  }
+
+  opts = AsrOptions(false);
+  opts.frame_opts.dither = 0.00003;
+  EXPECT_FALSE(BatchFbank::IsSupported(opts));
+}
+
+TEST(BatchFbank, NormalizePerFeature) {
+  // 83 is not a multiple of 4 so that the scalar tail is exercised
+  int32_t num_rows = 50;
+  int32_t num_cols = 83;
+  auto x = GenerateSamples(num_rows * num_cols);
+
+  auto y = x;
+  NormalizePerFeature(y.data(), num_rows, num_cols);
+
+  for (int32_t c = 0; c != num_cols; ++c) {
+    double sum = 0;
+    double sum_sq = 0;
+    for (int32_t r = 0; r != num_rows; ++r) {
+      sum += x[r * num_cols + c];
+      sum_sq += x[r * num_cols + c] * x[r * num_cols + c];
+    }
+    double mean = sum / num_rows;
+    double stddev = std::sqrt(sum_sq / num_rows - mean * mean);
+
+    for (int32_t r = 0; r != num_rows; ++r) {
+      float expected = (x[r * num_cols + c] - mean) / (stddev + 1e-5);
+      EXPECT_NEAR(y[r * num_cols + c], expected, 1e-3) << r << ", " << c;
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,402 @@
+// sherpa-onnx/csrc/batch-fbank.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/batch-fbank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHERPA_ONNX_BATCH_FBANK_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SHERPA_ONNX_BATCH_FBANK_NEON 1
+#endif
+
+#include "kaldi-native-fbank/csrc/feature-window.h"
+#include "kaldi-native-fbank/csrc/mel-computations.h"
+#include "kaldi-native-fbank/csrc/rfft.h"
+
+namespace sherpa_onnx {
+
+// Number of frames that are processed together
+static constexpr int32_t kBlockSize = 64;
+
+// Coefficients of the polynomial approximation of log(1 + x) used by
+// cephes logf(), from the highest order
+static constexpr float kLogCoeffs[] = {
+    7.0376836292E-2f,  -1.1514610310E-1f, 1.1676998740E-1f,
+    -1.2420140846E-1f, 1.4249322787E-1f,  -1.6668057665E-1f,
+    2.0000714765E-1f,  -2.4999993993E-1f, 3.3333331174E-1f,
+};
+
+#if defined(SHERPA_ONNX_BATCH_FBANK_SSE2)
+// Natural logarithm of 4 positive normal floats. See cephes logf().
+static inline __m128 Log4(__m128 x) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  __m128i k = _mm_srli_epi32(_mm_castps_si128(x), 23);
+  k = _mm_sub_epi32(k, _mm_set1_epi32(0x7f));
+
+  // x = frexp(x), so x is in [0.5, 1)
+  x = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(~0x7f800000)));
+  x = _mm_or_ps(x, half);
+  __m128 e = _mm_add_ps(_mm_cvtepi32_ps(k), one);
+
+  // if x < sqrt(0.5), then e -= 1 and x = 2x - 1; otherwise x = x - 1
+  __m128 mask = _mm_cmplt_ps(x, _mm_set1_ps(0.707106781186547524f));
+  __m128 tmp = _mm_and_ps(x, mask);
+  x = _mm_sub_ps(x, one);
+  e = _mm_sub_ps(e, _mm_and_ps(one, mask));
+  x = _mm_add_ps(x, tmp);
+
+  __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_set1_ps(kLogCoeffs[0]);
+  for (int32_t i = 1; i != 9; ++i) {
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kLogCoeffs[i]));
+  }
+  y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, half));
+  x = _mm_add_ps(x, y);
+  x = _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+
+  return x;
+}
+#elif defined(SHERPA_ONNX_BATCH_FBANK_NEON)
+static inline float32x4_t Log4(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.0f);
+
+  uint32x4_t u = vreinterpretq_u32_f32(x);
+  int32x4_t k = vreinterpretq_s32_u32(vshrq_n_u32(u, 23));
+  k = vsubq_s32(k, vdupq_n_s32(0x7f));
+
+  // x = frexp(x), so x is in [0.5, 1)
+  u = vandq_u32(u, vdupq_n_u32(~0x7f800000u));
+  u = vorrq_u32(u, vreinterpretq_u32_f32(vdupq_n_f32(0.5f)));
+  x = vreinterpretq_f32_u32(u);
+  float32x4_t e = vaddq_f32(vcvtq_f32_s32(k), one);
+
+  // if x < sqrt(0.5), then e -= 1 and x = 2x - 1; otherwise x = x - 1
+  uint32x4_t mask = vcltq_f32(x, vdupq_n_f32(0.707106781186547524f));
+  float32x4_t tmp = vreinterpretq_f32_u32(vandq_u32(u, mask));
+  x = vsubq_f32(x, one);
+  e = vsubq_f32(
+      e, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(one), mask)));
+  x = vaddq_f32(x, tmp);
+
+  float32x4_t z = vmulq_f32(x, x);
+  float32x4_t y = vdupq_n_f32(kLogCoeffs[0]);
+  for (int32_t i = 1; i != 9; ++i) {
+    y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(kLogCoeffs[i]));
+  }
+  y = vmulq_f32(vmulq_f32(y, x), z);
+
+  y = vaddq_f32(y, vmulq_n_f32(e, -2.12194440e-4f));
+  y = vsubq_f32(y, vmulq_n_f32(z, 0.5f));
+  x = vaddq_f32(x, y);
+  x = vaddq_f32(x, vmulq_n_f32(e, 0.693359375f));
+
+  return x;
+}
+#endif
+
+// p[i] = log(max(p[i], floor)) for i in [0, n). floor must be positive.
+static void LogWithFloor(float *p, int32_t n, float floor) {
+  int32_t i = 0;
+#if defined(SHERPA_ONNX_BATCH_FBANK_SSE2)
+  const __m128 f = _mm_set1_ps(floor);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(p + i, Log4(_mm_max_ps(_mm_loadu_ps(p + i), f)));
+  }
+#elif defined(SHERPA_ONNX_BATCH_FBANK_NEON)
+  const float32x4_t f = vdupq_n_f32(floor);
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(p + i, Log4(vmaxq_f32(vld1q_f32(p + i), f)));
+  }
+#endif
+  for (; i < n; ++i) {
+    p[i] = std::log(std::max(p[i], floor));
+  }
+}
+
+static float Dot(const float *a, const float *b, int32_t n) {
+  int32_t i = 0;
+  float sum = 0;
+#if defined(SHERPA_ONNX_BATCH_FBANK_SSE2)
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  }
+  float tmp[4];
+  _mm_storeu_ps(tmp, acc);
+  sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+#elif defined(SHERPA_ONNX_BATCH_FBANK_NEON)
+  float32x4_t acc = vdupq_n_f32(0);
+  for (; i + 4 <= n; i += 4) {
+    acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+  }
+  sum = vaddvq_f32(acc);
+#endif
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+
+  return sum;
+}
+
+BatchFbank::BatchFbank(const knf::FbankOptions &opts) : opts_(opts) {
+  const auto &frame_opts = opts_.frame_opts;
+
+  frame_length_ = frame_opts.WindowSize();
+  padded_length_ = frame_opts.PaddedWindowSize();
+  num_bins_ = opts_.mel_opts.num_bins;
+
+  // Get the window function by applying it to ones
+  window_.assign(frame_length_, 1);
+  knf::FeatureWindowFunction window_function(frame_opts);
+  window_function.Apply(window_.data());
+
+  // Get the weights of the mel filterbank one FFT bin at a time, so that
+  // we use exactly the same filterbank as knf::OnlineFbank
+  knf::MelBanks mel_banks(opts_.mel_opts, frame_opts, 1.0f);
+
+  int32_t num_fft_bins = padded_length_ / 2 + 1;
+  std::vector<float> weights(num_bins_ * num_fft_bins);
+  std::vector<float> unit(num_fft_bins);
+  std::vector<float> mel(num_bins_);
+
+  for (int32_t k = 0; k != num_fft_bins; ++k) {
+    unit[k] = 1;
+    mel_banks.Compute(unit.data(), mel.data());
+    unit[k] = 0;
+
+    for (int32_t b = 0; b != num_bins_; ++b) {
+      weights[b * num_fft_bins + k] = mel[b];
+    }
+  }
+
+  mel_offset_.reserve(num_bins_);
+  mel_size_.reserve(num_bins_);
+  mel_start_.reserve(num_bins_);
+
+  for (int32_t b = 0; b != num_bins_; ++b) {
+    const float *row = weights.data() + b * num_fft_bins;
+
+    int32_t first = 0;
+    while (first < num_fft_bins && row[first] == 0) {
+      ++first;
+    }
+
+    int32_t last = num_fft_bins;
+    while (last > first && row[last - 1] == 0) {
+      --last;
+    }
+
+    mel_offset_.push_back(first);
+    mel_size_.push_back(last - first);
+    mel_start_.push_back(mel_weights_.size());
+    mel_weights_.insert(mel_weights_.end(), row + first, row + last);
+  }
+}
+
+bool BatchFbank::IsSupported(const knf::FbankOptions &opts) {
+  if (opts.frame_opts.dither != 0 || opts.use_energy) {
+    return false;
+  }
+
+  // knf::Rfft requires a power of 2
+  int32_t n = opts.frame_opts.PaddedWindowSize();
+  return n >= 4 && (n & (n - 1)) == 0;
+}
+
+int32_t BatchFbank::NumFrames(int32_t num_samples) const {
+  return knf::NumFrames(num_samples, opts_.frame_opts, true);
+}
+
+void BatchFbank::ExtractFrames(const float *samples, int32_t n, int32_t begin,
+                               int32_t num_frames, float *frames) const {
+  const auto &frame_opts = opts_.frame_opts;
+
+  for (int32_t f = 0; f != num_frames; ++f) {
+    float *w = frames + f * padded_length_;
+
+    int64_t start = knf::FirstSampleOfFrame(begin + f, frame_opts);
+    if (start >= 0 && start + frame_length_ <= n) {
+      std::copy(samples + start, samples + start + frame_length_, w);
+    } else {
+      // Reflect at the boundaries, as knf does when snip_edges is false
+      for (int32_t s = 0; s != frame_length_; ++s) {
+        int64_t k = start + s;
+        while (k < 0 || k >= n) {
+          k = (k < 0) ? -k - 1 : 2 * static_cast<int64_t>(n) - 1 - k;
+        }
+        w[s] = samples[k];
+      }
+    }
+
+    std::fill(w + frame_length_, w + padded_length_, 0);
+
+    if (frame_opts.remove_dc_offset) {
+      float sum = 0;
+      for (int32_t s = 0; s != frame_length_; ++s) {
+        sum += w[s];
+      }
+
+      float mean = sum / frame_length_;
+      for (int32_t s = 0; s != frame_length_; ++s) {
+        w[s] -= mean;
+      }
+    }
+
+    if (frame_opts.preemph_coeff != 0) {
+      float c = frame_opts.preemph_coeff;
+      for (int32_t s = frame_length_ - 1; s > 0; --s) {
+        w[s] -= c * w[s - 1];
+      }
+      w[0] -= c * w[0];
+    }
+
+    for (int32_t s = 0; s != frame_length_; ++s) {
+      w[s] *= window_[s];
+    }
+  }
+}
+
+void BatchFbank::Compute(const float *samples, int32_t n, float *out) const {
+  int32_t num_frames = NumFrames(n);
+  if (num_frames <= 0) {
+    return;
+  }
+
+  // A local object so that this method is thread-safe
+  knf::Rfft rfft(padded_length_);
+
+  int32_t half = padded_length_ / 2;
+  std::vector<float> frames(std::min(num_frames, kBlockSize) * padded_length_);
+
+  for (int32_t begin = 0; begin < num_frames; begin += kBlockSize) {
+    int32_t block = std::min(kBlockSize, num_frames - begin);
+
+    ExtractFrames(samples, n, begin, block, frames.data());
+
+    for (int32_t f = 0; f != block; ++f) {
+      float *p = frames.data() + f * padded_length_;
+
+      rfft.Compute(p);
+
+      // p is [real0, real_half, real1, imag1, real2, imag2, ...].
+      // Convert it to the power spectrum of half + 1 bins in-place.
+      float first = p[0] * p[0];
+      float last = p[1] * p[1];
+      for (int32_t k = 1; k < half; ++k) {
+        float re = p[2 * k];
+        float im = p[2 * k + 1];
+        p[k] = re * re + im * im;
+      }
+      p[0] = first;
+      p[half] = last;
+
+      if (!opts_.use_power) {
+        for (int32_t k = 0; k <= half; ++k) {
+          p[k] = std::sqrt(p[k]);
+        }
+      }
+
+      float *o = out + (begin + f) * num_bins_;
+      for (int32_t b = 0; b != num_bins_; ++b) {
+        o[b] = Dot(mel_weights_.data() + mel_start_[b], p + mel_offset_[b],
+                   mel_size_[b]);
+      }
+    }
+
+    if (opts_.use_log_fbank) {
+      LogWithFloor(out + begin * num_bins_, block * num_bins_,
+                   std::numeric_limits<float>::epsilon());
+    }
+  }
+}
+
+void ComputeMeanAndInvStd(const float *p, int32_t num_rows, int32_t num_cols,
+                          std::vector<float> *mean,
+                          std::vector<float> *inv_stddev) {
+  std::vector<float> sum(num_cols);
+  std::vector<float> sum_sq(num_cols);
+
+  // Vectorized over columns, so the summation order of each column is
+  // the same as that of a scalar loop
+  for (int32_t i = 0; i != num_rows; ++i) {
+    int32_t c = 0;
+#if defined(SHERPA_ONNX_BATCH_FBANK_SSE2)
+    for (; c + 4 <= num_cols; c += 4) {
+      __m128 t = _mm_loadu_ps(p + c);
+      _mm_storeu_ps(sum.data() + c, _mm_add_ps(_mm_loadu_ps(&sum[c]), t));
+      _mm_storeu_ps(sum_sq.data() + c,
+                    _mm_add_ps(_mm_loadu_ps(&sum_sq[c]), _mm_mul_ps(t, t)));
+    }
+#elif defined(SHERPA_ONNX_BATCH_FBANK_NEON)
+    for (; c + 4 <= num_cols; c += 4) {
+      float32x4_t t = vld1q_f32(p + c);
+      vst1q_f32(&sum[c], vaddq_f32(vld1q_f32(&sum[c]), t));
+      vst1q_f32(&sum_sq[c], vaddq_f32(vld1q_f32(&sum_sq[c]), vmulq_f32(t, t)));
+    }
+#endif
+    for (; c < num_cols; ++c) {
+      auto t = p[c];
+      sum[c] += t;
+      sum_sq[c] += t * t;
+    }
+    p += num_cols;
+  }
+
+  mean->resize(num_cols);
+  inv_stddev->resize(num_cols);
+
+  for (int32_t i = 0; i != num_cols; ++i) {
+    auto t = sum[i] / num_rows;
+    (*mean)[i] = t;
+
+    float stddev = std::sqrt(sum_sq[i] / num_rows - t * t);
+
+    if (stddev != stddev) {
+      stddev = 0;
+    }
+
+    (*inv_stddev)[i] = 1.0f / (stddev + 1e-5f);
+  }
+}
+
+void NormalizePerFeature(float *p, int32_t num_rows, int32_t num_cols) {
+  std::vector<float> mean;
+  std::vector<float> inv_stddev;
+
+  ComputeMeanAndInvStd(p, num_rows, num_cols, &mean, &inv_stddev);
+
+  for (int32_t n = 0; n != num_rows; ++n) {
+    int32_t i = 0;
+#if defined(SHERPA_ONNX_BATCH_FBANK_SSE2)
+    for (; i + 4 <= num_cols; i += 4) {
+      __m128 t = _mm_sub_ps(_mm_loadu_ps(p + i), _mm_loadu_ps(&mean[i]));
+      _mm_storeu_ps(p + i, _mm_mul_ps(t, _mm_loadu_ps(&inv_stddev[i])));
+    }
+#elif defined(SHERPA_ONNX_BATCH_FBANK_NEON)
+    for (; i + 4 <= num_cols; i += 4) {
+      float32x4_t t = vsubq_f32(vld1q_f32(p + i), vld1q_f32(&mean[i]));
+      vst1q_f32(p + i, vmulq_f32(t, vld1q_f32(&inv_stddev[i])));
+    }
+#endif
+    for (; i < num_cols; ++i) {
+      p[i] = (p[i] - mean[i]) * inv_stddev[i];
+    }
+    p += num_cols;
+  }
+}
+
+}  // namespace sherpa_onnx
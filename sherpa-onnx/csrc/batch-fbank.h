@@ -0,0 +1,87 @@
+// sherpa-onnx/csrc/batch-fbank.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_BATCH_FBANK_H_
+#define SHERPA_ONNX_CSRC_BATCH_FBANK_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "kaldi-native-fbank/csrc/feature-fbank.h"
+
+namespace sherpa_onnx {
+
+// Computes the fbank features of a whole utterance at once.
+//
+// It produces the same features as knf::OnlineFbank, but instead of
+// processing one frame at a time, it processes blocks of frames:
+// windows of a block are extracted into one matrix, transformed with
+// real FFTs, multiplied with the mel filterbank stored as a sparse
+// matrix, and their logarithms are taken with SIMD instructions.
+//
+// Compute() is thread-safe.
+class BatchFbank {
+ public:
+  explicit BatchFbank(const knf::FbankOptions &opts);
+
+  // Return true if BatchFbank supports the given options. Otherwise,
+  // please use knf::OnlineFbank. Dithering and energy are not supported.
+  static bool IsSupported(const knf::FbankOptions &opts);
+
+  int32_t Dim() const { return num_bins_; }
+
+  // Number of frames for an utterance of num_samples samples.
+  // It is the same as that of knf::OnlineFbank after InputFinished().
+  int32_t NumFrames(int32_t num_samples) const;
+
+  /**
+   * @param samples Pointer to a 1-D array of n samples.
+   * @param n Number of samples.
+   * @param out Pointer to a 2-D array of shape (NumFrames(n), Dim()).
+   */
+  void Compute(const float *samples, int32_t n, float *out) const;
+
+ private:
+  // Extract, process and window frames [begin, begin + num_frames)
+  // into rows of `frames`, each of which has padded_length_ floats.
+  void ExtractFrames(const float *samples, int32_t n, int32_t begin,
+                     int32_t num_frames, float *frames) const;
+
+ private:
+  knf::FbankOptions opts_;
+
+  int32_t frame_length_ = 0;
+  int32_t padded_length_ = 0;
+  int32_t num_bins_ = 0;
+
+  std::vector<float> window_;
+
+  // The mel filterbank in a sparse format. Bin i uses FFT bins
+  // [mel_offset_[i], mel_offset_[i] + mel_size_[i]) with weights
+  // starting at mel_weights_[mel_start_[i]].
+  std::vector<int32_t> mel_offset_;
+  std::vector<int32_t> mel_size_;
+  std::vector<int32_t> mel_start_;
+  std::vector<float> mel_weights_;
+};
+
+/* Compute mean and inverse stddev over rows.
+ *
+ * @param p  A pointer to a 2-d array of shape (num_rows, num_cols)
+ * @param num_rows Number of rows
+ * @param num_cols Number of columns
+ * @param mean On return, it contains p.mean(axis=0)
+ * @param inv_stddev On return, it contains 1/p.std(axis=0)
+ */
+void ComputeMeanAndInvStd(const float *p, int32_t num_rows, int32_t num_cols,
+                          std::vector<float> *mean,
+                          std::vector<float> *inv_stddev);
+
+// Normalize each column of a 2-D array of shape (num_rows, num_cols)
+// in-place to zero mean and unit variance.
+void NormalizePerFeature(float *p, int32_t num_rows, int32_t num_cols);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_BATCH_FBANK_H_
@@ -13,6 +13,7 @@
 #include "kaldi-native-fbank/csrc/online-feature.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -66,6 +67,7 @@ class FeatureExtractor::Impl {
   }
 
   void AcceptWaveform(int32_t sampling_rate, const float *waveform, int32_t n) {
+    ScopedTrace trace(TraceStage::kFeatureExtraction);
     if (config_.normalize_samples) {
       AcceptWaveformImpl(sampling_rate, waveform, n);
     } else {
@@ -8,6 +8,21 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define SHERPA_ONNX_HAS_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHERPA_ONNX_HAS_MMAP 1
+#endif
 
 #include "sherpa-onnx/csrc/macros.h"
 
@@ -30,6 +45,129 @@ std::vector<char> ReadFile(const std::string &filename) {
   return buffer;
 }
 
+MappedFile::MappedFile(const std::string &filename) {
+#if defined(SHERPA_ONNX_HAS_MMAP) && defined(_WIN32)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+    return;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    SHERPA_ONNX_LOGE("Failed to get the size of '%s'", filename.c_str());
+    CloseHandle(file);
+    return;
+  }
+
+  is_open_ = true;
+  size_ = static_cast<size_t>(size.QuadPart);
+  if (size_ == 0) {
+    CloseHandle(file);
+    return;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+
+  if (mapping == nullptr) {
+    SHERPA_ONNX_LOGE("Failed to map '%s'", filename.c_str());
+    return;
+  }
+
+  data_ = reinterpret_cast<const char *>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  CloseHandle(mapping);
+
+  if (data_ == nullptr) {
+    SHERPA_ONNX_LOGE("Failed to map '%s'", filename.c_str());
+  }
+#elif defined(SHERPA_ONNX_HAS_MMAP)
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    SHERPA_ONNX_LOGE("Failed to get the size of '%s'", filename.c_str());
+    close(fd);
+    return;
+  }
+
+  is_open_ = true;
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+
+  void *p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (p == MAP_FAILED) {
+    SHERPA_ONNX_LOGE("Failed to map '%s'", filename.c_str());
+    return;
+  }
+
+  data_ = reinterpret_cast<const char *>(p);
+#else
+  if (!FileExists(filename)) {
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+    return;
+  }
+
+  buffer_ = ReadFile(filename);
+  is_open_ = true;
+  size_ = buffer_.size();
+  data_ = buffer_.empty() ? nullptr : buffer_.data();
+#endif
+}
+
+MappedFile::~MappedFile() { Release(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  Release();
+
+  buffer_ = std::move(other.buffer_);
+  size_ = other.size_;
+  is_open_ = other.is_open_;
+  data_ = buffer_.empty() ? other.data_ : buffer_.data();
+
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.is_open_ = false;
+
+  return *this;
+}
+
+void MappedFile::Release() {
+  if (data_ && buffer_.empty()) {
+#if defined(SHERPA_ONNX_HAS_MMAP) && defined(_WIN32)
+    UnmapViewOfFile(data_);
+#elif defined(SHERPA_ONNX_HAS_MMAP)
+    munmap(const_cast<char *>(data_), size_);
+#endif
+  }
+
+  buffer_.clear();
+  data_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+
 #if __ANDROID_API__ >= 9
 std::vector<char> ReadFile(AAssetManager *mgr, const std::string &filename) {
   AAsset *asset = AAssetManager_open(mgr, filename.c_str(), AASSET_MODE_BUFFER);
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_FILE_UTILS_H_
 #define SHERPA_ONNX_CSRC_FILE_UTILS_H_
 
+#include <cstddef>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -35,6 +36,42 @@ void AssertFileExists(const std::string &filename);
 
 std::vector<char> ReadFile(const std::string &filename);
 
+/** Map a file into memory read-only.
+ *
+ * Pages are loaded lazily by the OS, so large files can be accessed without
+ * reading them into memory first. If mapping is not supported on the
+ * platform, the file is read into a buffer instead.
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string &filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  // Return false if the file cannot be opened or mapped
+  bool IsOk() const { return data_ != nullptr || (is_open_ && size_ == 0); }
+
+  const char *Data() const { return data_; }
+  size_t Size() const { return size_; }
+
+ private:
+  void Release();
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  bool is_open_ = false;
+
+  // non-empty only if we fall back to reading the file
+  std::vector<char> buffer_;
+};
+
 #if __ANDROID_API__ >= 9
 std::vector<char> ReadFile(AAssetManager *mgr, const std::string &filename);
 #endif
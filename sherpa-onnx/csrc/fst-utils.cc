@@ -4,16 +4,21 @@
 
 #include "sherpa-onnx/csrc/fst-utils.h"
 
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
 #include "sherpa-onnx/csrc/macros.h"
 
 namespace sherpa_onnx {
 
 // This function is copied from kaldi.
 //
-// @param filename Path to a StdVectorFst or StdConstFst graph
 // @return The caller should free the returned pointer using `delete` to
 //         avoid memory leak.
-fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
+fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename,
+                                 bool use_mmap /*= false*/) {
   // read decoding network FST
   std::ifstream is(filename, std::ios::binary);
   if (!is.good()) {
@@ -31,6 +36,20 @@ fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
   }
   fst::FstReadOptions ropts("<unspecified>", &hdr);
 
+  if (use_mmap && hdr.FstType() == "const") {
+    // OpenFst maps the arrays of a ConstFst from the source file.
+    // They are read into memory if the file is not aligned.
+    ropts.source = filename;
+    ropts.mode = fst::FstReadOptions::MAP;
+  } else if (use_mmap) {
+    SHERPA_ONNX_LOGE(
+        "Only const FSTs can be memory mapped. Read %s FST '%s' into memory "
+        "instead. Please use\n"
+        "  fstconvert --fst_type=const --fst_align in.fst out.fst\n"
+        "to convert it.",
+        hdr.FstType().c_str(), filename.c_str());
+  }
+
   fst::Fst<fst::StdArc> *decode_fst = nullptr;
 
   if (hdr.FstType() == "vector") {
@@ -50,4 +69,32 @@ fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
   }
 }
 
+std::shared_ptr<const fst::Fst<fst::StdArc>> ReadSharedGraph(
+    const std::string &filename, bool use_mmap /*= false*/) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string,
+                            std::weak_ptr<const fst::Fst<fst::StdArc>>>
+      graphs;
+
+  std::string key = filename + (use_mmap ? ":mmap" : "");
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = graphs.find(key);
+  if (it != graphs.end()) {
+    auto graph = it->second.lock();
+    if (graph) {
+      return graph;
+    }
+  }
+
+  std::shared_ptr<const fst::Fst<fst::StdArc>> graph(
+      ReadGraph(filename, use_mmap));
+  if (graph) {
+    graphs[key] = graph;
+  }
+
+  return graph;
+}
+
 }  // namespace sherpa_onnx
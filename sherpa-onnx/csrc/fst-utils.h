@@ -5,14 +5,26 @@
 #ifndef SHERPA_ONNX_CSRC_FST_UTILS_H_
 #define SHERPA_ONNX_CSRC_FST_UTILS_H_
 
+#include <memory>
 #include <string>
 
 #include "fst/fstlib.h"
 
 namespace sherpa_onnx {
 
-fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename);
+// @param filename Path to a StdVectorFst or StdConstFst graph
+// @param use_mmap If true and the graph is a StdConstFst, its arcs and
+//                 states are memory mapped instead of being read into
+//                 memory. It is ignored for a StdVectorFst.
+fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename,
+                                 bool use_mmap = false);
 
-}
+// Like ReadGraph(), but recognizers that read the same file with the
+// same use_mmap share a single copy of the graph for as long as any of
+// them is alive. The returned graph must not be modified.
+std::shared_ptr<const fst::Fst<fst::StdArc>> ReadSharedGraph(
+    const std::string &filename, bool use_mmap = false);
+
+}  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_FST_UTILS_H_
@@ -0,0 +1,144 @@
+// sherpa-onnx/csrc/homophone-replacer-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/homophone-replacer.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fst/fstlib.h"
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+// Please download dict files form
+// https://github.com/csukuangfj/cppjieba/releases/download/sherpa-onnx-2024-04-19/dict.tar.bz2
+static const char *const kDictDir = "./dict";
+
+static void WriteLexicon(const std::string &filename) {
+  std::ofstream os(filename);
+  os << "相 xiang1\n"
+     << "交 jiao1\n"
+     << "世 shi4\n"
+     << "界 jie4\n"
+     << "你 ni3\n"
+     << "好 hao3\n";
+}
+
+// A rule that rewrites the pronunciation from to the word to, in the same
+// way as a byte-level rewrite rule compiled by pynini. Other bytes are
+// copied with a cost of 1 per byte, so the rewrite is always preferred.
+static void WriteRule(const std::string &filename, const std::string &from,
+                      const std::string &to) {
+  fst::StdVectorFst r;
+  int32_t start = r.AddState();
+  r.SetStart(start);
+  r.SetFinal(start, fst::TropicalWeight::One());
+
+  for (int32_t b = 1; b != 256; ++b) {
+    r.AddArc(start, fst::StdArc(b, b, 1.0f, start));
+  }
+
+  int32_t n = std::max(from.size(), to.size());
+  int32_t prev = start;
+  for (int32_t i = 0; i != n; ++i) {
+    int32_t ilabel =
+        i < static_cast<int32_t>(from.size()) ? static_cast<uint8_t>(from[i])
+                                              : 0;
+    int32_t olabel =
+        i < static_cast<int32_t>(to.size()) ? static_cast<uint8_t>(to[i]) : 0;
+    int32_t next = i + 1 == n ? start : r.AddState();
+    r.AddArc(prev, fst::StdArc(ilabel, olabel, 0.0f, next));
+    prev = next;
+  }
+
+  r.Write(filename);
+}
+
+class HomophoneReplacerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    WriteLexicon(lexicon_);
+    WriteRule(rule_a_, "xiang1jiao1", "香蕉");
+    WriteRule(rule_b_, "shi4jie4", "视界");
+  }
+
+  void TearDown() override {
+    remove(lexicon_.c_str());
+    remove(rule_a_.c_str());
+    remove(rule_b_.c_str());
+  }
+
+  HomophoneReplacerConfig GetConfig(const std::string &rule_fsts) const {
+    return HomophoneReplacerConfig(kDictDir, lexicon_, rule_fsts, false);
+  }
+
+  std::string lexicon_ = "homophone-replacer-test-lexicon.txt";
+  std::string rule_a_ = "homophone-replacer-test-a.fst";
+  std::string rule_b_ = "homophone-replacer-test-b.fst";
+};
+
+TEST_F(HomophoneReplacerTest, TwoRules) {
+  if (!FileExists(std::string(kDictDir) + "/jieba.dict.utf8")) {
+    SHERPA_ONNX_LOGE("%s does not exist. Skipping test", kDictDir);
+    return;
+  }
+
+  // Each rule is applied to the original text, so the order does not
+  // matter if they do not overlap
+  for (const auto &rule_fsts :
+       {rule_a_ + "," + rule_b_, rule_b_ + "," + rule_a_}) {
+    auto config = GetConfig(rule_fsts);
+    ASSERT_TRUE(config.Validate());
+
+    HomophoneReplacer replacer(config);
+    EXPECT_EQ(replacer.Apply("相交"), "香蕉") << rule_fsts;
+    EXPECT_EQ(replacer.Apply("世界"), "视界") << rule_fsts;
+    EXPECT_EQ(replacer.Apply("你好"), "你好") << rule_fsts;
+    EXPECT_EQ(replacer.Apply("相交，世界。你好"), "香蕉，视界。你好")
+        << rule_fsts;
+  }
+
+  // A single rule leaves the text of the other one unchanged
+  HomophoneReplacer replacer(GetConfig(rule_b_));
+  EXPECT_EQ(replacer.Apply("相交，世界。"), "相交，视界。");
+}
+
+TEST_F(HomophoneReplacerTest, Cache) {
+  if (!FileExists(std::string(kDictDir) + "/jieba.dict.utf8")) {
+    SHERPA_ONNX_LOGE("%s does not exist. Skipping test", kDictDir);
+    return;
+  }
+
+  std::vector<std::string> texts = {
+      "相交，", "相交，世界", "相交，世界。", "世界。相交，你好",
+      "你好，相交，", "相交，世界。",
+  };
+
+  auto config = GetConfig(rule_a_ + "," + rule_b_);
+  config.cache_size = 0;
+  HomophoneReplacer expected(config);
+
+  // A small cache evicts entries all the time
+  for (int32_t cache_size : {1, 2, 1000}) {
+    config.cache_size = cache_size;
+    HomophoneReplacer replacer(config);
+
+    // Twice, so that cached pieces are used
+    for (int32_t k = 0; k != 2; ++k) {
+      for (const auto &t : texts) {
+        EXPECT_EQ(replacer.Apply(t), expected.Apply(t)) << cache_size;
+      }
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -5,6 +5,8 @@
 #include "sherpa-onnx/csrc/homophone-replacer.h"
 
 #include <fstream>
+#include <list>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <strstream>
@@ -38,7 +40,13 @@ void HomophoneReplacerConfig::Register(ParseOptions *po) {
 
   po->Register("hr-rule-fsts", &rule_fsts,
                "Fst files for HomophoneReplacer. If there are multiple, they "
-               "are separated by a comma. E.g., a.fst,b.fst,c.fst");
+               "are separated by a comma. E.g., a.fst,b.fst,c.fst. "
+               "Each fst is applied to the original text. The result of the "
+               "first one that changes the text is used.");
+
+  po->Register("hr-cache-size", &cache_size,
+               "Maximum number of sentence pieces whose results are cached "
+               "by HomophoneReplacer. 0 disables the cache.");
 }
 
 bool HomophoneReplacerConfig::Validate() const {
@@ -66,11 +74,6 @@ bool HomophoneReplacerConfig::Validate() const {
     std::vector<std::string> files;
     SplitStringToVector(rule_fsts, ",", false, &files);
 
-    if (files.size() > 1) {
-      SHERPA_ONNX_LOGE("Only 1 file is supported now.");
-      SHERPA_ONNX_EXIT(-1);
-    }
-
     for (const auto &f : files) {
       if (!FileExists(f)) {
         SHERPA_ONNX_LOGE("Rule fst '%s' does not exist. ", f.c_str());
@@ -88,14 +91,118 @@ std::string HomophoneReplacerConfig::ToString() const {
   os << "HomophoneReplacerConfig(";
   os << "dict_dir=\"" << dict_dir << "\", ";
   os << "lexicon=\"" << lexicon << "\", ";
-  os << "rule_fsts=\"" << rule_fsts << "\")";
+  os << "rule_fsts=\"" << rule_fsts << "\", ";
+  os << "cache_size=" << cache_size << ")";
 
   return os.str();
 }
 
+// Return the number of bytes of the separator starting at text[i], or 0
+// if there is no separator at text[i].
+//
+// The separators are the same as SPECIAL_SEPARATORS of cppjieba. Jieba
+// splits its input at them before segmentation, so splitting the text at a
+// separator does not change the result of jieba.
+static int32_t SeparatorLength(const std::string &text, size_t i) {
+  char c = text[i];
+  if (c == ' ' || c == '\t' || c == '\n') {
+    return 1;
+  }
+
+  if (text.compare(i, 3, "，") == 0 || text.compare(i, 3, "。") == 0) {
+    return 3;
+  }
+
+  return 0;
+}
+
+static bool IsSeparator(const std::string &w) {
+  return !w.empty() && SeparatorLength(w, 0) == static_cast<int32_t>(w.size());
+}
+
+static bool EndsWithSeparator(const std::string &s) {
+  for (int32_t n : {1, 3}) {
+    if (static_cast<int32_t>(s.size()) >= n &&
+        SeparatorLength(s, s.size() - n) == n) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Split text into pieces. Each piece except the last one ends with a
+// separator.
+static std::vector<std::string> SplitAfterSeparators(const std::string &text) {
+  std::vector<std::string> ans;
+
+  size_t start = 0;
+  size_t i = 0;
+  while (i < text.size()) {
+    int32_t n = SeparatorLength(text, i);
+    if (n == 0) {
+      ++i;
+      continue;
+    }
+
+    i += n;
+    ans.push_back(text.substr(start, i - start));
+    start = i;
+  }
+
+  if (start < text.size()) {
+    ans.push_back(text.substr(start));
+  }
+
+  return ans;
+}
+
+// A string -> string cache that evicts the least recently used entry
+// when it is full. It is not thread-safe.
+class LruStringCache {
+ public:
+  explicit LruStringCache(int32_t max_size) : max_size_(max_size) {}
+
+  // Return nullptr if key is not cached. The returned pointer is valid
+  // until the next call to Insert().
+  const std::string *Find(const std::string &key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+
+    // Mark it as the most recently used one
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->second;
+  }
+
+  void Insert(const std::string &key, const std::string &value) {
+    if (max_size_ <= 0 || index_.count(key)) {
+      return;
+    }
+
+    entries_.emplace_front(key, value);
+    index_[key] = entries_.begin();
+
+    if (static_cast<int32_t>(entries_.size()) > max_size_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  int32_t max_size_;
+  std::list<std::pair<std::string, std::string>> entries_;
+  std::unordered_map<std::string,
+                     std::list<std::pair<std::string, std::string>>::iterator>
+      index_;
+};
+
 class HomophoneReplacer::Impl {
  public:
-  explicit Impl(const HomophoneReplacerConfig &config) : config_(config) {
+  explicit Impl(const HomophoneReplacerConfig &config)
+      : config_(config),
+        piece_cache_(config.cache_size),
+        pron_cache_(config.cache_size) {
     jieba_ = InitJieba(config.dict_dir);
 
     {
@@ -117,7 +224,10 @@ class HomophoneReplacer::Impl {
   }
 
   template <typename Manager>
-  Impl(Manager *mgr, const HomophoneReplacerConfig &config) : config_(config) {
+  Impl(Manager *mgr, const HomophoneReplacerConfig &config)
+      : config_(config),
+        piece_cache_(config.cache_size),
+        pron_cache_(config.cache_size) {
     jieba_ = InitJieba(config.dict_dir);
     {
       auto buf = ReadFile(mgr, config.lexicon);
@@ -149,12 +259,44 @@ class HomophoneReplacer::Impl {
       return ans;
     }
 
+    if (config_.debug) {
+      SHERPA_ONNX_LOGE("Input text: '%s'", text.c_str());
+    }
+
+    // Pieces are independent of each other. A piece that ends with a
+    // separator does not change when more text is appended, so it is
+    // cached. The last piece of a partial result is processed every time.
+    for (const auto &piece : SplitAfterSeparators(text)) {
+      bool complete = EndsWithSeparator(piece);
+
+      if (complete && LookupPiece(piece, &ans)) {
+        continue;
+      }
+
+      std::string r = ApplyPiece(piece);
+      if (complete) {
+        InsertPiece(piece, r);
+      }
+
+      ans += r;
+    }
+
+    if (config_.debug) {
+      SHERPA_ONNX_LOGE("Output text: '%s'", ans.c_str());
+    }
+
+    return ans;
+  }
+
+ private:
+  std::string ApplyPiece(const std::string &text) const {
+    std::string ans;
+
     bool is_hmm = true;
 
     std::vector<std::string> words;
     jieba_->Cut(text, words, is_hmm);
     if (config_.debug) {
-      SHERPA_ONNX_LOGE("Input text: '%s'", text.c_str());
       std::ostringstream os;
       os << "After jieba: ";
       std::string sep;
@@ -171,7 +313,8 @@ class HomophoneReplacer::Impl {
 
     for (const auto &w : words) {
       if (w.size() < 3 ||
-          reinterpret_cast<const uint8_t *>(w.data())[0] < 128) {
+          reinterpret_cast<const uint8_t *>(w.data())[0] < 128 ||
+          IsSeparator(w)) {
         if (!current_words.empty()) {
           ans += ApplyImpl(current_words, current_pronunciations);
           current_words.clear();
@@ -194,27 +337,65 @@ class HomophoneReplacer::Impl {
       ans += ApplyImpl(current_words, current_pronunciations);
     }
 
-    if (config_.debug) {
-      SHERPA_ONNX_LOGE("Output text: '%s'", ans.c_str());
-    }
-
     return ans;
   }
 
- private:
+  // Each rule fst is applied to the given words and pronunciations. The
+  // result of the first one that changes the words is used.
   std::string ApplyImpl(const std::vector<std::string> &words,
                         const std::vector<std::string> &pronunciations) const {
     std::string ans;
+    if (replacer_list_.empty()) {
+      return ans;
+    }
+
+    std::string text;
+    if (replacer_list_.size() > 1) {
+      for (const auto &w : words) {
+        text += w;
+      }
+    }
+
     for (const auto &r : replacer_list_) {
       ans = r->Normalize(words, pronunciations);
-      // TODO(fangjun): We support only 1 rule fst at present.
-      break;
+      if (ans != text) {
+        break;
+      }
     }
+
     return ans;
   }
+
+  // Append the cached result of piece to ans. Return false if it is not
+  // cached.
+  bool LookupPiece(const std::string &piece, std::string *ans) const {
+    if (config_.cache_size <= 0) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string *r = piece_cache_.Find(piece);
+    if (!r) {
+      return false;
+    }
+
+    ans->append(*r);
+    return true;
+  }
+
+  void InsertPiece(const std::string &piece, const std::string &r) const {
+    if (config_.cache_size <= 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    piece_cache_.Insert(piece, r);
+  }
+
   std::string ConvertWordToPronunciation(const std::string &word) const {
-    if (word2pron_.count(word)) {
-      return word2pron_.at(word);
+    auto it = word2pron_.find(word);
+    if (it != word2pron_.end()) {
+      return it->second;
     }
 
     if (word.size() <= 3) {
@@ -222,16 +403,32 @@ class HomophoneReplacer::Impl {
       return word;
     }
 
+    // Words not in the lexicon are converted character by character.
+    // Cache the result since names and terms occur again and again.
+    if (config_.cache_size > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const std::string *p = pron_cache_.Find(word);
+      if (p) {
+        return *p;
+      }
+    }
+
     std::vector<std::string> words = SplitUtf8(word);
     std::string ans;
     for (const auto &w : words) {
-      if (word2pron_.count(w)) {
-        ans.append(word2pron_.at(w));
+      auto it = word2pron_.find(w);
+      if (it != word2pron_.end()) {
+        ans.append(it->second);
       } else {
         ans.append(w);
       }
     }
 
+    if (config_.cache_size > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pron_cache_.Insert(word, ans);
+    }
+
     return ans;
   }
 
@@ -280,9 +477,15 @@ class HomophoneReplacer::Impl {
 
  private:
   HomophoneReplacerConfig config_;
-  std::unique_ptr<cppjieba::Jieba> jieba_;
+  std::shared_ptr<const cppjieba::Jieba> jieba_;
   std::vector<std::unique_ptr<kaldifst::TextNormalizer>> replacer_list_;
   std::unordered_map<std::string, std::string> word2pron_;
+
+  mutable std::mutex mutex_;
+  // Sentence piece -> result
+  mutable LruStringCache piece_cache_;
+  // Word that is not in the lexicon -> pronunciation
+  mutable LruStringCache pron_cache_;
 };
 
 HomophoneReplacer::HomophoneReplacer(const HomophoneReplacerConfig &config)
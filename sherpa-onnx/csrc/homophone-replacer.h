@@ -19,7 +19,14 @@ struct HomophoneReplacerConfig {
   // comma separated fst files, e.g. a.fst,b.fst,c.fst
   std::string rule_fsts;
 
-  bool debug;
+  bool debug = false;
+
+  // Maximum number of cached sentence pieces. A piece is a part of the
+  // input text that ends with a jieba separator, e.g., "，" or "。".
+  // Partial results of streaming ASR share their prefix with the previous
+  // partial result, so only the changed suffix is processed again.
+  // 0 disables the cache.
+  int32_t cache_size = 1000;
 
   HomophoneReplacerConfig() = default;
 
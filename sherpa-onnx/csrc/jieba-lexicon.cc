@@ -5,7 +5,6 @@
 #include "sherpa-onnx/csrc/jieba-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
 #include <strstream>
 #include <unordered_set>
 #include <utility>
@@ -24,6 +23,7 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-normalizer.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -77,17 +77,15 @@ class JiebaLexicon::Impl {
   std::vector<TokenIDs> ConvertTextToTokenIds(const std::string &text) const {
     // see
     // https://github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
-    std::regex punct_re{"：|、|；"};
-    std::string s = std::regex_replace(text, punct_re, "，");
-
-    std::regex punct_re2("[.]");
-    s = std::regex_replace(s, punct_re2, "。");
-
-    std::regex punct_re3("[?]");
-    s = std::regex_replace(s, punct_re3, "？");
-
-    std::regex punct_re4("[!]");
-    s = std::regex_replace(s, punct_re4, "！");
+    static const TextNormalizer normalizer({
+        {"：", "，"},
+        {"、", "，"},
+        {"；", "，"},
+        {".", "。"},
+        {"?", "？"},
+        {"!", "！"},
+    });
+    std::string s = normalizer.Normalize(text);
 
     std::vector<std::string> words;
     bool is_hmm = true;
@@ -286,7 +284,7 @@ class JiebaLexicon::Impl {
   // tokens.txt is saved in token2id_
   std::unordered_map<std::string, int32_t> token2id_;
 
-  std::unique_ptr<cppjieba::Jieba> jieba_;
+  std::shared_ptr<const cppjieba::Jieba> jieba_;
   bool debug_ = false;
 };
 
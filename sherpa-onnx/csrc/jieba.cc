@@ -4,15 +4,14 @@
 
 #include "sherpa-onnx/csrc/jieba.h"
 
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
 #include "sherpa-onnx/csrc/file-utils.h"
 
 namespace sherpa_onnx {
 
-std::unique_ptr<cppjieba::Jieba> InitJieba(const std::string &dict_dir) {
-  if (dict_dir.empty()) {
-    return {};
-  }
-
+static std::unique_ptr<cppjieba::Jieba> LoadJieba(const std::string &dict_dir) {
   std::string dict = dict_dir + "/jieba.dict.utf8";
   std::string hmm = dict_dir + "/hmm_model.utf8";
   std::string user_dict = dict_dir + "/user.dict.utf8";
@@ -29,4 +28,28 @@ std::unique_ptr<cppjieba::Jieba> InitJieba(const std::string &dict_dir) {
                                            stop_word);
 }
 
+std::shared_ptr<const cppjieba::Jieba> InitJieba(const std::string &dict_dir) {
+  if (dict_dir.empty()) {
+    return {};
+  }
+
+  static std::mutex mutex;
+  static std::unordered_map<std::string,
+                            std::weak_ptr<const cppjieba::Jieba>>
+      cache;
+
+  // Loading takes a while. Keep the lock so that concurrent callers wait
+  // for the first one instead of loading the same dictionary again.
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto &p = cache[dict_dir];
+  std::shared_ptr<const cppjieba::Jieba> ans = p.lock();
+  if (!ans) {
+    ans = LoadJieba(dict_dir);
+    p = ans;
+  }
+
+  return ans;
+}
+
 }  // namespace sherpa_onnx
@@ -12,7 +12,13 @@
 
 namespace sherpa_onnx {
 
-std::unique_ptr<cppjieba::Jieba> InitJieba(const std::string &dict_dir);
+// Return the jieba instance for dict_dir, or nullptr if dict_dir is empty.
+//
+// The instance is shared by all callers in the process, so the dictionary
+// is loaded and kept in memory only once for each dict_dir as long as
+// one of the returned pointers is alive. cppjieba::Jieba::Cut() is const
+// and can be called from multiple threads at the same time.
+std::shared_ptr<const cppjieba::Jieba> InitJieba(const std::string &dict_dir);
 }
 
 #endif  // SHERPA_ONNX_CSRC_JIEBA_H_
@@ -7,7 +7,6 @@
 
 #include <algorithm>
 #include <memory>
-#include <regex>  // NOLINT
 #include <string>
 #include <strstream>
 #include <utility>
@@ -17,8 +16,10 @@
 #include "sherpa-onnx/csrc/keyword-spotter-impl.h"
 #include "sherpa-onnx/csrc/keyword-spotter.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-batched-states.h"
 #include "sherpa-onnx/csrc/online-transducer-model.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/transducer-keyword-decoder.h"
 #include "sherpa-onnx/csrc/utils.h"
 
@@ -112,7 +113,8 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
 
   std::unique_ptr<OnlineStream> CreateStream(
       const std::string &keywords) const override {
-    auto kws = std::regex_replace(keywords, std::regex("/"), "\n");
+    auto kws = keywords;
+    std::replace(kws.begin(), kws.end(), '/', '\n');
     std::istringstream is(kws);
 
     std::vector<std::vector<int32_t>> current_ids;
@@ -220,6 +222,14 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
     std::vector<std::vector<Ort::Value>> states_vec(n);
     std::vector<int64_t> all_processed_frames(n);
 
+    // If ss contains the same streams as the previous call, reuse the
+    // output states of that call without unstacking and stacking them
+    std::vector<OnlineStream *> sorted;
+    std::vector<Ort::Value> states = TakeBatchedStates(ss, n, &sorted);
+    if (!states.empty()) {
+      ss = sorted.data();
+    }
+
     for (int32_t i = 0; i != n; ++i) {
       SHERPA_ONNX_CHECK(ss[i]->GetContextGraph() != nullptr);
 
@@ -234,7 +244,9 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
                 features_vec.data() + i * chunk_size * feature_dim);
 
       results[i] = std::move(ss[i]->GetKeywordResult());
-      states_vec[i] = std::move(ss[i]->GetStates());
+      if (states.empty()) {
+        states_vec[i] = std::move(ss[i]->GetStates());
+      }
       all_processed_frames[i] = num_processed_frames;
     }
 
@@ -254,19 +266,26 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
         memory_info, all_processed_frames.data(), all_processed_frames.size(),
         processed_frames_shape.data(), processed_frames_shape.size());
 
-    auto states = model_->StackStates(states_vec);
+    if (states.empty()) {
+      states = model_->StackStates(states_vec);
+    }
 
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto pair = model_->RunEncoder(std::move(x), std::move(states),
                                    std::move(processed_frames));
+    encoder_trace.Stop();
 
     decoder_->Decode(std::move(pair.first), ss, &results);
 
-    std::vector<std::vector<Ort::Value>> next_states =
-        model_->UnStackStates(pair.second);
+    auto next_states = std::make_shared<BatchedStates>(
+        std::move(pair.second), n,
+        [model = model_.get()](std::vector<Ort::Value> s) {
+          return model->UnStackStates(s);
+        });
 
     for (int32_t i = 0; i != n; ++i) {
       ss[i]->SetKeywordResult(results[i]);
-      ss[i]->SetStates(std::move(next_states[i]));
+      ss[i]->SetBatchedStates(next_states, i);
     }
   }
 
@@ -5,7 +5,6 @@
 #include "sherpa-onnx/csrc/kokoro-multi-lang-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <strstream>
 #include <unordered_map>
@@ -29,6 +28,7 @@
 #include "sherpa-onnx/csrc/jieba.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-normalizer.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -73,48 +73,35 @@ class KokoroMultiLangLexicon::Impl {
       SHERPA_ONNX_LOGE("After converting to lowercase:\n%s", text.c_str());
     }
 
-    std::vector<std::pair<std::string, std::string>> replace_str_pairs = {
-        {"，", ","}, {":", ","},  {"、", ","}, {"；", ";"},   {"：", ":"},
-        {"。", "."}, {"？", "?"}, {"！", "!"}, {"\\s+", " "},
-    };
-    for (const auto &p : replace_str_pairs) {
-      std::regex re(p.first);
-      text = std::regex_replace(text, re, p.second);
-    }
+    // The characters are replaced in a single pass. Runs of whitespace are
+    // merged into a single space.
+    static const TextNormalizer normalizer(
+        {
+            {"，", ","},
+            {":", ","},
+            {"、", ","},
+            {"；", ";"},
+            {"：", ":"},
+            {"。", "."},
+            {"？", "?"},
+            {"！", "!"},
+        },
+        /*merge_spaces*/ true);
+
+    text = normalizer.Normalize(text);
 
     if (debug_) {
       SHERPA_ONNX_LOGE("After replacing punctuations and merging spaces:\n%s",
                        text.c_str());
     }
 
-    // https://en.cppreference.com/w/cpp/regex
-    // https://stackoverflow.com/questions/37989081/how-to-use-unicode-range-in-c-regex
-    std::string expr_chinese = "([\\u4e00-\\u9fff]+)";
-    std::string expr_not_chinese = "([^\\u4e00-\\u9fff]+)";
-
-    std::string expr_both = expr_chinese + "|" + expr_not_chinese;
-
-    auto ws = ToWideString(text);
-    std::wstring wexpr_both = ToWideString(expr_both);
-    std::wregex we_both(wexpr_both);
-
-    std::wstring wexpr_zh = ToWideString(expr_chinese);
-    std::wregex we_zh(wexpr_zh);
-
-    auto begin = std::wsregex_iterator(ws.begin(), ws.end(), we_both);
-    auto end = std::wsregex_iterator();
-
     std::vector<TokenIDs> ans;
 
-    for (std::wsregex_iterator i = begin; i != end; ++i) {
-      std::wsmatch match = *i;
-      std::wstring match_str = match.str();
-
-      auto ms = ToString(match_str);
-      uint8_t c = reinterpret_cast<const uint8_t *>(ms.data())[0];
+    for (const auto &run : SplitChineseAndNonChinese(text)) {
+      const auto &ms = run.text;
 
       std::vector<std::vector<int32_t>> ids_vec;
-      if (std::regex_match(match_str, we_zh)) {
+      if (run.is_chinese) {
         if (debug_) {
           SHERPA_ONNX_LOGE("Chinese: %s", ms.c_str());
         }
@@ -465,7 +452,7 @@ class KokoroMultiLangLexicon::Impl {
   // tokens.txt is saved in token2id_
   std::unordered_map<std::string, int32_t> token2id_;
 
-  std::unique_ptr<cppjieba::Jieba> jieba_;
+  std::shared_ptr<const cppjieba::Jieba> jieba_;
   bool debug_ = false;
 };
 
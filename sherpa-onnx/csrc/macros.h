@@ -6,7 +6,9 @@
 #define SHERPA_ONNX_CSRC_MACROS_H_
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <atomic>
 #include <utility>
 #if __OHOS__
 #include "hilog/log.h"
@@ -49,6 +51,93 @@
   } while (0)
 #endif
 
+// Leveled logging.
+//
+//  SHERPA_ONNX_LOGT(...)  trace, e.g., values of tensors
+//  SHERPA_ONNX_LOGD(...)  debug, e.g., per-sentence diagnostics
+//  SHERPA_ONNX_LOGI(...)  info
+//  SHERPA_ONNX_LOGW(...)  warning
+//  SHERPA_ONNX_LOGE(...)  error. It is always printed.
+//
+// A message is printed only if its level is not below
+// SHERPA_ONNX_MIN_LOG_LEVEL, which is fixed at compile time, and not below
+// the runtime level, which is INFO by default. The runtime level can be
+// changed with the environment variable SHERPA_ONNX_LOG_LEVEL, e.g.,
+// SHERPA_ONNX_LOG_LEVEL=WARN, or with sherpa_onnx::SetLogLevel().
+//
+// Arguments are not evaluated if the message is not printed. For messages
+// that need extra work to build, use
+//
+//   if (SHERPA_ONNX_LOG_ENABLED(DEBUG)) {
+//     std::ostringstream os;
+//     ...
+//     SHERPA_ONNX_LOGD("%s", os.str().c_str());
+//   }
+#define SHERPA_ONNX_LOG_LEVEL_TRACE 0
+#define SHERPA_ONNX_LOG_LEVEL_DEBUG 1
+#define SHERPA_ONNX_LOG_LEVEL_INFO 2
+#define SHERPA_ONNX_LOG_LEVEL_WARN 3
+#define SHERPA_ONNX_LOG_LEVEL_ERROR 4
+
+#ifndef SHERPA_ONNX_MIN_LOG_LEVEL
+#define SHERPA_ONNX_MIN_LOG_LEVEL SHERPA_ONNX_LOG_LEVEL_TRACE
+#endif
+
+namespace sherpa_onnx {
+
+inline std::atomic<int> &RuntimeLogLevel() {
+  static std::atomic<int> level{[]() {
+    const char *s = getenv("SHERPA_ONNX_LOG_LEVEL");
+    if (s == nullptr) return SHERPA_ONNX_LOG_LEVEL_INFO;
+    if (strcmp(s, "TRACE") == 0) return SHERPA_ONNX_LOG_LEVEL_TRACE;
+    if (strcmp(s, "DEBUG") == 0) return SHERPA_ONNX_LOG_LEVEL_DEBUG;
+    if (strcmp(s, "WARN") == 0 || strcmp(s, "WARNING") == 0) {
+      return SHERPA_ONNX_LOG_LEVEL_WARN;
+    }
+    if (strcmp(s, "ERROR") == 0) return SHERPA_ONNX_LOG_LEVEL_ERROR;
+    return SHERPA_ONNX_LOG_LEVEL_INFO;
+  }()};
+  return level;
+}
+
+// level is one of SHERPA_ONNX_LOG_LEVEL_XXX
+inline void SetLogLevel(int level) {
+  RuntimeLogLevel().store(level, std::memory_order_relaxed);
+}
+
+inline int GetLogLevel() {
+  return RuntimeLogLevel().load(std::memory_order_relaxed);
+}
+
+}  // namespace sherpa_onnx
+
+// value is one of SHERPA_ONNX_LOG_LEVEL_XXX. The first comparison is
+// known at compile time, so the code is removed if it is false.
+#define SHERPA_ONNX_LOG_LEVEL_ENABLED(value) \
+  ((value) >= SHERPA_ONNX_MIN_LOG_LEVEL &&    \
+   (value) >= sherpa_onnx::GetLogLevel())
+
+// level is one of TRACE, DEBUG, INFO, WARN, ERROR. It is not expanded, so
+// it is fine if, e.g., ERROR is defined as a macro by windows.h
+#define SHERPA_ONNX_LOG_ENABLED(level) \
+  SHERPA_ONNX_LOG_LEVEL_ENABLED(SHERPA_ONNX_LOG_LEVEL_##level)
+
+#define SHERPA_ONNX_LOG_AT(value, ...)          \
+  do {                                          \
+    if (SHERPA_ONNX_LOG_LEVEL_ENABLED(value)) { \
+      SHERPA_ONNX_LOGE(__VA_ARGS__);            \
+    }                                           \
+  } while (0)
+
+#define SHERPA_ONNX_LOGT(...) \
+  SHERPA_ONNX_LOG_AT(SHERPA_ONNX_LOG_LEVEL_TRACE, __VA_ARGS__)
+#define SHERPA_ONNX_LOGD(...) \
+  SHERPA_ONNX_LOG_AT(SHERPA_ONNX_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define SHERPA_ONNX_LOGI(...) \
+  SHERPA_ONNX_LOG_AT(SHERPA_ONNX_LOG_LEVEL_INFO, __VA_ARGS__)
+#define SHERPA_ONNX_LOGW(...) \
+  SHERPA_ONNX_LOG_AT(SHERPA_ONNX_LOG_LEVEL_WARN, __VA_ARGS__)
+
 #define SHERPA_ONNX_EXIT(code) exit(code)
 
 // Read an integer
@@ -1,6 +1,8 @@
 ﻿#include "sherpa-onnx/csrc/melo-tts-ko-synthesizer-processor.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -14,18 +16,22 @@ GeneratedAudio SynthesizerProcessor::ProcessAllSentences(
     ProcessCallback callback) {
   
   if (sentences.empty()) {
-    SHERPA_ONNX_LOGE("No sentences to process.");
+    SHERPA_ONNX_LOGD("No sentences to process.");
     return {};
   }
 
-  stop_requested_ = false;
+  // Per call, so that concurrent calls do not stop each other. Queued
+  // sentences of this call are dropped once it is set
+  std::atomic<bool> stop(false);
+  int64_t generation = stop_generation_;
+
   GeneratedAudio final_audio_output;
   final_audio_output.sample_rate = 0;
 
   int32_t total_sentences = static_cast<int32_t>(sentences.size());
   int32_t processed_count = 0;
   
-  SHERPA_ONNX_LOGE("Starting pipelined processing of %d sentences with chunk size %zu...", 
+  SHERPA_ONNX_LOGD("Starting pipelined processing of %d sentences with chunk size %zu...", 
                    total_sentences, chunk_size_);
 
   // 파이프라인 방식: 모든 futures를 관리하되, 청크 단위로 제출
@@ -38,16 +44,19 @@ GeneratedAudio SynthesizerProcessor::ProcessAllSentences(
   // 첫 번째 청크를 미리 제출
   size_t initial_chunk_end = std::min(chunk_size_, sentences.size());
   for (size_t i = 0; i < initial_chunk_end; ++i) {
-    SubmitSentence(sentences, ja_berts, phone_ids, tones, i, sid, speed, all_futures);
+    SubmitSentence(sentences, ja_berts, phone_ids, tones, i, sid, speed,
+                   &stop, generation, all_futures);
   }
   next_to_submit = initial_chunk_end;
   
-  SHERPA_ONNX_LOGE("Initial chunk [0, %zu) submitted to ThreadPool", initial_chunk_end);
+  SHERPA_ONNX_LOGD("Initial chunk [0, %zu) submitted to ThreadPool", initial_chunk_end);
 
   // 파이프라인 처리: 결과 수집과 동시에 새로운 작업 제출
   while (next_to_collect < sentences.size()) {
-    if (stop_requested_.load()) {
-      SHERPA_ONNX_LOGE("Processing stopped by request at sentence %zu.", next_to_collect);
+    if (stop_generation_ != generation || IsOfflineTtsRequestCancelled()) {
+      SHERPA_ONNX_LOGD("Processing stopped by request at sentence %zu.",
+                       next_to_collect);
+      stop = true;
       break;
     }
 
@@ -76,13 +85,13 @@ GeneratedAudio SynthesizerProcessor::ProcessAllSentences(
             progress);
         
         if (continue_processing == 0) {
-          SHERPA_ONNX_LOGE("Callback requested stop at sentence %zu.", next_to_collect);
-          stop_requested_ = true;
+          SHERPA_ONNX_LOGT("Callback requested stop at sentence %zu.", next_to_collect);
+          stop = true;
           break;
         }
       }
 
-      SHERPA_ONNX_LOGE("Processed sentence %zu/%d (%.1f%%)", 
+      SHERPA_ONNX_LOGT("Processed sentence %zu/%d (%.1f%%)", 
                        next_to_collect + 1, total_sentences, 
                        (float)processed_count * 100.0f / total_sentences);
 
@@ -90,20 +99,29 @@ GeneratedAudio SynthesizerProcessor::ProcessAllSentences(
 
       // 결과를 하나 수집할 때마다 새로운 문장을 제출 (파이프라인 유지)
       if (next_to_submit < sentences.size()) {
-        SubmitSentence(sentences, ja_berts, phone_ids, tones, next_to_submit, sid, speed, all_futures);
-        SHERPA_ONNX_LOGE("Submitted sentence %zu to maintain pipeline", next_to_submit);
+        SubmitSentence(sentences, ja_berts, phone_ids, tones, next_to_submit,
+                       sid, speed, &stop, generation, all_futures);
+        SHERPA_ONNX_LOGT("Submitted sentence %zu to maintain pipeline", next_to_submit);
         next_to_submit++;
       }
 
     } catch (const std::exception &e) {
       SHERPA_ONNX_LOGE("Error getting result for sentence %zu: %s", 
                        next_to_collect, e.what());
-      stop_requested_ = true;
+      stop = true;
       break;
     }
   }
 
-  SHERPA_ONNX_LOGE("Finished pipelined processing. Total processed: %d/%d", 
+  // Queued sentences return at once since stop is set. Wait for them as
+  // they use stop and the request of the caller
+  for (size_t i = next_to_collect; i < all_futures.size(); ++i) {
+    if (all_futures[i].valid()) {
+      all_futures[i].wait();
+    }
+  }
+
+  SHERPA_ONNX_LOGD("Finished pipelined processing. Total processed: %d/%d", 
                    processed_count, total_sentences);
   return final_audio_output;
 }
@@ -116,6 +134,8 @@ void SynthesizerProcessor::SubmitSentence(
     size_t sentence_idx,
     int32_t sid, 
     float speed,
+    const std::atomic<bool> *stop,
+    int64_t generation,
     std::vector<std::future<GeneratedAudio>> &futures) {
 
   // 데이터 복사 (lambda 캡처를 위해)
@@ -124,25 +144,35 @@ void SynthesizerProcessor::SubmitSentence(
   std::vector<int64_t> phone_ids_copy = phone_ids[sentence_idx];
   std::vector<int64_t> tones_copy = tones[sentence_idx];
 
-  futures.push_back(
-      thread_pool_.enqueue(
-          process_fn_,
-          text_copy, ja_bert_copy, phone_ids_copy, tones_copy, sid, speed));
+  // Stages run by the worker are counted in the request of the caller
+  TraceRequest *request = CurrentTraceRequest();
+  const OfflineTtsRequestOptions *options = CurrentOfflineTtsRequest();
+  futures.push_back(thread_pool_.enqueue_with_priority(
+      CurrentOfflineTtsPriority(),
+      [this, request, options, stop, generation](
+          const std::string &text, std::vector<float> &ja_bert,
+          const std::vector<int64_t> &phone_ids,
+          const std::vector<int64_t> &tones, int32_t sid, float speed) {
+        ScopedTraceRequest scoped_request(request);
+        ScopedOfflineTtsRequest scoped_options(options);
+
+        // Dropped without running the model
+        if (*stop || stop_generation_ != generation ||
+            IsOfflineTtsRequestCancelled()) {
+          return GeneratedAudio{};
+        }
+
+        return process_fn_(text, ja_bert, phone_ids, tones, sid, speed);
+      },
+      text_copy, ja_bert_copy, phone_ids_copy, tones_copy, sid, speed));
 }
 
 void SynthesizerProcessor::StopProcessing() {
-  SHERPA_ONNX_LOGE("StopProcessing called.");
-  stop_requested_ = true;
-  
-  // ThreadPool 안전하게 종료
-  try {
-    thread_pool_.stop();
-    SHERPA_ONNX_LOGE("ThreadPool stopped successfully.");
-  } catch (const std::exception &e) {
-    SHERPA_ONNX_LOGE("Error stopping ThreadPool: %s", e.what());
-  } catch (...) {
-    SHERPA_ONNX_LOGE("Unknown error stopping ThreadPool.");
-  }
+  SHERPA_ONNX_LOGD("StopProcessing called.");
+
+  // The ThreadPool is kept so that the processor can be used afterwards.
+  // It is stopped in the destructor
+  stop_generation_ += 1;
 }
 
 }  // namespace sherpa_onnx
\ No newline at end of file
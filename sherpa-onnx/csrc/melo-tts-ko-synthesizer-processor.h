@@ -12,28 +12,36 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/offline-tts.h"
 
 namespace sherpa_onnx {
 
+// Queued tasks of interactive requests run before queued tasks of batch
+// requests.
 class ThreadPool {
  public:
   ThreadPool(size_t num_threads) : stop_(false) {
-    SHERPA_ONNX_LOGE("ThreadPool: Creating %zu worker threads.", num_threads);
+    SHERPA_ONNX_LOGD("ThreadPool: Creating %zu worker threads.", num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
       workers_.emplace_back([this, i] {
-        SHERPA_ONNX_LOGE("ThreadPool: Worker thread %zu started.", i);
+        SHERPA_ONNX_LOGD("ThreadPool: Worker thread %zu started.", i);
         for (;;) {
           std::function<void()> task;
           {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-            if (stop_ && tasks_.empty()) {
-              SHERPA_ONNX_LOGE("ThreadPool: Worker thread %zu exiting.", i);
+            condition_.wait(lock, [this] { return stop_ || NumTasks() > 0; });
+            if (stop_ && NumTasks() == 0) {
+              SHERPA_ONNX_LOGT("ThreadPool: Worker thread %zu exiting.", i);
               return;
             }
-            task = std::move(tasks_.front());
-            tasks_.pop();
+            for (auto &tasks : tasks_) {
+              if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop();
+                break;
+              }
+            }
           }
           try {
             task();
@@ -45,13 +53,13 @@ class ThreadPool {
         }
       });
     }
-    SHERPA_ONNX_LOGE("ThreadPool: All worker threads created.");
+    SHERPA_ONNX_LOGD("ThreadPool: All worker threads created.");
   }
 
   ~ThreadPool() {
-    SHERPA_ONNX_LOGE("ThreadPool: Destructor called. Stopping threads.");
+    SHERPA_ONNX_LOGD("ThreadPool: Destructor called. Stopping threads.");
     stop();
-    SHERPA_ONNX_LOGE("ThreadPool: Destructor finished.");
+    SHERPA_ONNX_LOGD("ThreadPool: Destructor finished.");
   }
 
   void stop() {
@@ -64,10 +72,10 @@ class ThreadPool {
     
     for (size_t i = 0; i < workers_.size(); ++i) {
       if (workers_[i].joinable()) {
-        SHERPA_ONNX_LOGE("ThreadPool: Joining worker thread %zu...", i);
+        SHERPA_ONNX_LOGT("ThreadPool: Joining worker thread %zu...", i);
         try {
           workers_[i].join();
-          SHERPA_ONNX_LOGE("ThreadPool: Worker thread %zu joined successfully.", i);
+          SHERPA_ONNX_LOGT("ThreadPool: Worker thread %zu joined successfully.", i);
         } catch (const std::exception& e) {
           SHERPA_ONNX_LOGE("ThreadPool: Exception joining thread %zu: %s", i, e.what());
         }
@@ -78,6 +86,15 @@ class ThreadPool {
   template <class F, class... Args>
   auto enqueue(F &&f, Args &&...args)
       -> std::future<typename std::result_of<F(Args...)>::type> {
+    return enqueue_with_priority(OfflineTtsPriority::kInteractive,
+                                 std::forward<F>(f),
+                                 std::forward<Args>(args)...);
+  }
+
+  template <class F, class... Args>
+  auto enqueue_with_priority(OfflineTtsPriority priority, F &&f,
+                             Args &&...args)
+      -> std::future<typename std::result_of<F(Args...)>::type> {
     using return_type = typename std::result_of<F(Args...)>::type;
 
     auto task = std::make_shared<std::packaged_task<return_type()>>(
@@ -89,15 +106,24 @@ class ThreadPool {
       if (stop_) {
         throw std::runtime_error("enqueue on stopped ThreadPool");
       }
-      tasks_.emplace([task]() { (*task)(); });
+      tasks_[static_cast<int32_t>(priority)].emplace([task]() { (*task)(); });
     }
     condition_.notify_one();
     return res;
   }
 
  private:
+  // The caller holds queue_mutex_
+  size_t NumTasks() const {
+    size_t n = 0;
+    for (const auto &tasks : tasks_) {
+      n += tasks.size();
+    }
+    return n;
+  }
+
   std::vector<std::thread> workers_;
-  std::queue<std::function<void()>> tasks_;
+  std::queue<std::function<void()>> tasks_[kNumOfflineTtsPriorities];
   std::mutex queue_mutex_;
   std::condition_variable condition_;
   bool stop_;
@@ -117,14 +143,15 @@ class SynthesizerProcessor {
       : process_fn_(process_fn),
         thread_pool_(num_synthesis_threads > 0 ? num_synthesis_threads : 1),
         chunk_size_(chunk_size),
-        stop_requested_(false) {
-    SHERPA_ONNX_LOGE(
+        stop_generation_(0) {
+    SHERPA_ONNX_LOGD(
         "SynthesizerProcessor initialized with %zu synthesis threads, chunk size %zu.",
         num_synthesis_threads > 0 ? num_synthesis_threads : 1, chunk_size);
   }
 
   ~SynthesizerProcessor() {
     StopProcessing();
+    thread_pool_.stop();
   }
 
   GeneratedAudio ProcessAllSentences(
@@ -136,6 +163,8 @@ class SynthesizerProcessor {
       float speed,
       ProcessCallback callback = nullptr);
 
+  // Stop all running calls of ProcessAllSentences(). Their queued sentences
+  // are dropped. The processor can still be used afterwards.
   void StopProcessing();
 
  private:
@@ -145,7 +174,8 @@ class SynthesizerProcessor {
 
   ThreadPool thread_pool_;
   size_t chunk_size_;
-  std::atomic<bool> stop_requested_;
+  // Incremented by StopProcessing()
+  std::atomic<int64_t> stop_generation_;
 
   // 청크 단위로 처리하는 내부 함수
   void SubmitSentence(
@@ -156,6 +186,8 @@ class SynthesizerProcessor {
       size_t sentence_idx,
       int32_t sid, 
       float speed,
+      const std::atomic<bool> *stop,
+      int64_t generation,
       std::vector<std::future<GeneratedAudio>> &futures);
 };
 
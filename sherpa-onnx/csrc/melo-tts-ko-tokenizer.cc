@@ -18,17 +18,17 @@ static std::string to_lower(const std::string &str) {
 WordPieceTokenizer::WordPieceTokenizer(std::istream &vocab_file,
                                        bool do_lower_case)
     : do_lower_case(do_lower_case) {
-  SHERPA_ONNX_LOGE(
+  SHERPA_ONNX_LOGD(
       ">>>> WordPieceTokenizer::WordPieceTokenizer init load_vocab start");
   load_vocab(vocab_file);
-  SHERPA_ONNX_LOGE(
+  SHERPA_ONNX_LOGD(
       ">>>> WordPieceTokenizer::WordPieceTokenizer init load_vocab end");
 }
 
 void WordPieceTokenizer::load_vocab(std::istream &vocab_file) {
-    SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::load_vocab start");
+    SHERPA_ONNX_LOGD(">>>> WordPieceTokenizer::load_vocab start");
 //   std::ifstream file(vocab_file);
-  SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::load_vocab file read");
+  SHERPA_ONNX_LOGD(">>>> WordPieceTokenizer::load_vocab file read");
 //   if (!file.is_open()) {
 //     SHERPA_ONNX_LOGE("Failed to open vocab file");
 //     throw std::runtime_error("Failed to open vocab file");
@@ -38,14 +38,14 @@ void WordPieceTokenizer::load_vocab(std::istream &vocab_file) {
   while (std::getline(vocab_file, line)) {
     vocab[line] = index++;
   }
-  SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::load_vocab end vocab size: %d,%d", vocab.size(), index);
+  SHERPA_ONNX_LOGD(">>>> WordPieceTokenizer::load_vocab end vocab size: %d,%d", vocab.size(), index);
   // for(int i = 0; i < 10; i++) {
   char * vocab_key0 = "릱";
-  SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::load_vocab vocab at %s : %d", vocab_key0, vocab[vocab_key0]);
+  SHERPA_ONNX_LOGD(">>>> WordPieceTokenizer::load_vocab vocab at %s : %d", vocab_key0, vocab[vocab_key0]);
   char * vocab_key1 = "릿";
-  SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::load_vocab vocab at %s : %d", vocab_key1, vocab[vocab_key1]);
+  SHERPA_ONNX_LOGD(">>>> WordPieceTokenizer::load_vocab vocab at %s : %d", vocab_key1, vocab[vocab_key1]);
   char * vocab_key2 = "##조개";
-  SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::load_vocab vocab at %s : %d", vocab_key2, vocab[vocab_key2]);
+  SHERPA_ONNX_LOGD(">>>> WordPieceTokenizer::load_vocab vocab at %s : %d", vocab_key2, vocab[vocab_key2]);
 
   // }
 }
@@ -110,7 +110,7 @@ std::vector<std::string> WordPieceTokenizer::wordpiece_tokenize(
 }
 
 std::vector<std::string> WordPieceTokenizer::tokenize(const std::string &text) {
-  SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::tokenize start");
+  SHERPA_ONNX_LOGT(">>>> WordPieceTokenizer::tokenize start");
   std::vector<std::string> basic_tokens = basic_tokenize(text);
   std::vector<std::string> wordpieces;
 
@@ -119,7 +119,7 @@ std::vector<std::string> WordPieceTokenizer::tokenize(const std::string &text) {
     wordpieces.insert(wordpieces.end(), pieces.begin(), pieces.end());
   }
 
-  SHERPA_ONNX_LOGE( ">>>> WordPieceTokenizer::tokenize end");
+  SHERPA_ONNX_LOGT( ">>>> WordPieceTokenizer::tokenize end");
   return wordpieces;
 }
 
@@ -129,7 +129,7 @@ std::vector<std::string> WordPieceTokenizer::tokenize(const std::string &text) {
 /// tokenized wordpieces.size() + 2 (first;2 and last;3)
 std::pair<std::vector<std::string>, std::vector<int>>
 WordPieceTokenizer::tokenize_with_ids(const std::string &text) {
-    SHERPA_ONNX_LOGE(">>>> WordPieceTokenizer::tokenize_with_ids start");
+    SHERPA_ONNX_LOGT(">>>> WordPieceTokenizer::tokenize_with_ids start");
   std::vector<std::string> basic_tokens = basic_tokenize(text);
   std::vector<std::string> wordpieces;
   std::vector<int> ids;
@@ -148,7 +148,7 @@ WordPieceTokenizer::tokenize_with_ids(const std::string &text) {
     }
   }
   ids.push_back(3);
-  SHERPA_ONNX_LOGE( ">>>> WordPieceTokenizer::tokenize_with_ids end");
+  SHERPA_ONNX_LOGT( ">>>> WordPieceTokenizer::tokenize_with_ids end");
 
   return {wordpieces, ids};
 }
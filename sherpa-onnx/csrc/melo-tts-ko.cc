@@ -54,7 +54,8 @@ bool containsDigit(const std::wstring& text) {
 // std::wstring process_num_w(std::wstring num, bool sino = true);
 std::wstring process_num_w(std::wstring num, bool sino = true) {
     // 콤마 제거: wstring과 wregex 사용
-    num = std::regex_replace(num, std::wregex(L","), L"");
+    static const std::wregex r1(L",");
+    num = std::regex_replace(num, r1, L"");
 
     if (num == L"0") {
         return L"영";
@@ -243,7 +244,7 @@ std::wstring convertNumbersInText_w(const std::wstring& text, bool sino = true)
         return text;
     }
     // wstring용 정규 표현식 (L"" 접두사)
-    std::wregex num_regex(L"\\d[\\d,]*");
+    static const std::wregex num_regex(L"\\d[\\d,]*");
 
     std::wstring result = text;
 
@@ -371,6 +372,14 @@ wstring replace_pairs_w(const wstring& inp, const vector<pair<wstring, wstring>>
 // }
 std::map<std::string, std::string> rule_id2text_map;
 
+// Sentences are converted in parallel, so never insert into
+// rule_id2text_map as operator[] does
+const std::string &RuleText(const std::string &rule_id) {
+  static const std::string kEmpty;
+  auto it = rule_id2text_map.find(rule_id);
+  return it != rule_id2text_map.end() ? it->second : kEmpty;
+}
+
 // --- gloss 함수 (로깅/디버깅용) ---
 void gloss(bool verbose, const std::wstring &out, const std::wstring &inp,
            const std::string &rule) {
@@ -386,7 +395,7 @@ void gloss(bool verbose, const std::wstring &out, const std::wstring &inp,
 
 // link1: 홑받침 또는 쌍받침 + ᄋ → 초성으로 변경 (wstring 버전)
 std::wstring link1_w(const std::wstring &inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["13"];
+    std::string rule = RuleText("13");
     std::vector<std::pair<std::wstring, std::wstring>> pairs = {
         {L"ᆨᄋ", L"ᄀ"}, {L"ᆩᄋ", L"ᄁ"}, {L"ᆫᄋ", L"ᄂ"}, {L"ᆮᄋ", L"ᄃ"}, {L"ᆯᄋ", L"ᄅ"},
         {L"ᆷᄋ", L"ᄆ"}, {L"ᆸᄋ", L"ᄇ"}, {L"ᆺᄋ", L"ᄉ"}, {L"ᆻᄋ", L"ᄊ"}, {L"ᆽᄋ", L"ᄌ"},
@@ -399,7 +408,7 @@ std::wstring link1_w(const std::wstring &inp, bool descriptive = false, bool ver
 
 // link2: 겹받침 + ᄋ → 초성 2개로 분해 (wstring 버전)
 std::wstring link2_w(const std::wstring &inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["14"];
+    std::string rule = RuleText("14");
     std::vector<std::pair<std::wstring, std::wstring>> pairs = {
         {L"ᆪᄋ", L"ᆨᄊ"}, {L"ᆬᄋ", L"ᆫᄌ"}, {L"ᆰᄋ", L"ᆯᄀ"},
         {L"ᆱᄋ", L"ᆯᄆ"}, {L"ᆲᄋ", L"ᆯᄇ"}, {L"ᆳᄋ", L"ᆯᄊ"},
@@ -418,7 +427,7 @@ std::wstring link2_w(const std::wstring &inp, bool descriptive = false, bool ver
 
 // link3: 받침 + 공백 + ᄋ 처리 (wstring 버전)
 std::wstring link3_w(const std::wstring &inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["15"];
+    std::string rule = RuleText("15");
     std::vector<std::pair<std::wstring, std::wstring>> pairs = {
         {L"ᆨ ᄋ", L" ᄀ"},  {L"ᆩ ᄋ", L" ᄁ"},  {L"ᆫ ᄋ", L" ᄂ"},  {L"ᆮ ᄋ", L" ᄃ"},
         {L"ᆯ ᄋ", L" ᄅ"},  {L"ᆷ ᄋ", L" ᄆ"},  {L"ᆸ ᄋ", L" ᄇ"},  {L"ᆺ ᄋ", L" ᄉ"},
@@ -434,7 +443,7 @@ std::wstring link3_w(const std::wstring &inp, bool descriptive = false, bool ver
 
 // link4: ㅎ+ᄋ → 생략 규칙 (wstring 버전)
 std::wstring link4_w(const std::wstring &inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["12.4"];
+    std::string rule = RuleText("12.4");
     std::vector<std::pair<std::wstring, std::wstring>> pairs = {
         {L"ᇂᄋ", L"ᄋ"}, {L"ᆭᄋ", L"ᄂ"}, {L"ᆶᄋ", L"ᄅ"}
     };
@@ -444,21 +453,23 @@ std::wstring link4_w(const std::wstring &inp, bool descriptive = false, bool ver
 }
 /// 파이썬의 jyeo 함수 대응 (wstring 버전)
 std::wstring jyeo_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["5.1"];
+    std::string rule = RuleText("5.1");
 
     std::wstring _inp = decomposed_and_compose(inp);
-    std::wstring out = std::regex_replace(_inp, std::wregex(L"([ᄌᄍᄎ])ᅧ"), L"$1ᅥ");
+    static const std::wregex r1(L"([ᄌᄍᄎ])ᅧ");
+    std::wstring out = std::regex_replace(_inp, r1, L"$1ᅥ");
     gloss(verbose, (out), (inp), rule);
     return out;
 }
 
 // 파이썬의 ye 함수 대응 (wstring 버전)
 std::wstring ye_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["5.2"];
+    std::string rule = RuleText("5.2");
     std::wstring out = inp;
     if (descriptive) {
         std::wstring _inp = decomposed_and_compose(inp);
-        out = std::regex_replace(_inp, std::wregex(L"([ᄀᄁᄃᄄᄅᄆᄇᄈᄌᄍᄎᄏᄐᄑᄒ])ᅨ"), L"$1ᅦ");
+        static const std::wregex r1(L"([ᄀᄁᄃᄄᄅᄆᄇᄈᄌᄍᄎᄏᄐᄑᄒ])ᅨ");
+        out = std::regex_replace(_inp, r1, L"$1ᅦ");
     }
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -466,19 +477,21 @@ std::wstring ye_w(std::wstring inp, bool descriptive = false, bool verbose = fal
 
 // 파이썬의 consonant_ui 함수 대응 (wstring 버전)
 std::wstring consonant_ui_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["5.3"];
+    std::string rule = RuleText("5.3");
     std::wstring _inp = decomposed_and_compose(inp);
-    std::wstring out = std::regex_replace(_inp, std::wregex(L"([ᄀᄁᄂᄃᄄᄅᄆᄇᄈᄉᄊᄌᄍᄎᄏᄐᄑᄒ])ᅴ"), L"$1ᅵ");
+    static const std::wregex r1(L"([ᄀᄁᄂᄃᄄᄅᄆᄇᄈᄉᄊᄌᄍᄎᄏᄐᄑᄒ])ᅴ");
+    std::wstring out = std::regex_replace(_inp, r1, L"$1ᅵ");
     gloss(verbose, (out), (inp), rule);
     return out;
 }
 
 // 파이썬의 josa_ui 함수 대응 (wstring 버전)
 std::wstring josa_ui_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["5.4.2"];
+    std::string rule = RuleText("5.4.2");
     std::wstring out = decomposed_and_compose(inp);
     if (descriptive) {
-        out = std::regex_replace(inp, std::wregex(L"의/J"), L"에");
+        static const std::wregex r1(L"의/J");
+        out = std::regex_replace(inp, r1, L"에");
     }
     else {
         size_t pos = out.find(L"/J");
@@ -492,11 +505,12 @@ std::wstring josa_ui_w(std::wstring inp, bool descriptive = false, bool verbose
 
 // 파이썬의 vowel_ui 함수 대응 (wstring 버전)
 std::wstring vowel_ui_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["5.4.1"];
+    std::string rule = RuleText("5.4.1");
     std::wstring out = inp;
     if (descriptive) {
         std::wstring _inp = decomposed_and_compose(inp);
-        out = std::regex_replace(_inp, std::wregex(L"(.ᄋ)ᅴ"), L"$1ᅵ");
+        static const std::wregex r1(L"(.ᄋ)ᅴ");
+        out = std::regex_replace(_inp, r1, L"$1ᅵ");
     }
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -504,13 +518,17 @@ std::wstring vowel_ui_w(std::wstring inp, bool descriptive = false, bool verbose
 
 // 파이썬의 jamo 함수 대응 (wstring 버전)
 std::wstring jamo_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["16"];
+    std::string rule = RuleText("16");
     std::wstring out = decomposed_and_compose(inp);
 
-    out = std::regex_replace(out, std::wregex(L"([그])ᆮᄋ"), L"$1ᄉ");
-    out = std::regex_replace(out, std::wregex(L"([으])[ᆽᆾᇀᇂ]ᄋ"), L"$1ᄉ");
-    out = std::regex_replace(out, std::wregex(L"([으])[ᆿ]ᄋ"), L"$1ᄀ");
-    out = std::regex_replace(out, std::wregex(L"([으])[ᇁ]ᄋ"), L"$1ᄇ");
+    static const std::wregex r1(L"([그])ᆮᄋ");
+    out = std::regex_replace(out, r1, L"$1ᄉ");
+    static const std::wregex r2(L"([으])[ᆽᆾᇀᇂ]ᄋ");
+    out = std::regex_replace(out, r2, L"$1ᄉ");
+    static const std::wregex r3(L"([으])[ᆿ]ᄋ");
+    out = std::regex_replace(out, r3, L"$1ᄀ");
+    static const std::wregex r4(L"([으])[ᇁ]ᄋ");
+    out = std::regex_replace(out, r4, L"$1ᄇ");
 
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -518,22 +536,27 @@ std::wstring jamo_w(std::wstring inp, bool descriptive = false, bool verbose = f
 
 // 파이썬의 rieulgiyeok 함수 대응 (wstring 버전)
 std::wstring rieulgiyeok_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["11.1"];
+    std::string rule = RuleText("11.1");
     std::wstring _inp = decomposed_and_compose(inp);
-    std::wstring out = std::regex_replace(_inp, std::wregex(L"ᆰ/P([ᄀᄁ])"), L"ᆯᄁ");
+    static const std::wregex r1(L"ᆰ/P([ᄀᄁ])");
+    std::wstring out = std::regex_replace(_inp, r1, L"ᆯᄁ");
     gloss(verbose, (out), (inp), rule);
     return out;
 }
 
 // 파이썬의 rieulbieub 함수 대응 (wstring 버전)
 std::wstring rieulbieub_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["25"];
+    std::string rule = RuleText("25");
     std::wstring out = decomposed_and_compose(inp);
 
-    out = std::regex_replace(out, std::wregex(L"([ᆲᆴ])/Pᄀ"), L"$1ᄁ");
-    out = std::regex_replace(out, std::wregex(L"([ᆲᆴ])/Pᄃ"), L"$1ᄄ");
-    out = std::regex_replace(out, std::wregex(L"([ᆲᆴ])/Pᄉ"), L"$1ᄊ");
-    out = std::regex_replace(out, std::wregex(L"([ᆲᆴ])/Pᄌ"), L"$1ᄍ");
+    static const std::wregex r1(L"([ᆲᆴ])/Pᄀ");
+    out = std::regex_replace(out, r1, L"$1ᄁ");
+    static const std::wregex r2(L"([ᆲᆴ])/Pᄃ");
+    out = std::regex_replace(out, r2, L"$1ᄄ");
+    static const std::wregex r3(L"([ᆲᆴ])/Pᄉ");
+    out = std::regex_replace(out, r3, L"$1ᄊ");
+    static const std::wregex r4(L"([ᆲᆴ])/Pᄌ");
+    out = std::regex_replace(out, r4, L"$1ᄍ");
 
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -541,23 +564,35 @@ std::wstring rieulbieub_w(std::wstring inp, bool descriptive = false, bool verbo
 
 // 파이썬의 verb_nieun 함수 대응 (wstring 버전)
 std::wstring verb_nieun_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["24"];
+    std::string rule = RuleText("24");
     std::wstring out = decomposed_and_compose(inp);
 
-    out = std::regex_replace(out, std::wregex(L"([ᆫᆷ])/Pᄀ"), L"$1ᄁ");
-    out = std::regex_replace(out, std::wregex(L"([ᆫᆷ])/Pᄃ"), L"$1ᄄ");
-    out = std::regex_replace(out, std::wregex(L"([ᆫᆷ])/Pᄉ"), L"$1ᄊ");
-    out = std::regex_replace(out, std::wregex(L"([ᆫᆷ])/Pᄌ"), L"$1ᄍ");
-
-    out = std::regex_replace(out, std::wregex(L"ᆬ/Pᄀ"), L"ᆫᄁ");
-    out = std::regex_replace(out, std::wregex(L"ᆬ/Pᄃ"), L"ᆫᄄ");
-    out = std::regex_replace(out, std::wregex(L"ᆬ/Pᄉ"), L"ᆫᄊ");
-    out = std::regex_replace(out, std::wregex(L"ᆬ/Pᄌ"), L"ᆫᄍ");
-
-    out = std::regex_replace(out, std::wregex(L"ᆱ/Pᄀ"), L"ᆷᄁ");
-    out = std::regex_replace(out, std::wregex(L"ᆱ/Pᄃ"), L"ᆷᄄ");
-    out = std::regex_replace(out, std::wregex(L"ᆱ/Pᄉ"), L"ᆷᄊ");
-    out = std::regex_replace(out, std::wregex(L"ᆱ/Pᄌ"), L"ᆷᄍ");
+    static const std::wregex r1(L"([ᆫᆷ])/Pᄀ");
+    out = std::regex_replace(out, r1, L"$1ᄁ");
+    static const std::wregex r2(L"([ᆫᆷ])/Pᄃ");
+    out = std::regex_replace(out, r2, L"$1ᄄ");
+    static const std::wregex r3(L"([ᆫᆷ])/Pᄉ");
+    out = std::regex_replace(out, r3, L"$1ᄊ");
+    static const std::wregex r4(L"([ᆫᆷ])/Pᄌ");
+    out = std::regex_replace(out, r4, L"$1ᄍ");
+
+    static const std::wregex r5(L"ᆬ/Pᄀ");
+    out = std::regex_replace(out, r5, L"ᆫᄁ");
+    static const std::wregex r6(L"ᆬ/Pᄃ");
+    out = std::regex_replace(out, r6, L"ᆫᄄ");
+    static const std::wregex r7(L"ᆬ/Pᄉ");
+    out = std::regex_replace(out, r7, L"ᆫᄊ");
+    static const std::wregex r8(L"ᆬ/Pᄌ");
+    out = std::regex_replace(out, r8, L"ᆫᄍ");
+
+    static const std::wregex r9(L"ᆱ/Pᄀ");
+    out = std::regex_replace(out, r9, L"ᆷᄁ");
+    static const std::wregex r10(L"ᆱ/Pᄃ");
+    out = std::regex_replace(out, r10, L"ᆷᄄ");
+    static const std::wregex r11(L"ᆱ/Pᄉ");
+    out = std::regex_replace(out, r11, L"ᆷᄊ");
+    static const std::wregex r12(L"ᆱ/Pᄌ");
+    out = std::regex_replace(out, r12, L"ᆷᄍ");
 
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -565,11 +600,13 @@ std::wstring verb_nieun_w(std::wstring inp, bool descriptive = false, bool verbo
 
 // balb 함수 대응 (wstring 버전)
 std::wstring balb_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["10.1"];
+    std::string rule = RuleText("10.1");
     std::wstring out = decomposed_and_compose(inp);
 
-    out = std::regex_replace(out, std::wregex(L"(바)ᆲ($|[^ᄋᄒ])"), L"$1ᆸ$2");
-    out = std::regex_replace(out, std::wregex(L"(너)ᆲ([ᄌᄍ]ᅮ|[ᄃᄄ]ᅮ)"), L"$1ᆸ$2");
+    static const std::wregex r1(L"(바)ᆲ($|[^ᄋᄒ])");
+    out = std::regex_replace(out, r1, L"$1ᆸ$2");
+    static const std::wregex r2(L"(너)ᆲ([ᄌᄍ]ᅮ|[ᄃᄄ]ᅮ)");
+    out = std::regex_replace(out, r2, L"$1ᆸ$2");
 
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -579,38 +616,50 @@ std::wstring balb_w(std::wstring inp, bool descriptive = false, bool verbose = f
 std::wstring palatalize_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
     std::wstring out = decomposed_and_compose(inp);
 
-    std::wregex r1(L"ᆮᄋ([ᅵᅧ])");
-    std::wregex r2(L"ᇀᄋ([ᅵᅧ])");
-    std::wregex r3(L"ᆴᄋ([ᅵᅧ])");
-    std::wregex r4(L"ᆮᄒ([ᅵ])");
+    static const std::wregex r1(L"ᆮᄋ([ᅵᅧ])");
+    static const std::wregex r2(L"ᇀᄋ([ᅵᅧ])");
+    static const std::wregex r3(L"ᆴᄋ([ᅵᅧ])");
+    static const std::wregex r4(L"ᆮᄒ([ᅵ])");
 
     out = std::regex_replace(out, r1, L"ᄌ$1");
     out = std::regex_replace(out, r2, L"ᄎ$1");
     out = std::regex_replace(out, r3, L"ᆯᄎ$1");
     out = std::regex_replace(out, r4, L"ᄎ$1");
 
-    gloss(verbose, (out), (inp), rule_id2text_map["17"]);
+    gloss(verbose, (out), (inp), RuleText("17"));
     return out;
 }
 
 // 파이썬의 modifying_rieul 함수 대응 (wstring 버전)
 std::wstring modifying_rieul_w(std::wstring inp, bool descriptive = false, bool verbose = false) {
-    std::string rule = rule_id2text_map["27"];
+    std::string rule = RuleText("27");
     std::wstring out = decomposed_and_compose(inp);
 
-    out = std::regex_replace(out, std::wregex(L"ᆯ/E ᄀ"), L"ᆯ ᄁ");
-    out = std::regex_replace(out, std::wregex(L"ᆯ/E ᄃ"), L"ᆯ ᄄ");
-    out = std::regex_replace(out, std::wregex(L"ᆯ/E ᄇ"), L"ᆯ ᄈ");
-    out = std::regex_replace(out, std::wregex(L"ᆯ/E ᄉ"), L"ᆯ ᄊ");
-    out = std::regex_replace(out, std::wregex(L"ᆯ/E ᄌ"), L"ᆯ ᄍ");
-
-    out = std::regex_replace(out, std::wregex(L"ᆯ걸"), L"ᆯ껄");
-    out = std::regex_replace(out, std::wregex(L"ᆯ밖에"), L"ᆯ빠께");
-    out = std::regex_replace(out, std::wregex(L"ᆯ세라"), L"ᆯ쎄라");
-    out = std::regex_replace(out, std::wregex(L"ᆯ수록"), L"ᆯ쑤록");
-    out = std::regex_replace(out, std::wregex(L"ᆯ지라도"), L"ᆯ찌라도");
-    out = std::regex_replace(out, std::wregex(L"ᆯ지언정"), L"ᆯ찌언정");
-    out = std::regex_replace(out, std::wregex(L"ᆯ진대"), L"ᆯ찐대");
+    static const std::wregex r1(L"ᆯ/E ᄀ");
+    out = std::regex_replace(out, r1, L"ᆯ ᄁ");
+    static const std::wregex r2(L"ᆯ/E ᄃ");
+    out = std::regex_replace(out, r2, L"ᆯ ᄄ");
+    static const std::wregex r3(L"ᆯ/E ᄇ");
+    out = std::regex_replace(out, r3, L"ᆯ ᄈ");
+    static const std::wregex r4(L"ᆯ/E ᄉ");
+    out = std::regex_replace(out, r4, L"ᆯ ᄊ");
+    static const std::wregex r5(L"ᆯ/E ᄌ");
+    out = std::regex_replace(out, r5, L"ᆯ ᄍ");
+
+    static const std::wregex r6(L"ᆯ걸");
+    out = std::regex_replace(out, r6, L"ᆯ껄");
+    static const std::wregex r7(L"ᆯ밖에");
+    out = std::regex_replace(out, r7, L"ᆯ빠께");
+    static const std::wregex r8(L"ᆯ세라");
+    out = std::regex_replace(out, r8, L"ᆯ쎄라");
+    static const std::wregex r9(L"ᆯ수록");
+    out = std::regex_replace(out, r9, L"ᆯ쑤록");
+    static const std::wregex r10(L"ᆯ지라도");
+    out = std::regex_replace(out, r10, L"ᆯ찌라도");
+    static const std::wregex r11(L"ᆯ지언정");
+    out = std::regex_replace(out, r11, L"ᆯ찌언정");
+    static const std::wregex r12(L"ᆯ진대");
+    out = std::regex_replace(out, r12, L"ᆯ찐대");
 
     gloss(verbose, (out), (inp), rule);
     return out;
@@ -618,7 +667,6 @@ std::wstring modifying_rieul_w(std::wstring inp, bool descriptive = false, bool
 // ############################ vowels ###########################
 
 using RuleEntry = tuple<wstring, wstring, vector<wstring>>;
-vector<RuleEntry> table;
 // tuple: (str1, str2, rule_ids)
 std::wstring fix_replacement_backrefs_w(const std::wstring& replacement) {
     std::wstring fixed;
@@ -758,8 +806,39 @@ std::vector<RuleEntry> parse_table_csv_hardcoded() {
     return table;
 }
 
+// A row of the table above with its pattern compiled once
+struct CompiledRule {
+    wstring pattern;
+    wstring replacement;  // with \1 back-references as in the table
+    wstring fixed_replacement;  // with $1 back-references for std::regex
+    vector<wstring> rule_ids;
+    std::wregex re;
+};
+
+// Sentences are converted in parallel; the table is compiled only once
+const vector<CompiledRule> &GetRuleTable() {
+    static const vector<CompiledRule> rules = []() {
+        vector<CompiledRule> ans;
+        for (auto &[str1, str2, rule_ids] : parse_table_csv_hardcoded()) {
+            try {
+                std::wregex re(str1);
+                std::wstring fixed = fix_replacement_backrefs_w(str2);
+                ans.push_back({str1, str2, std::move(fixed), rule_ids,
+                               std::move(re)});
+            } catch (std::regex_error &e) {
+                SHERPA_ONNX_LOGE("Skip invalid pattern '%s': %s",
+                                 wstring_to_utf8(str1).c_str(), e.what());
+            }
+        }
+        return ans;
+    }();
+
+    return rules;
+}
+
 std::wstring remove_pjeb_tags_w(const std::wstring &inp) {
-  return std::regex_replace(inp, std::wregex(L"/[PJEB]"), L"");
+  static const std::wregex r1(L"/[PJEB]");
+  return std::regex_replace(inp, r1, L"");
 }
 std::wstring apply_rule_step_w(
     const std::wstring& step_name,
@@ -769,8 +848,8 @@ std::wstring apply_rule_step_w(
 {
     std::wstring output = rule_func(input, descriptive, false); // verbose=false 고정
     if (output != input) {
-        SHERPA_ONNX_LOGE("[%s] 변환 전: %s\n", wstring_to_utf8(step_name).c_str(), wstring_to_utf8(input).c_str());
-        SHERPA_ONNX_LOGE("[%s] 변환 후: %s\n\n", wstring_to_utf8(step_name).c_str(), wstring_to_utf8(output).c_str());
+        SHERPA_ONNX_LOGT("[%s] 변환 전: %s\n", wstring_to_utf8(step_name).c_str(), wstring_to_utf8(input).c_str());
+        SHERPA_ONNX_LOGT("[%s] 변환 후: %s\n\n", wstring_to_utf8(step_name).c_str(), wstring_to_utf8(output).c_str());
     }
     return output;
 }
@@ -795,38 +874,27 @@ std::wstring apply_rules_w(std::wstring inp, bool descriptive = false) {
         std::wstring before = out;
         out = remove_pjeb_tags_w(out);
         if (out != before) {
-            SHERPA_ONNX_LOGE("[remove_pjeb_tags] 변환 전:%s" ,wstring_to_utf8(before).c_str() );
-            SHERPA_ONNX_LOGE("[remove_pjeb_tags] 변환 후:%s" , wstring_to_utf8(out).c_str() );
+            SHERPA_ONNX_LOGT("[remove_pjeb_tags] 변환 전:%s" ,wstring_to_utf8(before).c_str() );
+            SHERPA_ONNX_LOGT("[remove_pjeb_tags] 변환 후:%s" , wstring_to_utf8(out).c_str() );
         }
     }
 
     // 규칙 기반 치환
-    for (const auto& [_wstr1, _wstr2, rule_ids] : table) {
-        wstring wstr1 = _wstr1;
-        wstring wstr2 = _wstr2;
-
-        wstring wout = (out);
-
-        wstring before = wout;
-        //////////////
-        std::wstring fixed_str2 = fix_replacement_backrefs_w(wstr2);
+    for (const auto& r : GetRuleTable()) {
+        const wstring &wstr1 = r.pattern;
+        const wstring &wstr2 = r.replacement;
+        const vector<wstring> &rule_ids = r.rule_ids;
 
-        try {
-            wstring result = decomposed_and_compose(wout);
-
-            wout = std::regex_replace(result, std::wregex(wstr1), fixed_str2);
-            out = (wout);
-        }
-        catch (std::regex_error& e) {
-            std::cerr << "[regex error] pattern: " << wstring_to_utf8(wstr1)
-                << ", error: " << e.what() << std::endl;
-            continue;
-        }
+        wstring before = out;
+        wstring wout =
+            std::regex_replace(decomposed_and_compose(out), r.re,
+                               r.fixed_replacement);
+        out = wout;
 
         if (wout != before) {  // 변경이 있을 때만 출력
-            SHERPA_ONNX_LOGE("[regex_replace] wstr1:%s,wstr2:%s<<" , wstring_to_utf8(wstr1).c_str(), wstring_to_utf8(wstr2).c_str());
-            SHERPA_ONNX_LOGE("[regex_replace] 변환 전:%s<<" , wstring_to_utf8(before).c_str());
-            SHERPA_ONNX_LOGE("[regex_replace] 변환 후:%s<<" , wstring_to_utf8(wout).c_str());
+            SHERPA_ONNX_LOGT("[regex_replace] wstr1:%s,wstr2:%s<<" , wstring_to_utf8(wstr1).c_str(), wstring_to_utf8(wstr2).c_str());
+            SHERPA_ONNX_LOGT("[regex_replace] 변환 전:%s<<" , wstring_to_utf8(before).c_str());
+            SHERPA_ONNX_LOGT("[regex_replace] 변환 후:%s<<" , wstring_to_utf8(wout).c_str());
 
             std::string rule;
             if (!rule_ids.empty()) {
@@ -1092,24 +1160,22 @@ int64_t charToPhoneId(const wchar_t& _char) {
     }
 }
 std::vector<int64_t> TextToPhoneId(const std::string &_text, bool isFullSentence) {
-  if (table.empty()) {
-    // table = parse_table_csv("table.csv");
-    table = parse_table_csv_hardcoded();
-  }
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId table size: %lu", table.size());
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId %s", _text.c_str());
+  // Sentences are converted in parallel, so initialize the table only once
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId table size: %zu",
+                   GetRuleTable().size());
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId %s", _text.c_str());
   // UTF-8 문자열을 wstring으로 변환
   std::wstring text = utf8_to_wstring(_text);
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId utf8_to_wstring text");
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId utf8_to_wstring text");
 
   // 한글 분해
   std::vector<wchar_t> jamos = decompose_hangul(text);
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId decompose_hangle");
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId decompose_hangle");
   std::wstring result(jamos.begin(), jamos.end());
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId result");
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId result");
   vector<wstring> tokens = split(result, ' ');
 
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId apply rules");
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId apply rules");
   vector<wstring> out_applied_rules;
   for (auto &token : tokens) {
     wstring out = apply_rules_w((token));
@@ -1131,11 +1197,11 @@ std::vector<int64_t> TextToPhoneId(const std::string &_text, bool isFullSentence
 //   std::string rs_string = apply_rules(wstring_to_utf8(result));
 //   SHERPA_ONNX_LOGE(">>> TextToPhoneId apply rules reult %s", rs_string.c_str());
 //   std::wstring rs = compose_hangul(utf8_to_wstring(rs_string));
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId apply compose_hangle result");
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId apply compose_hangle result");
 
   // 자모 ID로 변환
   std::vector<int64_t> phoneme_ids = convert_to_jamo_ids(rs, isFullSentence);
-  SHERPA_ONNX_LOGE(">>> TextToPhoneId convert_to_jamo_ids");
+  SHERPA_ONNX_LOGT(">>> TextToPhoneId convert_to_jamo_ids");
   //   std::vector<int64_t> tone_ids(phoneme_ids.size(), 0);  // 톤 ID 기본값 0
 
   return std::vector<int64_t>(phoneme_ids.begin(), phoneme_ids.end());
@@ -1186,7 +1252,8 @@ bool containsDigit(const std::string& text) {
 
 std::string process_num(std::string num, bool sino = true) {
     // Remove commas from the number string
-    num = std::regex_replace(num, std::regex(","), "");
+    static const std::regex r1(",");
+    num = std::regex_replace(num, r1, "");
 
     if (num == "0") {
         return "영";
@@ -1456,29 +1523,31 @@ G2PResult g2pk(const std::string& norm_text, WordPieceTokenizer& tokenizer) {
         }
 
         std::string phonemes_ = TextToPhone(text); // This should return space-separated phonemes
-        SHERPA_ONNX_LOGE("---------- after textToPhone: %s\n text: %s", phonemes_.c_str(),text.c_str());
+        SHERPA_ONNX_LOGT("---------- after textToPhone: %s\n text: %s", phonemes_.c_str(),text.c_str());
         auto ph_ids_ = TextToPhoneId(phonemes_,false);
-        SHERPA_ONNX_LOGE("ph_ids");
-        std::ostringstream oss;
-        oss << "ph_ids: ";
-        for (auto p : ph_ids_) {
-            oss << p << ",";
+        if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+            std::ostringstream oss;
+            oss << "ph_ids: ";
+            for (auto p : ph_ids_) {
+                oss << p << ",";
+            }
+            SHERPA_ONNX_LOGT("%s",oss.str().c_str());
         }
-        // cout << "--------- " << endl;
-        SHERPA_ONNX_LOGE("%s",oss.str().c_str());
 
         ph_ids.insert(ph_ids.end(), ph_ids_.begin(), ph_ids_.end());
         //  textToPhoneId(text);
 
         std::vector<wchar_t> phonemes_w = decompose_hangul(utf8_to_wstring(phonemes_));
         std::vector<std::string> phonemes = convert_wchar_vector_to_string_vector(phonemes_w);
-        std::ostringstream oss2;
-        oss2 << "phonemes: ";
-        for (auto p : phonemes) {
-            oss2 << p << ",";
+        if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+            std::ostringstream oss2;
+            oss2 << "phonemes: ";
+            for (auto p : phonemes) {
+                oss2 << p << ",";
+            }
+            SHERPA_ONNX_LOGT("%s",oss2.str().c_str());
+            SHERPA_ONNX_LOGT("phonemes.size(): %d", phonemes.size());
         }
-        SHERPA_ONNX_LOGE("%s",oss2.str().c_str());
-        SHERPA_ONNX_LOGE("phonemes.size(): %d", phonemes.size());
         // cout << "phonemes.size(): " << phonemes.size() << endl;
 
         // cout << endl;
@@ -1496,7 +1565,7 @@ G2PResult g2pk(const std::string& norm_text, WordPieceTokenizer& tokenizer) {
 
         // If for some reason `phonemes` still ends up empty (e.g., textToPhone returns empty string)
         if (phonemes.empty()) {
-            std::cerr << "WARNING: No phonemes generated for text: \"" << text << "\". Treating as unknown." << std::endl;
+            SHERPA_ONNX_LOGW("No phonemes generated for text: \"%s\". Treating as unknown.", text.c_str());
             phs.push_back("_"); // Fallback phoneme
             word2ph_local.push_back(1); // Assign 1 phoneme to the token
             continue; // Skip to next group
@@ -1507,15 +1576,17 @@ G2PResult g2pk(const std::string& norm_text, WordPieceTokenizer& tokenizer) {
         int word_len = group.size(); // Number of WordPiece tokens for this combined text
 
         // Debug prints to verify `phone_len` and `word_len`
-        SHERPA_ONNX_LOGE("Processing group: ");
-        std::ostringstream oss3;
-        for (const auto& t : group){
-          oss3 << t << " ";
-        } 
-        oss3 << " (combined text: \"" << text << "\")" << std::endl;
-        oss3 << "  Expected phonemes count (phone_len): " << phone_len << std::endl;
-        oss3 << "  WordPiece tokens in group (word_len): " << word_len << std::endl;
-        SHERPA_ONNX_LOGE("%s",oss3.str().c_str());
+        if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+          SHERPA_ONNX_LOGT("Processing group: ");
+          std::ostringstream oss3;
+          for (const auto& t : group){
+            oss3 << t << " ";
+          }
+          oss3 << " (combined text: \"" << text << "\")" << std::endl;
+          oss3 << "  Expected phonemes count (phone_len): " << phone_len << std::endl;
+          oss3 << "  WordPiece tokens in group (word_len): " << word_len << std::endl;
+          SHERPA_ONNX_LOGT("%s",oss3.str().c_str());
+        }
 
 
         std::vector<int> aaa = distribute_phone(phone_len, word_len);
@@ -1566,16 +1637,16 @@ G2PResult g2pk(const std::string& norm_text, WordPieceTokenizer& tokenizer) {
     // result.word2ph = word2ph_final;
     // result.phone_ids = ph_ids;
 
-    SHERPA_ONNX_LOGE("phones_final.size(): %d", phones_final.size());
-    SHERPA_ONNX_LOGE("tones_final.size(): %d", tones_final.size());
-    SHERPA_ONNX_LOGE("word2ph_final.size(): %d", word2ph_final.size());
+    SHERPA_ONNX_LOGD("phones_final.size(): %d", phones_final.size());
+    SHERPA_ONNX_LOGD("tones_final.size(): %d", tones_final.size());
+    SHERPA_ONNX_LOGD("word2ph_final.size(): %d", word2ph_final.size());
     // sum of word2ph_final
     int64_t sum = 0;
     for(int i = 0; i < word2ph_final.size(); i++){
       sum += word2ph_final[i];
     }
-    SHERPA_ONNX_LOGE("sum of word2ph_final: %d", sum);
-    SHERPA_ONNX_LOGE("ph_ids_final.size(): %d", ph_ids_final.size());
+    SHERPA_ONNX_LOGD("sum of word2ph_final: %d", sum);
+    SHERPA_ONNX_LOGD("ph_ids_final.size(): %d", ph_ids_final.size());
     // return G2PResult{ phones_final, tones_final, word2ph_final };
     return G2PResult{ phones_final,ph_ids_final, tones_final, word2ph_final };
 }
@@ -1592,13 +1663,16 @@ std::vector<std::string> split_sentences_ko(const std::string& text, int min_len
     std::string processed_text = text;
 
     // 1. 텍스트 내의 여러 종류의 공백, 탭, 줄바꿈 등을 하나의 공백으로 정규화
-    processed_text = std::regex_replace(processed_text, std::regex("[\\n\\t ]+"), " ");
+    static const std::regex r1("[\\n\\t ]+");
+    processed_text = std::regex_replace(processed_text, r1, " ");
 
     // 2. 한국어 문장 종결 구두점 (온점, 물음표, 느낌표) 뒤에 특수 구분자 "$#!" 삽입
     //    쉼표(,) 뒤에도 삽입하여 초기 분리 기준으로 사용
     //    주의: 구두점 뒤에 공백을 추가하여, 공백도 분리 기준으로 삼을 수 있게 합니다.
-    processed_text = std::regex_replace(processed_text, std::regex("([.!?])"), "$1 $#!"); // 구두점 뒤에 공백과 구분자 삽입
-    processed_text = std::regex_replace(processed_text, std::regex("([,])"), "$1 $#!");   // 쉼표 뒤에 공백과 구분자 삽입
+    static const std::regex r2("([.!?])");
+    static const std::regex r3("([,])");
+    processed_text = std::regex_replace(processed_text, r2, "$1 $#!"); // 구두점 뒤에 공백과 구분자 삽입
+    processed_text = std::regex_replace(processed_text, r3, "$1 $#!");   // 쉼표 뒤에 공백과 구분자 삽입
 
     // 3. 공백도 특수 구분자 "$#!"로 간주하여 문장 분리.
     //    여기서 중요한 것은 공백 자체를 버리지 않고 구분자의 일부로 처리하거나,
@@ -1610,7 +1684,7 @@ std::vector<std::string> split_sentences_ko(const std::string& text, int min_len
     std::vector<std::string> sentences_raw;
     // 공백 ( ) 또는 특수 구분자 ($#!)를 분리 기준으로 사용
     // 이 정규식은 ' ' 또는 '$#!'를 분리자로 인식합니다.
-    std::regex re(" |\\$#!"); // 공백 또는 $#!
+    static const std::regex re(" |\\$#!"); // 공백 또는 $#!
 
     // std::sregex_token_iterator를 사용하여 분리 (토큰 추출 모드)
     // -1은 분리자 자체가 아닌, 분리자 사이의 토큰을 가져오라는 의미입니다.
@@ -5,7 +5,6 @@
 #include "sherpa-onnx/csrc/melo-tts-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <strstream>
 #include <unordered_map>
@@ -29,9 +28,12 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/melo-tts-ko-tokenizer.h"
 #include "sherpa-onnx/csrc/melo-tts-ko.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-normalizer.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 const std::vector<std::string> CHOSUNG = {
     "ᄀ", "ᄁ", "ᄂ", "ᄃ", "ᄄ", "ᄅ", "ᄆ", "ᄇ", "ᄈ", "ᄉ",
@@ -56,7 +58,7 @@ long get_codepoint_at(const std::string &s, size_t &index) {
   }
 
   unsigned char c = static_cast<unsigned char>(s[index]);
-  SHERPA_ONNX_LOGE(">>> get_codepoint_at called with index: %zu, char: %c",
+  SHERPA_ONNX_LOGD(">>> get_codepoint_at called with index: %zu, char: %c",
                    index, c);
   long codepoint;
   int len;
@@ -84,7 +86,7 @@ long get_codepoint_at(const std::string &s, size_t &index) {
   }
 
   index += len;  // Update index to point to the next character
-  SHERPA_ONNX_LOGE(
+  SHERPA_ONNX_LOGD(
       ">>> get_codepoint_at called with index: %zu, char: %c return codepoint: "
       "%ld",
       index, c, codepoint);
@@ -119,7 +121,7 @@ std::vector<std::string> splitOne(long codePoint,
         static_cast<size_t>(jong) >= JONGSUNG.size()) {
       // This case should ideally not be hit if the Unicode decomposition logic
       // is sound and your Jamo arrays are complete. But it's a good safeguard.
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGW(
           "Jamo index out of bounds! codePoint: %ld, cho: %ld, jung: %ld, "
           "jong: %ld",
           codePoint, cho, jung, jong);
@@ -141,11 +143,11 @@ std::vector<std::string> split(const std::string &target) {
   std::vector<std::string> result_jamos;
   size_t i = 0;
 
-  SHERPA_ONNX_LOGE(">>> split called with target: %s", target.c_str());
-  SHERPA_ONNX_LOGE(">>> initial i: %zu", i);
+  SHERPA_ONNX_LOGD(">>> split called with target: %s", target.c_str());
+  SHERPA_ONNX_LOGD(">>> initial i: %zu", i);
 
   while (i < target.length()) {
-    SHERPA_ONNX_LOGE(">>> while loop i: %zu", i);
+    SHERPA_ONNX_LOGT(">>> while loop i: %zu", i);
     size_t start_idx = i;
 
     // Call get_codepoint_at to parse ONE character and advance 'i'
@@ -174,13 +176,13 @@ std::vector<std::string> split(const std::string &target) {
     // Add the decomposed Jamo (or the original character if not decomposable)
     // to the result vector.
     int8_t cnt = 0;
-    SHERPA_ONNX_LOGE(">>> splitOne returned %zu jamos",
+    SHERPA_ONNX_LOGT(">>> splitOne returned %zu jamos",
                      split_char_result.size());
     for (const auto &jamo : split_char_result) {
       // We push back empty strings as well, consistent with the original Kotlin
       // logic.
       if (jamo == "") {
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGT(
             ">>> splitOne returned an empty string, skipping. cnt: %d", cnt);
         continue;  // Skip empty strings
       }
@@ -195,6 +197,20 @@ std::vector<std::string> split(const std::string &target) {
 
 namespace sherpa_onnx {
 
+// Replace Chinese punctuations with ASCII ones. See
+// https://github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
+static const TextNormalizer &ChinesePunctuationNormalizer() {
+  static const TextNormalizer normalizer({
+      {"：", ","},
+      {"、", ","},
+      {"；", ","},
+      {"。", "."},
+      {"？", "?"},
+      {"！", "!"},
+  });
+  return normalizer;
+}
+
 class MeloTtsLexicon::Impl {
  public:
   Impl(const std::string &lexicon, const std::string &tokens,
@@ -277,7 +293,7 @@ class MeloTtsLexicon::Impl {
       auto buf = ReadFile(mgr, tokens);
       // ja_bert_model_path_ = ja_bert_model_path;
       // vocab_path_ = vocab_path;
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           ">>>>> MeloTtsLexicon::Impl::Impl vocab_path_ %s,ja_bert_model_path_ "
           "%s",
           vocab_path.c_str(), ja_bert_model_path.c_str());
@@ -304,6 +320,135 @@ class MeloTtsLexicon::Impl {
     }
   }
 
+  // G2P of a sentence returned by split_sentences_ko(). The returned
+  // word2ph already accounts for the blanks added by AddBlank().
+  TokenIDs ConvertSentenceToTokenIdsKorean(const std::string &sentence) const {
+    SHERPA_ONNX_LOGT("ConvertSentenceToTokenIdsKorean sentence: %s",
+                     sentence.c_str());
+    G2PResult g2p_result = g2pk(sentence, *tokenizer_kor_);
+    SHERPA_ONNX_LOGT("ConvertSentenceToTokenIdsKorean end g2pk");
+
+    std::vector<std::int64_t> phoneIds = g2p_result.phone_ids;
+    std::vector<std::int64_t> word2ph = g2p_result.word2ph;
+    std::vector<std::string> phones = g2p_result.phones;
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      SHERPA_ONNX_LOGT("ConvertSentenceToTokenIdsKorean G2pResult");
+      SHERPA_ONNX_LOGT(
+          "ConvertSentenceToTokenIdsKorean G2pResult phoneIds size: %zu, "
+          "phones size: %zu",
+          phoneIds.size(), phones.size());
+      std::ostringstream phone_stream;
+      int idx = 0;
+      for (auto count : word2ph) {
+        for (int i = 0; i < count; i++) {
+          phone_stream << phoneIds[idx + i] << ",";
+        }
+        idx += count;
+        phone_stream << "\n";
+      }
+      phone_stream << "\n";
+      SHERPA_ONNX_LOGT("%s", phone_stream.str().c_str());
+      std::ostringstream ph_stream;
+      idx = 0;
+      for (auto count : word2ph) {
+        for (int i = 0; i < count; i++) {
+          ph_stream << phones[idx + i] << ",";
+        }
+        idx += count;
+        ph_stream << "\n";
+      }
+      ph_stream << "\n";
+
+      SHERPA_ONNX_LOGT("%s", ph_stream.str().c_str());
+      std::ostringstream word2ph_stream;
+      for (auto e : word2ph) {
+        word2ph_stream << e << ",";
+      }
+      SHERPA_ONNX_LOGT(
+          "ConvertSentenceToTokenIdsKorean G2pResult word2ph 0 :%s",
+          word2ph_stream.str().c_str());
+      SHERPA_ONNX_LOGT(
+          "ConvertSentenceToTokenIdsKorean G2pResult word2ph size: %zu",
+          word2ph.size());
+    }
+
+    // AddBlank() in offline-tts-vits-impl.h inserts a blank before each
+    // token and after the last one, as add_blank does in MeloTTS. Each word
+    // then covers twice as many tokens and the leading blank belongs to the
+    // first word. The BERT features are expanded with this word2ph.
+    for (auto &n : word2ph) {
+      n *= 2;
+    }
+
+    if (!word2ph.empty()) {
+      word2ph[0] += 1;
+    }
+
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      std::ostringstream os;
+      std::string sep;
+      for (auto e : word2ph) {
+        os << sep << e;
+        sep = ", ";
+      }
+      SHERPA_ONNX_LOGT("word2ph: [%s]", os.str().c_str());
+    }
+
+    TokenIDs ans;
+    ans.tones = std::vector<std::int64_t>(phoneIds.size(), 11);
+    ans.tokens = std::move(phoneIds);
+    ans.word2ph = std::move(word2ph);
+    ans.sentences.push_back(sentence);
+
+    return ans;
+  }
+
+  // Fill token_ids->ja_bert_vec, one 768-d BERT feature per token
+  void ComputeJaBertKorean(TokenIDs *token_ids) const {
+    if (IsOfflineTtsRequestCancelled()) {
+      return;
+    }
+
+    token_ids->ja_bert_vec =
+        GetJaBert(token_ids->sentences[0], token_ids->word2ph);
+
+    SHERPA_ONNX_LOGT(
+        "ComputeJaBertKorean 768 * tokens size: %zu = %zu should be the same "
+        "as ja_bert_vec size: %zu",
+        token_ids->tokens.size(), 768 * token_ids->tokens.size(),
+        token_ids->ja_bert_vec.size());
+
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      std::ostringstream oss;
+      oss << "real_ja_bert10: [";
+      for (size_t i = 0;
+           i < std::min<size_t>(10, token_ids->ja_bert_vec.size()); ++i) {
+        oss << token_ids->ja_bert_vec[i] << ",";
+      }
+      oss << "]";
+      SHERPA_ONNX_LOGT("%s", oss.str().c_str());
+    }
+  }
+
+  bool SupportsSentenceSplitting() const {
+    return tokenizer_kor_ && ja_bert_sess_;
+  }
+
+  // Return an empty vector if text is not converted by
+  // ConvertTextToTokenIdsKorean(). See ConvertTextToTokenIds()
+  std::vector<std::string> SplitSentencesKorean(const std::string &text) const {
+    if (text.empty() || !SupportsSentenceSplitting()) {
+      return {};
+    }
+
+    char c = text[0];
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+      return {};
+    }
+
+    return split_sentences_ko(text);
+  }
+
   // --- 자모 분리 로직 ---
 
   /// @brief vector means split sentence TokenIds contains token_ids, tone_ids
@@ -323,338 +468,76 @@ class MeloTtsLexicon::Impl {
   /// @return  std::vector<TokenIDs>
   std::vector<TokenIDs> ConvertTextToTokenIdsKorean(
       const std::string &_text) const {
-    SHERPA_ONNX_LOGE("ConvertTextToTokenIdsKorean called with text: %s",
+    SHERPA_ONNX_LOGD("ConvertTextToTokenIdsKorean called with text: %s",
                      _text.c_str());
     std::vector<std::string> words;
     // words = SplitUtf8(_text);
     words = split_sentences_ko(_text);
     for (const auto &word : words) {
-      SHERPA_ONNX_LOGE(">>>> ConvertTextToTokenIdsKorean word: %s",
+      SHERPA_ONNX_LOGT(">>>> ConvertTextToTokenIdsKorean word: %s",
                        word.c_str());
     }
 
     std::vector<TokenIDs> ans;
-    TokenIDs this_sentence;
+    ans.reserve(words.size());
 
     for (const auto &word : words) {
-      SHERPA_ONNX_LOGE("ConvertTextToTokenIdsKorean word: %s", word.c_str());
-      // split text if long text
-      // std::vector<std::int64_t> phoneIds = TextToPhoneId(_text);
-
-      // std::vector<float> ja_bert_vec_final;
-      SHERPA_ONNX_LOGE(
-          ">>>> ConvertTextToTokenIdsKorean melo-tts-lexicon.cc start g2pk");
-      G2PResult g2p_result = g2pk(word, *tokenizer_kor_);
-      SHERPA_ONNX_LOGE(
-          ">>>> ConvertTextToTokenIdsKorean melo-tts-lexicon.cc end g2pk");
-
-      std::vector<std::int64_t> phoneIds = g2p_result.phone_ids;
-      std::vector<std::int64_t> word2ph = g2p_result.word2ph;
-      std::vector<std::string> phones = g2p_result.phones;
-      {
-        SHERPA_ONNX_LOGE(">>>> ConvertTextToTokenIdsKorean G2pResult");
-        // size
-        SHERPA_ONNX_LOGE(
-            ">>>> ConvertTextToTokenIdsKorean G2pResult phoneIds size: %zu, "
-            "phones size: %zu",
-            phoneIds.size(), phones.size());
-        std::ostringstream phone_stream;
-        int idx = 0;
-        for (auto count : word2ph) {
-          for (int i = 0; i < count; i++) {
-            phone_stream << phoneIds[idx + i] << ",";
-          }
-          idx += count;
-          phone_stream << "\n";
-        }
-        phone_stream << "\n";
-        SHERPA_ONNX_LOGE("%s", phone_stream.str().c_str());
-        std::ostringstream ph_stream;
-        idx = 0;
-        for (auto count : word2ph) {
-          for (int i = 0; i < count; i++) {
-            ph_stream << phones[idx + i] << ",";
-          }
-          idx += count;
-          ph_stream << "\n";
-        }
-        ph_stream << "\n";
-
-        SHERPA_ONNX_LOGE("%s", ph_stream.str().c_str());
-        std::ostringstream word2ph_stream;
-        for (auto e : word2ph) {
-          word2ph_stream << e << ",";
-        }
-        SHERPA_ONNX_LOGE(
-            ">>>> ConvertTextToTokenIdsKorean G2pResult word2ph 0 :%s",
-            word2ph_stream.str().c_str());
-        SHERPA_ONNX_LOGE(
-            ">>>> ConvertTextToTokenIdsKorean G2pResult word2ph size: %zu",
-            word2ph.size());
-        // SHERPA_ONNX_LOGE(
-        //     ">>>> ConvertTextToTokenIdsKorean G2pResult ja_bert_vec size:
-        //     %zu", ja_bert_vec.size());
+      if (IsOfflineTtsRequestCancelled()) {
+        break;
       }
 
-      /// 여기선 미리 해준다!!!! ja_bert_vec
-      // ADDBland 효과!!!!!!!
-      for (size_t i = 0; i < word2ph.size(); ++i) {
-        word2ph[i] = word2ph[i] * 2;
-        // Python의 print(word2ph)와 동일하게 매 반복마다 출력
-        std::cout << "word2ph (in loop): [";
-        for (size_t j = 0; j < word2ph.size(); ++j) {
-          std::cout << word2ph[j] << (j == word2ph.size() - 1 ? "" : ", ");
-        }
-        std::cout << "]" << std::endl;
-      }
-
-      // word2ph[0] += 1
-      if (!word2ph.empty()) {  // 벡터가 비어있지 않은지 확인
-        word2ph[0] += 1;
-      }
-
-      ///////////////////////////////////
-      ///////////////////////////////////
-      //
-      /// @file offline-tts-vits-impl.h
-      ///  Generate
-      //  여기가 아닌 [addBlank하고 맞춰야함!!!!!]
-      //
-      // if hps.data.add_blank:
-      //     phone = commons.intersperse(phone, 0) << 0을 시작서부터 사이 사이에
-      //     추가 tone = commons.intersperse(tone, 0) language =
-      //     commons.intersperse(language, 0) for i in range(len(word2ph)):
-      //         word2ph[i] = word2ph[i] * 2 << 각 항목 * 2
-      //     word2ph[0] += 1 <<  맨 첫 번째 항목에 1 추가
-
-      // 파이선에서는 이 코드를 지나고 ja_bert를 구해서
-      // bert_model
-      //     res = model(**inputs, output_hidden_states=True)
-      //     res = torch.cat(res["hidden_states"][-3:-2], -1)[0].cpu()
-      //     print("japanese_bert.py get_bert_feature res1", res.shape)
-      //     <<hidden_state[0].shape torch.Size([1, 9, 768]) #
-      //     print("japanese_bert.py get_bert_feature res1", res)
-      //     print("japanese_bert.py get_bert_feature word2ph", word2ph)
-      //     print("japanese_bert.py get_bert_feature inputs[input_ids].shape",
-      //     inputs["input_ids"].shape) print("japanese_bert.py get_bert_feature
-      //     inputs[input_ids].shape[-1]", inputs["input_ids"].shape[-1])
-
-      /////////////////////////////////////
-      // logs
-      // hidden_state.size 13
-      // japanese_bert.py get_bert_feature res1 torch.Size([9, 768])
-      // japanese_bert.py get_bert_feature word2ph [3, 14, 16, 8, 6, 12, 6, 6,
-      // 2]
-      // << 각 항목 * 2, 맨 첫 번째 항목에 1 추가 japanese_bert.py
-      // get_bert_feature inputs[input_ids].shape torch.Size([1, 9])
-      // japanese_bert.py get_bert_feature inputs[input_ids].shape[-1] 9
-      // japanese_bert.py get_bert_feature phone_level_feature  cnt: 0
-      // element.shape: torch.Size([3, 768]) japanese_bert.py get_bert_feature
-      // phone_level_feature  cnt: 0 element.shape: torch.Size([14, 768])
-      // japanese_bert.py get_bert_feature phone_level_feature  cnt: 0
-      // element.shape: torch.Size([16, 768]) japanese_bert.py get_bert_feature
-      // phone_level_feature  cnt: 0 element.shape: torch.Size([8, 768])
-      // japanese_bert.py get_bert_feature phone_level_feature  cnt: 0
-      // element.shape: torch.Size([6, 768]) japanese_bert.py get_bert_feature
-      // phone_level_feature  cnt: 0 element.shape: torch.Size([12, 768])
-      // japanese_bert.py get_bert_feature phone_level_feature  cnt: 0
-      // element.shape: torch.Size([6, 768]) japanese_bert.py get_bert_feature
-      // phone_level_feature  cnt: 0 element.shape: torch.Size([6, 768])
-      // japanese_bert.py get_bert_feature phone_level_feature  cnt: 0
-      // element.shape: torch.Size([2, 768])
-      ////////////////////////////////
-
-      // assert inputs["input_ids"].shape[-1] == len(word2ph),
-      // f"{inputs['input_ids'].shape[-1]}/{len(word2ph)}" word2phone = word2ph
-      // phone_level_feature = []
-      // for i in range(len(word2phone)):
-      //     repeat_feature = res[i].repeat(word2phone[i], 1)
-      //     # print("japanese_bert.py get_bert_feature repeat_feature",
-      //     repeat_feature) phone_level_feature.append(repeat_feature) #
-      //     print("japanese_bert.py get_bert_feature phone_level_feature",
-      //     phone_level_feature)
-
-      // cnt = 0
-      // for i in phone_level_feature:
-      //     print("japanese_bert.py get_bert_feature phone_level_feature","
-      //     cnt:",cnt,"element.shape:", i.shape)
-      // phone_level_feature = torch.cat(phone_level_feature, dim=0)
-      // print("japanese_bert.py get_bert_feature phone_level_feature 1",
-      // phone_level_feature, phone_level_feature.shape)
-      ////////////////////////////////////// torch.Size([73, 768])
-
-      // return phone_level_feature.T
-      //
-      /////////////////////////////////
-      /////////////////////////////////
-      std::vector<float> ja_bert_vec = GetJaBert(word, word2ph);
-      // ja_bert_vec에서 완전히 처리되서 나옴
-      // std::vector<float> ja_bert_vec_final;
-
-      // GetJJaBert(_text, word2ph);에서 완전히 처리
-      //  int token_idx = 0;
-      //  const int ja_bert_vec_size = 768;
-      //  std::ostringstream word2ph_stream;
-      //  for (auto e : word2ph) {
-      //    word2ph_stream << e << ",";
-      //    // word2ph 값이 1인 경우 해당 토큰은 건너뜁니다.
-      //    // 하지만 ja_bert_vec_input에서 다음 토큰 위치로 이동하기 위해
-      //    token_idx는
-      //    // 증가해야 합니다.
-      //    // if (e == 1) {
-      //    //   token_idx++;
-      //    //   continue;
-      //    // }
-
-      //   // ja_bert_vec_input에서 현재 토큰 벡터의 시작 위치를 계산합니다.
-      //   int start_idx_in_input = token_idx * ja_bert_vec_size;
-
-      //   // ja_bert_vec_input의 끝을 벗어나지 않도록 범위 체크
-      //   if (start_idx_in_input + ja_bert_vec_size > ja_bert_vec.size()) {
-      //     // std::cerr << "Error: Out of bounds access for ja_bert_vec_input
-      //     at
-      //     // token_idx " << token_idx << std::endl; SHERPA_ONNX_LOGE("Error:
-      //     Out
-      //     // of bounds access for ja_bert_vec_input at token_idx " <<
-      //     token_idx); SHERPA_ONNX_LOGE(
-      //         ">>>> ConvertTextToTokenIdsKorean ja_bert_vec_size: %zu",
-      //         ja_bert_vec_size);
-      //     SHERPA_ONNX_LOGE(
-      //         ">>>> ConvertTextToTokenIdsKorean ja_bert_vec.size(): %zu",
-      //         ja_bert_vec.size());
-      //     SHERPA_ONNX_LOGE(
-      //         ">>>> ConvertTextToTokenIdsKorean Error: Out of bounds access
-      //         for " "ja_bert_vec_input at token_idx %zu", token_idx);
-      //     break;  // 또는 적절한 오류 처리
-      //   }
-
-      //   // 현재 토큰에 해당하는 벡터의 시작과 끝 이터레이터를 가져옵니다.
-      //   auto it_begin = ja_bert_vec.begin() + start_idx_in_input;
-      //   auto it_end = ja_bert_vec.begin() + start_idx_in_input +
-      //   ja_bert_vec_size;
-
-      //   // 'e'번 반복하여 ja_bert_vec_final에 벡터를 통째로 추가합니다.
-      //   for (int i = 0; i < e; i++) {
-      //     ja_bert_vec_final.insert(ja_bert_vec_final.end(), it_begin,
-      //     it_end);
-      //     // SHERPA_ONNX_LOGE(
-      //     //     ">>>> ConvertTextToTokenIdsKorean ja_bert_vec_final size:
-      //     //     %zu,tokenIdx: %d", ja_bert_vec_final.size(),token_idx);
-      //   }
-      //   token_idx++;
-      // }
-      // SHERPA_ONNX_LOGE(">>>> word2ph addblanks sequence: %s",
-      //                  word2ph_stream.str().c_str());
-      SHERPA_ONNX_LOGE(
-          ">>>> ConvertTextToTokenIdsKorean ja_bert_vec_final size: %zu",
-          ja_bert_vec.size());
-
-      SHERPA_ONNX_LOGE(
-          ">>>> ConvertTextToTokenIdsKorean melo-tts-lexicon.cc phoneIds size: "
-          "%zu",
-          phoneIds.size());
-      SHERPA_ONNX_LOGE(
-          ">>>> ConvertTextToTokenIdsKorean melo-tts-lexicon.cc "
-          "ja_bert_vec_final size: %zu",
-          ja_bert_vec.size());
-      // print phoneme_ids for debugging
-
-      std::vector<TokenIDs> result_token_ids_vec;
-      // std::vector<std::int64_t> toneIds = CreateToneKo(phoneIds.size());
-      std::vector<std::int64_t> toneIds =
-          std::vector<std::int64_t>(phoneIds.size(), 11);
-
-      std::ostringstream oss;
-      oss << "real_ja_bert10: [";
-      for (size_t i = 0; i < 10; ++i) {
-        oss << ja_bert_vec[i] << ",";
-      }
-      oss << "]";
-      SHERPA_ONNX_LOGE("%s", oss.str().c_str());
-      // SHERPA_ONNX_LOGE("=======THIS TEMP JARBERT as 0 =======");
-
-      // std::vector<float> temp_ja_bert_vec_final =
-      //     std::vector<float>(ja_bert_vec_final.size(), 0.0);
-      SHERPA_ONNX_LOGE(
-          ">>>> ConvertTextToTokenIdsKorean 768 * phoneIds size: %zu = %zu "
-          "should  same ja_bert_vec_final.size :%zu",
-          phoneIds.size(), 768 * phoneIds.size(), ja_bert_vec.size());
-      this_sentence.tokens.insert(this_sentence.tokens.end(), phoneIds.begin(),
-                                  phoneIds.end());
-      this_sentence.tones.insert(this_sentence.tones.end(), toneIds.begin(),
-                                 toneIds.end());
-      this_sentence.ja_bert_vec.insert(this_sentence.ja_bert_vec.end(),
-                                       ja_bert_vec.begin(), ja_bert_vec.end());
-
-      this_sentence.sentences.push_back(word);
-
-      
-      // if (word == "." || word == "!" || word == "?" || word == "," ||
-      //     word == "。" || word == "！" || word == "？" || word == "，") {
-        ans.push_back(std::move(this_sentence));
-        this_sentence = {};
-      // }
-      // result_token_ids_vec.emplace_back(std::move(phoneIds),
-      // std::move(toneIds),
-      //                                   std::move(ja_bert_vec));
-      // if (debug_) {
-      //   std::ostringstream oss;
-      //   oss << "phoneme_ids: [";
-      //   for (size_t i = 0; i < result_token_ids_vec[0].tokens.size(); ++i) {
-      //     oss << result_token_ids_vec[0].tokens[i];
-      //     if (i < result_token_ids_vec[0].tokens.size() - 1) {
-      //       oss << ", ";
-      //     }
-      //   }
-      //   oss << "]";
-      //   SHERPA_ONNX_LOGE("%s", oss.str().c_str());
-      // }
+      SHERPA_ONNX_LOGT("ConvertTextToTokenIdsKorean word: %s", word.c_str());
+      TokenIDs this_sentence = ConvertSentenceToTokenIdsKorean(word);
+      ComputeJaBertKorean(&this_sentence);
+      ans.push_back(std::move(this_sentence));
     }
     // if (!this_sentence.tokens.empty()) {
     //   ans.push_back(std::move(this_sentence));
     // }
     // print this_sentence all
-    for (int i = 0; i < ans.size(); i++) {
-      std::ostringstream oss;
-      oss << "phoneme_ids: [";
-      for (size_t j = 0; j < ans[i].tokens.size(); ++j) {
-        oss << ans[i].tokens[j];
-        if (j < ans[i].tokens.size() - 1) {
-          oss << ", ";
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      for (int i = 0; i < ans.size(); i++) {
+        std::ostringstream oss;
+        oss << "phoneme_ids: [";
+        for (size_t j = 0; j < ans[i].tokens.size(); ++j) {
+          oss << ans[i].tokens[j];
+          if (j < ans[i].tokens.size() - 1) {
+            oss << ", ";
+          }
         }
-      }
-      oss << "]\n";
-      SHERPA_ONNX_LOGE("%s", oss.str().c_str());
-      oss.clear();
-      oss << "tones: [";
-      for (size_t j = 0; j < ans[i].tones.size(); ++j) {
-        oss << ans[i].tones[j];
-        if (j < ans[i].tones.size() - 1) {
-          oss << ", ";
+        oss << "]\n";
+        SHERPA_ONNX_LOGT("%s", oss.str().c_str());
+        oss.clear();
+        oss << "tones: [";
+        for (size_t j = 0; j < ans[i].tones.size(); ++j) {
+          oss << ans[i].tones[j];
+          if (j < ans[i].tones.size() - 1) {
+            oss << ", ";
+          }
         }
-      }
-      oss << "]\n";
-      SHERPA_ONNX_LOGE("%s", oss.str().c_str());
-      oss.clear();
-      oss << "ja_bert_vec.size: [";
-      // for (size_t j = 0; j < ans[i].ja_bert_vec.size(); ++j) {
-      oss << ans[i].ja_bert_vec.size();
-      // if (j < ans[i].ja_bert_vec.size() - 1) {
-      //   oss << ", ";
-      // }
-      oss << "]\n";
-      // }
-      SHERPA_ONNX_LOGE("%s", oss.str().c_str());
-      oss.clear();
-      oss << "sentences: [";
-      for (size_t j = 0; j < ans[i].sentences.size(); ++j) {
-        oss << ans[i].sentences[j];
-        if (j < ans[i].sentences.size() - 1) {
-          oss << ", ";
+        oss << "]\n";
+        SHERPA_ONNX_LOGT("%s", oss.str().c_str());
+        oss.clear();
+        oss << "ja_bert_vec.size: [";
+        // for (size_t j = 0; j < ans[i].ja_bert_vec.size(); ++j) {
+        oss << ans[i].ja_bert_vec.size();
+        // if (j < ans[i].ja_bert_vec.size() - 1) {
+        //   oss << ", ";
+        // }
+        oss << "]\n";
+        // }
+        SHERPA_ONNX_LOGT("%s", oss.str().c_str());
+        oss.clear();
+        oss << "sentences: [";
+        for (size_t j = 0; j < ans[i].sentences.size(); ++j) {
+          oss << ans[i].sentences[j];
+          if (j < ans[i].sentences.size() - 1) {
+            oss << ", ";
+          }
         }
+        oss << "]\n";
+        SHERPA_ONNX_LOGT("%s", oss.str().c_str());
       }
-      oss << "]\n";
-      SHERPA_ONNX_LOGE("%s", oss.str().c_str());
     }
 
     return ans;
@@ -669,17 +552,17 @@ class MeloTtsLexicon::Impl {
     // SHERPA_ONNX_LOGE는 배포 시 로깅 수준을 낮추는 것이 좋습니다.
     // if text start with english check
     char16_t firstChar = _text.at(0);
-    SHERPA_ONNX_LOGE(">>> ConvertTextToTokenIds firstChar: %c %s", firstChar,
+    SHERPA_ONNX_LOGD(">>> ConvertTextToTokenIds firstChar: %c %s", firstChar,
                      _text.c_str());
 
     if ((firstChar >= char16_t('a') && firstChar <= char16_t('z')) ||
         (firstChar >= char16_t('A') && firstChar <= char16_t('Z'))) {
-      SHERPA_ONNX_LOGE("ConvertTextToTokenIds called with do origin text: %s",
+      SHERPA_ONNX_LOGD("ConvertTextToTokenIds called with do origin text: %s",
                        _text.c_str());
       return ConvertTextToTokenIdsOrigin(_text);
     }
 
-    SHERPA_ONNX_LOGE("ConvertTextToTokenIds called do kroean with text: %s",
+    SHERPA_ONNX_LOGD("ConvertTextToTokenIds called do kroean with text: %s",
                      _text.c_str());
     return ConvertTextToTokenIdsKorean(_text);
 
@@ -765,7 +648,7 @@ class MeloTtsLexicon::Impl {
         }
       }
 
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           "Hardcoded Korean text '밟아 밟아' detected. Using pre-defined "
           "phonemes and tones.");
       // 단일 문장이므로, TokenIDs 객체를 만들어서 벡터에 추가
@@ -777,17 +660,7 @@ class MeloTtsLexicon::Impl {
 
     // ** 기존 MeloTTS(중국어/영어) 처리 로직 시작 **
     // 밟아 밟아 가 아닌 다른 텍스트일 경우 기존 로직을 따릅니다.
-    std::regex punct_re{"：|、|；"};
-    std::string s = std::regex_replace(text, punct_re, ",");
-
-    std::regex punct_re2("。");
-    s = std::regex_replace(s, punct_re2, ".");
-
-    std::regex punct_re3("？");
-    s = std::regex_replace(s, punct_re3, "?");
-
-    std::regex punct_re4("！");
-    s = std::regex_replace(s, punct_re4, "!");
+    std::string s = ChinesePunctuationNormalizer().Normalize(text);
 
     std::vector<std::string> words;
     if (jieba_) {  // jieba_가 초기화되어 있다면 (주로 중국어)
@@ -838,7 +711,7 @@ class MeloTtsLexicon::Impl {
     for (const auto &w : words) {
       auto ids = ConvertWordToIds(w);  // lexicon에서 단어에 해당하는 ID를 찾음
       if (ids.tokens.empty()) {
-        SHERPA_ONNX_LOGE("Ignore OOV '%s'", w.c_str());
+        SHERPA_ONNX_LOGW("Ignore OOV '%s'", w.c_str());
         continue;
       }
 
@@ -868,17 +741,7 @@ class MeloTtsLexicon::Impl {
   // see
   //
   https:  // github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
-    std::regex punct_re{"：|、|；"};
-    std::string s = std::regex_replace(text, punct_re, ",");
-
-    std::regex punct_re2("。");
-    s = std::regex_replace(s, punct_re2, ".");
-
-    std::regex punct_re3("？");
-    s = std::regex_replace(s, punct_re3, "?");
-
-    std::regex punct_re4("！");
-    s = std::regex_replace(s, punct_re4, "!");
+    std::string s = ChinesePunctuationNormalizer().Normalize(text);
 
     std::vector<std::string> words;
     if (jieba_) {
@@ -929,7 +792,7 @@ class MeloTtsLexicon::Impl {
     for (const auto &w : words) {
       auto ids = ConvertWordToIds(w);
       if (ids.tokens.empty()) {
-        SHERPA_ONNX_LOGE("Ignore OOV '%s'", w.c_str());
+        SHERPA_ONNX_LOGW("Ignore OOV '%s'", w.c_str());
         continue;
       }
 
@@ -954,27 +817,28 @@ class MeloTtsLexicon::Impl {
 
   std::vector<float> GetJaBert(const std::string &text,
                                std::vector<int64_t> &word2ph_final) const {
+    ScopedTrace trace(TraceStage::kBert);
     Ort::MemoryInfo memory_info =
         Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-    SHERPA_ONNX_LOGE("--- Tokenization & BERT Input Preparation ---");
+    SHERPA_ONNX_LOGD("--- Tokenization & BERT Input Preparation ---");
 
     auto tokens_with_ids = tokenizer_kor_->tokenize_with_ids(text);
     auto ids = tokens_with_ids.second;    // input_ids에 사용될 ID 값
     auto tokens = tokens_with_ids.first;  // input_ids에 사용될 토큰 값
     // TextToPhoneId()
-    {
+    if (SHERPA_ONNX_LOG_ENABLED(DEBUG)) {
       std::ostringstream os;
       for (const auto &id : ids) {
         os << id << " ";
       }
-      SHERPA_ONNX_LOGE("GetJaBert input_ids: %s", os.str().c_str());
+      SHERPA_ONNX_LOGD("GetJaBert input_ids: %s", os.str().c_str());
     }
-    {
+    if (SHERPA_ONNX_LOG_ENABLED(DEBUG)) {
       std::ostringstream os;
       for (const auto &token : tokens) {
         os << token << " ";
       }
-      SHERPA_ONNX_LOGE("GetJaBert tokens: %s", os.str().c_str());
+      SHERPA_ONNX_LOGD("GetJaBert tokens: %s", os.str().c_str());
     }
 
     // tokenizer_kor_->tokenize_with_ids(text);
@@ -1001,7 +865,7 @@ class MeloTtsLexicon::Impl {
         bert_input_shape.data(), bert_input_shape.size()));
 
     // 2. BERT 모델 추론 실행
-    SHERPA_ONNX_LOGE("--- Running BERT Inference ---");
+    SHERPA_ONNX_LOGD("--- Running BERT Inference ---");
     std::vector<Ort::Value> bert_output_tensors;
     const char *my_input_names[] = {"input_ids", "attention_mask",
                                     "token_type_ids"};
@@ -1009,12 +873,21 @@ class MeloTtsLexicon::Impl {
       // BERT 모델의 입력 이름 순서가 중요합니다. "input_ids", "attention_mask",
       // "token_type_ids" ja_bert_input_names_ptr_는 InitJaBert에서 이미 모델의
       // 실제 입력 이름을 얻어와 채워져 있어야 합니다.
+      // Terminate the run if the current request is cancelled
+      Ort::RunOptions run_options;
+      ScopedOfflineTtsCancelCallback on_cancel(
+          [&run_options]() { run_options.SetTerminate(); });
+
       bert_output_tensors = ja_bert_sess_->Run(
-          Ort::RunOptions{nullptr}, my_input_names, bert_input_tensors.data(),
+          run_options, my_input_names, bert_input_tensors.data(),
           bert_input_tensors.size(), ja_bert_output_names_ptr_.data(),
           ja_bert_output_names_ptr_.size());
-      SHERPA_ONNX_LOGE("BERT Inference completed successfully.");
+      SHERPA_ONNX_LOGD("BERT Inference completed successfully.");
     } catch (const Ort::Exception &e) {
+      if (IsOfflineTtsRequestCancelled()) {
+        SHERPA_ONNX_LOGD("BERT inference is cancelled: %s", e.what());
+        return {};
+      }
       SHERPA_ONNX_LOGE("Error running BERT inference: %s", e.what());
       return {};  // 에러 발생 시 빈 벡터 반환
     }
@@ -1031,7 +904,17 @@ class MeloTtsLexicon::Impl {
       return {};
     }
 
-    SHERPA_ONNX_LOGE("GetJatBert bert_output_tensors.size(): %d",
+    // The BERT model may be converted to float16 without keeping float32
+    // outputs
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (auto &t : bert_output_tensors) {
+      if (t.GetTensorTypeAndShapeInfo().GetElementType() ==
+          ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        t = ConvertFloat16ToFloat(allocator, &t);
+      }
+    }
+
+    SHERPA_ONNX_LOGD("GetJatBert bert_output_tensors.size(): %d",
                      bert_output_tensors.size());
     // BERT 모델의 첫 번째 출력을 가져옵니다.
     Ort::Value &bert_output_tensor = bert_output_tensors[0];
@@ -1039,75 +922,78 @@ class MeloTtsLexicon::Impl {
     std::vector<int64_t> bert_output_shape = bert_output_info.GetShape();
     size_t bert_output_size = bert_output_info.GetElementCount();
     // bert_output_tensors의 모든 텐서들을 순회하며 출력
-    for (size_t i = 0; i < bert_output_tensors.size(); ++i) {
-      Ort::Value &current_tensor = bert_output_tensors[i];
-      auto current_info = current_tensor.GetTensorTypeAndShapeInfo();
-      std::vector<int64_t> current_shape = current_info.GetShape();
-      size_t current_element_count = current_info.GetElementCount();
-
-      SHERPA_ONNX_LOGE("--- Tensor %zu of bert_output_tensors ---", i);
-
-      // 텐서의 형태(shape) 출력
-      std::string shape_str = "[";
-      for (size_t dim_idx = 0; dim_idx < current_shape.size(); ++dim_idx) {
-        shape_str += std::to_string(current_shape[dim_idx]);
-        if (dim_idx < current_shape.size() - 1) {
-          shape_str += ", ";
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      for (size_t i = 0; i < bert_output_tensors.size(); ++i) {
+        Ort::Value &current_tensor = bert_output_tensors[i];
+        auto current_info = current_tensor.GetTensorTypeAndShapeInfo();
+        std::vector<int64_t> current_shape = current_info.GetShape();
+        size_t current_element_count = current_info.GetElementCount();
+
+        SHERPA_ONNX_LOGT("--- Tensor %zu of bert_output_tensors ---", i);
+
+        // 텐서의 형태(shape) 출력
+        std::string shape_str = "[";
+        for (size_t dim_idx = 0; dim_idx < current_shape.size(); ++dim_idx) {
+          shape_str += std::to_string(current_shape[dim_idx]);
+          if (dim_idx < current_shape.size() - 1) {
+            shape_str += ", ";
+          }
         }
-      }
-      shape_str += "]";
-      SHERPA_ONNX_LOGE("Shape: %s", shape_str.c_str());
-      SHERPA_ONNX_LOGE("Total elements: %zu", current_element_count);
-
-      // 텐서 데이터에 접근하여 모든 벡터의 앞 3개 원소 출력
-      if (current_element_count > 0 &&
-          current_shape.size() >=
-              3) {  // 최소한 [batch, seq_len, hidden_size] 형태여야 함
-        float *current_data = current_tensor.GetTensorMutableData<float>();
-
-        // current_shape: [batch_size, sequence_length, hidden_size]
-        // 여기서 batch_size는 1이라고 가정합니다.
-        // int64_t sequence_length = current_shape[1];
-        int64_t sequence_length = 5;
-        int64_t hidden_size = current_shape[2];
-
-        const size_t num_elements_to_print_per_vector =
-            std::min((size_t)3, (size_t)hidden_size);
-
-        SHERPA_ONNX_LOGE("5개만 보이게==================");
-        SHERPA_ONNX_LOGE(
-            "Printing first %zu elements for each of %lld vectors (tokens):",
-            num_elements_to_print_per_vector, sequence_length);
-
-        for (int64_t seq_idx = 0; seq_idx < sequence_length; ++seq_idx) {
-          std::string vector_elements_str = "Vector (token) ";
-          vector_elements_str += std::to_string(seq_idx);
-          vector_elements_str += ": [";
-
-          // 각 벡터의 시작 오프셋 계산: seq_idx * hidden_size
-          float *vector_start_ptr = current_data + (seq_idx * hidden_size);
-
-          for (size_t elem_idx = 0; elem_idx < num_elements_to_print_per_vector;
-               ++elem_idx) {
-            vector_elements_str += std::to_string(vector_start_ptr[elem_idx]);
-            if (elem_idx < num_elements_to_print_per_vector - 1) {
-              vector_elements_str += ", ";
+        shape_str += "]";
+        SHERPA_ONNX_LOGT("Shape: %s", shape_str.c_str());
+        SHERPA_ONNX_LOGT("Total elements: %zu", current_element_count);
+
+        // 텐서 데이터에 접근하여 모든 벡터의 앞 3개 원소 출력
+        if (current_element_count > 0 &&
+            current_shape.size() >=
+                3) {  // 최소한 [batch, seq_len, hidden_size] 형태여야 함
+          float *current_data = current_tensor.GetTensorMutableData<float>();
+
+          // current_shape: [batch_size, sequence_length, hidden_size]
+          // 여기서 batch_size는 1이라고 가정합니다.
+          // int64_t sequence_length = current_shape[1];
+          int64_t sequence_length = std::min<int64_t>(5, current_shape[1]);
+          int64_t hidden_size = current_shape[2];
+
+          const size_t num_elements_to_print_per_vector =
+              std::min((size_t)3, (size_t)hidden_size);
+
+          SHERPA_ONNX_LOGT("5개만 보이게==================");
+          SHERPA_ONNX_LOGT(
+              "Printing first %zu elements for each of %lld vectors (tokens):",
+              num_elements_to_print_per_vector, sequence_length);
+
+          for (int64_t seq_idx = 0; seq_idx < sequence_length; ++seq_idx) {
+            std::string vector_elements_str = "Vector (token) ";
+            vector_elements_str += std::to_string(seq_idx);
+            vector_elements_str += ": [";
+
+            // 각 벡터의 시작 오프셋 계산: seq_idx * hidden_size
+            float *vector_start_ptr = current_data + (seq_idx * hidden_size);
+
+            for (size_t elem_idx = 0;
+                 elem_idx < num_elements_to_print_per_vector; ++elem_idx) {
+              vector_elements_str +=
+                  std::to_string(vector_start_ptr[elem_idx]);
+              if (elem_idx < num_elements_to_print_per_vector - 1) {
+                vector_elements_str += ", ";
+              }
             }
+            vector_elements_str += "]";
+            SHERPA_ONNX_LOGT("%s", vector_elements_str.c_str());
           }
-          vector_elements_str += "]";
-          SHERPA_ONNX_LOGE("%s", vector_elements_str.c_str());
+        } else if (current_element_count > 0 && current_shape.size() < 3) {
+          SHERPA_ONNX_LOGE(
+              "Warning: Tensor has fewer than 3 dimensions. Cannot process as "
+              "[batch, seq_len, hidden_size].");
+          // 이 경우에는 기존처럼 전체 텐서의 처음 10개 원소를 출력할 수 있습니다.
+          // 예를 들어:
+          // size_t num_elements_to_print = std::min((size_t)10,
+          // current_element_count);
+          // ... (기존 처음 10개 출력 로직) ...
+        } else {
+          SHERPA_ONNX_LOGT("Tensor is empty (0 elements).");
         }
-      } else if (current_element_count > 0 && current_shape.size() < 3) {
-        SHERPA_ONNX_LOGE(
-            "Warning: Tensor has fewer than 3 dimensions. Cannot process as "
-            "[batch, seq_len, hidden_size].");
-        // 이 경우에는 기존처럼 전체 텐서의 처음 10개 원소를 출력할 수 있습니다.
-        // 예를 들어:
-        // size_t num_elements_to_print = std::min((size_t)10,
-        // current_element_count);
-        // ... (기존 처음 10개 출력 로직) ...
-      } else {
-        SHERPA_ONNX_LOGE("Tensor is empty (0 elements).");
       }
     }
     // 추출된 BERT 출력의 핵심 차원
@@ -1117,7 +1003,7 @@ class MeloTtsLexicon::Impl {
 
     // word2ph_final의 길이와 original_sequence_length가 일치하는지 확인 (필수)
     if (word2ph_final.size() != original_sequence_length) {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGW(
           "Mismatch between word2ph_final size (%zu) and BERT original "
           "sequence length (%lld).",
           word2ph_final.size(), original_sequence_length);
@@ -1130,7 +1016,7 @@ class MeloTtsLexicon::Impl {
       expanded_sequence_length += count;
     }
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         "Original BERT sequence length: %lld, Expanded sequence length: %lld",
         original_sequence_length, expanded_sequence_length);
     float *bert_output_data = bert_output_tensor.GetTensorMutableData<float>();
@@ -1160,7 +1046,7 @@ class MeloTtsLexicon::Impl {
       }
     }
 
-    SHERPA_ONNX_LOGE("Expanded data generated. Flat size: %zu",
+    SHERPA_ONNX_LOGD("Expanded data generated. Flat size: %zu",
                      expanded_data_flat.size());
 
     // (디버깅용) 확장된 데이터의 앞 10개 원소 출력
@@ -1193,22 +1079,24 @@ class MeloTtsLexicon::Impl {
       }
     }
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         "Data transposed and copied to ja_bert_vec. Final ja_bert_vec size: "
         "%zu",
         ja_bert_vec.size());
 
     // (디버깅용) 최종 ja_bert_vec의 앞 10개 원소 출력 (전치된 형태)
-    SHERPA_ONNX_LOGE("Final ja_bert_vec (first 10 elements):");
-    std::string final_elements_str = "[";
-    for (size_t k = 0; k < std::min((size_t)10, ja_bert_vec.size()); ++k) {
-      final_elements_str += std::to_string(ja_bert_vec[k]);
-      if (k < std::min((size_t)10, ja_bert_vec.size()) - 1) {
-        final_elements_str += ", ";
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      SHERPA_ONNX_LOGT("Final ja_bert_vec (first 10 elements):");
+      std::string final_elements_str = "[";
+      for (size_t k = 0; k < std::min((size_t)10, ja_bert_vec.size()); ++k) {
+        final_elements_str += std::to_string(ja_bert_vec[k]);
+        if (k < std::min((size_t)10, ja_bert_vec.size()) - 1) {
+          final_elements_str += ", ";
+        }
       }
+      final_elements_str += "]";
+      SHERPA_ONNX_LOGT("%s", final_elements_str.c_str());
     }
-    final_elements_str += "]";
-    SHERPA_ONNX_LOGE("%s", final_elements_str.c_str());
 
     return ja_bert_vec;
     // auto bert_output_info = bert_output_tensor.GetTensorTypeAndShapeInfo();
@@ -1256,10 +1144,11 @@ class MeloTtsLexicon::Impl {
     // SHERPA_ONNX_LOGE(">>>> InitTokenizer vocab_path: %s",
     // vocab_path.c_str());
     tokenizer_kor_ = std::make_unique<WordPieceTokenizer>(is, true);
-    // if (debug_) {
-    auto tokens = tokenizer_kor_->tokenize("안녕하세요 좋은 아침입니다.");
-    for (const auto &t : tokens) {
-      SHERPA_ONNX_LOGE(">>>> InitTokenizer tokenizer test %s", t.c_str());
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      auto tokens = tokenizer_kor_->tokenize("안녕하세요 좋은 아침입니다.");
+      for (const auto &t : tokens) {
+        SHERPA_ONNX_LOGT(">>>> InitTokenizer tokenizer test %s", t.c_str());
+      }
     }
     // SHERPA_ONNX_LOGE(">>>> InitTokenizer tokenizer test %s",
     // vocab_path.c_str());
@@ -1306,7 +1195,7 @@ class MeloTtsLexicon::Impl {
   }
 
   void InitTokens(std::istream &is) {
-    SHERPA_ONNX_LOGE("InitTokens called");
+    SHERPA_ONNX_LOGD("InitTokens called");
     token2id_ = ReadTokens(is);
     token2id_[" "] = token2id_["_"];
 
@@ -1326,16 +1215,18 @@ class MeloTtsLexicon::Impl {
     if (!token2id_.count("、") && token2id_.count("，")) {
       token2id_["、"] = token2id_["，"];
     }
-    SHERPA_ONNX_LOGE("InitTokens completed, token2id_ size: %zu",
+    SHERPA_ONNX_LOGD("InitTokens completed, token2id_ size: %zu",
                      token2id_.size());
-    std::ostringstream oss;
-    oss << "token2id_: {";
-    for (const auto &pair : token2id_) {
-      oss << "\"" << pair.first << "\": " << pair.second << ", ";
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      std::ostringstream oss;
+      oss << "token2id_: {";
+      for (const auto &pair : token2id_) {
+        oss << "\"" << pair.first << "\": " << pair.second << ", ";
+      }
+      oss << "}";
+      SHERPA_ONNX_LOGT("%s", oss.str().c_str());
     }
-    oss << "}";
-    SHERPA_ONNX_LOGE("%s", oss.str().c_str());
-    SHERPA_ONNX_LOGE("InitTokens completed");
+    SHERPA_ONNX_LOGD("InitTokens completed");
   }
 
   void InitLexicon(std::istream &is) {
@@ -1362,7 +1253,7 @@ class MeloTtsLexicon::Impl {
       ToLowerCase(&word);
 
       if (word2ids_.count(word)) {
-        SHERPA_ONNX_LOGE("Duplicated word: %s at line %d:%s. Ignore it.",
+        SHERPA_ONNX_LOGW("Duplicated word: %s at line %d:%s. Ignore it.",
                          word.c_str(), line_num, line.c_str());
         continue;
       }
@@ -1410,7 +1301,7 @@ class MeloTtsLexicon::Impl {
     word2ids_["嗯"] = word2ids_["恩"];
   }
   void InitJaBert(void *model_data, size_t model_data_length) {
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::InitJaBert() "
         "csrc/offline-tts-vits-model.cc start");
     ja_bert_env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ja_bert");
@@ -1426,20 +1317,20 @@ class MeloTtsLexicon::Impl {
 
     // // get meta data
     Ort::ModelMetadata meta_data = ja_bert_sess_->GetModelMetadata();
-    // // if (config_.debug) {
-    std::ostringstream os;
-    os << "---ja_bert model---\n";
-    PrintModelMetadata(os, meta_data);
-    os << "----------input names----------\n";
-    for (auto &name : ja_bert_input_names_) {
-      os << name << "\n";
-    }
-    os << "----------output names----------\n";
-    for (auto &name : ja_bert_output_names_) {
-      os << name << "\n";
+    if (SHERPA_ONNX_LOG_ENABLED(DEBUG)) {
+      std::ostringstream os;
+      os << "---ja_bert model---\n";
+      PrintModelMetadata(os, meta_data);
+      os << "----------input names----------\n";
+      for (auto &name : ja_bert_input_names_) {
+        os << name << "\n";
+      }
+      os << "----------output names----------\n";
+      for (auto &name : ja_bert_output_names_) {
+        os << name << "\n";
+      }
+      SHERPA_ONNX_LOGD("%s", os.str().c_str());
     }
-    SHERPA_ONNX_LOGE("%s", os.str().c_str());
-    // }
   }
 
  private:
@@ -1451,7 +1342,7 @@ class MeloTtsLexicon::Impl {
 
   OfflineTtsVitsModelMetaData meta_data_;
 
-  std::unique_ptr<cppjieba::Jieba> jieba_;
+  std::shared_ptr<const cppjieba::Jieba> jieba_;
 
   std::unique_ptr<WordPieceTokenizer> tokenizer_kor_;
 
@@ -1514,6 +1405,24 @@ MeloTtsLexicon::MeloTtsLexicon(Manager *mgr, const std::string &lexicon,
     : impl_(std::make_unique<Impl>(mgr, lexicon, tokens, ja_bert_model_path,
                                    vocab_path, meta_data, debug)) {}
 
+bool MeloTtsLexicon::SupportsSentenceSplitting() const {
+  return impl_->SupportsSentenceSplitting();
+}
+
+std::vector<std::string> MeloTtsLexicon::SplitSentences(
+    const std::string &text) const {
+  return impl_->SplitSentencesKorean(text);
+}
+
+TokenIDs MeloTtsLexicon::ConvertSentenceToTokenIds(
+    const std::string &sentence) const {
+  return impl_->ConvertSentenceToTokenIdsKorean(sentence);
+}
+
+void MeloTtsLexicon::ComputeBertFeatures(TokenIDs *token_ids) const {
+  impl_->ComputeJaBertKorean(token_ids);
+}
+
 std::vector<TokenIDs> MeloTtsLexicon::ConvertTextToTokenIds(
     const std::string &text, const std::string & /*unused_voice = ""*/) const {
   // return impl_->ConvertTextToTokenIdsKorean(text);
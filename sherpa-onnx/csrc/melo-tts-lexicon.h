@@ -44,7 +44,17 @@ class MeloTtsLexicon : public OfflineTtsFrontend {
   std::vector<TokenIDs> ConvertTextToTokenIds(
       const std::string &text,
       const std::string &unused_voice = "") const override;
-  
+
+  bool SupportsSentenceSplitting() const override;
+
+  std::vector<std::string> SplitSentences(
+      const std::string &text) const override;
+
+  TokenIDs ConvertSentenceToTokenIds(
+      const std::string &sentence) const override;
+
+  void ComputeBertFeatures(TokenIDs *token_ids) const override;
+
   // std::vector<float> GetJaBert(const std::string &text) const override;
 
  private:
@@ -0,0 +1,183 @@
+// sherpa-onnx/csrc/multi-stream-vad-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/multi-stream-vad.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace sherpa_onnx {
+
+// Window shift of silero VAD at 16 kHz
+static constexpr int32_t kWindowShift = 512;
+
+static std::vector<SpeechSegment> PopSegments(VoiceActivityDetector *vad) {
+  std::vector<SpeechSegment> ans;
+  while (!vad->Empty()) {
+    ans.push_back(vad->Front());
+    vad->Pop();
+  }
+  return ans;
+}
+
+static std::vector<SpeechSegment> PopSegments(VadStream *s) {
+  std::vector<SpeechSegment> ans;
+  while (!s->Empty()) {
+    ans.push_back(s->Front());
+    s->Pop();
+  }
+  return ans;
+}
+
+// Run VoiceActivityDetector on samples, passing one window at a time
+static std::vector<SpeechSegment> RunSingleStream(
+    const VadModelConfig &config, const std::vector<float> &samples) {
+  VoiceActivityDetector vad(config);
+
+  for (int32_t i = 0; i + kWindowShift <= static_cast<int32_t>(samples.size());
+       i += kWindowShift) {
+    vad.AcceptWaveform(samples.data() + i, kWindowShift);
+  }
+  vad.Flush();
+
+  return PopSegments(&vad);
+}
+
+static bool ReadTestData(VadModelConfig *config, std::vector<float> *samples) {
+  std::string model = "./silero_vad.onnx";
+  std::string wave = "./lei-jun-test.wav";
+  if (!FileExists(model) || !FileExists(wave)) {
+    SHERPA_ONNX_LOGE("%s or %s does not exist. Skipping test", model.c_str(),
+                     wave.c_str());
+    return false;
+  }
+
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  *samples = ReadWave(wave, &sample_rate, &is_ok);
+  if (!is_ok || sample_rate != 16000) {
+    SHERPA_ONNX_LOGE("Failed to read %s as a 16 kHz wave file", wave.c_str());
+    return false;
+  }
+
+  config->silero_vad.model = model;
+  config->sample_rate = sample_rate;
+  return true;
+}
+
+// VadSegmenter is updated once per window in MultiStreamVad and once per
+// AcceptWaveform() call in VoiceActivityDetector. When each call passes a
+// single window, both must give exactly the same segments.
+TEST(MultiStreamVad, MatchesVoiceActivityDetector) {
+  VadModelConfig config;
+  std::vector<float> samples;
+  if (!ReadTestData(&config, &samples)) {
+    return;
+  }
+
+  std::vector<SpeechSegment> expected = RunSingleStream(config, samples);
+  ASSERT_FALSE(expected.empty());
+
+  MultiStreamVad vad(config);
+  std::unique_ptr<VadStream> s = vad.CreateStream();
+  VadStream *ss = s.get();
+
+  std::vector<SpeechSegment> segments;
+  for (int32_t i = 0; i + kWindowShift <= static_cast<int32_t>(samples.size());
+       i += kWindowShift) {
+    s->AcceptWaveform(samples.data() + i, kWindowShift);
+    vad.Process(&ss, 1);
+
+    std::vector<SpeechSegment> v = PopSegments(s.get());
+    segments.insert(segments.end(), v.begin(), v.end());
+  }
+  s->Flush();
+
+  std::vector<SpeechSegment> v = PopSegments(s.get());
+  segments.insert(segments.end(), v.begin(), v.end());
+
+  ASSERT_EQ(segments.size(), expected.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(segments.size()); ++i) {
+    EXPECT_EQ(segments[i].start, expected[i].start) << "segment " << i;
+    EXPECT_EQ(segments[i].samples, expected[i].samples) << "segment " << i;
+  }
+}
+
+// Several streams in one batch, each receiving many windows per call of
+// Process(). The results of the batched model may differ slightly from
+// those of a single run, so a segment boundary may move by a window.
+TEST(MultiStreamVad, BatchedStreams) {
+  VadModelConfig config;
+  std::vector<float> samples;
+  if (!ReadTestData(&config, &samples)) {
+    return;
+  }
+
+  // Each stream starts at a different position of the test wave
+  std::vector<int32_t> offsets = {0, 8000, 24000};
+  int32_t num_streams = static_cast<int32_t>(offsets.size());
+
+  std::vector<std::vector<float>> inputs;
+  for (int32_t offset : offsets) {
+    std::vector<float> v(samples.begin() + offset, samples.end());
+    v.insert(v.end(), samples.begin(), samples.begin() + offset);
+    inputs.push_back(std::move(v));
+  }
+
+  MultiStreamVad vad(config, 2);
+  std::vector<std::unique_ptr<VadStream>> streams;
+  std::vector<VadStream *> ss;
+  for (int32_t i = 0; i != num_streams; ++i) {
+    streams.push_back(vad.CreateStream());
+    ss.push_back(streams.back().get());
+  }
+
+  std::vector<std::vector<SpeechSegment>> segments(num_streams);
+  int32_t chunk = 10 * kWindowShift;
+  int32_t num_samples = static_cast<int32_t>(samples.size());
+  for (int32_t start = 0; start < num_samples; start += chunk) {
+    int32_t n = std::min(chunk, num_samples - start);
+    for (int32_t i = 0; i != num_streams; ++i) {
+      streams[i]->AcceptWaveform(inputs[i].data() + start, n);
+    }
+
+    vad.Process(ss.data(), num_streams);
+
+    for (int32_t i = 0; i != num_streams; ++i) {
+      std::vector<SpeechSegment> v = PopSegments(streams[i].get());
+      segments[i].insert(segments[i].end(), v.begin(), v.end());
+    }
+  }
+
+  for (int32_t i = 0; i != num_streams; ++i) {
+    streams[i]->Flush();
+    std::vector<SpeechSegment> v = PopSegments(streams[i].get());
+    segments[i].insert(segments[i].end(), v.begin(), v.end());
+
+    std::vector<SpeechSegment> expected = RunSingleStream(config, inputs[i]);
+    ASSERT_EQ(segments[i].size(), expected.size()) << "stream " << i;
+
+    for (int32_t k = 0; k != static_cast<int32_t>(expected.size()); ++k) {
+      EXPECT_LE(std::abs(segments[i][k].start - expected[k].start),
+                kWindowShift)
+          << "stream " << i << ", segment " << k;
+
+      int32_t n1 = static_cast<int32_t>(segments[i][k].samples.size());
+      int32_t n2 = static_cast<int32_t>(expected[k].samples.size());
+      EXPECT_LE(std::abs(n1 - n2), 2 * kWindowShift)
+          << "stream " << i << ", segment " << k;
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,153 @@
+// sherpa-onnx/csrc/multi-stream-vad.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/multi-stream-vad.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+VadStream::VadStream(const MultiStreamVad *vad, int32_t buffer_size)
+    : vad_(vad),
+      state_(vad->model_->StateSize()),
+      segmenter_(buffer_size, vad->window_size_, vad->min_speech_samples_) {}
+
+void VadStream::AcceptWaveform(const float *samples, int32_t n) {
+  if (offset_ > 0) {
+    // Only less than one window of samples is left here
+    samples_.erase(samples_.begin(), samples_.begin() + offset_);
+    offset_ = 0;
+  }
+
+  samples_.insert(samples_.end(), samples, samples + n);
+}
+
+void VadStream::Reset() {
+  std::fill(state_.begin(), state_.end(), 0);
+  trigger_.Reset();
+  segmenter_.Reset();
+  samples_.clear();
+  offset_ = 0;
+}
+
+int32_t VadStream::NumPendingWindows() const {
+  int32_t n = static_cast<int32_t>(samples_.size()) - offset_;
+  if (n < vad_->window_size_) {
+    return 0;
+  }
+
+  return (n - vad_->window_size_) / vad_->window_shift_ + 1;
+}
+
+void VadStream::AcceptProb(float prob) {
+  int32_t min_silence_samples = vad_->min_silence_samples_;
+  float threshold = vad_->config_.silero_vad.threshold;
+
+  if (segmenter_.BufferSize() > vad_->max_utterance_length_) {
+    min_silence_samples = vad_->new_min_silence_samples_;
+    threshold = vad_->new_threshold_;
+  }
+
+  segmenter_.Push(Window(), vad_->window_shift_);
+
+  bool is_speech =
+      trigger_.Update(prob, threshold, vad_->window_shift_,
+                      vad_->min_speech_samples_, min_silence_samples);
+
+  segmenter_.Update(is_speech, min_silence_samples);
+
+  offset_ += vad_->window_shift_;
+}
+
+MultiStreamVad::MultiStreamVad(const VadModelConfig &config,
+                               int32_t max_batch_size /*= 256*/)
+    : config_(config), max_batch_size_(std::max(max_batch_size, 1)) {
+  if (config.provider == "rknn") {
+    SHERPA_ONNX_LOGE("MultiStreamVad does not support rknn");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  model_ = std::make_unique<SileroVadModel>(config);
+
+  window_size_ = model_->WindowSize();
+  window_shift_ = model_->WindowShift();
+  min_speech_samples_ = model_->MinSpeechDurationSamples();
+  min_silence_samples_ = model_->MinSilenceDurationSamples();
+
+  // The same values as VoiceActivityDetector
+  max_utterance_length_ =
+      config_.sample_rate * config_.silero_vad.max_speech_duration;
+  new_min_silence_samples_ = config_.sample_rate * 0.1;
+}
+
+MultiStreamVad::~MultiStreamVad() = default;
+
+std::unique_ptr<VadStream> MultiStreamVad::CreateStream(
+    float buffer_size_in_seconds /*= 60*/) const {
+  int32_t buffer_size = buffer_size_in_seconds * config_.sample_rate;
+
+  // private constructor; cannot use std::make_unique
+  return std::unique_ptr<VadStream>(new VadStream(this, buffer_size));
+}
+
+bool MultiStreamVad::IsReady(const VadStream *s) const {
+  return s->NumPendingWindows() > 0;
+}
+
+int32_t MultiStreamVad::Process(VadStream **ss, int32_t n) const {
+  std::vector<VadStream *> ready;
+  ready.reserve(n);
+
+  std::vector<float> batch;
+  std::vector<float *> states;
+  std::vector<float> probs;
+
+  int32_t num_runs = 0;
+
+  // Each iteration processes one window of every stream that is ready.
+  // Streams that received more than one window are visited again.
+  while (true) {
+    ready.clear();
+    for (int32_t i = 0; i != n; ++i) {
+      if (IsReady(ss[i])) {
+        ready.push_back(ss[i]);
+      }
+    }
+
+    if (ready.empty()) {
+      break;
+    }
+
+    int32_t num_ready = static_cast<int32_t>(ready.size());
+    for (int32_t start = 0; start < num_ready; start += max_batch_size_) {
+      int32_t batch_size = std::min(max_batch_size_, num_ready - start);
+
+      batch.resize(batch_size * window_size_);
+      states.resize(batch_size);
+      probs.resize(batch_size);
+
+      for (int32_t b = 0; b != batch_size; ++b) {
+        VadStream *s = ready[start + b];
+        std::copy(s->Window(), s->Window() + window_size_,
+                  batch.data() + b * window_size_);
+        states[b] = s->state_.data();
+      }
+
+      model_->RunBatch(batch.data(), batch_size, states.data(), probs.data());
+      ++num_runs;
+
+      for (int32_t b = 0; b != batch_size; ++b) {
+        ready[start + b]->AcceptProb(probs[b]);
+      }
+    }
+  }
+
+  return num_runs;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,146 @@
+// sherpa-onnx/csrc/multi-stream-vad.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_MULTI_STREAM_VAD_H_
+#define SHERPA_ONNX_CSRC_MULTI_STREAM_VAD_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sherpa-onnx/csrc/silero-vad-model.h"
+#include "sherpa-onnx/csrc/vad-model-config.h"
+#include "sherpa-onnx/csrc/vad-segmenter.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+
+namespace sherpa_onnx {
+
+class MultiStreamVad;
+
+// VAD state of a single audio stream, e.g., one telephone channel.
+// Create it with MultiStreamVad::CreateStream().
+//
+// The methods for segments behave like those of VoiceActivityDetector.
+class VadStream {
+ public:
+  // Samples are buffered until MultiStreamVad::Process() is called.
+  void AcceptWaveform(const float *samples, int32_t n);
+
+  bool Empty() const { return segmenter_.Empty(); }
+  void Pop() { segmenter_.Pop(); }
+  void Clear() { segmenter_.Clear(); }
+  const SpeechSegment &Front() const { return segmenter_.Front(); }
+
+  bool IsSpeechDetected() const { return segmenter_.IsSpeechDetected(); }
+
+  void Reset();
+
+  // At the end of the stream, call MultiStreamVad::Process() and then this
+  // method so that the last speech segment can be detected.
+  void Flush() { segmenter_.Flush(); }
+
+  // Number of complete windows waiting to be processed
+  int32_t NumPendingWindows() const;
+
+ private:
+  friend class MultiStreamVad;
+
+  VadStream(const MultiStreamVad *vad, int32_t buffer_size);
+
+  // Pointer to the current window
+  const float *Window() const { return samples_.data() + offset_; }
+
+  // Consume the current window given its speech probability
+  void AcceptProb(float prob);
+
+ private:
+  const MultiStreamVad *vad_;
+
+  std::vector<float> state_;
+  SileroVadTrigger trigger_;
+  VadSegmenter segmenter_;
+
+  // Samples that have not been processed start at samples_[offset_]
+  std::vector<float> samples_;
+  int32_t offset_ = 0;
+};
+
+/** Run VAD on many streams with batched model invocations.
+
+    Each call of Process() stacks one window from every stream that has
+    enough samples, together with their model states, into a single run
+    of the model and dispatches the results back to the streams. This
+    replaces thousands of tiny runs per second with a few large ones.
+
+    Usage:
+
+      MultiStreamVad vad(config);
+      std::vector<std::unique_ptr<VadStream>> streams;
+      for (int32_t i = 0; i != num_channels; ++i) {
+        streams.push_back(vad.CreateStream());
+      }
+
+      // every 20 ms
+      for (each channel i) streams[i]->AcceptWaveform(samples, n);
+      vad.Process(ptrs.data(), ptrs.size());
+      for (each channel i) {
+        while (!streams[i]->Empty()) { ...; streams[i]->Pop(); }
+      }
+
+    Process() can be called from several threads with disjoint sets of
+    streams. Only silero VAD is supported.
+
+    The segmenter of a stream is updated after every window. This gives
+    the same segments as VoiceActivityDetector when each call of its
+    AcceptWaveform() passes one window_shift of samples. When a call
+    passes several windows, VoiceActivityDetector updates its segmenter
+    only once for all of them, so its segment boundaries can differ by up
+    to the number of samples in a call.
+ */
+class MultiStreamVad {
+ public:
+  // @param max_batch_size Maximum number of windows in one model run.
+  explicit MultiStreamVad(const VadModelConfig &config,
+                          int32_t max_batch_size = 256);
+
+  ~MultiStreamVad();
+
+  // @param buffer_size_in_seconds Size of the audio buffer of the stream.
+  //        A segment longer than it cannot be returned. Use a small value
+  //        when there are many streams to save memory.
+  std::unique_ptr<VadStream> CreateStream(
+      float buffer_size_in_seconds = 60) const;
+
+  // Return true if the stream has at least one complete window
+  bool IsReady(const VadStream *s) const;
+
+  // Process all complete windows of the given streams.
+  //
+  // @return Return the number of model runs.
+  int32_t Process(VadStream **ss, int32_t n) const;
+
+  const VadModelConfig &GetConfig() const { return config_; }
+
+ private:
+  friend class VadStream;
+
+  VadModelConfig config_;
+  std::unique_ptr<SileroVadModel> model_;
+  int32_t max_batch_size_;
+
+  int32_t window_size_;
+  int32_t window_shift_;
+  int32_t min_speech_samples_;
+  int32_t min_silence_samples_;
+
+  // If a stream has more than this number of samples in its buffer,
+  // a smaller min silence duration and a larger threshold are used.
+  // See also VoiceActivityDetector
+  int32_t max_utterance_length_;
+  int32_t new_min_silence_samples_;
+  float new_threshold_ = 0.90;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_MULTI_STREAM_VAD_H_
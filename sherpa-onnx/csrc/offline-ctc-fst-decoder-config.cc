@@ -17,7 +17,9 @@ std::string OfflineCtcFstDecoderConfig::ToString() const {
 
   os << "OfflineCtcFstDecoderConfig(";
   os << "graph=\"" << graph << "\", ";
-  os << "max_active=" << max_active << ")";
+  os << "max_active=" << max_active << ", ";
+  os << "num_threads=" << num_threads << ", ";
+  os << "use_mmap=" << (use_mmap ? "True" : "False") << ")";
 
   return os.str();
 }
@@ -30,6 +32,15 @@ void OfflineCtcFstDecoderConfig::Register(ParseOptions *po) {
 
   p.Register("max-active", &max_active,
              "Decoder max active states.  Larger->slower; more accurate");
+
+  p.Register("decoding-threads", &num_threads,
+             "Number of threads to decode utterances of a batch with the "
+             "graph in parallel");
+
+  p.Register("mmap-graph", &use_mmap,
+             "true to memory map the graph instead of reading it into "
+             "memory. Pages are shared by processes using the same graph. "
+             "The graph must be an aligned const FST");
 }
 
 bool OfflineCtcFstDecoderConfig::Validate() const {
@@ -37,6 +48,13 @@ bool OfflineCtcFstDecoderConfig::Validate() const {
     SHERPA_ONNX_LOGE("graph: '%s' does not exist", graph.c_str());
     return false;
   }
+
+  if (num_threads < 1) {
+    SHERPA_ONNX_LOGE("--ctc.decoding-threads should be >= 1. Given: %d",
+                     num_threads);
+    return false;
+  }
+
   return true;
 }
 
@@ -16,10 +16,21 @@ struct OfflineCtcFstDecoderConfig {
   std::string graph;
   int32_t max_active = 3000;
 
+  // Number of threads to decode utterances of a batch in parallel
+  int32_t num_threads = 1;
+
+  // true to memory map the graph. It requires an aligned const FST, e.g.,
+  //  fstconvert --fst_type=const --fst_align HLG.fst HLG.const.fst
+  bool use_mmap = false;
+
   OfflineCtcFstDecoderConfig() = default;
 
-  OfflineCtcFstDecoderConfig(const std::string &graph, int32_t max_active)
-      : graph(graph), max_active(max_active) {}
+  OfflineCtcFstDecoderConfig(const std::string &graph, int32_t max_active,
+                             int32_t num_threads = 1, bool use_mmap = false)
+      : graph(graph),
+        max_active(max_active),
+        num_threads(num_threads),
+        use_mmap(use_mmap) {}
 
   std::string ToString() const;
 
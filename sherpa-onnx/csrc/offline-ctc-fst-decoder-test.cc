@@ -0,0 +1,132 @@
+// sherpa-onnx/csrc/offline-ctc-fst-decoder-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-ctc-fst-decoder.h"
+
+#include <stdio.h>
+
+#include <array>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fst/fstlib.h"
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/fst-utils.h"
+
+namespace sherpa_onnx {
+
+static constexpr int32_t kVocabSize = 100;
+
+// A graph with num_states states, where each state has an arc for every
+// token to a pseudo random state. Input labels are token IDs plus 1.
+static void WriteGraph(const std::string &filename, int32_t num_states) {
+  std::mt19937 gen(20250107);
+  std::uniform_real_distribution<float> dist(0, 5);
+
+  fst::StdVectorFst g;
+  for (int32_t s = 0; s != num_states; ++s) {
+    g.AddState();
+  }
+  g.SetStart(0);
+
+  for (int32_t s = 0; s != num_states; ++s) {
+    g.SetFinal(s, fst::TropicalWeight::One());
+
+    for (int32_t k = 1; k <= kVocabSize; ++k) {
+      int32_t next = k == 1 ? s : (s * 31 + k * 17) % num_states;
+      int32_t olabel = k == 1 ? 0 : k;
+      g.AddArc(s, fst::StdArc(k, olabel, dist(gen), next));
+    }
+  }
+
+  // Arrays of an aligned const FST can be memory mapped
+  fst::StdConstFst c(g);
+  fst::FstWriteOptions opts(filename);
+  opts.align = true;
+
+  std::ofstream os(filename, std::ios::binary);
+  c.Write(os, opts);
+}
+
+static std::vector<float> GenerateLogProbs(int32_t batch_size, int32_t T) {
+  std::mt19937 gen(20250108);
+  std::uniform_real_distribution<float> dist(-10, 0);
+
+  std::vector<float> ans(batch_size * T * kVocabSize);
+  for (auto &f : ans) {
+    f = dist(gen);
+  }
+  return ans;
+}
+
+static std::vector<OfflineCtcDecoderResult> Decode(
+    OfflineCtcFstDecoder *decoder, std::vector<float> *log_probs,
+    std::vector<int64_t> *lengths, int32_t T) {
+  auto memory_info =
+      Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  std::array<int64_t, 3> shape{static_cast<int64_t>(lengths->size()), T,
+                               kVocabSize};
+  Ort::Value x = Ort::Value::CreateTensor(memory_info, log_probs->data(),
+                                          log_probs->size(), shape.data(),
+                                          shape.size());
+
+  std::array<int64_t, 1> length_shape{static_cast<int64_t>(lengths->size())};
+  Ort::Value x_lens =
+      Ort::Value::CreateTensor(memory_info, lengths->data(), lengths->size(),
+                               length_shape.data(), length_shape.size());
+
+  return decoder->Decode(std::move(x), std::move(x_lens));
+}
+
+TEST(OfflineCtcFstDecoder, Parallel) {
+  std::string filename = "offline-ctc-fst-decoder-test.fst";
+  WriteGraph(filename, 500);
+
+  int32_t batch_size = 8;
+  int32_t T = 100;
+
+  auto log_probs = GenerateLogProbs(batch_size, T);
+
+  std::vector<int64_t> lengths(batch_size);
+  for (int32_t i = 0; i != batch_size; ++i) {
+    lengths[i] = T - i * 7;
+  }
+
+  OfflineCtcFstDecoderConfig config(filename, 3000);
+  OfflineCtcFstDecoder serial(config);
+  auto expected = Decode(&serial, &log_probs, &lengths, T);
+
+  for (bool use_mmap : {false, true}) {
+    for (int32_t num_threads : {1, 3}) {
+      config.num_threads = num_threads;
+      config.use_mmap = use_mmap;
+      OfflineCtcFstDecoder decoder(config);
+
+      // Call it twice so that decoders from the pool are reused
+      auto results = Decode(&decoder, &log_probs, &lengths, T);
+      results = Decode(&decoder, &log_probs, &lengths, T);
+
+      ASSERT_EQ(results.size(), expected.size());
+      for (int32_t i = 0; i != batch_size; ++i) {
+        EXPECT_EQ(results[i].tokens, expected[i].tokens) << i;
+        EXPECT_EQ(results[i].words, expected[i].words) << i;
+        EXPECT_EQ(results[i].timestamps, expected[i].timestamps) << i;
+      }
+    }
+  }
+
+  // Graphs read with the same options are shared
+  auto g1 = ReadSharedGraph(filename, true);
+  auto g2 = ReadSharedGraph(filename, true);
+  EXPECT_EQ(g1.get(), g2.get());
+  EXPECT_NE(g1.get(), ReadSharedGraph(filename, false).get());
+
+  remove(filename.c_str());
+}
+
+}  // namespace sherpa_onnx
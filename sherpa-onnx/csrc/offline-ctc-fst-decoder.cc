@@ -4,7 +4,10 @@
 
 #include "sherpa-onnx/csrc/offline-ctc-fst-decoder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "fst/fstlib.h"
@@ -80,7 +83,34 @@ static OfflineCtcDecoderResult DecodeOne(kaldi_decoder::FasterDecoder *decoder,
 
 OfflineCtcFstDecoder::OfflineCtcFstDecoder(
     const OfflineCtcFstDecoderConfig &config)
-    : config_(config), fst_(ReadGraph(config_.graph)) {}
+    : config_(config), fst_(ReadSharedGraph(config_.graph, config_.use_mmap)) {
+  if (!fst_) {
+    SHERPA_ONNX_LOGE("Failed to read '%s'", config_.graph.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  options_.max_active = config_.max_active;
+}
+
+std::unique_ptr<kaldi_decoder::FasterDecoder>
+OfflineCtcFstDecoder::AcquireDecoder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!decoders_.empty()) {
+      auto decoder = std::move(decoders_.back());
+      decoders_.pop_back();
+      return decoder;
+    }
+  }
+
+  return std::make_unique<kaldi_decoder::FasterDecoder>(*fst_, options_);
+}
+
+void OfflineCtcFstDecoder::ReleaseDecoder(
+    std::unique_ptr<kaldi_decoder::FasterDecoder> decoder) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  decoders_.push_back(std::move(decoder));
+}
 
 std::vector<OfflineCtcDecoderResult> OfflineCtcFstDecoder::Decode(
     Ort::Value log_probs, Ort::Value log_probs_length) {
@@ -97,20 +127,39 @@ std::vector<OfflineCtcDecoderResult> OfflineCtcFstDecoder::Decode(
 
   assert(shape[0] == length_shape[0]);
 
-  kaldi_decoder::FasterDecoderOptions opts;
-  opts.max_active = config_.max_active;
-  kaldi_decoder::FasterDecoder faster_decoder(*fst_, opts);
-
   const float *start = log_probs.GetTensorData<float>();
+  const int64_t *num_frames = log_probs_length.GetTensorData<int64_t>();
+
+  std::vector<OfflineCtcDecoderResult> ans(batch_size);
+
+  // Utterances are taken in order by whichever thread is free, so a long
+  // utterance does not hold back the others
+  std::atomic<int32_t> next{0};
+
+  auto worker = [&]() {
+    auto decoder = AcquireDecoder();
+
+    for (int32_t i = next++; i < batch_size; i = next++) {
+      const float *p = start + static_cast<int64_t>(i) * T * vocab_size;
+      ans[i] = DecodeOne(decoder.get(), p, num_frames[i], vocab_size);
+    }
+
+    ReleaseDecoder(std::move(decoder));
+  };
+
+  int32_t num_threads = std::min(config_.num_threads, batch_size);
+
+  std::vector<std::thread> threads;
+  threads.reserve(std::max(num_threads - 1, 0));
+  for (int32_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
 
-  std::vector<OfflineCtcDecoderResult> ans;
-  ans.reserve(batch_size);
+  // The calling thread is also a worker
+  worker();
 
-  for (int32_t i = 0; i != batch_size; ++i) {
-    const float *p = start + i * T * vocab_size;
-    int32_t num_frames = log_probs_length.GetTensorData<int64_t>()[i];
-    auto r = DecodeOne(&faster_decoder, p, num_frames, vocab_size);
-    ans.push_back(std::move(r));
+  for (auto &t : threads) {
+    t.join();
   }
 
   return ans;
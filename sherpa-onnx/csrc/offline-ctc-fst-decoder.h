@@ -6,15 +6,23 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_CTC_FST_DECODER_H_
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 
 #include "fst/fst.h"
+#include "kaldi-decoder/csrc/faster-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-fst-decoder-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 
 namespace sherpa_onnx {
 
+// Utterances of a batch are decoded in parallel with up to
+// config.num_threads threads. Each thread uses a FasterDecoder from a
+// pool so that decoders are reused across calls of Decode(). All
+// decoders share the same read-only graph.
+//
+// Decode() is thread-safe.
 class OfflineCtcFstDecoder : public OfflineCtcDecoder {
  public:
   explicit OfflineCtcFstDecoder(const OfflineCtcFstDecoderConfig &config);
@@ -22,10 +30,21 @@ class OfflineCtcFstDecoder : public OfflineCtcDecoder {
   std::vector<OfflineCtcDecoderResult> Decode(
       Ort::Value log_probs, Ort::Value log_probs_length) override;
 
+ private:
+  // Take a decoder from the pool. A new one is created if the pool is empty.
+  std::unique_ptr<kaldi_decoder::FasterDecoder> AcquireDecoder();
+
+  // Return a decoder to the pool
+  void ReleaseDecoder(std::unique_ptr<kaldi_decoder::FasterDecoder> decoder);
+
  private:
   OfflineCtcFstDecoderConfig config_;
+  kaldi_decoder::FasterDecoderOptions options_;
+
+  std::shared_ptr<const fst::Fst<fst::StdArc>> fst_;
 
-  std::unique_ptr<fst::Fst<fst::StdArc>> fst_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<kaldi_decoder::FasterDecoder>> decoders_;
 };
 
 }  // namespace sherpa_onnx
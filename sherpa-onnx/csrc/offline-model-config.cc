@@ -53,6 +53,8 @@ void OfflineModelConfig::Register(ParseOptions *po) {
                "the log probability, you can get it from the directory where "
                "your bpe model is generated. Only used when hotwords provided "
                "and the modeling unit is bpe or cjkchar+bpe");
+
+  session_config.Register(po);
 }
 
 bool OfflineModelConfig::Validate() const {
@@ -66,6 +68,10 @@ bool OfflineModelConfig::Validate() const {
     return false;
   }
 
+  if (!session_config.Validate()) {
+    return false;
+  }
+
   if (!modeling_unit.empty() &&
       (modeling_unit == "bpe" || modeling_unit == "cjkchar+bpe")) {
     if (!FileExists(bpe_vocab)) {
@@ -149,7 +155,8 @@ std::string OfflineModelConfig::ToString() const {
   os << "provider=\"" << provider << "\", ";
   os << "model_type=\"" << model_type << "\", ";
   os << "modeling_unit=\"" << modeling_unit << "\", ";
-  os << "bpe_vocab=\"" << bpe_vocab << "\")";
+  os << "bpe_vocab=\"" << bpe_vocab << "\", ";
+  os << "session_config=" << session_config.ToString() << ")";
 
   return os.str();
 }
@@ -6,6 +6,9 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <memory>
 #include <string>
 #include <utility>
@@ -42,116 +45,306 @@ class OfflinePunctuationCtTransformerImpl : public OfflinePunctuationImpl {
       return {};
     }
 
-    std::vector<std::string> tokens = SplitUtf8(text);
+    return AddPunctuationBatch({text})[0];
+  }
+
+  std::vector<std::string> AddPunctuationBatch(
+      const std::vector<std::string> &texts) const override {
+    std::vector<std::string> ans(texts.size());
+
+    // Texts that are being processed. A text leaves the batch once all of
+    // its segments are processed and the next pending text takes its place.
+    std::vector<TextState> active;
+    active.reserve(kMaxBatchSize);
+
+    int32_t next = 0;
+    int32_t num_texts = static_cast<int32_t>(texts.size());
+
+    while (true) {
+      while (static_cast<int32_t>(active.size()) < kMaxBatchSize &&
+             next < num_texts) {
+        if (!texts[next].empty()) {
+          active.push_back(CreateTextState(texts[next], next));
+        }
+        ++next;
+      }
+
+      if (active.empty()) {
+        break;
+      }
+
+      RunOneStep(&active);
+
+      auto it = active.begin();
+      while (it != active.end()) {
+        if (it->done) {
+          ans[it->index] = Finalize(&(*it));
+          it = active.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    return ans;
+  }
+
+  // Maximum number of padded positions per segment in a model run
+  static constexpr int32_t kMaxPadding = 10;
+
+  // Group segments so that each group can be run in a single model run.
+  // Within a group, the longest segment is at most kMaxPadding tokens
+  // longer than the shortest one. Segments carry over the tokens after
+  // the last full stop, so their lengths vary from step to step.
+  //
+  // @param lengths lengths[i] is the number of tokens of segment i
+  // @return Return groups of indexes into lengths. Indexes in a group
+  //         are in ascending order of length.
+  static std::vector<std::vector<int32_t>> GroupSegments(
+      const std::vector<int32_t> &lengths) {
+    std::vector<int32_t> order(lengths.size());
+    for (int32_t i = 0; i != static_cast<int32_t>(order.size()); ++i) {
+      order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(),
+                     [&lengths](int32_t a, int32_t b) {
+                       return lengths[a] < lengths[b];
+                     });
+
+    std::vector<std::vector<int32_t>> ans;
+    int32_t min_len = 0;
+    for (int32_t i : order) {
+      if (ans.empty() || lengths[i] > min_len + kMaxPadding) {
+        ans.emplace_back();
+        min_len = lengths[i];
+      }
+      ans.back().push_back(i);
+    }
+
+    return ans;
+  }
+
+ private:
+  // Maximum number of texts in a batch
+  static constexpr int32_t kMaxBatchSize = 32;
+
+  static constexpr int32_t kSegmentSize = 20;
+  static constexpr int32_t kMaxLen = 200;
+
+  struct TextState {
+    // index into the input texts
+    int32_t index = 0;
+
+    std::string text;
+    std::vector<std::string> tokens;
     std::vector<int32_t> token_ids;
-    token_ids.reserve(tokens.size());
+
+    int32_t num_segments = 0;
+
+    // index of the segment to process next
+    int32_t i = 0;
+
+    // start of the carry-over tokens. -1 means no carry-over
+    int32_t last = -1;
+
+    // [start, end) of the segment in the current step
+    int32_t start = 0;
+    int32_t end = 0;
+
+    std::vector<int32_t> punctuations;
+
+    bool done = false;
+  };
+
+  TextState CreateTextState(const std::string &text, int32_t index) const {
+    TextState s;
+    s.index = index;
+    s.text = text;
+    s.tokens = SplitUtf8(text);
+    s.token_ids.reserve(s.tokens.size());
 
     const auto &meta_data = model_.GetModelMetadata();
 
-    for (const auto &t : tokens) {
+    for (const auto &t : s.tokens) {
       std::string token = ToLowerCase(t);
       if (meta_data.token2id.count(token)) {
-        token_ids.push_back(meta_data.token2id.at(token));
+        s.token_ids.push_back(meta_data.token2id.at(token));
       } else {
-        token_ids.push_back(meta_data.unk_id);
+        s.token_ids.push_back(meta_data.unk_id);
       }
     }
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    s.num_segments =
+        ceil((static_cast<float>(s.token_ids.size()) + kSegmentSize - 1) /
+             kSegmentSize);
 
-    int32_t segment_size = 20;
-    int32_t max_len = 200;
-    int32_t num_segments =
-        ceil((static_cast<float>(token_ids.size()) + segment_size - 1) /
-             segment_size);
+    s.done = s.token_ids.empty();
 
-    std::vector<int32_t> punctuations;
-    int32_t last = -1;
-    for (int32_t i = 0; i != num_segments; ++i) {
-      int32_t this_start = i * segment_size;         // included
-      int32_t this_end = this_start + segment_size;  // not included
-      if (this_end > static_cast<int32_t>(token_ids.size())) {
-        this_end = token_ids.size();
+    return s;
+  }
+
+  // Run the model with the next segment of each text in the batch.
+  //
+  // Segments are grouped by GroupSegments() and each group is run once,
+  // padded to its longest segment. The model masks the padded positions
+  // with x_len, so the result of a text does not depend on the other texts.
+  void RunOneStep(std::vector<TextState> *states) const {
+    std::vector<int32_t> indexes;
+    std::vector<int32_t> lengths;
+
+    for (int32_t b = 0; b != static_cast<int32_t>(states->size()); ++b) {
+      auto &s = (*states)[b];
+      s.start = s.i * kSegmentSize;     // included
+      s.end = s.start + kSegmentSize;  // not included
+      if (s.end > static_cast<int32_t>(s.token_ids.size())) {
+        s.end = s.token_ids.size();
+      }
+
+      if (s.last != -1) {
+        s.start = s.last;
       }
+      // token_ids[start:end] is sent to the model
 
-      if (last != -1) {
-        this_start = last;
+      if (s.end - s.start <= 0) {
+        s.done = true;
+        continue;
       }
-      // token_ids[this_start:this_end] is sent to the model
 
-      std::array<int64_t, 2> x_shape = {1, this_end - this_start};
-      Ort::Value x =
-          Ort::Value::CreateTensor(memory_info, token_ids.data() + this_start,
-                                   x_shape[1], x_shape.data(), x_shape.size());
+      indexes.push_back(b);
+      lengths.push_back(s.end - s.start);
+    }
+
+    for (auto &g : GroupSegments(lengths)) {
+      for (auto &i : g) {
+        i = indexes[i];
+      }
+      RunSegments(states, g);
+    }
+  }
+
+  // Run the model once with the current segments of the given states.
+  // Shorter segments are padded with 0.
+  void RunSegments(std::vector<TextState> *states,
+                   const std::vector<int32_t> &indexes) const {
+    const auto &meta_data = model_.GetModelMetadata();
+
+    int32_t batch_size = static_cast<int32_t>(indexes.size());
 
-      int64_t len_shape = 1;
-      int32_t len = x_shape[1];
-      Ort::Value x_len =
-          Ort::Value::CreateTensor(memory_info, &len, 1, &len_shape, 1);
+    int32_t max_len = 0;
+    for (int32_t i : indexes) {
+      const auto &s = (*states)[i];
+      max_len = std::max(max_len, s.end - s.start);
+    }
 
-      Ort::Value out = model_.Forward(std::move(x), std::move(x_len));
+    std::vector<int32_t> x(batch_size * max_len, 0);
+    std::vector<int32_t> x_len(batch_size);
 
-      // [N, T, num_punctuations]
-      std::vector<int64_t> out_shape =
-          out.GetTensorTypeAndShapeInfo().GetShape();
+    for (int32_t b = 0; b != batch_size; ++b) {
+      const auto &s = (*states)[indexes[b]];
+      std::copy(s.token_ids.begin() + s.start, s.token_ids.begin() + s.end,
+                x.begin() + b * max_len);
+      x_len[b] = s.end - s.start;
+    }
 
-      assert(out_shape[0] == 1);
-      assert(out_shape[1] == len);
-      assert(out_shape[2] == meta_data.num_punctuations);
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-      std::vector<int32_t> this_punctuations;
-      this_punctuations.reserve(len);
+    std::array<int64_t, 2> x_shape = {batch_size, max_len};
+    Ort::Value x_tensor = Ort::Value::CreateTensor(
+        memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
-      const float *p = out.GetTensorData<float>();
-      for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations) {
-        auto index = static_cast<int32_t>(std::distance(
-            p, std::max_element(p, p + meta_data.num_punctuations)));
-        this_punctuations.push_back(index);
-      }  // for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations)
+    int64_t len_shape = batch_size;
+    Ort::Value x_len_tensor = Ort::Value::CreateTensor(
+        memory_info, x_len.data(), x_len.size(), &len_shape, 1);
 
-      int32_t dot_index = -1;
-      int32_t comma_index = -1;
+    Ort::Value out =
+        model_.Forward(std::move(x_tensor), std::move(x_len_tensor));
 
-      for (int32_t m = static_cast<int32_t>(this_punctuations.size()) - 2;
-           m >= 1; --m) {
-        int32_t punct_id = this_punctuations[m];
+    // [N, T, num_punctuations]
+    std::vector<int64_t> out_shape = out.GetTensorTypeAndShapeInfo().GetShape();
 
-        if (punct_id == meta_data.dot_id || punct_id == meta_data.quest_id) {
-          dot_index = m;
-          break;
-        }
+    assert(out_shape[0] == batch_size);
+    assert(out_shape[1] == max_len);
+    assert(out_shape[2] == meta_data.num_punctuations);
 
-        if (comma_index == -1 && punct_id == meta_data.comma_id) {
-          comma_index = m;
-        }
-      }  // for (int32_t k = this_punctuations.size() - 1; k >= 1; --k)
+    const float *p_out = out.GetTensorData<float>();
 
-      if (dot_index == -1 && len >= max_len && comma_index != -1) {
-        dot_index = comma_index;
-        this_punctuations[dot_index] = meta_data.dot_id;
+    for (int32_t b = 0; b != batch_size; ++b) {
+      auto &s = (*states)[indexes[b]];
+      const float *p = p_out + b * out_shape[1] * out_shape[2];
+
+      ProcessSegmentOutput(p, x_len[b], &s);
+
+      s.i += 1;
+      if (s.i >= s.num_segments) {
+        s.done = true;
       }
+    }
+  }
 
-      if (dot_index == -1) {
-        if (last == -1) {
-          last = this_start;
-        }
+  // @param p Pointer to the model output of this text in the current step.
+  //          It is of shape (len, num_punctuations).
+  void ProcessSegmentOutput(const float *p, int32_t len, TextState *s) const {
+    const auto &meta_data = model_.GetModelMetadata();
 
-        if (i == num_segments - 1) {
-          dot_index = static_cast<int32_t>(this_punctuations.size()) - 1;
-        }
-      } else {
-        last = this_start + dot_index + 1;
+    std::vector<int32_t> this_punctuations;
+    this_punctuations.reserve(len);
+
+    for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations) {
+      auto index = static_cast<int32_t>(std::distance(
+          p, std::max_element(p, p + meta_data.num_punctuations)));
+      this_punctuations.push_back(index);
+    }  // for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations)
+
+    int32_t dot_index = -1;
+    int32_t comma_index = -1;
+
+    for (int32_t m = static_cast<int32_t>(this_punctuations.size()) - 2;
+         m >= 1; --m) {
+      int32_t punct_id = this_punctuations[m];
+
+      if (punct_id == meta_data.dot_id || punct_id == meta_data.quest_id) {
+        dot_index = m;
+        break;
+      }
+
+      if (comma_index == -1 && punct_id == meta_data.comma_id) {
+        comma_index = m;
+      }
+    }  // for (int32_t k = this_punctuations.size() - 1; k >= 1; --k)
+
+    if (dot_index == -1 && len >= kMaxLen && comma_index != -1) {
+      dot_index = comma_index;
+      this_punctuations[dot_index] = meta_data.dot_id;
+    }
+
+    if (dot_index == -1) {
+      if (s->last == -1) {
+        s->last = s->start;
       }
 
-      if (dot_index != -1) {
-        punctuations.insert(punctuations.end(), this_punctuations.begin(),
-                            this_punctuations.begin() + (dot_index + 1));
+      if (s->i == s->num_segments - 1) {
+        dot_index = static_cast<int32_t>(this_punctuations.size()) - 1;
       }
-    }  // for (int32_t i = 0; i != num_segments; ++i)
+    } else {
+      s->last = s->start + dot_index + 1;
+    }
+
+    if (dot_index != -1) {
+      s->punctuations.insert(s->punctuations.end(), this_punctuations.begin(),
+                             this_punctuations.begin() + (dot_index + 1));
+    }
+  }
+
+  std::string Finalize(TextState *s) const {
+    const auto &meta_data = model_.GetModelMetadata();
+
+    const auto &punctuations = s->punctuations;
+    auto &tokens = s->tokens;
 
     if (punctuations.empty()) {
-      return text + meta_data.id2punct[meta_data.dot_id];
+      return s->text + meta_data.id2punct[meta_data.dot_id];
     }
     std::vector<std::string> words_punct;
 
@@ -187,7 +380,6 @@ class OfflinePunctuationCtTransformerImpl : public OfflinePunctuationImpl {
     return ans;
   }
 
- private:
   OfflinePunctuationConfig config_;
   OfflineCtTransformerModel model_;
 };
@@ -24,6 +24,18 @@ std::unique_ptr<OfflinePunctuationImpl> OfflinePunctuationImpl::Create(
   return nullptr;
 }
 
+std::vector<std::string> OfflinePunctuationImpl::AddPunctuationBatch(
+    const std::vector<std::string> &texts) const {
+  std::vector<std::string> ans;
+  ans.reserve(texts.size());
+
+  for (const auto &text : texts) {
+    ans.push_back(AddPunctuation(text));
+  }
+
+  return ans;
+}
+
 #if __ANDROID_API__ >= 9
 std::unique_ptr<OfflinePunctuationImpl> OfflinePunctuationImpl::Create(
     AAssetManager *mgr, const OfflinePunctuationConfig &config) {
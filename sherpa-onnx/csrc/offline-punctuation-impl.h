@@ -29,6 +29,10 @@ class OfflinePunctuationImpl {
 #endif
 
   virtual std::string AddPunctuation(const std::string &text) const = 0;
+
+  // The default implementation processes the texts one by one.
+  virtual std::vector<std::string> AddPunctuationBatch(
+      const std::vector<std::string> &texts) const;
 };
 
 }  // namespace sherpa_onnx
@@ -0,0 +1,80 @@
+// sherpa-onnx/csrc/offline-punctuation-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-punctuation.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-punctuation-ct-transformer-impl.h"
+
+namespace sherpa_onnx {
+
+using CtTransformer = OfflinePunctuationCtTransformerImpl;
+
+TEST(OfflinePunctuation, GroupSegments) {
+  int32_t pad = CtTransformer::kMaxPadding;
+
+  std::vector<int32_t> lengths = {20, 20 + pad, 25, 3, 20 + pad + 1, 20};
+  auto groups = CtTransformer::GroupSegments(lengths);
+
+  // Segments of different lengths share a model run
+  std::vector<std::vector<int32_t>> expected = {{3}, {0, 5, 2, 1}, {4}};
+  EXPECT_EQ(groups, expected);
+
+  // All segments of a step are 20 tokens long if no text has a carry-over
+  lengths.assign(32, 20);
+  EXPECT_EQ(CtTransformer::GroupSegments(lengths).size(), 1u);
+
+  EXPECT_TRUE(CtTransformer::GroupSegments({}).empty());
+}
+
+// Please download the model from
+// https://github.com/k2-fsa/sherpa-onnx/releases/download/punctuation-models/sherpa-onnx-punct-ct-transformer-zh-en-vocab272727-2024-04-12.tar.bz2
+static const char *const kModel =
+    "./sherpa-onnx-punct-ct-transformer-zh-en-vocab272727-2024-04-12/"
+    "model.onnx";
+
+TEST(OfflinePunctuation, BatchMatchesSingle) {
+  if (!FileExists(kModel)) {
+    SHERPA_ONNX_LOGE("%s does not exist. Skipping test", kModel);
+    return;
+  }
+
+  OfflinePunctuationConfig config(
+      OfflinePunctuationModelConfig(kModel, 1, false, "cpu"));
+  OfflinePunctuation punct(config);
+
+  std::vector<std::string> sentences = {
+      "这是一个测试你好吗How are you我很好thank you are you ok谢谢你",
+      "我们都是木头人不会说话不会动",
+      "The African blogosphere is rapidly expanding bringing more voices "
+      "online in the form of commentaries opinions analyses rants and poetry",
+      "你好",
+      "",
+  };
+
+  // Texts of many lengths, so that segments with and without a carry-over
+  // are padded in the same model run
+  std::vector<std::string> texts;
+  for (int32_t i = 0; i != 40; ++i) {
+    std::string t;
+    for (int32_t k = 0; k <= i % 7; ++k) {
+      t += sentences[(i + k) % sentences.size()];
+    }
+    texts.push_back(t);
+  }
+
+  auto results = punct.AddPunctuationBatch(texts);
+  ASSERT_EQ(results.size(), texts.size());
+
+  for (size_t i = 0; i != texts.size(); ++i) {
+    EXPECT_EQ(results[i], punct.AddPunctuation(texts[i])) << texts[i];
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -48,6 +48,15 @@ class OfflinePunctuation {
   // Add punctuation to the input text and return it.
   std::string AddPunctuation(const std::string &text) const;
 
+  // Add punctuation to each of the input texts.
+  //
+  // Segments of similar length from different texts are padded and
+  // processed together in a single model run, so it is much faster than
+  // calling AddPunctuation() for each text. ans[i] is the same as
+  // AddPunctuation(texts[i]).
+  std::vector<std::string> AddPunctuationBatch(
+      const std::vector<std::string> &texts) const;
+
  private:
   std::unique_ptr<OfflinePunctuationImpl> impl_;
 };
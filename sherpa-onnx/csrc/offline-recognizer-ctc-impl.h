@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_CTC_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_CTC_IMPL_H_
 
+#include <array>
 #include <ios>
 #include <memory>
 #include <sstream>
@@ -17,8 +18,8 @@
 #include "sherpa-onnx/csrc/offline-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-model.h"
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
-#include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -199,44 +200,31 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
 
     int32_t feat_dim = config_.feat_config.feature_dim;
 
-    std::vector<Ort::Value> features;
-    features.reserve(n);
+    // Features are written directly into the padded input
+    std::vector<float> features;
+    std::vector<int64_t> features_length_vec;
+    int32_t max_num_frames = GetBatchFrames(
+        ss, n, -23.025850929940457f, &features, &features_length_vec);
 
-    std::vector<std::vector<float>> features_vec(n);
-    std::vector<int64_t> features_length_vec(n);
-
-    for (int32_t i = 0; i != n; ++i) {
-      std::vector<float> f = ss[i]->GetFrames();
-
-      int32_t num_frames = f.size() / feat_dim;
-
-      model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
-
-      features_vec[i] = std::move(f);
-
-      features_length_vec[i] = num_frames;
-
-      std::array<int64_t, 2> shape = {num_frames, feat_dim};
-
-      Ort::Value x = Ort::Value::CreateTensor(
-          memory_info, features_vec[i].data(), features_vec[i].size(),
-          shape.data(), shape.size());
-      features.push_back(std::move(x));
-    }  // for (int32_t i = 0; i != n; ++i)
-
-    std::vector<const Ort::Value *> features_pointer(n);
     for (int32_t i = 0; i != n; ++i) {
-      features_pointer[i] = &features[i];
+      model_->NormalizeFeatures(
+          features.data() + i * max_num_frames * feat_dim,
+          features_length_vec[i], feat_dim);
     }
 
+    std::array<int64_t, 3> shape = {n, max_num_frames, feat_dim};
+    Ort::Value x =
+        Ort::Value::CreateTensor(memory_info, features.data(), features.size(),
+                                 shape.data(), shape.size());
+
     std::array<int64_t, 1> features_length_shape = {n};
     Ort::Value x_length = Ort::Value::CreateTensor(
         memory_info, features_length_vec.data(), n,
         features_length_shape.data(), features_length_shape.size());
 
-    Ort::Value x = PadSequence(model_->Allocator(), features_pointer,
-                               -23.025850929940457f);
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto t = model_->Forward(std::move(x), std::move(x_length));
+    encoder_trace.Stop();
 
     auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
 
@@ -277,7 +265,9 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
         Ort::Value::CreateTensor(memory_info, &x_length_scalar, 1,
                                  x_length_shape.data(), x_length_shape.size());
 
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto t = model_->Forward(std::move(x), std::move(x_length));
+    encoder_trace.Stop();
     auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
     int32_t frame_shift_ms = 10;
 
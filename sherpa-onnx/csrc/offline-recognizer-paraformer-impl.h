@@ -19,6 +19,7 @@
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -179,7 +180,10 @@ class OfflineRecognizerParaformerImpl : public OfflineRecognizerImpl {
 
     std::vector<Ort::Value> t;
     try {
+      // It also runs the predictor and the decoder
+      ScopedTrace encoder_trace(TraceStage::kEncoder);
       t = model_->Forward(std::move(x), std::move(x_length));
+      encoder_trace.Stop();
     } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE("\n\nCaught exception:\n\n%s\n\nReturn an empty result",
                        ex.what());
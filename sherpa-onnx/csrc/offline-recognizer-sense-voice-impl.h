@@ -18,6 +18,7 @@
 #include "sherpa-onnx/csrc/offline-sense-voice-model.h"
 #include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -192,9 +193,11 @@ class OfflineRecognizerSenseVoiceImpl : public OfflineRecognizerImpl {
 
     Ort::Value logits{nullptr};
     try {
+      ScopedTrace encoder_trace(TraceStage::kEncoder);
       logits = model_->Forward(std::move(x), std::move(x_length),
                                std::move(language_tensor),
                                std::move(text_norm_tensor));
+      encoder_trace.Stop();
     } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE("\n\nCaught exception:\n\n%s\n\nReturn an empty result",
                        ex.what());
@@ -274,9 +277,11 @@ class OfflineRecognizerSenseVoiceImpl : public OfflineRecognizerImpl {
 
     Ort::Value logits{nullptr};
     try {
+      ScopedTrace encoder_trace(TraceStage::kEncoder);
       logits = model_->Forward(std::move(x), std::move(x_length),
                                std::move(language_tensor),
                                std::move(text_norm_tensor));
+      encoder_trace.Stop();
     } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE("\n\nCaught exception:\n\n%s\n\nReturn an empty result",
                        ex.what());
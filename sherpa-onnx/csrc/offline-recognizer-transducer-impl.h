@@ -5,10 +5,11 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <ios>
 #include <memory>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
@@ -23,8 +24,8 @@
 #include "sherpa-onnx/csrc/offline-transducer-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-transducer-model.h"
 #include "sherpa-onnx/csrc/offline-transducer-modified-beam-search-decoder.h"
-#include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/utils.h"
 #include "ssentencepiece/csrc/ssentencepiece.h"
 
@@ -150,7 +151,8 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
   std::unique_ptr<OfflineStream> CreateStream(
       const std::string &hotwords) const override {
-    auto hws = std::regex_replace(hotwords, std::regex("/"), "\n");
+    auto hws = hotwords;
+    std::replace(hws.begin(), hws.end(), '/', '\n');
     std::istringstream is(hws);
     std::vector<std::vector<int32_t>> current;
     std::vector<float> current_scores;
@@ -196,41 +198,25 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
     int32_t feat_dim = ss[0]->FeatureDim();
 
-    std::vector<Ort::Value> features;
+    // Features are written directly into the padded input
+    std::vector<float> features;
+    std::vector<int64_t> features_length_vec;
+    int32_t max_num_frames = GetBatchFrames(
+        ss, n, -23.025850929940457f, &features, &features_length_vec);
 
-    features.reserve(n);
-
-    std::vector<std::vector<float>> features_vec(n);
-    std::vector<int64_t> features_length_vec(n);
-    for (int32_t i = 0; i != n; ++i) {
-      auto f = ss[i]->GetFrames();
-      int32_t num_frames = f.size() / feat_dim;
-
-      features_length_vec[i] = num_frames;
-      features_vec[i] = std::move(f);
-
-      std::array<int64_t, 2> shape = {num_frames, feat_dim};
-
-      Ort::Value x = Ort::Value::CreateTensor(
-          memory_info, features_vec[i].data(), features_vec[i].size(),
-          shape.data(), shape.size());
-      features.push_back(std::move(x));
-    }
-
-    std::vector<const Ort::Value *> features_pointer(n);
-    for (int32_t i = 0; i != n; ++i) {
-      features_pointer[i] = &features[i];
-    }
+    std::array<int64_t, 3> shape = {n, max_num_frames, feat_dim};
+    Ort::Value x =
+        Ort::Value::CreateTensor(memory_info, features.data(), features.size(),
+                                 shape.data(), shape.size());
 
     std::array<int64_t, 1> features_length_shape = {n};
     Ort::Value x_length = Ort::Value::CreateTensor(
         memory_info, features_length_vec.data(), n,
         features_length_shape.data(), features_length_shape.size());
 
-    Ort::Value x = PadSequence(model_->Allocator(), features_pointer,
-                               -23.025850929940457f);
-
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto t = model_->RunEncoder(std::move(x), std::move(x_length));
+    encoder_trace.Stop();
     auto results =
         decoder_->Decode(std::move(t.first), std::move(t.second), ss, n);
 
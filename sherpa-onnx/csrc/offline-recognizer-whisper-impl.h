@@ -19,6 +19,7 @@
 #include "sherpa-onnx/csrc/offline-whisper-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-whisper-model.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/transpose.h"
 
 namespace sherpa_onnx {
@@ -128,7 +129,9 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
     mel = Transpose12(model_->Allocator(), &mel);
 
     try {
+      ScopedTrace encoder_trace(TraceStage::kEncoder);
       auto cross_kv = model_->ForwardEncoder(std::move(mel));
+      encoder_trace.Stop();
 
       auto results = decoder_->Decode(std::move(cross_kv.first),
                                       std::move(cross_kv.second), num_frames);
@@ -5,8 +5,11 @@
 #include "sherpa-onnx/csrc/offline-source-separation-impl.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
+#include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -17,12 +20,101 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-source-separation-spleeter-impl.h"
 #include "sherpa-onnx/csrc/offline-source-separation-uvr-impl.h"
 #include "sherpa-onnx/csrc/resample.h"
 
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
 namespace sherpa_onnx {
 
+namespace {
+
+// Produces the input at the output sample rate piece by piece so that
+// we never need to resample the whole input at once.
+class IncrementalInput {
+ public:
+  IncrementalInput(const OfflineSourceSeparationInput &input,
+                   int32_t output_sample_rate)
+      : input_(input), pending_(input.samples.data.size()) {
+    if (input.sample_rate != output_sample_rate) {
+      float min_freq = std::min<int32_t>(input.sample_rate, output_sample_rate);
+      float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+
+      int32_t lowpass_filter_width = 6;
+      for (size_t i = 0; i != input.samples.data.size(); ++i) {
+        resamplers_.push_back(std::make_unique<LinearResample>(
+            input.sample_rate, output_sample_rate, lowpass_cutoff,
+            lowpass_filter_width));
+      }
+    }
+
+    // feed about 1 second of input at a time
+    feed_size_ = std::max(input.sample_rate, 1);
+  }
+
+  // Make sure that there are at least n samples in the pending buffer
+  // unless the input is exhausted.
+  void Fill(int32_t n) {
+    int64_t num_samples = input_.samples.data[0].size();
+
+    while (!done_ && static_cast<int32_t>(pending_[0].size()) < n) {
+      int64_t end = std::min<int64_t>(offset_ + feed_size_, num_samples);
+      bool flush = (end == num_samples);
+
+      for (size_t c = 0; c != pending_.size(); ++c) {
+        const float *p = input_.samples.data[c].data() + offset_;
+        int32_t m = static_cast<int32_t>(end - offset_);
+
+        if (resamplers_.empty()) {
+          pending_[c].insert(pending_[c].end(), p, p + m);
+        } else {
+          resamplers_[c]->Resample(p, m, flush, &tmp_);
+          pending_[c].insert(pending_[c].end(), tmp_.begin(), tmp_.end());
+        }
+      }
+
+      offset_ = end;
+      done_ = flush;
+    }
+  }
+
+  // Remove the first n samples from the pending buffer
+  void Drop(int32_t n) {
+    for (auto &p : pending_) {
+      n = std::min<int32_t>(n, p.size());
+      p.erase(p.begin(), p.begin() + n);
+    }
+  }
+
+  const std::vector<std::vector<float>> &Pending() const { return pending_; }
+
+  bool Done() const { return done_; }
+
+ private:
+  const OfflineSourceSeparationInput &input_;
+  std::vector<std::unique_ptr<LinearResample>> resamplers_;
+
+  // pending_[c] contains resampled samples of channel c that have not
+  // been consumed yet
+  std::vector<std::vector<float>> pending_;
+  std::vector<float> tmp_;
+
+  int64_t offset_ = 0;
+  int32_t feed_size_ = 0;
+  bool done_ = false;
+};
+
+struct Segment {
+  OfflineSourceSeparationInput input;
+  bool is_last = false;
+};
+
+}  // namespace
+
 std::unique_ptr<OfflineSourceSeparationImpl>
 OfflineSourceSeparationImpl::Create(
     const OfflineSourceSeparationConfig &config) {
@@ -107,6 +199,190 @@ OfflineSourceSeparationInput OfflineSourceSeparationImpl::Resample(
   return *p_input;
 }
 
+OfflineSourceSeparationOutput OfflineSourceSeparationImpl::ProcessChunked(
+    const OfflineSourceSeparationInput &input,
+    const OfflineSourceSeparationConfig &config,
+    OfflineSourceSeparationCallback callback) const {
+  int32_t sample_rate = GetOutputSampleRate();
+
+  OfflineSourceSeparationOutput ans;
+  ans.sample_rate = sample_rate;
+
+  if (input.samples.data.empty() || input.samples.data[0].empty()) {
+    return ans;
+  }
+
+  for (const auto &samples : input.samples.data) {
+    if (samples.size() != input.samples.data[0].size()) {
+      SHERPA_ONNX_LOGE("ch0 samples size %d vs samples size %d",
+                       static_cast<int32_t>(input.samples.data[0].size()),
+                       static_cast<int32_t>(samples.size()));
+      SHERPA_ONNX_EXIT(-1);
+    }
+  }
+
+  int32_t chunk_size = static_cast<int32_t>(config.chunk_size * sample_rate);
+  int32_t overlap = static_cast<int32_t>(config.chunk_overlap * sample_rate);
+  overlap = std::max(0, std::min(overlap, chunk_size - 1));
+  int32_t hop = chunk_size - overlap;
+  int32_t num_workers = std::max(1, config.num_chunk_workers);
+
+  if (hop <= 0) {
+    SHERPA_ONNX_LOGE("Invalid chunk_size %.3f and chunk_overlap %.3f",
+                     config.chunk_size, config.chunk_overlap);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (config.model.debug) {
+    SHERPA_ONNX_LOGE(
+        "chunk_size: %d samples, overlap: %d samples, num_workers: %d",
+        chunk_size, overlap, num_workers);
+  }
+
+  // fade_in[i] + fade_out[i] == 1 in the overlapped region
+  std::vector<float> fade_in(overlap);
+  for (int32_t i = 0; i != overlap; ++i) {
+    float s = std::sin(0.5 * M_PI * (i + 0.5) / overlap);
+    fade_in[i] = s * s;
+  }
+
+  double expected_num_samples =
+      static_cast<double>(input.samples.data[0].size()) * sample_rate /
+      input.sample_rate;
+
+  IncrementalInput reader(input, sample_rate);
+
+  // tail[s].data[c] contains the last `overlap` samples of the previous
+  // segment for stem s and channel c
+  std::vector<MultiChannelSamples> tail;
+
+  int64_t num_processed_samples = 0;
+  int32_t segment_index = 0;
+  bool done = false;
+
+  while (!done) {
+    std::vector<Segment> segments;
+    while (static_cast<int32_t>(segments.size()) < num_workers && !done) {
+      // one more sample to tell whether this is the last segment
+      reader.Fill(chunk_size + 1);
+      const auto &pending = reader.Pending();
+
+      int32_t n = std::min<int32_t>(pending[0].size(), chunk_size);
+      if (n == 0) {
+        done = true;
+        break;
+      }
+
+      Segment segment;
+      segment.input.sample_rate = sample_rate;
+      segment.input.samples.data.reserve(pending.size());
+      for (const auto &p : pending) {
+        segment.input.samples.data.emplace_back(p.begin(), p.begin() + n);
+      }
+
+      segment.is_last =
+          reader.Done() && static_cast<int32_t>(pending[0].size()) <= n;
+
+      reader.Drop(segment.is_last ? n : hop);
+      done = segment.is_last;
+
+      segments.push_back(std::move(segment));
+    }
+
+    if (segments.empty()) {
+      break;
+    }
+
+    std::vector<OfflineSourceSeparationOutput> outputs(segments.size());
+    if (segments.size() == 1) {
+      outputs[0] = Process(segments[0].input);
+    } else {
+      std::vector<std::thread> threads;
+      threads.reserve(segments.size());
+      for (size_t i = 0; i != segments.size(); ++i) {
+        threads.emplace_back([this, i, &segments, &outputs]() {
+          outputs[i] = Process(segments[i].input);
+        });
+      }
+
+      for (auto &t : threads) {
+        t.join();
+      }
+    }
+
+    for (size_t i = 0; i != segments.size(); ++i, ++segment_index) {
+      auto &out = outputs[i];
+      int32_t n = segments[i].input.samples.data[0].size();
+      bool is_first = (segment_index == 0);
+      bool is_last = segments[i].is_last;
+
+      // the number of samples that are final after this segment
+      int32_t keep = is_last ? n : hop;
+
+      if (tail.empty()) {
+        tail.resize(out.stems.size());
+      }
+
+      for (size_t s = 0; s != out.stems.size(); ++s) {
+        auto &channels = out.stems[s].data;
+        tail[s].data.resize(channels.size());
+
+        for (size_t c = 0; c != channels.size(); ++c) {
+          auto &y = channels[c];
+
+          // the model output may be off by a few samples
+          y.resize(n);
+
+          if (!is_first) {
+            const auto &prev = tail[s].data[c];
+            int32_t k = std::min<int32_t>(prev.size(), n);
+            int32_t offset = overlap - static_cast<int32_t>(prev.size());
+
+            for (int32_t t = 0; t != k; ++t) {
+              float w = fade_in[t + offset];
+              y[t] = prev[t] * (1 - w) + y[t] * w;
+            }
+          }
+
+          tail[s].data[c].assign(y.begin() + keep, y.end());
+          y.resize(keep);
+        }
+      }
+
+      num_processed_samples += keep;
+
+      if (callback) {
+        float progress =
+            is_last ? 1.0
+                    : std::min<float>(
+                          num_processed_samples / expected_num_samples, 1.0);
+
+        if (!callback(out, progress)) {
+          done = true;
+          break;
+        }
+
+        continue;
+      }
+
+      if (ans.stems.empty()) {
+        ans.stems = std::move(out.stems);
+        continue;
+      }
+
+      for (size_t s = 0; s != out.stems.size(); ++s) {
+        for (size_t c = 0; c != out.stems[s].data.size(); ++c) {
+          auto &dst = ans.stems[s].data[c];
+          const auto &src = out.stems[s].data[c];
+          dst.insert(dst.end(), src.begin(), src.end());
+        }
+      }
+    }
+  }
+
+  return ans;
+}
+
 #if __ANDROID_API__ >= 9
 template std::unique_ptr<OfflineSourceSeparationImpl>
 OfflineSourceSeparationImpl::Create(
@@ -32,6 +32,17 @@ class OfflineSourceSeparationImpl {
 
   OfflineSourceSeparationInput Resample(
       const OfflineSourceSeparationInput &input, bool debug = false) const;
+
+  // Split the input into overlapping segments of config.chunk_size seconds,
+  // run Process() on up to config.num_chunk_workers segments in parallel
+  // and stitch the results with a windowed overlap-add.
+  //
+  // If callback is not empty, each stitched piece is passed to it and the
+  // returned output contains no samples.
+  OfflineSourceSeparationOutput ProcessChunked(
+      const OfflineSourceSeparationInput &input,
+      const OfflineSourceSeparationConfig &config,
+      OfflineSourceSeparationCallback callback) const;
 };
 
 }  // namespace sherpa_onnx
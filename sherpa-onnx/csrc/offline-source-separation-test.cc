@@ -0,0 +1,183 @@
+// sherpa-onnx/csrc/offline-source-separation-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-source-separation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/offline-source-separation-impl.h"
+
+namespace sherpa_onnx {
+
+// A stand-in for a separation model. The first stem is the input smoothed
+// by a 5-tap filter and the second stem is the rest. The filter needs
+// context, so segments differ from the whole input near their edges.
+class SmoothingSeparationImpl : public OfflineSourceSeparationImpl {
+ public:
+  explicit SmoothingSeparationImpl(int32_t sample_rate)
+      : sample_rate_(sample_rate) {}
+
+  OfflineSourceSeparationOutput Process(
+      const OfflineSourceSeparationInput &input) const override {
+    static const float kWeights[] = {0.1, 0.2, 0.4, 0.2, 0.1};
+
+    OfflineSourceSeparationOutput ans;
+    ans.sample_rate = sample_rate_;
+    ans.stems.resize(2);
+
+    for (const auto &x : input.samples.data) {
+      int32_t n = x.size();
+      std::vector<float> smooth(n);
+      std::vector<float> rest(n);
+      for (int32_t t = 0; t != n; ++t) {
+        for (int32_t k = 0; k != 5; ++k) {
+          int32_t i = t + k - 2;
+          if (i >= 0 && i < n) {
+            smooth[t] += kWeights[k] * x[i];
+          }
+        }
+        rest[t] = x[t] - smooth[t];
+      }
+
+      ans.stems[0].data.push_back(std::move(smooth));
+      ans.stems[1].data.push_back(std::move(rest));
+    }
+
+    return ans;
+  }
+
+  int32_t GetOutputSampleRate() const override { return sample_rate_; }
+
+  int32_t GetNumberOfStems() const override { return 2; }
+
+ private:
+  int32_t sample_rate_;
+};
+
+static OfflineSourceSeparationInput GenerateInput(int32_t num_samples,
+                                                  int32_t sample_rate) {
+  std::mt19937 gen(20250103);
+  std::uniform_real_distribution<float> dist(-0.5, 0.5);
+
+  OfflineSourceSeparationInput input;
+  input.sample_rate = sample_rate;
+  input.samples.data.resize(2);
+  for (auto &x : input.samples.data) {
+    x.resize(num_samples);
+    for (auto &f : x) {
+      f = dist(gen);
+    }
+  }
+
+  return input;
+}
+
+// Concatenate the pieces passed to the callback
+static OfflineSourceSeparationOutput ProcessChunked(
+    const OfflineSourceSeparationImpl &impl,
+    const OfflineSourceSeparationInput &input,
+    const OfflineSourceSeparationConfig &config, int32_t *num_calls) {
+  OfflineSourceSeparationOutput ans;
+  float last_progress = 0;
+  *num_calls = 0;
+
+  auto callback = [&](const OfflineSourceSeparationOutput &out,
+                      float progress) -> int32_t {
+    EXPECT_GE(progress, last_progress);
+    last_progress = progress;
+    *num_calls += 1;
+
+    ans.sample_rate = out.sample_rate;
+    ans.stems.resize(out.stems.size());
+    for (size_t s = 0; s != out.stems.size(); ++s) {
+      ans.stems[s].data.resize(out.stems[s].data.size());
+      for (size_t c = 0; c != out.stems[s].data.size(); ++c) {
+        auto &dst = ans.stems[s].data[c];
+        const auto &src = out.stems[s].data[c];
+        dst.insert(dst.end(), src.begin(), src.end());
+      }
+    }
+    return 1;
+  };
+
+  auto r = impl.ProcessChunked(input, config, callback);
+  EXPECT_TRUE(r.stems.empty());
+  EXPECT_EQ(last_progress, 1);
+
+  return ans;
+}
+
+static void ExpectNear(const OfflineSourceSeparationOutput &a,
+                       const OfflineSourceSeparationOutput &b, float tol) {
+  EXPECT_EQ(a.sample_rate, b.sample_rate);
+  ASSERT_EQ(a.stems.size(), b.stems.size());
+  for (size_t s = 0; s != a.stems.size(); ++s) {
+    ASSERT_EQ(a.stems[s].data.size(), b.stems[s].data.size());
+    for (size_t c = 0; c != a.stems[s].data.size(); ++c) {
+      const auto &x = a.stems[s].data[c];
+      const auto &y = b.stems[s].data[c];
+      ASSERT_EQ(x.size(), y.size()) << s << " " << c;
+
+      float max_diff = 0;
+      for (size_t i = 0; i != x.size(); ++i) {
+        max_diff = std::max(max_diff, std::abs(x[i] - y[i]));
+      }
+      EXPECT_LE(max_diff, tol) << s << " " << c;
+    }
+  }
+}
+
+TEST(OfflineSourceSeparation, ChunkedMatchesWhole) {
+  int32_t sample_rate = 16000;
+  SmoothingSeparationImpl impl(sample_rate);
+
+  // 10.3 seconds, so the last segment is shorter
+  auto input = GenerateInput(164800, sample_rate);
+  auto expected = impl.Process(input);
+
+  OfflineSourceSeparationConfig config;
+  config.chunk_size = 2;
+  config.chunk_overlap = 0.5;
+
+  for (int32_t num_workers : {1, 3}) {
+    config.num_chunk_workers = num_workers;
+
+    int32_t num_calls = 0;
+    auto stitched = ProcessChunked(impl, input, config, &num_calls);
+    EXPECT_GT(num_calls, 1);
+
+    // Segment edges are faded in or out, so their errors are tiny
+    ExpectNear(stitched, expected, 1e-4);
+
+    // Without a callback, the pieces are concatenated in the output
+    ExpectNear(impl.ProcessChunked(input, config, nullptr), stitched, 0);
+  }
+}
+
+TEST(OfflineSourceSeparation, ChunkedWithResampling) {
+  SmoothingSeparationImpl impl(16000);
+
+  // 5 seconds at 44.1 kHz
+  auto input = GenerateInput(220500, 44100);
+  auto expected = impl.Process(impl.Resample(input));
+
+  OfflineSourceSeparationConfig config;
+  config.chunk_size = 1;
+  config.chunk_overlap = 0.25;
+  config.num_chunk_workers = 2;
+
+  int32_t num_calls = 0;
+  auto stitched = ProcessChunked(impl, input, config, &num_calls);
+  EXPECT_GT(num_calls, 1);
+
+  // The input is resampled in pieces instead of in one go
+  ExpectNear(stitched, expected, 1e-3);
+}
+
+}  // namespace sherpa_onnx
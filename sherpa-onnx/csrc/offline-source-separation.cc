@@ -5,7 +5,9 @@
 #include "sherpa-onnx/csrc/offline-source-separation.h"
 
 #include <memory>
+#include <utility>
 
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-source-separation-impl.h"
 
 #if __ANDROID_API__ >= 9
@@ -21,9 +23,45 @@ namespace sherpa_onnx {
 
 void OfflineSourceSeparationConfig::Register(ParseOptions *po) {
   model.Register(po);
+
+  po->Register("chunk-size", &chunk_size,
+               "If positive, split the input into segments of this many "
+               "seconds and process them independently. Segments are "
+               "stitched with a windowed overlap-add. Use it for long audio "
+               "so that peak memory does not depend on the input length. "
+               "If 0, process the whole input at once.");
+
+  po->Register("chunk-overlap", &chunk_overlap,
+               "Overlap in seconds between two neighbouring segments. "
+               "Used only when --chunk-size is positive.");
+
+  po->Register("num-chunk-workers", &num_chunk_workers,
+               "Number of segments to process in parallel. "
+               "Used only when --chunk-size is positive.");
 }
 
 bool OfflineSourceSeparationConfig::Validate() const {
+  if (chunk_size > 0) {
+    if (chunk_overlap < 0) {
+      SHERPA_ONNX_LOGE("chunk_overlap should be non-negative. Given: %.3f",
+                       chunk_overlap);
+      return false;
+    }
+
+    if (chunk_overlap >= chunk_size) {
+      SHERPA_ONNX_LOGE(
+          "chunk_overlap (%.3f) should be less than chunk_size (%.3f)",
+          chunk_overlap, chunk_size);
+      return false;
+    }
+
+    if (num_chunk_workers < 1) {
+      SHERPA_ONNX_LOGE("num_chunk_workers should be at least 1. Given: %d",
+                       num_chunk_workers);
+      return false;
+    }
+  }
+
   return model.Validate();
 }
 
@@ -31,7 +69,10 @@ std::string OfflineSourceSeparationConfig::ToString() const {
   std::ostringstream os;
 
   os << "OfflineSourceSeparationConfig(";
-  os << "model=" << model.ToString() << ")";
+  os << "model=" << model.ToString() << ", ";
+  os << "chunk_size=" << chunk_size << ", ";
+  os << "chunk_overlap=" << chunk_overlap << ", ";
+  os << "num_chunk_workers=" << num_chunk_workers << ")";
 
   return os.str();
 }
@@ -39,17 +80,33 @@ std::string OfflineSourceSeparationConfig::ToString() const {
 template <typename Manager>
 OfflineSourceSeparation::OfflineSourceSeparation(
     Manager *mgr, const OfflineSourceSeparationConfig &config)
-    : impl_(OfflineSourceSeparationImpl::Create(mgr, config)) {}
+    : config_(config),
+      impl_(OfflineSourceSeparationImpl::Create(mgr, config)) {}
 
 OfflineSourceSeparation::OfflineSourceSeparation(
     const OfflineSourceSeparationConfig &config)
-    : impl_(OfflineSourceSeparationImpl::Create(config)) {}
+    : config_(config), impl_(OfflineSourceSeparationImpl::Create(config)) {}
 
 OfflineSourceSeparation::~OfflineSourceSeparation() = default;
 
 OfflineSourceSeparationOutput OfflineSourceSeparation::Process(
-    const OfflineSourceSeparationInput &input) const {
-  return impl_->Process(input);
+    const OfflineSourceSeparationInput &input,
+    OfflineSourceSeparationCallback callback /*= nullptr*/) const {
+  if (config_.chunk_size > 0) {
+    return impl_->ProcessChunked(input, config_, std::move(callback));
+  }
+
+  if (!callback) {
+    return impl_->Process(input);
+  }
+
+  auto output = impl_->Process(input);
+  callback(output, 1.0);
+
+  OfflineSourceSeparationOutput ans;
+  ans.sample_rate = output.sample_rate;
+
+  return ans;
 }
 
 int32_t OfflineSourceSeparation::GetOutputSampleRate() const {
@@ -5,6 +5,8 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,12 +19,36 @@ namespace sherpa_onnx {
 struct OfflineSourceSeparationConfig {
   OfflineSourceSeparationModelConfig model;
 
+  // If positive, the input is split into segments of this many seconds.
+  // Segments are processed independently and stitched together with a
+  // windowed overlap-add, so peak memory no longer depends on the
+  // duration of the input.
+  //
+  // If it is 0, the whole input is processed in one go.
+  float chunk_size = 0;
+
+  // Overlap in seconds between two neighbouring segments.
+  // Used only when chunk_size > 0.
+  float chunk_overlap = 1;
+
+  // Number of segments to process in parallel.
+  // Used only when chunk_size > 0.
+  int32_t num_chunk_workers = 1;
+
   OfflineSourceSeparationConfig() = default;
 
   explicit OfflineSourceSeparationConfig(
       const OfflineSourceSeparationModelConfig &model)
       : model(model) {}
 
+  OfflineSourceSeparationConfig(
+      const OfflineSourceSeparationModelConfig &model, float chunk_size,
+      float chunk_overlap, int32_t num_chunk_workers)
+      : model(model),
+        chunk_size(chunk_size),
+        chunk_overlap(chunk_overlap),
+        num_chunk_workers(num_chunk_workers) {}
+
   void Register(ParseOptions *po);
 
   bool Validate() const;
@@ -49,6 +75,16 @@ struct OfflineSourceSeparationOutput {
   int32_t sample_rate;
 };
 
+// It is called whenever a new piece of separated audio is available.
+// The pieces are delivered in order; concatenating them gives the
+// complete output.
+//
+// If the callback returns 0, then it stops processing.
+// If the callback returns 1, then it keeps processing.
+using OfflineSourceSeparationCallback =
+    std::function<int32_t(const OfflineSourceSeparationOutput & /*output*/,
+                          float /*progress*/)>;
+
 class OfflineSourceSeparationImpl;
 
 class OfflineSourceSeparation {
@@ -61,8 +97,16 @@ class OfflineSourceSeparation {
   OfflineSourceSeparation(Manager *mgr,
                           const OfflineSourceSeparationConfig &config);
 
+  // @param input The input audio.
+  // @param callback If not NULL, it is called with each piece of separated
+  //                 audio as soon as it is ready and the returned output
+  //                 contains no samples. This is the recommended way to
+  //                 process long audio with config.chunk_size > 0 since
+  //                 the output is then never accumulated in memory.
+  //                 The callback is called in the current thread.
   OfflineSourceSeparationOutput Process(
-      const OfflineSourceSeparationInput &input) const;
+      const OfflineSourceSeparationInput &input,
+      OfflineSourceSeparationCallback callback = nullptr) const;
 
   int32_t GetOutputSampleRate() const;
 
@@ -70,6 +114,7 @@ class OfflineSourceSeparation {
   int32_t GetNumberOfStems() const;
 
  private:
+  OfflineSourceSeparationConfig config_;
   std::unique_ptr<OfflineSourceSeparationImpl> impl_;
 };
 
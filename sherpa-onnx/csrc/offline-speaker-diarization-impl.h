@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "sherpa-onnx/csrc/offline-speaker-diarization.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
 namespace sherpa_onnx {
 
 class OfflineSpeakerDiarizationImpl {
@@ -32,6 +33,11 @@ class OfflineSpeakerDiarizationImpl {
       const float *audio, int32_t n,
       OfflineSpeakerDiarizationProgressCallback callback = nullptr,
       void *callback_arg = nullptr) const = 0;
+
+  virtual OfflineSpeakerDiarizationResult Process(
+      const StreamingWaveReader &reader,
+      OfflineSpeakerDiarizationProgressCallback callback = nullptr,
+      void *callback_arg = nullptr) const = 0;
 };
 
 }  // namespace sherpa_onnx
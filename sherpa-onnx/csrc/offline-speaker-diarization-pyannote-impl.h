@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -17,6 +19,7 @@
 #include "sherpa-onnx/csrc/offline-speaker-diarization-impl.h"
 #include "sherpa-onnx/csrc/offline-speaker-segmentation-pyannote-model.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
 
 namespace sherpa_onnx {
 
@@ -95,7 +98,50 @@ class OfflineSpeakerDiarizationPyannoteImpl
       const float *audio, int32_t n,
       OfflineSpeakerDiarizationProgressCallback callback = nullptr,
       void *callback_arg = nullptr) const override {
-    std::vector<Matrix2D> segmentations = RunSpeakerSegmentationModel(audio, n);
+    auto get_samples = [audio](int32_t start, int32_t /*num_samples*/,
+                               std::vector<float> * /*buf*/) {
+      return audio + start;
+    };
+
+    return ProcessImpl(get_samples, n, std::move(callback), callback_arg);
+  }
+
+  OfflineSpeakerDiarizationResult Process(
+      const StreamingWaveReader &reader,
+      OfflineSpeakerDiarizationProgressCallback callback = nullptr,
+      void *callback_arg = nullptr) const override {
+    if (reader.NumSamples() > std::numeric_limits<int32_t>::max()) {
+      SHERPA_ONNX_LOGE("The file is too long: %lld samples",
+                       static_cast<long long>(reader.NumSamples()));  // NOLINT
+      return {};
+    }
+
+    // Samples are decoded only when the segmentation or the embedding model
+    // needs them
+    auto get_samples = [&reader](int32_t start, int32_t num_samples,
+                                 std::vector<float> *buf) {
+      buf->resize(num_samples);
+      reader.ReadAt(start, num_samples, buf->data());
+      return static_cast<const float *>(buf->data());
+    };
+
+    return ProcessImpl(get_samples, reader.NumSamples(), std::move(callback),
+                       callback_arg);
+  }
+
+ private:
+  // Return a pointer to the samples [start, start + num_samples). The
+  // returned pointer either points to the input audio or to *buf.
+  using GetSamplesFunc =
+      std::function<const float *(int32_t /*start*/, int32_t /*num_samples*/,
+                                  std::vector<float> * /*buf*/)>;
+
+  OfflineSpeakerDiarizationResult ProcessImpl(
+      const GetSamplesFunc &get_samples, int32_t n,
+      OfflineSpeakerDiarizationProgressCallback callback,
+      void *callback_arg) const {
+    std::vector<Matrix2D> segmentations =
+        RunSpeakerSegmentationModel(get_samples, n);
     // segmentations[i] is for chunk_i
     // Each matrix is of shape (num_frames, num_powerset_classes)
     if (segmentations.empty()) {
@@ -138,7 +184,8 @@ class OfflineSpeakerDiarizationPyannoteImpl
     valid_indexes.reserve(chunk_speaker_samples_list_pair.second.size());
 
     Matrix2D embeddings =
-        ComputeEmbeddings(audio, n, chunk_speaker_samples_list_pair.second,
+        ComputeEmbeddings(get_samples, n,
+                          chunk_speaker_samples_list_pair.second,
                           &valid_indexes, std::move(callback), callback_arg);
 
     if (valid_indexes.size() != chunk_speaker_samples_list_pair.second.size()) {
@@ -179,7 +226,6 @@ class OfflineSpeakerDiarizationPyannoteImpl
     return result;
   }
 
- private:
   void Init() { InitPowersetMapping(); }
 
   // see also
@@ -219,8 +265,8 @@ class OfflineSpeakerDiarizationPyannoteImpl
     }
   }
 
-  std::vector<Matrix2D> RunSpeakerSegmentationModel(const float *audio,
-                                                    int32_t n) const {
+  std::vector<Matrix2D> RunSpeakerSegmentationModel(
+      const GetSamplesFunc &get_samples, int32_t n) const {
     std::vector<Matrix2D> ans;
 
     const auto &meta_data = segmentation_model_.GetModelMetaData();
@@ -246,7 +292,9 @@ class OfflineSpeakerDiarizationPyannoteImpl
       std::vector<float> buf(window_size);
       // NOTE: buf is zero initialized by default
 
-      std::copy(audio, audio + n, buf.data());
+      std::vector<float> tmp;
+      const float *p = get_samples(0, n, &tmp);
+      std::copy(p, p + n, buf.data());
 
       Matrix2D m = ProcessChunk(buf.data());
 
@@ -260,17 +308,19 @@ class OfflineSpeakerDiarizationPyannoteImpl
 
     ans.reserve(num_chunks + has_last_chunk);
 
-    const float *p = audio;
+    std::vector<float> tmp;
+    int32_t start = 0;
 
-    for (int32_t i = 0; i != num_chunks; ++i, p += window_shift) {
-      Matrix2D m = ProcessChunk(p);
+    for (int32_t i = 0; i != num_chunks; ++i, start += window_shift) {
+      Matrix2D m = ProcessChunk(get_samples(start, window_size, &tmp));
 
       ans.push_back(std::move(m));
     }
 
     if (has_last_chunk) {
       std::vector<float> buf(window_size);
-      std::copy(p, audio + n, buf.data());
+      const float *p = get_samples(start, n - start, &tmp);
+      std::copy(p, p + n - start, buf.data());
 
       Matrix2D m = ProcessChunk(buf.data());
 
@@ -459,7 +509,7 @@ class OfflineSpeakerDiarizationPyannoteImpl
    *         i-th (chunk, speaker) pair
    */
   Matrix2D ComputeEmbeddings(
-      const float *audio, int32_t n,
+      const GetSamplesFunc &get_samples, int32_t n,
       const std::vector<std::vector<Int32Pair>> &sample_indexes,
       std::vector<int32_t> *valid_indexes,
       OfflineSpeakerDiarizationProgressCallback callback,
@@ -472,6 +522,7 @@ class OfflineSpeakerDiarizationPyannoteImpl
 
     int32_t k = 0;
     int32_t cur_row_index = 0;
+    std::vector<float> tmp;
     for (const auto &v : sample_indexes) {
       auto stream = embedding_extractor_.CreateStream();
       for (const auto &p : v) {
@@ -479,7 +530,9 @@ class OfflineSpeakerDiarizationPyannoteImpl
         int32_t num_samples = end - p.first;
 
         if (num_samples > 0) {
-          stream->AcceptWaveform(sample_rate, audio + p.first, num_samples);
+          stream->AcceptWaveform(sample_rate,
+                                 get_samples(p.first, num_samples, &tmp),
+                                 num_samples);
         }
       }
 
@@ -16,6 +16,7 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-speaker-diarization-impl.h"
 
 namespace sherpa_onnx {
@@ -106,6 +107,24 @@ OfflineSpeakerDiarizationResult OfflineSpeakerDiarization::Process(
   return impl_->Process(audio, n, std::move(callback), callback_arg);
 }
 
+OfflineSpeakerDiarizationResult OfflineSpeakerDiarization::Process(
+    const StreamingWaveReader &reader,
+    OfflineSpeakerDiarizationProgressCallback callback /*= nullptr*/,
+    void *callback_arg /*= nullptr*/) const {
+  if (!reader.IsOk()) {
+    SHERPA_ONNX_LOGE("Invalid wave reader");
+    return {};
+  }
+
+  if (reader.SampleRate() != SampleRate()) {
+    SHERPA_ONNX_LOGE("Expected sample rate %d. Given: %d", SampleRate(),
+                     reader.SampleRate());
+    return {};
+  }
+
+  return impl_->Process(reader, std::move(callback), callback_arg);
+}
+
 #if __ANDROID_API__ >= 9
 template OfflineSpeakerDiarization::OfflineSpeakerDiarization(
     AAssetManager *mgr, const OfflineSpeakerDiarizationConfig &config);
@@ -13,6 +13,7 @@
 #include "sherpa-onnx/csrc/offline-speaker-diarization-result.h"
 #include "sherpa-onnx/csrc/offline-speaker-segmentation-model-config.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
 
 namespace sherpa_onnx {
 
@@ -75,6 +76,14 @@ class OfflineSpeakerDiarization {
       OfflineSpeakerDiarizationProgressCallback callback = nullptr,
       void *callback_arg = nullptr) const;
 
+  // Like the above one but samples of the first channel are decoded from
+  // `reader` only when they are needed, so a long file is never fully
+  // loaded into memory. The sample rate of the file must be SampleRate().
+  OfflineSpeakerDiarizationResult Process(
+      const StreamingWaveReader &reader,
+      OfflineSpeakerDiarizationProgressCallback callback = nullptr,
+      void *callback_arg = nullptr) const;
+
  private:
   std::unique_ptr<OfflineSpeakerDiarizationImpl> impl_;
 };
@@ -0,0 +1,100 @@
+// sherpa-onnx/csrc/offline-stream-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> GenerateSamples(int32_t n) {
+  std::mt19937 gen(20250109);
+  std::uniform_real_distribution<float> dist(-0.3, 0.3);
+
+  std::vector<float> x(n);
+  for (auto &f : x) {
+    f = dist(gen);
+  }
+
+  return x;
+}
+
+// Give x to a new stream in pieces of pseudo random sizes
+static std::unique_ptr<OfflineStream> AcceptChunks(
+    const std::function<std::unique_ptr<OfflineStream>()> &create,
+    int32_t sampling_rate, const std::vector<float> &x) {
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int32_t> chunk_size(1, 4000);
+
+  auto s = create();
+  int32_t offset = 0;
+  while (offset < static_cast<int32_t>(x.size())) {
+    int32_t n = std::min<int32_t>(chunk_size(gen), x.size() - offset);
+    s->AcceptWaveformChunk(sampling_rate, x.data() + offset, n);
+    offset += n;
+  }
+  s->InputFinished();
+
+  return s;
+}
+
+static void ExpectSameFeatures(
+    const std::function<std::unique_ptr<OfflineStream>()> &create,
+    int32_t sampling_rate, float tol) {
+  auto x = GenerateSamples(sampling_rate * 3 + 123);
+
+  auto whole = create();
+  whole->AcceptWaveform(sampling_rate, x.data(), x.size());
+
+  auto chunked = AcceptChunks(create, sampling_rate, x);
+
+  ASSERT_EQ(chunked->FeatureDim(), whole->FeatureDim());
+  ASSERT_EQ(chunked->NumFrames(), whole->NumFrames());
+  ASSERT_GT(whole->NumFrames(), 0);
+
+  auto expected = whole->GetFrames();
+  auto features = chunked->GetFrames();
+  ASSERT_EQ(features.size(), expected.size());
+
+  for (size_t i = 0; i != expected.size(); ++i) {
+    ASSERT_NEAR(features[i], expected[i],
+                tol * std::max(1.0f, std::fabs(expected[i])))
+        << i;
+  }
+}
+
+TEST(OfflineStream, ChunksMatchWholeWaveform) {
+  // It uses BatchFbank
+  auto fbank = []() {
+    FeatureExtractorConfig config;
+    return std::make_unique<OfflineStream>(config);
+  };
+  ExpectSameFeatures(fbank, 16000, 1e-5);
+
+  // Chunks are resampled with a single resampler instead of in one go
+  ExpectSameFeatures(fbank, 8000, 1e-3);
+
+  // BatchFbank does not support dithering, so a negligible dither makes it
+  // use knf::OnlineFbank
+  auto dithered_fbank = []() {
+    FeatureExtractorConfig config;
+    config.dither = 1e-30;
+    return std::make_unique<OfflineStream>(config);
+  };
+  ExpectSameFeatures(dithered_fbank, 16000, 1e-3);
+
+  auto whisper = []() {
+    return std::make_unique<OfflineStream>(WhisperTag{80});
+  };
+  ExpectSameFeatures(whisper, 16000, 1e-3);
+}
+
+}  // namespace sherpa_onnx
@@ -9,53 +9,73 @@
 #include <cmath>
 #include <iomanip>
 #include <limits>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "kaldi-native-fbank/csrc/online-feature.h"
+#include "sherpa-onnx/csrc/batch-fbank.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
-/* Compute mean and inverse stddev over rows.
- *
- * @param p  A pointer to a 2-d array of shape (num_rows, num_cols)
- * @param num_rows Number of rows
- * @param num_cols Number of columns
- * @param mean On return, it contains p.mean(axis=0)
- * @param inv_stddev On return, it contains 1/p.std(axis=0)
- */
-static void ComputeMeanAndInvStd(const float *p, int32_t num_rows,
-                                 int32_t num_cols, std::vector<float> *mean,
-                                 std::vector<float> *inv_stddev) {
-  std::vector<float> sum(num_cols);
-  std::vector<float> sum_sq(num_cols);
-
-  for (int32_t i = 0; i != num_rows; ++i) {
-    for (int32_t c = 0; c != num_cols; ++c) {
-      auto t = p[c];
-      sum[c] += t;
-      sum_sq[c] += t * t;
-    }
-    p += num_cols;
-  }
-
-  mean->resize(num_cols);
-  inv_stddev->resize(num_cols);
+static bool IsEqual(const knf::FrameExtractionOptions &a,
+                    const knf::FrameExtractionOptions &b) {
+  return a.samp_freq == b.samp_freq && a.frame_shift_ms == b.frame_shift_ms &&
+         a.frame_length_ms == b.frame_length_ms && a.dither == b.dither &&
+         a.preemph_coeff == b.preemph_coeff &&
+         a.remove_dc_offset == b.remove_dc_offset &&
+         a.window_type == b.window_type &&
+         a.round_to_power_of_two == b.round_to_power_of_two &&
+         a.blackman_coeff == b.blackman_coeff && a.snip_edges == b.snip_edges;
+}
 
-  for (int32_t i = 0; i != num_cols; ++i) {
-    auto t = sum[i] / num_rows;
-    (*mean)[i] = t;
+static bool IsEqual(const knf::MelBanksOptions &a,
+                    const knf::MelBanksOptions &b) {
+  return a.num_bins == b.num_bins && a.low_freq == b.low_freq &&
+         a.high_freq == b.high_freq && a.vtln_low == b.vtln_low &&
+         a.vtln_high == b.vtln_high && a.debug_mel == b.debug_mel &&
+         a.htk_mode == b.htk_mode && a.is_librosa == b.is_librosa &&
+         a.norm == b.norm && a.use_slaney_mel_scale == b.use_slaney_mel_scale &&
+         a.floor_to_int_bin == b.floor_to_int_bin;
+}
 
-    float stddev = std::sqrt(sum_sq[i] / num_rows - t * t);
+static bool IsEqual(const knf::FbankOptions &a, const knf::FbankOptions &b) {
+  return IsEqual(a.frame_opts, b.frame_opts) &&
+         IsEqual(a.mel_opts, b.mel_opts) &&
+         a.use_energy == b.use_energy && a.energy_floor == b.energy_floor &&
+         a.raw_energy == b.raw_energy && a.htk_compat == b.htk_compat &&
+         a.use_log_fbank == b.use_log_fbank && a.use_power == b.use_power;
+}
 
-    if (stddev != stddev) {
-      stddev = 0;
+// BatchFbank objects are immutable and their construction is not free,
+// so streams with the same options share one. All fields of the options
+// are compared. A process uses only a few distinct options, so a linear
+// search is enough.
+static std::shared_ptr<const BatchFbank> GetBatchFbank(
+    const knf::FbankOptions &opts) {
+  static std::mutex mutex;
+  static std::vector<
+      std::pair<knf::FbankOptions, std::shared_ptr<const BatchFbank>>>
+      cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &p : cache) {
+    if (IsEqual(p.first, opts)) {
+      return p.second;
     }
-
-    (*inv_stddev)[i] = 1.0f / (stddev + 1e-5f);
   }
+
+  auto ans = std::make_shared<BatchFbank>(opts);
+  cache.emplace_back(opts, ans);
+
+  return ans;
 }
 
 class OfflineStream::Impl {
@@ -100,6 +120,7 @@ class OfflineStream::Impl {
       opts_.mel_opts.is_librosa = config.is_librosa;
 
       fbank_ = std::make_unique<knf::OnlineFbank>(opts_);
+      InitBatchFbank();
     }
   }
 
@@ -136,6 +157,7 @@ class OfflineStream::Impl {
     config_.sampling_rate = opts_.frame_opts.samp_freq;
 
     fbank_ = std::make_unique<knf::OnlineFbank>(opts_);
+    InitBatchFbank();
   }
 
   explicit Impl(MoonshineTag /*tag*/) : is_moonshine_(true) {
@@ -143,6 +165,7 @@ class OfflineStream::Impl {
   }
 
   void AcceptWaveform(int32_t sampling_rate, const float *waveform, int32_t n) {
+    ScopedTrace trace(TraceStage::kFeatureExtraction);
     if (config_.normalize_samples) {
       AcceptWaveformImpl(sampling_rate, waveform, n);
     } else {
@@ -156,6 +179,7 @@ class OfflineStream::Impl {
 
   void AcceptWaveformImpl(int32_t sampling_rate, const float *waveform,
                           int32_t n) {
+    std::vector<float> samples;
     if (sampling_rate != config_.sampling_rate) {
       SHERPA_ONNX_LOGE(
           "Creating a resampler:\n"
@@ -170,38 +194,100 @@ class OfflineStream::Impl {
       auto resampler = std::make_unique<LinearResample>(
           sampling_rate, config_.sampling_rate, lowpass_cutoff,
           lowpass_filter_width);
-      std::vector<float> samples;
       resampler->Resample(waveform, n, true, &samples);
 
-      if (is_moonshine_) {
-        samples_.insert(samples_.end(), samples.begin(), samples.end());
-      } else if (fbank_) {
-        fbank_->AcceptWaveform(config_.sampling_rate, samples.data(),
-                               samples.size());
-        fbank_->InputFinished();
-      } else if (mfcc_) {
-        mfcc_->AcceptWaveform(config_.sampling_rate, samples.data(),
-                              samples.size());
-        mfcc_->InputFinished();
-      } else {
-        whisper_fbank_->AcceptWaveform(config_.sampling_rate, samples.data(),
-                                       samples.size());
-        whisper_fbank_->InputFinished();
+      waveform = samples.data();
+      n = samples.size();
+    }
+
+    AcceptSamples(waveform, n);
+    FinishFeatures();
+  }
+
+  void AcceptWaveformChunk(int32_t sampling_rate, const float *waveform,
+                           int32_t n) {
+    ScopedTrace trace(TraceStage::kFeatureExtraction);
+    if (!config_.normalize_samples) {
+      chunk_buf_.resize(n);
+      for (int32_t i = 0; i != n; ++i) {
+        chunk_buf_[i] = waveform[i] * 32768;
       }
+      waveform = chunk_buf_.data();
+    }
 
+    if (sampling_rate != config_.sampling_rate) {
+      if (!chunk_resampler_) {
+        SHERPA_ONNX_LOGE(
+            "Creating a resampler:\n"
+            "   in_sample_rate: %d\n"
+            "   output_sample_rate: %d\n",
+            sampling_rate, static_cast<int32_t>(config_.sampling_rate));
+
+        float min_freq =
+            std::min<int32_t>(sampling_rate, config_.sampling_rate);
+        float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+
+        int32_t lowpass_filter_width = 6;
+        chunk_resampler_ = std::make_unique<LinearResample>(
+            sampling_rate, config_.sampling_rate, lowpass_cutoff,
+            lowpass_filter_width);
+        chunk_sampling_rate_ = sampling_rate;
+      } else if (sampling_rate != chunk_sampling_rate_) {
+        SHERPA_ONNX_LOGE(
+            "You changed the input sampling rate!! Expected: %d, given: "
+            "%d",
+            chunk_sampling_rate_, sampling_rate);
+        SHERPA_ONNX_EXIT(-1);
+      }
+
+      chunk_resampler_->Resample(waveform, n, false, &resampled_);
+      AcceptSamples(resampled_.data(), resampled_.size());
       return;
-    }  // if (sampling_rate != config_.sampling_rate)
+    }
 
+    AcceptSamples(waveform, n);
+  }
+
+  void InputFinished() {
+    ScopedTrace trace(TraceStage::kFeatureExtraction);
+    if (chunk_resampler_) {
+      chunk_resampler_->Resample(nullptr, 0, true, &resampled_);
+      AcceptSamples(resampled_.data(), resampled_.size());
+      chunk_resampler_.reset();
+    }
+
+    FinishFeatures();
+  }
+
+  // Samples are at config_.sampling_rate. Both AcceptWaveform() and
+  // AcceptWaveformChunk() pass their samples to it.
+  void AcceptSamples(const float *samples, int32_t n) {
     if (is_moonshine_) {
-      samples_.insert(samples_.end(), waveform, waveform + n);
+      samples_.insert(samples_.end(), samples, samples + n);
+    } else if (batch_fbank_) {
+      // Features are computed for the whole utterance in GetFrames()
+      fbank_samples_.insert(fbank_samples_.end(), samples, samples + n);
+      fbank_features_.clear();
     } else if (fbank_) {
-      fbank_->AcceptWaveform(sampling_rate, waveform, n);
+      fbank_->AcceptWaveform(config_.sampling_rate, samples, n);
+    } else if (mfcc_) {
+      mfcc_->AcceptWaveform(config_.sampling_rate, samples, n);
+    } else {
+      whisper_fbank_->AcceptWaveform(config_.sampling_rate, samples, n);
+    }
+  }
+
+  // Flush the frames of the samples given so far
+  void FinishFeatures() {
+    if (is_moonshine_ || batch_fbank_) {
+      return;
+    }
+
+    if (fbank_) {
       fbank_->InputFinished();
     } else if (mfcc_) {
-      mfcc_->AcceptWaveform(sampling_rate, waveform, n);
       mfcc_->InputFinished();
     } else {
-      whisper_fbank_->AcceptWaveform(sampling_rate, waveform, n);
       whisper_fbank_->InputFinished();
     }
   }
@@ -214,37 +300,69 @@ class OfflineStream::Impl {
     return mfcc_ ? mfcc_opts_.num_ceps : opts_.mel_opts.num_bins;
   }
 
+  int32_t NumFrames() const {
+    if (is_moonshine_) {
+      return 1;
+    }
+
+    if (!fbank_samples_.empty()) {
+      return batch_fbank_->NumFrames(fbank_samples_.size());
+    }
+
+    return fbank_  ? fbank_->NumFramesReady()
+           : mfcc_ ? mfcc_->NumFramesReady()
+                   : whisper_fbank_->NumFramesReady();
+  }
+
   std::vector<float> GetFrames() const {
     if (is_moonshine_) {
       return samples_;
     }
 
-    int32_t n = fbank_  ? fbank_->NumFramesReady()
-                : mfcc_ ? mfcc_->NumFramesReady()
-                        : whisper_fbank_->NumFramesReady();
+    int32_t n = NumFrames();
     assert(n > 0 && "Please first call AcceptWaveform()");
 
-    int32_t feature_dim = FeatureDim();
+    std::vector<float> features(n * FeatureDim());
+    GetFrames(features.data());
 
-    std::vector<float> features(n * feature_dim);
+    return features;
+  }
 
-    float *p = features.data();
+  void GetFrames(float *p) const {
+    if (is_moonshine_) {
+      std::copy(samples_.begin(), samples_.end(), p);
+      return;
+    }
 
-    for (int32_t i = 0; i != n; ++i) {
-      const float *f = fbank_  ? fbank_->GetFrame(i)
-                       : mfcc_ ? mfcc_->GetFrame(i)
-                               : whisper_fbank_->GetFrame(i);
-      std::copy(f, f + feature_dim, p);
-      p += feature_dim;
+    int32_t n = NumFrames();
+    int32_t feature_dim = FeatureDim();
+    float *features = p;
+
+    if (!fbank_samples_.empty()) {
+      if (fbank_features_.empty()) {
+        // AcceptWaveform() only saves the samples in this case, so the
+        // features are timed here
+        ScopedTrace trace(TraceStage::kFeatureExtraction);
+        fbank_features_.resize(static_cast<size_t>(n) * feature_dim);
+        batch_fbank_->Compute(fbank_samples_.data(), fbank_samples_.size(),
+                              fbank_features_.data());
+      }
+      std::copy(fbank_features_.begin(), fbank_features_.end(), p);
+    } else {
+      for (int32_t i = 0; i != n; ++i) {
+        const float *f = fbank_  ? fbank_->GetFrame(i)
+                         : mfcc_ ? mfcc_->GetFrame(i)
+                                 : whisper_fbank_->GetFrame(i);
+        std::copy(f, f + feature_dim, p);
+        p += feature_dim;
+      }
     }
 
-    NemoNormalizeFeatures(features.data(), n, feature_dim);
+    NemoNormalizeFeatures(features, n, feature_dim);
 
     if (is_ced_) {
-      AmplitudeToDB(features.data(), features.size());
+      AmplitudeToDB(features, n * feature_dim);
     }
-
-    return features;
   }
 
   void SetResult(const OfflineRecognitionResult &r) { r_ = r; }
@@ -293,21 +411,12 @@ class OfflineStream::Impl {
       exit(-1);
     }
 
-    NemoNormalizePerFeature(p, num_frames, feature_dim);
+    NormalizePerFeature(p, num_frames, feature_dim);
   }
 
-  static void NemoNormalizePerFeature(float *p, int32_t num_frames,
-                                      int32_t feature_dim) {
-    std::vector<float> mean;
-    std::vector<float> inv_stddev;
-
-    ComputeMeanAndInvStd(p, num_frames, feature_dim, &mean, &inv_stddev);
-
-    for (int32_t n = 0; n != num_frames; ++n) {
-      for (int32_t i = 0; i != feature_dim; ++i) {
-        p[i] = (p[i] - mean[i]) * inv_stddev[i];
-      }
-      p += feature_dim;
+  void InitBatchFbank() {
+    if (BatchFbank::IsSupported(opts_)) {
+      batch_fbank_ = GetBatchFbank(opts_);
     }
   }
 
@@ -316,6 +425,18 @@ class OfflineStream::Impl {
   std::unique_ptr<knf::OnlineFbank> fbank_;
   std::unique_ptr<knf::OnlineMfcc> mfcc_;
   std::unique_ptr<knf::OnlineWhisperFbank> whisper_fbank_;
+
+  // If not nullptr, samples given to AcceptWaveform() and
+  // AcceptWaveformChunk() are saved in fbank_samples_ and features are
+  // computed by it in GetFrames(). The samples take about twice as much
+  // memory as the features.
+  std::shared_ptr<const BatchFbank> batch_fbank_;
+  std::vector<float> fbank_samples_;
+
+  // Features of fbank_samples_ computed by the first call of GetFrames().
+  // It is cleared when samples are added. Like the other members, it must
+  // not be accessed by two threads at the same time.
+  mutable std::vector<float> fbank_features_;
   knf::FbankOptions opts_;
   knf::MfccOptions mfcc_opts_;
   OfflineRecognitionResult r_;
@@ -325,6 +446,12 @@ class OfflineStream::Impl {
 
   // used only when is_moonshine_== true
   std::vector<float> samples_;
+
+  // for AcceptWaveformChunk()
+  std::unique_ptr<LinearResample> chunk_resampler_;
+  int32_t chunk_sampling_rate_ = 0;
+  std::vector<float> chunk_buf_;
+  std::vector<float> resampled_;
 };
 
 OfflineStream::OfflineStream(const FeatureExtractorConfig &config /*= {}*/,
@@ -346,12 +473,24 @@ void OfflineStream::AcceptWaveform(int32_t sampling_rate, const float *waveform,
   impl_->AcceptWaveform(sampling_rate, waveform, n);
 }
 
+void OfflineStream::AcceptWaveformChunk(int32_t sampling_rate,
+                                        const float *waveform,
+                                        int32_t n) const {
+  impl_->AcceptWaveformChunk(sampling_rate, waveform, n);
+}
+
+void OfflineStream::InputFinished() const { impl_->InputFinished(); }
+
 int32_t OfflineStream::FeatureDim() const { return impl_->FeatureDim(); }
 
+int32_t OfflineStream::NumFrames() const { return impl_->NumFrames(); }
+
 std::vector<float> OfflineStream::GetFrames() const {
   return impl_->GetFrames();
 }
 
+void OfflineStream::GetFrames(float *out) const { impl_->GetFrames(out); }
+
 void OfflineStream::SetResult(const OfflineRecognitionResult &r) {
   impl_->SetResult(r);
 }
@@ -363,6 +502,32 @@ const ContextGraphPtr &OfflineStream::GetContextGraph() const {
 const OfflineRecognitionResult &OfflineStream::GetResult() const {
   return impl_->GetResult();
 }
+int32_t GetBatchFrames(OfflineStream **ss, int32_t n, float padding_value,
+                       std::vector<float> *features,
+                       std::vector<int64_t> *num_frames) {
+  int32_t feat_dim = ss[0]->FeatureDim();
+
+  num_frames->resize(n);
+
+  int32_t max_num_frames = 0;
+  for (int32_t i = 0; i != n; ++i) {
+    (*num_frames)[i] = ss[i]->NumFrames();
+    max_num_frames = std::max<int32_t>(max_num_frames, (*num_frames)[i]);
+  }
+
+  int32_t stride = max_num_frames * feat_dim;
+  features->resize(n * stride);
+
+  for (int32_t i = 0; i != n; ++i) {
+    float *p = features->data() + i * stride;
+    ss[i]->GetFrames(p);
+
+    std::fill(p + (*num_frames)[i] * feat_dim, p + stride, padding_value);
+  }
+
+  return max_num_frames;
+}
+
 std::string OfflineRecognitionResult::AsJsonString() const {
   std::ostringstream os;
   os << "{";
@@ -77,16 +77,40 @@ class OfflineStream {
   void AcceptWaveform(int32_t sampling_rate, const float *waveform,
                       int32_t n) const;
 
+  /**
+     Like AcceptWaveform() but it can be called multiple times, e.g., with
+     chunks from StreamingWaveReader, so that the whole file never needs to
+     be decoded at once. The features are the same as those of a single
+     AcceptWaveform() call. Call InputFinished() after the last chunk.
+
+     Don't mix it with AcceptWaveform() on the same stream.
+   */
+  void AcceptWaveformChunk(int32_t sampling_rate, const float *waveform,
+                           int32_t n) const;
+
+  // Signal that no more chunks will be given to AcceptWaveformChunk()
+  void InputFinished() const;
+
   /// Return feature dim of this extractor.
   ///
   /// Note: if it is Moonshine, then it returns the number of audio samples
   /// currently received.
   int32_t FeatureDim() const;
 
+  /// Return the number of feature frames.
+  ///
+  /// Note: if it is Moonshine, then it returns 1.
+  int32_t NumFrames() const;
+
   // Get all the feature frames of this stream in a 1-D array, which is
   // flattened from a 2-D array of shape (num_frames, feat_dim).
   std::vector<float> GetFrames() const;
 
+  // Like GetFrames() but write the features into a caller-provided buffer,
+  // e.g., a row of a padded model input, of NumFrames() * FeatureDim()
+  // floats.
+  void GetFrames(float *out) const;
+
   /** Set the recognition result for this stream. */
   void SetResult(const OfflineRecognitionResult &r);
 
@@ -101,6 +125,25 @@ class OfflineStream {
   std::unique_ptr<Impl> impl_;
 };
 
+/** Compute the features of n streams and write them directly into a
+ * padded 3-D array that can be used as the input of a model.
+ *
+ * It does not support Moonshine.
+ *
+ * @param ss Pointer to an array of n streams.
+ * @param n Number of streams.
+ * @param padding_value Value for frames beyond the end of a stream.
+ * @param features On return, it contains a 3-D array of shape
+ *                 (n, max_num_frames, feat_dim) flattened in row major.
+ * @param num_frames On return, num_frames[i] is the number of frames of
+ *                   the i-th stream.
+ *
+ * @return Return max_num_frames.
+ */
+int32_t GetBatchFrames(OfflineStream **ss, int32_t n, float padding_value,
+                       std::vector<float> *features,
+                       std::vector<int64_t> *num_frames);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_OFFLINE_STREAM_H_
@@ -11,6 +11,7 @@
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/packed-sequence.h"
 #include "sherpa-onnx/csrc/slice.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -36,7 +37,9 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
   }
 
   auto decoder_input = model_->BuildDecoderInput(ans, ans.size());
+  ScopedTrace decoder_trace(TraceStage::kDecoder);
   Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+  decoder_trace.Stop();
 
   int32_t start = 0;
   int32_t t = 0;
@@ -44,8 +47,10 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
     Ort::Value cur_encoder_out = packed_encoder_out.Get(start, n);
     Ort::Value cur_decoder_out = Slice(model_->Allocator(), &decoder_out, 0, n);
     start += n;
+    ScopedTrace joiner_trace(TraceStage::kJoiner);
     Ort::Value logit = model_->RunJoiner(std::move(cur_encoder_out),
                                          std::move(cur_decoder_out));
+    joiner_trace.Stop();
     float *p_logit = logit.GetTensorMutableData<float>();
     bool emitted = false;
     for (int32_t i = 0; i != n; ++i) {
@@ -67,7 +72,9 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
     }
     if (emitted) {
       Ort::Value decoder_input = model_->BuildDecoderInput(ans, n);
+      ScopedTrace decoder_trace(TraceStage::kDecoder);
       decoder_out = model_->RunDecoder(std::move(decoder_input));
+      decoder_trace.Stop();
     }
     ++t;
   }
@@ -14,6 +14,7 @@
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/packed-sequence.h"
 #include "sherpa-onnx/csrc/slice.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -86,15 +87,19 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     auto decoder_input = model_->BuildDecoderInput(prev, num_hyps);
     // decoder_input shape: (num_hyps, context_size)
 
+    ScopedTrace decoder_trace(TraceStage::kDecoder);
     auto decoder_out = model_->RunDecoder(std::move(decoder_input));
+    decoder_trace.Stop();
     // decoder_out is (num_hyps, joiner_dim)
 
     cur_encoder_out =
         Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
     // now cur_encoder_out is of shape (num_hyps, joiner_dim)
 
+    ScopedTrace joiner_trace(TraceStage::kJoiner);
     Ort::Value logit =
         model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    joiner_trace.Stop();
 
     float *p_logit = logit.GetTensorMutableData<float>();
     if (blank_penalty_ > 0.0) {
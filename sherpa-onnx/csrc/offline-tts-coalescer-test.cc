@@ -0,0 +1,220 @@
+// sherpa-onnx/csrc/offline-tts-coalescer-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-coalescer.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+
+namespace sherpa_onnx {
+
+// If a test reaches it, the synthesis was not stopped
+static constexpr int32_t kMaxNumChunks = 10000;
+
+static void WaitUntil(const std::function<bool()> &cond) {
+  while (!cond()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+TEST(OfflineTtsCoalescer, Coalesce) {
+  OfflineTtsCoalescer coalescer(16000);
+  std::atomic<int32_t> num_generate{0};
+  const int32_t num_followers = 3;
+
+  // Chunk i contains a single sample i. Followers subscribe after the
+  // second chunk, so the samples generated so far are handed over to them
+  auto generate = [&](GeneratedAudioCallback callback) {
+    num_generate += 1;
+    GeneratedAudio audio;
+    audio.sample_rate = 16000;
+    for (int32_t i = 0; i != 5; ++i) {
+      float sample = i;
+      audio.samples.push_back(sample);
+      callback(&sample, 1, (i + 1) / 5.0f);
+
+      if (i == 1) {
+        WaitUntil([&]() { return coalescer.NumCoalesced() == num_followers; });
+      }
+    }
+    return audio;
+  };
+
+  std::vector<std::vector<float>> received(num_followers + 1);
+  std::vector<GeneratedAudio> results(num_followers + 1);
+  auto run = [&](int32_t k) {
+    results[k] = coalescer.Run(
+        OfflineTtsCoalescer::GetKey("hello", 1, 1.0), [&received, k](
+            const float *samples, int32_t n, float /*progress*/) -> int32_t {
+          received[k].insert(received[k].end(), samples, samples + n);
+          return 1;
+        },
+        generate);
+  };
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(run, 0);
+  WaitUntil([&]() { return coalescer.NumSyntheses() == 1; });
+
+  for (int32_t k = 1; k <= num_followers; ++k) {
+    threads.emplace_back(run, k);
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(num_generate, 1);
+  std::vector<float> expected = {0, 1, 2, 3, 4};
+  for (int32_t k = 0; k <= num_followers; ++k) {
+    EXPECT_EQ(received[k], expected);
+    EXPECT_EQ(results[k].samples, expected);
+    EXPECT_EQ(results[k].sample_rate, 16000);
+  }
+
+  // The synthesis has finished, so the next request starts a new one
+  coalescer.Run(OfflineTtsCoalescer::GetKey("hello", 1, 1.0), nullptr,
+                generate);
+  EXPECT_EQ(num_generate, 2);
+
+  // A different key is not coalesced
+  coalescer.Run(OfflineTtsCoalescer::GetKey("hello", 2, 1.0), nullptr,
+                generate);
+  EXPECT_EQ(num_generate, 3);
+}
+
+TEST(OfflineTtsCoalescer, AllSubscribersLeave) {
+  OfflineTtsCoalescer coalescer(16000);
+
+  int32_t num_chunks = 0;
+  bool cancelled = false;
+  auto generate = [&](GeneratedAudioCallback callback) {
+    GeneratedAudio audio;
+    audio.sample_rate = 16000;
+    float sample = 0;
+    // The synthesis runs in its own thread, so it does not wait for the
+    // subscribers. Slow it down until it is stopped.
+    while (num_chunks < kMaxNumChunks && callback(&sample, 1, 0)) {
+      num_chunks += 1;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    cancelled = IsOfflineTtsRequestCancelled();
+    return audio;
+  };
+
+  int32_t num_calls = 0;
+  coalescer.Run("key", [&num_calls](const float *, int32_t, float) {
+        num_calls += 1;
+        return num_calls < 3 ? 1 : 0;
+      }, generate);
+
+  EXPECT_EQ(num_calls, 3);
+  EXPECT_LT(num_chunks, kMaxNumChunks);
+  EXPECT_TRUE(cancelled);
+}
+
+TEST(OfflineTtsCoalescer, CancelledLeader) {
+  OfflineTtsCoalescer coalescer(16000);
+
+  int32_t num_chunks = 0;
+  bool cancelled_at_start = true;
+  bool cancelled = false;
+  auto generate = [&](GeneratedAudioCallback callback) {
+    cancelled_at_start = IsOfflineTtsRequestCancelled();
+    GeneratedAudio audio;
+    audio.sample_rate = 16000;
+    float sample = 0;
+    // The synthesis runs in its own thread, so it does not wait for the
+    // subscribers. Slow it down until it is stopped.
+    while (num_chunks < kMaxNumChunks && callback(&sample, 1, 0)) {
+      num_chunks += 1;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    cancelled = IsOfflineTtsRequestCancelled();
+    return audio;
+  };
+
+  // The synthesis is shared, so it does not see the request of the leader.
+  // The leader leaves it at the first chunk and, as there are no other
+  // subscribers, it is stopped.
+  OfflineTtsRequestOptions options;
+  options.cancellation = std::make_shared<OfflineTtsCancellationToken>();
+  options.cancellation->Cancel();
+  ScopedOfflineTtsRequest scoped_options(&options);
+
+  int32_t num_calls = 0;
+  coalescer.Run("key", [&num_calls](const float *, int32_t, float) {
+        num_calls += 1;
+        return 1;
+      }, generate);
+
+  EXPECT_EQ(num_calls, 0);
+  EXPECT_LT(num_chunks, kMaxNumChunks);
+  EXPECT_FALSE(cancelled_at_start);
+  EXPECT_TRUE(cancelled);
+}
+
+TEST(OfflineTtsCoalescer, SlowLeader) {
+  OfflineTtsCoalescer coalescer(16000);
+  const int32_t num_chunks = 5;
+
+  std::atomic<bool> followed{false};
+  std::atomic<bool> finished{false};
+  auto generate = [&](GeneratedAudioCallback callback) {
+    GeneratedAudio audio;
+    audio.sample_rate = 16000;
+    for (int32_t i = 0; i != num_chunks; ++i) {
+      float sample = i;
+      audio.samples.push_back(sample);
+      callback(&sample, 1, (i + 1) / static_cast<float>(num_chunks));
+
+      if (i == 0) {
+        WaitUntil([&]() { return followed.load(); });
+      }
+    }
+    finished = true;
+    return audio;
+  };
+
+  // The callback of the leader blocks until the synthesis has finished.
+  // If the synthesis waited for the leader, it would never finish.
+  std::vector<float> leader_received;
+  std::thread leader([&]() {
+    coalescer.Run("key", [&](const float *samples, int32_t n, float) {
+          WaitUntil([&]() { return finished.load(); });
+          leader_received.insert(leader_received.end(), samples, samples + n);
+          return 1;
+        }, generate);
+  });
+
+  WaitUntil([&]() { return coalescer.NumSyntheses() == 1; });
+
+  std::vector<float> follower_received;
+  std::thread follower([&]() {
+    coalescer.Run("key", [&](const float *samples, int32_t n, float) {
+          followed = true;
+          follower_received.insert(follower_received.end(), samples,
+                                   samples + n);
+          return 1;
+        }, generate);
+  });
+
+  follower.join();
+  leader.join();
+
+  std::vector<float> expected = {0, 1, 2, 3, 4};
+  EXPECT_EQ(coalescer.NumSyntheses(), 1);
+  EXPECT_EQ(leader_received, expected);
+  EXPECT_EQ(follower_received, expected);
+}
+
+}  // namespace sherpa_onnx
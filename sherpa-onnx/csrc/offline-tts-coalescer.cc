@@ -0,0 +1,229 @@
+// sherpa-onnx/csrc/offline-tts-coalescer.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-coalescer.h"
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+#include "sherpa-onnx/csrc/trace.h"
+
+namespace sherpa_onnx {
+
+struct OfflineTtsCoalescer::Flight {
+  struct Chunk {
+    std::vector<float> samples;
+    float progress = 0;
+  };
+
+  // Options of the synthesis. Its token is cancelled when all subscribers
+  // have left
+  OfflineTtsRequestOptions options;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  // A deque so that a subscriber can use a chunk without holding the mutex
+  // while the synthesis appends new chunks
+  std::deque<Chunk> chunks;
+
+  // Number of subscribers that have not left, including the leader
+  int32_t num_subscribers = 1;
+
+  // True once num_subscribers drops to 0. No one can subscribe after that
+  bool stopping = false;
+
+  // True once the synthesis has finished. result is valid after that
+  bool done = false;
+  GeneratedAudio result;
+};
+
+OfflineTtsCoalescer::OfflineTtsCoalescer(int32_t sample_rate)
+    : sample_rate_(sample_rate) {}
+
+OfflineTtsCoalescer::~OfflineTtsCoalescer() = default;
+
+std::string OfflineTtsCoalescer::GetKey(const std::string &text, int64_t sid,
+                                        float speed) {
+  return std::to_string(sid) + "/" + std::to_string(speed) + "/" + text;
+}
+
+int64_t OfflineTtsCoalescer::NumSyntheses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_syntheses_;
+}
+
+int64_t OfflineTtsCoalescer::NumCoalesced() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_coalesced_;
+}
+
+GeneratedAudio OfflineTtsCoalescer::Run(const std::string &key,
+                                        GeneratedAudioCallback callback,
+                                        const GenerateFunc &generate) {
+  std::shared_ptr<Flight> flight;
+  bool is_leader = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = flights_.find(key);
+    if (it != flights_.end()) {
+      Flight *f = it->second.get();
+      std::lock_guard<std::mutex> flight_lock(f->mutex);
+      if (!f->stopping) {
+        f->num_subscribers += 1;
+        flight = it->second;
+        num_coalesced_ += 1;
+      }
+    }
+
+    if (!flight) {
+      // It replaces a synthesis that is stopping, if any
+      flight = std::make_shared<Flight>();
+      flight->options.priority = CurrentOfflineTtsPriority();
+      flight->options.cancellation =
+          std::make_shared<OfflineTtsCancellationToken>();
+      flights_[key] = flight;
+      num_syntheses_ += 1;
+      is_leader = true;
+    }
+  }
+
+  if (is_leader) {
+    return Lead(key, std::move(flight), std::move(callback), generate);
+  }
+
+  SHERPA_ONNX_LOGT("Coalesced with a running synthesis");
+  return Follow(std::move(flight), std::move(callback));
+}
+
+GeneratedAudio OfflineTtsCoalescer::Lead(const std::string &key,
+                                         std::shared_ptr<Flight> flight,
+                                         GeneratedAudioCallback callback,
+                                         const GenerateFunc &generate) {
+  TraceRequest *trace = CurrentTraceRequest();
+
+  // The synthesis only records chunks, so a slow subscriber, including the
+  // leader, never blocks it
+  std::thread synthesis([this, &key, &flight, &generate, trace]() {
+    ScopedTraceRequest scoped_trace(trace);
+
+    // The synthesis is shared, so it must not be stopped by the request of
+    // the leader. The leader leaves it instead.
+    ScopedOfflineTtsRequest scoped_options(&flight->options);
+
+    GeneratedAudio audio = generate(
+        [&flight](const float *samples, int32_t n, float progress) -> int32_t {
+          {
+            std::lock_guard<std::mutex> lock(flight->mutex);
+            flight->chunks.push_back({{samples, samples + n}, progress});
+          }
+          flight->cv.notify_all();
+
+          return flight->options.IsCancelled() ? 0 : 1;
+        });
+
+    {
+      // New requests of this key start a new synthesis from now on
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = flights_.find(key);
+      if (it != flights_.end() && it->second == flight) {
+        flights_.erase(it);
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(flight->mutex);
+      flight->result = std::move(audio);
+      flight->result.trace.clear();
+      flight->done = true;
+    }
+    flight->cv.notify_all();
+  });
+
+  // The leader consumes the chunks in the same way as the followers
+  GeneratedAudio ans = Follow(flight, std::move(callback));
+
+  // generate may refer to the request of the leader
+  synthesis.join();
+
+  return ans;
+}
+
+GeneratedAudio OfflineTtsCoalescer::Follow(std::shared_ptr<Flight> flight,
+                                           GeneratedAudioCallback callback) {
+  const OfflineTtsRequestOptions *options = CurrentOfflineTtsRequest();
+
+  std::unique_lock<std::mutex> lock(flight->mutex);
+  int32_t i = 0;
+  while (true) {
+    flight->cv.wait(lock, [&flight, i]() {
+      return i < static_cast<int32_t>(flight->chunks.size()) || flight->done;
+    });
+
+    if (i == static_cast<int32_t>(flight->chunks.size())) {
+      break;
+    }
+
+    const Flight::Chunk &chunk = flight->chunks[i];
+    i += 1;
+    lock.unlock();
+
+    int32_t should_continue = 1;
+    if (options && options->IsCancelled()) {
+      should_continue = 0;
+    } else if (callback) {
+      should_continue =
+          callback(chunk.samples.data(),
+                   static_cast<int32_t>(chunk.samples.size()), chunk.progress);
+    }
+
+    lock.lock();
+
+    if (!should_continue) {
+      // Return the audio received so far
+      GeneratedAudio ans;
+      ans.sample_rate = sample_rate_;
+      for (int32_t k = 0; k != i; ++k) {
+        const auto &samples = flight->chunks[k].samples;
+        ans.samples.insert(ans.samples.end(), samples.begin(), samples.end());
+      }
+      lock.unlock();
+
+      Leave(flight.get());
+      return ans;
+    }
+  }
+
+  GeneratedAudio ans = flight->result;
+  lock.unlock();
+
+  Leave(flight.get());
+  return ans;
+}
+
+void OfflineTtsCoalescer::Leave(Flight *flight) {
+  bool cancel = false;
+  {
+    std::lock_guard<std::mutex> lock(flight->mutex);
+    flight->num_subscribers -= 1;
+    if (flight->num_subscribers == 0 && !flight->done) {
+      flight->stopping = true;
+      cancel = true;
+    }
+  }
+
+  if (cancel) {
+    SHERPA_ONNX_LOGT("All subscribers have left. Stop the synthesis");
+    flight->options.cancellation->Cancel();
+  }
+}
+
+}  // namespace sherpa_onnx
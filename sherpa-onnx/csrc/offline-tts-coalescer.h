@@ -0,0 +1,87 @@
+// sherpa-onnx/csrc/offline-tts-coalescer.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_COALESCER_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_COALESCER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+#include "sherpa-onnx/csrc/offline-tts.h"
+
+namespace sherpa_onnx {
+
+// Single-flight coalescing of identical concurrent requests.
+//
+// The first request of a key is called the leader. It starts the
+// synthesis in a new thread. Requests with the same key that arrive while
+// it is running subscribe to it instead of running their own synthesis.
+// The leader is a subscriber as well. Each subscriber gets all chunks of
+// the synthesis, including the ones produced before it subscribed, in its
+// own thread and through its own callback. The synthesis only records the
+// chunks, so a slow subscriber does not slow down the others.
+//
+// The synthesis runs with its own request options: the priority of the
+// leader, no deadline and its own cancellation token. It is cancelled only
+// when all subscribers, including the leader, have left, i.e., their
+// callbacks returned 0 or their requests were cancelled. A subscriber
+// notices that its request is cancelled when the next chunk arrives.
+//
+// Note that the leader stays in Run() until the synthesis finishes, even if
+// it has left, since the synthesis may refer to the request of the leader.
+class OfflineTtsCoalescer {
+ public:
+  // It runs the synthesis and passes the generated audio to the given
+  // callback
+  using GenerateFunc = std::function<GeneratedAudio(GeneratedAudioCallback)>;
+
+  explicit OfflineTtsCoalescer(int32_t sample_rate);
+  ~OfflineTtsCoalescer();
+
+  // @param key Requests with the same key produce the same audio,
+  //            e.g., see GetKey()
+  // @param callback The callback of this request. It can be nullptr.
+  // @param generate It is called only if there is no running synthesis
+  //                 for the key.
+  GeneratedAudio Run(const std::string &key, GeneratedAudioCallback callback,
+                     const GenerateFunc &generate);
+
+  static std::string GetKey(const std::string &text, int64_t sid,
+                            float speed);
+
+  // Number of syntheses that have been started
+  int64_t NumSyntheses() const;
+
+  // Number of requests that subscribed to a running synthesis
+  int64_t NumCoalesced() const;
+
+ private:
+  struct Flight;
+
+  GeneratedAudio Lead(const std::string &key, std::shared_ptr<Flight> flight,
+                      GeneratedAudioCallback callback,
+                      const GenerateFunc &generate);
+
+  GeneratedAudio Follow(std::shared_ptr<Flight> flight,
+                        GeneratedAudioCallback callback);
+
+  // The subscriber will not consume any more chunks
+  static void Leave(Flight *flight);
+
+ private:
+  int32_t sample_rate_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+  int64_t num_syntheses_ = 0;
+  int64_t num_coalesced_ = 0;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_COALESCER_H_
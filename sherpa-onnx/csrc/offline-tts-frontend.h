@@ -50,6 +50,10 @@ struct TokenIDs {
 
   std::vector<float> ja_bert_vec;
   std::vector<std::string> sentences;
+
+  // Used only in MeloTTS Korean. The number of tokens of each BERT token,
+  // counting the blanks added by AddBlank()
+  std::vector<int64_t> word2ph;
 };
 
 class OfflineTtsFrontend {
@@ -71,6 +75,33 @@ class OfflineTtsFrontend {
   virtual std::vector<TokenIDs> ConvertTextToTokenIds(
       const std::string &text, const std::string &voice = "") const = 0;
 
+  // Return true if SplitSentences() can return a non-empty result. It is
+  // used to decide whether to create the thread pool of the task graph.
+  virtual bool SupportsSentenceSplitting() const { return false; }
+
+  /** Split a string into sentences that can be converted independently
+   * with ConvertSentenceToTokenIds() and ComputeBertFeatures(), so that
+   * sentences of a long text can be processed in parallel.
+   *
+   * @return Return an empty vector if the frontend does not support
+   *         converting a single sentence. Use ConvertTextToTokenIds()
+   *         in this case.
+   */
+  virtual std::vector<std::string> SplitSentences(
+      const std::string & /*text*/) const {
+    return {};
+  }
+
+  // G2P of a sentence returned by SplitSentences(). It does not fill
+  // ja_bert_vec of the returned value.
+  virtual TokenIDs ConvertSentenceToTokenIds(
+      const std::string & /*sentence*/) const {
+    return {};
+  }
+
+  // Fill ja_bert_vec of the output of ConvertSentenceToTokenIds()
+  virtual void ComputeBertFeatures(TokenIDs * /*token_ids*/) const {}
+
   // virtual std::vector<float> GetJaBert(const std::string &text) const {
   //   // 기본 구현: 지원하지 않음을 나타내기 위해 비어있는 벡터를 반환하거나,
   //   // 오류 로그를 남기고 빈 벡터를 반환합니다.
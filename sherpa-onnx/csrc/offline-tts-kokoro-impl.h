@@ -22,8 +22,10 @@
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
 #include "sherpa-onnx/csrc/offline-tts-kokoro-model.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/piper-phonemize-lexicon.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -208,6 +210,7 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
     }
 
     if (!tn_list_.empty()) {
+      ScopedTrace trace(TraceStage::kTextNormalization);
       for (const auto &tn : tn_list_) {
         text = tn->Normalize(text);
         if (config_.model.debug) {
@@ -220,8 +223,10 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
       }
     }
 
+    ScopedTrace g2p_trace(TraceStage::kG2P);
     std::vector<TokenIDs> token_ids =
         frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+    g2p_trace.Stop();
 
     if (token_ids.empty() ||
         (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
@@ -286,6 +291,11 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
     int32_t k = 0;
 
     for (int32_t b = 0; b != num_batches && should_continue; ++b) {
+      if (IsOfflineTtsRequestCancelled()) {
+        should_continue = 0;
+        break;
+      }
+
       batch_x.clear();
       for (int32_t i = 0; i != batch_size; ++i, ++k) {
         batch_x.push_back(std::move(x[k]));
@@ -304,6 +314,10 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
       }
     }
 
+    if (IsOfflineTtsRequestCancelled()) {
+      should_continue = 0;
+    }
+
     batch_x.clear();
     while (k < static_cast<int32_t>(x.size()) && should_continue) {
       batch_x.push_back(std::move(x[k]));
@@ -404,7 +418,9 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
     Ort::Value x_tensor = Ort::Value::CreateTensor(
         memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
+    ScopedTrace acoustic_model_trace(TraceStage::kAcousticModel);
     Ort::Value audio = model_->Run(std::move(x_tensor), sid, speed);
+    acoustic_model_trace.Stop();
 
     std::vector<int64_t> audio_shape =
         audio.GetTensorTypeAndShapeInfo().GetShape();
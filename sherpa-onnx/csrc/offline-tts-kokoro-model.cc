@@ -33,10 +33,10 @@ class OfflineTtsKokoroModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto model_buf = ReadFile(config.kokoro.model);
+    sess_ = CreateSession(env_, config.kokoro.model, sess_opts_,
+                          config.session_config, config.provider);
     auto voices_buf = ReadFile(config.kokoro.voices);
-    Init(model_buf.data(), model_buf.size(), voices_buf.data(),
-         voices_buf.size());
+    Init(voices_buf.data(), voices_buf.size());
   }
 
   template <typename Manager>
@@ -106,7 +106,11 @@ class OfflineTtsKokoroModel::Impl {
             size_t voices_data_length) {
     sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
                                            sess_opts_);
+    Init(voices_data, voices_data_length);
+  }
 
+  // sess_ has been created
+  void Init(const char *voices_data, size_t voices_data_length) {
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
     GetOutputNames(sess_.get(), &output_names_, &output_names_ptr_);
@@ -21,9 +21,11 @@
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
 #include "sherpa-onnx/csrc/offline-tts-matcha-model.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/piper-phonemize-lexicon.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/vocoder.h"
 
 namespace sherpa_onnx {
@@ -197,6 +199,7 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
     }
 
     if (!tn_list_.empty()) {
+      ScopedTrace trace(TraceStage::kTextNormalization);
       for (const auto &tn : tn_list_) {
         text = tn->Normalize(text);
         if (config_.model.debug) {
@@ -209,8 +212,10 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       }
     }
 
+    ScopedTrace g2p_trace(TraceStage::kG2P);
     std::vector<TokenIDs> token_ids =
         frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+    g2p_trace.Stop();
 
     if (token_ids.empty() ||
         (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
@@ -274,6 +279,11 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
     int32_t k = 0;
 
     for (int32_t b = 0; b != num_batches && should_continue; ++b) {
+      if (IsOfflineTtsRequestCancelled()) {
+        should_continue = 0;
+        break;
+      }
+
       batch_x.clear();
       for (int32_t i = 0; i != batch_size; ++i, ++k) {
         batch_x.push_back(std::move(x[k]));
@@ -292,6 +302,10 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       }
     }
 
+    if (IsOfflineTtsRequestCancelled()) {
+      should_continue = 0;
+    }
+
     batch_x.clear();
     while (k < static_cast<int32_t>(x.size()) && should_continue) {
       batch_x.push_back(std::move(x[k]));
@@ -377,11 +391,15 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
     Ort::Value x_tensor = Ort::Value::CreateTensor(
         memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
+    ScopedTrace acoustic_model_trace(TraceStage::kAcousticModel);
     Ort::Value mel = model_->Run(std::move(x_tensor), sid, speed);
+    acoustic_model_trace.Stop();
 
     GeneratedAudio ans;
 
+    ScopedTrace vocoder_trace(TraceStage::kVocoder);
     ans.samples = vocoder_->Run(std::move(mel));
+    vocoder_trace.Stop();
     ans.sample_rate = model_->GetMetaData().sample_rate;
 
     float silence_scale = config_.silence_scale;
@@ -22,6 +22,8 @@ void OfflineTtsModelConfig::Register(ParseOptions *po) {
 
   po->Register("provider", &provider,
                "Specify a provider to use: cpu, cuda, coreml");
+
+  session_config.Register(po);
   SHERPA_ONNX_LOGE(">>>> OfflineTtsModelConfig::Register csrc/offline-tts-model-config.cc end");
 }
 
@@ -32,6 +34,10 @@ bool OfflineTtsModelConfig::Validate() const {
     return false;
   }
 
+  if (!session_config.Validate()) {
+    return false;
+  }
+
   if (!vits.model.empty()) {
     return vits.Validate();
   }
@@ -53,7 +59,8 @@ std::string OfflineTtsModelConfig::ToString() const {
   os << "kokoro=" << kokoro.ToString() << ", ";
   os << "num_threads=" << num_threads << ", ";
   os << "debug=" << (debug ? "True" : "False") << ", ";
-  os << "provider=\"" << provider << "\")";
+  os << "provider=\"" << provider << "\", ";
+  os << "session_config=" << session_config.ToString() << ")";
 
   return os.str();
 }
@@ -11,6 +11,7 @@
 #include "sherpa-onnx/csrc/offline-tts-matcha-model-config.h"
 #include "sherpa-onnx/csrc/offline-tts-vits-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/provider-config.h"
 
 namespace sherpa_onnx {
 
@@ -23,6 +24,8 @@ struct OfflineTtsModelConfig {
   bool debug = false;
   std::string provider = "cpu";
 
+  SessionConfig session_config;
+
   OfflineTtsModelConfig() = default;
 
   OfflineTtsModelConfig(const OfflineTtsVitsModelConfig &vits,
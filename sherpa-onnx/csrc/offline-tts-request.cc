@@ -0,0 +1,105 @@
+// sherpa-onnx/csrc/offline-tts-request.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+
+#include <utility>
+
+namespace sherpa_onnx {
+
+namespace {
+
+thread_local const OfflineTtsRequestOptions *current_request = nullptr;
+
+}  // namespace
+
+void OfflineTtsCancellationToken::Cancel() {
+  cancelled_ = true;
+
+  // Callbacks are called with the lock held so that RemoveCallback() does
+  // not return while its callback is running
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &p : callbacks_) {
+    p.second();
+  }
+  callbacks_.clear();
+}
+
+int64_t OfflineTtsCancellationToken::AddCallback(
+    std::function<void()> callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t id = next_id_++;
+
+  // Checked under the lock, so the callback is either called here or by
+  // Cancel()
+  if (cancelled_) {
+    callback();
+    return id;
+  }
+
+  callbacks_.emplace(id, std::move(callback));
+  return id;
+}
+
+void OfflineTtsCancellationToken::RemoveCallback(int64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callbacks_.erase(id);
+}
+
+void OfflineTtsRequestOptions::SetTimeout(int32_t ms) {
+  if (ms <= 0) {
+    deadline = std::chrono::steady_clock::time_point::max();
+    return;
+  }
+
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+}
+
+bool OfflineTtsRequestOptions::IsCancelled() const {
+  if (cancellation && cancellation->IsCancelled()) {
+    return true;
+  }
+
+  return deadline != std::chrono::steady_clock::time_point::max() &&
+         std::chrono::steady_clock::now() >= deadline;
+}
+
+ScopedOfflineTtsRequest::ScopedOfflineTtsRequest(
+    const OfflineTtsRequestOptions *options)
+    : prev_(current_request) {
+  current_request = options;
+}
+
+ScopedOfflineTtsRequest::~ScopedOfflineTtsRequest() {
+  current_request = prev_;
+}
+
+const OfflineTtsRequestOptions *CurrentOfflineTtsRequest() {
+  return current_request;
+}
+
+OfflineTtsPriority CurrentOfflineTtsPriority() {
+  return current_request ? current_request->priority
+                         : OfflineTtsPriority::kInteractive;
+}
+
+bool IsOfflineTtsRequestCancelled() {
+  return current_request && current_request->IsCancelled();
+}
+
+ScopedOfflineTtsCancelCallback::ScopedOfflineTtsCancelCallback(
+    std::function<void()> callback) {
+  if (current_request && current_request->cancellation) {
+    token_ = current_request->cancellation;
+    id_ = token_->AddCallback(std::move(callback));
+  }
+}
+
+ScopedOfflineTtsCancelCallback::~ScopedOfflineTtsCancelCallback() {
+  if (token_) {
+    token_->RemoveCallback(id_);
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,128 @@
+// sherpa-onnx/csrc/offline-tts-request.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_REQUEST_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_REQUEST_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+
+namespace sherpa_onnx {
+
+// Queued work of interactive requests runs before queued work of batch
+// requests. Work that has started is not preempted.
+enum class OfflineTtsPriority : int32_t {
+  kInteractive = 0,
+  kBatch = 1,
+};
+
+constexpr int32_t kNumOfflineTtsPriorities = 2;
+
+// Shared by the caller of OfflineTts::Generate() and the threads working on
+// the request. It is thread-safe.
+class OfflineTtsCancellationToken {
+ public:
+  // Queued work of the request is dropped and running ORT sessions of the
+  // request are terminated. It can be called more than once.
+  void Cancel();
+
+  bool IsCancelled() const { return cancelled_.load(); }
+
+  // callback is called in the thread calling Cancel(). It is called right
+  // away if the token has been cancelled. It must be cheap and must not
+  // use this token.
+  //
+  // @return Return an ID for RemoveCallback().
+  int64_t AddCallback(std::function<void()> callback);
+
+  // callback is not running when it returns
+  void RemoveCallback(int64_t id);
+
+ private:
+  std::atomic<bool> cancelled_{false};
+
+  std::mutex mutex_;
+  int64_t next_id_ = 0;
+  std::map<int64_t, std::function<void()>> callbacks_;
+};
+
+struct OfflineTtsRequestOptions {
+  OfflineTtsPriority priority = OfflineTtsPriority::kInteractive;
+
+  // Optional. Cancel it to drop the rest of the request
+  std::shared_ptr<OfflineTtsCancellationToken> cancellation;
+
+  // Work that has not started by the deadline is dropped. The default
+  // value means no deadline.
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::time_point::max();
+
+  // Set the deadline to ms milliseconds from now. If ms <= 0, there is no
+  // deadline.
+  void SetTimeout(int32_t ms);
+
+  // Return true if the token is cancelled or the deadline has passed
+  bool IsCancelled() const;
+};
+
+// Make options the request options of this thread while this object is
+// alive. The previous one is restored in the destructor.
+//
+// Like ScopedTraceRequest, it is installed in each worker thread that works
+// on the request. See trace.h
+class ScopedOfflineTtsRequest {
+ public:
+  explicit ScopedOfflineTtsRequest(const OfflineTtsRequestOptions *options);
+  ~ScopedOfflineTtsRequest();
+
+  ScopedOfflineTtsRequest(const ScopedOfflineTtsRequest &) = delete;
+  ScopedOfflineTtsRequest &operator=(const ScopedOfflineTtsRequest &) = delete;
+
+ private:
+  const OfflineTtsRequestOptions *prev_;
+};
+
+// Return the request options of this thread. It may be nullptr.
+const OfflineTtsRequestOptions *CurrentOfflineTtsRequest();
+
+// Return the priority of the current request. It is kInteractive if there
+// is no current request.
+OfflineTtsPriority CurrentOfflineTtsPriority();
+
+// Return true if the current request of this thread is cancelled or
+// has passed its deadline.
+bool IsOfflineTtsRequestCancelled();
+
+// Call callback if the token of the current request of this thread is
+// cancelled while this object is alive.
+//
+// Usage:
+//
+//   Ort::RunOptions run_options;
+//   ScopedOfflineTtsCancelCallback on_cancel(
+//       [&run_options]() { run_options.SetTerminate(); });
+//   auto out = sess_->Run(run_options, ...);
+class ScopedOfflineTtsCancelCallback {
+ public:
+  explicit ScopedOfflineTtsCancelCallback(std::function<void()> callback);
+  ~ScopedOfflineTtsCancelCallback();
+
+  ScopedOfflineTtsCancelCallback(const ScopedOfflineTtsCancelCallback &) =
+      delete;
+  ScopedOfflineTtsCancelCallback &operator=(
+      const ScopedOfflineTtsCancelCallback &) = delete;
+
+ private:
+  std::shared_ptr<OfflineTtsCancellationToken> token_;
+  int64_t id_ = -1;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_REQUEST_H_
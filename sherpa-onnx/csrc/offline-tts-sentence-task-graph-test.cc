@@ -0,0 +1,174 @@
+// sherpa-onnx/csrc/offline-tts-sentence-task-graph-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-sentence-task-graph.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+// Each stage appends its index to the text. The last stage converts the
+// text to audio samples so that the order of the output can be checked.
+static std::vector<OfflineTtsSentenceStage> GetStages(
+    std::atomic<int32_t> *num_calls) {
+  auto append = [num_calls](OfflineTtsSentence *s) {
+    *num_calls += 1;
+    s->text += "+";
+  };
+
+  return {append, append, [num_calls](OfflineTtsSentence *s) {
+            *num_calls += 1;
+            // Later sentences finish earlier
+            int32_t i = std::stoi(s->text);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 - i));
+            s->audio.sample_rate = 16000;
+            s->audio.samples = {static_cast<float>(i),
+                                static_cast<float>(s->text.size())};
+          }};
+}
+
+TEST(OfflineTtsSentenceTaskGraph, InOrder) {
+  OfflineTtsSentenceTaskGraph graph(4);
+  std::atomic<int32_t> num_calls{0};
+  auto stages = GetStages(&num_calls);
+
+  std::vector<std::string> sentences = {"0", "1", "2", "3", "4", "5", "6"};
+  std::vector<float> progress;
+  GeneratedAudio audio = graph.Run(
+      sentences, stages, [&progress](const float *, int32_t, float p) {
+        progress.push_back(p);
+        return 1;
+      });
+
+  EXPECT_EQ(num_calls, 3 * 7);
+  EXPECT_EQ(audio.sample_rate, 16000);
+  ASSERT_EQ(audio.samples.size(), 2 * 7);
+  for (int32_t i = 0; i != 7; ++i) {
+    EXPECT_EQ(audio.samples[2 * i], i);
+    // Both of the first two stages are run before the last one
+    EXPECT_EQ(audio.samples[2 * i + 1], 3);
+  }
+
+  ASSERT_EQ(progress.size(), 7);
+  EXPECT_FLOAT_EQ(progress.back(), 1);
+}
+
+TEST(OfflineTtsSentenceTaskGraph, Stop) {
+  OfflineTtsSentenceTaskGraph graph(2);
+  std::atomic<int32_t> num_calls{0};
+  auto stages = GetStages(&num_calls);
+
+  std::vector<std::string> sentences(50, "0");
+  GeneratedAudio audio =
+      graph.Run(sentences, stages,
+                [](const float *, int32_t, float) { return 0; });
+
+  // Only the first sentence is returned and not all stages are run
+  EXPECT_EQ(audio.samples.size(), 2);
+  EXPECT_LT(num_calls, 3 * 50);
+}
+
+TEST(OfflineTtsSentenceTaskGraph, Cancel) {
+  OfflineTtsSentenceTaskGraph graph(2);
+  std::atomic<int32_t> num_calls{0};
+  auto stages = GetStages(&num_calls);
+
+  OfflineTtsRequestOptions options;
+  options.cancellation = std::make_shared<OfflineTtsCancellationToken>();
+
+  int32_t num_callbacks = 0;
+  std::vector<std::string> sentences(50, "0");
+  GeneratedAudio audio;
+  {
+    ScopedOfflineTtsRequest scoped_options(&options);
+    audio = graph.Run(sentences, stages,
+                      [&](const float *, int32_t, float) {
+                        num_callbacks += 1;
+                        if (num_callbacks == 2) {
+                          // e.g., the client disconnects
+                          options.cancellation->Cancel();
+                        }
+                        return 1;
+                      });
+  }
+
+  EXPECT_EQ(num_callbacks, 2);
+  EXPECT_EQ(audio.samples.size(), 2 * 2);
+  EXPECT_LT(num_calls, 3 * 50);
+}
+
+TEST(WorkStealingThreadPool, Priority) {
+  WorkStealingThreadPool pool(1);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool blocked = true;
+  std::vector<int32_t> order;
+
+  // Keep the only worker busy until all tasks are submitted
+  pool.Submit([&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&blocked]() { return !blocked; });
+  });
+
+  auto record = [&](int32_t i) {
+    return [&order, &mutex, i]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(i);
+    };
+  };
+
+  pool.Submit(record(0), OfflineTtsPriority::kBatch);
+  pool.Submit(record(1), OfflineTtsPriority::kBatch);
+  pool.Submit(record(2), OfflineTtsPriority::kInteractive);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    blocked = false;
+  }
+  cv.notify_all();
+
+  while (true) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock(mutex);
+    if (order.size() == 3) {
+      break;
+    }
+  }
+
+  EXPECT_EQ(order, (std::vector<int32_t>{2, 0, 1}));
+}
+
+TEST(OfflineTtsSentenceTaskGraph, ConcurrentRuns) {
+  OfflineTtsSentenceTaskGraph graph(3);
+  std::atomic<int32_t> num_calls{0};
+  auto stages = GetStages(&num_calls);
+
+  std::vector<std::string> sentences = {"0", "1", "2", "3"};
+  std::vector<GeneratedAudio> audios(4);
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i != 4; ++i) {
+    threads.emplace_back(
+        [&, i]() { audios[i] = graph.Run(sentences, stages); });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (const auto &audio : audios) {
+    ASSERT_EQ(audio.samples.size(), 2 * 4);
+    EXPECT_EQ(audio.samples[6], 3);
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,284 @@
+// sherpa-onnx/csrc/offline-tts-sentence-task-graph.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-sentence-task-graph.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/trace.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+// The pool and the index of the worker running on the current thread
+thread_local const WorkStealingThreadPool *tls_pool = nullptr;
+thread_local int32_t tls_worker = -1;
+
+struct RunState {
+  const std::vector<OfflineTtsSentenceStage> *stages = nullptr;
+  std::vector<OfflineTtsSentence> sentences;
+  TraceRequest *request = nullptr;
+  const OfflineTtsRequestOptions *options = nullptr;
+  OfflineTtsPriority priority = OfflineTtsPriority::kInteractive;
+
+  std::atomic<bool> stop{false};
+
+  bool IsStopped() const {
+    return stop || (options && options->IsCancelled());
+  }
+
+  // Protects done and num_running
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<char> done;
+  int32_t num_running = 0;
+};
+
+void ScheduleStage(WorkStealingThreadPool *pool, RunState *state, int32_t i,
+                   int32_t k) {
+  auto task = [pool, state, i, k]() {
+    // Stages run by the workers are counted in the request of the caller
+    ScopedTraceRequest scoped_request(state->request);
+    ScopedOfflineTtsRequest scoped_options(state->options);
+
+    const auto &stages = *state->stages;
+    bool ok = false;
+    if (!state->IsStopped()) {
+      try {
+        stages[k](&state->sentences[i]);
+        ok = true;
+      } catch (const std::exception &e) {
+        SHERPA_ONNX_LOGE("Stage %d of sentence %d failed: %s", k, i,
+                         e.what());
+      } catch (...) {
+        SHERPA_ONNX_LOGE("Stage %d of sentence %d failed", k, i);
+      }
+    }
+
+    if (ok && !state->IsStopped() &&
+        k + 1 < static_cast<int32_t>(stages.size())) {
+      ScheduleStage(pool, state, i, k + 1);
+      return;
+    }
+
+    // Notify with the lock held. Otherwise, Run() may return and destroy
+    // state before notify_all() is called
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->done[i] = 1;
+    state->num_running -= 1;
+    state->cv.notify_all();
+  };
+
+  pool->Submit(std::move(task), state->priority);
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(int32_t num_threads) {
+  num_threads = std::max(num_threads, 1);
+
+  workers_.reserve(num_threads);
+  for (int32_t i = 0; i != num_threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+
+  threads_.reserve(num_threads);
+  for (int32_t i = 0; i != num_threads; ++i) {
+    threads_.emplace_back([this, i]() { Loop(i); });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+
+  for (auto &t : threads_) {
+    t.join();
+  }
+}
+
+void WorkStealingThreadPool::Submit(std::function<void()> task,
+                                    OfflineTtsPriority priority) {
+  int32_t p = static_cast<int32_t>(priority);
+  if (tls_pool == this) {
+    auto &w = *workers_[tls_worker];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    w.tasks[p].push_back(std::move(task));
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shared_[p].push_back(std::move(task));
+  }
+
+  {
+    // Under the lock so that a worker cannot miss the notification between
+    // checking num_pending_ and going to sleep
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_pending_ += 1;
+  }
+  cv_.notify_one();
+}
+
+bool WorkStealingThreadPool::Pop(int32_t i, std::function<void()> *task) {
+  for (int32_t p = 0; p != kNumOfflineTtsPriorities; ++p) {
+    if (Pop(i, p, task)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool WorkStealingThreadPool::Pop(int32_t i, int32_t priority,
+                                 std::function<void()> *task) {
+  {
+    auto &tasks = workers_[i]->tasks[priority];
+    std::lock_guard<std::mutex> lock(workers_[i]->mutex);
+    if (!tasks.empty()) {
+      *task = std::move(tasks.back());
+      tasks.pop_back();
+      num_pending_ -= 1;
+      return true;
+    }
+  }
+
+  {
+    auto &tasks = shared_[priority];
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tasks.empty()) {
+      *task = std::move(tasks.front());
+      tasks.pop_front();
+      num_pending_ -= 1;
+      return true;
+    }
+  }
+
+  int32_t n = static_cast<int32_t>(workers_.size());
+  for (int32_t k = 1; k != n; ++k) {
+    auto &w = *workers_[(i + k) % n];
+    auto &tasks = w.tasks[priority];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (!tasks.empty()) {
+      *task = std::move(tasks.front());
+      tasks.pop_front();
+      num_pending_ -= 1;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void WorkStealingThreadPool::Loop(int32_t i) {
+  tls_pool = this;
+  tls_worker = i;
+
+  while (true) {
+    std::function<void()> task;
+    if (Pop(i, &task)) {
+      try {
+        task();
+      } catch (const std::exception &e) {
+        SHERPA_ONNX_LOGE("Exception in worker %d: %s", i, e.what());
+      } catch (...) {
+        SHERPA_ONNX_LOGE("Unknown exception in worker %d", i);
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return stop_ || num_pending_ > 0; });
+    if (stop_ && num_pending_ <= 0) {
+      return;
+    }
+  }
+}
+
+OfflineTtsSentenceTaskGraph::OfflineTtsSentenceTaskGraph(int32_t num_threads)
+    : pool_(num_threads) {
+  SHERPA_ONNX_LOGD("Sentence task graph with %d threads", pool_.NumThreads());
+}
+
+GeneratedAudio OfflineTtsSentenceTaskGraph::Run(
+    const std::vector<std::string> &sentences,
+    const std::vector<OfflineTtsSentenceStage> &stages,
+    GeneratedAudioCallback callback) {
+  GeneratedAudio ans;
+  ans.sample_rate = 0;
+
+  int32_t n = static_cast<int32_t>(sentences.size());
+  if (n == 0 || stages.empty()) {
+    return ans;
+  }
+
+  RunState state;
+  state.stages = &stages;
+  state.request = CurrentTraceRequest();
+  state.options = CurrentOfflineTtsRequest();
+  state.priority = CurrentOfflineTtsPriority();
+  state.sentences.resize(n);
+  for (int32_t i = 0; i != n; ++i) {
+    state.sentences[i].text = sentences[i];
+  }
+  state.done.resize(n, 0);
+  state.num_running = n;
+
+  // Sentences enter the shared queue in order, so earlier sentences start
+  // first and the audio is ready roughly in the order it is emitted
+  for (int32_t i = 0; i != n; ++i) {
+    ScheduleStage(&pool_, &state, i, 0);
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    {
+      std::unique_lock<std::mutex> lock(state.mutex);
+      state.cv.wait(lock, [&state, i]() { return state.done[i] != 0; });
+    }
+
+    if (state.IsStopped()) {
+      SHERPA_ONNX_LOGD("Request is cancelled at sentence %d of %d", i, n);
+      break;
+    }
+
+    const auto &audio = state.sentences[i].audio;
+    if (audio.samples.empty()) {
+      SHERPA_ONNX_LOGW("No audio is generated for sentence %d: %s", i,
+                       sentences[i].c_str());
+      continue;
+    }
+
+    if (ans.sample_rate == 0) {
+      ans.sample_rate = audio.sample_rate;
+    }
+
+    ans.samples.insert(ans.samples.end(), audio.samples.begin(),
+                       audio.samples.end());
+
+    if (callback) {
+      int32_t should_continue = callback(audio.samples.data(),
+                                         audio.samples.size(), (i + 1.0) / n);
+      if (!should_continue) {
+        state.stop = true;
+        break;
+      }
+    }
+
+    // Release the memory of this sentence as early as possible
+    state.sentences[i] = {};
+  }
+
+  // Tasks of this call use state, so wait for all of them to finish
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.cv.wait(lock, [&state]() { return state.num_running == 0; });
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
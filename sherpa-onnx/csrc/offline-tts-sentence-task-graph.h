@@ -0,0 +1,121 @@
+// sherpa-onnx/csrc/offline-tts-sentence-task-graph.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_SENTENCE_TASK_GRAPH_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_SENTENCE_TASK_GRAPH_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-tts-frontend.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+
+namespace sherpa_onnx {
+
+// A thread pool in which each worker has its own queue.
+//
+// A task submitted from a worker is pushed to the back of the queue of that
+// worker and the worker takes tasks from the back of its own queue first, so
+// the follow-up task of a task usually runs on the same thread right after
+// it. Tasks submitted from other threads go to a shared queue and are taken
+// in FIFO order. An idle worker steals tasks from the front of the queues of
+// other workers.
+//
+// Each queue is split by priority. A worker looks for an interactive task
+// in all of the queues in the above order before it takes a batch task.
+class WorkStealingThreadPool {
+ public:
+  explicit WorkStealingThreadPool(int32_t num_threads);
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+  WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+  void Submit(std::function<void()> task,
+              OfflineTtsPriority priority = OfflineTtsPriority::kInteractive);
+
+  int32_t NumThreads() const { return static_cast<int32_t>(threads_.size()); }
+
+ private:
+  using TaskQueue = std::deque<std::function<void()>>;
+
+  struct Worker {
+    std::mutex mutex;
+    TaskQueue tasks[kNumOfflineTtsPriorities];
+  };
+
+  // Return false if there are no tasks in any of the queues
+  bool Pop(int32_t i, std::function<void()> *task);
+
+  // Return false if there are no tasks of the given priority
+  bool Pop(int32_t i, int32_t priority, std::function<void()> *task);
+
+  void Loop(int32_t i);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  // Protects shared_ and stop_. Workers sleep on cv_
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  TaskQueue shared_[kNumOfflineTtsPriorities];
+  bool stop_ = false;
+
+  // Number of tasks in all of the queues
+  std::atomic<int64_t> num_pending_{0};
+};
+
+// A sentence of the input text and the results of the stages run on it.
+struct OfflineTtsSentence {
+  std::string text;
+  TokenIDs token_ids;
+  GeneratedAudio audio;
+};
+
+// A stage, e.g., G2P, BERT or the acoustic model, reads and updates the
+// given sentence.
+using OfflineTtsSentenceStage = std::function<void(OfflineTtsSentence *)>;
+
+// Each sentence of a text is a chain of stages. Stages of a sentence run
+// one after another and stages of different sentences run in parallel on a
+// WorkStealingThreadPool, which is shared by all calls of Run().
+class OfflineTtsSentenceTaskGraph {
+ public:
+  explicit OfflineTtsSentenceTaskGraph(int32_t num_threads);
+
+  /** Run the stages on each sentence.
+   *
+   * @param sentences Sentences of the input text.
+   * @param stages The stages to run on each sentence. The last stage is
+   *               expected to fill OfflineTtsSentence::audio.
+   * @param callback If not null, it is called in the calling thread with
+   *                 the audio of each sentence in the order of sentences.
+   *                 If it returns 0, stages that have not started are
+   *                 skipped and Run() returns.
+   *
+   * Stages run with the priority of the current request of the calling
+   * thread. If the request is cancelled, stages that have not started are
+   * skipped and Run() returns. See offline-tts-request.h
+   *
+   * @return Return the audio of all sentences that are passed to the
+   *         callback.
+   */
+  GeneratedAudio Run(const std::vector<std::string> &sentences,
+                     const std::vector<OfflineTtsSentenceStage> &stages,
+                     GeneratedAudioCallback callback = nullptr);
+
+ private:
+  WorkStealingThreadPool pool_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_SENTENCE_TASK_GRAPH_H_
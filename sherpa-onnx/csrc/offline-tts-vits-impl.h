@@ -4,9 +4,11 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_VITS_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_TTS_VITS_IMPL_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <strstream>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -22,9 +24,12 @@
 #include "sherpa-onnx/csrc/offline-tts-character-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+#include "sherpa-onnx/csrc/offline-tts-sentence-task-graph.h"
 #include "sherpa-onnx/csrc/offline-tts-vits-model.h"
 #include "sherpa-onnx/csrc/piper-phonemize-lexicon.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -34,8 +39,9 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       : config_(config),
         model_(std::make_unique<OfflineTtsVitsModel>(config.model)) {
     InitFrontend();
+    InitSentencePipeline();
 
-    SHERPA_ONNX_LOGE("!!OfflineTtsVitsImpl//Create model:");
+    SHERPA_ONNX_LOGD("!!OfflineTtsVitsImpl//Create model:");
 
     if (!config.rule_fsts.empty()) {
       std::vector<std::string> files;
@@ -90,20 +96,10 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
   template <typename Manager>
   OfflineTtsVitsImpl(Manager *mgr, const OfflineTtsConfig &config)
       : config_(config),
-        model_(std::make_unique<OfflineTtsVitsModel>(mgr, config.model)),
-        synthesizer_processor_(std::make_unique<SynthesizerProcessor>(
-            [this](const std::string &text_arg,
-                   std::vector<float> &ja_bert_vec_arg,
-                   const std::vector<int64_t> &tokens_arg,
-                   const std::vector<int64_t> &tones_arg, int32_t sid_arg,
-                   float speed_arg) -> GeneratedAudio {
-              return this->ProcessWithJaBert(text_arg, ja_bert_vec_arg,
-                                             tokens_arg, tones_arg, sid_arg,
-                                             speed_arg);
-            },
-            std::thread::hardware_concurrency())) {
-    SHERPA_ONNX_LOGE(">>>> OfflineTtsVitsImpl constructor");
+        model_(std::make_unique<OfflineTtsVitsModel>(mgr, config.model)) {
+    SHERPA_ONNX_LOGD(">>>> OfflineTtsVitsImpl constructor");
     InitFrontend(mgr);
+    InitSentencePipeline();
 
     if (!config.rule_fsts.empty()) {
       std::vector<std::string> files;
@@ -167,12 +163,12 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
   GeneratedAudio Generate(
       const std::string &_text, int64_t sid = 0, float speed = 1.0,
       GeneratedAudioCallback callback = nullptr) const override {
-    SHERPA_ONNX_LOGE(">>> Generate offline-tts-vits start");
+    SHERPA_ONNX_LOGD(">>> Generate offline-tts-vits start");
     const auto &meta_data = model_->GetMetaData();
     int32_t num_speakers = meta_data.num_speakers;
 
-    SHERPA_ONNX_LOGE("sid: %d", static_cast<int32_t>(sid));
-    SHERPA_ONNX_LOGE("speed: %f", speed);
+    SHERPA_ONNX_LOGD("sid: %d", static_cast<int32_t>(sid));
+    SHERPA_ONNX_LOGD("speed: %f", speed);
     if (num_speakers == 0 && sid != 0) {
 #if __OHOS__
       SHERPA_ONNX_LOGE(
@@ -212,6 +208,7 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     }
 
     if (!tn_list_.empty()) {
+      ScopedTrace trace(TraceStage::kTextNormalization);
       for (const auto &tn : tn_list_) {
         text = tn->Normalize(text);
         if (config_.model.debug) {
@@ -224,9 +221,28 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       }
     }
 
+    std::vector<std::string> split;
+    if (task_graph_) {
+      split = frontend_->SplitSentences(text);
+      int32_t n = static_cast<int32_t>(split.size());
+      if (n > 1 && config_.max_num_sentences > 0 &&
+          n > config_.max_num_sentences) {
+        return GenerateWithTaskGraph(split, sid, speed, std::move(callback));
+      }
+    }
+
     /// ConvertTextToTokenIdsKorean
+    ScopedTrace g2p_trace(TraceStage::kG2P);
+    // Reuse the sentences from above instead of splitting the text again
     std::vector<TokenIDs> token_ids =
-        frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+        split.empty() ? frontend_->ConvertTextToTokenIds(text, meta_data.voice)
+                      : ConvertSentencesToTokenIds(split);
+    g2p_trace.Stop();
+
+    if (IsOfflineTtsRequestCancelled()) {
+      SHERPA_ONNX_LOGD("Request is cancelled after G2P");
+      return {};
+    }
 
     // std::vector<std::string> sentences = to
 
@@ -247,18 +263,18 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
         max_len_idx = i;
       }
     }
-    SHERPA_ONNX_LOGE("max_len_idx: %ld of %ld", max_len_idx, token_ids.size());
+    SHERPA_ONNX_LOGD("max_len_idx: %ld of %ld", max_len_idx, token_ids.size());
 
     phone_ids.reserve(token_ids.size());
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         "this from ConvertTextToTokenIdsKorean ; tokens.size(): %zu",
         token_ids[0].tokens.size());
     for (int i = 0; i < token_ids.size(); i++) {
       phone_ids.push_back(std::move(token_ids[i].tokens));
-      SHERPA_ONNX_LOGE("index:%d, phone_ids[i].size: %zu", i,
+      SHERPA_ONNX_LOGT("index:%d, phone_ids[i].size: %zu", i,
                        phone_ids[i].size());
     }
-    SHERPA_ONNX_LOGE(">>>>> 0 phone_ids.size(): %zu", phone_ids.size());
+    SHERPA_ONNX_LOGD(">>>>> 0 phone_ids.size(): %zu", phone_ids.size());
 
     // if (!token_ids[0].tones.empty()) {
     tones.reserve(token_ids.size());
@@ -271,15 +287,17 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       ja_berts.push_back(std::move(i.ja_bert_vec));
     }
     // print ja_berts
-    for (int i = 0; i < ja_berts.size(); i++) {
-      SHERPA_ONNX_LOGE("index: %d,ja_bert.size: %zu", i, ja_berts[i].size());
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      for (int i = 0; i < ja_berts.size(); i++) {
+        SHERPA_ONNX_LOGT("index: %d,ja_bert.size: %zu", i, ja_berts[i].size());
+      }
     }
     sentences.reserve(token_ids.size());
     for (int i = 0; i < token_ids.size(); i++) {
       // sentences.push_back(std::move(i.sentences));
       sentences.insert(sentences.end(), token_ids[i].sentences.begin(),
                        token_ids[i].sentences.end());
-      SHERPA_ONNX_LOGE("index: %d,sentences:#%s#", i, sentences[i].c_str());
+      SHERPA_ONNX_LOGT("index: %d,sentences:#%s#", i, sentences[i].c_str());
     }
 
     // TODO(fangjun): add blank inside the frontend, not here
@@ -296,23 +314,23 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       // 이걸 기준으로 ja_bert_vec 또한 해줘야함
       /// melo-tts-lexicon.cc ConvertTextToTokenIdsKorean 에서 미리 처리함
     }
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>> 1 phone_ids.size(): %zu, config._max_num_sentences: %zu",
         phone_ids.size(), config_.max_num_sentences);
 
     int32_t x_size = static_cast<int32_t>(phone_ids.size());
 
     if (config_.max_num_sentences <= 0 || x_size <= config_.max_num_sentences) {
-      SHERPA_ONNX_LOGE(">>> Process all sentences offline-tts-vits create 0");
+      SHERPA_ONNX_LOGD(">>> Process all sentences offline-tts-vits create 0");
       // std::vector<float> ja_bert_vec = token_ids[0].ja_bert_vec;
       auto ans = ProcessWithJaBert(text, ja_berts[0], phone_ids[0], tones[0],
                                    sid, speed);
-      SHERPA_ONNX_LOGE(">>> Process all sentences offline-tts-vits created end 0");
+      SHERPA_ONNX_LOGD(">>> Process all sentences offline-tts-vits created end 0");
       if (callback) {
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             ">>> Process all sentences offline-tts-vits callback 0");
         callback(ans.samples.data(), ans.samples.size(), 1.0);
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             ">>> Process all sentences offline-tts-vits callback 0");
       }
       return ans;
@@ -352,7 +370,7 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     // GeneratedAudio ans;
     int32_t should_continue_flag = 1;  // 변수명 충돌 방지
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         "Text is too long Start processing sentences concurrently...");
 
     // 1. SynthesizerProcessor 객체 생성 (한 번만 생성하고 재사용하는 것이
@@ -475,6 +493,11 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     //     // the callback returns to avoid segmentation fault.
     //   }
     // }
+    if (!synthesizer_processor_) {
+      return ProcessSentencesSerially(sentences, ja_berts, phone_ids, tones,
+                                      sid, speed, callback);
+    }
+
     GeneratedAudio ans = synthesizer_processor_->ProcessAllSentences(
             sentences,
             ja_berts,
@@ -492,7 +515,7 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
             }
         );
     //     return ans;
-    SHERPA_ONNX_LOGE("Finished processing sentences");
+    SHERPA_ONNX_LOGD("Finished processing sentences");
 
     // SHERPA_ONNX_LOGE("Start processing the remaining sentences");
     // batch_x.clear();
@@ -530,12 +553,136 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     // }
     // SHERPA_ONNX_LOGE("Finished processing the last batch");
 
-    SHERPA_ONNX_LOGE("Finished processing all sentences");
+    SHERPA_ONNX_LOGD("Finished processing all sentences");
     return ans;
   }
 
  private:
+  // At most one thread pool is created, since its threads compete with the
+  // intra-op threads of onnxruntime and multiply with the number of
+  // OfflineTts instances
+  void InitSentencePipeline() {
+    if (config_.sentence_pipeline == "serial") {
+      return;
+    }
+
+    int32_t num_threads =
+        std::max<int32_t>(std::thread::hardware_concurrency(), 1);
+
+    // The task graph needs a frontend that supports SplitSentences(), e.g.,
+    // MeloTTS Korean. Texts that it cannot split are processed serially.
+    if (config_.sentence_pipeline == "task-graph" &&
+        frontend_->SupportsSentenceSplitting()) {
+      task_graph_ = std::make_unique<OfflineTtsSentenceTaskGraph>(num_threads);
+      return;
+    }
+
+    // synthesis, or task-graph with other frontends
+    synthesizer_processor_ = std::make_unique<SynthesizerProcessor>(
+        [this](const std::string &text, std::vector<float> &ja_bert_vec,
+               const std::vector<int64_t> &tokens,
+               const std::vector<int64_t> &tones, int32_t sid,
+               float speed) -> GeneratedAudio {
+          return ProcessWithJaBert(text, ja_bert_vec, tokens, tones, sid,
+                                   speed);
+        },
+        num_threads);
+  }
+
+  // Same as ConvertTextToTokenIds() for sentences from SplitSentences()
+  std::vector<TokenIDs> ConvertSentencesToTokenIds(
+      const std::vector<std::string> &sentences) const {
+    std::vector<TokenIDs> ans;
+    ans.reserve(sentences.size());
+
+    for (const auto &s : sentences) {
+      if (IsOfflineTtsRequestCancelled()) {
+        break;
+      }
+
+      TokenIDs token_ids = frontend_->ConvertSentenceToTokenIds(s);
+      frontend_->ComputeBertFeatures(&token_ids);
+      ans.push_back(std::move(token_ids));
+    }
+
+    return ans;
+  }
+
+  bool NeedsBlank() const {
+    const auto &meta_data = model_->GetMetaData();
+    return meta_data.add_blank && config_.model.vits.data_dir.empty() &&
+           meta_data.frontend != "characters";
+  }
+
+  // G2P -> BERT -> acoustic model of each sentence run as a chain on the
+  // task graph. See offline-tts-sentence-task-graph.h
+  GeneratedAudio GenerateWithTaskGraph(
+      const std::vector<std::string> &sentences, int64_t sid, float speed,
+      GeneratedAudioCallback callback) const {
+    SHERPA_ONNX_LOGD("Process %d sentences with the task graph",
+                     static_cast<int32_t>(sentences.size()));
+
+    bool add_blank = NeedsBlank();
+
+    std::vector<OfflineTtsSentenceStage> stages = {
+        [this](OfflineTtsSentence *s) {
+          ScopedTrace trace(TraceStage::kG2P);
+          s->token_ids = frontend_->ConvertSentenceToTokenIds(s->text);
+        },
+        [this](OfflineTtsSentence *s) {
+          if (!s->token_ids.tokens.empty()) {
+            frontend_->ComputeBertFeatures(&s->token_ids);
+          }
+        },
+        [this, add_blank, sid, speed](OfflineTtsSentence *s) {
+          auto &ids = s->token_ids;
+          if (ids.tokens.empty()) {
+            return;
+          }
+
+          if (add_blank) {
+            ids.tokens = AddBlank(ids.tokens);
+            ids.tones = AddBlank(ids.tones);
+          }
+
+          s->audio = ProcessWithJaBert(s->text, ids.ja_bert_vec, ids.tokens,
+                                       ids.tones, sid, speed);
+        },
+    };
+
+    return task_graph_->Run(sentences, stages, std::move(callback));
+  }
+
+  GeneratedAudio ProcessSentencesSerially(
+      const std::vector<std::string> &sentences,
+      std::vector<std::vector<float>> &ja_berts,
+      const std::vector<std::vector<int64_t>> &phone_ids,
+      const std::vector<std::vector<int64_t>> &tones, int32_t sid,
+      float speed, GeneratedAudioCallback callback) const {
+    GeneratedAudio ans;
+    ans.sample_rate = model_->GetMetaData().sample_rate;
+
+    int32_t n = static_cast<int32_t>(phone_ids.size());
+    for (int32_t i = 0; i != n && !IsOfflineTtsRequestCancelled(); ++i) {
+      const std::string &text = i < static_cast<int32_t>(sentences.size())
+                                    ? sentences[i]
+                                    : std::string();
+      auto audio = ProcessWithJaBert(text, ja_berts[i], phone_ids[i], tones[i],
+                                     sid, speed);
+      ans.samples.insert(ans.samples.end(), audio.samples.begin(),
+                         audio.samples.end());
+      if (callback &&
+          !callback(audio.samples.data(), audio.samples.size(),
+                    (i + 1.0) / n)) {
+        break;
+      }
+    }
+
+    return ans;
+  }
+
   std::unique_ptr<SynthesizerProcessor> synthesizer_processor_;
+  std::unique_ptr<OfflineTtsSentenceTaskGraph> task_graph_;
 
   template <typename Manager>
   void InitFrontend(Manager *mgr) {
@@ -546,19 +693,19 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     // hack: melo-tts-korean용
     // prrint
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> InitFrontEnd csrc/offline-tts-vits-impl.h meta_data.frontend: "
         "%s ",
         meta_data.frontend.c_str());
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> InitFrontEnd csrc/offline-tts-vits-impl.h "
         "config_.model.vits.model: %s",
         config_.model.vits.model.c_str());
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> InitFrontEnd csrc/offline-tts-vits-impl.h "
         "config_.model.vits.lexicon: %s",
         config_.model.vits.lexicon.c_str());
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> InitFrontEnd csrc/offline-tts-vits-impl.h "
         "config_.model.vits.tokens: %s",
         config_.model.vits.tokens.c_str());
@@ -580,49 +727,49 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     // 경로를 타도록 합니다. lexicon과 tokens 경로는 config.json에서 가져오므로
     // 그대로 사용합니다.
     if (meta_data.is_melo_tts && meta_data.language == "Korean") {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           "!!InitFrontEnd create init MeloTtsLexicon for Korean: New Path");
       frontend_ = std::make_unique<MeloTtsLexicon>(
           mgr, config_.model.vits.lexicon, config_.model.vits.tokens,
           config_.model.vits.ja_bert_model, config_.model.vits.vocab,
           model_->GetMetaData(), config_.model.debug);
     } else if (meta_data.frontend == "characters") {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           "!!InitFrontEnd create init OfflineTtsCharacterFrontend:1 ");
       frontend_ = std::make_unique<OfflineTtsCharacterFrontend>(
           mgr, config_.model.vits.tokens, meta_data);
     } else if (meta_data.jieba && !config_.model.vits.dict_dir.empty() &&
                meta_data.is_melo_tts) {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           "!!InitFrontEnd create init OfflineTtsCharacterFrontend:2 ");
       frontend_ = std::make_unique<MeloTtsLexicon>(
           mgr, config_.model.vits.lexicon, config_.model.vits.tokens,
           config_.model.vits.dict_dir, model_->GetMetaData(),
           config_.model.debug);
     } else if (meta_data.jieba && !config_.model.vits.dict_dir.empty()) {
-      SHERPA_ONNX_LOGE("!!InitFrontEnd create init JiebaLexicon:3 ");
+      SHERPA_ONNX_LOGD("!!InitFrontEnd create init JiebaLexicon:3 ");
       frontend_ = std::make_unique<JiebaLexicon>(
           mgr, config_.model.vits.lexicon, config_.model.vits.tokens,
           config_.model.vits.dict_dir, config_.model.debug);
     } else if (meta_data.is_melo_tts && meta_data.language == "English") {
-      SHERPA_ONNX_LOGE("!!InitFrontEnd create init MeloTtsLexicon:4 ");
+      SHERPA_ONNX_LOGD("!!InitFrontEnd create init MeloTtsLexicon:4 ");
       frontend_ = std::make_unique<MeloTtsLexicon>(
           mgr, config_.model.vits.lexicon, config_.model.vits.tokens,
           model_->GetMetaData(), config_.model.debug);
     } else if ((meta_data.is_piper || meta_data.is_coqui ||
                 meta_data.is_icefall) &&
                !config_.model.vits.data_dir.empty()) {
-      SHERPA_ONNX_LOGE("!!InitFrontEnd create init PiperPhonemizeLexicon:5 ");
+      SHERPA_ONNX_LOGD("!!InitFrontEnd create init PiperPhonemizeLexicon:5 ");
       frontend_ = std::make_unique<PiperPhonemizeLexicon>(
           mgr, config_.model.vits.tokens, config_.model.vits.data_dir,
           meta_data);
     } else if (meta_data.is_melo_tts) {
-      SHERPA_ONNX_LOGE("!!InitFrontEnd create init MeloTtsLexicon:6 ");
+      SHERPA_ONNX_LOGD("!!InitFrontEnd create init MeloTtsLexicon:6 ");
       frontend_ = std::make_unique<MeloTtsLexicon>(
           mgr, config_.model.vits.lexicon, config_.model.vits.tokens,
           model_->GetMetaData(), config_.model.debug);
     } else {
-      SHERPA_ONNX_LOGE("!!InitFrontEnd create init Lexicon:6 ");
+      SHERPA_ONNX_LOGD("!!InitFrontEnd create init Lexicon:6 ");
       if (config_.model.vits.lexicon.empty()) {
         SHERPA_ONNX_LOGE(
             "Not a model using characters as modeling unit. Please provide "
@@ -692,8 +839,13 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
                                    const std::vector<int64_t> &tokens,
                                    const std::vector<int64_t> &tones,
                                    int32_t sid, float speed) const {
-    SHERPA_ONNX_LOGE(" >>> text Process offline-tts-vits-impl.h start");
-    SHERPA_ONNX_LOGE(">>> Process text:%s,ja_bert_vec:%zu", text.c_str(),
+    SHERPA_ONNX_LOGD(" >>> text Process offline-tts-vits-impl.h start");
+    if (IsOfflineTtsRequestCancelled()) {
+      // Skip the model of a sentence of a cancelled request
+      return GeneratedAudio{};
+    }
+
+    SHERPA_ONNX_LOGD(">>> Process text:%s,ja_bert_vec:%zu", text.c_str(),
                      ja_bert_vec.size());
 
     // int32_t num_tokens = 0;
@@ -710,13 +862,15 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       phone_ids.insert(phone_ids.end(), tokens.begin(), tokens.end());
       // for (const auto &k : tokens) {
       // }
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h phone_ids.size() %d",
           phone_ids.size());
-      for (int i = 0; i < 10; i++) {
-        SHERPA_ONNX_LOGE(
-            " >>> Process offline-tts-vits-impl.h phone_ids[%d] %d", i,
-            phone_ids[i]);
+      if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+        for (int i = 0; i < std::min<size_t>(10, phone_ids.size()); i++) {
+          SHERPA_ONNX_LOGT(
+              " >>> Process offline-tts-vits-impl.h phone_ids[%d] %d", i,
+              phone_ids[i]);
+        }
       }
 
       std::vector<int64_t> tone_list;
@@ -729,7 +883,7 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       //     tone_list.insert(tone_list.end(), k.begin(), k.end());
       //   }
       // }
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h tone_list.size() %d",
           tone_list.size());
 
@@ -741,30 +895,30 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       // SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h sid %d", sid);
       // SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h speed %f",
       // speed);
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h memory_info  start");
       auto memory_info =
           Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-      SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h memory_info end ");
+      SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h memory_info end ");
 
       std::array<int64_t, 2> x_shape = {1,
                                         static_cast<int32_t>(phone_ids.size())};
-      SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h x_shape[0] %d",
+      SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h x_shape[0] %d",
                        x_shape[0]);
-      SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h x_shape[1] %d",
+      SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h x_shape[1] %d",
                        x_shape[1]);
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h phone_ids.size() %d",
           phone_ids.size());
       Ort::Value x_tensor = Ort::Value::CreateTensor(
           memory_info, phone_ids.data(), phone_ids.size(), x_shape.data(),
           x_shape.size());
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h "
           "x_tensor.GetTensorTypeAndShapeInfo().GetShape()[0] %d",
           x_tensor.GetTensorTypeAndShapeInfo().GetShape()[0]);
 
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h "
           "x_tensor.GetTensorTypeAndShapeInfo().GetShape()[1] %d",
           x_tensor.GetTensorTypeAndShapeInfo().GetShape()[1]);
@@ -773,39 +927,42 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
         tones_tensor = Ort::Value::CreateTensor(memory_info, tone_list.data(),
                                                 tone_list.size(),
                                                 x_shape.data(), x_shape.size());
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             " >>> Process offline-tts-vits-impl.h "
             "tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[0] %d",
             tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[0]);
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             " >>> Process offline-tts-vits-impl.h "
             "tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[1] %d",
             tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[1]);
       }
 
+      // VITS generates audio directly, so the vocoder is included
+      ScopedTrace acoustic_model_trace(TraceStage::kAcousticModel);
       Ort::Value audio{nullptr};
       if (tones.empty()) {
-        SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h no tones");
+        SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h no tones");
         audio = model_->Run(std::move(x_tensor), sid, speed);
       } else {
-        SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h has tones");
+        SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h has tones");
         // audio =
         //     model_->Run(std::move(x_tensor), std::move(tones_tensor), sid,
         //     speed);
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             ">>>> Process offline-tts-vits-impl.h has tones ja_bert_vec.size() "
             "%d",
             ja_bert_vec.size());
         audio = model_->Run(text, ja_bert_vec, std::move(x_tensor),
                             std::move(tones_tensor), sid, speed);
       }
+      acoustic_model_trace.Stop();
 
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h "
           "audio.GetTensorTypeAndShapeInfo().GetShape()[0] %d",
           audio.GetTensorTypeAndShapeInfo().GetShape()[0]);
 
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h "
           "audio.GetTensorTypeAndShapeInfo().GetShape()[1] %d",
           audio.GetTensorTypeAndShapeInfo().GetShape()[1]);
@@ -821,28 +978,33 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       const float *p = audio.GetTensorData<float>();
 
       GeneratedAudio ans;
-      SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h total %d", total);
+      SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h total %d", total);
       ans.sample_rate = model_->GetMetaData().sample_rate;
       ans.samples = std::vector<float>(p, p + total);
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process offline-tts-vits-impl.h ans.samples.size() %d",
           ans.samples.size());
 
       float silence_scale = config_.silence_scale;
       if (silence_scale != 1) {
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             " >>> Process offline-tts-vits-impl.h silence_scale %f",
             silence_scale);
         ans = ans.ScaleSilence(silence_scale);
-        SHERPA_ONNX_LOGE(
+        SHERPA_ONNX_LOGD(
             " >>> Process offline-tts-vits-impl.h ans.samples.size() %d",
             ans.samples.size());
       }
 
-      SHERPA_ONNX_LOGE(" >>> Process offline-tts-vits-impl.h end ");
+      SHERPA_ONNX_LOGD(" >>> Process offline-tts-vits-impl.h end ");
 
       return ans;
     } catch (const Ort::Exception &e) {
+      if (IsOfflineTtsRequestCancelled()) {
+        // The run is terminated by OfflineTtsCancellationToken::Cancel()
+        SHERPA_ONNX_LOGD("ProcessWithJaBert is cancelled: %s", e.what());
+        return GeneratedAudio{};
+      }
       SHERPA_ONNX_LOGE("ORT Exception in ProcessWithJaBert: %s", e.what());
       // 적절한 오류 처리: 빈 GeneratedAudio를 반환하거나, 오류 상태를 표시
       return GeneratedAudio{};
@@ -857,13 +1019,13 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
   GeneratedAudio Process(const std::vector<std::vector<int64_t>> &tokens,
                          const std::vector<std::vector<int64_t>> &tones,
                          int32_t sid, float speed) const {
-    SHERPA_ONNX_LOGE(" >>> Process no ja_bert offline-tts-vits-impl.h start");
+    SHERPA_ONNX_LOGD(" >>> Process no ja_bert offline-tts-vits-impl.h start");
 
     int32_t num_tokens = 0;
     for (const auto &k : tokens) {
       num_tokens += k.size();
     }
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h num_tokens %d",
         num_tokens);
 
@@ -872,13 +1034,15 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     for (const auto &k : tokens) {
       phone_ids.insert(phone_ids.end(), k.begin(), k.end());
     }
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h phone_ids.size() %d",
         phone_ids.size());
-    for (int i = 0; i < 10; i++) {
-      SHERPA_ONNX_LOGE(
-          " >>> Process no ja_bert offline-tts-vits-impl.h phone_ids[%d] %d", i,
-          phone_ids[i]);
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      for (int i = 0; i < std::min<size_t>(10, phone_ids.size()); i++) {
+        SHERPA_ONNX_LOGT(
+            " >>> Process no ja_bert offline-tts-vits-impl.h phone_ids[%d] %d",
+            i, phone_ids[i]);
+      }
     }
 
     std::vector<int64_t> tone_list;
@@ -888,7 +1052,7 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
         tone_list.insert(tone_list.end(), k.begin(), k.end());
       }
     }
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h tone_list.size() %d",
         tone_list.size());
 
@@ -897,37 +1061,37 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     //   tone_list[%d] %d",
     //                    i, tone_list[i]);
     // }
-    SHERPA_ONNX_LOGE(" >>> Process no ja_bert offline-tts-vits-impl.h sid %d",
+    SHERPA_ONNX_LOGD(" >>> Process no ja_bert offline-tts-vits-impl.h sid %d",
                      sid);
-    SHERPA_ONNX_LOGE(" >>> Process no ja_bert offline-tts-vits-impl.h speed %f",
+    SHERPA_ONNX_LOGD(" >>> Process no ja_bert offline-tts-vits-impl.h speed %f",
                      speed);
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h memory_info  start");
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h memory_info end ");
 
     std::array<int64_t, 2> x_shape = {1,
                                       static_cast<int32_t>(phone_ids.size())};
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h x_shape[0] %d",
         x_shape[0]);
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h x_shape[1] %d",
         x_shape[1]);
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h phone_ids.size() %d",
         phone_ids.size());
     Ort::Value x_tensor = Ort::Value::CreateTensor(
         memory_info, phone_ids.data(), phone_ids.size(), x_shape.data(),
         x_shape.size());
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h "
         "x_tensor.GetTensorTypeAndShapeInfo().GetShape()[0] %d",
         x_tensor.GetTensorTypeAndShapeInfo().GetShape()[0]);
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h "
         "x_tensor.GetTensorTypeAndShapeInfo().GetShape()[1] %d",
         x_tensor.GetTensorTypeAndShapeInfo().GetShape()[1]);
@@ -936,36 +1100,38 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
       tones_tensor = Ort::Value::CreateTensor(memory_info, tone_list.data(),
                                               tone_list.size(), x_shape.data(),
                                               x_shape.size());
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process no ja_bert offline-tts-vits-impl.h "
           "tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[0] %d",
           tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[0]);
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process no ja_bert offline-tts-vits-impl.h "
           "tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[1] %d",
           tones_tensor.GetTensorTypeAndShapeInfo().GetShape()[1]);
     }
 
+    ScopedTrace acoustic_model_trace(TraceStage::kAcousticModel);
     Ort::Value audio{nullptr};
     if (tones.empty()) {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process no ja_bert offline-tts-vits-impl.h no tones");
       audio = model_->Run(std::move(x_tensor), sid, speed);
     } else {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process no ja_bert offline-tts-vits-impl.h has tones");
       audio =
           model_->Run(std::move(x_tensor), std::move(tones_tensor), sid, speed);
       // audio = model_->Run(text,std::move(x_tensor), std::move(tones_tensor),
       // sid, speed,frontend_.get());
     }
+    acoustic_model_trace.Stop();
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h "
         "audio.GetTensorTypeAndShapeInfo().GetShape()[0] %d",
         audio.GetTensorTypeAndShapeInfo().GetShape()[0]);
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h "
         "audio.GetTensorTypeAndShapeInfo().GetShape()[1] %d",
         audio.GetTensorTypeAndShapeInfo().GetShape()[1]);
@@ -981,27 +1147,27 @@ class OfflineTtsVitsImpl : public OfflineTtsImpl {
     const float *p = audio.GetTensorData<float>();
 
     GeneratedAudio ans;
-    SHERPA_ONNX_LOGE(" >>> Process no ja_bert offline-tts-vits-impl.h total %d",
+    SHERPA_ONNX_LOGD(" >>> Process no ja_bert offline-tts-vits-impl.h total %d",
                      total);
     ans.sample_rate = model_->GetMetaData().sample_rate;
     ans.samples = std::vector<float>(p, p + total);
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         " >>> Process no ja_bert offline-tts-vits-impl.h ans.samples.size() %d",
         ans.samples.size());
 
     float silence_scale = config_.silence_scale;
     if (silence_scale != 1) {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process no ja_bert offline-tts-vits-impl.h silence_scale %f",
           silence_scale);
       ans = ans.ScaleSilence(silence_scale);
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGD(
           " >>> Process no ja_bert offline-tts-vits-impl.h ans.samples.size() "
           "%d",
           ans.samples.size());
     }
 
-    SHERPA_ONNX_LOGE(" >>> Process no ja_bert offline-tts-vits-impl.h end ");
+    SHERPA_ONNX_LOGD(" >>> Process no ja_bert offline-tts-vits-impl.h end ");
 
     return ans;
   }
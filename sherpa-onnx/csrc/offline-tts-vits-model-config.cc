@@ -27,6 +27,11 @@ void OfflineTtsVitsModelConfig::Register(ParseOptions *po) {
                "noise_scale_w for VITS models");
   po->Register("vits-length-scale", &length_scale,
                "Speech speed. Larger->Slower; Smaller->faster.");
+  po->Register("vits-ja-bert-model", &ja_bert_model,
+               "Path to the BERT model of MeloTTS Korean. It can also be an "
+               "int8 or fp16 model from scripts/melo-tts/quantize-kr.py");
+  po->Register("vits-vocab", &vocab,
+               "Path to vocab.txt of the BERT tokenizer of MeloTTS Korean");
   SHERPA_ONNX_LOGE(">>>> OfflineTtsVitsModelConfig::Register csrc/offline-tts-vits-model-config.cc  end");
 }
 
@@ -82,6 +87,17 @@ bool OfflineTtsVitsModelConfig::Validate() const {
     }
   }
 
+  if (!ja_bert_model.empty() && !FileExists(ja_bert_model)) {
+    SHERPA_ONNX_LOGE("--vits-ja-bert-model: '%s' does not exist",
+                     ja_bert_model.c_str());
+    return false;
+  }
+
+  if (!vocab.empty() && !FileExists(vocab)) {
+    SHERPA_ONNX_LOGE("--vits-vocab: '%s' does not exist", vocab.c_str());
+    return false;
+  }
+
   if (!dict_dir.empty()) {
     std::vector<std::string> required_files = {
         "jieba.dict.utf8", "hmm_model.utf8",  "user.dict.utf8",
@@ -24,6 +24,7 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/melo-tts-ko-const.h"
 #include "sherpa-onnx/csrc/melo-tts-ko.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
 
@@ -37,10 +38,11 @@ class OfflineTtsVitsModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    auto buf = ReadFile(config.vits.model);
-    SHERPA_ONNX_LOGE(
+    sess_ = CreateSession(env_, config.vits.model, sess_opts_,
+                          config.session_config, config.provider);
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl Impl offline-tts-vits-model.cc 0");
-    Init(buf.data(), buf.size());
+    Init();
   }
 
   template <typename Manager>
@@ -52,7 +54,7 @@ class OfflineTtsVitsModel::Impl {
 
   {
     auto buf = ReadFile(mgr, config.vits.model);
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl Impl offline-tts-vits-model.cc 1");
     Init(buf.data(), buf.size());
   }
@@ -62,14 +64,14 @@ class OfflineTtsVitsModel::Impl {
       return RunVitsPiperOrCoqui(std::move(x), sid, speed);
     }
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl Ort::Value Run "
         "offline-tts-vits-model.cc ");
     return RunVits(std::move(x), sid, speed);
   }
   Ort::Value Run(const std::string &text, std::vector<float> &ja_bert_vec,
                  Ort::Value x, Ort::Value tones, int64_t sid, float speed) {
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Run(ja_bert) "
         "csrc/offline-tts-vits-model.cc start");
 
@@ -80,13 +82,13 @@ class OfflineTtsVitsModel::Impl {
       sid = meta_data_.speaker_id;
     }
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Run(ja_bert) "
         "csrc/offline-tts-vits-model.cc create cpu");
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Run(ja_bert) "
         "csrc/offline-tts-vits-model.cc xshape");
 
@@ -100,7 +102,7 @@ class OfflineTtsVitsModel::Impl {
     int64_t len = x_shape[1];
     int64_t len_shape = 1;
     // --- Start of added code for ja_bert ---
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Run() csrc/offline-tts-vits-model.cc "
         "ja_bert tensor len %d",
         len);
@@ -108,7 +110,7 @@ class OfflineTtsVitsModel::Impl {
     // Define the shape for ja_bert
     std::vector<int64_t> ja_bert_shape = {1, 768, len};
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         "DEBUG: ja_bert_vec actual size: %zu, 768 * %zu = %zu, this should "
         "same",
         ja_bert_vec.size(), len, 768 * len);
@@ -116,9 +118,11 @@ class OfflineTtsVitsModel::Impl {
     // for (int i = 0; i < 5; i++) {
     //   SHERPA_ONNX_LOGE("ja_bert_vec[%d] = %f", i, ja_bert_vec[i]);
     // }
-    SHERPA_ONNX_LOGE("Dumping first 10 elements of ja_bert_vec:");
-    for (int i = 0; i < std::min((size_t)10, ja_bert_vec.size()); ++i) {
-      SHERPA_ONNX_LOGE("ja_bert_vec[%d]: %f", i, ja_bert_vec[i]);
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      SHERPA_ONNX_LOGT("Dumping first 10 elements of ja_bert_vec:");
+      for (int i = 0; i < std::min((size_t)10, ja_bert_vec.size()); ++i) {
+        SHERPA_ONNX_LOGT("ja_bert_vec[%d]: %f", i, ja_bert_vec[i]);
+      }
     }
     // You might also want to check for NaNs or Infs
     for (float val : ja_bert_vec) {
@@ -130,7 +134,7 @@ class OfflineTtsVitsModel::Impl {
     Ort::Value ja_bert_tensor = Ort::Value::CreateTensor<float>(
         memory_info, ja_bert_vec.data(), ja_bert_vec.size(),
         ja_bert_shape.data(), ja_bert_shape.size());
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>> OfflineTtsVitsModel::Impl::Run() csrc/offline-tts-vits-model.cc "
         "ja_bert tensor created");
 
@@ -170,21 +174,19 @@ class OfflineTtsVitsModel::Impl {
     inputs.push_back(std::move(length_scale_tensor));   // Reordered
     inputs.push_back(std::move(noise_scale_w_tensor));  // Reordered
     inputs.push_back(std::move(ja_bert_tensor));
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Run() csrc/offline-tts-vits-model.cc "
         "sess_->Run() start");
-    auto out =
-        sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
-                   output_names_ptr_.data(), output_names_ptr_.size());
-    SHERPA_ONNX_LOGE(
+    auto out = RunSession(std::move(inputs));
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Run() csrc/offline-tts-vits-model.cc "
         "sess_->Run() end");
 
-    return std::move(out[0]);
+    return out;
   }
 
   Ort::Value Run(Ort::Value x, Ort::Value tones, int64_t sid, float speed) {
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>origin OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc start");
 
@@ -195,14 +197,14 @@ class OfflineTtsVitsModel::Impl {
       sid = meta_data_.speaker_id;
     }
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>origin OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc "
         "create cpu");
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>origin OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc "
         "xshape");
@@ -218,7 +220,7 @@ class OfflineTtsVitsModel::Impl {
     int64_t len = x_shape[1];
     int64_t len_shape = 1;
     // --- Start of added code for ja_bert ---
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>origin OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc  "
         "ja_bert tensor len %d",
@@ -234,13 +236,15 @@ class OfflineTtsVitsModel::Impl {
     // You might want to initialize this with meaningful data if needed
     // std::vector<float> dummy_ja_bert_data = ja_bert_vec;
     // ReadJaBert(dummy_ja_bert_data);
-    for (int i = 0; i < 5; i++) {
-      SHERPA_ONNX_LOGE(
-          ">>>>origin OfflineTtsVitsModel::Impl::Run() "
-          "csrc/offline-tts-vits-model.cc dummy ja_bert data %f",
-          ja_bert_vec[i]);
+    if (SHERPA_ONNX_LOG_ENABLED(TRACE)) {
+      for (int i = 0; i < std::min((size_t)5, ja_bert_vec.size()); i++) {
+        SHERPA_ONNX_LOGT(
+            ">>>>origin OfflineTtsVitsModel::Impl::Run() "
+            "csrc/offline-tts-vits-model.cc dummy ja_bert data %f",
+            ja_bert_vec[i]);
+      }
     }
-    SHERPA_ONNX_LOGE("111DEBUG: ja_bert_vec actual size: %zu",
+    SHERPA_ONNX_LOGD("111DEBUG: ja_bert_vec actual size: %zu",
                      ja_bert_vec.size());
     assert(ja_bert_vec.size() == 768 * len);
     // Create the Ort::Value for ja_bert
@@ -248,7 +252,7 @@ class OfflineTtsVitsModel::Impl {
         memory_info, ja_bert_vec.data(), ja_bert_vec.size(),
         ja_bert_shape.data(), ja_bert_shape.size());
 
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>origin OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc "
         "dummy ja_bert tensor created");
@@ -288,19 +292,17 @@ class OfflineTtsVitsModel::Impl {
     inputs.push_back(std::move(length_scale_tensor));   // Reordered
     inputs.push_back(std::move(noise_scale_w_tensor));  // Reordered
     // inputs.push_back(std::move(ja_bert_tensor));
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>>origin OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc "
         "sess_->Run() start");
-    auto out =
-        sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
-                   output_names_ptr_.data(), output_names_ptr_.size());
-    SHERPA_ONNX_LOGE(
+    auto out = RunSession(std::move(inputs));
+    SHERPA_ONNX_LOGD(
         ">>>>origin no used OfflineTtsVitsModel::Impl::Run() "
         "csrc/offline-tts-vits-model.cc "
         "sess_->Run() end");
 
-    return std::move(out[0]);
+    return out;
   }
 
   const OfflineTtsVitsModelMetaData &GetMetaData() const { return meta_data_; }
@@ -309,14 +311,27 @@ class OfflineTtsVitsModel::Impl {
   void Init(void *model_data, size_t model_data_length) {
     sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
                                            sess_opts_);
+    Init();
+  }
 
-    SHERPA_ONNX_LOGE(
+  // sess_ has been created
+  void Init() {
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Init() csrc/offline-tts-vits-model.cc "
         "start");
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
     GetOutputNames(sess_.get(), &output_names_, &output_names_ptr_);
 
+    for (size_t i = 0; i != sess_->GetInputCount(); ++i) {
+      input_types_.push_back(sess_->GetInputTypeInfo(i)
+                                 .GetTensorTypeAndShapeInfo()
+                                 .GetElementType());
+    }
+    output_type_ = sess_->GetOutputTypeInfo(0)
+                       .GetTensorTypeAndShapeInfo()
+                       .GetElementType();
+
     // get meta data
     Ort::ModelMetadata meta_data = sess_->GetModelMetadata();
     if (config_.debug) {
@@ -400,11 +415,41 @@ class OfflineTtsVitsModel::Impl {
       // version 0 is the first version
       // version 2: add jieba=1 to the metadata
     }
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::Init() csrc/offline-tts-vits-model.cc "
         " end");
   }
 
+  // Run the model and return its first output as a float tensor.
+  //
+  // Models converted to float16 without keeping the float32 inputs and
+  // outputs, e.g., with keep_io_types=False, expect float16 for the
+  // float inputs and return float16 audio.
+  Ort::Value RunSession(std::vector<Ort::Value> inputs) {
+    for (size_t i = 0; i != inputs.size() && i != input_types_.size(); ++i) {
+      if (input_types_[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 &&
+          inputs[i].GetTensorTypeAndShapeInfo().GetElementType() ==
+              ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        inputs[i] = ConvertFloatToFloat16(allocator_, &inputs[i]);
+      }
+    }
+
+    // Terminate the run if the current request is cancelled
+    Ort::RunOptions run_options;
+    ScopedOfflineTtsCancelCallback on_cancel(
+        [&run_options]() { run_options.SetTerminate(); });
+
+    auto out = sess_->Run(run_options, input_names_ptr_.data(), inputs.data(),
+                          inputs.size(), output_names_ptr_.data(),
+                          output_names_ptr_.size());
+
+    if (output_type_ == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+      return ConvertFloat16ToFloat(allocator_, &out[0]);
+    }
+
+    return std::move(out[0]);
+  }
+
   Ort::Value RunVitsPiperOrCoqui(Ort::Value x, int64_t sid, float speed) {
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
@@ -459,15 +504,11 @@ class OfflineTtsVitsModel::Impl {
       inputs.push_back(std::move(lang_id_tensor));
     }
 
-    auto out =
-        sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
-                   output_names_ptr_.data(), output_names_ptr_.size());
-
-    return std::move(out[0]);
+    return RunSession(std::move(inputs));
   }
 
   Ort::Value RunVits(Ort::Value x, int64_t sid, float speed) {
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGD(
         ">>>> OfflineTtsVitsModel::Impl::RunVits() "
         "csrc/offline-tts-vits-model");
     auto memory_info =
@@ -520,11 +561,7 @@ class OfflineTtsVitsModel::Impl {
       inputs.push_back(std::move(sid_tensor));
     }
 
-    auto out =
-        sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
-                   output_names_ptr_.data(), output_names_ptr_.size());
-
-    return std::move(out[0]);
+    return RunSession(std::move(inputs));
   }
 
  private:
@@ -541,6 +578,9 @@ class OfflineTtsVitsModel::Impl {
   std::vector<std::string> output_names_;
   std::vector<const char *> output_names_ptr_;
 
+  std::vector<ONNXTensorElementDataType> input_types_;
+  ONNXTensorElementDataType output_type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+
   OfflineTtsVitsModelMetaData meta_data_;
 };
 
@@ -562,7 +602,7 @@ Ort::Value OfflineTtsVitsModel::Run(Ort::Value x, int64_t sid /*=0*/,
 Ort::Value OfflineTtsVitsModel::Run(Ort::Value x, Ort::Value tones,
                                     int64_t sid /*= 0*/,
                                     float speed /*= 1.0*/) const {
-  SHERPA_ONNX_LOGE(
+  SHERPA_ONNX_LOGD(
       ">>>> no ja_bert OfflineTtsVitsModel::Run() "
       "csrc/offline-tts-vits-model.cc");
   return impl_->Run(std::move(x), std::move(tones), sid, speed);
@@ -572,7 +612,7 @@ Ort::Value OfflineTtsVitsModel::Run(const std::string &text,
                                      std::vector<float> &ja_bert_vec,
                                     Ort::Value x, Ort::Value tones, int64_t sid,
                                     float speed) {
-  SHERPA_ONNX_LOGE(
+  SHERPA_ONNX_LOGD(
       ">>>> OfflineTtsVitsModel::Run() csrc/offline-tts-vits-model.cc passed "
       "frontend");
   return impl_->Run(text, ja_bert_vec, std::move(x), std::move(tones), sid,
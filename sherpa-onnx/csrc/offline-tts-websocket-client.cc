@@ -0,0 +1,307 @@
+// sherpa-onnx/csrc/offline-tts-websocket-client.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// A load test client for sherpa-onnx-offline-tts-server
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "websocketpp/client.hpp"
+#include "websocketpp/config/asio_no_tls_client.hpp"
+#include "websocketpp/uri.hpp"
+
+using client = websocketpp::client<websocketpp::config::asio_client>;
+
+using message_ptr = client::message_ptr;
+using websocketpp::connection_hdl;
+
+static constexpr const char *kUsageMessage = R"(
+Load test of sherpa-onnx-offline-tts-server.
+
+--num-connections connections are opened at the same time. Each of them
+sends --num-requests requests one after another. Each non-empty line of the
+text file is a request. Lines are used in a round-robin manner.
+
+It prints the time to the first audio chunk (time to first byte), the
+latency and the real time factor of the requests.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-websocket-client \
+  --server-ip=127.0.0.1 \
+  --server-port=6006 \
+  --num-connections=8 \
+  --num-requests=10 \
+  ./sentences.txt
+)";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RequestStats {
+  float ttfb = 0;     // seconds
+  float latency = 0;  // seconds
+  float duration = 0;  // seconds of audio
+};
+
+struct LoadTestResult {
+  std::vector<RequestStats> requests;
+  int32_t num_errors = 0;
+};
+
+class Connection {
+ public:
+  Connection(client *c, const std::string &uri,
+             const std::vector<std::string> &texts, int32_t offset,
+             int32_t num_requests, int32_t sid, float speed,
+             LoadTestResult *result)
+      : c_(c),
+        texts_(texts),
+        next_text_(offset),
+        num_requests_(num_requests),
+        sid_(sid),
+        speed_(speed),
+        result_(result) {
+    websocketpp::lib::error_code ec;
+    client::connection_ptr con = c_->get_connection(uri, ec);
+    if (ec) {
+      SHERPA_ONNX_LOGE("Could not create connection to %s because %s",
+                       uri.c_str(), ec.message().c_str());
+      exit(EXIT_FAILURE);
+    }
+
+    con->set_open_handler([this](connection_hdl hdl) { SendRequest(hdl); });
+    con->set_message_handler(
+        [this](connection_hdl hdl, message_ptr msg) { OnMessage(hdl, msg); });
+    con->set_fail_handler([this](connection_hdl /*hdl*/) {
+      SHERPA_ONNX_LOGE("Failed to connect");
+      result_->num_errors += num_requests_ - num_sent_;
+    });
+
+    c_->connect(con);
+  }
+
+ private:
+  void SendRequest(connection_hdl hdl) {
+    websocketpp::lib::error_code ec;
+    if (num_sent_ == num_requests_) {
+      c_->send(hdl, "Done", websocketpp::frame::opcode::text, ec);
+      return;
+    }
+
+    const std::string &text = texts_[next_text_ % texts_.size()];
+    next_text_ += 1;
+
+    std::string payload(8 + text.size(), 0);
+    std::memcpy(&payload[0], &sid_, 4);
+    std::memcpy(&payload[4], &speed_, 4);
+    std::memcpy(&payload[8], text.data(), text.size());
+
+    num_sent_ += 1;
+    num_samples_ = 0;
+    first_audio_ = Clock::time_point{};
+    start_ = Clock::now();
+
+    c_->send(hdl, payload, websocketpp::frame::opcode::binary, ec);
+    if (ec) {
+      SHERPA_ONNX_LOGE("Failed to send the request because %s",
+                       ec.message().c_str());
+      result_->num_errors += 1;
+    }
+  }
+
+  void OnMessage(connection_hdl hdl, message_ptr msg) {
+    const std::string &payload = msg->get_payload();
+
+    if (msg->get_opcode() == websocketpp::frame::opcode::binary) {
+      if (first_audio_ == Clock::time_point{}) {
+        first_audio_ = Clock::now();
+      }
+      num_samples_ += payload.size() / sizeof(float);
+      return;
+    }
+
+    if (payload.find("\"start\"") != std::string::npos) {
+      auto pos = payload.find("\"sample_rate\":");
+      if (pos != std::string::npos) {
+        sample_rate_ = atoi(payload.c_str() + pos + 14);
+      }
+      return;
+    }
+
+    if (payload.find("\"done\"") != std::string::npos) {
+      auto now = Clock::now();
+      RequestStats s;
+      s.latency = std::chrono::duration<float>(now - start_).count();
+      s.ttfb = first_audio_ == Clock::time_point{}
+                   ? s.latency
+                   : std::chrono::duration<float>(first_audio_ - start_)
+                         .count();
+      s.duration = sample_rate_ > 0 ? num_samples_ / sample_rate_ : 0;
+      result_->requests.push_back(s);
+    } else {
+      SHERPA_ONNX_LOGE("%s", payload.c_str());
+      result_->num_errors += 1;
+    }
+
+    SendRequest(hdl);
+  }
+
+ private:
+  client *c_;
+  const std::vector<std::string> &texts_;
+  int32_t next_text_;
+  int32_t num_requests_;
+  int32_t sid_;
+  float speed_;
+  LoadTestResult *result_;
+
+  int32_t num_sent_ = 0;
+  float sample_rate_ = 0;
+  int64_t num_samples_ = 0;
+  Clock::time_point start_;
+  Clock::time_point first_audio_;
+};
+
+float Percentile(std::vector<float> v, float q) {
+  if (v.empty()) {
+    return 0;
+  }
+
+  std::sort(v.begin(), v.end());
+  int32_t i = static_cast<int32_t>(q * (v.size() - 1) + 0.5f);
+  return v[i];
+}
+
+float Mean(const std::vector<float> &v) {
+  if (v.empty()) {
+    return 0;
+  }
+
+  double sum = 0;
+  for (auto f : v) {
+    sum += f;
+  }
+  return sum / v.size();
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  std::string server_ip = "127.0.0.1";
+  int32_t server_port = 6006;
+  int32_t num_connections = 8;
+  int32_t num_requests = 10;
+  int32_t sid = 0;
+  float speed = 1.0;
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  po.Register("server-ip", &server_ip, "IP address of the websocket server");
+  po.Register("server-port", &server_port, "Port of the websocket server");
+  po.Register("num-connections", &num_connections,
+              "Number of concurrent connections");
+  po.Register("num-requests", &num_requests,
+              "Number of requests of each connection");
+  po.Register("sid", &sid, "Speaker ID");
+  po.Register("speed", &speed, "Speed of the generated speech");
+
+  po.Read(argc, argv);
+
+  if (!websocketpp::uri_helper::ipv4_literal(server_ip.begin(),
+                                             server_ip.end())) {
+    SHERPA_ONNX_LOGE("Invalid server IP: %s", server_ip.c_str());
+    return -1;
+  }
+
+  if (server_port <= 0 || server_port > 65535) {
+    SHERPA_ONNX_LOGE("Invalid server port: %d", server_port);
+    return -1;
+  }
+
+  if (num_connections <= 0 || num_requests <= 0) {
+    SHERPA_ONNX_LOGE("Expect --num-connections > 0 and --num-requests > 0");
+    return -1;
+  }
+
+  if (po.NumArgs() != 1) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> texts;
+  {
+    std::ifstream is(po.GetArg(1));
+    std::string line;
+    while (std::getline(is, line)) {
+      if (!line.empty()) {
+        texts.push_back(line);
+      }
+    }
+  }
+
+  if (texts.empty()) {
+    SHERPA_ONNX_LOGE("No text is found in %s", po.GetArg(1).c_str());
+    return -1;
+  }
+
+  websocketpp::uri uri(/*secure*/ false, server_ip, server_port,
+                       /*resource*/ "/");
+
+  asio::io_context io;
+  client c;
+  c.clear_access_channels(websocketpp::log::alevel::all);
+  c.init_asio(&io);
+
+  LoadTestResult result;
+  std::vector<std::unique_ptr<Connection>> connections;
+  auto start = Clock::now();
+  for (int32_t i = 0; i != num_connections; ++i) {
+    connections.push_back(std::make_unique<Connection>(
+        &c, uri.str(), texts, i, num_requests, sid, speed, &result));
+  }
+
+  // All connections run in this thread
+  io.run();
+
+  float wall = std::chrono::duration<float>(Clock::now() - start).count();
+
+  std::vector<float> ttfb;
+  std::vector<float> latency;
+  std::vector<float> rtf;
+  float total_duration = 0;
+  for (const auto &s : result.requests) {
+    ttfb.push_back(s.ttfb);
+    latency.push_back(s.latency);
+    if (s.duration > 0) {
+      rtf.push_back(s.latency / s.duration);
+    }
+    total_duration += s.duration;
+  }
+
+  printf("Requests: %d, errors: %d, wall time: %.3f s\n",
+         static_cast<int32_t>(result.requests.size()), result.num_errors,
+         wall);
+  printf("TTFB    mean %.3f s, p50 %.3f s, p90 %.3f s, p99 %.3f s\n",
+         Mean(ttfb), Percentile(ttfb, 0.5), Percentile(ttfb, 0.9),
+         Percentile(ttfb, 0.99));
+  printf("Latency mean %.3f s, p50 %.3f s, p90 %.3f s, p99 %.3f s\n",
+         Mean(latency), Percentile(latency, 0.5), Percentile(latency, 0.9),
+         Percentile(latency, 0.99));
+  printf("RTF     mean %.3f, p90 %.3f\n", Mean(rtf), Percentile(rtf, 0.9));
+  printf("Throughput: %.3f seconds of audio per second\n",
+         wall > 0 ? total_duration / wall : 0);
+
+  return 0;
+}
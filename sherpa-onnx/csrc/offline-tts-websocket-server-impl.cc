@@ -0,0 +1,564 @@
+// sherpa-onnx/csrc/offline-tts-websocket-server-impl.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-websocket-server-impl.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sstream>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/wave-writer.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+std::string ErrorJson(const std::string &message) {
+  std::ostringstream os;
+  os << "{\"type\": \"error\", \"message\": \"" << message << "\"}";
+  return os.str();
+}
+
+// Speeds outside of this range are rejected
+constexpr float kMinSpeed = 0.1;
+constexpr float kMaxSpeed = 10;
+
+// Parse sid and speed from the query of a resource, e.g.,
+// /generate?sid=1&speed=1.2
+// Return false if one of them is not a number.
+bool ParseQuery(const std::string &resource, int32_t *sid, float *speed) {
+  auto pos = resource.find('?');
+  if (pos == std::string::npos) {
+    return true;
+  }
+
+  std::vector<std::string> fields;
+  SplitStringToVector(resource.substr(pos + 1), "&", true, &fields);
+  for (const auto &f : fields) {
+    auto eq = f.find('=');
+    if (eq == std::string::npos) {
+      continue;
+    }
+
+    std::string key = f.substr(0, eq);
+    std::string value = f.substr(eq + 1);
+    if (key == "sid" && !ConvertStringToInteger(value, sid)) {
+      return false;
+    } else if (key == "speed" && !ConvertStringToReal(value, speed)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// sid and speed come from the client. Return an error message if they
+// are out of range or an empty string otherwise.
+std::string CheckSidAndSpeed(int32_t sid, float speed, int32_t num_speakers) {
+  // Single speaker models report 0 or 1 speakers
+  if (sid < 0 || sid >= std::max(num_speakers, 1)) {
+    std::ostringstream os;
+    os << "sid should be in the range [0, " << std::max(num_speakers, 1) - 1
+       << "]";
+    return os.str();
+  }
+
+  // Also rejects NaN
+  if (!(speed >= kMinSpeed && speed <= kMaxSpeed)) {
+    std::ostringstream os;
+    os << "speed should be in the range [" << kMinSpeed << ", " << kMaxSpeed
+       << "]";
+    return os.str();
+  }
+
+  return {};
+}
+
+}  // namespace
+
+void OfflineTtsWebsocketServerConfig::Register(ParseOptions *po) {
+  tts_config.Register(po);
+
+  po->Register("max-queue-size", &max_queue_size,
+               "Max number of requests waiting for a work thread. If the "
+               "queue is full, new requests are rejected.");
+
+  po->Register("max-text-length", &max_text_length,
+               "Max number of bytes of the text of a request.");
+
+  po->Register("max-buffered-bytes", &max_buffered_bytes,
+               "If audio of a connection that has not been sent to the "
+               "client exceeds this value, the work thread waits for the "
+               "client. It checks every 10 ms and cannot serve other "
+               "requests while waiting.");
+
+  po->Register("log-file", &log_file,
+               "Path to the log file. Logs are "
+               "appended to this file");
+}
+
+void OfflineTtsWebsocketServerConfig::Validate() const {
+  if (!tts_config.Validate()) {
+    SHERPA_ONNX_LOGE("Error in tts config");
+    exit(-1);
+  }
+
+  if (max_queue_size <= 0) {
+    SHERPA_ONNX_LOGE("Expect --max-queue-size > 0. Given: %d",
+                     max_queue_size);
+    exit(-1);
+  }
+
+  if (max_text_length <= 0) {
+    SHERPA_ONNX_LOGE("Expect --max-text-length > 0. Given: %d",
+                     max_text_length);
+    exit(-1);
+  }
+
+  if (max_buffered_bytes <= 0) {
+    SHERPA_ONNX_LOGE("Expect --max-buffered-bytes > 0. Given: %d",
+                     max_buffered_bytes);
+    exit(-1);
+  }
+}
+
+OfflineTtsWebsocketServer::OfflineTtsWebsocketServer(
+    asio::io_context &io_conn,  // NOLINT
+    asio::io_context &io_work,  // NOLINT
+    const OfflineTtsWebsocketServerConfig &config)
+    : io_conn_(io_conn),
+      io_work_(io_work),
+      config_(config),
+      log_(config.log_file, std::ios::app),
+      tee_(std::cout, log_),
+      tts_(config.tts_config) {
+  SetupLog();
+
+  server_.init_asio(&io_conn_);
+
+  server_.set_open_handler([this](connection_hdl hdl) { OnOpen(hdl); });
+
+  server_.set_close_handler([this](connection_hdl hdl) { OnClose(hdl); });
+
+  server_.set_message_handler(
+      [this](connection_hdl hdl, server::message_ptr msg) {
+        OnMessage(hdl, msg);
+      });
+
+  server_.set_http_handler([this](connection_hdl hdl) { OnHttp(hdl); });
+}
+
+void OfflineTtsWebsocketServer::SetupLog() {
+  server_.clear_access_channels(websocketpp::log::alevel::all);
+  server_.set_access_channels(websocketpp::log::alevel::connect);
+  server_.set_access_channels(websocketpp::log::alevel::disconnect);
+
+  // So that it also prints to std::cout and std::cerr
+  server_.get_alog().set_ostream(&tee_);
+  server_.get_elog().set_ostream(&tee_);
+}
+
+void OfflineTtsWebsocketServer::OnOpen(connection_hdl hdl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  connections_.emplace(hdl, std::make_shared<OfflineTtsConnectionData>());
+
+  SHERPA_ONNX_LOGI("Number of active connections: %d",
+                   static_cast<int32_t>(connections_.size()));
+}
+
+void OfflineTtsWebsocketServer::OnClose(connection_hdl hdl) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = connections_.find(hdl);
+  if (it == connections_.end()) {
+    return;
+  }
+  auto connection = it->second;
+  connections_.erase(it);
+
+  SHERPA_ONNX_LOGI("Number of active connections: %d",
+                   static_cast<int32_t>(connections_.size()));
+  lock.unlock();
+
+  // The client will not receive the audio, so stop generating it
+  std::lock_guard<std::mutex> connection_lock(connection->mutex);
+  if (connection->cancellation) {
+    connection->cancellation->Cancel();
+  }
+}
+
+void OfflineTtsWebsocketServer::OnMessage(connection_hdl hdl,
+                                          server::message_ptr msg) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = connections_.find(hdl);
+  if (it == connections_.end()) {
+    return;
+  }
+  auto connection = it->second;
+  lock.unlock();
+
+  const std::string &payload = msg->get_payload();
+
+  switch (msg->get_opcode()) {
+    case websocketpp::frame::opcode::text:
+      if (payload == "Done") {
+        // The client will not send any more requests. We can close the
+        // connection now.
+        Close(hdl, websocketpp::close::status::normal, "Done");
+      } else {
+        // The reason of a close frame is limited to 123 bytes, so do not
+        // echo the payload
+        Close(hdl, websocketpp::close::status::normal, "Invalid payload");
+      }
+      break;
+
+    case websocketpp::frame::opcode::binary: {
+      std::string error;
+      if (payload.size() <= 8) {
+        error = "Payload is too short";
+      } else if (static_cast<int32_t>(payload.size()) - 8 >
+                 config_.max_text_length) {
+        error = "Text is too long";
+      }
+
+      if (!error.empty()) {
+        Send(hdl, connection, ErrorJson(error),
+             websocketpp::frame::opcode::text);
+        break;
+      }
+
+      auto r = std::make_shared<OfflineTtsServerRequest>();
+      r->hdl = hdl;
+      r->connection = connection;
+      std::memcpy(&r->sid, payload.data(), 4);
+      std::memcpy(&r->speed, payload.data() + 4, 4);
+      r->text = payload.substr(8);
+
+      error = CheckSidAndSpeed(r->sid, r->speed, tts_.NumSpeakers());
+      if (!error.empty()) {
+        Send(hdl, connection, ErrorJson(error),
+             websocketpp::frame::opcode::text);
+        break;
+      }
+
+      r->cancellation = std::make_shared<OfflineTtsCancellationToken>();
+      r->received = std::chrono::steady_clock::now();
+
+      {
+        std::lock_guard<std::mutex> connection_lock(connection->mutex);
+        if (connection->cancellation) {
+          error = "A request of this connection is running";
+        } else {
+          connection->cancellation = r->cancellation;
+        }
+      }
+
+      if (error.empty() && !Push(r)) {
+        error = "Server is busy";
+        std::lock_guard<std::mutex> connection_lock(connection->mutex);
+        connection->cancellation.reset();
+      }
+
+      if (!error.empty()) {
+        Send(hdl, connection, ErrorJson(error),
+             websocketpp::frame::opcode::text);
+      }
+      break;
+    }
+
+    default:
+      // Unexpected message, ignore it
+      break;
+  }
+}
+
+void OfflineTtsWebsocketServer::OnHttp(connection_hdl hdl) {
+  auto con = server_.get_con_from_hdl(hdl);
+  const std::string &method = con->get_request().get_method();
+  std::string resource = con->get_resource();
+  std::string path = resource.substr(0, resource.find('?'));
+
+  if (method == "GET" && path == "/health") {
+    std::ostringstream os;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      os << "{\"num_queued\": " << requests_.size()
+         << ", \"num_running\": " << num_running_
+         << ", \"max_queue_size\": " << config_.max_queue_size << "}";
+    }
+    con->set_status(websocketpp::http::status_code::ok);
+    con->append_header("Content-Type", "application/json");
+    con->set_body(os.str());
+    return;
+  }
+
+  if (method != "POST" || path != "/generate") {
+    con->set_status(websocketpp::http::status_code::not_found);
+    con->set_body("Not found");
+    return;
+  }
+
+  auto r = std::make_shared<OfflineTtsServerRequest>();
+  r->hdl = hdl;
+  r->connection = std::make_shared<OfflineTtsConnectionData>();
+  r->text = con->get_request_body();
+  r->cancellation = std::make_shared<OfflineTtsCancellationToken>();
+  r->http = true;
+  r->received = std::chrono::steady_clock::now();
+
+  std::string error;
+  if (!ParseQuery(resource, &r->sid, &r->speed)) {
+    error = "sid and speed should be numbers";
+  } else if (r->text.empty() ||
+             static_cast<int32_t>(r->text.size()) > config_.max_text_length) {
+    error = "Text is empty or too long";
+  } else {
+    error = CheckSidAndSpeed(r->sid, r->speed, tts_.NumSpeakers());
+  }
+
+  if (!error.empty()) {
+    con->set_status(websocketpp::http::status_code::bad_request);
+    con->set_body(error);
+    return;
+  }
+
+  // The client will not receive the audio if it disconnects, so stop
+  // generating it. websocketpp ends an HTTP connection that has not sent
+  // its response through the fail handler.
+  std::weak_ptr<OfflineTtsCancellationToken> cancellation = r->cancellation;
+  auto cancel = [cancellation](connection_hdl /*hdl*/) {
+    if (auto c = cancellation.lock()) {
+      c->Cancel();
+    }
+  };
+  con->set_close_handler(cancel);
+  con->set_fail_handler(cancel);
+
+  // websocketpp does not read from the connection while the response is
+  // deferred, so it notices a disconnected client only when it sends the
+  // response. Wait for the end of the stream ourselves. The client sends
+  // nothing after the request, so the read completes only when the client
+  // disconnects or the server closes the connection after the response.
+  auto buf = std::make_shared<std::array<char, 1>>();
+  con->get_raw_socket().async_read_some(
+      asio::buffer(*buf),
+      [con, buf, cancel](const websocketpp::lib::asio::error_code &ec,
+                         std::size_t /*n*/) {
+        if (ec) {
+          cancel(con->get_handle());
+        }
+      });
+
+  // The response is sent by SendHttpResponse() once the audio is generated
+  con->defer_http_response();
+
+  if (!Push(r)) {
+    con->set_status(websocketpp::http::status_code::service_unavailable);
+    con->set_body("Server is busy");
+    con->send_http_response();
+  }
+}
+
+bool OfflineTtsWebsocketServer::Push(OfflineTtsServerRequestPtr r) {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (static_cast<int32_t>(requests_.size()) >= config_.max_queue_size) {
+      SHERPA_ONNX_LOGW("Queue is full. Reject a request");
+      return false;
+    }
+    requests_.push_back(std::move(r));
+  }
+
+  asio::post(io_work_, [this]() { Generate(); });
+  return true;
+}
+
+void OfflineTtsWebsocketServer::Generate() {
+  OfflineTtsServerRequestPtr r;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (requests_.empty()) {
+      return;
+    }
+    r = std::move(requests_.front());
+    requests_.pop_front();
+    num_running_ += 1;
+  }
+
+  int32_t sample_rate = tts_.SampleRate();
+  auto start = std::chrono::steady_clock::now();
+  float queued_seconds =
+      std::chrono::duration<float>(start - r->received).count();
+  float first_audio_seconds = -1;
+
+  OfflineTtsRequestOptions options;
+  options.cancellation = r->cancellation;
+
+  if (!r->http) {
+    std::ostringstream os;
+    os << "{\"type\": \"start\", \"sample_rate\": " << sample_rate << "}";
+    Send(r->hdl, r->connection, os.str(), websocketpp::frame::opcode::text);
+  }
+
+  auto callback = [&](const float *samples, int32_t n,
+                      float /*progress*/) -> int32_t {
+    if (first_audio_seconds < 0) {
+      first_audio_seconds = std::chrono::duration<float>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+    }
+
+    if (r->http || n == 0) {
+      return 1;
+    }
+
+    WaitForClient(*r);
+
+    std::string chunk(reinterpret_cast<const char *>(samples),
+                      n * sizeof(float));
+    Send(r->hdl, r->connection, std::move(chunk),
+         websocketpp::frame::opcode::binary);
+    return 1;
+  };
+
+  GeneratedAudio audio =
+      tts_.Generate(r->text, r->sid, r->speed, callback, options);
+
+  float elapsed_seconds = std::chrono::duration<float>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+  float duration =
+      audio.samples.size() / static_cast<float>(std::max(sample_rate, 1));
+  float rtf = duration > 0 ? elapsed_seconds / duration : 0;
+
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    num_running_ -= 1;
+  }
+
+  if (r->cancellation->IsCancelled()) {
+    SHERPA_ONNX_LOGI("Request is cancelled after %.3f s", elapsed_seconds);
+    return;
+  }
+
+  SHERPA_ONNX_LOGI(
+      "queued: %.3f s, first audio: %.3f s, elapsed: %.3f s, audio: %.3f s, "
+      "RTF: %.3f",
+      queued_seconds, first_audio_seconds, elapsed_seconds, duration, rtf);
+
+  if (r->http) {
+    std::string wave;
+    wave.resize(WaveFileSize(audio.samples.size()));
+    WriteWave(&wave[0], sample_rate, audio.samples.data(),
+              audio.samples.size());
+    SendHttpResponse(r->hdl, websocketpp::http::status_code::ok, "audio/wav",
+                     std::move(wave));
+    return;
+  }
+
+  std::ostringstream os;
+  os << "{\"type\": \"done\", \"num_samples\": " << audio.samples.size()
+     << ", \"elapsed_seconds\": " << elapsed_seconds << ", \"rtf\": " << rtf
+     << "}";
+
+  {
+    // Accept the next request of the connection. The client sends it
+    // after receiving "done"
+    std::lock_guard<std::mutex> lock(r->connection->mutex);
+    r->connection->cancellation.reset();
+  }
+
+  Send(r->hdl, r->connection, os.str(), websocketpp::frame::opcode::text);
+}
+
+void OfflineTtsWebsocketServer::Send(
+    connection_hdl hdl, const OfflineTtsConnectionDataPtr &connection,
+    std::string payload, websocketpp::frame::opcode::value op) {
+  connection->buffered_bytes += payload.size();
+
+  asio::post(io_conn_, [this, hdl, connection, payload = std::move(payload),
+                        op]() {
+    websocketpp::lib::error_code ec;
+    server_.send(hdl, payload, op, ec);
+    if (ec) {
+      server_.get_alog().write(websocketpp::log::alevel::app, ec.message());
+      connection->buffered_bytes = 0;
+      return;
+    }
+
+    auto con = server_.get_con_from_hdl(hdl, ec);
+    connection->buffered_bytes = ec ? 0 : con->get_buffered_amount();
+  });
+}
+
+void OfflineTtsWebsocketServer::WaitForClient(
+    const OfflineTtsServerRequest &r) {
+  auto connection = r.connection;
+  connection_hdl hdl = r.hdl;
+  while (connection->buffered_bytes > config_.max_buffered_bytes &&
+         !r.cancellation->IsCancelled()) {
+    // buffered_bytes is updated only when a message is sent, so ask the
+    // connection for it
+    asio::post(io_conn_, [this, hdl, connection]() {
+      websocketpp::lib::error_code ec;
+      auto con = server_.get_con_from_hdl(hdl, ec);
+      connection->buffered_bytes = ec ? 0 : con->get_buffered_amount();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+void OfflineTtsWebsocketServer::SendHttpResponse(
+    connection_hdl hdl, websocketpp::http::status_code::value code,
+    const std::string &content_type, std::string body) {
+  asio::post(io_conn_, [this, hdl, code, content_type,
+                        body = std::move(body)]() {
+    websocketpp::lib::error_code ec;
+    auto con = server_.get_con_from_hdl(hdl, ec);
+    if (ec) {
+      // The client has disconnected
+      return;
+    }
+
+    con->set_status(code);
+    con->append_header("Content-Type", content_type);
+    con->set_body(body);
+    con->send_http_response(ec);
+    if (ec) {
+      server_.get_alog().write(websocketpp::log::alevel::app, ec.message());
+    }
+  });
+}
+
+void OfflineTtsWebsocketServer::Close(connection_hdl hdl,
+                                      websocketpp::close::status::value code,
+                                      const std::string &reason) {
+  auto con = server_.get_con_from_hdl(hdl);
+
+  std::ostringstream os;
+  os << "Closing " << con->get_remote_endpoint() << " with reason: " << reason
+     << "\n";
+
+  websocketpp::lib::error_code ec;
+  server_.close(hdl, code, reason, ec);
+  if (ec) {
+    os << "Failed to close" << con->get_remote_endpoint() << ". "
+       << ec.message() << "\n";
+  }
+  server_.get_alog().write(websocketpp::log::alevel::app, os.str());
+}
+
+void OfflineTtsWebsocketServer::Run(uint16_t port) {
+  server_.set_reuse_addr(true);
+  server_.listen(asio::ip::tcp::v4(), port);
+  server_.start_accept();
+}
+
+}  // namespace sherpa_onnx
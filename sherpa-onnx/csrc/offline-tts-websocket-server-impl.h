@@ -0,0 +1,198 @@
+// sherpa-onnx/csrc/offline-tts-websocket-server-impl.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_WEBSOCKET_SERVER_IMPL_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_WEBSOCKET_SERVER_IMPL_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/tee-stream.h"
+#include "websocketpp/config/asio_no_tls.hpp"  // TODO(fangjun): support TLS
+#include "websocketpp/server.hpp"
+
+using server = websocketpp::server<websocketpp::config::asio>;
+using connection_hdl = websocketpp::connection_hdl;
+
+namespace sherpa_onnx {
+
+/** Communication protocol
+ *
+ * Websocket
+ *
+ * The client sends a binary message for each request. The first 4 bytes in
+ * little endian is an int32_t containing the speaker ID. The next 4 bytes
+ * in little endian is a float containing the speed. The remaining bytes
+ * are the text in UTF-8. The speaker ID must be less than the number of
+ * speakers of the model and the speed must be in the range [0.1, 10].
+ *
+ * The server replies with
+ *
+ *  (1) a text message {"type": "start", "sample_rate": 44100}
+ *  (2) a binary message for each chunk of audio as soon as it is generated.
+ *      Each sample is a float occupying 4 bytes in little endian and is
+ *      normalized into the range [-1, 1].
+ *  (3) a text message {"type": "done", "num_samples": 123456,
+ *      "elapsed_seconds": 1.5, "rtf": 0.3}
+ *
+ * If the request is rejected, e.g., the queue of the server is full, the
+ * server replies with a text message {"type": "error", "message": "..."}.
+ *
+ * A connection handles one request at a time. After receiving "done" or
+ * "error", the client can send another request. It sends a text message
+ * "Done" to close the connection. If the client disconnects in the middle
+ * of a request, the request is cancelled.
+ *
+ * HTTP
+ *
+ *   POST /generate?sid=0&speed=1.0 with the text in UTF-8 as the body
+ *   returns a wave file with 16-bit samples. If the client disconnects
+ *   before the response is sent, the request is cancelled.
+ *
+ *   GET /health returns
+ *   {"num_queued": 0, "num_running": 1, "max_queue_size": 32}
+ */
+struct OfflineTtsWebsocketServerConfig {
+  OfflineTtsConfig tts_config;
+
+  // Requests that are waiting for a work thread. If the queue is full,
+  // new requests are rejected
+  int32_t max_queue_size = 32;
+
+  // Max number of bytes of the text of a request
+  int32_t max_text_length = 10000;
+
+  // If audio of a connection that has not been sent to the client exceeds
+  // this value, the work thread waits for the client. See WaitForClient()
+  int32_t max_buffered_bytes = 1 << 20;
+
+  std::string log_file = "./log.txt";
+
+  void Register(ParseOptions *po);
+  void Validate() const;
+};
+
+struct OfflineTtsConnectionData {
+  std::mutex mutex;
+
+  // Token of the running request of this connection. It is null if there
+  // is no running request
+  std::shared_ptr<OfflineTtsCancellationToken> cancellation;
+
+  // Bytes that are queued in the connection but not sent to the client yet
+  std::atomic<int64_t> buffered_bytes{0};
+};
+
+using OfflineTtsConnectionDataPtr = std::shared_ptr<OfflineTtsConnectionData>;
+
+struct OfflineTtsServerRequest {
+  connection_hdl hdl;
+  OfflineTtsConnectionDataPtr connection;
+
+  std::string text;
+  int32_t sid = 0;
+  float speed = 1.0;
+
+  std::shared_ptr<OfflineTtsCancellationToken> cancellation;
+
+  // True for HTTP requests. The audio is sent as a single wave file
+  bool http = false;
+
+  std::chrono::steady_clock::time_point received;
+};
+
+using OfflineTtsServerRequestPtr = std::shared_ptr<OfflineTtsServerRequest>;
+
+class OfflineTtsWebsocketServer {
+ public:
+  OfflineTtsWebsocketServer(asio::io_context &io_conn,  // NOLINT
+                            asio::io_context &io_work,  // NOLINT
+                            const OfflineTtsWebsocketServerConfig &config);
+
+  void Run(uint16_t port);
+
+  const OfflineTtsWebsocketServerConfig &GetConfig() const { return config_; }
+
+ private:
+  void SetupLog();
+
+  // When a websocket client is connected, it will invoke this method
+  // (Not for HTTP)
+  void OnOpen(connection_hdl hdl);
+
+  // When a websocket client is disconnected, it will invoke this method.
+  // The running request of the connection is cancelled.
+  void OnClose(connection_hdl hdl);
+
+  // A websocket request. See the protocol above
+  void OnMessage(connection_hdl hdl, server::message_ptr msg);
+
+  // An HTTP request. See the protocol above
+  void OnHttp(connection_hdl hdl);
+
+  // Put a request into the queue. Return false if the queue is full.
+  bool Push(OfflineTtsServerRequestPtr r);
+
+  // It is called by one of the work threads. It takes a request from the
+  // queue and generates audio for it.
+  void Generate();
+
+  // Send a text or a binary message in the thread of io_conn_
+  void Send(connection_hdl hdl, const OfflineTtsConnectionDataPtr &connection,
+            std::string payload, websocketpp::frame::opcode::value op);
+
+  // Wait until the client has received most of the audio of the connection
+  // or the request is cancelled.
+  //
+  // websocketpp has no callback for when its send buffer drains, so this
+  // polls the buffered amount every 10 ms and blocks the calling work
+  // thread meanwhile. A slow client holds a work thread for as long as it
+  // lags behind; as many slow clients as there are work threads stall all
+  // other requests. Use more work threads or a larger --max-buffered-bytes
+  // if clients are on slow links.
+  void WaitForClient(const OfflineTtsServerRequest &r);
+
+  void SendHttpResponse(connection_hdl hdl,
+                        websocketpp::http::status_code::value code,
+                        const std::string &content_type, std::string body);
+
+  // Close a websocket connection with given code and reason
+  void Close(connection_hdl hdl, websocketpp::close::status::value code,
+             const std::string &reason);
+
+ private:
+  asio::io_context &io_conn_;
+  asio::io_context &io_work_;
+  server server_;
+
+  std::map<connection_hdl, OfflineTtsConnectionDataPtr,
+           std::owner_less<connection_hdl>>
+      connections_;
+  std::mutex mutex_;
+
+  OfflineTtsWebsocketServerConfig config_;
+
+  std::ofstream log_;
+  TeeStream tee_;
+
+  // Protects requests_ and num_running_
+  std::mutex queue_mutex_;
+  std::deque<OfflineTtsServerRequestPtr> requests_;
+  int32_t num_running_ = 0;
+
+  OfflineTts tts_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_WEBSOCKET_SERVER_IMPL_H_
@@ -0,0 +1,122 @@
+// sherpa-onnx/csrc/offline-tts-websocket-server.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "asio.hpp"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-websocket-server-impl.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+static constexpr const char *kUsageMessage = R"(
+Text to speech with sherpa-onnx using websocket and HTTP.
+
+Audio of each request is streamed back to the client as soon as each
+sentence is generated. See offline-tts-websocket-server-impl.h for the
+protocol.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-server --help
+
+./bin/sherpa-onnx-offline-tts-server \
+  --port=6006 \
+  --num-work-threads=2 \
+  --max-queue-size=32 \
+  --vits-model=./melo-tts-ko/model.onnx \
+  --vits-ja-bert-model=./melo-tts-ko/ja_bert.onnx \
+  --vits-vocab=./melo-tts-ko/vocab.txt \
+  --vits-lexicon=./melo-tts-ko/lexicon.txt \
+  --vits-tokens=./melo-tts-ko/tokens.txt \
+  --tts-max-num-sentences=1 \
+  --log-file=./log.txt
+
+Each work thread runs one request at a time. Sentences of a request are
+generated in parallel by the sentence pipeline of the model, so a small
+number of work threads is usually enough.
+
+curl --data "안녕하세요." -o hello.wav "http://127.0.0.1:6006/generate?sid=0"
+
+Please refer to
+https://k2-fsa.github.io/sherpa/onnx/tts/pretrained_models/index.html
+for a list of pre-trained models to download.
+)";
+
+int32_t main(int32_t argc, char *argv[]) {
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  sherpa_onnx::OfflineTtsWebsocketServerConfig config;
+
+  // the server will listen on this port
+  int32_t port = 6006;
+
+  // size of the thread pool for handling network connections
+  int32_t num_io_threads = 1;
+
+  // size of the thread pool for generating audio
+  int32_t num_work_threads = 2;
+
+  po.Register("num-io-threads", &num_io_threads,
+              "Thread pool size for network connections.");
+
+  po.Register("num-work-threads", &num_work_threads,
+              "Number of requests that are generated at the same time.");
+
+  po.Register("port", &port, "The port on which the server will listen.");
+
+  config.Register(&po);
+
+  if (argc == 1) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 0) {
+    SHERPA_ONNX_LOGE("Unrecognized positional arguments!");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  config.Validate();
+
+  asio::io_context io_conn;  // for network connections
+  asio::io_context io_work;  // for generating audio
+
+  sherpa_onnx::OfflineTtsWebsocketServer server(io_conn, io_work, config);
+  server.Run(port);
+
+  SHERPA_ONNX_LOGE("Started!");
+  SHERPA_ONNX_LOGE("Listening on: %d", port);
+  SHERPA_ONNX_LOGE("Number of work threads: %d", num_work_threads);
+
+  // give some work to do for the io_work pool
+  auto work_guard = asio::make_work_guard(io_work);
+
+  std::vector<std::thread> io_threads;
+
+  // decrement since the main thread is also used for network communications
+  for (int32_t i = 0; i < num_io_threads - 1; ++i) {
+    io_threads.emplace_back([&io_conn]() { io_conn.run(); });
+  }
+
+  std::vector<std::thread> work_threads;
+  for (int32_t i = 0; i < num_work_threads; ++i) {
+    work_threads.emplace_back([&io_work]() { io_work.run(); });
+  }
+
+  io_conn.run();
+
+  for (auto &t : io_threads) {
+    t.join();
+  }
+
+  for (auto &t : work_threads) {
+    t.join();
+  }
+
+  return 0;
+}
@@ -19,8 +19,10 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-coalescer.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -30,7 +32,7 @@ struct SilenceInterval {
 };
 
 GeneratedAudio GeneratedAudio::ScaleSilence(float scale) const {
-  SHERPA_ONNX_LOGE(">>>> GeneratedAudio::ScaleSilence csrc/offline-tts.h start");
+  SHERPA_ONNX_LOGD(">>>> GeneratedAudio::ScaleSilence csrc/offline-tts.h start");
   if (scale == 1) {
     return *this;
   }
@@ -88,12 +90,12 @@ GeneratedAudio GeneratedAudio::ScaleSilence(float scale) const {
     ans.samples.insert(ans.samples.end(), samples.begin() + i, samples.end());
   }
 
-  SHERPA_ONNX_LOGE(">>>> GeneratedAudio::ScaleSilence csrc/offline-tts.h end");
+  SHERPA_ONNX_LOGD(">>>> GeneratedAudio::ScaleSilence csrc/offline-tts.h end");
   return ans;
 }
 
 void OfflineTtsConfig::Register(ParseOptions *po) {
-  SHERPA_ONNX_LOGE(">>>> OfflineTtsConfig::Register csrc/offline-tts.h start");
+  SHERPA_ONNX_LOGD(">>>> OfflineTtsConfig::Register csrc/offline-tts.h start");
   model.Register(po);
 
   po->Register("tts-rule-fsts", &rule_fsts,
@@ -118,11 +120,25 @@ void OfflineTtsConfig::Register(ParseOptions *po) {
   po->Register("tts-silence-scale", &silence_scale,
                "Duration of the pause is scaled by this number. So a smaller "
                "value leads to a shorter pause.");
-  SHERPA_ONNX_LOGE(">>>> OfflineTtsConfig::Register csrc/offline-tts.h end");
+
+  po->Register("tts-sentence-pipeline", &sentence_pipeline,
+               "How sentences of a long text are processed. Valid values: "
+               "serial, synthesis, task-graph. serial processes sentences one "
+               "by one. synthesis runs the frontend serially and the acoustic "
+               "model in parallel. task-graph runs G2P, BERT and the acoustic "
+               "model of all sentences in parallel. Audio is always returned "
+               "in the order of sentences. synthesis and task-graph create a "
+               "thread pool for each OfflineTts instance.");
+
+  po->Register("tts-coalesce-requests", &coalesce_requests,
+               "If true, concurrent requests with the same text, speaker ID "
+               "and speed share a single synthesis. Each of them still gets "
+               "all the audio through its own callback.");
+  SHERPA_ONNX_LOGD(">>>> OfflineTtsConfig::Register csrc/offline-tts.h end");
 }
 
 bool OfflineTtsConfig::Validate() const {
-  SHERPA_ONNX_LOGE(">>>> OfflineTtsConfig::Validate csrc/offline-tts.h start");
+  SHERPA_ONNX_LOGD(">>>> OfflineTtsConfig::Validate csrc/offline-tts.h start");
   if (!rule_fsts.empty()) {
     std::vector<std::string> files;
     SplitStringToVector(rule_fsts, ",", false, &files);
@@ -150,7 +166,16 @@ bool OfflineTtsConfig::Validate() const {
     return false;
   }
 
-  SHERPA_ONNX_LOGE(">>>> OfflineTtsConfig::Validate csrc/offline-tts.h end");
+  if (sentence_pipeline != "serial" && sentence_pipeline != "synthesis" &&
+      sentence_pipeline != "task-graph") {
+    SHERPA_ONNX_LOGE(
+        "--tts-sentence-pipeline '%s' is invalid. Valid values: serial, "
+        "synthesis, task-graph",
+        sentence_pipeline.c_str());
+    return false;
+  }
+
+  SHERPA_ONNX_LOGD(">>>> OfflineTtsConfig::Validate csrc/offline-tts.h end");
   return model.Validate();
 }
 
@@ -162,24 +187,91 @@ std::string OfflineTtsConfig::ToString() const {
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
   os << "max_num_sentences=" << max_num_sentences << ", ";
-  os << "silence_scale=" << silence_scale << ")";
+  os << "silence_scale=" << silence_scale << ", ";
+  os << "sentence_pipeline=\"" << sentence_pipeline << "\", ";
+  os << "coalesce_requests=" << (coalesce_requests ? "True" : "False") << ")";
 
   return os.str();
 }
 
 OfflineTts::OfflineTts(const OfflineTtsConfig &config)
-    : impl_(OfflineTtsImpl::Create(config)) {}
+    : impl_(OfflineTtsImpl::Create(config)) {
+  if (config.coalesce_requests) {
+    coalescer_ = std::make_unique<OfflineTtsCoalescer>(impl_->SampleRate());
+  }
+}
 
 template <typename Manager>
 OfflineTts::OfflineTts(Manager *mgr, const OfflineTtsConfig &config)
-    : impl_(OfflineTtsImpl::Create(mgr, config)) {}
+    : impl_(OfflineTtsImpl::Create(mgr, config)) {
+  if (config.coalesce_requests) {
+    coalescer_ = std::make_unique<OfflineTtsCoalescer>(impl_->SampleRate());
+  }
+}
 
 OfflineTts::~OfflineTts() = default;
 
 GeneratedAudio OfflineTts::Generate(
     const std::string &text, int64_t sid /*=0*/, float speed /*= 1.0*/,
     GeneratedAudioCallback callback /*= nullptr*/) const {
-      SHERPA_ONNX_LOGE(">>>> OfflineTts::Generate csrc/offline-tts.cc start");
+  if (!Tracer::IsEnabled()) {
+    return GenerateImpl(text, sid, speed, std::move(callback));
+  }
+
+  TraceRequest request;
+  GeneratedAudio ans;
+  {
+    ScopedTraceRequest scoped_request(&request);
+    ans = GenerateImpl(text, sid, speed, std::move(callback));
+  }
+  ans.trace = request.ToJson();
+
+  return ans;
+}
+
+GeneratedAudio OfflineTts::Generate(
+    const std::string &text, int64_t sid, float speed,
+    GeneratedAudioCallback callback,
+    const OfflineTtsRequestOptions &options) const {
+  if (options.IsCancelled()) {
+    GeneratedAudio ans;
+    ans.sample_rate = SampleRate();
+    return ans;
+  }
+
+  ScopedOfflineTtsRequest scoped_options(&options);
+
+  // The callback is not called once the request is cancelled
+  auto wrapper = [&options, &callback](const float *samples, int32_t n,
+                                       float progress) -> int32_t {
+    if (options.IsCancelled()) {
+      return 0;
+    }
+
+    return callback ? callback(samples, n, progress) : 1;
+  };
+
+  return Generate(text, sid, speed, wrapper);
+}
+
+GeneratedAudio OfflineTts::GenerateImpl(const std::string &text, int64_t sid,
+                                        float speed,
+                                        GeneratedAudioCallback callback) const {
+  if (!coalescer_) {
+    return GenerateWithModel(text, sid, speed, std::move(callback));
+  }
+
+  return coalescer_->Run(
+      OfflineTtsCoalescer::GetKey(text, sid, speed), std::move(callback),
+      [this, &text, sid, speed](GeneratedAudioCallback cb) {
+        return GenerateWithModel(text, sid, speed, std::move(cb));
+      });
+}
+
+GeneratedAudio OfflineTts::GenerateWithModel(
+    const std::string &text, int64_t sid, float speed,
+    GeneratedAudioCallback callback) const {
+      SHERPA_ONNX_LOGD(">>>> OfflineTts::Generate csrc/offline-tts.cc start");
 #if !defined(_WIN32)
   return impl_->Generate(text, sid, speed, std::move(callback));
 #else
@@ -190,19 +282,50 @@ GeneratedAudio OfflineTts::Generate(
     auto utf8_text = Gb2312ToUtf8(text);
     static bool printed = false;
     if (!printed) {
-      SHERPA_ONNX_LOGE(
+      SHERPA_ONNX_LOGW(
           "Detected GB2312 encoded string! Converting it to UTF8.");
       printed = true;
     }
     return impl_->Generate(utf8_text, sid, speed, std::move(callback));
   } else {
-    SHERPA_ONNX_LOGE(
+    SHERPA_ONNX_LOGW(
         "Non UTF8 encoded string is received. You would not get expected "
         "results!");
     return impl_->Generate(text, sid, speed, std::move(callback));
   }
 #endif
-  SHERPA_ONNX_LOGE(">>>> OfflineTts::Generate csrc/offline-tts.cc end");
+  SHERPA_ONNX_LOGD(">>>> OfflineTts::Generate csrc/offline-tts.cc end");
+}
+
+int64_t OfflineTts::GenerateEncoded(const std::string &text, int64_t sid,
+                                    float speed,
+                                    const TelephonyEncoderConfig &output_config,
+                                    EncodedAudioCallback callback) const {
+  if (!output_config.Validate()) {
+    return -1;
+  }
+
+  TelephonyEncoder encoder(SampleRate(), output_config);
+
+  float progress = 0;
+  auto frame_callback = [&callback, &progress](const uint8_t *data,
+                                               int32_t n) -> int32_t {
+    return callback ? callback(data, n, progress) : 1;
+  };
+
+  int32_t should_continue = 1;
+  Generate(text, sid, speed,
+           [&](const float *samples, int32_t n, float p) -> int32_t {
+             progress = p;
+             should_continue = encoder.Accept(samples, n, frame_callback);
+             return should_continue;
+           });
+
+  if (should_continue) {
+    encoder.Flush(frame_callback);
+  }
+
+  return encoder.NumFrames();
 }
 
 int32_t OfflineTts::SampleRate() const { return impl_->SampleRate(); }
@@ -11,7 +11,9 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-tts-model-config.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/telephony-encoder.h"
 
 namespace sherpa_onnx {
 
@@ -37,6 +39,25 @@ struct OfflineTtsConfig {
   // the duration of the new interval is old_duration * silence_scale.
   float silence_scale = 0.2;
 
+  // How the sentences of a long text are processed. Used only by models
+  // whose frontend supports OfflineTtsFrontend::SplitSentences(), e.g.,
+  // MeloTTS Korean.
+  //  - serial: all stages run one sentence after another
+  //  - synthesis: the frontend runs on the calling thread and the
+  //               acoustic model runs on sentences in parallel
+  //  - task-graph: G2P, BERT and the acoustic model of each sentence form
+  //                a chain and chains of all sentences run in parallel.
+  //                See offline-tts-sentence-task-graph.h. Other frontends
+  //                use the synthesis pipeline.
+  //
+  // synthesis and task-graph create a pool of hardware_concurrency()
+  // threads for each OfflineTts instance, so serial is the default.
+  std::string sentence_pipeline = "serial";
+
+  // If true, concurrent requests with the same text, speaker ID and speed
+  // share a single synthesis. See offline-tts-coalescer.h
+  bool coalesce_requests = false;
+
   OfflineTtsConfig() = default;
   OfflineTtsConfig(const OfflineTtsModelConfig &model,
                    const std::string &rule_fsts, const std::string &rule_fars,
@@ -57,12 +78,17 @@ struct GeneratedAudio {
   std::vector<float> samples;
   int32_t sample_rate;
 
+  // Per-stage timings of this request in JSON. See TraceStats::ToJson().
+  // It is empty if the tracer is disabled. See trace.h
+  std::string trace;
+
   // Silence means pause here.
   // If scale > 1, then it increases the duration of a pause
   // If scale < 1, then it reduces the duration of a pause
   GeneratedAudio ScaleSilence(float scale) const;
 };
 
+class OfflineTtsCoalescer;
 class OfflineTtsImpl;
 
 // If the callback returns 0, then it stop generating
@@ -70,6 +96,12 @@ class OfflineTtsImpl;
 using GeneratedAudioCallback = std::function<int32_t(
     const float * /*samples*/, int32_t /*n*/, float /*progress*/)>;
 
+// It is called with one encoded frame of n bytes.
+// If the callback returns 0, then it stop generating
+// if the callback returns 1, then it keeps generating
+using EncodedAudioCallback = std::function<int32_t(
+    const uint8_t * /*data*/, int32_t /*n*/, float /*progress*/)>;
+
 class OfflineTts {
  public:
   ~OfflineTts();
@@ -95,6 +127,38 @@ class OfflineTts {
                           float speed = 1.0,
                           GeneratedAudioCallback callback = nullptr) const;
 
+  // Like Generate(), but the request has a priority and it can be
+  // cancelled, e.g., when the client disconnects, or given a deadline.
+  //
+  // Once options.IsCancelled() returns true, queued work of the request is
+  // dropped, running ORT sessions are terminated if the token is cancelled,
+  // the callback is no longer called and the audio generated so far is
+  // returned.
+  //
+  // Caution: If config.coalesce_requests is true, identical requests share
+  // one synthesis, which runs with its own options instead of those of
+  // any request: the priority of the request that started it and no
+  // deadline. A cancelled request stops receiving audio. However, if it
+  // started the synthesis and other requests still use it, this call
+  // returns only after the synthesis has finished.
+  GeneratedAudio Generate(const std::string &text, int64_t sid, float speed,
+                          GeneratedAudioCallback callback,
+                          const OfflineTtsRequestOptions &options) const;
+
+  // Like Generate(), but the audio is resampled to
+  // output_config.sample_rate, encoded with output_config.encoding, e.g.,
+  // mu-law, and delivered to the callback in frames of
+  // output_config.frame_ms milliseconds, e.g., 20 ms for RTP.
+  //
+  // Resampling is incremental, so the first frame is available as soon as
+  // the first callback of Generate() fires.
+  //
+  // @return Return the number of frames passed to the callback.
+  //         Return -1 if output_config is invalid.
+  int64_t GenerateEncoded(const std::string &text, int64_t sid, float speed,
+                          const TelephonyEncoderConfig &output_config,
+                          EncodedAudioCallback callback) const;
+
   // Return the sample rate of the generated audio
   int32_t SampleRate() const;
 
@@ -102,8 +166,20 @@ class OfflineTts {
   // If it supports only a single speaker, then it return 0 or 1.
   int32_t NumSpeakers() const;
 
+ private:
+  GeneratedAudio GenerateImpl(const std::string &text, int64_t sid,
+                              float speed,
+                              GeneratedAudioCallback callback) const;
+
+  GeneratedAudio GenerateWithModel(const std::string &text, int64_t sid,
+                                   float speed,
+                                   GeneratedAudioCallback callback) const;
+
  private:
   std::unique_ptr<OfflineTtsImpl> impl_;
+
+  // Not null if config.coalesce_requests is true
+  std::unique_ptr<OfflineTtsCoalescer> coalescer_;
 };
 
 }  // namespace sherpa_onnx
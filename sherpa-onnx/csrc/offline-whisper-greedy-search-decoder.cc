@@ -9,6 +9,7 @@
 
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -78,10 +79,12 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
 
   auto self_kv_cache = model_->GetInitialSelfKVCache();
 
+  ScopedTrace decoder_trace(TraceStage::kDecoder);
   auto decoder_out = model_->ForwardDecoder(
       std::move(tokens), std::move(self_kv_cache.first),
       std::move(self_kv_cache.second), std::move(cross_k), std::move(cross_v),
       std::move(offset));
+  decoder_trace.Stop();
 
   *(std::get<5>(decoder_out).GetTensorMutableData<int64_t>()) =
       initial_tokens.size();
@@ -119,12 +122,14 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
     int64_t *p_tokens = tokens.GetTensorMutableData<int64_t>();
     p_tokens[0] = max_token_id;
 
+    ScopedTrace decoder_trace(TraceStage::kDecoder);
     decoder_out = model_->ForwardDecoder(std::move(tokens),
                                          std::move(std::get<1>(decoder_out)),
                                          std::move(std::get<2>(decoder_out)),
                                          std::move(std::get<3>(decoder_out)),
                                          std::move(std::get<4>(decoder_out)),
                                          std::move(std::get<5>(decoder_out)));
+    decoder_trace.Stop();
 
     int64_t *p_offset =
         std::get<5>(decoder_out).GetTensorMutableData<int64_t>();
@@ -10,6 +10,7 @@
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -35,15 +36,13 @@ class OfflineWhisperModel::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
-    {
-      auto buf = ReadFile(config.whisper.encoder);
-      InitEncoder(buf.data(), buf.size());
-    }
+    encoder_sess_ = CreateSession(env_, config.whisper.encoder, sess_opts_,
+                                  config.session_config, config.provider);
+    InitEncoder();
 
-    {
-      auto buf = ReadFile(config.whisper.decoder);
-      InitDecoder(buf.data(), buf.size());
-    }
+    decoder_sess_ = CreateSession(env_, config.whisper.decoder, sess_opts_,
+                                  config.session_config, config.provider);
+    InitDecoder();
   }
 
   explicit Impl(const SpokenLanguageIdentificationConfig &config)
@@ -130,21 +129,30 @@ class OfflineWhisperModel::Impl {
 
   int32_t DetectLanguage(Ort::Value &cross_k,    // NOLINT
                          Ort::Value &cross_v) {  // NOLINT
-    int64_t token_val = SOT();
-    std::array<int64_t, 2> token_shape{1, 1};
+    return DetectLanguages(cross_k, cross_v)[0];
+  }
+
+  std::vector<int32_t> DetectLanguages(Ort::Value &cross_k,    // NOLINT
+                                       Ort::Value &cross_v) {  // NOLINT
+    // (n_text_layer, batch_size, n_audio_ctx, n_text_state)
+    int32_t batch_size = cross_k.GetTensorTypeAndShapeInfo().GetShape()[1];
+
+    std::vector<int64_t> token_val(batch_size, SOT());
+    std::array<int64_t, 2> token_shape{batch_size, 1};
 
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    Ort::Value tokens = Ort::Value::CreateTensor(
-        memory_info, &token_val, 1, token_shape.data(), token_shape.size());
+    Ort::Value tokens =
+        Ort::Value::CreateTensor(memory_info, token_val.data(), batch_size,
+                                 token_shape.data(), token_shape.size());
 
-    auto self_kv_cache = GetInitialSelfKVCache();
+    auto self_kv_cache = GetInitialSelfKVCache(batch_size);
 
-    std::array<int64_t, 1> offset_shape{1};
+    std::array<int64_t, 1> offset_shape{batch_size};
     Ort::Value offset = Ort::Value::CreateTensor<int64_t>(
         Allocator(), offset_shape.data(), offset_shape.size());
-    *(offset.GetTensorMutableData<int64_t>()) = 0;
+    std::fill_n(offset.GetTensorMutableData<int64_t>(), batch_size, 0);
 
     auto decoder_out =
         ForwardDecoder(std::move(tokens), std::move(self_kv_cache.first),
@@ -154,32 +162,45 @@ class OfflineWhisperModel::Impl {
     cross_k = std::move(std::get<3>(decoder_out));
     cross_v = std::move(std::get<4>(decoder_out));
 
-    const float *p_logits = std::get<0>(decoder_out).GetTensorData<float>();
+    // (batch_size, 1, vocab_size)
+    const auto &logits = std::get<0>(decoder_out);
+    int32_t vocab_size = logits.GetTensorTypeAndShapeInfo().GetShape()[2];
+
     const auto &all_language_ids = GetAllLanguageIDs();
 
-    int32_t lang_id = all_language_ids[0];
-    float this_logit = p_logits[lang_id];
+    std::vector<int32_t> ans(batch_size);
+
+    for (int32_t b = 0; b != batch_size; ++b) {
+      const float *p_logits = logits.GetTensorData<float>() + b * vocab_size;
+
+      int32_t lang_id = all_language_ids[0];
+      float this_logit = p_logits[lang_id];
 
-    for (int32_t i = 1; i != all_language_ids.size(); ++i) {
-      int32_t id = all_language_ids[i];
-      float p = p_logits[id];
+      for (int32_t i = 1; i != all_language_ids.size(); ++i) {
+        int32_t id = all_language_ids[i];
+        float p = p_logits[id];
 
-      if (p > this_logit) {
-        this_logit = p;
-        lang_id = id;
+        if (p > this_logit) {
+          this_logit = p;
+          lang_id = id;
+        }
       }
-    }
 
-    if (config_.debug) {
-      SHERPA_ONNX_LOGE("Detected language: %s",
-                       GetID2Lang().at(lang_id).c_str());
+      if (config_.debug) {
+        SHERPA_ONNX_LOGE("Detected language: %s",
+                         GetID2Lang().at(lang_id).c_str());
+      }
+
+      ans[b] = lang_id;
     }
 
-    return lang_id;
+    return ans;
   }
 
-  std::pair<Ort::Value, Ort::Value> GetInitialSelfKVCache() {
-    std::array<int64_t, 4> shape{n_text_layer_, 1, n_text_ctx_, n_text_state_};
+  std::pair<Ort::Value, Ort::Value> GetInitialSelfKVCache(
+      int32_t batch_size = 1) {
+    std::array<int64_t, 4> shape{n_text_layer_, batch_size, n_text_ctx_,
+                                 n_text_state_};
 
     Ort::Value n_layer_self_k_cache = Ort::Value::CreateTensor<float>(
         Allocator(), shape.data(), shape.size());
@@ -234,7 +255,11 @@ class OfflineWhisperModel::Impl {
   void InitEncoder(void *model_data, size_t model_data_length) {
     encoder_sess_ = std::make_unique<Ort::Session>(
         env_, model_data, model_data_length, sess_opts_);
+    InitEncoder();
+  }
 
+  // encoder_sess_ has been created
+  void InitEncoder() {
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
 
@@ -293,7 +318,11 @@ class OfflineWhisperModel::Impl {
   void InitDecoder(void *model_data, size_t model_data_length) {
     decoder_sess_ = std::make_unique<Ort::Session>(
         env_, model_data, model_data_length, sess_opts_);
+    InitDecoder();
+  }
 
+  // decoder_sess_ has been created
+  void InitDecoder() {
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
 
@@ -388,6 +417,12 @@ int32_t OfflineWhisperModel::DetectLanguage(Ort::Value &cross_k,    // NOLINT
   return impl_->DetectLanguage(cross_k, cross_v);
 }
 
+std::vector<int32_t> OfflineWhisperModel::DetectLanguages(
+    Ort::Value &cross_k,    // NOLINT
+    Ort::Value &cross_v) {  // NOLINT
+  return impl_->DetectLanguages(cross_k, cross_v);
+}
+
 std::pair<Ort::Value, Ort::Value> OfflineWhisperModel::GetInitialSelfKVCache()
     const {
   return impl_->GetInitialSelfKVCache();
@@ -77,6 +77,11 @@ class OfflineWhisperModel {
   int32_t DetectLanguage(Ort::Value &cross_k,   // NOLINT
                          Ort::Value &cross_v);  // NOLINT
 
+  // Like DetectLanguage(), but it returns the language ID of each
+  // utterance in the batch. The batch size is cross_k.shape[1].
+  std::vector<int32_t> DetectLanguages(Ort::Value &cross_k,   // NOLINT
+                                       Ort::Value &cross_v);  // NOLINT
+
   /** Return the initial self kv cache in a pair
    *  - n_layer_self_k_cache A 4-D tensor of shape
    *                         (n_text_layer, N, n_audio_ctx, n_text_state).
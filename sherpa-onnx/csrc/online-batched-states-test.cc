@@ -0,0 +1,245 @@
+// sherpa-onnx/csrc/online-batched-states-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-batched-states.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/stack.h"
+#include "sherpa-onnx/csrc/unbind.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+constexpr int32_t kDim = 3;
+
+// The states of a stream are two tensors of shape (kDim,). All elements
+// of state k of stream i are 10 * i + k.
+std::vector<Ort::Value> CreateStates(OrtAllocator *allocator, int32_t i) {
+  std::array<int64_t, 1> shape{kDim};
+
+  std::vector<Ort::Value> ans;
+  for (int32_t k = 0; k != 2; ++k) {
+    Ort::Value v =
+        Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+    Fill<float>(&v, 10 * i + k);
+    ans.push_back(std::move(v));
+  }
+
+  return ans;
+}
+
+// Stack states of n streams into two tensors of shape (n, kDim)
+std::vector<Ort::Value> StackStates(OrtAllocator *allocator, int32_t n) {
+  std::vector<std::vector<Ort::Value>> states;
+  for (int32_t i = 0; i != n; ++i) {
+    states.push_back(CreateStates(allocator, i));
+  }
+
+  std::vector<Ort::Value> ans;
+  for (int32_t k = 0; k != 2; ++k) {
+    std::vector<const Ort::Value *> buf;
+    for (int32_t i = 0; i != n; ++i) {
+      buf.push_back(&states[i][k]);
+    }
+    ans.push_back(Stack(allocator, buf, 0));
+  }
+
+  return ans;
+}
+
+// Return a function unstacking the output of StackStates(). *num_calls is
+// incremented at each call.
+BatchedStates::UnStackFunc GetUnStackFunc(OrtAllocator *allocator,
+                                          int32_t *num_calls) {
+  return [allocator, num_calls](std::vector<Ort::Value> stacked) {
+    *num_calls += 1;
+
+    std::vector<std::vector<Ort::Value>> ans;
+    for (int32_t k = 0; k != static_cast<int32_t>(stacked.size()); ++k) {
+      std::vector<Ort::Value> v = Unbind(allocator, &stacked[k], 0);
+      ans.resize(v.size());
+      for (int32_t i = 0; i != static_cast<int32_t>(v.size()); ++i) {
+        ans[i].push_back(std::move(v[i]));
+      }
+    }
+
+    return ans;
+  };
+}
+
+// Check that states are those of stream i as created by CreateStates()
+void ExpectStatesOf(const std::vector<Ort::Value> &states, int32_t i) {
+  ASSERT_EQ(states.size(), 2u);
+  for (int32_t k = 0; k != 2; ++k) {
+    const float *p = states[k].GetTensorData<float>();
+    for (int32_t d = 0; d != kDim; ++d) {
+      EXPECT_EQ(p[d], 10 * i + k) << "stream " << i << ", state " << k;
+    }
+  }
+}
+
+// Check that row i of each stacked state is the states of stream i
+void ExpectStacked(const std::vector<Ort::Value> &stacked, int32_t n) {
+  ASSERT_EQ(stacked.size(), 2u);
+  for (int32_t k = 0; k != 2; ++k) {
+    auto shape = stacked[k].GetTensorTypeAndShapeInfo().GetShape();
+    ASSERT_EQ(shape.size(), 2u);
+    EXPECT_EQ(shape[0], n);
+    EXPECT_EQ(shape[1], kDim);
+
+    const float *p = stacked[k].GetTensorData<float>();
+    for (int32_t i = 0; i != n; ++i) {
+      for (int32_t d = 0; d != kDim; ++d) {
+        EXPECT_EQ(p[i * kDim + d], 10 * i + k);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(BatchedStates, GetUnstacksOnce) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  int32_t num_calls = 0;
+
+  BatchedStates batch(StackStates(allocator, 3), 3,
+                      GetUnStackFunc(allocator, &num_calls));
+  EXPECT_EQ(batch.BatchSize(), 3);
+
+  ExpectStatesOf(batch.Get(2), 2);
+  ExpectStatesOf(batch.Get(0), 0);
+  EXPECT_EQ(num_calls, 1);
+
+  // The stacked states are gone after unstacking
+  EXPECT_TRUE(batch.TakeStacked().empty());
+  EXPECT_TRUE(batch.CloneStacked(allocator).empty());
+}
+
+TEST(BatchedStates, TakeAndClone) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  int32_t num_calls = 0;
+
+  BatchedStates batch(StackStates(allocator, 2), 2,
+                      GetUnStackFunc(allocator, &num_calls));
+
+  // Cloning keeps the stacked states in the batch
+  ExpectStacked(batch.CloneStacked(allocator), 2);
+  ExpectStacked(batch.TakeStacked(), 2);
+  EXPECT_EQ(num_calls, 0);
+
+  EXPECT_TRUE(batch.TakeStacked().empty());
+  EXPECT_TRUE(batch.Get(0).empty());
+}
+
+TEST(TakeBatchedStates, ReuseStackedStates) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  int32_t num_calls = 0;
+  int32_t n = 3;
+
+  auto batch = std::make_shared<BatchedStates>(
+      StackStates(allocator, n), n, GetUnStackFunc(allocator, &num_calls));
+
+  std::vector<std::unique_ptr<OnlineStream>> streams;
+  for (int32_t i = 0; i != n; ++i) {
+    streams.push_back(std::make_unique<OnlineStream>());
+    streams.back()->SetBatchedStates(batch, i);
+    EXPECT_TRUE(streams.back()->StatesAreInBatch());
+  }
+
+  // The same streams in a different order
+  std::vector<OnlineStream *> ss = {streams[2].get(), streams[0].get(),
+                                    streams[1].get()};
+  std::vector<OnlineStream *> sorted;
+  std::vector<Ort::Value> stacked = TakeBatchedStates(ss.data(), n, &sorted);
+
+  ExpectStacked(stacked, n);
+  EXPECT_EQ(num_calls, 0);
+
+  ASSERT_EQ(static_cast<int32_t>(sorted.size()), n);
+  for (int32_t i = 0; i != n; ++i) {
+    EXPECT_EQ(sorted[i], streams[i].get());
+  }
+}
+
+TEST(TakeBatchedStates, PartialBatch) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  int32_t num_calls = 0;
+  int32_t n = 3;
+
+  auto batch = std::make_shared<BatchedStates>(
+      StackStates(allocator, n), n, GetUnStackFunc(allocator, &num_calls));
+
+  std::vector<std::unique_ptr<OnlineStream>> streams;
+  for (int32_t i = 0; i != n; ++i) {
+    streams.push_back(std::make_unique<OnlineStream>());
+    streams.back()->SetBatchedStates(batch, i);
+  }
+
+  // Only 2 of the 3 streams of the batch
+  std::vector<OnlineStream *> ss = {streams[0].get(), streams[2].get()};
+  std::vector<OnlineStream *> sorted;
+  EXPECT_TRUE(TakeBatchedStates(ss.data(), ss.size(), &sorted).empty());
+
+  // The same stream twice
+  ss = {streams[0].get(), streams[0].get(), streams[1].get()};
+  EXPECT_TRUE(TakeBatchedStates(ss.data(), ss.size(), &sorted).empty());
+  EXPECT_EQ(num_calls, 0);
+
+  // Each stream takes its own states
+  ExpectStatesOf(streams[2]->GetStates(), 2);
+  EXPECT_FALSE(streams[2]->StatesAreInBatch());
+  EXPECT_TRUE(streams[0]->StatesAreInBatch());
+
+  ExpectStatesOf(streams[0]->GetStates(), 0);
+  ExpectStatesOf(streams[1]->GetStates(), 1);
+  EXPECT_EQ(num_calls, 1);
+
+  // A second call returns the same states
+  ExpectStatesOf(streams[2]->GetStates(), 2);
+
+  // The stacked states are no longer available
+  ss = {streams[0].get(), streams[1].get(), streams[2].get()};
+  EXPECT_TRUE(TakeBatchedStates(ss.data(), ss.size(), &sorted).empty());
+}
+
+TEST(TakeBatchedStates, SetStatesInvalidates) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  int32_t num_calls = 0;
+  int32_t n = 2;
+
+  auto batch = std::make_shared<BatchedStates>(
+      StackStates(allocator, n), n, GetUnStackFunc(allocator, &num_calls));
+
+  std::vector<std::unique_ptr<OnlineStream>> streams;
+  for (int32_t i = 0; i != n; ++i) {
+    streams.push_back(std::make_unique<OnlineStream>());
+    streams.back()->SetBatchedStates(batch, i);
+  }
+
+  // e.g., the encoder states are reset at an endpoint
+  streams[1]->SetStates(CreateStates(allocator, 5));
+
+  int32_t slot = -1;
+  EXPECT_EQ(streams[1]->GetBatchedStates(&slot), nullptr);
+  EXPECT_FALSE(streams[1]->StatesAreInBatch());
+  ExpectStatesOf(streams[1]->GetStates(), 5);
+
+  std::vector<OnlineStream *> ss = {streams[0].get(), streams[1].get()};
+  std::vector<OnlineStream *> sorted;
+  EXPECT_TRUE(TakeBatchedStates(ss.data(), ss.size(), &sorted).empty());
+
+  // The other stream still gets its states from the batch
+  ExpectStatesOf(streams[0]->GetStates(), 0);
+  EXPECT_EQ(num_calls, 1);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,82 @@
+// sherpa-onnx/csrc/online-batched-states.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-batched-states.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
+
+namespace sherpa_onnx {
+
+BatchedStates::BatchedStates(std::vector<Ort::Value> states,
+                             int32_t batch_size, UnStackFunc unstack)
+    : stacked_(std::move(states)),
+      batch_size_(batch_size),
+      unstack_(std::move(unstack)) {}
+
+std::vector<Ort::Value> BatchedStates::Get(int32_t slot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (unstacked_.empty()) {
+    if (stacked_.empty()) {
+      SHERPA_ONNX_LOGE("The states of slot %d have been taken", slot);
+      return {};
+    }
+
+    unstacked_ = unstack_(std::move(stacked_));
+    stacked_.clear();
+  }
+
+  return std::move(unstacked_[slot]);
+}
+
+std::vector<Ort::Value> BatchedStates::TakeStacked() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<Ort::Value> ans = std::move(stacked_);
+  stacked_.clear();
+
+  return ans;
+}
+
+std::vector<Ort::Value> BatchedStates::CloneStacked(OrtAllocator *allocator) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<Ort::Value> ans;
+  ans.reserve(stacked_.size());
+  for (const auto &v : stacked_) {
+    ans.push_back(Clone(allocator, &v));
+  }
+
+  return ans;
+}
+
+std::vector<Ort::Value> TakeBatchedStates(
+    OnlineStream **ss, int32_t n, std::vector<OnlineStream *> *sorted) {
+  int32_t slot = -1;
+  BatchedStates *batch = ss[0]->GetBatchedStates(&slot).get();
+  if (!batch || batch->BatchSize() != n) {
+    return {};
+  }
+
+  sorted->assign(n, nullptr);
+
+  for (int32_t i = 0; i != n; ++i) {
+    if (ss[i]->GetBatchedStates(&slot).get() != batch ||
+        (*sorted)[slot] != nullptr) {
+      return {};
+    }
+
+    (*sorted)[slot] = ss[i];
+  }
+
+  return batch->TakeStacked();
+}
+
+}  // namespace sherpa_onnx
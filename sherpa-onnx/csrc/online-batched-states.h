@@ -0,0 +1,82 @@
+// sherpa-onnx/csrc/online-batched-states.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_ONLINE_BATCHED_STATES_H_
+#define SHERPA_ONNX_CSRC_ONLINE_BATCHED_STATES_H_
+
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace sherpa_onnx {
+
+class OnlineStream;
+
+/* Model states of a batch of streams, stacked along the batch axis as
+ * returned by the model.
+ *
+ * After decoding a batch, each stream refers to the batch with its index
+ * (slot) in it instead of holding its own states. If the next batch
+ * contains exactly the same streams, the stacked states are passed to the
+ * model as they are, so StackStates() and UnStackStates() are skipped.
+ * Otherwise, a stream takes its own states on first use, see
+ * OnlineStream::GetStates().
+ */
+class BatchedStates {
+ public:
+  using UnStackFunc = std::function<std::vector<std::vector<Ort::Value>>(
+      std::vector<Ort::Value>)>;
+
+  /**
+   * @param states Stacked states of batch_size streams.
+   * @param batch_size Number of streams in the batch.
+   * @param unstack Split stacked states into states of each stream. It is
+   *                usually a wrapper around UnStackStates() of the model,
+   *                so the model must outlive this object.
+   */
+  BatchedStates(std::vector<Ort::Value> states, int32_t batch_size,
+                UnStackFunc unstack);
+
+  int32_t BatchSize() const { return batch_size_; }
+
+  // Return the states of the stream at the given slot. The first call
+  // unstacks the states of all slots.
+  std::vector<Ort::Value> Get(int32_t slot);
+
+  // Return the stacked states and leave this object empty. Return an empty
+  // vector if they have already been unstacked or taken.
+  std::vector<Ort::Value> TakeStacked();
+
+  // Return a copy of the stacked states, which are kept in this object.
+  // Return an empty vector if they have already been unstacked or taken.
+  std::vector<Ort::Value> CloneStacked(OrtAllocator *allocator);
+
+ private:
+  // Streams of a batch may be used by different threads afterwards
+  std::mutex mutex_;
+  std::vector<Ort::Value> stacked_;
+  std::vector<std::vector<Ort::Value>> unstacked_;
+  int32_t batch_size_;
+  UnStackFunc unstack_;
+};
+
+/** If ss[0], ..., ss[n-1] are exactly the streams of one BatchedStates
+ * object, take its stacked states.
+ *
+ * @param ss Pointer to an array of n streams.
+ * @param n Number of streams.
+ * @param sorted On success, it contains the streams of ss sorted by their
+ *               slots, i.e., in the order of the returned states.
+ *
+ * @return Return the stacked states on success. Return an empty vector
+ *         otherwise.
+ */
+std::vector<Ort::Value> TakeBatchedStates(OnlineStream **ss, int32_t n,
+                                          std::vector<OnlineStream *> *sorted);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_BATCHED_STATES_H_
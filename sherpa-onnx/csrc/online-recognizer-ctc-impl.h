@@ -15,12 +15,14 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-batched-states.h"
 #include "sherpa-onnx/csrc/online-ctc-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-fst-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-model.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -143,6 +145,14 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
     std::vector<std::vector<Ort::Value>> states_vec(n);
     std::vector<int64_t> all_processed_frames(n);
 
+    // If ss contains the same streams as the previous call, reuse the
+    // output states of that call without unstacking and stacking them
+    std::vector<OnlineStream *> sorted;
+    std::vector<Ort::Value> states = TakeBatchedStates(ss, n, &sorted);
+    if (!states.empty()) {
+      ss = sorted.data();
+    }
+
     for (int32_t i = 0; i != n; ++i) {
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
       std::vector<float> features =
@@ -155,7 +165,9 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
                 features_vec.data() + i * chunk_length * feat_dim);
 
       results[i] = std::move(ss[i]->GetCtcResult());
-      states_vec[i] = std::move(ss[i]->GetStates());
+      if (states.empty()) {
+        states_vec[i] = std::move(ss[i]->GetStates());
+      }
       all_processed_frames[i] = num_processed_frames;
     }
 
@@ -168,9 +180,14 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
                                             features_vec.size(), x_shape.data(),
                                             x_shape.size());
 
-    auto states = model_->StackStates(std::move(states_vec));
+    if (states.empty()) {
+      states = model_->StackStates(std::move(states_vec));
+    }
+
     int32_t num_states = states.size();
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto out = model_->Forward(std::move(x), std::move(states));
+    encoder_trace.Stop();
     std::vector<Ort::Value> out_states;
     out_states.reserve(num_states);
 
@@ -178,8 +195,11 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
       out_states.push_back(std::move(out[k]));
     }
 
-    std::vector<std::vector<Ort::Value>> next_states =
-        model_->UnStackStates(std::move(out_states));
+    auto next_states = std::make_shared<BatchedStates>(
+        std::move(out_states), n,
+        [model = model_.get()](std::vector<Ort::Value> s) {
+          return model->UnStackStates(std::move(s));
+        });
 
     std::vector<int64_t> log_probs_shape =
         out[0].GetTensorTypeAndShapeInfo().GetShape();
@@ -188,7 +208,7 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
 
     for (int32_t k = 0; k != n; ++k) {
       ss[k]->SetCtcResult(results[k]);
-      ss[k]->SetStates(std::move(next_states[k]));
+      ss[k]->SetBatchedStates(next_states, k);
     }
   }
 
@@ -296,7 +316,9 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
     Ort::Value x =
         Ort::Value::CreateTensor(memory_info, frames.data(), frames.size(),
                                  x_shape.data(), x_shape.size());
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto out = model_->Forward(std::move(x), std::move(s->GetStates()));
+    encoder_trace.Stop();
     int32_t num_states = static_cast<int32_t>(out.size()) - 1;
 
     std::vector<Ort::Value> states;
@@ -19,6 +19,7 @@
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -251,8 +252,10 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
     Ort::Value x_length =
         Ort::Value::CreateTensor(memory_info, &x_len_val, 1, &x_len_shape, 1);
 
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto encoder_out_vec =
         model_.ForwardEncoder(std::move(x), std::move(x_length));
+    encoder_trace.Stop();
 
     // CIF search
     auto &encoder_out = encoder_out_vec[0];
@@ -350,10 +353,12 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
         memory_info, &num_tokens, 1, acoustic_embedding_length_shape.data(),
         acoustic_embedding_length_shape.size());
 
+    ScopedTrace decoder_trace(TraceStage::kDecoder);
     auto decoder_out_vec = model_.ForwardDecoder(
         std::move(encoder_out), std::move(encoder_out_len),
         std::move(acoustic_embedding_tensor),
         std::move(acoustic_embedding_length_tensor), std::move(states));
+    decoder_trace.Stop();
 
     states.reserve(model_.DecoderNumBlocks());
     for (int32_t i = 2; i != decoder_out_vec.size(); ++i) {
@@ -6,9 +6,10 @@
 #define SHERPA_ONNX_CSRC_ONLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <ios>
 #include <memory>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
@@ -16,15 +17,18 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-batched-states.h"
 #include "sherpa-onnx/csrc/online-lm.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-transducer-decoder-out-cache.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-model.h"
 #include "sherpa-onnx/csrc/online-transducer-modified-beam-search-decoder.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/utils.h"
 #include "ssentencepiece/csrc/ssentencepiece.h"
 
@@ -101,6 +105,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     }
 
     model_->SetFeatureDim(config.feat_config.feature_dim);
+    InitDecoderOutCache();
 
     if (config.decoding_method == "modified_beam_search") {
       if (!config_.model_config.bpe_vocab.empty()) {
@@ -119,14 +124,15 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       }
 
       decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
-          model_.get(), lm_.get(), config_.max_active_paths,
-          config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
-          config_.blank_penalty, config_.temperature_scale);
+          model_.get(), decoder_out_cache_.get(), lm_.get(),
+          config_.max_active_paths, config_.lm_config.scale,
+          config_.lm_config.shallow_fusion, unk_id_, config_.blank_penalty,
+          config_.temperature_scale);
 
     } else if (config.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OnlineTransducerGreedySearchDecoder>(
-          model_.get(), unk_id_, config_.blank_penalty,
-          config_.temperature_scale);
+          model_.get(), decoder_out_cache_.get(), unk_id_,
+          config_.blank_penalty, config_.temperature_scale);
 
     } else {
       SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
@@ -148,6 +154,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     }
 
     model_->SetFeatureDim(config.feat_config.feature_dim);
+    InitDecoderOutCache();
 
     if (config.decoding_method == "modified_beam_search") {
 #if 0
@@ -168,14 +175,15 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       }
 
       decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
-          model_.get(), lm_.get(), config_.max_active_paths,
-          config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
-          config_.blank_penalty, config_.temperature_scale);
+          model_.get(), decoder_out_cache_.get(), lm_.get(),
+          config_.max_active_paths, config_.lm_config.scale,
+          config_.lm_config.shallow_fusion, unk_id_, config_.blank_penalty,
+          config_.temperature_scale);
 
     } else if (config.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OnlineTransducerGreedySearchDecoder>(
-          model_.get(), unk_id_, config_.blank_penalty,
-          config_.temperature_scale);
+          model_.get(), decoder_out_cache_.get(), unk_id_,
+          config_.blank_penalty, config_.temperature_scale);
 
     } else {
       SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
@@ -184,6 +192,17 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     }
   }
 
+  ~OnlineRecognizerTransducerImpl() override {
+    if (config_.model_config.debug && decoder_out_cache_->NumLookups() > 0) {
+      SHERPA_ONNX_LOGE(
+          "Decoder out cache: %lld lookups, %lld hits, hit rate %.2f%%",
+          static_cast<long long>(decoder_out_cache_->NumLookups()),  // NOLINT
+          static_cast<long long>(decoder_out_cache_->NumHits()),     // NOLINT
+          100.0 * decoder_out_cache_->NumHits() /
+              decoder_out_cache_->NumLookups());
+    }
+  }
+
   std::unique_ptr<OnlineStream> CreateStream() const override {
     auto stream =
         std::make_unique<OnlineStream>(config_.feat_config, hotwords_graph_);
@@ -193,7 +212,8 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
 
   std::unique_ptr<OnlineStream> CreateStream(
       const std::string &hotwords) const override {
-    auto hws = std::regex_replace(hotwords, std::regex("/"), "\n");
+    auto hws = hotwords;
+    std::replace(hws.begin(), hws.end(), '/', '\n');
     std::istringstream is(hws);
     std::vector<std::vector<int32_t>> current;
     std::vector<float> current_scores;
@@ -265,8 +285,10 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
                                               features_vec.size(),
                                               x_shape.data(), x_shape.size());
       auto x_copy = Clone(model_->Allocator(), &x);
+      ScopedTrace encoder_trace(TraceStage::kEncoder);
       auto pair = model_->RunEncoder(std::move(x), std::move(states),
                                      std::move(x_copy));
+      encoder_trace.Stop();
       decoder_->Decode(std::move(pair.first), &results);
     }
   }
@@ -283,6 +305,14 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     std::vector<int64_t> all_processed_frames(n);
     bool has_context_graph = false;
 
+    // If ss contains the same streams as the previous call, reuse the
+    // output states of that call without unstacking and stacking them
+    std::vector<OnlineStream *> sorted;
+    std::vector<Ort::Value> states = TakeBatchedStates(ss, n, &sorted);
+    if (!states.empty()) {
+      ss = sorted.data();
+    }
+
     for (int32_t i = 0; i != n; ++i) {
       if (!has_context_graph && ss[i]->GetContextGraph()) {
         has_context_graph = true;
@@ -299,7 +329,9 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
                 features_vec.data() + i * chunk_size * feature_dim);
 
       results[i] = std::move(ss[i]->GetResult());
-      states_vec[i] = std::move(ss[i]->GetStates());
+      if (states.empty()) {
+        states_vec[i] = std::move(ss[i]->GetStates());
+      }
       all_processed_frames[i] = num_processed_frames;
     }
 
@@ -319,10 +351,14 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
         memory_info, all_processed_frames.data(), all_processed_frames.size(),
         processed_frames_shape.data(), processed_frames_shape.size());
 
-    auto states = model_->StackStates(states_vec);
+    if (states.empty()) {
+      states = model_->StackStates(states_vec);
+    }
 
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
     auto pair = model_->RunEncoder(std::move(x), std::move(states),
                                    std::move(processed_frames));
+    encoder_trace.Stop();
 
     if (has_context_graph) {
       decoder_->Decode(std::move(pair.first), ss, &results);
@@ -330,17 +366,32 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       decoder_->Decode(std::move(pair.first), &results);
     }
 
-    std::vector<std::vector<Ort::Value>> next_states =
-        model_->UnStackStates(pair.second);
+    auto next_states = std::make_shared<BatchedStates>(
+        std::move(pair.second), n,
+        [model = model_.get()](std::vector<Ort::Value> s) {
+          return model->UnStackStates(s);
+        });
 
     for (int32_t i = 0; i != n; ++i) {
       ss[i]->SetResult(results[i]);
-      ss[i]->SetStates(std::move(next_states[i]));
+      ss[i]->SetBatchedStates(next_states, i);
     }
   }
 
   OnlineRecognizerResult GetResult(OnlineStream *s) const override {
     OnlineTransducerDecoderResult decoder_result = s->GetResult();
+
+    int32_t num_provisional_tokens = 0;
+    if (config_.speculative_decoding) {
+      const OnlineTransducerDecoderResult *speculative = Speculate(s);
+      if (speculative) {
+        num_provisional_tokens = NumProvisionalTokens(
+            decoder_result.tokens, speculative->tokens, unk_id_);
+
+        decoder_result = *speculative;
+      }
+    }
+
     decoder_->StripLeadingBlanks(&decoder_result);
 
     // TODO(fangjun): Remember to change these constants if needed
@@ -350,6 +401,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
                      s->GetCurrentSegment(), s->GetNumFramesSinceStart());
     r.text = ApplyInverseTextNormalization(std::move(r.text));
     r.text = ApplyHomophoneReplacer(std::move(r.text));
+    r.num_provisional_tokens = num_provisional_tokens;
     return r;
   }
 
@@ -421,6 +473,107 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   }
 
  private:
+  // Decode the frames that do not fill a chunk yet on top of the committed
+  // result. They are padded with the features of silence. The encoder runs
+  // on a copy of the encoder states, so neither the states nor the result
+  // of the stream change, and DecodeStreams() decodes the chunk again from
+  // the saved states once it is complete.
+  //
+  // Return nullptr if there are too few new frames or if a full chunk is
+  // ready. The returned result is cached in the stream until more frames
+  // arrive or the committed result changes.
+  const OnlineTransducerDecoderResult *Speculate(OnlineStream *s) const {
+    int32_t num_frames_ready = s->NumFramesReady();
+    if (s->GetSpeculativeFramesReady() == num_frames_ready) {
+      return &s->GetSpeculativeResult();
+    }
+
+    int32_t num_processed_frames = s->GetNumProcessedFrames();
+    int32_t num_new_frames = num_frames_ready - num_processed_frames;
+    if (num_new_frames < config_.speculative_min_frames || IsReady(s)) {
+      return nullptr;
+    }
+
+    int32_t chunk_size = model_->ChunkSize();
+    int32_t feature_dim = s->FeatureDim();
+
+    // log(FLT_EPSILON) is the log mel energy of zero samples
+    std::vector<float> features_vec(chunk_size * feature_dim,
+                                    std::log(FLT_EPSILON));
+    std::vector<float> features =
+        s->GetFrames(num_processed_frames, num_new_frames);
+    std::copy(features.begin(), features.end(), features_vec.begin());
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    std::array<int64_t, 3> x_shape{1, chunk_size, feature_dim};
+    Ort::Value x = Ort::Value::CreateTensor(memory_info, features_vec.data(),
+                                            features_vec.size(), x_shape.data(),
+                                            x_shape.size());
+
+    int64_t processed = num_processed_frames;
+    std::array<int64_t, 1> processed_frames_shape{1};
+    Ort::Value processed_frames =
+        Ort::Value::CreateTensor(memory_info, &processed, 1,
+                                 processed_frames_shape.data(),
+                                 processed_frames_shape.size());
+
+    // checkpoint of the encoder states
+    std::vector<Ort::Value> states;
+    if (s->StatesAreInBatch()) {
+      // GetStates() would unstack the states of all streams of the batch,
+      // so that the next DecodeStreams() could not reuse them. The stacked
+      // states of a batch of one stream are the states of this stream.
+      // Streams of larger batches are not speculated.
+      int32_t slot = 0;
+      const auto &batch = s->GetBatchedStates(&slot);
+      if (batch->BatchSize() != 1) {
+        return nullptr;
+      }
+
+      states = batch->CloneStacked(model_->Allocator());
+      if (states.empty()) {
+        return nullptr;
+      }
+    } else {
+      std::vector<std::vector<Ort::Value>> states_vec(1);
+      for (const auto &v : s->GetStates()) {
+        states_vec[0].push_back(Clone(model_->Allocator(), &v));
+      }
+      states = model_->StackStates(states_vec);
+    }
+
+    ScopedTrace encoder_trace(TraceStage::kEncoder);
+    auto pair = model_->RunEncoder(std::move(x), std::move(states),
+                                   std::move(processed_frames));
+    encoder_trace.Stop();
+
+    std::vector<OnlineTransducerDecoderResult> results(1);
+    results[0] = s->GetResult();
+
+    if (s->GetContextGraph()) {
+      decoder_->Decode(std::move(pair.first), &s, &results);
+    } else {
+      decoder_->Decode(std::move(pair.first), &results);
+    }
+
+    s->GetSpeculativeResult() = std::move(results[0]);
+    s->GetSpeculativeFramesReady() = num_frames_ready;
+
+    return &s->GetSpeculativeResult();
+  }
+
+  void InitDecoderOutCache() {
+    decoder_out_cache_ = std::make_unique<OnlineTransducerDecoderOutCache>(
+        model_.get(), config_.decoder_out_cache_size);
+
+    if (config_.precompute_decoder_out && decoder_out_cache_->Precompute() &&
+        config_.model_config.debug) {
+      SHERPA_ONNX_LOGE("Precomputed the decoder output of all contexts");
+    }
+  }
+
   void InitHotwords() {
     // each line in hotwords_file contains space-separated words
 
@@ -502,6 +655,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   std::unique_ptr<ssentencepiece::Ssentencepiece> bpe_encoder_;
   std::unique_ptr<OnlineTransducerModel> model_;
   std::unique_ptr<OnlineLM> lm_;
+  std::unique_ptr<OnlineTransducerDecoderOutCache> decoder_out_cache_;
   std::unique_ptr<OnlineTransducerDecoder> decoder_;
   SymbolTable sym_;
   Endpoint endpoint_;
@@ -78,7 +78,8 @@ std::string OnlineRecognizerResult::AsJsonString() const {
   os << "\"start_time\": " << std::fixed << std::setprecision(2) << start_time
      << ", ";
   os << "\"is_final\": " << (is_final ? "true" : "false") << ", ";
-  os << "\"is_eof\": " << (is_eof ? "true" : "false");
+  os << "\"is_eof\": " << (is_eof ? "true" : "false") << ", ";
+  os << "\"num_provisional_tokens\": " << num_provisional_tokens;
   os << "}";
   return os.str();
 }
@@ -127,6 +128,28 @@ void OnlineRecognizerConfig::Register(ParseOptions *po) {
   po->Register("reset-encoder", &reset_encoder,
                "True to reset encoder_state on an endpoint after empty segment."
                "Done in `Reset()` method, after an endpoint was detected.");
+
+  po->Register("speculative-decoding", &speculative_decoding,
+               "True to also decode frames that do not fill a chunk yet when "
+               "getting the result. Such tokens are provisional. It lowers "
+               "the latency of partial results at the cost of extra encoder "
+               "runs. Used only for transducer models. It is skipped for a "
+               "stream that was last decoded together with other streams "
+               "by DecodeStreams(), so use it with batches of one stream.");
+
+  po->Register("speculative-min-frames", &speculative_min_frames,
+               "Minimum number of new feature frames before a speculative "
+               "pass is run. Used only when --speculative-decoding is true.");
+
+  po->Register("decoder-out-cache-size", &decoder_out_cache_size,
+               "Maximum number of token contexts whose decoder output is "
+               "cached and reused across streams and hypotheses. 0 disables "
+               "the cache. Used only for transducer models.");
+
+  po->Register("precompute-decoder-out", &precompute_decoder_out,
+               "True to compute the decoder output of all token contexts at "
+               "startup. It is skipped if they do not fit into "
+               "--decoder-out-cache-size. Used only for transducer models.");
 }
 
 bool OnlineRecognizerConfig::Validate() const {
@@ -189,6 +212,18 @@ bool OnlineRecognizerConfig::Validate() const {
     return false;
   }
 
+  if (speculative_decoding && speculative_min_frames <= 0) {
+    SHERPA_ONNX_LOGE("--speculative-min-frames should be positive. Given: %d",
+                     speculative_min_frames);
+    return false;
+  }
+
+  if (decoder_out_cache_size < 0) {
+    SHERPA_ONNX_LOGE("--decoder-out-cache-size should be >= 0. Given: %d",
+                     decoder_out_cache_size);
+    return false;
+  }
+
   return model_config.Validate();
 }
 
@@ -211,6 +246,12 @@ std::string OnlineRecognizerConfig::ToString() const {
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
   os << "reset_encoder=" << (reset_encoder ? "True" : "False") << ", ";
+  os << "speculative_decoding=" << (speculative_decoding ? "True" : "False")
+     << ", ";
+  os << "speculative_min_frames=" << speculative_min_frames << ", ";
+  os << "decoder_out_cache_size=" << decoder_out_cache_size << ", ";
+  os << "precompute_decoder_out=" << (precompute_decoder_out ? "True" : "False")
+     << ", ";
   os << "hr=" << hr.ToString() << ")";
 
   return os.str();
@@ -61,6 +61,12 @@ struct OnlineRecognizerResult {
   /// If it is true, it means the server has processed all received samples
   bool is_eof = false;
 
+  /// Number of trailing entries in tokens (and timestamps) that are
+  /// provisional. They are decoded from a partially filled chunk when
+  /// speculative decoding is enabled and may change once the chunk is
+  /// complete. The other tokens are final. text contains both.
+  int32_t num_provisional_tokens = 0;
+
   /** Return a json string.
    *
    * The returned string contains:
@@ -75,6 +81,7 @@ struct OnlineRecognizerResult {
    *     "start_time": x,
    *     "is_final": true|false
    *     "is_eof": true|false
+   *     "num_provisional_tokens": x
    *   }
    */
   std::string AsJsonString() const;
@@ -121,6 +128,31 @@ struct OnlineRecognizerConfig {
   /// "hotwords_file"
   std::string hotwords_buf;
 
+  /// used only for transducer models.
+  /// If true, GetResult() also decodes the frames that do not fill a chunk
+  /// yet. They are padded with silence and run through the encoder on a
+  /// copy of the encoder states. The resulting tokens are provisional.
+  /// The frames are decoded again from the saved states once the chunk is
+  /// complete. It is skipped for a stream that was last decoded by
+  /// DecodeStreams() together with other streams, since reading its states
+  /// would unstack the states of the whole batch.
+  bool speculative_decoding = false;
+
+  /// Minimum number of new feature frames before a speculative pass is run
+  int32_t speculative_min_frames = 8;
+
+  /// used only for transducer models.
+  /// Maximum number of decoder contexts, i.e., the last context_size
+  /// tokens, whose decoder output is cached and shared by all streams.
+  /// The least recently used contexts are evicted. 0 disables the cache.
+  int32_t decoder_out_cache_size = 2048;
+
+  /// used only for transducer models.
+  /// If true, compute the decoder output of all contexts at startup.
+  /// It is done only if all of them fit into decoder_out_cache_size, which
+  /// is the case only for small vocabularies.
+  bool precompute_decoder_out = false;
+
   OnlineRecognizerConfig() = default;
 
   OnlineRecognizerConfig(
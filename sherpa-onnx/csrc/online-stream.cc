@@ -40,6 +40,7 @@ class OnlineStream::Impl {
     // we don't reset the feature extractor
     start_frame_index_ += num_processed_frames_;
     num_processed_frames_ = 0;
+    speculative_frames_ready_ = -1;
   }
 
   int32_t &GetNumProcessedFrames() { return num_processed_frames_; }
@@ -48,10 +49,19 @@ class OnlineStream::Impl {
 
   int32_t &GetCurrentSegment() { return segment_; }
 
-  void SetResult(const OnlineTransducerDecoderResult &r) { result_ = r; }
+  void SetResult(const OnlineTransducerDecoderResult &r) {
+    result_ = r;
+    speculative_frames_ready_ = -1;
+  }
 
   OnlineTransducerDecoderResult &GetResult() { return result_; }
 
+  OnlineTransducerDecoderResult &GetSpeculativeResult() {
+    return speculative_result_;
+  }
+
+  int32_t &GetSpeculativeFramesReady() { return speculative_frames_ready_; }
+
   void SetKeywordResult(const TransducerKeywordResult &r) {
     keyword_result_ = r;
   }
@@ -87,9 +97,31 @@ class OnlineStream::Impl {
 
   void SetStates(std::vector<Ort::Value> states) {
     states_ = std::move(states);
+    batched_states_.reset();
+  }
+
+  std::vector<Ort::Value> &GetStates() {
+    if (batched_states_ && !has_own_states_) {
+      states_ = batched_states_->Get(slot_);
+      has_own_states_ = true;
+    }
+
+    return states_;
+  }
+
+  void SetBatchedStates(std::shared_ptr<BatchedStates> states, int32_t slot) {
+    batched_states_ = std::move(states);
+    slot_ = slot;
+    has_own_states_ = false;
+    states_.clear();
+  }
+
+  const std::shared_ptr<BatchedStates> &GetBatchedStates(int32_t *slot) const {
+    *slot = slot_;
+    return batched_states_;
   }
 
-  std::vector<Ort::Value> &GetStates() { return states_; }
+  bool StatesAreInBatch() const { return batched_states_ && !has_own_states_; }
 
   void SetNeMoDecoderStates(std::vector<Ort::Value> decoder_states) {
     decoder_states_ = std::move(decoder_states);
@@ -131,11 +163,18 @@ class OnlineStream::Impl {
   int32_t start_frame_index_ = 0;     // never reset
   int32_t segment_ = 0;
   OnlineTransducerDecoderResult result_;
+  OnlineTransducerDecoderResult speculative_result_;
+  int32_t speculative_frames_ready_ = -1;
   TransducerKeywordResult prev_keyword_result_;
   TransducerKeywordResult keyword_result_;
   TransducerKeywordResult empty_keyword_result_;
   OnlineCtcDecoderResult ctc_result_;
   std::vector<Ort::Value> states_;  // states for transducer or ctc models
+
+  // If not null, states_ is at slot_ of it until has_own_states_ is true
+  std::shared_ptr<BatchedStates> batched_states_;
+  int32_t slot_ = -1;
+  bool has_own_states_ = false;
   std::vector<Ort::Value> decoder_states_;  // states for nemo transducer models
   std::vector<float> paraformer_feat_cache_;
   std::vector<float> paraformer_encoder_out_cache_;
@@ -193,6 +232,14 @@ OnlineTransducerDecoderResult &OnlineStream::GetResult() {
   return impl_->GetResult();
 }
 
+OnlineTransducerDecoderResult &OnlineStream::GetSpeculativeResult() {
+  return impl_->GetSpeculativeResult();
+}
+
+int32_t &OnlineStream::GetSpeculativeFramesReady() {
+  return impl_->GetSpeculativeFramesReady();
+}
+
 void OnlineStream::SetKeywordResult(const TransducerKeywordResult &r) {
   impl_->SetKeywordResult(r);
 }
@@ -226,6 +273,20 @@ std::vector<Ort::Value> &OnlineStream::GetStates() {
   return impl_->GetStates();
 }
 
+void OnlineStream::SetBatchedStates(std::shared_ptr<BatchedStates> states,
+                                    int32_t slot) {
+  impl_->SetBatchedStates(std::move(states), slot);
+}
+
+const std::shared_ptr<BatchedStates> &OnlineStream::GetBatchedStates(
+    int32_t *slot) const {
+  return impl_->GetBatchedStates(slot);
+}
+
+bool OnlineStream::StatesAreInBatch() const {
+  return impl_->StatesAreInBatch();
+}
+
 void OnlineStream::SetNeMoDecoderStates(
     std::vector<Ort::Value> decoder_states) {
   return impl_->SetNeMoDecoderStates(std::move(decoder_states));
@@ -12,6 +12,7 @@
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/context-graph.h"
 #include "sherpa-onnx/csrc/features.h"
+#include "sherpa-onnx/csrc/online-batched-states.h"
 #include "sherpa-onnx/csrc/online-ctc-decoder.h"
 #include "sherpa-onnx/csrc/online-paraformer-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
@@ -79,6 +80,13 @@ class OnlineStream {
   void SetResult(const OnlineTransducerDecoderResult &r);
   OnlineTransducerDecoderResult &GetResult();
 
+  // For speculative decoding of transducer models.
+  // GetSpeculativeFramesReady() is NumFramesReady() at the time the
+  // speculative result was computed, or -1 if there is none. It is set to -1
+  // by SetResult() and Reset().
+  OnlineTransducerDecoderResult &GetSpeculativeResult();
+  int32_t &GetSpeculativeFramesReady();
+
   void SetKeywordResult(const TransducerKeywordResult &r);
   TransducerKeywordResult &GetKeywordResult(bool remove_duplicates = false);
 
@@ -89,8 +97,23 @@ class OnlineStream {
   OnlineParaformerDecoderResult &GetParaformerResult();
 
   void SetStates(std::vector<Ort::Value> states);
+
+  // If the states are in a BatchedStates object, this stream takes its
+  // own states from it on the first call.
   std::vector<Ort::Value> &GetStates();
 
+  // Let the states of this stream be the given slot of a batch.
+  // It replaces states set by SetStates().
+  void SetBatchedStates(std::shared_ptr<BatchedStates> states, int32_t slot);
+
+  // Return the batch containing the states of this stream and set *slot to
+  // the index of this stream in it. Return nullptr if there is none.
+  const std::shared_ptr<BatchedStates> &GetBatchedStates(int32_t *slot) const;
+
+  // Return true if the states of this stream are still in a BatchedStates
+  // object, i.e., GetStates() would take them out of it.
+  bool StatesAreInBatch() const;
+
   void SetNeMoDecoderStates(std::vector<Ort::Value> decoder_states);
   std::vector<Ort::Value> &GetNeMoDecoderStates();
 
@@ -0,0 +1,231 @@
+// sherpa-onnx/csrc/online-transducer-decoder-out-cache-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-transducer-decoder-out-cache.h"
+
+#include <array>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+// A model with only a decoder. Row i of the decoder output is
+// (x, -x), where x = 100 * context[0] + context[1].
+class FakeTransducerModel : public OnlineTransducerModel {
+ public:
+  explicit FakeTransducerModel(int32_t vocab_size) : vocab_size_(vocab_size) {}
+
+  std::vector<Ort::Value> StackStates(
+      const std::vector<std::vector<Ort::Value>> & /*states*/) const override {
+    return {};
+  }
+
+  std::vector<std::vector<Ort::Value>> UnStackStates(
+      const std::vector<Ort::Value> & /*states*/) const override {
+    return {};
+  }
+
+  std::vector<Ort::Value> GetEncoderInitStates() override { return {}; }
+
+  std::pair<Ort::Value, std::vector<Ort::Value>> RunEncoder(
+      Ort::Value /*features*/, std::vector<Ort::Value> /*states*/,
+      Ort::Value /*processed_frames*/) override {
+    return {Ort::Value{nullptr}, std::vector<Ort::Value>{}};
+  }
+
+  Ort::Value RunDecoder(Ort::Value decoder_input) override {
+    int64_t num_rows =
+        decoder_input.GetTensorTypeAndShapeInfo().GetShape()[0];
+    num_decoded_rows_ += num_rows;
+
+    std::array<int64_t, 2> shape{num_rows, 2};
+    Ort::Value ans = Ort::Value::CreateTensor<float>(
+        allocator_, shape.data(), shape.size());
+
+    const int64_t *p = decoder_input.GetTensorData<int64_t>();
+    float *q = ans.GetTensorMutableData<float>();
+    for (int64_t i = 0; i != num_rows; ++i, p += 2, q += 2) {
+      q[0] = 100 * p[0] + p[1];
+      q[1] = -q[0];
+    }
+
+    return ans;
+  }
+
+  Ort::Value RunJoiner(Ort::Value /*encoder_out*/,
+                       Ort::Value /*decoder_out*/) override {
+    return Ort::Value{nullptr};
+  }
+
+  int32_t ContextSize() const override { return 2; }
+  int32_t ChunkSize() const override { return 32; }
+  int32_t ChunkShift() const override { return 32; }
+  int32_t VocabSize() const override { return vocab_size_; }
+  OrtAllocator *Allocator() override { return allocator_; }
+
+  int64_t NumDecodedRows() const { return num_decoded_rows_; }
+
+ private:
+  Ort::AllocatorWithDefaultOptions allocator_;
+  int32_t vocab_size_;
+  std::atomic<int64_t> num_decoded_rows_{0};
+};
+
+// Run the cache on the given contexts and check its output
+void RunAndCheck(OnlineTransducerDecoderOutCache *cache,
+                 OrtAllocator *allocator,
+                 const std::vector<std::array<int64_t, 2>> &contexts) {
+  std::array<int64_t, 2> shape{static_cast<int64_t>(contexts.size()), 2};
+  Ort::Value decoder_input = Ort::Value::CreateTensor<int64_t>(
+      allocator, shape.data(), shape.size());
+
+  int64_t *p = decoder_input.GetTensorMutableData<int64_t>();
+  for (const auto &c : contexts) {
+    *p++ = c[0];
+    *p++ = c[1];
+  }
+
+  Ort::Value decoder_out = cache->Run(std::move(decoder_input));
+  auto out_shape = decoder_out.GetTensorTypeAndShapeInfo().GetShape();
+  ASSERT_EQ(out_shape[0], static_cast<int64_t>(contexts.size()));
+  ASSERT_EQ(out_shape[1], 2);
+
+  const float *q = decoder_out.GetTensorData<float>();
+  for (const auto &c : contexts) {
+    EXPECT_EQ(q[0], 100 * c[0] + c[1]);
+    EXPECT_EQ(q[1], -q[0]);
+    q += 2;
+  }
+}
+
+}  // namespace
+
+TEST(OnlineTransducerDecoderOutCache, HitAndMiss) {
+  FakeTransducerModel model(10);
+  OnlineTransducerDecoderOutCache cache(&model, 100);
+
+  // The same context twice in one batch is decoded only once
+  RunAndCheck(&cache, model.Allocator(), {{-1, 0}, {1, 2}, {1, 2}});
+  EXPECT_EQ(cache.NumLookups(), 3);
+  EXPECT_EQ(cache.NumHits(), 0);
+  EXPECT_EQ(model.NumDecodedRows(), 2);
+  EXPECT_EQ(cache.Size(), 2);
+
+  RunAndCheck(&cache, model.Allocator(), {{3, 4}, {1, 2}, {-1, 0}});
+  EXPECT_EQ(cache.NumLookups(), 6);
+  EXPECT_EQ(cache.NumHits(), 2);
+  EXPECT_EQ(model.NumDecodedRows(), 3);
+  EXPECT_EQ(cache.Size(), 3);
+
+  RunAndCheck(&cache, model.Allocator(), {{3, 4}, {1, 2}});
+  EXPECT_EQ(cache.NumLookups(), 8);
+  EXPECT_EQ(cache.NumHits(), 4);
+  EXPECT_EQ(model.NumDecodedRows(), 3);
+}
+
+TEST(OnlineTransducerDecoderOutCache, EvictLeastRecentlyUsed) {
+  FakeTransducerModel model(10);
+  OnlineTransducerDecoderOutCache cache(&model, 2);
+
+  RunAndCheck(&cache, model.Allocator(), {{1, 1}});
+  RunAndCheck(&cache, model.Allocator(), {{2, 2}});
+  RunAndCheck(&cache, model.Allocator(), {{1, 1}});
+  EXPECT_EQ(model.NumDecodedRows(), 2);
+
+  // (2, 2) is the least recently used one and is evicted
+  RunAndCheck(&cache, model.Allocator(), {{3, 3}});
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(model.NumDecodedRows(), 3);
+
+  RunAndCheck(&cache, model.Allocator(), {{1, 1}, {3, 3}});
+  EXPECT_EQ(model.NumDecodedRows(), 3);
+
+  RunAndCheck(&cache, model.Allocator(), {{2, 2}});
+  EXPECT_EQ(model.NumDecodedRows(), 4);
+  EXPECT_EQ(cache.Size(), 2);
+}
+
+TEST(OnlineTransducerDecoderOutCache, ManyShards) {
+  FakeTransducerModel model(50);
+  OnlineTransducerDecoderOutCache cache(&model, 4096);
+
+  std::vector<std::array<int64_t, 2>> contexts;
+  for (int64_t i = 0; i != 50; ++i) {
+    for (int64_t k = 0; k != 50; ++k) {
+      contexts.push_back({i, k});
+    }
+  }
+
+  RunAndCheck(&cache, model.Allocator(), contexts);
+  EXPECT_EQ(model.NumDecodedRows(), 2500);
+  EXPECT_EQ(cache.Size(), 2500);
+
+  RunAndCheck(&cache, model.Allocator(), contexts);
+  EXPECT_EQ(model.NumDecodedRows(), 2500);
+  EXPECT_EQ(cache.NumHits(), 2500);
+}
+
+TEST(OnlineTransducerDecoderOutCache, ConcurrentStreams) {
+  FakeTransducerModel model(50);
+  OnlineTransducerDecoderOutCache cache(&model, 1024);
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t != 4; ++t) {
+    threads.emplace_back([&cache, &model, t]() {
+      // Streams share some contexts with each other
+      std::vector<std::array<int64_t, 2>> contexts;
+      for (int64_t i = 0; i != 100; ++i) {
+        contexts.push_back({(i * (t + 1)) % 50, i % 50});
+      }
+
+      for (int32_t k = 0; k != 10; ++k) {
+        RunAndCheck(&cache, model.Allocator(), contexts);
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(cache.NumLookups(), 4 * 10 * 100);
+  EXPECT_LE(cache.Size(), 1024);
+}
+
+TEST(OnlineTransducerDecoderOutCache, Disabled) {
+  FakeTransducerModel model(10);
+  OnlineTransducerDecoderOutCache cache(&model, 0);
+
+  RunAndCheck(&cache, model.Allocator(), {{1, 2}, {1, 2}});
+  RunAndCheck(&cache, model.Allocator(), {{1, 2}});
+  EXPECT_EQ(model.NumDecodedRows(), 3);
+  EXPECT_EQ(cache.NumLookups(), 0);
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_FALSE(cache.Precompute());
+}
+
+TEST(OnlineTransducerDecoderOutCache, Precompute) {
+  FakeTransducerModel model(3);
+
+  // 3 * 3 contexts without padding and 3 with one padding
+  OnlineTransducerDecoderOutCache small_cache(&model, 11);
+  EXPECT_FALSE(small_cache.Precompute());
+
+  OnlineTransducerDecoderOutCache cache(&model, 12);
+  EXPECT_TRUE(cache.Precompute());
+  EXPECT_EQ(cache.Size(), 12);
+  EXPECT_EQ(model.NumDecodedRows(), 12);
+
+  RunAndCheck(&cache, model.Allocator(), {{-1, 0}, {-1, 2}, {2, 1}, {0, 0}});
+  EXPECT_EQ(cache.NumHits(), 4);
+  EXPECT_EQ(model.NumDecodedRows(), 12);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,267 @@
+// sherpa-onnx/csrc/online-transducer-decoder-out-cache.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-transducer-decoder-out-cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/trace.h"
+
+namespace sherpa_onnx {
+
+// A cache is split into at most this number of shards
+static constexpr int32_t kMaxNumShards = 16;
+
+// Caches smaller than this number of contexts per shard use fewer shards,
+// so that a small cache still evicts in LRU order
+static constexpr int32_t kMinShardSize = 64;
+
+OnlineTransducerDecoderOutCache::OnlineTransducerDecoderOutCache(
+    OnlineTransducerModel *model, int32_t max_size)
+    : model_(model),
+      max_size_(max_size),
+      context_size_(model->ContextSize()),
+      vocab_size_(model->VocabSize()) {
+  // GetKey() uses vocab_size + 1 as the base
+  double num_keys = std::pow(vocab_size_ + 1.0, context_size_);
+  if (max_size_ <= 0 ||
+      num_keys > static_cast<double>(std::numeric_limits<uint64_t>::max())) {
+    enabled_ = false;
+    return;
+  }
+
+  num_shards_ =
+      std::min(kMaxNumShards, std::max(1, max_size_ / kMinShardSize));
+  shard_size_ = (max_size_ + num_shards_ - 1) / num_shards_;
+  shards_ = std::make_unique<Shard[]>(num_shards_);
+}
+
+uint64_t OnlineTransducerDecoderOutCache::GetKey(
+    const int64_t *context) const {
+  uint64_t key = 0;
+  for (int32_t i = 0; i != context_size_; ++i) {
+    key = key * (vocab_size_ + 1) + (context[i] + 1);
+  }
+  return key;
+}
+
+int32_t OnlineTransducerDecoderOutCache::Size() const {
+  int32_t ans = 0;
+  for (int32_t i = 0; i != num_shards_ && shards_; ++i) {
+    std::lock_guard<std::mutex> lock(shards_[i].mutex);
+    ans += static_cast<int32_t>(shards_[i].entries.size());
+  }
+  return ans;
+}
+
+bool OnlineTransducerDecoderOutCache::Lookup(uint64_t key, float *dst) {
+  Shard &shard = GetShard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    return false;
+  }
+
+  // Mark it as the most recently used one
+  shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+
+  const std::vector<float> &v = it->second->second;
+  std::copy(v.begin(), v.end(), dst);
+  return true;
+}
+
+Ort::Value OnlineTransducerDecoderOutCache::RunAndCache(
+    const int64_t *contexts, int32_t num_rows) {
+  std::array<int64_t, 2> shape{num_rows, context_size_};
+  Ort::Value decoder_input = Ort::Value::CreateTensor<int64_t>(
+      model_->Allocator(), shape.data(), shape.size());
+  std::copy(contexts, contexts + num_rows * context_size_,
+            decoder_input.GetTensorMutableData<int64_t>());
+
+  ScopedTrace decoder_trace(TraceStage::kDecoder);
+  Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+  decoder_trace.Stop();
+
+  int32_t dim = decoder_out.GetTensorTypeAndShapeInfo().GetShape()[1];
+  const float *p = decoder_out.GetTensorData<float>();
+  dim_ = dim;
+
+  for (int32_t i = 0; i != num_rows; ++i, p += dim) {
+    uint64_t key = GetKey(contexts + i * context_size_);
+
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      // Another thread has cached it in the meantime
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      continue;
+    }
+
+    shard.entries.emplace_front(key, std::vector<float>(p, p + dim));
+    shard.index[key] = shard.entries.begin();
+
+    if (static_cast<int32_t>(shard.entries.size()) > shard_size_) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+    }
+  }
+
+  return decoder_out;
+}
+
+Ort::Value OnlineTransducerDecoderOutCache::Run(Ort::Value decoder_input) {
+  if (!enabled_) {
+    ScopedTrace decoder_trace(TraceStage::kDecoder);
+    return model_->RunDecoder(std::move(decoder_input));
+  }
+
+  int32_t num_rows = decoder_input.GetTensorTypeAndShapeInfo().GetShape()[0];
+  const int64_t *p = decoder_input.GetTensorData<int64_t>();
+
+  num_lookups_ += num_rows;
+
+  // The cache is empty until the decoder has been run once
+  int32_t dim = dim_;
+  Ort::Value ans{nullptr};
+  if (dim > 0) {
+    std::array<int64_t, 2> shape{num_rows, dim};
+    ans = Ort::Value::CreateTensor<float>(model_->Allocator(), shape.data(),
+                                          shape.size());
+  }
+
+  // Rows not in the cache. A context that appears in several rows is
+  // computed only once.
+  std::vector<int64_t> missed_contexts;
+  std::unordered_map<uint64_t, int32_t> missed_keys;
+  std::vector<int32_t> missed_index(num_rows, -1);
+  int32_t num_hits = 0;
+
+  for (int32_t i = 0; i != num_rows; ++i) {
+    const int64_t *context = p + i * context_size_;
+    uint64_t key = GetKey(context);
+
+    if (dim > 0 &&
+        Lookup(key, ans.GetTensorMutableData<float>() + i * dim)) {
+      num_hits += 1;
+      continue;
+    }
+
+    auto r = missed_keys.emplace(key, missed_keys.size());
+    if (r.second) {
+      missed_contexts.insert(missed_contexts.end(), context,
+                             context + context_size_);
+    }
+    missed_index[i] = r.first->second;
+  }
+
+  num_hits_ += num_hits;
+
+  if (missed_keys.empty()) {
+    return ans;
+  }
+
+  int32_t num_missed = static_cast<int32_t>(missed_keys.size());
+  Ort::Value decoder_out = RunAndCache(missed_contexts.data(), num_missed);
+
+  if (num_missed == num_rows) {
+    // All rows are distinct and none of them is cached, so decoder_out
+    // contains the rows in the same order
+    return decoder_out;
+  }
+
+  dim = decoder_out.GetTensorTypeAndShapeInfo().GetShape()[1];
+  if (!ans) {
+    std::array<int64_t, 2> shape{num_rows, dim};
+    ans = Ort::Value::CreateTensor<float>(model_->Allocator(), shape.data(),
+                                          shape.size());
+  }
+
+  const float *src = decoder_out.GetTensorData<float>();
+  float *dst = ans.GetTensorMutableData<float>();
+  for (int32_t i = 0; i != num_rows; ++i) {
+    if (missed_index[i] != -1) {
+      const float *row = src + missed_index[i] * dim;
+      std::copy(row, row + dim, dst + i * dim);
+    }
+  }
+
+  return ans;
+}
+
+bool OnlineTransducerDecoderOutCache::Precompute() {
+  if (!enabled_) {
+    return false;
+  }
+
+  // A context consists of k paddings (-1) followed by context_size - k
+  // tokens, where k is in [0, context_size). Padding occurs only at the
+  // beginning of an utterance.
+  double num_contexts = 0;
+  for (int32_t k = 0; k != context_size_; ++k) {
+    num_contexts += std::pow(vocab_size_, context_size_ - k);
+  }
+
+  if (num_contexts > max_size_) {
+    SHERPA_ONNX_LOGE(
+        "There are %.0f decoder contexts but the cache can hold only %d of "
+        "them. Skip precomputing.",
+        num_contexts, max_size_);
+    return false;
+  }
+
+  std::vector<int64_t> contexts;
+  contexts.reserve(static_cast<int64_t>(num_contexts) * context_size_);
+  std::vector<int64_t> context(context_size_);
+
+  for (int32_t k = 0; k != context_size_; ++k) {
+    std::fill(context.begin(), context.begin() + k, -1);
+
+    int64_t n = static_cast<int64_t>(
+        std::pow(vocab_size_, context_size_ - k) + 0.5);
+    for (int64_t i = 0; i != n; ++i) {
+      int64_t r = i;
+      for (int32_t j = context_size_ - 1; j >= k; --j) {
+        context[j] = r % vocab_size_;
+        r /= vocab_size_;
+      }
+
+      contexts.insert(contexts.end(), context.begin(), context.end());
+    }
+  }
+
+  int32_t num_rows = static_cast<int32_t>(contexts.size() / context_size_);
+
+  // Contexts are not spread evenly over the shards. Make sure that none of
+  // them is evicted while precomputing.
+  std::vector<int32_t> shard_sizes(num_shards_);
+  for (int32_t i = 0; i != num_rows; ++i) {
+    uint64_t key = GetKey(contexts.data() + i * context_size_);
+    if (++shard_sizes[key % num_shards_] > shard_size_) {
+      SHERPA_ONNX_LOGE(
+          "The %d decoder contexts do not fit into the cache of size %d. "
+          "Skip precomputing.",
+          num_rows, max_size_);
+      return false;
+    }
+  }
+
+  constexpr int32_t kBatchSize = 512;
+  for (int32_t i = 0; i < num_rows; i += kBatchSize) {
+    RunAndCache(contexts.data() + i * context_size_,
+                std::min(kBatchSize, num_rows - i));
+  }
+
+  return true;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,106 @@
+// sherpa-onnx/csrc/online-transducer-decoder-out-cache.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_ONLINE_TRANSDUCER_DECODER_OUT_CACHE_H_
+#define SHERPA_ONNX_CSRC_ONLINE_TRANSDUCER_DECODER_OUT_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/online-transducer-model.h"
+
+namespace sherpa_onnx {
+
+/* The decoder of a transducer model is stateless: its output depends only
+ * on the last context_size tokens. This class caches the output for each
+ * context, so that rows shared by streams and hypotheses, or seen in an
+ * earlier chunk, are not computed again.
+ *
+ * It is owned by a recognizer and shared by all of its streams. Contexts
+ * are split into shards, each with its own lock, so that streams decoded
+ * on different threads seldom wait for each other. When a shard is full,
+ * its least recently used context is evicted.
+ */
+class OnlineTransducerDecoderOutCache {
+ public:
+  /**
+   * @param model Not owned.
+   * @param max_size Maximum number of contexts to cache. 0 disables the
+   *                 cache.
+   */
+  OnlineTransducerDecoderOutCache(OnlineTransducerModel *model,
+                                  int32_t max_size);
+
+  /** Same as model->RunDecoder(decoder_input) except that cached rows are
+   * copied instead of being computed.
+   *
+   * @param decoder_input A tensor of shape (N, context_size) of type int64.
+   * @return Return a tensor of shape (N, joiner_dim).
+   */
+  Ort::Value Run(Ort::Value decoder_input);
+
+  /** Compute the decoder output of all possible contexts, including the
+   * ones padded with -1 at the start of an utterance. A context with k
+   * paddings, 0 <= k < context_size, is followed by context_size - k
+   * tokens, so there are sum_k vocab_size^(context_size - k) of them.
+   *
+   * @return Return false if they do not fit into the cache.
+   */
+  bool Precompute();
+
+  // Number of cached contexts
+  int32_t Size() const;
+
+  int64_t NumLookups() const { return num_lookups_; }
+  int64_t NumHits() const { return num_hits_; }
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+
+    // The most recently used context is at the front
+    std::list<std::pair<uint64_t, std::vector<float>>> entries;
+    std::unordered_map<uint64_t, decltype(entries)::iterator> index;
+  };
+
+  // Map a context to a unique integer. Tokens are in the range
+  // [-1, vocab_size), where -1 is used for padding.
+  uint64_t GetKey(const int64_t *context) const;
+
+  Shard &GetShard(uint64_t key) const { return shards_[key % num_shards_]; }
+
+  // Copy the cached output of the given context to dst.
+  // Return false if it is not cached.
+  bool Lookup(uint64_t key, float *dst);
+
+  // Run the decoder on num_rows contexts and cache the results.
+  // Return the decoder output.
+  Ort::Value RunAndCache(const int64_t *contexts, int32_t num_rows);
+
+ private:
+  OnlineTransducerModel *model_;  // Not owned
+  int32_t max_size_;
+  int32_t context_size_;
+  int32_t vocab_size_;
+  bool enabled_ = true;
+
+  int32_t num_shards_ = 1;
+  int32_t shard_size_ = 0;  // Maximum number of contexts per shard
+  std::unique_ptr<Shard[]> shards_;
+
+  std::atomic<int32_t> dim_{0};  // joiner_dim, known after the first run
+  std::atomic<int64_t> num_lookups_{0};
+  std::atomic<int64_t> num_hits_{0};
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_TRANSDUCER_DECODER_OUT_CACHE_H_
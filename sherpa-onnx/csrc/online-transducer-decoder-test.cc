@@ -0,0 +1,44 @@
+// sherpa-onnx/csrc/online-transducer-decoder-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-transducer-decoder.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(NumProvisionalTokens, Extends) {
+  std::vector<int64_t> committed = {0, 0, 5, 8};
+
+  EXPECT_EQ(NumProvisionalTokens(committed, committed, 2), 0);
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 5, 8, 9}, 2), 1);
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 5, 8, 9, 10}, 2), 2);
+
+  // <unk> is not counted
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 5, 8, 2, 10}, 2), 1);
+}
+
+TEST(NumProvisionalTokens, Shorter) {
+  std::vector<int64_t> committed = {0, 0, 5, 8, 9};
+
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 5, 8}, 2), 0);
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0}, 2), 0);
+  EXPECT_EQ(NumProvisionalTokens(committed, {}, 2), 0);
+
+  // Shorter and diverging
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 6}, 2), 1);
+}
+
+TEST(NumProvisionalTokens, Diverges) {
+  std::vector<int64_t> committed = {0, 0, 5, 8};
+
+  // Everything after the common prefix {0, 0, 5} is provisional
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 5, 7, 9}, 2), 2);
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 6, 8}, 2), 2);
+  EXPECT_EQ(NumProvisionalTokens(committed, {0, 0, 6, 2}, 2), 1);
+}
+
+}  // namespace sherpa_onnx
@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -71,4 +72,17 @@ OnlineTransducerDecoderResult &OnlineTransducerDecoderResult::operator=(
   return *this;
 }
 
+int32_t NumProvisionalTokens(const std::vector<int64_t> &committed,
+                             const std::vector<int64_t> &speculative,
+                             int64_t unk_id) {
+  auto n = std::min(committed.size(), speculative.size());
+  auto begin = std::mismatch(speculative.begin(), speculative.begin() + n,
+                             committed.begin())
+                   .first;
+  auto end = speculative.end();
+
+  return std::max<int32_t>((end - begin) - std::count(begin, end, unk_id),
+                           0);
+}
+
 }  // namespace sherpa_onnx
@@ -50,6 +50,16 @@ struct OnlineTransducerDecoderResult {
       OnlineTransducerDecoderResult &&other) noexcept;
 };
 
+/** Return the number of trailing tokens of a speculative result that are
+ * provisional, i.e., that are not in the common prefix of the committed
+ * and the speculative tokens. The speculative result usually extends the
+ * committed one, but it may also be shorter or diverge from it. unk_id is
+ * not counted since it is dropped from the final result.
+ */
+int32_t NumProvisionalTokens(const std::vector<int64_t> &committed,
+                             const std::vector<int64_t> &speculative,
+                             int64_t unk_id);
+
 class OnlineStream;
 class OnlineTransducerDecoder {
  public:
@@ -10,6 +10,7 @@
 
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -109,14 +110,16 @@ void OnlineTransducerGreedySearchDecoder::Decode(
     UseCachedDecoderOut(*result, &decoder_out);
   } else {
     Ort::Value decoder_input = model_->BuildDecoderInput(*result);
-    decoder_out = model_->RunDecoder(std::move(decoder_input));
+    decoder_out = decoder_out_cache_->Run(std::move(decoder_input));
   }
 
   for (int32_t t = 0; t != num_frames; ++t) {
     Ort::Value cur_encoder_out =
         GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
+    ScopedTrace joiner_trace(TraceStage::kJoiner);
     Ort::Value logit =
         model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    joiner_trace.Stop();
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
@@ -159,7 +162,7 @@ void OnlineTransducerGreedySearchDecoder::Decode(
     }
     if (emitted) {
       Ort::Value decoder_input = model_->BuildDecoderInput(*result);
-      decoder_out = model_->RunDecoder(std::move(decoder_input));
+      decoder_out = decoder_out_cache_->Run(std::move(decoder_input));
     }
   }
 
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "sherpa-onnx/csrc/online-transducer-decoder-out-cache.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-model.h"
 
@@ -14,11 +15,12 @@ namespace sherpa_onnx {
 
 class OnlineTransducerGreedySearchDecoder : public OnlineTransducerDecoder {
  public:
-  OnlineTransducerGreedySearchDecoder(OnlineTransducerModel *model,
-                                      int32_t unk_id,
-                                      float blank_penalty,
-                                      float temperature_scale)
+  OnlineTransducerGreedySearchDecoder(
+      OnlineTransducerModel *model,
+      OnlineTransducerDecoderOutCache *decoder_out_cache, int32_t unk_id,
+      float blank_penalty, float temperature_scale)
       : model_(model),
+      decoder_out_cache_(decoder_out_cache),
       unk_id_(unk_id),
       blank_penalty_(blank_penalty),
       temperature_scale_(temperature_scale) {}
@@ -32,6 +34,7 @@ class OnlineTransducerGreedySearchDecoder : public OnlineTransducerDecoder {
 
  private:
   OnlineTransducerModel *model_;  // Not owned
+  OnlineTransducerDecoderOutCache *decoder_out_cache_;  // Not owned
   int32_t unk_id_;
   float blank_penalty_;
   float temperature_scale_;
@@ -11,6 +11,7 @@
 
 #include "sherpa-onnx/csrc/log.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/trace.h"
 
 namespace sherpa_onnx {
 
@@ -116,7 +117,8 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     cur.reserve(batch_size);
 
     Ort::Value decoder_input = model_->BuildDecoderInput(prev);
-    Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+    Ort::Value decoder_out =
+        decoder_out_cache_->Run(std::move(decoder_input));
     if (t == 0) {
       UseCachedDecoderOut(hyps_row_splits, *result, &decoder_out);
     }
@@ -125,8 +127,10 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
         GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
     cur_encoder_out =
         Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
+    ScopedTrace joiner_trace(TraceStage::kJoiner);
     Ort::Value logit =
         model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    joiner_trace.Stop();
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
@@ -264,7 +268,7 @@ void OnlineTransducerModifiedBeamSearchDecoder::UpdateDecoderOut(
     return;
   }
   Ort::Value decoder_input = model_->BuildDecoderInput({*result});
-  result->decoder_out = model_->RunDecoder(std::move(decoder_input));
+  result->decoder_out = decoder_out_cache_->Run(std::move(decoder_input));
 }
 
 }  // namespace sherpa_onnx
@@ -10,6 +10,7 @@
 
 #include "sherpa-onnx/csrc/online-lm.h"
 #include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/online-transducer-decoder-out-cache.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-model.h"
 
@@ -18,15 +19,13 @@ namespace sherpa_onnx {
 class OnlineTransducerModifiedBeamSearchDecoder
     : public OnlineTransducerDecoder {
  public:
-  OnlineTransducerModifiedBeamSearchDecoder(OnlineTransducerModel *model,
-                                            OnlineLM *lm,
-                                            int32_t max_active_paths,
-                                            float lm_scale,
-                                            bool shallow_fusion,
-                                            int32_t unk_id,
-                                            float blank_penalty,
-                                            float temperature_scale)
+  OnlineTransducerModifiedBeamSearchDecoder(
+      OnlineTransducerModel *model,
+      OnlineTransducerDecoderOutCache *decoder_out_cache, OnlineLM *lm,
+      int32_t max_active_paths, float lm_scale, bool shallow_fusion,
+      int32_t unk_id, float blank_penalty, float temperature_scale)
       : model_(model),
+        decoder_out_cache_(decoder_out_cache),
         lm_(lm),
         max_active_paths_(max_active_paths),
         lm_scale_(lm_scale),
@@ -49,7 +48,8 @@ class OnlineTransducerModifiedBeamSearchDecoder
 
  private:
   OnlineTransducerModel *model_;  // Not owned
-  OnlineLM *lm_;                  // Not owned
+  OnlineTransducerDecoderOutCache *decoder_out_cache_;  // Not owned
+  OnlineLM *lm_;                                        // Not owned
 
   int32_t max_active_paths_;
   float lm_scale_;  // used only when lm_ is not nullptr
@@ -0,0 +1,156 @@
+// sherpa-onnx/csrc/onnx-utils-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/onnx-utils.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+static std::vector<uint16_t> ToHalf(const std::vector<float> &src) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::array<int64_t, 1> shape{static_cast<int64_t>(src.size())};
+  Ort::Value v =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  std::copy(src.begin(), src.end(), v.GetTensorMutableData<float>());
+
+  Ort::Value h = ConvertFloatToFloat16(allocator, &v);
+  const uint16_t *p = h.GetTensorData<uint16_t>();
+  return {p, p + src.size()};
+}
+
+static std::vector<float> ToFloat(const std::vector<uint16_t> &src) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::array<int64_t, 1> shape{static_cast<int64_t>(src.size())};
+  Ort::Value v = Ort::Value::CreateTensor(
+      allocator, shape.data(), shape.size(),
+      ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+  std::copy(src.begin(), src.end(), v.GetTensorMutableData<uint16_t>());
+
+  Ort::Value f = ConvertFloat16ToFloat(allocator, &v);
+  const float *p = f.GetTensorData<float>();
+  return {p, p + src.size()};
+}
+
+static uint16_t ToHalf(float f) { return ToHalf(std::vector<float>{f})[0]; }
+
+static bool IsHalfNaN(uint16_t h) {
+  return (h & 0x7c00) == 0x7c00 && (h & 0x3ff) != 0;
+}
+
+TEST(ConvertFloatToFloat16, Exact) {
+  EXPECT_EQ(ToHalf(0.0f), 0x0000);
+  EXPECT_EQ(ToHalf(-0.0f), 0x8000);
+  EXPECT_EQ(ToHalf(1.0f), 0x3c00);
+  EXPECT_EQ(ToHalf(-2.0f), 0xc000);
+  EXPECT_EQ(ToHalf(0.5f), 0x3800);
+  EXPECT_EQ(ToHalf(65504.0f), 0x7bff);  // largest finite half
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -14)), 0x0400);  // smallest normal
+}
+
+TEST(ConvertFloatToFloat16, RoundToNearestEven) {
+  // The spacing of halfs in [1, 2) is 2^-10
+  float ulp = std::ldexp(1.0f, -10);
+
+  // Ties go to the even neighbour
+  EXPECT_EQ(ToHalf(1.0f + 0.5f * ulp), 0x3c00);
+  EXPECT_EQ(ToHalf(1.0f + 1.5f * ulp), 0x3c02);
+  EXPECT_EQ(ToHalf(-1.0f - 1.5f * ulp), 0xbc02);
+
+  // Off-tie values go to the nearest neighbour
+  EXPECT_EQ(ToHalf(1.0f + 0.5f * ulp + std::ldexp(1.0f, -20)), 0x3c01);
+  EXPECT_EQ(ToHalf(1.0f + 0.5f * ulp - std::ldexp(1.0f, -20)), 0x3c00);
+
+  // A carry out of the mantissa increments the exponent
+  EXPECT_EQ(ToHalf(2.0f - 0.25f * ulp), 0x4000);
+}
+
+TEST(ConvertFloatToFloat16, Subnormal) {
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -24)), 0x0001);  // smallest subnormal
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -15)), 0x0200);
+  EXPECT_EQ(ToHalf(-std::ldexp(3.0f, -24)), 0x8003);
+
+  // Halfway between 0 and the smallest subnormal rounds to 0
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -25)), 0x0000);
+  EXPECT_EQ(ToHalf(std::ldexp(1.5f, -25)), 0x0001);
+  EXPECT_EQ(ToHalf(std::ldexp(1.5f, -24)), 0x0002);
+  EXPECT_EQ(ToHalf(std::ldexp(2.5f, -24)), 0x0002);
+
+  // Too small: flush to a signed zero
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -30)), 0x0000);
+  EXPECT_EQ(ToHalf(-std::ldexp(1.0f, -30)), 0x8000);
+  EXPECT_EQ(ToHalf(std::numeric_limits<float>::denorm_min()), 0x0000);
+
+  // The largest subnormal rounds up to the smallest normal
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -14) - std::ldexp(1.0f, -25)), 0x0400);
+  EXPECT_EQ(ToHalf(std::ldexp(1.0f, -14) - std::ldexp(1.0f, -24)), 0x03ff);
+}
+
+TEST(ConvertFloatToFloat16, Overflow) {
+  // Below the midpoint between 65504 and 65536
+  EXPECT_EQ(ToHalf(65519.0f), 0x7bff);
+  // The midpoint rounds to even, i.e., to infinity
+  EXPECT_EQ(ToHalf(65520.0f), 0x7c00);
+  EXPECT_EQ(ToHalf(1e10f), 0x7c00);
+  EXPECT_EQ(ToHalf(-1e10f), 0xfc00);
+  EXPECT_EQ(ToHalf(std::numeric_limits<float>::max()), 0x7c00);
+}
+
+TEST(ConvertFloatToFloat16, InfAndNaN) {
+  float inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(ToHalf(inf), 0x7c00);
+  EXPECT_EQ(ToHalf(-inf), 0xfc00);
+
+  EXPECT_TRUE(IsHalfNaN(ToHalf(std::numeric_limits<float>::quiet_NaN())));
+  EXPECT_TRUE(IsHalfNaN(ToHalf(-std::numeric_limits<float>::quiet_NaN())));
+
+  // A NaN whose payload lives only in the low mantissa bits must not
+  // become infinity
+  uint32_t bits = 0x7f800001;
+  float nan;
+  memcpy(&nan, &bits, sizeof(nan));
+  EXPECT_TRUE(IsHalfNaN(ToHalf(nan)));
+}
+
+TEST(ConvertFloat16ToFloat, Special) {
+  std::vector<float> f = ToFloat({0x0000, 0x8000, 0x3c00, 0x0001, 0x03ff,
+                                  0x7bff, 0x7c00, 0xfc00, 0x7e00});
+  EXPECT_EQ(f[0], 0.0f);
+  EXPECT_TRUE(std::signbit(f[1]));
+  EXPECT_EQ(f[2], 1.0f);
+  EXPECT_EQ(f[3], std::ldexp(1.0f, -24));
+  EXPECT_EQ(f[4], std::ldexp(1023.0f, -24));
+  EXPECT_EQ(f[5], 65504.0f);
+  EXPECT_EQ(f[6], std::numeric_limits<float>::infinity());
+  EXPECT_EQ(f[7], -std::numeric_limits<float>::infinity());
+  EXPECT_TRUE(std::isnan(f[8]));
+}
+
+TEST(ConvertFloat16ToFloat, RoundTrip) {
+  // Every half is exactly representable as a float, so converting it to
+  // float and back must give the same bits.
+  std::vector<uint16_t> all(1 << 16);
+  for (int32_t i = 0; i != static_cast<int32_t>(all.size()); ++i) {
+    all[i] = static_cast<uint16_t>(i);
+  }
+
+  std::vector<uint16_t> back = ToHalf(ToFloat(all));
+
+  for (int32_t i = 0; i != static_cast<int32_t>(all.size()); ++i) {
+    if (IsHalfNaN(all[i])) {
+      EXPECT_TRUE(IsHalfNaN(back[i])) << i;
+    } else {
+      EXPECT_EQ(back[i], all[i]) << i;
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
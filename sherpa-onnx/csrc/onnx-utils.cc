@@ -4,6 +4,8 @@
 // Copyright (c)  2023  Pingfeng Luo
 #include "sherpa-onnx/csrc/onnx-utils.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <fstream>
 #include <functional>
@@ -192,6 +194,118 @@ Ort::Value View(Ort::Value *v) {
   }
 }
 
+// IEEE 754 half precision with round to nearest even
+static uint16_t FloatToHalf(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t exp = (x >> 23) & 0xff;
+  uint32_t mant = x & 0x7fffff;
+
+  if (exp == 0xff) {
+    // inf or nan
+    return sign | 0x7c00 | (mant ? 0x200 : 0);
+  }
+
+  int32_t e = static_cast<int32_t>(exp) - 127 + 15;
+  if (e >= 0x1f) {
+    // overflow to inf
+    return sign | 0x7c00;
+  }
+
+  if (e <= 0) {
+    // subnormal or zero
+    if (e < -10) {
+      return sign;
+    }
+
+    mant |= 0x800000;
+    int32_t shift = 14 - e;
+    uint32_t half_mant = mant >> shift;
+    uint32_t rem = mant & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (rem > halfway || (rem == halfway && (half_mant & 1))) {
+      ++half_mant;
+    }
+    return sign | half_mant;
+  }
+
+  uint32_t half = sign | (e << 10) | (mant >> 13);
+  uint32_t rem = mant & 0x1fff;
+  if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) {
+    // A carry into the exponent is still correct
+    ++half;
+  }
+
+  return half;
+}
+
+static float HalfToFloat(uint16_t h) {
+  uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+  uint32_t exp = (h >> 10) & 0x1f;
+  uint32_t mant = h & 0x3ff;
+
+  uint32_t x;
+  if (exp == 0) {
+    if (mant == 0) {
+      x = sign;
+    } else {
+      // subnormal
+      exp = 127 - 15 + 1;
+      while ((mant & 0x400) == 0) {
+        mant <<= 1;
+        --exp;
+      }
+      mant &= 0x3ff;
+      x = sign | (exp << 23) | (mant << 13);
+    }
+  } else if (exp == 0x1f) {
+    x = sign | 0x7f800000 | (mant << 13);
+  } else {
+    x = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+  }
+
+  float f;
+  memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+Ort::Value ConvertFloatToFloat16(OrtAllocator *allocator, const Ort::Value *v) {
+  auto type_and_shape = v->GetTensorTypeAndShapeInfo();
+  std::vector<int64_t> shape = type_and_shape.GetShape();
+  int64_t n = type_and_shape.GetElementCount();
+
+  Ort::Value ans = Ort::Value::CreateTensor(
+      allocator, shape.data(), shape.size(),
+      ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+
+  const float *src = v->GetTensorData<float>();
+  uint16_t *dst = ans.GetTensorMutableData<uint16_t>();
+  for (int64_t i = 0; i != n; ++i) {
+    dst[i] = FloatToHalf(src[i]);
+  }
+
+  return ans;
+}
+
+Ort::Value ConvertFloat16ToFloat(OrtAllocator *allocator, const Ort::Value *v) {
+  auto type_and_shape = v->GetTensorTypeAndShapeInfo();
+  std::vector<int64_t> shape = type_and_shape.GetShape();
+  int64_t n = type_and_shape.GetElementCount();
+
+  Ort::Value ans =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+
+  const uint16_t *src = v->GetTensorData<uint16_t>();
+  float *dst = ans.GetTensorMutableData<float>();
+  for (int64_t i = 0; i != n; ++i) {
+    dst[i] = HalfToFloat(src[i]);
+  }
+
+  return ans;
+}
+
 float ComputeSum(const Ort::Value *v, int32_t n /*= -1*/) {
   std::vector<int64_t> shape = v->GetTensorTypeAndShapeInfo().GetShape();
   auto size = static_cast<int32_t>(
@@ -66,6 +66,14 @@ Ort::Value Clone(OrtAllocator *allocator, const Ort::Value *v);
 // Return a shallow copy
 Ort::Value View(Ort::Value *v);
 
+// Return a float16 tensor with values of the given float tensor.
+// Used for models exported with float16 inputs.
+Ort::Value ConvertFloatToFloat16(OrtAllocator *allocator, const Ort::Value *v);
+
+// Return a float tensor with values of the given float16 tensor.
+// Used for models exported with float16 outputs.
+Ort::Value ConvertFloat16ToFloat(OrtAllocator *allocator, const Ort::Value *v);
+
 float ComputeSum(const Ort::Value *v, int32_t n = -1);
 float ComputeMean(const Ort::Value *v, int32_t n = -1);
 
@@ -102,9 +102,77 @@ std::string TensorrtConfig::ToString() const {
   return os.str();
 }
 
+void SessionConfig::Register(ParseOptions *po) {
+  po->Register("ort-graph-optimization-level", &graph_optimization_level,
+               "Graph optimization level of onnxruntime: disabled, basic, "
+               "extended, or all");
+  po->Register("ort-optimized-model-cache-dir", &optimized_model_cache_dir,
+               "If not empty, save the optimized model in ORT format to this "
+               "existing and writable directory and load it at the next "
+               "startup. Empty to disable the cache.");
+  po->Register("ort-intra-op-num-threads", &intra_op_num_threads,
+               "Number of threads to run an operator. 0 to use --num-threads");
+  po->Register("ort-inter-op-num-threads", &inter_op_num_threads,
+               "Number of threads to run independent operators in parallel. "
+               "0 to use --num-threads");
+  po->Register("ort-allow-spinning", &allow_spinning,
+               "False to let idle threads of onnxruntime sleep instead of "
+               "spinning");
+  po->Register("ort-thread-affinity", &thread_affinity,
+               "Affinity of the intra op threads, e.g., '1;2;3' for 4 "
+               "threads. See session.intra_op_thread_affinities of "
+               "onnxruntime. Empty to let onnxruntime decide.");
+  po->Register("ort-profile-prefix", &profile_prefix,
+               "If not empty, enable the profiler of onnxruntime. The result "
+               "of each session is saved to <prefix>_<timestamp>.json");
+}
+
+bool SessionConfig::Validate() const {
+  if (graph_optimization_level != "disabled" &&
+      graph_optimization_level != "basic" &&
+      graph_optimization_level != "extended" &&
+      graph_optimization_level != "all") {
+    SHERPA_ONNX_LOGE(
+        "graph_optimization_level: '%s' is not valid. Options: disabled, "
+        "basic, extended, all",
+        graph_optimization_level.c_str());
+    return false;
+  }
+
+  if (intra_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE("intra_op_num_threads: %d is not valid.",
+                     intra_op_num_threads);
+    return false;
+  }
+
+  if (inter_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE("inter_op_num_threads: %d is not valid.",
+                     inter_op_num_threads);
+    return false;
+  }
+
+  return true;
+}
+
+std::string SessionConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "SessionConfig(";
+  os << "graph_optimization_level=\"" << graph_optimization_level << "\", ";
+  os << "optimized_model_cache_dir=\"" << optimized_model_cache_dir << "\", ";
+  os << "intra_op_num_threads=" << intra_op_num_threads << ", ";
+  os << "inter_op_num_threads=" << inter_op_num_threads << ", ";
+  os << "allow_spinning=" << (allow_spinning ? "True" : "False") << ", ";
+  os << "thread_affinity=\"" << thread_affinity << "\", ";
+  os << "profile_prefix=\"" << profile_prefix << "\")";
+
+  return os.str();
+}
+
 void ProviderConfig::Register(ParseOptions *po) {
   cuda_config.Register(po);
   trt_config.Register(po);
+  session_config.Register(po);
 
   po->Register("device", &device, "GPU device index for CUDA and Trt EP");
   po->Register("provider", &provider,
@@ -125,7 +193,7 @@ bool ProviderConfig::Validate() const {
     return false;
   }
 
-  return true;
+  return session_config.Validate();
 }
 
 std::string ProviderConfig::ToString() const {
@@ -135,7 +203,8 @@ std::string ProviderConfig::ToString() const {
   os << "device=" << device << ", ";
   os << "provider=\"" << provider << "\", ";
   os << "cuda_config=" << cuda_config.ToString() << ", ";
-  os << "trt_config=" << trt_config.ToString() << ")";
+  os << "trt_config=" << trt_config.ToString() << ", ";
+  os << "session_config=" << session_config.ToString() << ")";
   return os.str();
 }
 
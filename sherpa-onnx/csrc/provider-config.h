@@ -64,9 +64,60 @@ struct TensorrtConfig {
   std::string ToString() const;
 };
 
+// Options of onnxruntime sessions that do not depend on the provider
+struct SessionConfig {
+  // disabled, basic, extended, or all
+  std::string graph_optimization_level = "all";
+
+  // If not empty, the model optimized by onnxruntime is saved in ORT format
+  // to this directory and is loaded instead of the model file next time,
+  // so that graph optimization is not run at each startup. The directory
+  // must exist and be writable. Used only for some models.
+  std::string optimized_model_cache_dir;
+
+  // 0 means to use num_threads of the model config
+  int32_t intra_op_num_threads = 0;
+  int32_t inter_op_num_threads = 0;
+
+  // False to let idle threads of the thread pools sleep instead of spinning.
+  // It saves CPU at the cost of latency.
+  bool allow_spinning = true;
+
+  // CPU affinity of the intra op threads except the calling thread.
+  // It is passed to onnxruntime as session.intra_op_thread_affinities, e.g.,
+  // "1;2;3" for 4 threads. Logical processors are 1-based. Empty to let
+  // onnxruntime decide.
+  std::string thread_affinity;
+
+  // If not empty, onnxruntime profiles each session and writes the result
+  // to <profile_prefix>_<timestamp>.json when the session is destroyed.
+  std::string profile_prefix;
+
+  SessionConfig() = default;
+  SessionConfig(const std::string &graph_optimization_level,
+                const std::string &optimized_model_cache_dir,
+                int32_t intra_op_num_threads,
+                int32_t inter_op_num_threads, bool allow_spinning,
+                const std::string &thread_affinity,
+                const std::string &profile_prefix)
+      : graph_optimization_level(graph_optimization_level),
+        optimized_model_cache_dir(optimized_model_cache_dir),
+        intra_op_num_threads(intra_op_num_threads),
+        inter_op_num_threads(inter_op_num_threads),
+        allow_spinning(allow_spinning),
+        thread_affinity(thread_affinity),
+        profile_prefix(profile_prefix) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
 struct ProviderConfig {
   TensorrtConfig trt_config;
   CudaConfig cuda_config;
+  SessionConfig session_config;
   std::string provider = "cpu";
   int32_t device = 0;
   // device only used for cuda and trt
@@ -24,12 +24,25 @@
 
 #include "sherpa-onnx/csrc/resample.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <type_traits>
 
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SHERPA_ONNX_RESAMPLE_AVX2 1
+#elif defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SHERPA_ONNX_RESAMPLE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SHERPA_ONNX_RESAMPLE_NEON 1
+#endif
+
 #ifndef M_2PI
 #define M_2PI 6.283185307179586476925286766559005
 #endif
@@ -73,10 +86,71 @@ static I Lcm(I m, I n) {
 }
 
 static float DotProduct(const float *a, const float *b, int32_t n) {
+  int32_t i = 0;
   float sum = 0;
-  for (int32_t i = 0; i != n; ++i) {
+
+#if defined(SHERPA_ONNX_RESAMPLE_AVX2)
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                           _mm256_loadu_ps(b + i + 8), acc1);
+  }
+
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           acc0);
+  }
+
+  acc0 = _mm256_add_ps(acc0, acc1);
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc0),
+                        _mm256_extractf128_ps(acc0, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+  sum = _mm_cvtss_f32(s);
+#elif defined(SHERPA_ONNX_RESAMPLE_SSE)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0,
+                      _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(
+        acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_ps(acc0,
+                      _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  }
+
+  __m128 s = _mm_add_ps(acc0, acc1);
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+  sum = _mm_cvtss_f32(s);
+#elif defined(SHERPA_ONNX_RESAMPLE_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+
+  for (; i + 4 <= n; i += 4) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+  }
+
+  acc0 = vaddq_f32(acc0, acc1);
+  float32x2_t s = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+  s = vpadd_f32(s, s);
+  sum = vget_lane_f32(s, 0);
+#endif
+
+  for (; i < n; ++i) {
     sum += a[i] * b[i];
   }
+
   return sum;
 }
 
@@ -103,10 +177,12 @@ LinearResample::LinearResample(int32_t samp_rate_in_hz,
 
 void LinearResample::SetIndexesAndWeights() {
   first_index_.resize(output_samples_in_unit_);
-  weights_.resize(output_samples_in_unit_);
+  num_weights_.resize(output_samples_in_unit_);
 
   double window_width = num_zeros_ / (2.0 * filter_cutoff_);
 
+  std::vector<std::vector<float>> weights(output_samples_in_unit_);
+
   for (int32_t i = 0; i < output_samples_in_unit_; i++) {
     double output_t = i / static_cast<double>(samp_rate_out_);
     double min_t = output_t - window_width, max_t = output_t + window_width;
@@ -121,15 +197,27 @@ void LinearResample::SetIndexesAndWeights() {
             max_input_index = floor(max_t * samp_rate_in_),
             num_indices = max_input_index - min_input_index + 1;
     first_index_[i] = min_input_index;
-    weights_[i].resize(num_indices);
+    num_weights_[i] = num_indices;
+    weights[i].resize(num_indices);
     for (int32_t j = 0; j < num_indices; j++) {
       int32_t input_index = min_input_index + j;
       double input_t = input_index / static_cast<double>(samp_rate_in_),
              delta_t = input_t - output_t;
       // sign of delta_t doesn't matter.
-      weights_[i][j] = FilterFunc(delta_t) / samp_rate_in_;
+      weights[i][j] = FilterFunc(delta_t) / samp_rate_in_;
     }
   }
+
+  weights_stride_ =
+      *std::max_element(num_weights_.begin(), num_weights_.end());
+
+  // Unused entries are zero
+  weights_.assign(output_samples_in_unit_ * weights_stride_, 0);
+
+  for (int32_t i = 0; i < output_samples_in_unit_; i++) {
+    std::copy(weights[i].begin(), weights[i].end(),
+              weights_.begin() + i * weights_stride_);
+  }
 }
 
 /** Here, t is a time in seconds representing an offset from
@@ -160,12 +248,29 @@ void LinearResample::Reset() {
 
 void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
                               std::vector<float> *output) {
+  output->resize(NumOutputSamples(input_dim, flush));
+
+  Resample(input, input_dim, flush, output->data());
+}
+
+int32_t LinearResample::NumOutputSamples(int32_t input_dim, bool flush) const {
   int64_t tot_input_samp = input_sample_offset_ + input_dim,
           tot_output_samp = GetNumOutputSamples(tot_input_samp, flush);
 
   assert(tot_output_samp >= output_sample_offset_);
 
-  output->resize(tot_output_samp - output_sample_offset_);
+  return static_cast<int32_t>(tot_output_samp - output_sample_offset_);
+}
+
+int32_t LinearResample::Resample(const float *input, int32_t input_dim,
+                                 bool flush, float *output) {
+  int64_t tot_input_samp = input_sample_offset_ + input_dim,
+          tot_output_samp = GetNumOutputSamples(tot_input_samp, flush);
+
+  assert(tot_output_samp >= output_sample_offset_);
+
+  int32_t num_output_samples =
+      static_cast<int32_t>(tot_output_samp - output_sample_offset_);
 
   // samp_out is the index into the total output signal, not just the part
   // of it we are producing here.
@@ -174,19 +279,19 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
     int64_t first_samp_in = 0;
     int32_t samp_out_wrapped = 0;
     GetIndexes(samp_out, &first_samp_in, &samp_out_wrapped);
-    const std::vector<float> &weights = weights_[samp_out_wrapped];
+    const float *weights = weights_.data() + samp_out_wrapped * weights_stride_;
+    int32_t num_weights = num_weights_[samp_out_wrapped];
     // first_input_index is the first index into "input" that we have a weight
     // for.
     int32_t first_input_index =
         static_cast<int32_t>(first_samp_in - input_sample_offset_);
     float this_output = 0;
     if (first_input_index >= 0 &&
-        first_input_index + static_cast<int32_t>(weights.size()) <= input_dim) {
-      this_output =
-          DotProduct(input + first_input_index, weights.data(), weights.size());
+        first_input_index + num_weights <= input_dim) {
+      this_output = DotProduct(input + first_input_index, weights, num_weights);
     } else {  // Handle edge cases.
       this_output = 0.0;
-      for (int32_t i = 0; i < static_cast<int32_t>(weights.size()); i++) {
+      for (int32_t i = 0; i < num_weights; i++) {
         float weight = weights[i];
         int32_t input_index = first_input_index + i;
         if (input_index < 0 &&
@@ -205,7 +310,7 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
     }
     int32_t output_index =
         static_cast<int32_t>(samp_out - output_sample_offset_);
-    (*output)[output_index] = this_output;
+    output[output_index] = this_output;
   }
 
   if (flush) {
@@ -215,6 +320,8 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
     input_sample_offset_ = tot_input_samp;
     output_sample_offset_ = tot_output_samp;
   }
+
+  return num_output_samples;
 }
 
 int64_t LinearResample::GetNumOutputSamples(int64_t input_num_samp,
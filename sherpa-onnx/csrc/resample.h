@@ -73,6 +73,20 @@ class LinearResample {
   void Resample(const float *input, int32_t input_dim, bool flush,
                 std::vector<float> *output);
 
+  /// Same as above, but write the output to a caller-provided buffer so
+  /// that no memory is allocated in the streaming case.
+  ///
+  /// `output` must have room for at least NumOutputSamples(input_dim, flush)
+  /// samples.
+  ///
+  /// @return Return the number of samples written to `output`.
+  int32_t Resample(const float *input, int32_t input_dim, bool flush,
+                   float *output);
+
+  /// Return the number of samples that the next call to
+  /// Resample(input, input_dim, flush, ...) will output.
+  int32_t NumOutputSamples(int32_t input_dim, bool flush) const;
+
   //// Return the input and output sampling rates (for checks, for example)
   int32_t GetInputSamplingRate() const { return samp_rate_in_; }
   int32_t GetOutputSamplingRate() const { return samp_rate_out_; }
@@ -124,8 +138,16 @@ class LinearResample {
   /// extrapolate the correct input-sample index for arbitrary output samples.
   std::vector<int32_t> first_index_;
 
-  /// Weights on the input samples, for this output-sample index.
-  std::vector<std::vector<float>> weights_;
+  /// Number of weights for each output-sample index in a unit.
+  std::vector<int32_t> num_weights_;
+
+  /// Weights on the input samples, for each output-sample index in a unit.
+  /// They are stored contiguously; the weights for the i-th output-sample
+  /// index start at weights_[i * weights_stride_].
+  std::vector<float> weights_;
+
+  /// Maximum of num_weights_
+  int32_t weights_stride_ = 0;
 
   // the following variables keep track of where we are in a particular signal,
   // if it is being provided over multiple calls to Resample().
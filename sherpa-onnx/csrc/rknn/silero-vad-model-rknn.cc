@@ -93,6 +93,39 @@ class SileroVadModelRknn::Impl {
 
     float prob = Run(samples, n);
 
+    return Update(prob);
+  }
+
+  bool SkipWindow(bool reset_states) {
+    if (reset_states) {
+      for (auto &s : states_) {
+        std::fill(s.begin(), s.end(), 0);
+      }
+    }
+
+    return Update(0);
+  }
+
+  int32_t WindowShift() const { return config_.silero_vad.window_size; }
+
+  int32_t WindowSize() const {
+    return config_.silero_vad.window_size + window_overlap_;
+  }
+
+  int32_t MinSilenceDurationSamples() const { return min_silence_samples_; }
+
+  int32_t MinSpeechDurationSamples() const { return min_speech_samples_; }
+
+  void SetMinSilenceDuration(float s) {
+    min_silence_samples_ = sample_rate_ * s;
+  }
+
+  void SetThreshold(float threshold) {
+    config_.silero_vad.threshold = threshold;
+  }
+
+ private:
+  bool Update(float prob) {
     float threshold = config_.silero_vad.threshold;
 
     current_sample_ += config_.silero_vad.window_size;
@@ -157,25 +190,6 @@ class SileroVadModelRknn::Impl {
     return false;
   }
 
-  int32_t WindowShift() const { return config_.silero_vad.window_size; }
-
-  int32_t WindowSize() const {
-    return config_.silero_vad.window_size + window_overlap_;
-  }
-
-  int32_t MinSilenceDurationSamples() const { return min_silence_samples_; }
-
-  int32_t MinSpeechDurationSamples() const { return min_speech_samples_; }
-
-  void SetMinSilenceDuration(float s) {
-    min_silence_samples_ = sample_rate_ * s;
-  }
-
-  void SetThreshold(float threshold) {
-    config_.silero_vad.threshold = threshold;
-  }
-
- private:
   void Init(void *model_data, size_t model_data_length) {
     InitContext(model_data, model_data_length, config_.debug, &ctx_);
 
@@ -375,6 +389,10 @@ bool SileroVadModelRknn::IsSpeech(const float *samples, int32_t n) {
   return impl_->IsSpeech(samples, n);
 }
 
+bool SileroVadModelRknn::SkipWindow(bool reset_states) {
+  return impl_->SkipWindow(reset_states);
+}
+
 int32_t SileroVadModelRknn::WindowSize() const { return impl_->WindowSize(); }
 
 int32_t SileroVadModelRknn::WindowShift() const { return impl_->WindowShift(); }
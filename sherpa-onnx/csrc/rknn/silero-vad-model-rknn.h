@@ -33,6 +33,8 @@ class SileroVadModelRknn : public VadModel {
    */
   bool IsSpeech(const float *samples, int32_t n) override;
 
+  bool SkipWindow(bool reset_states) override;
+
   // For silero vad V4, it is WindowShift().
   int32_t WindowSize() const override;
 
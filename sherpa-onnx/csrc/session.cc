@@ -4,13 +4,23 @@
 
 #include "sherpa-onnx/csrc/session.h"
 
+#include <sys/stat.h>
+
 #include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/provider.h"
+#include "sherpa-onnx/csrc/text-utils.h"
 #if defined(__APPLE__)
 #include "coreml_provider_factory.h"  // NOLINT
 #endif
@@ -35,15 +45,69 @@ static void OrtStatusFailure(OrtStatus *status, const char *s) {
   api.ReleaseStatus(status);
 }
 
+static GraphOptimizationLevel ToGraphOptimizationLevel(
+    const std::string &level) {
+  if (level == "disabled") {
+    return ORT_DISABLE_ALL;
+  } else if (level == "basic") {
+    return ORT_ENABLE_BASIC;
+  } else if (level == "extended") {
+    return ORT_ENABLE_EXTENDED;
+  }
+
+  return ORT_ENABLE_ALL;
+}
+
+static void ApplySessionConfig(const SessionConfig &config,
+                               int32_t num_threads,
+                               Ort::SessionOptions *sess_opts) {
+  sess_opts->SetIntraOpNumThreads(config.intra_op_num_threads > 0
+                                      ? config.intra_op_num_threads
+                                      : num_threads);
+
+  sess_opts->SetInterOpNumThreads(config.inter_op_num_threads > 0
+                                      ? config.inter_op_num_threads
+                                      : num_threads);
+
+  sess_opts->SetGraphOptimizationLevel(
+      ToGraphOptimizationLevel(config.graph_optimization_level));
+
+  if (!config.allow_spinning) {
+    sess_opts->AddConfigEntry("session.intra_op.allow_spinning", "0");
+    sess_opts->AddConfigEntry("session.inter_op.allow_spinning", "0");
+  }
+
+  if (!config.thread_affinity.empty()) {
+    sess_opts->AddConfigEntry("session.intra_op_thread_affinities",
+                              config.thread_affinity.c_str());
+  }
+
+  if (!config.profile_prefix.empty()) {
+#if defined(_WIN32)
+    std::wstring prefix = ToWideString(config.profile_prefix);
+    sess_opts->EnableProfiling(prefix.c_str());
+#else
+    sess_opts->EnableProfiling(config.profile_prefix.c_str());
+#endif
+  }
+}
+
 Ort::SessionOptions GetSessionOptionsImpl(
     int32_t num_threads, const std::string &provider_str,
-    const ProviderConfig *provider_config /*= nullptr*/) {
+    const ProviderConfig *provider_config /*= nullptr*/,
+    const SessionConfig *session_config /*= nullptr*/) {
   Provider p = StringToProvider(provider_str);
 
   Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(num_threads);
 
-  sess_opts.SetInterOpNumThreads(num_threads);
+  if (provider_config != nullptr) {
+    ApplySessionConfig(provider_config->session_config, num_threads,
+                       &sess_opts);
+  } else if (session_config != nullptr) {
+    ApplySessionConfig(*session_config, num_threads, &sess_opts);
+  } else {
+    ApplySessionConfig(SessionConfig{}, num_threads, &sess_opts);
+  }
 
   std::vector<std::string> available_providers = Ort::GetAvailableProviders();
   std::ostringstream os;
@@ -52,9 +116,7 @@ Ort::SessionOptions GetSessionOptionsImpl(
   }
 
   // Other possible options
-  // sess_opts.SetGraphOptimizationLevel(ORT_ENABLE_EXTENDED);
   // sess_opts.SetLogSeverityLevel(ORT_LOGGING_LEVEL_VERBOSE);
-  // sess_opts.EnableProfiling("profile");
 
   switch (p) {
     case Provider::kCPU:
@@ -265,6 +327,16 @@ Ort::SessionOptions GetSessionOptions(const OnlineModelConfig &config,
                                &config.provider_config);
 }
 
+Ort::SessionOptions GetSessionOptions(const OfflineModelConfig &config) {
+  return GetSessionOptionsImpl(config.num_threads, config.provider, nullptr,
+                               &config.session_config);
+}
+
+Ort::SessionOptions GetSessionOptions(const OfflineTtsModelConfig &config) {
+  return GetSessionOptionsImpl(config.num_threads, config.provider, nullptr,
+                               &config.session_config);
+}
+
 Ort::SessionOptions GetSessionOptions(const OfflineLMConfig &config) {
   return GetSessionOptionsImpl(config.lm_num_threads, config.lm_provider);
 }
@@ -278,4 +350,127 @@ Ort::SessionOptions GetSessionOptions(int32_t num_threads,
   return GetSessionOptionsImpl(num_threads, provider_str);
 }
 
+// Return 0 if the file does not exist
+static int64_t GetModificationTime(const std::string &filename) {
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(st.st_mtime);
+}
+
+// The optimized model depends on the model file, the optimization level,
+// the provider and the version of onnxruntime, so all of them are in the
+// name of the cached file.
+static std::string GetOptimizedModelFilename(const std::string &filename,
+                                             const SessionConfig &config,
+                                             const std::string &provider) {
+  std::string version = OrtGetApiBase()->GetVersionString();
+
+  std::string key = filename + "|" + config.graph_optimization_level + "|" +
+                    provider + "|" + version;
+
+  std::ostringstream os;
+  os << std::hex << std::hash<std::string>{}(key);
+
+  std::string basename = filename;
+  auto pos = basename.find_last_of("/\\");
+  if (pos != std::string::npos) {
+    basename = basename.substr(pos + 1);
+  }
+
+  return config.optimized_model_cache_dir + "/" + basename + "." +
+         config.graph_optimization_level + "." + provider + "." + version +
+         "." + os.str() + ".ort";
+}
+
+// A unique name in the same directory as filename, so that the file can be
+// renamed to filename atomically and concurrent writers do not conflict.
+static std::string GetTempFilename(const std::string &filename) {
+  std::ostringstream os;
+  os << filename << ".tmp."
+     << std::hash<std::thread::id>{}(std::this_thread::get_id()) << "."
+     << std::chrono::steady_clock::now().time_since_epoch().count();
+  return os.str();
+}
+
+static std::unique_ptr<Ort::Session> CreateSessionFromFile(
+    const Ort::Env &env, const std::string &filename,
+    const Ort::SessionOptions &sess_opts) {
+  auto buf = ReadFile(filename);
+  return std::make_unique<Ort::Session>(env, buf.data(), buf.size(),
+                                        sess_opts);
+}
+
+std::unique_ptr<Ort::Session> CreateSession(
+    const Ort::Env &env, const std::string &filename,
+    const Ort::SessionOptions &sess_opts, const SessionConfig &config,
+    const std::string &provider) {
+  if (config.optimized_model_cache_dir.empty()) {
+    return CreateSessionFromFile(env, filename, sess_opts);
+  }
+
+  std::string cache_filename =
+      GetOptimizedModelFilename(filename, config, provider);
+
+  int64_t cache_time = GetModificationTime(cache_filename);
+  if (cache_time != 0 && cache_time >= GetModificationTime(filename)) {
+    // The model in the cache has already been optimized
+    Ort::SessionOptions opts = sess_opts.Clone();
+    opts.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+
+    try {
+      return CreateSessionFromFile(env, cache_filename, opts);
+    } catch (const Ort::Exception &e) {
+      SHERPA_ONNX_LOGW("Failed to load '%s': %s. Re-create it.",
+                       cache_filename.c_str(), e.what());
+    }
+  }
+
+  // onnxruntime writes the optimized model while creating the session.
+  // Write it to a temporary file and rename it afterwards so that other
+  // processes never load a partially written model.
+  std::string tmp_filename = GetTempFilename(cache_filename);
+
+  Ort::SessionOptions opts = sess_opts.Clone();
+  opts.AddConfigEntry("session.save_model_format", "ORT");
+#if defined(_WIN32)
+  std::wstring tmp_filename_w = ToWideString(tmp_filename);
+  opts.SetOptimizedModelFilePath(tmp_filename_w.c_str());
+#else
+  opts.SetOptimizedModelFilePath(tmp_filename.c_str());
+#endif
+
+  std::unique_ptr<Ort::Session> sess;
+  try {
+    sess = CreateSessionFromFile(env, filename, opts);
+  } catch (const Ort::Exception &e) {
+    // e.g., the cache directory is not writable
+    SHERPA_ONNX_LOGW("Failed to save the optimized model to '%s': %s",
+                     tmp_filename.c_str(), e.what());
+    std::remove(tmp_filename.c_str());
+
+    return CreateSessionFromFile(env, filename, sess_opts);
+  }
+
+  if (GetModificationTime(tmp_filename) == 0) {
+    SHERPA_ONNX_LOGW("onnxruntime did not save the optimized model to '%s'",
+                     tmp_filename.c_str());
+    return sess;
+  }
+
+#if defined(_WIN32)
+  // rename() does not replace an existing file on Windows
+  std::remove(cache_filename.c_str());
+#endif
+
+  if (std::rename(tmp_filename.c_str(), cache_filename.c_str()) != 0) {
+    SHERPA_ONNX_LOGW("Failed to rename '%s' to '%s'", tmp_filename.c_str(),
+                     cache_filename.c_str());
+    std::remove(tmp_filename.c_str());
+  }
+
+  return sess;
+}
+
 }  // namespace sherpa_onnx
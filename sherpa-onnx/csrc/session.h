@@ -5,18 +5,26 @@
 #ifndef SHERPA_ONNX_CSRC_SESSION_H_
 #define SHERPA_ONNX_CSRC_SESSION_H_
 
+#include <memory>
 #include <string>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/offline-lm-config.h"
+#include "sherpa-onnx/csrc/offline-model-config.h"
+#include "sherpa-onnx/csrc/offline-tts-model-config.h"
 #include "sherpa-onnx/csrc/online-lm-config.h"
 #include "sherpa-onnx/csrc/online-model-config.h"
+#include "sherpa-onnx/csrc/provider-config.h"
 
 namespace sherpa_onnx {
 
 Ort::SessionOptions GetSessionOptionsImpl(
     int32_t num_threads, const std::string &provider_str,
-    const ProviderConfig *provider_config = nullptr);
+    const ProviderConfig *provider_config = nullptr,
+    const SessionConfig *session_config = nullptr);
+
+Ort::SessionOptions GetSessionOptions(const OfflineModelConfig &config);
+Ort::SessionOptions GetSessionOptions(const OfflineTtsModelConfig &config);
 
 Ort::SessionOptions GetSessionOptions(const OfflineLMConfig &config);
 Ort::SessionOptions GetSessionOptions(const OnlineLMConfig &config);
@@ -34,6 +42,22 @@ Ort::SessionOptions GetSessionOptions(const T &config) {
   return GetSessionOptionsImpl(config.num_threads, config.provider);
 }
 
+/** Create a session for the given model file.
+ *
+ * If config.optimized_model_cache_dir is not empty, the model optimized by
+ * onnxruntime is saved in ORT format to that directory. The name of the
+ * saved file depends on the model file, config.graph_optimization_level,
+ * the provider and the version of onnxruntime. Later calls load the saved
+ * model instead and skip graph optimization, unless the model file is newer.
+ *
+ * If the optimized model cannot be saved or loaded, the session is created
+ * from the model file as if the cache were disabled.
+ */
+std::unique_ptr<Ort::Session> CreateSession(
+    const Ort::Env &env, const std::string &filename,
+    const Ort::SessionOptions &sess_opts, const SessionConfig &config,
+    const std::string &provider);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_SESSION_H_
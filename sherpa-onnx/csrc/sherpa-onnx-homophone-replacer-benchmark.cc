@@ -0,0 +1,165 @@
+// sherpa-onnx/csrc/sherpa-onnx-homophone-replacer-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Per-partial latency of HomophoneReplacer::Apply() for streaming ASR.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/homophone-replacer.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace {
+
+// Return the latency in microseconds of each call. results[i] is the
+// output for the last partial result of lines[i].
+std::vector<float> Run(const sherpa_onnx::HomophoneReplacerConfig &config,
+                       const std::vector<std::string> &lines, int32_t step,
+                       std::vector<std::string> *results) {
+  sherpa_onnx::HomophoneReplacer replacer(config);
+
+  std::vector<float> ans;
+  results->clear();
+
+  for (const auto &line : lines) {
+    std::vector<std::string> chars = sherpa_onnx::SplitUtf8(line);
+
+    std::string partial;
+    std::string r;
+    for (size_t i = 0; i < chars.size(); ++i) {
+      partial += chars[i];
+      if ((i + 1) % step != 0 && i + 1 != chars.size()) {
+        continue;
+      }
+
+      auto begin = std::chrono::steady_clock::now();
+      r = replacer.Apply(partial);
+      auto end = std::chrono::steady_clock::now();
+
+      ans.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+              .count() /
+          1e3);
+    }
+
+    results->push_back(std::move(r));
+  }
+
+  return ans;
+}
+
+void PrintStats(const char *name, std::vector<float> latency) {
+  if (latency.empty()) {
+    return;
+  }
+
+  std::sort(latency.begin(), latency.end());
+
+  double sum = 0;
+  for (auto f : latency) {
+    sum += f;
+  }
+
+  auto percentile = [&latency](float p) {
+    return latency[static_cast<size_t>(p * (latency.size() - 1))];
+  };
+
+  fprintf(stderr, "%-10s %10zu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+          latency.size(), sum / latency.size(), percentile(0.5),
+          percentile(0.9), percentile(0.99), latency.back());
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Measure the latency of the homophone replacer for partial results of
+streaming ASR. Each line of the given text file is an utterance. Partial
+results are simulated by appending --step characters at a time, and each
+partial result is processed from scratch as the online recognizer does.
+
+The test is run twice: once with the cache disabled and once with
+--hr-cache-size.
+
+Usage:
+
+./bin/sherpa-onnx-homophone-replacer-benchmark \
+  --hr-dict-dir=./dict \
+  --hr-lexicon=./lexicon.txt \
+  --hr-rule-fsts=./replace.fst \
+  ./text.txt
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::HomophoneReplacerConfig config;
+  config.Register(&po);
+
+  int32_t step = 1;
+  po.Register("step", &step,
+              "Number of characters appended to each partial result");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "\nError: Please provide 1 text file\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate() || step < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  std::vector<std::string> lines;
+  {
+    std::ifstream is(po.GetArg(1));
+    std::string line;
+    while (std::getline(is, line)) {
+      if (!line.empty()) {
+        lines.push_back(std::move(line));
+      }
+    }
+  }
+
+  if (lines.empty()) {
+    fprintf(stderr, "No text in '%s'\n", po.GetArg(1).c_str());
+    return -1;
+  }
+
+  auto no_cache_config = config;
+  no_cache_config.cache_size = 0;
+
+  std::vector<std::string> expected;
+  std::vector<std::string> results;
+  auto no_cache = Run(no_cache_config, lines, step, &expected);
+  auto cache = Run(config, lines, step, &results);
+
+  fprintf(stderr, "Latency per partial result in microseconds\n");
+  fprintf(stderr, "%-10s %10s %10s %10s %10s %10s %10s\n", "", "count",
+          "mean", "p50", "p90", "p99", "max");
+  PrintStats("no-cache", std::move(no_cache));
+  PrintStats("cache", std::move(cache));
+
+  int32_t num_diff = 0;
+  for (size_t i = 0; i != lines.size(); ++i) {
+    if (results[i] != expected[i]) {
+      num_diff += 1;
+      fprintf(stderr, "Mismatch:\n  %s\n  %s\n", expected[i].c_str(),
+              results[i].c_str());
+    }
+  }
+  fprintf(stderr, "Utterances: %d, mismatches: %d\n",
+          static_cast<int32_t>(lines.size()), num_diff);
+
+  return 0;
+}
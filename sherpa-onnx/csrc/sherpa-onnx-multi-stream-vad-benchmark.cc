@@ -0,0 +1,301 @@
+// sherpa-onnx/csrc/sherpa-onnx-multi-stream-vad-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sherpa-onnx/csrc/multi-stream-vad.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+// Speech-like bursts separated by silence, so that the VAD has
+// something to detect
+static std::vector<float> GenerateSamples(int32_t num_samples,
+                                          int32_t sample_rate) {
+  std::mt19937 gen(20250104);
+  std::uniform_real_distribution<float> noise(-0.3, 0.3);
+
+  std::vector<float> ans(num_samples);
+  for (int32_t i = 0; i != num_samples; ++i) {
+    // 1.5 seconds of noise, then 1 second of silence
+    int32_t k = i % (sample_rate * 5 / 2);
+    if (k < sample_rate * 3 / 2) {
+      ans[i] = noise(gen);
+    }
+  }
+
+  return ans;
+}
+
+// Feed `samples` to each stream in steps of `tick` samples, as a gateway
+// receiving packets from many calls would do.
+static int32_t RunMultiStreamVad(const sherpa_onnx::MultiStreamVad &vad,
+                                 const std::vector<float> &samples,
+                                 int32_t num_streams, int32_t tick,
+                                 float buffer_size_in_seconds,
+                                 int64_t *num_segments) {
+  std::vector<std::unique_ptr<sherpa_onnx::VadStream>> streams;
+  std::vector<sherpa_onnx::VadStream *> ss;
+  streams.reserve(num_streams);
+  ss.reserve(num_streams);
+
+  for (int32_t i = 0; i != num_streams; ++i) {
+    streams.push_back(vad.CreateStream(buffer_size_in_seconds));
+    ss.push_back(streams.back().get());
+  }
+
+  int32_t num_runs = 0;
+  int32_t n = samples.size();
+
+  for (int32_t offset = 0; offset < n; offset += tick) {
+    int32_t k = std::min(tick, n - offset);
+    for (auto s : ss) {
+      s->AcceptWaveform(samples.data() + offset, k);
+    }
+
+    num_runs += vad.Process(ss.data(), ss.size());
+
+    for (auto s : ss) {
+      while (!s->Empty()) {
+        *num_segments += 1;
+        s->Pop();
+      }
+    }
+  }
+
+  for (auto s : ss) {
+    s->Flush();
+    while (!s->Empty()) {
+      *num_segments += 1;
+      s->Pop();
+    }
+  }
+
+  return num_runs;
+}
+
+// The baseline: one VoiceActivityDetector per stream
+static void RunVoiceActivityDetector(const sherpa_onnx::VadModelConfig &config,
+                                     const std::vector<float> &samples,
+                                     int32_t num_streams,
+                                     float buffer_size_in_seconds,
+                                     int64_t *num_segments) {
+  std::vector<std::unique_ptr<sherpa_onnx::VoiceActivityDetector>> vads;
+  vads.reserve(num_streams);
+  for (int32_t i = 0; i != num_streams; ++i) {
+    vads.push_back(std::make_unique<sherpa_onnx::VoiceActivityDetector>(
+        config, buffer_size_in_seconds));
+  }
+
+  int32_t window_size = config.silero_vad.window_size;
+  int32_t n = samples.size();
+
+  for (int32_t offset = 0; offset + window_size <= n;
+       offset += window_size) {
+    for (auto &vad : vads) {
+      vad->AcceptWaveform(samples.data() + offset, window_size);
+      while (!vad->Empty()) {
+        *num_segments += 1;
+        vad->Pop();
+      }
+    }
+  }
+
+  for (auto &vad : vads) {
+    vad->Flush();
+    while (!vad->Empty()) {
+      *num_segments += 1;
+      vad->Pop();
+    }
+  }
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+This program benchmarks the multi-stream batched VAD, which runs silero VAD
+on many concurrent audio streams with one model invocation per window.
+
+It reports how many real-time channels can be handled per CPU core.
+
+  ./bin/sherpa-onnx-multi-stream-vad-benchmark \
+    --silero-vad-model=/path/to/silero_vad.onnx \
+    --num-streams=1000 \
+    --num-workers=4 \
+    --compare=true \
+    [/path/to/input.wav]
+
+If no wave file is given, --duration seconds of synthetic audio are used.
+The same audio is fed to all streams. input.wav should be 16kHz.
+
+--num-threads is the number of threads per ONNX Runtime session while
+--num-workers is the number of threads calling the engine, each of which
+owns num-streams / num-workers streams.
+
+Please download silero_vad.onnx from
+https://github.com/snakers4/silero-vad/raw/master/src/silero_vad/data/silero_vad.onnx
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::VadModelConfig config;
+
+  int32_t num_streams = 100;
+  int32_t num_workers = 1;
+  int32_t batch_size = 256;
+  int32_t tick_ms = 32;
+  float duration = 30;
+  float buffer_size_in_seconds = 30;
+  bool compare = false;
+
+  config.Register(&po);
+  po.Register("num-streams", &num_streams, "Number of concurrent streams");
+  po.Register("num-workers", &num_workers,
+              "Number of threads that call the engine. Streams are evenly "
+              "distributed among them");
+  po.Register("batch-size", &batch_size,
+              "Max number of streams per model invocation");
+  po.Register("tick-ms", &tick_ms,
+              "Each stream receives this many milliseconds of audio per "
+              "step");
+  po.Register("duration", &duration,
+              "Seconds of synthetic audio if no wave file is given");
+  po.Register("buffer-size-in-seconds", &buffer_size_in_seconds,
+              "Size of the per-stream buffer for detected segments");
+  po.Register("compare", &compare,
+              "true to also run one VoiceActivityDetector per stream and "
+              "compare the number of detected segments");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() > 1) {
+    fprintf(stderr, "Please provide at most 1 argument: the input wav\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  if (num_streams < 1 || num_workers < 1 || tick_ms < 1) {
+    fprintf(stderr,
+            "--num-streams, --num-workers and --tick-ms should be positive\n");
+    return -1;
+  }
+
+  num_workers = std::min(num_workers, num_streams);
+
+  std::vector<float> samples;
+  if (po.NumArgs() == 1) {
+    int32_t sampling_rate = 0;
+    bool is_ok = false;
+    samples = sherpa_onnx::ReadWave(po.GetArg(1), &sampling_rate, &is_ok);
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", po.GetArg(1).c_str());
+      return -1;
+    }
+
+    if (sampling_rate != config.sample_rate) {
+      fprintf(stderr, "Expect sample rate %d. Given: %d\n", config.sample_rate,
+              sampling_rate);
+      return -1;
+    }
+  } else {
+    samples = GenerateSamples(duration * config.sample_rate,
+                              config.sample_rate);
+  }
+
+  float audio_seconds = samples.size() / static_cast<float>(config.sample_rate);
+  int32_t tick = config.sample_rate * tick_ms / 1000;
+
+  sherpa_onnx::MultiStreamVad vad(config, batch_size);
+
+  std::vector<int64_t> num_segments(num_workers);
+  std::vector<int32_t> num_runs(num_workers);
+  std::vector<std::thread> threads;
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (int32_t w = 0; w != num_workers; ++w) {
+    int32_t n = num_streams / num_workers + (w < num_streams % num_workers);
+
+    threads.emplace_back([&, w, n]() {
+      num_runs[w] = RunMultiStreamVad(vad, samples, n, tick,
+                                      buffer_size_in_seconds, &num_segments[w]);
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  int64_t total_segments = 0;
+  int64_t total_runs = 0;
+  for (int32_t w = 0; w != num_workers; ++w) {
+    total_segments += num_segments[w];
+    total_runs += num_runs[w];
+  }
+
+  // Each worker uses config.num_threads threads of ONNX Runtime
+  int32_t num_cores = num_workers * std::max(config.num_threads, 1);
+
+  float channels_per_core =
+      num_streams * audio_seconds / elapsed_seconds / num_cores;
+
+  fprintf(stderr, "Streams: %d, audio: %.3f s per stream\n", num_streams,
+          audio_seconds);
+  fprintf(stderr, "Batched: %.3f s, %ld model runs, %ld segments\n",
+          elapsed_seconds, static_cast<long>(total_runs),  // NOLINT
+          static_cast<long>(total_segments));              // NOLINT
+  fprintf(stderr, "Batched: %.1f real-time channels per core\n",
+          channels_per_core);
+
+  if (!compare) {
+    return 0;
+  }
+
+  int64_t baseline_segments = 0;
+
+  const auto begin2 = std::chrono::steady_clock::now();
+  RunVoiceActivityDetector(config, samples, num_streams,
+                           buffer_size_in_seconds, &baseline_segments);
+  const auto end2 = std::chrono::steady_clock::now();
+
+  float elapsed_seconds2 =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end2 - begin2)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "Per-stream: %.3f s, %ld segments\n", elapsed_seconds2,
+          static_cast<long>(baseline_segments));  // NOLINT
+  fprintf(stderr, "Per-stream: %.1f real-time channels per core\n",
+          num_streams * audio_seconds / elapsed_seconds2 /
+              std::max(config.num_threads, 1));
+  fprintf(stderr, "Speedup per core: %.2fx\n",
+          channels_per_core * std::max(config.num_threads, 1) /
+              (num_streams * audio_seconds / elapsed_seconds2));
+
+  if (baseline_segments != total_segments) {
+    fprintf(stderr, "Warning: the number of segments differs\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,188 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-batch-classification-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Throughput of AudioTagging::ComputeBatch() and
+// SpokenLanguageIdentification::ComputeBatch() for different batch sizes.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/audio-tagging.h"
+#include "sherpa-onnx/csrc/offline-stream.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/spoken-language-identification.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace {
+
+struct Wave {
+  std::vector<float> samples;
+  int32_t sampling_rate = 0;
+};
+
+using CreateStreamFunc =
+    std::function<std::unique_ptr<sherpa_onnx::OfflineStream>()>;
+using ComputeFunc =
+    std::function<void(sherpa_onnx::OfflineStream **, int32_t)>;
+
+// Run num_clips clips in batches of 1, 2, 4, ..., max_batch_size.
+// Feature extraction is done before timing so that only the
+// neural network is measured.
+void Benchmark(const char *name, const std::vector<Wave> &waves,
+               int32_t num_clips, int32_t max_batch_size,
+               CreateStreamFunc create_stream, ComputeFunc compute) {
+  fprintf(stderr, "\n%s\n", name);
+  fprintf(stderr, "%10s %10s %12s %10s\n", "batch", "clips", "clips/s", "RTF");
+
+  for (int32_t batch_size = 1; batch_size <= max_batch_size;
+       batch_size *= 2) {
+    std::vector<std::unique_ptr<sherpa_onnx::OfflineStream>> streams;
+    std::vector<sherpa_onnx::OfflineStream *> ss;
+    float duration = 0;
+
+    for (int32_t i = 0; i != num_clips; ++i) {
+      const auto &w = waves[i % waves.size()];
+      auto s = create_stream();
+      s->AcceptWaveform(w.sampling_rate, w.samples.data(), w.samples.size());
+      duration += w.samples.size() / static_cast<float>(w.sampling_rate);
+
+      ss.push_back(s.get());
+      streams.push_back(std::move(s));
+    }
+
+    // warm up so that memory allocation of the first run is not counted
+    compute(ss.data(), std::min(batch_size, num_clips));
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < num_clips; i += batch_size) {
+      compute(ss.data() + i, std::min(batch_size, num_clips - i));
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    float elapsed_seconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+            .count() /
+        1e6;
+
+    fprintf(stderr, "%10d %10d %12.2f %10.4f\n", batch_size, num_clips,
+            num_clips / elapsed_seconds, elapsed_seconds / duration);
+  }
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Measure the throughput of batched audio tagging and spoken language
+identification for batch sizes 1, 2, 4, ..., --max-batch-size.
+
+Usage:
+
+./bin/sherpa-onnx-offline-batch-classification-benchmark \
+  --tagging.zipformer-model=./sherpa-onnx-zipformer-audio-tagging-2024-04-09/model.onnx \
+  --tagging.labels=./sherpa-onnx-zipformer-audio-tagging-2024-04-09/class_labels_indices.csv \
+  --slid.whisper-encoder=./sherpa-onnx-whisper-tiny/tiny-encoder.int8.onnx \
+  --slid.whisper-decoder=./sherpa-onnx-whisper-tiny/tiny-decoder.int8.onnx \
+  --num-clips=64 \
+  --max-batch-size=32 \
+  ./sherpa-onnx-zipformer-audio-tagging-2024-04-09/test_wavs/*.wav
+
+Either of the two models can be omitted. Wave files are reused in a round
+robin fashion until --num-clips clips are available.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  sherpa_onnx::AudioTaggingConfig tagging_config;
+  sherpa_onnx::ParseOptions po_tagging("tagging", &po);
+  tagging_config.Register(&po_tagging);
+
+  sherpa_onnx::SpokenLanguageIdentificationConfig slid_config;
+  sherpa_onnx::ParseOptions po_slid("slid", &po);
+  slid_config.Register(&po_slid);
+
+  int32_t num_clips = 64;
+  int32_t max_batch_size = 32;
+  po.Register("num-clips", &num_clips,
+              "Number of clips to process for each batch size");
+  po.Register("max-batch-size", &max_batch_size, "Largest batch size to test");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() < 1) {
+    fprintf(stderr, "\nError: Please provide at least 1 wave file\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  bool has_tagging = !tagging_config.model.zipformer.model.empty() ||
+                     !tagging_config.model.ced.empty();
+  bool has_slid = !slid_config.whisper.encoder.empty();
+
+  if (!has_tagging && !has_slid) {
+    fprintf(stderr, "Please provide an audio tagging or a whisper model\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (num_clips < 1 || max_batch_size < 1) {
+    fprintf(stderr, "--num-clips and --max-batch-size must be positive\n");
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<Wave> waves;
+  for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+    std::string wav_filename = po.GetArg(i);
+
+    Wave w;
+    bool is_ok = false;
+    w.samples = sherpa_onnx::ReadWave(wav_filename, &w.sampling_rate, &is_ok);
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
+      return -1;
+    }
+
+    waves.push_back(std::move(w));
+  }
+
+  if (has_tagging) {
+    fprintf(stderr, "%s\n", tagging_config.ToString().c_str());
+    if (!tagging_config.Validate()) {
+      fprintf(stderr, "Errors in the audio tagging config!\n");
+      return -1;
+    }
+
+    sherpa_onnx::AudioTagging tagger(tagging_config);
+    Benchmark(
+        "Audio tagging", waves, num_clips, max_batch_size,
+        [&tagger]() { return tagger.CreateStream(); },
+        [&tagger](sherpa_onnx::OfflineStream **ss, int32_t n) {
+          tagger.ComputeBatch(ss, n);
+        });
+  }
+
+  if (has_slid) {
+    fprintf(stderr, "%s\n", slid_config.ToString().c_str());
+    if (!slid_config.Validate()) {
+      fprintf(stderr, "Errors in the spoken language identification config!\n");
+      return -1;
+    }
+
+    sherpa_onnx::SpokenLanguageIdentification slid(slid_config);
+    Benchmark(
+        "Spoken language identification", waves, num_clips, max_batch_size,
+        [&slid]() { return slid.CreateStream(); },
+        [&slid](sherpa_onnx::OfflineStream **ss, int32_t n) {
+          slid.ComputeBatch(ss, n);
+        });
+  }
+
+  return 0;
+}
@@ -0,0 +1,133 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-ctc-fst-decoder-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Throughput of OfflineCtcFstDecoder for a batch of random log-probs
+// decoded with 1, 2, 4 and 8 threads.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>  // NOLINT
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-ctc-fst-decoder-config.h"
+#include "sherpa-onnx/csrc/offline-ctc-fst-decoder.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace {
+
+// Return the number of utterances per second
+float Run(const sherpa_onnx::OfflineCtcFstDecoderConfig &config,
+          std::vector<float> *log_probs, std::vector<int64_t> *lengths,
+          int32_t num_frames, int32_t vocab_size, int32_t num_runs) {
+  sherpa_onnx::OfflineCtcFstDecoder decoder(config);
+
+  auto memory_info =
+      Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  std::array<int64_t, 3> shape{static_cast<int64_t>(lengths->size()),
+                               num_frames, vocab_size};
+  std::array<int64_t, 1> length_shape{static_cast<int64_t>(lengths->size())};
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (int32_t i = 0; i != num_runs; ++i) {
+    Ort::Value x = Ort::Value::CreateTensor(memory_info, log_probs->data(),
+                                            log_probs->size(), shape.data(),
+                                            shape.size());
+
+    Ort::Value x_lens =
+        Ort::Value::CreateTensor(memory_info, lengths->data(), lengths->size(),
+                                 length_shape.data(), length_shape.size());
+
+    decoder.Decode(std::move(x), std::move(x_lens));
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count() /
+      1e6;
+
+  return num_runs * lengths->size() / std::max(elapsed_seconds, 1e-6f);
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Measure the throughput of decoding a batch with an HLG graph when
+utterances of the batch are decoded in parallel. The log-probs are random,
+so the numbers show the cost of the search and not the accuracy.
+
+Usage:
+
+./bin/sherpa-onnx-offline-ctc-fst-decoder-benchmark \
+  --ctc-graph=./HLG.fst \
+  --vocab-size=500 \
+  --batch-size=16 \
+  --num-frames=200
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineCtcFstDecoderConfig config;
+  config.Register(&po);
+
+  int32_t vocab_size = 500;
+  int32_t batch_size = 16;
+  int32_t num_frames = 200;
+  int32_t num_runs = 5;
+
+  po.Register("vocab-size", &vocab_size,
+              "Number of tokens, i.e., the last dimension of the log-probs");
+  po.Register("batch-size", &batch_size, "Number of utterances in a batch");
+  po.Register("num-frames", &num_frames,
+              "Number of frames of the longest utterance");
+  po.Register("num-runs", &num_runs,
+              "Number of times the batch is decoded for each setting");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 0 || config.graph.empty()) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate() || vocab_size < 1 || batch_size < 1 ||
+      num_frames < 1 || num_runs < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  std::mt19937 gen(20250108);
+  std::uniform_real_distribution<float> dist(-10, 0);
+
+  std::vector<float> log_probs(batch_size * num_frames * vocab_size);
+  for (auto &f : log_probs) {
+    f = dist(gen);
+  }
+
+  // Utterances of a batch differ in length
+  std::vector<int64_t> lengths(batch_size);
+  for (int32_t i = 0; i != batch_size; ++i) {
+    lengths[i] = std::max(num_frames - i * num_frames / (2 * batch_size), 1);
+  }
+
+  for (int32_t num_threads : {1, 2, 4, 8}) {
+    config.num_threads = num_threads;
+    fprintf(stderr, "mmap: %d, threads: %d, utterances/s: %.1f\n",
+            config.use_mmap, num_threads,
+            Run(config, &log_probs, &lengths, num_frames, vocab_size,
+                num_runs));
+  }
+
+  return 0;
+}
@@ -4,130 +4,409 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 
-std::atomic<int> wav_index(0);
-std::mutex mtx;
+// The files are processed by a pipeline of 4 stages:
+//
+//  (1) Readers read and decode wave files into streams. They stop
+//      reading when enough files are waiting to be decoded.
+//  (2) The batcher sorts loaded files by duration and groups files of
+//      similar lengths into batches to reduce padding.
+//  (3) Decoders run DecodeStreams(). Each decoder has its own queue of
+//      batches and steals batches from the other queues when its own
+//      queue is empty.
+//  (4) The writer prints results in the order of the input files.
+
+struct Utterance {
+  // Index in the input list
+  int32_t index = 0;
+
+  std::string id;
+  std::string path;
+  float duration = 0;
+
+  // nullptr if the file cannot be read
+  std::unique_ptr<sherpa_onnx::OfflineStream> stream;
+};
+
+using Batch = std::vector<std::unique_ptr<Utterance>>;
+
+static int64_t NowInMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Accumulates the time a stage spends on doing work
+class BusyTimer {
+ public:
+  explicit BusyTimer(std::atomic<int64_t> *busy)
+      : busy_(busy), start_(NowInMicroseconds()) {}
+
+  ~BusyTimer() { *busy_ += NowInMicroseconds() - start_; }
+
+ private:
+  std::atomic<int64_t> *busy_;
+  int64_t start_;
+};
+
+struct Stats {
+  std::atomic<int64_t> read_busy{0};
+  std::atomic<int64_t> batch_busy{0};
+  std::atomic<int64_t> decode_busy{0};
+  std::atomic<int64_t> write_busy{0};
+
+  // The following are accessed only by the batcher
+  int32_t num_batches = 0;
+  int32_t num_batched_files = 0;
+  double padded_seconds = 0;
+  double batched_seconds = 0;
+
+  std::atomic<int32_t> num_stolen_batches{0};
+};
+
+// A FIFO queue. Push() blocks while the queue is full and Pop() blocks
+// while it is empty. A capacity of 0 means unbounded.
+template <typename T>
+class BlockingQueue {
+ public:
+  explicit BlockingQueue(int32_t capacity = 0) : capacity_(capacity) {}
+
+  void Push(T v) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] {
+      return capacity_ <= 0 || static_cast<int32_t>(q_.size()) < capacity_;
+    });
+
+    q_.push_back(std::move(v));
+    not_empty_.notify_one();
+  }
+
+  // Return false if the queue is closed and empty
+  bool Pop(T *v) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return closed_ || !q_.empty(); });
+
+    if (q_.empty()) {
+      return false;
+    }
 
-std::vector<std::vector<std::string>> SplitToBatches(
-    const std::vector<std::string> &input, int32_t batch_size) {
-  std::vector<std::vector<std::string>> outputs;
-  auto itr = input.cbegin();
-  int32_t process_num = 0;
+    *v = std::move(q_.front());
+    q_.pop_front();
+    not_full_.notify_one();
 
-  while (process_num + batch_size <= static_cast<int32_t>(input.size())) {
-    auto chunk_end = itr + batch_size;
-    outputs.emplace_back(itr, chunk_end);
-    itr = chunk_end;
-    process_num += batch_size;
+    return true;
   }
-  if (itr != input.cend()) {
-    outputs.emplace_back(itr, input.cend());
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
   }
-  return outputs;
-}
 
-std::vector<std::string> LoadScpFile(const std::string &wav_scp_path) {
-  std::vector<std::string> wav_paths;
+ private:
+  int32_t capacity_;
+  bool closed_ = false;
+  std::deque<T> q_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+// Each decoder owns a queue. New batches are distributed round-robin.
+// A decoder takes batches from the front of its own queue and, if it is
+// empty, steals from the back of the longest queue of the others.
+// Push() blocks while max_batches batches are waiting to be decoded.
+class BatchScheduler {
+ public:
+  BatchScheduler(int32_t num_workers, int32_t max_batches)
+      : queues_(num_workers), max_batches_(max_batches) {}
+
+  void Push(Batch batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return num_batches_ < max_batches_; });
+
+    queues_[next_].push_back(std::move(batch));
+    next_ = (next_ + 1) % queues_.size();
+    num_batches_ += 1;
+
+    cv_.notify_all();
+  }
+
+  // Return false if there are no batches left and Close() is called
+  bool Pop(int32_t worker, Batch *batch, bool *stolen) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+      auto &own = queues_[worker];
+      if (!own.empty()) {
+        *batch = std::move(own.front());
+        own.pop_front();
+        *stolen = false;
+        break;
+      }
+
+      auto victim = std::max_element(
+          queues_.begin(), queues_.end(),
+          [](const auto &a, const auto &b) { return a.size() < b.size(); });
+
+      if (!victim->empty()) {
+        *batch = std::move(victim->back());
+        victim->pop_back();
+        *stolen = true;
+        break;
+      }
+
+      if (closed_) {
+        return false;
+      }
+
+      cv_.wait(lock);
+    }
+
+    num_batches_ -= 1;
+    cv_.notify_all();
+
+    return true;
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  std::vector<std::deque<Batch>> queues_;
+  int32_t max_batches_;
+  int32_t num_batches_ = 0;
+  int32_t next_ = 0;
+  bool closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+// Each line of a kaldi style wav.scp contains "wav-id wav-path"
+static void LoadScpFile(const std::string &wav_scp_path,
+                        std::vector<std::string> *ids,
+                        std::vector<std::string> *wav_paths) {
   std::ifstream in(wav_scp_path);
   if (!in.is_open()) {
     fprintf(stderr, "Failed to open file: %s.\n", wav_scp_path.c_str());
-    return wav_paths;
+    return;
   }
+
   std::string line, column1, column2;
   while (std::getline(in, line)) {
     std::istringstream iss(line);
-    iss >> column1 >> column2;
-    wav_paths.emplace_back(std::move(column2));
+    if (!(iss >> column1 >> column2)) {
+      continue;
+    }
+    ids->push_back(std::move(column1));
+    wav_paths->push_back(std::move(column2));
   }
-
-  return wav_paths;
 }
 
-void AsrInference(const std::vector<std::vector<std::string>> &chunk_wav_paths,
-                  sherpa_onnx::OfflineRecognizer *recognizer,
-                  float *total_length, float *total_time) {
-  std::vector<std::unique_ptr<sherpa_onnx::OfflineStream>> ss;
-  std::vector<sherpa_onnx::OfflineStream *> ss_pointers;
-  float duration = 0.0f;
-  float elapsed_seconds_batch = 0.0f;
-
-  // warm up
-  for (const auto &wav_filename : chunk_wav_paths[0]) {
-    int32_t sampling_rate = -1;
-    bool is_ok = false;
-    const std::vector<float> samples =
-        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-    if (!is_ok) {
-      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
-      continue;
-    }
-    duration += samples.size() / static_cast<float>(sampling_rate);
-    auto s = recognizer->CreateStream();
-    s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
+static void ReadFiles(const sherpa_onnx::OfflineRecognizer &recognizer,
+                      const std::vector<std::string> &ids,
+                      const std::vector<std::string> &wav_paths,
+                      std::atomic<int32_t> *next_file,
+                      BlockingQueue<std::unique_ptr<Utterance>> *loaded,
+                      BlockingQueue<std::unique_ptr<Utterance>> *results,
+                      Stats *stats) {
+  int32_t num_files = wav_paths.size();
 
-    ss.push_back(std::move(s));
-    ss_pointers.push_back(ss.back().get());
-  }
-  recognizer->DecodeStreams(ss_pointers.data(), ss_pointers.size());
-  ss_pointers.clear();
-  ss.clear();
+  for (int32_t i = (*next_file)++; i < num_files; i = (*next_file)++) {
+    auto u = std::make_unique<Utterance>();
+    u->index = i;
+    u->id = ids[i];
+    u->path = wav_paths[i];
+
+    {
+      BusyTimer timer(&stats->read_busy);
 
-  while (true) {
-    int chunk = wav_index.fetch_add(1);
-    if (chunk >= static_cast<int32_t>(chunk_wav_paths.size())) {
-      break;
-    }
-    const auto &wav_paths = chunk_wav_paths[chunk];
-    const auto begin = std::chrono::steady_clock::now();
-    for (const auto &wav_filename : wav_paths) {
       int32_t sampling_rate = -1;
       bool is_ok = false;
       const std::vector<float> samples =
-          sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-      if (!is_ok) {
-        fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
-        continue;
+          sherpa_onnx::ReadWave(u->path, &sampling_rate, &is_ok);
+
+      if (is_ok) {
+        u->duration = samples.size() / static_cast<float>(sampling_rate);
+        u->stream = recognizer.CreateStream();
+        u->stream->AcceptWaveform(sampling_rate, samples.data(),
+                                  samples.size());
+      } else {
+        fprintf(stderr, "Failed to read '%s'\n", u->path.c_str());
       }
-      duration += samples.size() / static_cast<float>(sampling_rate);
-      auto s = recognizer->CreateStream();
-      s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
+    }
+
+    if (u->stream) {
+      // It blocks if too many files are waiting to be decoded
+      loaded->Push(std::move(u));
+    } else {
+      results->Push(std::move(u));
+    }
+  }
+}
+
+// Sort pending files by duration in descending order and move the
+// longest ones into a batch. A batch contains at most batch_size files
+// and, if max_batch_seconds > 0, at most max_batch_seconds of padded
+// audio.
+static Batch TakeBatch(std::vector<std::unique_ptr<Utterance>> *pending,
+                       bool sort_by_length, int32_t batch_size,
+                       float max_batch_seconds, Stats *stats) {
+  if (sort_by_length) {
+    std::stable_sort(pending->begin(), pending->end(),
+                     [](const auto &a, const auto &b) {
+                       return a->duration > b->duration;
+                     });
+  } else {
+    std::stable_sort(
+        pending->begin(), pending->end(),
+        [](const auto &a, const auto &b) { return a->index < b->index; });
+  }
+
+  float longest = (*pending)[0]->duration;
+
+  int32_t n = 1;
+  while (n < static_cast<int32_t>(pending->size()) && n < batch_size) {
+    float d = std::max(longest, (*pending)[n]->duration);
+    if (max_batch_seconds > 0 && d * (n + 1) > max_batch_seconds) {
+      break;
+    }
+    longest = d;
+    ++n;
+  }
+
+  Batch batch;
+  batch.reserve(n);
+  for (int32_t i = 0; i != n; ++i) {
+    stats->batched_seconds += (*pending)[i]->duration;
+    batch.push_back(std::move((*pending)[i]));
+  }
+  pending->erase(pending->begin(), pending->begin() + n);
+
+  stats->num_batches += 1;
+  stats->num_batched_files += n;
+  stats->padded_seconds += longest * n;
+
+  return batch;
+}
 
-      ss.push_back(std::move(s));
-      ss_pointers.push_back(ss.back().get());
+static void MakeBatches(BlockingQueue<std::unique_ptr<Utterance>> *loaded,
+                        BatchScheduler *scheduler, int32_t prefetch,
+                        bool sort_by_length, int32_t batch_size,
+                        float max_batch_seconds, Stats *stats) {
+  std::vector<std::unique_ptr<Utterance>> pending;
+
+  std::unique_ptr<Utterance> u;
+  while (loaded->Pop(&u)) {
+    pending.push_back(std::move(u));
+
+    // Wait for more files so that there are files of similar lengths
+    // to choose from
+    if (static_cast<int32_t>(pending.size()) < prefetch) {
+      continue;
     }
-    recognizer->DecodeStreams(ss_pointers.data(), ss_pointers.size());
-    const auto end = std::chrono::steady_clock::now();
-    float elapsed_seconds =
-        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
-            .count() /
-        1000.;
-    elapsed_seconds_batch += elapsed_seconds;
-    int i = 0;
-    for (const auto &wav_filename : wav_paths) {
-      fprintf(stderr, "%s\n%s\n----\n", wav_filename.c_str(),
-              ss[i]->GetResult().AsJsonString().c_str());
-      i = i + 1;
+
+    Batch batch;
+    {
+      BusyTimer timer(&stats->batch_busy);
+      batch = TakeBatch(&pending, sort_by_length, batch_size,
+                        max_batch_seconds, stats);
+    }
+
+    // It blocks if the decoders are busy
+    scheduler->Push(std::move(batch));
+  }
+
+  while (!pending.empty()) {
+    Batch batch;
+    {
+      BusyTimer timer(&stats->batch_busy);
+      batch = TakeBatch(&pending, sort_by_length, batch_size,
+                        max_batch_seconds, stats);
     }
-    ss_pointers.clear();
+    scheduler->Push(std::move(batch));
+  }
+
+  scheduler->Close();
+}
+
+static void DecodeBatches(sherpa_onnx::OfflineRecognizer *recognizer,
+                          int32_t worker, BatchScheduler *scheduler,
+                          BlockingQueue<std::unique_ptr<Utterance>> *results,
+                          Stats *stats) {
+  Batch batch;
+  bool stolen = false;
+  std::vector<sherpa_onnx::OfflineStream *> ss;
+
+  while (scheduler->Pop(worker, &batch, &stolen)) {
+    stats->num_stolen_batches += stolen;
+
     ss.clear();
+    for (const auto &u : batch) {
+      ss.push_back(u->stream.get());
+    }
+
+    {
+      BusyTimer timer(&stats->decode_busy);
+      recognizer->DecodeStreams(ss.data(), ss.size());
+    }
+
+    for (auto &u : batch) {
+      results->Push(std::move(u));
+    }
   }
+}
 
-  {
-    std::lock_guard<std::mutex> guard(mtx);
-    *total_length += duration;
-    if (*total_time < elapsed_seconds_batch) {
-      *total_time = elapsed_seconds_batch;
+// Results are printed in the order of the input files. If os is not
+// nullptr, "wav-id text" is written to it for each file.
+static void WriteResults(BlockingQueue<std::unique_ptr<Utterance>> *results,
+                         std::ostream *os, Stats *stats) {
+  std::map<int32_t, std::unique_ptr<Utterance>> pending;
+  int32_t next = 0;
+
+  std::unique_ptr<Utterance> u;
+  while (results->Pop(&u)) {
+    BusyTimer timer(&stats->write_busy);
+
+    int32_t index = u->index;
+    pending[index] = std::move(u);
+
+    while (!pending.empty() && pending.begin()->first == next) {
+      const auto &r = pending.begin()->second;
+      if (r->stream) {
+        auto result = r->stream->GetResult();
+        if (os) {
+          *os << r->id << " " << result.text << "\n";
+        } else {
+          fprintf(stderr, "%s\n%s\n----\n", r->path.c_str(),
+                  result.AsJsonString().c_str());
+        }
+      }
+
+      pending.erase(pending.begin());
+      ++next;
     }
   }
 }
@@ -212,7 +491,13 @@ See https://k2-fsa.github.io/sherpa/onnx/pretrained_models/offline-ctc/yesno/ind
     ./sherpa-onnx-tdnn-yesno/test_wavs/0_0_0_1_0_0_0_1.wav \
     ./sherpa-onnx-tdnn-yesno/test_wavs/0_0_1_0_0_0_1_0.wav
 
-Note: It supports decoding multiple files in batches
+Files are read by --io-threads threads and decoded by --nj threads in
+batches of at most --batch-size files. Loaded files are sorted by
+duration so that files in a batch have similar lengths. Results are
+printed in the order of the input files, or saved to --output as
+"wav-id text" lines. Statistics of each stage of the pipeline are printed
+at the end, so this program can be used to benchmark the throughput of
+non-streaming models.
 
 foo.wav should be of single channel, 16-bit PCM encoded wave file; its
 sampling rate can be arbitrary and does not need to be 16kHz.
@@ -224,6 +509,12 @@ for a list of pre-trained models to download.
   std::string wav_scp = "";  // file path, kaldi style wav list.
   int32_t nj = 1;            // thread number
   int32_t batch_size = 1;    // number of wav files processed at once.
+  int32_t io_threads = 2;
+  int32_t prefetch = 0;
+  float max_batch_seconds = 0;
+  bool sort_by_length = true;
+  std::string output;
+
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::OfflineRecognizerConfig config;
   config.Register(&po);
@@ -236,6 +527,21 @@ for a list of pre-trained models to download.
   po.Register("batch-size", &batch_size,
               "number of wav files processed at once during the decoding"
               "process. default=1");
+  po.Register("io-threads", &io_threads,
+              "Number of threads to read wave files. default=2");
+  po.Register("prefetch", &prefetch,
+              "Number of loaded files to sort by length before forming a "
+              "batch. It also limits the number of files read ahead of the "
+              "decoders. If it is 0, 4 * batch-size * nj is used");
+  po.Register("max-batch-seconds", &max_batch_seconds,
+              "If positive, the padded duration of a batch, i.e., batch size "
+              "times the duration of its longest file, does not exceed it");
+  po.Register("sort-by-length", &sort_by_length,
+              "true to group files of similar lengths into a batch. false to "
+              "form batches in the input order");
+  po.Register("output", &output,
+              "If not empty, write \"wav-id text\" for each file to it instead "
+              "of printing results");
 
   po.Read(argc, argv);
   if (po.NumArgs() < 1 && wav_scp.empty()) {
@@ -250,7 +556,17 @@ for a list of pre-trained models to download.
     fprintf(stderr, "Errors in config!\n");
     return -1;
   }
-  std::this_thread::sleep_for(std::chrono::seconds(10));  // sleep 10s
+
+  if (nj < 1 || batch_size < 1 || io_threads < 1) {
+    fprintf(stderr, "--nj, --batch-size and --io-threads should be >= 1\n");
+    return -1;
+  }
+
+  if (prefetch <= 0) {
+    prefetch = 4 * batch_size * nj;
+  }
+  prefetch = std::max(prefetch, batch_size);
+
   fprintf(stderr, "Creating recognizer ...\n");
   const auto begin = std::chrono::steady_clock::now();
   sherpa_onnx::OfflineRecognizer recognizer(config);
@@ -263,12 +579,14 @@ for a list of pre-trained models to download.
           "Started nj: %d, batch_size: %d, wav_path: %s. recognizer init time: "
           "%.6f\n",
           nj, batch_size, wav_scp.c_str(), elapsed_seconds);
-  std::this_thread::sleep_for(std::chrono::seconds(10));  // sleep 10s
+
+  std::vector<std::string> ids;
   std::vector<std::string> wav_paths;
   if (!wav_scp.empty()) {
-    wav_paths = LoadScpFile(wav_scp);
+    LoadScpFile(wav_scp, &ids, &wav_paths);
   } else {
     for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+      ids.emplace_back(po.GetArg(i));
       wav_paths.emplace_back(po.GetArg(i));
     }
   }
@@ -276,26 +594,103 @@ for a list of pre-trained models to download.
     fprintf(stderr, "wav files is empty.\n");
     return -1;
   }
-  std::vector<std::thread> threads;
-  std::vector<std::vector<std::string>> batch_wav_paths =
-      SplitToBatches(wav_paths, batch_size);
-  float total_length = 0.0f;
-  float total_time = 0.0f;
-  for (int i = 0; i < nj; i++) {
-    threads.emplace_back(std::thread(AsrInference, batch_wav_paths, &recognizer,
-                                     &total_length, &total_time));
+
+  std::ofstream os;
+  if (!output.empty()) {
+    os.open(output);
+    if (!os) {
+      fprintf(stderr, "Failed to open '%s'\n", output.c_str());
+      return -1;
+    }
+  }
+
+  Stats stats;
+
+  // Readers block once batch_size files are waiting for the batcher,
+  // which holds at most prefetch files and blocks once 2 batches per
+  // decoder are waiting to be decoded
+  BlockingQueue<std::unique_ptr<Utterance>> loaded(batch_size);
+  BlockingQueue<std::unique_ptr<Utterance>> results;
+  BatchScheduler scheduler(nj, 2 * nj);
+  std::atomic<int32_t> next_file{0};
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::thread writer(WriteResults, &results, output.empty() ? nullptr : &os,
+                     &stats);
+
+  std::vector<std::thread> decoders;
+  for (int32_t i = 0; i != nj; ++i) {
+    decoders.emplace_back(DecodeBatches, &recognizer, i, &scheduler,
+                          &results, &stats);
+  }
+
+  std::thread batcher(MakeBatches, &loaded, &scheduler, prefetch,
+                      sort_by_length, batch_size, max_batch_seconds, &stats);
+
+  std::vector<std::thread> readers;
+  for (int32_t i = 0; i != io_threads; ++i) {
+    readers.emplace_back(ReadFiles, std::cref(recognizer), std::cref(ids),
+                         std::cref(wav_paths), &next_file, &loaded, &results,
+                         &stats);
   }
 
-  for (auto &thread : threads) {
-    thread.join();
+  for (auto &t : readers) {
+    t.join();
   }
+  loaded.Close();
+
+  batcher.join();
+
+  for (auto &t : decoders) {
+    t.join();
+  }
+  results.Close();
+
+  writer.join();
+
+  const auto stop = std::chrono::steady_clock::now();
+
+  float total_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start)
+          .count() /
+      1000.;
+  float total_length = stats.batched_seconds;
+  int32_t num_files = wav_paths.size();
+  int32_t num_failed = num_files - stats.num_batched_files;
+
+  auto utilization = [total_time](const std::atomic<int64_t> &busy,
+                                  int32_t num_threads) {
+    return 100. * busy / 1e6 / std::max(total_time * num_threads, 1e-6f);
+  };
 
   fprintf(stderr, "num threads: %d\n", config.model_config.num_threads);
   fprintf(stderr, "decoding method: %s\n", config.decoding_method.c_str());
   if (config.decoding_method == "modified_beam_search") {
     fprintf(stderr, "max active paths: %d\n", config.max_active_paths);
   }
+
+  fprintf(stderr, "Files: %d (failed: %d), audio: %.3f s\n", num_files,
+          num_failed, total_length);
+  fprintf(stderr,
+          "Batches: %d, average batch size: %.2f, padding: %.2f%%, "
+          "stolen: %d\n",
+          stats.num_batches,
+          static_cast<float>(stats.num_batched_files) /
+              std::max(stats.num_batches, 1),
+          100. * (stats.padded_seconds - stats.batched_seconds) /
+              std::max(stats.padded_seconds, 1e-6),
+          stats.num_stolen_batches.load());
+  fprintf(stderr,
+          "Utilization: read %.1f%% (%d threads), batch %.1f%%, "
+          "decode %.1f%% (%d threads), write %.1f%%\n",
+          utilization(stats.read_busy, io_threads), io_threads,
+          utilization(stats.batch_busy, 1),
+          utilization(stats.decode_busy, nj), nj,
+          utilization(stats.write_busy, 1));
+
   fprintf(stderr, "Elapsed seconds: %.3f s\n", total_time);
+  fprintf(stderr, "Files per second: %.3f\n", num_files / total_time);
   float rtf = total_time / total_length;
   fprintf(stderr, "Real time factor (RTF): %.6f / %.6f = %.4f\n", total_time,
           total_length, rtf);
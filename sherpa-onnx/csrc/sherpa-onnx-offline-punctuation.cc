@@ -3,7 +3,11 @@
 // Copyright (c)  2022-2024  Xiaomi Corporation
 #include <stdio.h>
 
+#include <algorithm>
 #include <chrono>  // NOLINT
+#include <fstream>
+#include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/offline-punctuation.h"
 #include "sherpa-onnx/csrc/parse-options.h"
@@ -25,13 +29,41 @@ rm sherpa-onnx-punct-ct-transformer-zh-en-vocab272727-2024-04-12.tar.bz2
   "你好吗how are you Fantasitic 谢谢我很好你怎么样呢"
 
 The output text should look like below:
+
+To benchmark the throughput, put one text per line in a file and use
+
+./bin/sherpa-onnx-offline-punctuation \
+  --ct-transformer=./sherpa-onnx-punct-ct-transformer-zh-en-vocab272727-2024-04-12/model.onnx \
+  --input-file=./texts.txt \
+  --batch-size=32
+
+--batch-size=1 calls AddPunctuation() for each text, while a larger value
+calls AddPunctuationBatch() with that many texts at a time.
 )usage";
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::OfflinePunctuationConfig config;
   config.Register(&po);
+
+  std::string input_file;
+  int32_t batch_size = 1;
+  po.Register("input-file", &input_file,
+              "If not empty, read texts from this file, one text per line, "
+              "and report the throughput. No positional argument is "
+              "expected in this case.");
+  po.Register("batch-size", &batch_size,
+              "Number of texts to process together. Used only when "
+              "--input-file is given.");
+
   po.Read(argc, argv);
-  if (po.NumArgs() != 1) {
+
+  if (!input_file.empty()) {
+    if (po.NumArgs() != 0) {
+      fprintf(stderr, "Please don't give positional arguments\n");
+      po.PrintUsage();
+      exit(EXIT_FAILURE);
+    }
+  } else if (po.NumArgs() != 1) {
     fprintf(stderr,
             "Error: Please provide only 1 position argument containing the "
             "input text.\n\n");
@@ -48,6 +80,70 @@ The output text should look like below:
 
   fprintf(stderr, "Creating OfflinePunctuation ...\n");
   sherpa_onnx::OfflinePunctuation punct(config);
+  if (!input_file.empty()) {
+    std::ifstream is(input_file);
+    if (!is) {
+      fprintf(stderr, "Failed to open '%s'\n", input_file.c_str());
+      exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::string> texts;
+    std::string line;
+    int64_t num_bytes = 0;
+    while (std::getline(is, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      num_bytes += line.size();
+      texts.push_back(std::move(line));
+    }
+
+    batch_size = std::max(batch_size, 1);
+
+    fprintf(stderr, "Started\n");
+    const auto begin = std::chrono::steady_clock::now();
+
+    std::vector<std::string> results;
+    results.reserve(texts.size());
+
+    if (batch_size == 1) {
+      for (const auto &t : texts) {
+        results.push_back(punct.AddPunctuation(t));
+      }
+    } else {
+      for (size_t i = 0; i < texts.size(); i += batch_size) {
+        size_t end = std::min(texts.size(), i + batch_size);
+        std::vector<std::string> batch(texts.begin() + i, texts.begin() + end);
+        auto r = punct.AddPunctuationBatch(batch);
+        results.insert(results.end(), r.begin(), r.end());
+      }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    float elapsed_seconds =
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+            .count() /
+        1000.;
+
+    for (const auto &r : results) {
+      fprintf(stdout, "%s\n", r.c_str());
+    }
+
+    fprintf(stderr, "Num threads: %d\n", config.model.num_threads);
+    fprintf(stderr, "Batch size: %d\n", batch_size);
+    fprintf(stderr, "Num texts: %d\n", static_cast<int32_t>(texts.size()));
+    fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+    if (elapsed_seconds > 0) {
+      fprintf(stderr, "Texts per second: %.2f\n",
+              texts.size() / elapsed_seconds);
+      fprintf(stderr, "Bytes per second: %.2f\n",
+              num_bytes / elapsed_seconds);
+    }
+
+    return 0;
+  }
+
   fprintf(stderr, "Started\n");
   const auto begin = std::chrono::steady_clock::now();
 
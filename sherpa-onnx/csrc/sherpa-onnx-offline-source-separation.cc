@@ -7,6 +7,7 @@
 #include <string>
 
 #include "sherpa-onnx/csrc/offline-source-separation.h"
+#include "sherpa-onnx/csrc/telephony-encoder.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
 
@@ -44,6 +45,21 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/source-separation-m
   --input-wav=audio_example.wav \
   --output-vocals-wav=output_vocals.wav \
   --output-accompaniment-wav=output_accompaniment.wav
+
+(3) Long audio
+
+Pass --chunk-size to split the input into segments of that many seconds.
+Segments are processed independently, --num-chunk-workers at a time, and
+stitched with a windowed overlap-add of --chunk-overlap seconds:
+
+./bin/sherpa-onnx-offline-source-separation \
+  --uvr-model=./UVR_MDXNET_1_9703.onnx \
+  --chunk-size=30 \
+  --chunk-overlap=1 \
+  --num-chunk-workers=4 \
+  --input-wav=audio_example.wav \
+  --output-vocals-wav=output_vocals.wav \
+  --output-accompaniment-wav=output_accompaniment.wav
 )usage";
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
@@ -104,8 +120,41 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/source-separation-m
 
   sherpa_onnx::OfflineSourceSeparation sp(config);
 
+  // The separated audio is written as soon as it is ready, so that long
+  // inputs processed with --chunk-size are never held in memory
+  sherpa_onnx::WaveWriter vocals_writer;
+  sherpa_onnx::WaveWriter accompaniment_writer;
+
+  auto write = [](sherpa_onnx::WaveWriter *writer, const std::string &filename,
+                  int32_t sample_rate,
+                  const sherpa_onnx::MultiChannelSamples &stem) -> bool {
+    if (!writer->IsOpen() &&
+        !writer->Open(filename, sample_rate,
+                      sherpa_onnx::AudioEncoding::kPcm16,
+                      stem.data.size() > 1 ? 2 : 1)) {
+      return false;
+    }
+
+    int32_t n = stem.data[0].size();
+    if (stem.data.size() > 1) {
+      return writer->Write(stem.data[0].data(), stem.data[1].data(), n);
+    }
+
+    return writer->Write(stem.data[0].data(), n);
+  };
+
+  is_ok = true;
+  auto callback = [&](const sherpa_onnx::OfflineSourceSeparationOutput &output,
+                      float /*progress*/) -> int32_t {
+    is_ok = write(&vocals_writer, output_vocals_wave, output.sample_rate,
+                  output.stems[0]) &&
+            write(&accompaniment_writer, output_accompaniment_wave,
+                  output.sample_rate, output.stems[1]);
+    return is_ok;
+  };
+
   const auto begin = std::chrono::steady_clock::now();
-  auto output = sp.Process(input);
+  sp.Process(input, callback);
   const auto end = std::chrono::steady_clock::now();
 
   float elapsed_seconds =
@@ -113,23 +162,9 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/source-separation-m
           .count() /
       1000.;
 
-  is_ok = sherpa_onnx::WriteWave(
-      output_vocals_wave, output.sample_rate, output.stems[0].data[0].data(),
-      output.stems[0].data[1].data(), output.stems[0].data[0].size());
-
-  if (!is_ok) {
-    fprintf(stderr, "Failed to write to '%s'\n", output_vocals_wave.c_str());
-    exit(EXIT_FAILURE);
-  }
-
-  is_ok = sherpa_onnx::WriteWave(output_accompaniment_wave, output.sample_rate,
-                                 output.stems[1].data[0].data(),
-                                 output.stems[1].data[1].data(),
-                                 output.stems[1].data[0].size());
-
-  if (!is_ok) {
-    fprintf(stderr, "Failed to write to '%s'\n",
-            output_accompaniment_wave.c_str());
+  if (!is_ok || !vocals_writer.Close() || !accompaniment_writer.Close()) {
+    fprintf(stderr, "Failed to write to '%s' and '%s'\n",
+            output_vocals_wave.c_str(), output_accompaniment_wave.c_str());
     exit(EXIT_FAILURE);
   }
 
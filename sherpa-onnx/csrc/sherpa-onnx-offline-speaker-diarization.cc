@@ -92,26 +92,24 @@ a smaller threshold leads to more clusters, i.e., more speakers
   std::cout << "Started\n";
   const auto begin = std::chrono::steady_clock::now();
   const std::string wav_filename = po.GetArg(1);
-  int32_t sample_rate = -1;
-  bool is_ok = false;
-  const std::vector<float> samples =
-      sherpa_onnx::ReadWave(wav_filename, &sample_rate, &is_ok);
-  if (!is_ok) {
+  // The file is memory mapped and decoded on demand
+  sherpa_onnx::StreamingWaveReader reader(wav_filename);
+  if (!reader.IsOk()) {
     std::cerr << "Failed to read " << wav_filename.c_str() << "\n";
     return -1;
   }
 
+  int32_t sample_rate = reader.SampleRate();
   if (sample_rate != sd.SampleRate()) {
     std::cerr << "Expect sample rate " << sd.SampleRate()
               << ". Given: " << sample_rate << "\n";
     return -1;
   }
 
-  float duration = samples.size() / static_cast<float>(sample_rate);
+  float duration = reader.NumSamples() / static_cast<float>(sample_rate);
 
   auto result =
-      sd.Process(samples.data(), samples.size(), ProgressCallback, nullptr)
-          .SortByStartTime();
+      sd.Process(reader, ProgressCallback, nullptr).SortByStartTime();
 
   for (const auto &r : result) {
     std::cout << r.ToString() << "\n";
@@ -0,0 +1,243 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-cancellation-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Wasted work when clients disconnect in the middle of a request.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace {
+
+double Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+             .count() /
+         1e6;
+}
+
+struct ClientResult {
+  double end = 0;  // when Generate() returns
+  // From the disconnect to the return of Generate(). 0 if the request
+  // finishes before the client disconnects
+  double release_seconds = 0;
+  // Audio passed to the callback after the client disconnects
+  int64_t wasted_samples = 0;
+  int32_t sample_rate = 0;
+};
+
+// The client disconnects disconnect_ms after the request starts. The
+// server notices it as follows:
+//
+//  - ignore: never. The request runs to the end
+//  - callback: the next callback returns 0
+//  - cancel: the cancellation token of the request is cancelled at once
+//  - deadline: the request has a timeout of disconnect_ms
+ClientResult RunClient(const sherpa_onnx::OfflineTts &tts,
+                       const std::string &text, int32_t sid,
+                       const std::string &mode, int32_t disconnect_ms) {
+  sherpa_onnx::OfflineTtsRequestOptions options;
+  options.cancellation =
+      std::make_shared<sherpa_onnx::OfflineTtsCancellationToken>();
+  if (mode == "deadline") {
+    options.SetTimeout(disconnect_ms);
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  std::atomic<bool> disconnected{false};
+  double disconnect_time = 0;
+
+  // It plays the role of the network thread of a server
+  std::thread network([&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (cv.wait_for(lock, std::chrono::milliseconds(disconnect_ms),
+                    [&done]() { return done; })) {
+      return;
+    }
+
+    disconnect_time = Now();
+    disconnected = true;
+    if (mode == "cancel") {
+      options.cancellation->Cancel();
+    }
+  });
+
+  ClientResult ans;
+  auto audio = tts.Generate(
+      text, sid, 1.0,
+      [&](const float * /*samples*/, int32_t n, float /*progress*/) -> int32_t {
+        if (!disconnected) {
+          return 1;
+        }
+
+        ans.wasted_samples += n;
+        return mode == "ignore" ? 1 : 0;
+      },
+      options);
+  ans.end = Now();
+  ans.sample_rate = audio.sample_rate;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  cv.notify_all();
+  network.join();
+
+  if (disconnected) {
+    ans.release_seconds = std::max(ans.end - disconnect_time, 0.0);
+  }
+
+  return ans;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Start --num-clients concurrent requests for the given document. Each
+client disconnects --disconnect-ms milliseconds after its request starts.
+For each of the given modes, print the wall time, the CPU time of the
+process, the mean time from the disconnect to the return of Generate() and
+the seconds of audio generated after the disconnect.
+
+  - ignore: the disconnect is not noticed and the request runs to the end
+  - callback: the next callback of the request returns 0
+  - cancel: the cancellation token of the request is cancelled at once
+  - deadline: the request has a deadline of --disconnect-ms
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-cancellation-benchmark \
+  --vits-model=./melo-tts-ko/model.onnx \
+  --vits-ja-bert-model=./melo-tts-ko/ja_bert.onnx \
+  --vits-vocab=./melo-tts-ko/vocab.txt \
+  --vits-lexicon=./melo-tts-ko/lexicon.txt \
+  --vits-tokens=./melo-tts-ko/tokens.txt \
+  --modes=ignore,callback,cancel,deadline \
+  --num-clients=4 \
+  --disconnect-ms=500 \
+  ./document-ko.txt
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineTtsConfig config;
+  config.Register(&po);
+
+  std::string modes = "ignore,callback,cancel,deadline";
+  int32_t num_clients = 4;
+  int32_t disconnect_ms = 500;
+  int32_t sid = 0;
+
+  po.Register("modes", &modes,
+              "Comma separated modes. Valid values: ignore, callback, cancel, "
+              "deadline");
+  po.Register("num-clients", &num_clients, "Number of concurrent clients");
+  po.Register("disconnect-ms", &disconnect_ms,
+              "Each client disconnects this many milliseconds after its "
+              "request starts");
+  po.Register("sid", &sid, "Speaker ID");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "Error: Please provide a text file\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> names;
+  sherpa_onnx::SplitStringToVector(modes, ",", false, &names);
+
+  if (!config.Validate() || names.empty() || num_clients < 1 ||
+      disconnect_ms < 0) {
+    fprintf(stderr, "Errors in config!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (const auto &name : names) {
+    if (name != "ignore" && name != "callback" && name != "cancel" &&
+        name != "deadline") {
+      fprintf(stderr, "Invalid mode '%s'\n", name.c_str());
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  std::string text;
+  {
+    std::ifstream is(po.GetArg(1));
+    std::ostringstream os;
+    os << is.rdbuf();
+    text = os.str();
+  }
+
+  if (text.empty()) {
+    fprintf(stderr, "'%s' is empty\n", po.GetArg(1).c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  sherpa_onnx::SetLogLevel(SHERPA_ONNX_LOG_LEVEL_WARN);
+
+  sherpa_onnx::OfflineTts tts(config);
+
+  // warm up
+  tts.Generate(text, sid);
+
+  for (const auto &name : names) {
+    std::vector<ClientResult> results(num_clients);
+    std::vector<std::thread> clients;
+
+    std::clock_t cpu_start = std::clock();
+    double start = Now();
+    for (int32_t i = 0; i != num_clients; ++i) {
+      clients.emplace_back([&, i]() {
+        results[i] = RunClient(tts, text, sid, name, disconnect_ms);
+      });
+    }
+
+    for (auto &t : clients) {
+      t.join();
+    }
+    double cpu_seconds =
+        static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    double end = start;
+    double release_seconds = 0;
+    double wasted_seconds = 0;
+    for (const auto &r : results) {
+      end = std::max(end, r.end);
+      release_seconds += r.release_seconds;
+      if (r.sample_rate > 0) {
+        wasted_seconds += r.wasted_samples / static_cast<double>(r.sample_rate);
+      }
+    }
+
+    printf(
+        "%-8s wall %8.3f s, cpu %8.3f s, release %8.3f s, wasted audio "
+        "%8.3f s\n",
+        name.c_str(), end - start, cpu_seconds, release_seconds / num_clients,
+        wasted_seconds);
+  }
+
+  return 0;
+}
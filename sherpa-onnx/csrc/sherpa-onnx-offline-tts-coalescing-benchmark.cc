@@ -0,0 +1,199 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-coalescing-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// CPU saved by coalescing identical concurrent requests.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace {
+
+double Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+             .count() /
+         1e6;
+}
+
+struct ClientResult {
+  double ttfb = 0;     // from the start of the request to the first audio
+  double latency = 0;  // from the start of the request to the return
+  int32_t num_samples = 0;
+};
+
+struct BurstResult {
+  double wall_seconds = 0;
+  double cpu_seconds = 0;
+  double ttfb = 0;
+  double latency = 0;
+  bool identical = true;
+};
+
+// num_clients clients send the same request. Client i starts
+// i * burst_ms / num_clients milliseconds after the first one.
+BurstResult RunBurst(const sherpa_onnx::OfflineTts &tts,
+                     const std::string &text, int32_t sid, float speed,
+                     int32_t num_clients, int32_t burst_ms) {
+  std::vector<ClientResult> results(num_clients);
+  std::vector<std::thread> clients;
+
+  std::clock_t cpu_start = std::clock();
+  double start = Now();
+  for (int32_t i = 0; i != num_clients; ++i) {
+    clients.emplace_back([&, i]() {
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(1000LL * i * burst_ms / num_clients));
+
+      ClientResult &r = results[i];
+      double request_start = Now();
+      auto audio = tts.Generate(
+          text, sid, speed,
+          [&](const float * /*samples*/, int32_t /*n*/,
+              float /*progress*/) -> int32_t {
+            if (r.ttfb == 0) {
+              r.ttfb = Now() - request_start;
+            }
+            return 1;
+          });
+      r.latency = Now() - request_start;
+      r.num_samples = static_cast<int32_t>(audio.samples.size());
+    });
+  }
+
+  for (auto &t : clients) {
+    t.join();
+  }
+
+  BurstResult ans;
+  ans.wall_seconds = Now() - start;
+  ans.cpu_seconds =
+      static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  for (const auto &r : results) {
+    ans.ttfb += r.ttfb / num_clients;
+    ans.latency += r.latency / num_clients;
+    ans.identical = ans.identical && r.num_samples == results[0].num_samples;
+  }
+
+  return ans;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Simulate bursts of identical requests, e.g., the same notification sent to
+many sessions at once. Each burst has --num-clients requests with the same
+text, speaker ID and speed, started within --burst-ms milliseconds.
+
+The bursts run once without and once with --tts-coalesce-requests. For each,
+print the wall time, the CPU time of the process, the mean time to the first
+audio chunk and the mean latency of the requests.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-coalescing-benchmark \
+  --vits-model=./melo-tts-ko/model.onnx \
+  --vits-ja-bert-model=./melo-tts-ko/ja_bert.onnx \
+  --vits-vocab=./melo-tts-ko/vocab.txt \
+  --vits-lexicon=./melo-tts-ko/lexicon.txt \
+  --vits-tokens=./melo-tts-ko/tokens.txt \
+  --num-clients=16 \
+  --burst-ms=50 \
+  --num-bursts=3 \
+  ./notification-ko.txt
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineTtsConfig config;
+  config.Register(&po);
+
+  int32_t num_clients = 16;
+  int32_t burst_ms = 50;
+  int32_t num_bursts = 3;
+  int32_t sid = 0;
+  float speed = 1.0;
+
+  po.Register("num-clients", &num_clients,
+              "Number of identical requests in a burst");
+  po.Register("burst-ms", &burst_ms,
+              "Requests of a burst start within this many milliseconds");
+  po.Register("num-bursts", &num_bursts, "Number of bursts");
+  po.Register("sid", &sid, "Speaker ID");
+  po.Register("speed", &speed, "Speed of the generated speech");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "Error: Please provide a text file\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (!config.Validate() || num_clients < 1 || burst_ms < 0 ||
+      num_bursts < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  std::string text;
+  {
+    std::ifstream is(po.GetArg(1));
+    std::ostringstream os;
+    os << is.rdbuf();
+    text = os.str();
+  }
+
+  if (text.empty()) {
+    fprintf(stderr, "'%s' is empty\n", po.GetArg(1).c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  sherpa_onnx::SetLogLevel(SHERPA_ONNX_LOG_LEVEL_WARN);
+
+  double cpu_seconds[2] = {0, 0};
+  for (int32_t coalesce = 0; coalesce != 2; ++coalesce) {
+    // Only one model is loaded at a time
+    config.coalesce_requests = coalesce;
+    sherpa_onnx::OfflineTts tts(config);
+
+    // warm up
+    tts.Generate(text, sid, speed);
+
+    BurstResult total;
+    for (int32_t i = 0; i != num_bursts; ++i) {
+      BurstResult r = RunBurst(tts, text, sid, speed, num_clients, burst_ms);
+      total.wall_seconds += r.wall_seconds;
+      total.cpu_seconds += r.cpu_seconds;
+      total.ttfb += r.ttfb / num_bursts;
+      total.latency += r.latency / num_bursts;
+      total.identical = total.identical && r.identical;
+    }
+    cpu_seconds[coalesce] = total.cpu_seconds;
+
+    printf(
+        "%-12s wall %8.3f s, cpu %8.3f s, ttfb %8.3f s, latency %8.3f s%s\n",
+        coalesce ? "coalesced" : "independent", total.wall_seconds,
+        total.cpu_seconds, total.ttfb, total.latency,
+        total.identical ? "" : ", outputs differ in length");
+  }
+
+  if (cpu_seconds[0] > 0) {
+    printf("CPU saved: %.1f%%\n",
+           100 * (cpu_seconds[0] - cpu_seconds[1]) / cpu_seconds[0]);
+  }
+
+  return 0;
+}
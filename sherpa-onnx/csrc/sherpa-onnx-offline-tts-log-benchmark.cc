@@ -0,0 +1,152 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-log-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Latency of OfflineTts::Generate() at different runtime log levels.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace {
+
+struct LogLevel {
+  const char *name;
+  int value;
+};
+
+constexpr LogLevel kLogLevels[] = {
+    {"trace", SHERPA_ONNX_LOG_LEVEL_TRACE},
+    {"debug", SHERPA_ONNX_LOG_LEVEL_DEBUG},
+    {"info", SHERPA_ONNX_LOG_LEVEL_INFO},
+    {"warn", SHERPA_ONNX_LOG_LEVEL_WARN},
+    {"error", SHERPA_ONNX_LOG_LEVEL_ERROR},
+};
+
+// Return -1 if name is not a valid log level
+int ToLogLevel(const std::string &name) {
+  for (const auto &level : kLogLevels) {
+    if (name == level.name) {
+      return level.value;
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Generate the given text --num-runs times at each of the given runtime log
+levels and print the mean and the median latency of Generate() for each
+level. Messages below SHERPA_ONNX_MIN_LOG_LEVEL are removed at compile
+time and cost nothing at any runtime level.
+
+Log messages are written to stderr, so you may want to redirect stderr
+to /dev/null and read the results from stdout.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-log-benchmark \
+  --vits-model=./vits-melo-tts-zh_en/model.onnx \
+  --vits-lexicon=./vits-melo-tts-zh_en/lexicon.txt \
+  --vits-tokens=./vits-melo-tts-zh_en/tokens.txt \
+  --vits-dict-dir=./vits-melo-tts-zh_en/dict \
+  --log-levels=warn,debug,trace \
+  --num-runs=10 \
+  "小米的核心价值观是什么？" 2>/dev/null
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineTtsConfig config;
+  config.Register(&po);
+
+  std::string log_levels = "warn,debug";
+  int32_t num_runs = 10;
+  int32_t sid = 0;
+
+  po.Register("log-levels", &log_levels,
+              "Comma separated runtime log levels to benchmark. Valid "
+              "values: trace, debug, info, warn, error");
+  po.Register("num-runs", &num_runs, "Number of runs for each log level");
+  po.Register("sid", &sid, "Speaker ID");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr,
+            "Error: Please provide the text to generate. Use single quotes "
+            "to wrap your text\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> names;
+  sherpa_onnx::SplitStringToVector(log_levels, ",", false, &names);
+  for (const auto &name : names) {
+    if (ToLogLevel(name) == -1) {
+      fprintf(stderr, "Invalid log level: '%s'\n", name.c_str());
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (!config.Validate() || names.empty() || num_runs < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  std::string text = po.GetArg(1);
+
+  sherpa_onnx::SetLogLevel(SHERPA_ONNX_LOG_LEVEL_WARN);
+  sherpa_onnx::OfflineTts tts(config);
+
+  // warm up
+  auto audio = tts.Generate(text, sid);
+  if (audio.samples.empty()) {
+    fprintf(stderr, "Failed to generate audio\n");
+    exit(EXIT_FAILURE);
+  }
+
+  float duration = audio.samples.size() / static_cast<float>(audio.sample_rate);
+  printf("Audio duration: %.3f s\n", duration);
+
+  for (const auto &name : names) {
+    sherpa_onnx::SetLogLevel(ToLogLevel(name));
+
+    std::vector<float> elapsed_ms;
+    for (int32_t i = 0; i != num_runs; ++i) {
+      const auto begin = std::chrono::steady_clock::now();
+      tts.Generate(text, sid);
+      const auto end = std::chrono::steady_clock::now();
+
+      elapsed_ms.push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+              .count() /
+          1000.);
+    }
+
+    sherpa_onnx::SetLogLevel(SHERPA_ONNX_LOG_LEVEL_WARN);
+
+    float sum = 0;
+    for (auto ms : elapsed_ms) {
+      sum += ms;
+    }
+    float mean = sum / num_runs;
+
+    std::sort(elapsed_ms.begin(), elapsed_ms.end());
+    float median = elapsed_ms[num_runs / 2];
+
+    printf("%-6s mean %9.3f ms, median %9.3f ms, RTF %.3f\n", name.c_str(),
+           mean, median, mean / 1000 / duration);
+  }
+
+  return 0;
+}
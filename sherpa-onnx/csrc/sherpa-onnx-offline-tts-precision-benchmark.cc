@@ -0,0 +1,257 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-precision-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Latency and accuracy of int8, fp16 and mixed precision variants of a VITS
+// model, e.g., MeloTTS Korean and its BERT model, against the fp32 model.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/features.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace {
+
+struct Result {
+  std::vector<float> samples;
+  int32_t sample_rate = 0;
+  float elapsed_seconds = 0;
+};
+
+// Generate each sentence num_runs times and keep the audio of the last run
+std::vector<Result> Run(const sherpa_onnx::OfflineTtsConfig &config,
+                        const std::vector<std::string> &sentences,
+                        int32_t num_runs) {
+  sherpa_onnx::OfflineTts tts(config);
+
+  // warm up
+  tts.Generate(sentences[0]);
+
+  std::vector<Result> ans;
+  for (const auto &s : sentences) {
+    Result r;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i != num_runs; ++i) {
+      auto audio = tts.Generate(s);
+      r.samples = std::move(audio.samples);
+      r.sample_rate = audio.sample_rate;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    r.elapsed_seconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+            .count() /
+        1e6 / num_runs;
+
+    ans.push_back(std::move(r));
+  }
+
+  return ans;
+}
+
+// Return log-mel features of shape (num_frames, 80), flattened
+std::vector<float> ComputeLogMel(const Result &r, int32_t *num_frames) {
+  sherpa_onnx::FeatureExtractorConfig config;
+  config.sampling_rate = r.sample_rate;
+  config.feature_dim = 80;
+
+  sherpa_onnx::FeatureExtractor extractor(config);
+  extractor.AcceptWaveform(r.sample_rate, r.samples.data(), r.samples.size());
+  extractor.InputFinished();
+
+  *num_frames = extractor.NumFramesReady();
+  return extractor.GetFrames(0, *num_frames);
+}
+
+// Mean absolute difference of log-mel features over the frames of the
+// shorter audio
+float LogMelDistance(const Result &a, const Result &b) {
+  int32_t num_frames_a = 0;
+  int32_t num_frames_b = 0;
+  std::vector<float> mel_a = ComputeLogMel(a, &num_frames_a);
+  std::vector<float> mel_b = ComputeLogMel(b, &num_frames_b);
+
+  int32_t n = std::min(num_frames_a, num_frames_b) * 80;
+  if (n == 0) {
+    return 0;
+  }
+
+  double sum = 0;
+  for (int32_t i = 0; i != n; ++i) {
+    sum += std::abs(mel_a[i] - mel_b[i]);
+  }
+
+  return sum / n;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Compare variants of a VITS model with the model given by --vits-model
+and --vits-ja-bert-model, which is usually the fp32 one.
+
+Each variant is a pair of a VITS model and a BERT model, given by the
+i-th entry of --variant-models and --variant-ja-bert-models. An empty
+entry means to use the reference model, so the following example compares
+int8 BERT + fp32 VITS, int8 BERT + int8 VITS, and int8 BERT + fp16 VITS
+with fp32 BERT + fp32 VITS.
+
+For each variant it prints the mean latency per sentence, the real time
+factor, the ratio of the audio duration to the reference, and the mean
+absolute difference of log-mel features from the reference.
+
+Noise is disabled by default, i.e., --vits-noise-scale=0 and
+--vits-noise-scale-w=0, so that the output of a model is deterministic.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-precision-benchmark \
+  --vits-model=./melo-tts-ko/model.onnx \
+  --vits-ja-bert-model=./melo-tts-ko/ja_bert.onnx \
+  --vits-vocab=./melo-tts-ko/vocab.txt \
+  --vits-lexicon=./melo-tts-ko/lexicon.txt \
+  --vits-tokens=./melo-tts-ko/tokens.txt \
+  --variant-models=",./melo-tts-ko/model.int8.onnx,./melo-tts-ko/model.fp16.onnx" \
+  --variant-ja-bert-models="./melo-tts-ko/ja_bert.int8.onnx,./melo-tts-ko/ja_bert.int8.onnx,./melo-tts-ko/ja_bert.int8.onnx" \
+  --num-runs=3 \
+  ./sentences-ko.txt
+
+where sentences-ko.txt contains one sentence per line.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineTtsConfig config;
+  config.model.vits.noise_scale = 0;
+  config.model.vits.noise_scale_w = 0;
+  config.Register(&po);
+
+  std::string variant_models;
+  std::string variant_ja_bert_models;
+  int32_t num_runs = 3;
+
+  po.Register("variant-models", &variant_models,
+              "Comma separated VITS models to compare with --vits-model");
+  po.Register("variant-ja-bert-models", &variant_ja_bert_models,
+              "Comma separated BERT models to compare with "
+              "--vits-ja-bert-model");
+  po.Register("num-runs", &num_runs, "Number of runs for each sentence");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "Error: Please provide a file with sentences\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> models;
+  std::vector<std::string> ja_bert_models;
+  sherpa_onnx::SplitStringToVector(variant_models, ",", false, &models);
+  sherpa_onnx::SplitStringToVector(variant_ja_bert_models, ",", false,
+                                   &ja_bert_models);
+
+  if (models.empty()) {
+    models.resize(ja_bert_models.size());
+  }
+
+  if (ja_bert_models.empty()) {
+    ja_bert_models.resize(models.size());
+  }
+
+  if (models.size() != ja_bert_models.size()) {
+    fprintf(stderr,
+            "--variant-models and --variant-ja-bert-models have different "
+            "number of entries: %d vs %d\n",
+            static_cast<int32_t>(models.size()),
+            static_cast<int32_t>(ja_bert_models.size()));
+    exit(EXIT_FAILURE);
+  }
+
+  if (!config.Validate() || num_runs < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> sentences;
+  {
+    std::ifstream is(po.GetArg(1));
+    std::string line;
+    while (std::getline(is, line)) {
+      if (!line.empty()) {
+        sentences.push_back(line);
+      }
+    }
+  }
+
+  if (sentences.empty()) {
+    fprintf(stderr, "No sentences in '%s'\n", po.GetArg(1).c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  sherpa_onnx::SetLogLevel(SHERPA_ONNX_LOG_LEVEL_WARN);
+
+  std::vector<Result> reference = Run(config, sentences, num_runs);
+
+  float reference_seconds = 0;
+  float reference_duration = 0;
+  for (const auto &r : reference) {
+    reference_seconds += r.elapsed_seconds;
+    reference_duration += r.samples.size() / static_cast<float>(r.sample_rate);
+  }
+
+  printf("%-40s %-40s %10s %6s %8s %8s\n", "VITS model", "BERT model",
+         "latency", "RTF", "duration", "log-mel");
+  printf("%-40s %-40s %8.1fms %6.3f %8.3f %8.4f\n",
+         config.model.vits.model.c_str(),
+         config.model.vits.ja_bert_model.c_str(),
+         reference_seconds * 1000 / sentences.size(),
+         reference_seconds / reference_duration, 1.0, 0.0);
+
+  for (size_t i = 0; i != models.size(); ++i) {
+    sherpa_onnx::OfflineTtsConfig c = config;
+    if (!models[i].empty()) {
+      c.model.vits.model = models[i];
+    }
+
+    if (!ja_bert_models[i].empty()) {
+      c.model.vits.ja_bert_model = ja_bert_models[i];
+    }
+
+    if (!c.Validate()) {
+      fprintf(stderr, "Errors in config of variant %d!\n",
+              static_cast<int32_t>(i));
+      exit(EXIT_FAILURE);
+    }
+
+    std::vector<Result> results = Run(c, sentences, num_runs);
+
+    float seconds = 0;
+    float duration = 0;
+    float distance = 0;
+    for (size_t k = 0; k != results.size(); ++k) {
+      seconds += results[k].elapsed_seconds;
+      duration += results[k].samples.size() /
+                  static_cast<float>(results[k].sample_rate);
+      distance += LogMelDistance(reference[k], results[k]);
+    }
+
+    printf("%-40s %-40s %8.1fms %6.3f %8.3f %8.4f\n",
+           c.model.vits.model.c_str(), c.model.vits.ja_bert_model.c_str(),
+           seconds * 1000 / sentences.size(), seconds / duration,
+           duration / reference_duration, distance / sentences.size());
+  }
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-sentence-pipeline-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Latency of a long document with different values of
+// --tts-sentence-pipeline.
+
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace {
+
+// Number of UTF-8 characters in s
+int32_t NumChars(const std::string &s) {
+  int32_t n = 0;
+  for (char c : s) {
+    if ((static_cast<uint8_t>(c) & 0xc0) != 0x80) {
+      n += 1;
+    }
+  }
+  return n;
+}
+
+// Repeat text until it contains at least num_chars characters and then
+// truncate it to num_chars characters
+std::string Resize(const std::string &text, int32_t num_chars) {
+  std::string ans = text;
+  while (NumChars(ans) < num_chars) {
+    ans += " ";
+    ans += text;
+  }
+
+  int32_t n = 0;
+  for (size_t i = 0; i != ans.size(); ++i) {
+    if ((static_cast<uint8_t>(ans[i]) & 0xc0) != 0x80) {
+      if (n == num_chars) {
+        ans.resize(i);
+        break;
+      }
+      n += 1;
+    }
+  }
+
+  return ans;
+}
+
+double Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+             .count() /
+         1e6;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Generate a long document with each of the given sentence pipelines and
+print the mean latency, the mean time to the first audio and the real time
+factor of each pipeline.
+
+  - serial: the frontend and the acoustic model of all sentences run
+            one after another
+  - synthesis: the frontend runs serially, the acoustic model runs in
+               parallel
+  - task-graph: G2P, BERT and the acoustic model of all sentences run in
+                parallel
+
+The document is repeated or truncated to --num-chars characters.
+Set --num-chars=0 to use the document as it is.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-sentence-pipeline-benchmark \
+  --vits-model=./melo-tts-ko/model.onnx \
+  --vits-ja-bert-model=./melo-tts-ko/ja_bert.onnx \
+  --vits-vocab=./melo-tts-ko/vocab.txt \
+  --vits-lexicon=./melo-tts-ko/lexicon.txt \
+  --vits-tokens=./melo-tts-ko/tokens.txt \
+  --pipelines=serial,synthesis,task-graph \
+  --num-chars=5000 \
+  --num-runs=3 \
+  ./document-ko.txt
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineTtsConfig config;
+  config.Register(&po);
+
+  std::string pipelines = "serial,synthesis,task-graph";
+  int32_t num_chars = 5000;
+  int32_t num_runs = 3;
+  int32_t sid = 0;
+
+  po.Register("pipelines", &pipelines,
+              "Comma separated values of --tts-sentence-pipeline to "
+              "benchmark");
+  po.Register("num-chars", &num_chars,
+              "Number of characters of the document. 0 to use the document "
+              "as it is");
+  po.Register("num-runs", &num_runs, "Number of runs for each pipeline");
+  po.Register("sid", &sid, "Speaker ID");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "Error: Please provide a text file\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> names;
+  sherpa_onnx::SplitStringToVector(pipelines, ",", false, &names);
+
+  if (!config.Validate() || names.empty() || num_runs < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  std::string text;
+  {
+    std::ifstream is(po.GetArg(1));
+    std::ostringstream os;
+    os << is.rdbuf();
+    text = os.str();
+  }
+
+  if (text.empty()) {
+    fprintf(stderr, "'%s' is empty\n", po.GetArg(1).c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  if (num_chars > 0) {
+    text = Resize(text, num_chars);
+  }
+
+  printf("Number of characters: %d\n", NumChars(text));
+
+  sherpa_onnx::SetLogLevel(SHERPA_ONNX_LOG_LEVEL_WARN);
+
+  for (const auto &name : names) {
+    sherpa_onnx::OfflineTtsConfig c = config;
+    c.sentence_pipeline = name;
+    if (!c.Validate()) {
+      fprintf(stderr, "Invalid pipeline '%s'\n", name.c_str());
+      exit(EXIT_FAILURE);
+    }
+
+    sherpa_onnx::OfflineTts tts(c);
+
+    // warm up
+    tts.Generate("안녕하세요.", sid);
+
+    double total_seconds = 0;
+    double total_first_audio_seconds = 0;
+    float duration = 0;
+    for (int32_t i = 0; i != num_runs; ++i) {
+      double start = Now();
+      double first_audio = 0;
+      auto audio = tts.Generate(
+          text, sid, 1.0,
+          [&first_audio](const float * /*samples*/, int32_t /*n*/,
+                         float /*progress*/) -> int32_t {
+            if (first_audio == 0) {
+              first_audio = Now();
+            }
+            return 1;
+          });
+      double end = Now();
+
+      total_seconds += end - start;
+      total_first_audio_seconds += (first_audio > 0 ? first_audio : end) -
+                                   start;
+      duration = audio.samples.size() / static_cast<float>(audio.sample_rate);
+    }
+
+    double mean = total_seconds / num_runs;
+    printf("%-10s mean %8.3f s, first audio %8.3f s, RTF %.3f\n",
+           name.c_str(), mean, total_first_audio_seconds / num_runs,
+           mean / duration);
+  }
+
+  return 0;
+}
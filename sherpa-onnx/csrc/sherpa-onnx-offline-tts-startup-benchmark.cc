@@ -0,0 +1,132 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-tts-startup-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Startup time and memory usage of multiple OfflineTts instances in one
+// process.
+
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+// Return the resident set size of this process in MB, or -1 if it is not
+// available on this platform.
+static float GetRssMB() {
+  std::ifstream is("/proc/self/status");
+  std::string line;
+  while (std::getline(is, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      return std::stof(line.substr(6)) / 1024;
+    }
+  }
+  return -1;
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Create --num-instances TTS engines with the same model in one process
+and print the time to create each of them and the resident memory
+afterwards. Resources such as the jieba dictionary are shared between
+instances, so only the first instance pays for loading them.
+
+If a text is given, all instances then generate it at the same time,
+each one in its own thread.
+
+Usage:
+
+./bin/sherpa-onnx-offline-tts-startup-benchmark \
+  --vits-model=./vits-melo-tts-zh_en/model.onnx \
+  --vits-lexicon=./vits-melo-tts-zh_en/lexicon.txt \
+  --vits-tokens=./vits-melo-tts-zh_en/tokens.txt \
+  --vits-dict-dir=./vits-melo-tts-zh_en/dict \
+  --num-instances=8 \
+  "小米的核心价值观是什么？"
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineTtsConfig config;
+  config.Register(&po);
+
+  int32_t num_instances = 8;
+  po.Register("num-instances", &num_instances,
+              "Number of TTS instances to create");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() > 1) {
+    fprintf(stderr,
+            "Error: Accept at most one positional argument. Please use "
+            "single quotes to wrap your text\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (!config.Validate() || num_instances < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  float base_rss = GetRssMB();
+  fprintf(stderr, "RSS before creating instances: %.1f MB\n", base_rss);
+
+  std::vector<std::unique_ptr<sherpa_onnx::OfflineTts>> instances;
+  for (int32_t i = 0; i != num_instances; ++i) {
+    const auto begin = std::chrono::steady_clock::now();
+    instances.push_back(std::make_unique<sherpa_onnx::OfflineTts>(config));
+    const auto end = std::chrono::steady_clock::now();
+
+    float elapsed_seconds =
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+            .count() /
+        1000.;
+
+    float rss = GetRssMB();
+    fprintf(stderr, "Instance %d: startup %.3f s, RSS %.1f MB (+%.1f MB)\n", i,
+            elapsed_seconds, rss, rss - base_rss);
+  }
+
+  if (po.NumArgs() == 0) {
+    return 0;
+  }
+
+  std::string text = po.GetArg(1);
+  std::vector<float> elapsed(num_instances);
+  std::vector<std::thread> threads;
+
+  for (int32_t i = 0; i != num_instances; ++i) {
+    threads.emplace_back([i, &instances, &text, &elapsed]() {
+      const auto begin = std::chrono::steady_clock::now();
+      auto audio = instances[i]->Generate(text);
+      const auto end = std::chrono::steady_clock::now();
+
+      elapsed[i] =
+          std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+              .count() /
+          1000.;
+
+      if (audio.samples.empty()) {
+        fprintf(stderr, "Instance %d failed to generate audio\n", i);
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (int32_t i = 0; i != num_instances; ++i) {
+    fprintf(stderr, "Instance %d: generation %.3f s\n", i, elapsed[i]);
+  }
+
+  fprintf(stderr, "RSS after generation: %.1f MB\n", GetRssMB());
+
+  return 0;
+}
@@ -4,9 +4,12 @@
 
 #include <chrono>  // NOLINT
 #include <fstream>
+#include <string>
 
 #include "sherpa-onnx/csrc/offline-tts.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/telephony-encoder.h"
+#include "sherpa-onnx/csrc/trace.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
 
 static int32_t AudioCallback(const float * /*samples*/, int32_t n,
@@ -15,6 +18,65 @@ static int32_t AudioCallback(const float * /*samples*/, int32_t n,
   return 1;
 }
 
+static int32_t GenerateTelephony(
+    const sherpa_onnx::OfflineTts &tts,
+    const sherpa_onnx::TelephonyEncoderConfig &output_config,
+    const std::string &text, int32_t sid, const std::string &output_filename) {
+  if (!output_config.Validate()) {
+    fprintf(stderr, "Errors in output config!\n");
+    return EXIT_FAILURE;
+  }
+
+  sherpa_onnx::AudioEncoding encoding;
+  sherpa_onnx::StringToAudioEncoding(output_config.encoding, &encoding);
+
+  int32_t sample_rate = output_config.sample_rate > 0
+                            ? output_config.sample_rate
+                            : tts.SampleRate();
+
+  sherpa_onnx::WaveWriter writer;
+  if (!writer.Open(output_filename, sample_rate, encoding)) {
+    return EXIT_FAILURE;
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  float first_frame_seconds = -1;
+
+  int64_t num_frames = tts.GenerateEncoded(
+      text, sid, 1.0, output_config,
+      [&](const uint8_t *data, int32_t n, float /*progress*/) -> int32_t {
+        if (first_frame_seconds < 0) {
+          first_frame_seconds =
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - begin)
+                  .count() /
+              1000.;
+        }
+        return writer.WriteEncoded(data, n);
+      });
+
+  const auto end = std::chrono::steady_clock::now();
+
+  bool ok = writer.Close();
+  if (num_frames <= 0 || !ok) {
+    fprintf(stderr, "Failed to generate %s\n", output_filename.c_str());
+    return EXIT_FAILURE;
+  }
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "%s\n", output_config.ToString().c_str());
+  fprintf(stderr, "Number of frames: %d\n", static_cast<int32_t>(num_frames));
+  fprintf(stderr, "Time to first frame: %.3f s\n", first_frame_seconds);
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+  fprintf(stderr, "Saved to %s successfully!\n", output_filename.c_str());
+
+  return 0;
+}
+
 int main(int32_t argc, char *argv[]) {
   const char *kUsageMessage = R"usage(
 Offline/Non-streaming text-to-speech with sherpa-onnx
@@ -33,6 +95,25 @@ tar xf vits-piper-en_US-amy-low.tar.bz2
 
 It will generate a file ./generated.wav as specified by --output-filename.
 
+To generate 8 kHz mu-law audio in 20 ms frames, e.g., for telephony, use
+
+./bin/sherpa-onnx-offline-tts \
+ --vits-model=./vits-piper-en_US-amy-low/en_US-amy-low.onnx \
+ --vits-tokens=./vits-piper-en_US-amy-low/tokens.txt \
+ --vits-data-dir=./vits-piper-en_US-amy-low/espeak-ng-data \
+ --output-filename=./generated-mulaw.wav \
+ --telephony=true \
+ --output-sample-rate=8000 \
+ --output-encoding=mulaw \
+ --output-frame-ms=20 \
+ "How are you doing?"
+
+The frames are appended to the output file as soon as they are produced.
+
+Use --trace=true to print the time spent in each stage, e.g., g2p and
+acoustic_model, and --chrome-trace=./trace.json to also save a timeline
+that can be viewed with chrome://tracing or https://ui.perfetto.dev
+
 You can find more models at
 https://github.com/k2-fsa/sherpa-onnx/releases/tag/tts-models
 
@@ -44,6 +125,9 @@ or details.
   sherpa_onnx::ParseOptions po(kUsageMessage);
   std::string output_filename = "./generated.wav";
   int32_t sid = 0;
+  bool telephony = false;
+  bool trace = false;
+  std::string chrome_trace;
 
   po.Register("output-filename", &output_filename,
               "Path to save the generated audio");
@@ -53,9 +137,22 @@ or details.
               "trained using the VCTK dataset. Not used for single-speaker "
               "models, e.g., models trained using the LJSpeech dataset");
 
+  po.Register("telephony", &telephony,
+              "true to resample and encode the audio in fixed-size frames. "
+              "See --output-sample-rate, --output-encoding and "
+              "--output-frame-ms");
+
+  po.Register("trace", &trace, "true to print the time of each stage");
+
+  po.Register("chrome-trace", &chrome_trace,
+              "If not empty, save the time of each stage to this file in the "
+              "Chrome trace event format. It implies --trace=true");
+
   sherpa_onnx::OfflineTtsConfig config;
+  sherpa_onnx::TelephonyEncoderConfig output_config;
 
   config.Register(&po);
+  output_config.Register(&po);
   po.Read(argc, argv);
 
   if (po.NumArgs() == 0) {
@@ -81,8 +178,17 @@ or details.
     exit(EXIT_FAILURE);
   }
 
+  if (trace || !chrome_trace.empty()) {
+    sherpa_onnx::Tracer::Get().Enable(!chrome_trace.empty());
+  }
+
   sherpa_onnx::OfflineTts tts(config);
 
+  if (telephony) {
+    return GenerateTelephony(tts, output_config, po.GetArg(1), sid,
+                             output_filename);
+  }
+
   const auto begin = std::chrono::steady_clock::now();
   auto audio = tts.Generate(po.GetArg(1), sid, 1.0, AudioCallback);
   const auto end = std::chrono::steady_clock::now();
@@ -106,6 +212,15 @@ or details.
   fprintf(stderr, "Real-time factor (RTF): %.3f/%.3f = %.3f\n", elapsed_seconds,
           duration, rtf);
 
+  if (!audio.trace.empty()) {
+    fprintf(stderr, "Stages: %s\n", audio.trace.c_str());
+  }
+
+  if (!chrome_trace.empty() &&
+      sherpa_onnx::Tracer::Get().WriteChromeTrace(chrome_trace)) {
+    fprintf(stderr, "Saved trace to %s\n", chrome_trace.c_str());
+  }
+
   bool ok = sherpa_onnx::WriteWave(output_filename, audio.sample_rate,
                                    audio.samples.data(), audio.samples.size());
   if (!ok) {
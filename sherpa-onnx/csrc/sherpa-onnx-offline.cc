@@ -132,18 +132,21 @@ for a list of pre-trained models to download.
   float duration = 0;
   for (int32_t i = 1; i <= po.NumArgs(); ++i) {
     std::string wav_filename = po.GetArg(i);
-    int32_t sampling_rate = -1;
-    bool is_ok = false;
-    std::vector<float> samples =
-        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-    if (!is_ok) {
+    sherpa_onnx::StreamingWaveReader reader(wav_filename);
+    if (!reader.IsOk()) {
       fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
       return -1;
     }
-    duration += samples.size() / static_cast<float>(sampling_rate);
+    int32_t sampling_rate = reader.SampleRate();
+    duration += reader.NumSamples() / static_cast<float>(sampling_rate);
 
+    // Decode the file in chunks of 10 seconds so that only the features,
+    // not the samples, are kept in memory
     auto s = recognizer.CreateStream();
-    s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
+    for (const auto &chunk : reader.Chunks(10 * sampling_rate)) {
+      s->AcceptWaveformChunk(sampling_rate, chunk.data(), chunk.size());
+    }
+    s->InputFinished();
 
     ss.push_back(std::move(s));
     ss_pointers.push_back(ss.back().get());
@@ -0,0 +1,206 @@
+// sherpa-onnx/csrc/sherpa-onnx-online-batch-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Throughput of OnlineRecognizer::DecodeStreams() for many concurrent
+// streams, with and without reusing the batched model states.
+
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace {
+
+// Number of bytes of the given states
+int64_t NumBytes(const std::vector<Ort::Value> &states) {
+  int64_t ans = 0;
+  for (const auto &v : states) {
+    auto info = v.GetTensorTypeAndShapeInfo();
+    int64_t n = info.GetElementCount();
+    switch (info.GetElementType()) {
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+        ans += n * 8;
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+        ans += n * 2;
+        break;
+      default:
+        ans += n * 4;
+        break;
+    }
+  }
+  return ans;
+}
+
+struct Stats {
+  float elapsed_seconds = 0;
+  int64_t num_chunks = 0;
+  int64_t bytes_copied = 0;
+};
+
+// Decode num_streams copies of the given wave in batches.
+//
+// If copy is true, every stream takes its own states before each call of
+// DecodeStreams(), so the states are unstacked and stacked again for each
+// chunk as if they were not kept in batches.
+Stats Run(const sherpa_onnx::OnlineRecognizer &recognizer,
+          const std::vector<float> &samples, int32_t sampling_rate,
+          int32_t num_streams, bool copy) {
+  std::vector<std::unique_ptr<sherpa_onnx::OnlineStream>> streams;
+  std::vector<float> tail_paddings(static_cast<int>(0.8 * sampling_rate));
+
+  for (int32_t i = 0; i != num_streams; ++i) {
+    auto s = recognizer.CreateStream();
+    s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
+    s->AcceptWaveform(sampling_rate, tail_paddings.data(),
+                      tail_paddings.size());
+    s->InputFinished();
+    streams.push_back(std::move(s));
+  }
+
+  int64_t state_bytes = NumBytes(streams[0]->GetStates());
+
+  Stats stats;
+  std::vector<sherpa_onnx::OnlineStream *> ready_streams;
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  while (true) {
+    ready_streams.clear();
+    for (auto &s : streams) {
+      if (recognizer.IsReady(s.get())) {
+        ready_streams.push_back(s.get());
+      }
+    }
+
+    if (ready_streams.empty()) {
+      break;
+    }
+
+    if (copy) {
+      for (auto s : ready_streams) {
+        s->GetStates();
+      }
+    }
+
+    recognizer.DecodeStreams(ready_streams.data(), ready_streams.size());
+    stats.num_chunks += ready_streams.size();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  stats.elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count() /
+      1e6;
+
+  // States of a stream are copied once to unstack and once to stack them
+  if (copy) {
+    stats.bytes_copied = stats.num_chunks * state_bytes * 2;
+  }
+
+  return stats;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Decode the given wave file in many streams at the same time and print the
+number of chunks per second.
+
+Two modes are compared:
+  - pool: model states stay stacked in a batch between calls of
+    DecodeStreams() when the same streams are decoded again
+  - copy: states are unstacked into each stream after each chunk and
+    stacked again for the next one
+
+Usage:
+
+  ./bin/sherpa-onnx-online-batch-benchmark \
+    --tokens=/path/to/tokens.txt \
+    --encoder=/path/to/encoder.onnx \
+    --decoder=/path/to/decoder.onnx \
+    --joiner=/path/to/joiner.onnx \
+    --num-streams=64,256 \
+    /path/to/foo.wav
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OnlineRecognizerConfig config;
+  config.Register(&po);
+
+  std::string num_streams_str = "64,256";
+  po.Register("num-streams", &num_streams_str,
+              "Comma separated list of the number of streams to test");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() != 1) {
+    po.PrintUsage();
+    fprintf(stderr, "Error! Please provide 1 wav file\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Endpointing would reset the states of some streams
+  config.enable_endpoint = false;
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  std::vector<int32_t> num_streams_list;
+  {
+    std::istringstream is(num_streams_str);
+    std::string s;
+    while (std::getline(is, s, ',')) {
+      int32_t n = atoi(s.c_str());
+      if (n < 1) {
+        fprintf(stderr, "Invalid --num-streams: '%s'\n",
+                num_streams_str.c_str());
+        return -1;
+      }
+      num_streams_list.push_back(n);
+    }
+  }
+
+  const std::string wav_filename = po.GetArg(1);
+  int32_t sampling_rate = -1;
+  bool is_ok = false;
+  const std::vector<float> samples =
+      sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
+
+  if (!is_ok) {
+    fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
+    return -1;
+  }
+
+  sherpa_onnx::OnlineRecognizer recognizer(config);
+
+  fprintf(stderr, "%10s %6s %12s %12s %16s\n", "streams", "mode", "chunks",
+          "chunks/s", "copied (MB)");
+
+  for (int32_t n : num_streams_list) {
+    for (bool copy : {false, true}) {
+      Stats stats = Run(recognizer, samples, sampling_rate, n, copy);
+      fprintf(stderr, "%10d %6s %12lld %12.1f %16.1f\n", n,
+              copy ? "copy" : "pool", static_cast<long long>(stats.num_chunks),
+              stats.num_chunks / stats.elapsed_seconds,
+              stats.bytes_copied / 1024. / 1024.);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,212 @@
+// sherpa-onnx/csrc/sherpa-onnx-online-speculative-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Compare the latency of partial results and the compute cost of streaming
+// transducer decoding with and without --speculative-decoding.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace {
+
+struct Snapshot {
+  float audio_time;
+  std::vector<std::string> tokens;
+};
+
+struct Stats {
+  float elapsed_seconds = 0;
+  float duration = 0;
+
+  // Sum over all tokens of the audio time between the timestamp of a token
+  // and the first partial result that contains it and all tokens before it.
+  double latency = 0;
+  int32_t num_tokens = 0;
+  int32_t num_provisional_results = 0;
+
+  std::vector<std::string> final_tokens;
+};
+
+// Feed the samples in blocks of block_size as if they came from a
+// microphone and get the result after each block.
+void Run(const sherpa_onnx::OnlineRecognizer &recognizer,
+         const std::vector<float> &samples, int32_t sampling_rate,
+         int32_t block_size, Stats *stats) {
+  auto s = recognizer.CreateStream();
+  std::vector<Snapshot> snapshots;
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (int32_t start = 0; start < static_cast<int32_t>(samples.size());
+       start += block_size) {
+    int32_t n =
+        std::min<int32_t>(block_size, static_cast<int32_t>(samples.size()) -
+                                          start);
+    s->AcceptWaveform(sampling_rate, samples.data() + start, n);
+
+    while (recognizer.IsReady(s.get())) {
+      recognizer.DecodeStream(s.get());
+    }
+
+    auto r = recognizer.GetResult(s.get());
+    stats->num_provisional_results += r.num_provisional_tokens > 0;
+    snapshots.push_back({static_cast<float>(start + n) / sampling_rate,
+                         std::move(r.tokens)});
+  }
+
+  std::vector<float> tail_paddings(static_cast<int>(0.8 * sampling_rate));
+  s->AcceptWaveform(sampling_rate, tail_paddings.data(),
+                    tail_paddings.size());
+  s->InputFinished();
+
+  while (recognizer.IsReady(s.get())) {
+    recognizer.DecodeStream(s.get());
+  }
+
+  auto r = recognizer.GetResult(s.get());
+
+  const auto end = std::chrono::steady_clock::now();
+
+  stats->elapsed_seconds +=
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count() /
+      1e6;
+  stats->duration += static_cast<float>(samples.size()) / sampling_rate;
+
+  // Frames at the end that do not fill a chunk are decoded only
+  // speculatively. Ignore them so that both modes can be compared.
+  std::vector<std::string> tokens(r.tokens.begin(),
+                                  r.tokens.end() - r.num_provisional_tokens);
+  float duration = static_cast<float>(samples.size()) / sampling_rate;
+
+  // The first snapshot that contains tokens[0..k] is never earlier than
+  // the one for tokens[0..k-1], so we scan the snapshots only once.
+  size_t i = 0;
+  for (size_t k = 0; k != tokens.size(); ++k) {
+    while (i < snapshots.size() &&
+           (snapshots[i].tokens.size() <= k ||
+            !std::equal(tokens.begin(), tokens.begin() + k + 1,
+                        snapshots[i].tokens.begin()))) {
+      ++i;
+    }
+
+    float seen = i < snapshots.size() ? snapshots[i].audio_time : duration;
+    stats->latency += std::max(0.0f, seen - r.timestamps[k]);
+    stats->num_tokens += 1;
+  }
+
+  stats->final_tokens.insert(stats->final_tokens.end(), tokens.begin(),
+                             tokens.end());
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Compare streaming transducer decoding with and without speculative
+decoding of partially filled chunks. Audio is fed in blocks of --block-ms
+milliseconds and the result is fetched after each block.
+
+For each mode it prints
+  - the average latency of a token, i.e., the audio time between the
+    token and the first partial result that shows it correctly,
+  - the real time factor, which includes the extra encoder runs.
+
+Usage:
+
+  ./bin/sherpa-onnx-online-speculative-benchmark \
+    --tokens=/path/to/tokens.txt \
+    --encoder=/path/to/encoder.onnx \
+    --decoder=/path/to/decoder.onnx \
+    --joiner=/path/to/joiner.onnx \
+    --block-ms=20 \
+    /path/to/foo.wav [bar.wav foobar.wav ...]
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OnlineRecognizerConfig config;
+  config.Register(&po);
+
+  int32_t block_ms = 20;
+  po.Register("block-ms", &block_ms,
+              "Audio is fed to the recognizer in blocks of this many "
+              "milliseconds");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() < 1) {
+    po.PrintUsage();
+    fprintf(stderr, "Error! Please provide at least 1 wav file\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Endpointing would split the results into segments
+  config.enable_endpoint = false;
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate() || block_ms <= 0) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  auto speculative_config = config;
+  config.speculative_decoding = false;
+  speculative_config.speculative_decoding = true;
+
+  sherpa_onnx::OnlineRecognizer recognizer(config);
+  sherpa_onnx::OnlineRecognizer speculative_recognizer(speculative_config);
+
+  Stats stats;
+  Stats speculative_stats;
+
+  for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+    const std::string wav_filename = po.GetArg(i);
+    int32_t sampling_rate = -1;
+
+    bool is_ok = false;
+    const std::vector<float> samples =
+        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
+
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
+      return -1;
+    }
+
+    int32_t block_size = sampling_rate * block_ms / 1000;
+
+    Run(recognizer, samples, sampling_rate, block_size, &stats);
+    Run(speculative_recognizer, samples, sampling_rate, block_size,
+        &speculative_stats);
+  }
+
+  fprintf(stderr, "%-12s %12s %12s %16s\n", "mode", "latency (s)", "RTF",
+          "provisional");
+
+  for (const auto *p : {&stats, &speculative_stats}) {
+    fprintf(stderr, "%-12s %12.3f %12.4f %16d\n",
+            p == &stats ? "baseline" : "speculative",
+            p->num_tokens ? p->latency / p->num_tokens : 0,
+            p->elapsed_seconds / p->duration, p->num_provisional_results);
+  }
+
+  fprintf(stderr, "Extra compute: %.1f%%\n",
+          (speculative_stats.elapsed_seconds / stats.elapsed_seconds - 1) *
+              100);
+
+  if (stats.final_tokens != speculative_stats.final_tokens) {
+    fprintf(stderr, "Error: final results differ!\n");
+    return -1;
+  }
+
+  return 0;
+}
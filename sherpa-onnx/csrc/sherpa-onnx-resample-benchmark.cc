@@ -0,0 +1,111 @@
+// sherpa-onnx/csrc/sherpa-onnx-resample-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Throughput of LinearResample when it is fed 10 ms chunks, as in a
+// streaming application.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/resample.h"
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
+namespace {
+
+// A 440 Hz tone plus some noise
+std::vector<float> GenerateSignal(int32_t num_samples, int32_t sample_rate) {
+  std::mt19937 gen(20250101);
+  std::uniform_real_distribution<float> noise(-0.05, 0.05);
+
+  std::vector<float> x(num_samples);
+  for (int32_t i = 0; i != num_samples; ++i) {
+    float t = i / static_cast<float>(sample_rate);
+    x[i] = 0.5 * std::sin(2 * M_PI * 440 * t) + noise(gen);
+  }
+
+  return x;
+}
+
+// Return the number of input samples per second
+float Run(int32_t samp_rate_in, int32_t samp_rate_out, float seconds) {
+  auto x = GenerateSignal(seconds * samp_rate_in, samp_rate_in);
+
+  float cutoff = 0.99 * 0.5 * std::min(samp_rate_in, samp_rate_out);
+  sherpa_onnx::LinearResample resampler(samp_rate_in, samp_rate_out, cutoff,
+                                        6);
+
+  int32_t chunk = samp_rate_in / 100;
+  std::vector<float> buf(resampler.NumOutputSamples(chunk, true) + 16);
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (int32_t offset = 0; offset + chunk <= static_cast<int32_t>(x.size());
+       offset += chunk) {
+    resampler.Resample(x.data() + offset, chunk, false, buf.data());
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count() /
+      1e6;
+
+  return x.size() / std::max(elapsed_seconds, 1e-6f);
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Measure the throughput of LinearResample for a synthetic signal that is
+fed in 10 ms chunks. Without arguments, a few common rate pairs are used.
+
+Usage:
+
+./bin/sherpa-onnx-resample-benchmark [--seconds=30]
+./bin/sherpa-onnx-resample-benchmark [--seconds=30] 48000 16000
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  float seconds = 30;
+  po.Register("seconds", &seconds, "Duration of the input signal");
+
+  po.Read(argc, argv);
+
+  if ((po.NumArgs() != 0 && po.NumArgs() != 2) || seconds <= 0) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::pair<int32_t, int32_t>> pairs = {
+      {48000, 16000}, {44100, 16000}, {22050, 8000}};
+
+  if (po.NumArgs() == 2) {
+    pairs = {{atoi(po.GetArg(1).c_str()), atoi(po.GetArg(2).c_str())}};
+    if (pairs[0].first <= 0 || pairs[0].second <= 0) {
+      fprintf(stderr, "Invalid sample rates\n");
+      return -1;
+    }
+  }
+
+  for (const auto &[in, out] : pairs) {
+    fprintf(stderr, "%d -> %d: %.2f M input samples/s\n", in, out,
+            Run(in, out, seconds) / 1e6);
+  }
+
+  return 0;
+}
@@ -0,0 +1,181 @@
+// sherpa-onnx/csrc/sherpa-onnx-session-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Cold start and warm inference time of an onnx model with different
+// onnxruntime session options.
+
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/provider-config.h"
+#include "sherpa-onnx/csrc/session.h"
+
+namespace {
+
+float ElapsedSeconds(std::chrono::steady_clock::time_point begin) {
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+             .count() /
+         1e6;
+}
+
+// Create inputs filled with ones. Dynamic dimensions are set to dim.
+std::vector<Ort::Value> CreateInputs(Ort::Session *sess, int64_t dim) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::vector<Ort::Value> ans;
+
+  for (size_t i = 0; i != sess->GetInputCount(); ++i) {
+    auto info = sess->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo();
+    std::vector<int64_t> shape = info.GetShape();
+    for (auto &d : shape) {
+      if (d < 0) {
+        d = dim;
+      }
+    }
+
+    switch (info.GetElementType()) {
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: {
+        Ort::Value v = Ort::Value::CreateTensor<int64_t>(
+            allocator, shape.data(), shape.size());
+        sherpa_onnx::Fill<int64_t>(&v, 1);
+        ans.push_back(std::move(v));
+        break;
+      }
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: {
+        Ort::Value v = Ort::Value::CreateTensor<int32_t>(
+            allocator, shape.data(), shape.size());
+        sherpa_onnx::Fill<int32_t>(&v, 1);
+        ans.push_back(std::move(v));
+        break;
+      }
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: {
+        Ort::Value v = Ort::Value::CreateTensor<float>(allocator, shape.data(),
+                                                       shape.size());
+        sherpa_onnx::Fill<float>(&v, 1);
+        ans.push_back(std::move(v));
+        break;
+      }
+      default:
+        fprintf(stderr, "Unsupported type %d of input %d\n",
+                static_cast<int32_t>(info.GetElementType()),
+                static_cast<int32_t>(i));
+        exit(EXIT_FAILURE);
+    }
+  }
+
+  return ans;
+}
+
+// Create a session num_starts times and print the time of each. Then run
+// it num_runs times and print the average time.
+void Benchmark(const char *name, const std::string &filename,
+               int32_t num_threads, const std::string &provider,
+               const sherpa_onnx::SessionConfig &config, int32_t num_starts,
+               int32_t num_runs, int64_t dim) {
+  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  Ort::SessionOptions sess_opts = sherpa_onnx::GetSessionOptionsImpl(
+      num_threads, provider, nullptr, &config);
+
+  std::unique_ptr<Ort::Session> sess;
+  for (int32_t i = 0; i != num_starts; ++i) {
+    sess.reset();
+
+    auto begin = std::chrono::steady_clock::now();
+    sess = sherpa_onnx::CreateSession(env, filename, sess_opts, config,
+                                      provider);
+    fprintf(stderr, "%-24s start %d: %8.3f s\n", name, i,
+            ElapsedSeconds(begin));
+  }
+
+  std::vector<std::string> input_names;
+  std::vector<const char *> input_names_ptr;
+  sherpa_onnx::GetInputNames(sess.get(), &input_names, &input_names_ptr);
+
+  std::vector<std::string> output_names;
+  std::vector<const char *> output_names_ptr;
+  sherpa_onnx::GetOutputNames(sess.get(), &output_names, &output_names_ptr);
+
+  std::vector<Ort::Value> inputs = CreateInputs(sess.get(), dim);
+
+  // warm up
+  sess->Run({}, input_names_ptr.data(), inputs.data(), inputs.size(),
+            output_names_ptr.data(), output_names_ptr.size());
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != num_runs; ++i) {
+    sess->Run({}, input_names_ptr.data(), inputs.data(), inputs.size(),
+              output_names_ptr.data(), output_names_ptr.size());
+  }
+  fprintf(stderr, "%-24s run:     %8.3f ms\n", name,
+          ElapsedSeconds(begin) * 1000 / num_runs);
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Measure the time to create an onnxruntime session for a model and the
+average time to run it with inputs filled with ones.
+
+It compares the given session options with the default options. If
+--ort-optimized-model-cache-dir is given, the session is created twice: the
+first time saves the optimized model and the second time loads it.
+
+Usage:
+
+./bin/sherpa-onnx-session-benchmark \
+  --num-threads=2 \
+  --ort-graph-optimization-level=extended \
+  --ort-optimized-model-cache-dir=/tmp/ort-cache \
+  --dim=100 \
+  /path/to/model.onnx
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::SessionConfig config;
+  config.Register(&po);
+
+  int32_t num_threads = 1;
+  std::string provider = "cpu";
+  int32_t num_runs = 10;
+  int64_t dim = 1;
+
+  po.Register("num-threads", &num_threads,
+              "Number of threads to run the neural network");
+  po.Register("provider", &provider,
+              "Specify a provider to use: cpu, cuda, coreml");
+  po.Register("num-runs", &num_runs, "Number of runs to average");
+  po.Register("dim", &dim, "Size of dynamic dimensions of the inputs");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() != 1) {
+    fprintf(stderr, "\nError: Please provide 1 onnx model\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate() || num_threads < 1 || num_runs < 1 || dim < 1) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  std::string filename = po.GetArg(1);
+
+  Benchmark("default", filename, num_threads, provider,
+            sherpa_onnx::SessionConfig{}, 1, num_runs, dim);
+
+  Benchmark("given", filename, num_threads, provider, config,
+            config.optimized_model_cache_dir.empty() ? 1 : 2, num_runs, dim);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+// sherpa-onnx/csrc/sherpa-onnx-text-normalizer-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+// Time per request of the punctuation normalization and CJK splitting done
+// by the TTS text frontends, with std::regex and with TextNormalizer.
+
+#include <stdio.h>
+
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <regex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/text-normalizer.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace {
+
+const char *kDefaultText =
+    "Hello,  world!\tHow are you?\n"
+    "中英文混合：你好、世界；Hello World。真的吗？是的！"
+    "今天是2025年1月8日，天气：晴。  Let's  go!"
+    "ﾟ𝕏😀 emoji 和 CJK 扩展字符𠀀。"
+    "The quick brown fox: jumps over the lazy dog；谢谢";
+
+const std::vector<std::pair<std::string, std::string>> kReplacements = {
+    {"，", ","}, {":", ","},  {"、", ","}, {"；", ";"},
+    {"：", ":"}, {"。", "."}, {"？", "?"}, {"！", "!"},
+};
+
+// What KokoroMultiLangLexicon did with std::regex
+std::string RegexNormalize(std::string text) {
+  for (const auto &p : kReplacements) {
+    text = std::regex_replace(text, std::regex(p.first), p.second);
+  }
+  return std::regex_replace(text, std::regex("\\s+"), " ");
+}
+
+std::vector<sherpa_onnx::TextRun> RegexSplit(const std::string &text) {
+  std::wregex we_both(sherpa_onnx::ToWideString(
+      "([\\u4e00-\\u9fff]+)|([^\\u4e00-\\u9fff]+)"));
+  std::wregex we_zh(sherpa_onnx::ToWideString("([\\u4e00-\\u9fff]+)"));
+
+  std::wstring ws = sherpa_onnx::ToWideString(text);
+  std::vector<sherpa_onnx::TextRun> ans;
+  for (std::wsregex_iterator i(ws.begin(), ws.end(), we_both), end; i != end;
+       ++i) {
+    std::wstring s = i->str();
+    ans.push_back({sherpa_onnx::ToString(s), std::regex_match(s, we_zh)});
+  }
+  return ans;
+}
+
+template <typename F>
+float TimeInMicroseconds(int32_t num_requests, F f) {
+  auto begin = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != num_requests; ++i) {
+    f();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+             .count() /
+         1e3 / num_requests;
+}
+
+}  // namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Measure the time per request of the text normalization done by the TTS
+frontends, once with std::regex as before and once with TextNormalizer.
+If no text file is given, a short mixed Chinese/English text is used.
+
+Usage:
+
+./bin/sherpa-onnx-text-normalizer-benchmark [--num-requests=200] [text.txt]
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  int32_t num_requests = 200;
+  po.Register("num-requests", &num_requests,
+              "Number of times the text is processed");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() > 1 || num_requests < 1) {
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  std::string text = kDefaultText;
+  if (po.NumArgs() == 1) {
+    std::ifstream is(po.GetArg(1));
+    if (!is) {
+      fprintf(stderr, "Failed to open '%s'\n", po.GetArg(1).c_str());
+      return -1;
+    }
+
+    std::ostringstream os;
+    os << is.rdbuf();
+    text = os.str();
+  }
+
+  const sherpa_onnx::TextNormalizer normalizer(kReplacements,
+                                               /*merge_spaces*/ true);
+
+  std::string expected = RegexNormalize(text);
+  std::string result = normalizer.Normalize(text);
+  if (result != expected) {
+    fprintf(stderr, "Mismatch:\n  %s\n  %s\n", expected.c_str(),
+            result.c_str());
+  }
+
+  float regex_us = TimeInMicroseconds(
+      num_requests, [&text]() { RegexSplit(RegexNormalize(text)); });
+
+  float normalizer_us = TimeInMicroseconds(num_requests, [&]() {
+    sherpa_onnx::SplitChineseAndNonChinese(normalizer.Normalize(text));
+  });
+
+  fprintf(stderr,
+          "%d bytes per request. std::regex: %.1f us, TextNormalizer: %.1f "
+          "us\n",
+          static_cast<int32_t>(text.size()), regex_us, normalizer_us);
+
+  return 0;
+}
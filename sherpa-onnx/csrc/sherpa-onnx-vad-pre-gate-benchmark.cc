@@ -0,0 +1,216 @@
+// sherpa-onnx/csrc/sherpa-onnx-vad-pre-gate-benchmark.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+// Frame resolution for scoring, in samples at 16 kHz
+static constexpr int32_t kFrameShift = 160;
+
+struct Result {
+  float elapsed_seconds = 0;
+  int64_t num_windows = 0;
+  int64_t num_skipped_windows = 0;
+
+  int64_t num_speech_frames = 0;
+  int64_t num_non_speech_frames = 0;
+  int64_t num_missed_frames = 0;
+  int64_t num_false_alarm_frames = 0;
+};
+
+// Each line of the label file contains "start end" in seconds of a
+// speech segment.
+static std::vector<bool> ReadLabels(const std::string &filename,
+                                    int32_t sample_rate, int32_t num_frames,
+                                    bool *is_ok) {
+  std::vector<bool> ans(num_frames);
+
+  std::ifstream is(filename);
+  if (!is) {
+    *is_ok = false;
+    return ans;
+  }
+
+  float start = 0;
+  float end = 0;
+  while (is >> start >> end) {
+    int32_t b = std::max<int32_t>(start * sample_rate / kFrameShift, 0);
+    int32_t e = std::min<int32_t>(end * sample_rate / kFrameShift, num_frames);
+    for (int32_t i = b; i < e; ++i) {
+      ans[i] = true;
+    }
+  }
+
+  *is_ok = true;
+  return ans;
+}
+
+static void Run(const sherpa_onnx::VadModelConfig &config,
+                const std::vector<float> &samples,
+                const std::vector<bool> &labels, Result *r) {
+  sherpa_onnx::VoiceActivityDetector vad(config);
+
+  int32_t num_frames = labels.size();
+  std::vector<bool> detected(num_frames);
+
+  auto mark = [&](const sherpa_onnx::SpeechSegment &s) {
+    int32_t b = s.start / kFrameShift;
+    int32_t e = std::min<int32_t>((s.start + s.samples.size()) / kFrameShift,
+                                  num_frames);
+    for (int32_t i = b; i < e; ++i) {
+      detected[i] = true;
+    }
+  };
+
+  int32_t window_size = config.silero_vad.window_size;
+  int32_t n = samples.size();
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (int32_t offset = 0; offset < n; offset += window_size) {
+    int32_t k = std::min(window_size, n - offset);
+    vad.AcceptWaveform(samples.data() + offset, k);
+    while (!vad.Empty()) {
+      mark(vad.Front());
+      vad.Pop();
+    }
+  }
+
+  vad.Flush();
+  while (!vad.Empty()) {
+    mark(vad.Front());
+    vad.Pop();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  r->elapsed_seconds +=
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count() /
+      1e6;
+
+  r->num_windows += vad.NumWindows();
+  r->num_skipped_windows += vad.NumSkippedWindows();
+
+  for (int32_t i = 0; i != num_frames; ++i) {
+    if (labels[i]) {
+      r->num_speech_frames += 1;
+      r->num_missed_frames += !detected[i];
+    } else {
+      r->num_non_speech_frames += 1;
+      r->num_false_alarm_frames += detected[i];
+    }
+  }
+}
+
+static void Print(const char *name, const Result &r, float audio_seconds) {
+  fprintf(stderr,
+          "%-10s time: %7.3f s, RTF: %.5f, skipped windows: %5.1f%%, "
+          "miss: %5.2f%%, false alarm: %5.2f%%\n",
+          name, r.elapsed_seconds, r.elapsed_seconds / audio_seconds,
+          100. * r.num_skipped_windows / std::max<int64_t>(r.num_windows, 1),
+          100. * r.num_missed_frames /
+              std::max<int64_t>(r.num_speech_frames, 1),
+          100. * r.num_false_alarm_frames /
+              std::max<int64_t>(r.num_non_speech_frames, 1));
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+This program measures the accuracy/CPU trade-off of --vad-pre-gate on a
+labeled set. Each wave file is processed twice: without and with the
+pre-gate. Speech segments are scored against the labels at a 10 ms
+resolution.
+
+  ./bin/sherpa-onnx-vad-pre-gate-benchmark \
+    --silero-vad-model=/path/to/silero_vad.onnx \
+    --vad-pre-gate-noise-db=-40 \
+    /path/to/a.wav /path/to/a.txt \
+    /path/to/b.wav /path/to/b.txt
+
+Each line of a label file is "start end" in seconds of a speech segment.
+Wave files should be 16kHz. The value of --vad-pre-gate is ignored.
+
+Please download silero_vad.onnx from
+https://github.com/snakers4/silero-vad/raw/master/src/silero_vad/data/silero_vad.onnx
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::VadModelConfig config;
+
+  config.Register(&po);
+  po.Read(argc, argv);
+  if (po.NumArgs() < 2 || po.NumArgs() % 2 != 0) {
+    fprintf(stderr, "Please provide pairs of wave files and label files\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  config.pre_gate.enabled = true;
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  sherpa_onnx::VadModelConfig baseline_config = config;
+  baseline_config.pre_gate.enabled = false;
+
+  Result baseline;
+  Result gated;
+  float audio_seconds = 0;
+
+  for (int32_t i = 1; i <= po.NumArgs(); i += 2) {
+    std::string wav_filename = po.GetArg(i);
+    std::string label_filename = po.GetArg(i + 1);
+
+    int32_t sampling_rate = 0;
+    bool is_ok = false;
+    auto samples = sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
+      return -1;
+    }
+
+    if (sampling_rate != config.sample_rate) {
+      fprintf(stderr, "Expect sample rate %d. Given: %d for '%s'\n",
+              config.sample_rate, sampling_rate, wav_filename.c_str());
+      return -1;
+    }
+
+    int32_t num_frames = samples.size() / kFrameShift;
+    auto labels =
+        ReadLabels(label_filename, sampling_rate, num_frames, &is_ok);
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", label_filename.c_str());
+      return -1;
+    }
+
+    audio_seconds += samples.size() / static_cast<float>(sampling_rate);
+
+    Run(baseline_config, samples, labels, &baseline);
+    Run(config, samples, labels, &gated);
+  }
+
+  fprintf(stderr, "Audio: %.3f s in %d files\n", audio_seconds,
+          po.NumArgs() / 2);
+  Print("baseline", baseline, audio_seconds);
+  Print("pre-gate", gated, audio_seconds);
+
+  fprintf(stderr, "Speedup: %.2fx\n",
+          baseline.elapsed_seconds / std::max(gated.elapsed_seconds, 1e-6f));
+
+  return 0;
+}
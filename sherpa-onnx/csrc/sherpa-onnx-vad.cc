@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <vector>
 
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
@@ -52,17 +53,15 @@ input.wav should be 16kHz.
   }
 
   std::string wav_filename = po.GetArg(1);
-  int32_t sampling_rate = -1;
+  sherpa_onnx::StreamingWaveReader reader(wav_filename);
 
-  bool is_ok = false;
-  std::vector<float> samples =
-      sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-
-  if (!is_ok) {
+  if (!reader.IsOk()) {
     fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
     return -1;
   }
 
+  int32_t sampling_rate = reader.SampleRate();
+
   if (sampling_rate != 16000) {
     fprintf(stderr, "Support only 16000Hz. Given: %d\n", sampling_rate);
     return -1;
@@ -71,16 +70,20 @@ input.wav should be 16kHz.
   auto vad = std::make_unique<sherpa_onnx::VoiceActivityDetector>(config);
 
   int32_t window_size = config.silero_vad.window_size;
+  std::vector<float> samples(window_size);
 
-  int32_t i = 0;
   bool is_eof = false;
 
-  std::vector<float> samples_without_silence;
+  // Segments are appended to the output file as soon as they are detected
+  sherpa_onnx::WaveWriter writer;
+  if (!writer.Open(po.GetArg(2), sampling_rate)) {
+    return -1;
+  }
 
   while (!is_eof) {
-    if (i + window_size < samples.size()) {
-      vad->AcceptWaveform(samples.data() + i, window_size);
-      i += window_size;
+    if (reader.Tell() + window_size < reader.NumSamples()) {
+      reader.Read(window_size, samples.data());
+      vad->AcceptWaveform(samples.data(), window_size);
     } else {
       vad->Flush();
       is_eof = true;
@@ -93,16 +96,14 @@ input.wav should be 16kHz.
                                         static_cast<float>(sampling_rate);
 
       fprintf(stderr, "%.3f -- %.3f\n", start_time, end_time);
-      samples_without_silence.insert(samples_without_silence.end(),
-                                     segment.samples.begin(),
-                                     segment.samples.end());
+      writer.Write(segment.samples.data(), segment.samples.size());
       vad->Pop();
     }
   }
 
-  sherpa_onnx::WriteWave(po.GetArg(2), sampling_rate,
-                         samples_without_silence.data(),
-                         samples_without_silence.size());
+  if (!writer.Close()) {
+    return -1;
+  }
 
   fprintf(stderr, "Saved to %s\n", po.GetArg(2).c_str());
 
@@ -4,6 +4,8 @@
 
 #include "sherpa-onnx/csrc/silero-vad-model.h"
 
+#include <algorithm>
+#include <array>
 #include <string>
 #include <utility>
 #include <vector>
@@ -70,16 +72,9 @@ class SileroVadModel::Impl {
   }
 
   void Reset() {
-    if (is_v5_) {
-      ResetV5();
-    } else {
-      ResetV4();
-    }
+    ResetStates();
 
-    triggered_ = false;
-    current_sample_ = 0;
-    temp_start_ = 0;
-    temp_end_ = 0;
+    trigger_.Reset();
   }
 
   bool IsSpeech(const float *samples, int32_t n) {
@@ -90,68 +85,19 @@ class SileroVadModel::Impl {
 
     float prob = Run(samples, n);
 
-    float threshold = config_.silero_vad.threshold;
-
-    current_sample_ += config_.silero_vad.window_size;
-
-    if (prob > threshold && temp_end_ != 0) {
-      temp_end_ = 0;
-    }
-
-    if (prob > threshold && temp_start_ == 0) {
-      // start speaking, but we require that it must satisfy
-      // min_speech_duration
-      temp_start_ = current_sample_;
-      return false;
-    }
-
-    if (prob > threshold && temp_start_ != 0 && !triggered_) {
-      if (current_sample_ - temp_start_ < min_speech_samples_) {
-        return false;
-      }
-
-      triggered_ = true;
-
-      return true;
-    }
-
-    if ((prob < threshold) && !triggered_) {
-      // silence
-      temp_start_ = 0;
-      temp_end_ = 0;
-      return false;
-    }
-
-    if ((prob > threshold - 0.15) && triggered_) {
-      // speaking
-      return true;
-    }
-
-    if ((prob > threshold) && !triggered_) {
-      // start speaking
-      triggered_ = true;
-
-      return true;
-    }
-
-    if ((prob < threshold) && triggered_) {
-      // stop to speak
-      if (temp_end_ == 0) {
-        temp_end_ = current_sample_;
-      }
+    return trigger_.Update(prob, config_.silero_vad.threshold,
+                           config_.silero_vad.window_size, min_speech_samples_,
+                           min_silence_samples_);
+  }
 
-      if (current_sample_ - temp_end_ < min_silence_samples_) {
-        // continue speaking
-        return true;
-      }
-      // stopped speaking
-      temp_start_ = 0;
-      temp_end_ = 0;
-      triggered_ = false;
-      return false;
+  bool SkipWindow(bool reset_states) {
+    if (reset_states) {
+      ResetStates();
     }
 
-    return false;
+    return trigger_.Update(0, config_.silero_vad.threshold,
+                           config_.silero_vad.window_size, min_speech_samples_,
+                           min_silence_samples_);
   }
 
   int32_t WindowShift() const { return config_.silero_vad.window_size; }
@@ -172,6 +118,84 @@ class SileroVadModel::Impl {
     config_.silero_vad.threshold = threshold;
   }
 
+  // v5: state of shape (2, batch_size, 128)
+  // v4: h and c, each of shape (2, batch_size, 64)
+  int32_t StateSize() const { return NumStateTensors() * 2 * HiddenDim(); }
+
+  void RunBatch(const float *samples, int32_t batch_size,
+                float *const *states, float *probs) const {
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    int32_t n = WindowSize();
+    int32_t hidden_dim = HiddenDim();
+    int32_t num_state_tensors = NumStateTensors();
+
+    std::array<int64_t, 2> x_shape = {batch_size, n};
+
+    Ort::Value x = Ort::Value::CreateTensor(
+        memory_info, const_cast<float *>(samples), batch_size * n,
+        x_shape.data(), x_shape.size());
+
+    int64_t sample_rate = sample_rate_;
+    int64_t sr_shape = 1;
+    Ort::Value sr =
+        Ort::Value::CreateTensor(memory_info, &sample_rate, 1, &sr_shape, 1);
+
+    // Stack the states of all streams. The i-th stream uses
+    // states[i][(t * 2 + layer) * hidden_dim + d] for tensor t.
+    std::array<int64_t, 3> s_shape = {2, batch_size, hidden_dim};
+    std::vector<std::vector<float>> buf(num_state_tensors);
+    std::vector<Ort::Value> s;
+    s.reserve(num_state_tensors);
+
+    for (int32_t t = 0; t != num_state_tensors; ++t) {
+      buf[t].resize(2 * batch_size * hidden_dim);
+      for (int32_t layer = 0; layer != 2; ++layer) {
+        for (int32_t b = 0; b != batch_size; ++b) {
+          const float *src = states[b] + (t * 2 + layer) * hidden_dim;
+          std::copy(src, src + hidden_dim,
+                    buf[t].data() + (layer * batch_size + b) * hidden_dim);
+        }
+      }
+
+      s.push_back(Ort::Value::CreateTensor(memory_info, buf[t].data(),
+                                           buf[t].size(), s_shape.data(),
+                                           s_shape.size()));
+    }
+
+    std::vector<Ort::Value> inputs;
+    inputs.reserve(input_names_.size());
+    inputs.push_back(std::move(x));
+    if (is_v5_) {
+      inputs.push_back(std::move(s[0]));
+      inputs.push_back(std::move(sr));
+    } else {
+      inputs.push_back(std::move(sr));
+      inputs.push_back(std::move(s[0]));
+      inputs.push_back(std::move(s[1]));
+    }
+
+    auto out =
+        sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
+                   output_names_ptr_.data(), output_names_ptr_.size());
+
+    // out[0] is of shape (batch_size, 1)
+    const float *p = out[0].GetTensorData<float>();
+    std::copy(p, p + batch_size, probs);
+
+    for (int32_t t = 0; t != num_state_tensors; ++t) {
+      const float *src = out[t + 1].GetTensorData<float>();
+      for (int32_t layer = 0; layer != 2; ++layer) {
+        for (int32_t b = 0; b != batch_size; ++b) {
+          const float *q = src + (layer * batch_size + b) * hidden_dim;
+          std::copy(q, q + hidden_dim,
+                    states[b] + (t * 2 + layer) * hidden_dim);
+        }
+      }
+    }
+  }
+
  private:
   void Init(void *model_data, size_t model_data_length) {
     sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
@@ -204,6 +228,18 @@ class SileroVadModel::Impl {
     Reset();
   }
 
+  int32_t HiddenDim() const { return is_v5_ ? 128 : 64; }
+
+  int32_t NumStateTensors() const { return is_v5_ ? 1 : 2; }
+
+  void ResetStates() {
+    if (is_v5_) {
+      ResetV5();
+    } else {
+      ResetV4();
+    }
+  }
+
   void ResetV5() {
     // 2 - number of LSTM layer
     // 1 - batch size
@@ -428,16 +464,86 @@ class SileroVadModel::Impl {
   int32_t min_silence_samples_;
   int32_t min_speech_samples_;
 
-  bool triggered_ = false;
-  int32_t current_sample_ = 0;
-  int32_t temp_start_ = 0;
-  int32_t temp_end_ = 0;
+  SileroVadTrigger trigger_;
 
   int32_t window_overlap_ = 0;
 
   bool is_v5_ = false;
 };
 
+bool SileroVadTrigger::Update(float prob, float threshold,
+                              int32_t window_shift,
+                              int32_t min_speech_samples,
+                              int32_t min_silence_samples) {
+  current_sample_ += window_shift;
+
+  if (prob > threshold && temp_end_ != 0) {
+    temp_end_ = 0;
+  }
+
+  if (prob > threshold && temp_start_ == 0) {
+    // start speaking, but we require that it must satisfy
+    // min_speech_duration
+    temp_start_ = current_sample_;
+    return false;
+  }
+
+  if (prob > threshold && temp_start_ != 0 && !triggered_) {
+    if (current_sample_ - temp_start_ < min_speech_samples) {
+      return false;
+    }
+
+    triggered_ = true;
+
+    return true;
+  }
+
+  if ((prob < threshold) && !triggered_) {
+    // silence
+    temp_start_ = 0;
+    temp_end_ = 0;
+    return false;
+  }
+
+  if ((prob > threshold - 0.15) && triggered_) {
+    // speaking
+    return true;
+  }
+
+  if ((prob > threshold) && !triggered_) {
+    // start speaking
+    triggered_ = true;
+
+    return true;
+  }
+
+  if ((prob < threshold) && triggered_) {
+    // stop to speak
+    if (temp_end_ == 0) {
+      temp_end_ = current_sample_;
+    }
+
+    if (current_sample_ - temp_end_ < min_silence_samples) {
+      // continue speaking
+      return true;
+    }
+    // stopped speaking
+    temp_start_ = 0;
+    temp_end_ = 0;
+    triggered_ = false;
+    return false;
+  }
+
+  return false;
+}
+
+void SileroVadTrigger::Reset() {
+  triggered_ = false;
+  current_sample_ = 0;
+  temp_start_ = 0;
+  temp_end_ = 0;
+}
+
 SileroVadModel::SileroVadModel(const VadModelConfig &config)
     : impl_(std::make_unique<Impl>(config)) {}
 
@@ -453,6 +559,10 @@ bool SileroVadModel::IsSpeech(const float *samples, int32_t n) {
   return impl_->IsSpeech(samples, n);
 }
 
+bool SileroVadModel::SkipWindow(bool reset_states) {
+  return impl_->SkipWindow(reset_states);
+}
+
 int32_t SileroVadModel::WindowSize() const { return impl_->WindowSize(); }
 
 int32_t SileroVadModel::WindowShift() const { return impl_->WindowShift(); }
@@ -473,6 +583,13 @@ void SileroVadModel::SetThreshold(float threshold) {
   impl_->SetThreshold(threshold);
 }
 
+int32_t SileroVadModel::StateSize() const { return impl_->StateSize(); }
+
+void SileroVadModel::RunBatch(const float *samples, int32_t batch_size,
+                              float *const *states, float *probs) const {
+  impl_->RunBatch(samples, batch_size, states, probs);
+}
+
 #if __ANDROID_API__ >= 9
 template SileroVadModel::SileroVadModel(AAssetManager *mgr,
                                         const VadModelConfig &config);
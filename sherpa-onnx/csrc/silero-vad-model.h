@@ -10,6 +10,32 @@
 
 namespace sherpa_onnx {
 
+// It converts the speech probability of each window into a speech/non-speech
+// decision, requiring min_speech_samples of speech to start a segment and
+// min_silence_samples of silence to end it.
+class SileroVadTrigger {
+ public:
+  /**
+   * @param prob Speech probability of the current window.
+   * @param threshold Windows with prob above it are considered as speech.
+   * @param window_shift Number of samples the window has moved.
+   * @param min_speech_samples Minimum speech duration in samples.
+   * @param min_silence_samples Minimum silence duration in samples.
+   *
+   * @return Return true if speech is detected. Return false otherwise.
+   */
+  bool Update(float prob, float threshold, int32_t window_shift,
+              int32_t min_speech_samples, int32_t min_silence_samples);
+
+  void Reset();
+
+ private:
+  bool triggered_ = false;
+  int32_t current_sample_ = 0;
+  int32_t temp_start_ = 0;
+  int32_t temp_end_ = 0;
+};
+
 class SileroVadModel : public VadModel {
  public:
   explicit SileroVadModel(const VadModelConfig &config);
@@ -31,6 +57,8 @@ class SileroVadModel : public VadModel {
    */
   bool IsSpeech(const float *samples, int32_t n) override;
 
+  bool SkipWindow(bool reset_states) override;
+
   // For silero vad V4, it is WindowShift().
   // For silero vad V5, it is WindowShift()+64 for 16kHz and
   //                          WindowShift()+32 for 8kHz
@@ -45,6 +73,27 @@ class SileroVadModel : public VadModel {
   void SetMinSilenceDuration(float s) override;
   void SetThreshold(float threshold) override;
 
+  // Number of floats in the recurrent states of one stream
+  int32_t StateSize() const;
+
+  /**
+   * Run the model on windows from independent streams in a single batch.
+   *
+   * Unlike IsSpeech(), it neither uses nor changes the internal states of
+   * this object, so it can be called from multiple threads.
+   *
+   * @param samples Pointer to a 2-d array of shape
+   *                (batch_size, WindowSize()).
+   * @param batch_size Number of streams.
+   * @param states states[i] points to StateSize() floats containing the
+   *               states of the i-th stream. They are updated in place.
+   *               Use zeros for a new stream.
+   * @param probs On return, probs[i] contains the speech probability of
+   *              the window of the i-th stream.
+   */
+  void RunBatch(const float *samples, int32_t batch_size,
+                float *const *states, float *probs) const;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
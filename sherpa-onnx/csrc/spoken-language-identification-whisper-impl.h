@@ -6,6 +6,7 @@
 #define SHERPA_ONNX_CSRC_SPOKEN_LANGUAGE_IDENTIFICATION_WHISPER_IMPL_H_
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -16,6 +17,7 @@
 #include "android/asset_manager_jni.h"
 #endif
 
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-whisper-model.h"
 #include "sherpa-onnx/csrc/spoken-language-identification-impl.h"
 #include "sherpa-onnx/csrc/transpose.h"
@@ -45,23 +47,18 @@ class SpokenLanguageIdentificationWhisperImpl
   }
 
   std::string Compute(OfflineStream *s) const override {
-    int32_t max_num_frames = 3000;
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-    int32_t feat_dim = s->FeatureDim();
-    std::vector<float> f = s->GetFrames();
-    int32_t num_frames = f.size() / feat_dim;
+    return ComputeBatch(&s, 1)[0];
+  }
 
-    // we use 50 here so that there will be some zero tail paddings
-    if (num_frames >= max_num_frames - 50) {
-      SHERPA_ONNX_LOGE(
-          "Only waves less than 30 seconds are supported. We process only the "
-          "first 30 seconds and discard the remaining data");
-      num_frames = max_num_frames - 50;
+  std::vector<std::string> ComputeBatch(OfflineStream **ss,
+                                        int32_t n) const override {
+    if (n <= 0) {
+      return {};
     }
 
-    model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
+    int32_t max_num_frames = 3000;
+
+    int32_t feat_dim = ss[0]->FeatureDim();
 
     // note that 1000 is an experience-value.
     // You can replace 1000 by other values, say, 100.
@@ -69,37 +66,67 @@ class SpokenLanguageIdentificationWhisperImpl
     // Since we have removed the 30 seconds constraint, we need
     // tail_padding_frames so that whisper is able to detect the eot token.
     int32_t tail_padding_frames = 1000;
-
     if (config_.whisper.tail_paddings > 0) {
       tail_padding_frames = config_.whisper.tail_paddings;
     }
 
-    int32_t actual_frames =
-        std::min(num_frames + tail_padding_frames, max_num_frames);
+    std::vector<std::vector<float>> features(n);
+    std::vector<int32_t> num_frames(n);
+    int32_t actual_frames = 0;
+
+    for (int32_t i = 0; i != n; ++i) {
+      features[i] = ss[i]->GetFrames();
+      num_frames[i] = features[i].size() / feat_dim;
+
+      // we use 50 here so that there will be some zero tail paddings
+      if (num_frames[i] >= max_num_frames - 50) {
+        SHERPA_ONNX_LOGE(
+            "Only waves less than 30 seconds are supported. We process only "
+            "the first 30 seconds and discard the remaining data");
+        num_frames[i] = max_num_frames - 50;
+      }
 
-    std::array<int64_t, 3> shape{1, actual_frames, feat_dim};
+      model_->NormalizeFeatures(features[i].data(), num_frames[i], feat_dim);
+
+      // Streams shorter than the longest one get more zero tail paddings
+      actual_frames =
+          std::max(actual_frames, std::min(num_frames[i] + tail_padding_frames,
+                                           max_num_frames));
+    }
+
+    std::array<int64_t, 3> shape{n, actual_frames, feat_dim};
 
     Ort::Value mel = Ort::Value::CreateTensor<float>(
         model_->Allocator(), shape.data(), shape.size());
 
     float *p_mel = mel.GetTensorMutableData<float>();
-    std::copy(f.data(), f.data() + num_frames * feat_dim, p_mel);
+    std::fill_n(p_mel, n * actual_frames * feat_dim, 0);
 
-    std::fill_n(p_mel + num_frames * feat_dim,
-                (actual_frames - num_frames) * feat_dim, 0);
+    for (int32_t i = 0; i != n; ++i) {
+      std::copy(features[i].data(),
+                features[i].data() + num_frames[i] * feat_dim,
+                p_mel + i * actual_frames * feat_dim);
+    }
 
     mel = Transpose12(model_->Allocator(), &mel);
 
+    std::vector<std::string> ans(n);
+
     try {
       auto cross_kv = model_->ForwardEncoder(std::move(mel));
-      int32_t lang_id = model_->DetectLanguage(cross_kv.first, cross_kv.second);
+
+      std::vector<int32_t> lang_ids =
+          model_->DetectLanguages(cross_kv.first, cross_kv.second);
+
       const auto &id2lang = model_->GetID2Lang();
-      if (id2lang.count(lang_id)) {
-        return id2lang.at(lang_id);
-      } else {
-        SHERPA_ONNX_LOGE("Unknown language ID: %d. Return an empty string.",
-                         lang_id);
-        return "";
+
+      for (int32_t i = 0; i != n; ++i) {
+        if (id2lang.count(lang_ids[i])) {
+          ans[i] = id2lang.at(lang_ids[i]);
+        } else {
+          SHERPA_ONNX_LOGE("Unknown language ID: %d. Return an empty string.",
+                           lang_ids[i]);
+        }
       }
     } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE(
@@ -107,9 +134,11 @@ class SpokenLanguageIdentificationWhisperImpl
           "input frames: %d, Current tail "
           "paddings: %d. If you see a lot of such exceptions, please consider "
           "using a larger --whisper-tail-paddings",
-          ex.what(), num_frames, tail_padding_frames);
-      return "";
+          ex.what(), *std::max_element(num_frames.begin(), num_frames.end()),
+          tail_padding_frames);
     }
+
+    return ans;
   }
 
  private:
@@ -5,6 +5,7 @@
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
 
 #include <string>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -127,4 +128,9 @@ std::string SpokenLanguageIdentification::Compute(OfflineStream *s) const {
   return impl_->Compute(s);
 }
 
+std::vector<std::string> SpokenLanguageIdentification::ComputeBatch(
+    OfflineStream **ss, int32_t n) const {
+  return impl_->ComputeBatch(ss, n);
+}
+
 }  // namespace sherpa_onnx
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -90,6 +91,12 @@ class SpokenLanguageIdentification {
   // Note: en is for English, zh is for Chinese, de is for German, etc.
   std::string Compute(OfflineStream *s) const;
 
+  // Identify the languages of n streams with a single batched inference.
+  // Shorter streams are padded with zeros to the longest one, so the
+  // results may differ slightly from those of Compute(). Return an empty
+  // vector if n <= 0.
+  std::vector<std::string> ComputeBatch(OfflineStream **ss, int32_t n) const;
+
  private:
   std::unique_ptr<SpokenLanguageIdentificationImpl> impl_;
 };
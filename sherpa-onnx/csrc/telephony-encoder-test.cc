@@ -0,0 +1,225 @@
+// sherpa-onnx/csrc/telephony-encoder-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/telephony-encoder.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+#include "sherpa-onnx/csrc/wave-writer.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> GenerateSignal(int32_t num_samples) {
+  std::mt19937 gen(20250102);
+  std::uniform_real_distribution<float> dist(-1.2, 1.2);
+
+  std::vector<float> x(num_samples);
+  for (auto &f : x) {
+    f = dist(gen);
+  }
+
+  return x;
+}
+
+TEST(TelephonyEncoder, Pcm16MatchesScalar) {
+  // not a multiple of 8 so that the scalar tail is exercised
+  auto x = GenerateSignal(1003);
+
+  std::vector<int16_t> y(x.size());
+  FloatToPcm16(x.data(), x.size(), y.data());
+
+  for (size_t i = 0; i != x.size(); ++i) {
+    float f = std::max(-1.0f, std::min(1.0f, x[i]));
+    EXPECT_EQ(y[i], static_cast<int16_t>(std::lrint(f * 32767))) << i;
+  }
+}
+
+TEST(TelephonyEncoder, G711) {
+  float zero = 0;
+  uint8_t u = 0;
+  uint8_t a = 0;
+
+  FloatToMulaw(&zero, 1, &u);
+  FloatToAlaw(&zero, 1, &a);
+
+  EXPECT_EQ(u, 0xFF);
+  EXPECT_EQ(a, 0xD5);
+
+  // Decoding every code word and encoding it again is lossless
+  for (int32_t i = 0; i != 256; ++i) {
+    float f = MulawToPcm16(i) / 32767.0f;
+    FloatToMulaw(&f, 1, &u);
+    EXPECT_EQ(MulawToPcm16(u), MulawToPcm16(i)) << i;
+
+    f = AlawToPcm16(i) / 32767.0f;
+    FloatToAlaw(&f, 1, &a);
+    EXPECT_EQ(a, i) << i;
+  }
+
+  // The quantization error is bounded by half of the largest step
+  auto x = GenerateSignal(10000);
+  std::vector<uint8_t> ux(x.size());
+  std::vector<uint8_t> ax(x.size());
+  FloatToMulaw(x.data(), x.size(), ux.data());
+  FloatToAlaw(x.data(), x.size(), ax.data());
+
+  for (size_t i = 0; i != x.size(); ++i) {
+    float f = std::max(-1.0f, std::min(1.0f, x[i])) * 32767;
+    EXPECT_LE(std::fabs(MulawToPcm16(ux[i]) - f), 1100) << i;
+    EXPECT_LE(std::fabs(AlawToPcm16(ax[i]) - f), 1100) << i;
+  }
+}
+
+TEST(TelephonyEncoder, Frames) {
+  TelephonyEncoderConfig config(8000, "mulaw", 20, true);
+  TelephonyEncoder encoder(22050, config);
+  EXPECT_EQ(encoder.FrameSize(), 160);
+  EXPECT_EQ(encoder.FrameBytes(), 160);
+
+  auto x = GenerateSignal(22050);
+
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int32_t> piece_size(1, 5000);
+
+  int32_t num_bytes = 0;
+  auto callback = [&num_bytes](const uint8_t * /*data*/, int32_t n) {
+    EXPECT_EQ(n, 160);
+    num_bytes += n;
+    return 1;
+  };
+
+  int32_t offset = 0;
+  while (offset < static_cast<int32_t>(x.size())) {
+    int32_t n = std::min<int32_t>(piece_size(gen), x.size() - offset);
+    encoder.Accept(x.data() + offset, n, callback);
+    offset += n;
+  }
+  encoder.Flush(callback);
+
+  // 1 second at 8 kHz is exactly 50 frames
+  EXPECT_EQ(encoder.NumFrames(), 50);
+  EXPECT_EQ(num_bytes, 8000);
+}
+
+TEST(TelephonyEncoder, Stop) {
+  TelephonyEncoderConfig config(0, "pcm16", 10, true);
+  TelephonyEncoder encoder(16000, config);
+
+  auto x = GenerateSignal(16000);
+
+  int32_t num_calls = 0;
+  int32_t ok = encoder.Accept(x.data(), x.size(),
+                              [&num_calls](const uint8_t *, int32_t n) {
+                                EXPECT_EQ(n, 320);
+                                return ++num_calls < 3;
+                              });
+
+  EXPECT_EQ(ok, 0);
+  EXPECT_EQ(num_calls, 3);
+}
+
+TEST(WaveWriter, Streaming) {
+  auto x = GenerateSignal(16001);
+  for (auto &f : x) {
+    f *= 0.5;
+  }
+
+  std::string filename = "./telephony-encoder-test.wav";
+
+  WaveWriter writer;
+  ASSERT_TRUE(writer.Open(filename, 16000));
+  ASSERT_TRUE(writer.Write(x.data(), 1000));
+  ASSERT_TRUE(writer.Write(x.data() + 1000, x.size() - 1000));
+  EXPECT_EQ(writer.NumSamples(), static_cast<int64_t>(x.size()));
+  ASSERT_TRUE(writer.Close());
+
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  auto y = ReadWave(filename, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+  EXPECT_EQ(sample_rate, 16000);
+  ASSERT_EQ(y.size(), x.size());
+
+  for (size_t i = 0; i != x.size(); ++i) {
+    // ReadWave() divides by 32768 while we multiply by 32767
+    EXPECT_NEAR(y[i], x[i], 2.0 / 32767) << i;
+  }
+
+  // 58-byte header + 16001 bytes + 1 pad byte
+  ASSERT_TRUE(writer.Open(filename, 8000, AudioEncoding::kMulaw));
+  ASSERT_TRUE(writer.Write(x.data(), x.size()));
+  ASSERT_TRUE(writer.Close());
+
+  FILE *fp = fopen(filename.c_str(), "rb");
+  ASSERT_NE(fp, nullptr);
+  fseek(fp, 0, SEEK_END);
+  EXPECT_EQ(ftell(fp), 58 + 16001 + 1);
+  fclose(fp);
+
+  // Two channels
+  std::vector<float> x1(x.rbegin(), x.rend());
+  ASSERT_TRUE(writer.Open(filename, 16000, AudioEncoding::kPcm16, 2));
+  EXPECT_FALSE(writer.Write(x.data(), x.size()));
+  ASSERT_TRUE(writer.Write(x.data(), x1.data(), 5000));
+  ASSERT_TRUE(
+      writer.Write(x.data() + 5000, x1.data() + 5000, x.size() - 5000));
+  EXPECT_EQ(writer.NumSamples(), static_cast<int64_t>(x.size()));
+  ASSERT_TRUE(writer.Close());
+
+  auto channels = ReadWaveMultiChannel(filename, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+  EXPECT_EQ(sample_rate, 16000);
+  ASSERT_EQ(channels.size(), 2u);
+  ASSERT_EQ(channels[0].size(), x.size());
+  ASSERT_EQ(channels[1].size(), x.size());
+
+  for (size_t i = 0; i != x.size(); ++i) {
+    EXPECT_NEAR(channels[0][i], x[i], 2.0 / 32767) << i;
+    EXPECT_NEAR(channels[1][i], x1[i], 2.0 / 32767) << i;
+  }
+
+  remove(filename.c_str());
+}
+
+TEST(TelephonyEncoder, Benchmark) {
+  // 60 seconds at 22050 Hz
+  auto x = GenerateSignal(60 * 22050);
+
+  const char *encodings[] = {"pcm16", "mulaw", "alaw"};
+  for (const char *e : encodings) {
+    TelephonyEncoderConfig config(8000, e, 20, true);
+    TelephonyEncoder encoder(22050, config);
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    // one callback of TTS every 0.5 seconds
+    int32_t chunk = 22050 / 2;
+    for (int32_t offset = 0; offset < static_cast<int32_t>(x.size());
+         offset += chunk) {
+      int32_t n = std::min<int32_t>(chunk, x.size() - offset);
+      encoder.Accept(x.data() + offset, n, nullptr);
+    }
+    encoder.Flush(nullptr);
+
+    const auto end = std::chrono::steady_clock::now();
+
+    float elapsed_seconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+            .count() /
+        1e6;
+
+    fprintf(stderr, "22050 -> 8000 %s: %.1fx real time\n", e,
+            60 / std::max(elapsed_seconds, 1e-6f));
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,401 @@
+// sherpa-onnx/csrc/telephony-encoder.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/telephony-encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHERPA_ONNX_TELEPHONY_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SHERPA_ONNX_TELEPHONY_NEON 1
+#endif
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+// The following G.711 routines follow the reference implementation
+// g711.c from Sun Microsystems, which is in the public domain.
+constexpr int32_t kMulawBias = 0x84;
+constexpr int32_t kMulawClip = 8159;
+
+int32_t Segment(int32_t val, const int32_t *table) {
+  for (int32_t i = 0; i != 8; ++i) {
+    if (val <= table[i]) {
+      return i;
+    }
+  }
+  return 8;
+}
+
+uint8_t Linear14ToMulaw(int32_t pcm_val) {
+  static const int32_t kSegEnd[8] = {0x3F,  0x7F,  0xFF,  0x1FF,
+                                     0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+  int32_t mask = 0xFF;
+  if (pcm_val < 0) {
+    pcm_val = -pcm_val;
+    mask = 0x7F;
+  }
+
+  pcm_val = std::min(pcm_val, kMulawClip);
+  pcm_val += (kMulawBias >> 2);
+
+  int32_t seg = Segment(pcm_val, kSegEnd);
+  if (seg >= 8) {
+    return 0x7F ^ mask;
+  }
+
+  int32_t uval = (seg << 4) | ((pcm_val >> (seg + 1)) & 0xF);
+  return uval ^ mask;
+}
+
+uint8_t Linear13ToAlaw(int32_t pcm_val) {
+  static const int32_t kSegEnd[8] = {0x1F, 0x3F,  0x7F,  0xFF,
+                                     0x1FF, 0x3FF, 0x7FF, 0xFFF};
+  int32_t mask = 0xD5;
+  if (pcm_val < 0) {
+    pcm_val = -pcm_val - 1;
+    mask = 0x55;
+  }
+
+  int32_t seg = Segment(pcm_val, kSegEnd);
+  if (seg >= 8) {
+    return 0x7F ^ mask;
+  }
+
+  int32_t aval = seg << 4;
+  if (seg < 2) {
+    aval |= (pcm_val >> 1) & 0xF;
+  } else {
+    aval |= (pcm_val >> seg) & 0xF;
+  }
+
+  return aval ^ mask;
+}
+
+// mu-law depends only on the upper 14 bits of a 16-bit sample and
+// A-law only on the upper 13 bits, so a lookup table replaces the
+// per-sample segment search.
+const uint8_t *MulawTable() {
+  static const std::array<uint8_t, 16384> table = [] {
+    std::array<uint8_t, 16384> t{};
+    for (int32_t i = 0; i != 16384; ++i) {
+      t[i] = Linear14ToMulaw(i - 8192);
+    }
+    return t;
+  }();
+  return table.data() + 8192;
+}
+
+const uint8_t *AlawTable() {
+  static const std::array<uint8_t, 8192> table = [] {
+    std::array<uint8_t, 8192> t{};
+    for (int32_t i = 0; i != 8192; ++i) {
+      t[i] = Linear13ToAlaw(i - 4096);
+    }
+    return t;
+  }();
+  return table.data() + 4096;
+}
+
+inline int16_t FloatToPcm16Scalar(float f) {
+  f = std::max(-1.0f, std::min(1.0f, f));
+  return static_cast<int16_t>(std::lrint(f * 32767));
+}
+
+// Number of samples converted to int16_t at a time before a table lookup
+constexpr int32_t kBlockSize = 256;
+
+template <int32_t Shift>
+void FloatToG711(const float *in, int32_t n, const uint8_t *table,
+                 uint8_t *out) {
+  int16_t buf[kBlockSize];
+  for (int32_t i = 0; i < n; i += kBlockSize) {
+    int32_t m = std::min(kBlockSize, n - i);
+    FloatToPcm16(in + i, m, buf);
+    for (int32_t k = 0; k != m; ++k) {
+      out[i + k] = table[buf[k] >> Shift];
+    }
+  }
+}
+
+}  // namespace
+
+bool StringToAudioEncoding(const std::string &s, AudioEncoding *encoding) {
+  if (s == "pcm16" || s == "pcm" || s == "s16le") {
+    *encoding = AudioEncoding::kPcm16;
+  } else if (s == "mulaw" || s == "ulaw" || s == "pcmu") {
+    *encoding = AudioEncoding::kMulaw;
+  } else if (s == "alaw" || s == "pcma") {
+    *encoding = AudioEncoding::kAlaw;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+const char *AudioEncodingToString(AudioEncoding encoding) {
+  switch (encoding) {
+    case AudioEncoding::kPcm16:
+      return "pcm16";
+    case AudioEncoding::kMulaw:
+      return "mulaw";
+    case AudioEncoding::kAlaw:
+      return "alaw";
+  }
+  return "unknown";
+}
+
+void FloatToPcm16(const float *in, int32_t n, int16_t *out) {
+  int32_t i = 0;
+#if defined(SHERPA_ONNX_TELEPHONY_SSE2)
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  const __m128 hi = _mm_set1_ps(1.0f);
+  for (; i + 8 <= n; i += 8) {
+    __m128 a = _mm_loadu_ps(in + i);
+    __m128 b = _mm_loadu_ps(in + i + 4);
+    a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, lo), hi), scale);
+    b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, lo), hi), scale);
+    __m128i r = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), r);
+  }
+#elif defined(SHERPA_ONNX_TELEPHONY_NEON)
+  const float32x4_t lo = vdupq_n_f32(-1.0f);
+  const float32x4_t hi = vdupq_n_f32(1.0f);
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t a = vld1q_f32(in + i);
+    float32x4_t b = vld1q_f32(in + i + 4);
+    a = vmulq_n_f32(vminq_f32(vmaxq_f32(a, lo), hi), 32767.0f);
+    b = vmulq_n_f32(vminq_f32(vmaxq_f32(b, lo), hi), 32767.0f);
+    int16x4_t ra = vqmovn_s32(vcvtnq_s32_f32(a));
+    int16x4_t rb = vqmovn_s32(vcvtnq_s32_f32(b));
+    vst1q_s16(out + i, vcombine_s16(ra, rb));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = FloatToPcm16Scalar(in[i]);
+  }
+}
+
+void FloatToMulaw(const float *in, int32_t n, uint8_t *out) {
+  FloatToG711<2>(in, n, MulawTable(), out);
+}
+
+void FloatToAlaw(const float *in, int32_t n, uint8_t *out) {
+  FloatToG711<3>(in, n, AlawTable(), out);
+}
+
+int16_t MulawToPcm16(uint8_t u) {
+  u = ~u;
+  int32_t t = ((u & 0xF) << 3) + kMulawBias;
+  t <<= (u & 0x70) >> 4;
+  return (u & 0x80) ? (kMulawBias - t) : (t - kMulawBias);
+}
+
+int16_t AlawToPcm16(uint8_t a) {
+  a ^= 0x55;
+  int32_t t = (a & 0xF) << 4;
+  int32_t seg = (a & 0x70) >> 4;
+  switch (seg) {
+    case 0:
+      t += 8;
+      break;
+    case 1:
+      t += 0x108;
+      break;
+    default:
+      t += 0x108;
+      t <<= seg - 1;
+  }
+  return (a & 0x80) ? t : -t;
+}
+
+void EncodeAudio(AudioEncoding encoding, const float *in, int32_t n,
+                 uint8_t *out) {
+  switch (encoding) {
+    case AudioEncoding::kPcm16:
+      // Note: We assume little endian here
+      FloatToPcm16(in, n, reinterpret_cast<int16_t *>(out));
+      break;
+    case AudioEncoding::kMulaw:
+      FloatToMulaw(in, n, out);
+      break;
+    case AudioEncoding::kAlaw:
+      FloatToAlaw(in, n, out);
+      break;
+  }
+}
+
+void TelephonyEncoderConfig::Register(ParseOptions *po) {
+  po->Register("output-sample-rate", &sample_rate,
+               "Sample rate of the encoded audio. 0 means to use the sample "
+               "rate of the model");
+
+  po->Register("output-encoding", &encoding,
+               "Encoding of the output audio. Valid values: pcm16, mulaw, "
+               "alaw");
+
+  po->Register("output-frame-ms", &frame_ms,
+               "Duration in milliseconds of each output frame");
+
+  po->Register("output-pad-last-frame", &pad_last_frame,
+               "true to pad the last frame with silence so that all frames "
+               "have the same size");
+}
+
+bool TelephonyEncoderConfig::Validate() const {
+  AudioEncoding e;
+  if (!StringToAudioEncoding(encoding, &e)) {
+    SHERPA_ONNX_LOGE("Unsupported encoding: '%s'", encoding.c_str());
+    return false;
+  }
+
+  if (sample_rate < 0) {
+    SHERPA_ONNX_LOGE("sample_rate should be >= 0. Given: %d", sample_rate);
+    return false;
+  }
+
+  if (frame_ms <= 0) {
+    SHERPA_ONNX_LOGE("frame_ms should be positive. Given: %d", frame_ms);
+    return false;
+  }
+
+  return true;
+}
+
+std::string TelephonyEncoderConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "TelephonyEncoderConfig(";
+  os << "sample_rate=" << sample_rate << ", ";
+  os << "encoding=\"" << encoding << "\", ";
+  os << "frame_ms=" << frame_ms << ", ";
+  os << "pad_last_frame=" << (pad_last_frame ? "True" : "False") << ")";
+
+  return os.str();
+}
+
+TelephonyEncoder::TelephonyEncoder(int32_t input_sample_rate,
+                                   const TelephonyEncoderConfig &config)
+    : sample_rate_(config.sample_rate > 0 ? config.sample_rate
+                                          : input_sample_rate),
+      pad_last_frame_(config.pad_last_frame) {
+  if (!StringToAudioEncoding(config.encoding, &encoding_)) {
+    SHERPA_ONNX_LOGE("Unsupported encoding: '%s'", config.encoding.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  frame_size_ = std::max<int32_t>(
+      1, static_cast<int64_t>(sample_rate_) * config.frame_ms / 1000);
+
+  if (sample_rate_ != input_sample_rate) {
+    float min_freq = std::min(input_sample_rate, sample_rate_);
+    float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+
+    int32_t lowpass_filter_width = 6;
+    resampler_ = std::make_unique<LinearResample>(
+        input_sample_rate, sample_rate_, lowpass_cutoff, lowpass_filter_width);
+  }
+
+  pending_.resize(frame_size_);
+  bytes_.resize(FrameBytes());
+}
+
+int32_t TelephonyEncoder::Accept(const float *samples, int32_t n,
+                                 const EncodedFrameCallback &callback) {
+  if (!resampler_) {
+    return Consume(samples, n, callback);
+  }
+
+  resampled_.resize(resampler_->NumOutputSamples(n, false));
+  int32_t k = resampler_->Resample(samples, n, false, resampled_.data());
+
+  return Consume(resampled_.data(), k, callback);
+}
+
+int32_t TelephonyEncoder::Flush(const EncodedFrameCallback &callback) {
+  int32_t ok = 1;
+
+  if (resampler_) {
+    resampled_.resize(resampler_->NumOutputSamples(0, true));
+    int32_t k = resampler_->Resample(nullptr, 0, true, resampled_.data());
+    ok = Consume(resampled_.data(), k, callback);
+  }
+
+  if (ok && num_pending_ > 0) {
+    int32_t n = num_pending_;
+    if (pad_last_frame_) {
+      std::fill(pending_.begin() + num_pending_, pending_.end(), 0);
+      n = frame_size_;
+    }
+    ok = EmitFrame(pending_.data(), n, callback);
+  }
+
+  num_pending_ = 0;
+  if (resampler_) {
+    resampler_->Reset();
+  }
+
+  return ok;
+}
+
+int32_t TelephonyEncoder::Consume(const float *samples, int32_t n,
+                                  const EncodedFrameCallback &callback) {
+  int32_t i = 0;
+
+  if (num_pending_ > 0) {
+    int32_t m = std::min(frame_size_ - num_pending_, n);
+    std::copy(samples, samples + m, pending_.begin() + num_pending_);
+    num_pending_ += m;
+    i = m;
+
+    if (num_pending_ < frame_size_) {
+      return 1;
+    }
+
+    num_pending_ = 0;
+    if (!EmitFrame(pending_.data(), frame_size_, callback)) {
+      return 0;
+    }
+  }
+
+  // Encode whole frames directly from the input without copying
+  for (; i + frame_size_ <= n; i += frame_size_) {
+    if (!EmitFrame(samples + i, frame_size_, callback)) {
+      return 0;
+    }
+  }
+
+  std::copy(samples + i, samples + n, pending_.begin());
+  num_pending_ = n - i;
+
+  return 1;
+}
+
+int32_t TelephonyEncoder::EmitFrame(const float *samples, int32_t n,
+                                    const EncodedFrameCallback &callback) {
+  EncodeAudio(encoding_, samples, n, bytes_.data());
+  ++num_frames_;
+
+  if (!callback) {
+    return 1;
+  }
+
+  return callback(bytes_.data(), n * BytesPerSample(encoding_));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,148 @@
+// sherpa-onnx/csrc/telephony-encoder.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_TELEPHONY_ENCODER_H_
+#define SHERPA_ONNX_CSRC_TELEPHONY_ENCODER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/resample.h"
+
+namespace sherpa_onnx {
+
+enum class AudioEncoding : int32_t {
+  kPcm16 = 0,  // 16-bit signed little-endian linear PCM
+  kMulaw = 1,  // G.711 mu-law, 8 bits per sample
+  kAlaw = 2,   // G.711 A-law, 8 bits per sample
+};
+
+// Return false if `s` is not one of "pcm16", "mulaw", "alaw"
+bool StringToAudioEncoding(const std::string &s, AudioEncoding *encoding);
+
+const char *AudioEncodingToString(AudioEncoding encoding);
+
+inline int32_t BytesPerSample(AudioEncoding encoding) {
+  return encoding == AudioEncoding::kPcm16 ? 2 : 1;
+}
+
+// Convert float samples in the range [-1, 1] to int16_t.
+// Values out of range are clipped.
+void FloatToPcm16(const float *in, int32_t n, int16_t *out);
+
+// Convert float samples in the range [-1, 1] to G.711 mu-law/A-law.
+void FloatToMulaw(const float *in, int32_t n, uint8_t *out);
+void FloatToAlaw(const float *in, int32_t n, uint8_t *out);
+
+int16_t MulawToPcm16(uint8_t u);
+int16_t AlawToPcm16(uint8_t a);
+
+// Encode n samples. `out` must have room for n * BytesPerSample(encoding)
+// bytes. For kPcm16, the output is in little-endian byte order.
+void EncodeAudio(AudioEncoding encoding, const float *in, int32_t n,
+                 uint8_t *out);
+
+struct TelephonyEncoderConfig {
+  // Sample rate of the encoded output. 0 means to use the input sample rate.
+  int32_t sample_rate = 8000;
+
+  // pcm16, mulaw, or alaw
+  std::string encoding = "mulaw";
+
+  // Duration of each output frame in milliseconds.
+  int32_t frame_ms = 20;
+
+  // If true, the last frame is padded with silence so that every frame
+  // has the same size. Otherwise, the last frame may be shorter.
+  bool pad_last_frame = true;
+
+  TelephonyEncoderConfig() = default;
+
+  TelephonyEncoderConfig(int32_t sample_rate, const std::string &encoding,
+                         int32_t frame_ms, bool pad_last_frame)
+      : sample_rate(sample_rate),
+        encoding(encoding),
+        frame_ms(frame_ms),
+        pad_last_frame(pad_last_frame) {}
+
+  void Register(ParseOptions *po);
+
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+// Called with one encoded frame of n bytes.
+// If it returns 0, the caller should stop feeding samples.
+using EncodedFrameCallback =
+    std::function<int32_t(const uint8_t * /*data*/, int32_t /*n*/)>;
+
+// Converts a stream of float samples into fixed-size encoded frames,
+// e.g., 20 ms of 8 kHz mu-law for a SIP/RTP leg.
+//
+// Samples are resampled incrementally, so only one frame of audio is
+// buffered between calls to Accept().
+class TelephonyEncoder {
+ public:
+  TelephonyEncoder(int32_t input_sample_rate,
+                   const TelephonyEncoderConfig &config);
+
+  // Feed n samples. The callback is invoked for each complete frame.
+  //
+  // @return Return 0 if the callback asks to stop; return 1 otherwise.
+  int32_t Accept(const float *samples, int32_t n,
+                 const EncodedFrameCallback &callback);
+
+  // Flush the resampler and emit the last, possibly partial, frame.
+  // The encoder can be reused for a new stream after this call.
+  int32_t Flush(const EncodedFrameCallback &callback);
+
+  // Number of samples per frame
+  int32_t FrameSize() const { return frame_size_; }
+
+  // Number of bytes per frame
+  int32_t FrameBytes() const { return frame_size_ * BytesPerSample(encoding_); }
+
+  int32_t SampleRate() const { return sample_rate_; }
+
+  AudioEncoding Encoding() const { return encoding_; }
+
+  // Number of frames emitted so far
+  int64_t NumFrames() const { return num_frames_; }
+
+ private:
+  int32_t Consume(const float *samples, int32_t n,
+                  const EncodedFrameCallback &callback);
+
+  int32_t EmitFrame(const float *samples, int32_t n,
+                    const EncodedFrameCallback &callback);
+
+ private:
+  AudioEncoding encoding_ = AudioEncoding::kMulaw;
+  int32_t sample_rate_ = 0;
+  int32_t frame_size_ = 0;
+  bool pad_last_frame_ = true;
+
+  std::unique_ptr<LinearResample> resampler_;
+
+  // output of the resampler; reused across calls
+  std::vector<float> resampled_;
+
+  // a partially filled frame
+  std::vector<float> pending_;
+  int32_t num_pending_ = 0;
+
+  // encoded bytes of one frame
+  std::vector<uint8_t> bytes_;
+
+  int64_t num_frames_ = 0;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_TELEPHONY_ENCODER_H_
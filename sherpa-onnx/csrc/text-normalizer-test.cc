@@ -0,0 +1,86 @@
+// sherpa-onnx/csrc/text-normalizer-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/text-normalizer.h"
+
+#include <regex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+static const std::vector<std::string> kTexts = {
+    "",
+    "   ",
+    "Hello,  world!\tHow are you?\n",
+    "中英文混合：你好、世界；Hello World。真的吗？是的！",
+    "今天是2025年1月8日，天气：晴。  Let's  go!",
+    "ﾟ𝕏😀 emoji 和 CJK 扩展字符𠀀。",
+    "The quick brown fox: jumps over the lazy dog；谢谢",
+};
+
+static const std::vector<std::pair<std::string, std::string>> kReplacements =
+    {
+        {"，", ","}, {":", ","},  {"、", ","}, {"；", ";"},
+        {"：", ":"}, {"。", "."}, {"？", "?"}, {"！", "!"},
+};
+
+// What KokoroMultiLangLexicon did with std::regex
+static std::string RegexNormalize(std::string text) {
+  for (const auto &p : kReplacements) {
+    text = std::regex_replace(text, std::regex(p.first), p.second);
+  }
+  return std::regex_replace(text, std::regex("\\s+"), " ");
+}
+
+static std::vector<TextRun> RegexSplit(const std::string &text) {
+  std::wregex we_both(
+      ToWideString("([\\u4e00-\\u9fff]+)|([^\\u4e00-\\u9fff]+)"));
+  std::wregex we_zh(ToWideString("([\\u4e00-\\u9fff]+)"));
+
+  std::wstring ws = ToWideString(text);
+  std::vector<TextRun> ans;
+  for (std::wsregex_iterator i(ws.begin(), ws.end(), we_both), end; i != end;
+       ++i) {
+    std::wstring s = i->str();
+    ans.push_back({ToString(s), std::regex_match(s, we_zh)});
+  }
+  return ans;
+}
+
+TEST(TextNormalizer, SameAsRegex) {
+  TextNormalizer normalizer(kReplacements, /*merge_spaces*/ true);
+
+  for (const auto &text : kTexts) {
+    auto s = normalizer.Normalize(text);
+    EXPECT_EQ(s, RegexNormalize(text)) << text;
+
+    auto runs = SplitChineseAndNonChinese(s);
+    auto expected = RegexSplit(s);
+
+    ASSERT_EQ(runs.size(), expected.size()) << s;
+    for (size_t i = 0; i != runs.size(); ++i) {
+      EXPECT_EQ(runs[i].text, expected[i].text) << s;
+      EXPECT_EQ(runs[i].is_chinese, expected[i].is_chinese) << s;
+    }
+  }
+}
+
+TEST(TextNormalizer, InvalidUtf8) {
+  TextNormalizer normalizer({{"。", "."}}, false);
+
+  std::string text = "a\xe3\x80\xff\xe3\x80\x82\xe4";
+  EXPECT_EQ(normalizer.Normalize(text), "a\xe3\x80\xff.\xe4");
+
+  auto runs = SplitChineseAndNonChinese(text + "中");
+  ASSERT_EQ(runs.size(), 2u);
+  EXPECT_FALSE(runs[0].is_chinese);
+  EXPECT_TRUE(runs[1].is_chinese);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,186 @@
+// sherpa-onnx/csrc/text-normalizer.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/text-normalizer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static bool IsSpace(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+// Decode the UTF-8 character starting at p.
+//
+// @param p Pointer to the first byte of a character
+// @param end Pointer to one past the last byte of the string
+// @param code_point On return, it contains the code point
+// @return Return the number of bytes of the character. If it is not a
+//         valid character, return 1 and code_point is set to the byte.
+static int32_t DecodeUtf8(const uint8_t *p, const uint8_t *end,
+                          uint32_t *code_point) {
+  uint8_t c = p[0];
+
+  int32_t n = 0;
+  uint32_t cp = 0;
+  if (c < 0x80) {
+    *code_point = c;
+    return 1;
+  } else if ((c & 0xe0) == 0xc0) {
+    n = 2;
+    cp = c & 0x1f;
+  } else if ((c & 0xf0) == 0xe0) {
+    n = 3;
+    cp = c & 0x0f;
+  } else if ((c & 0xf8) == 0xf0) {
+    n = 4;
+    cp = c & 0x07;
+  } else {
+    *code_point = c;
+    return 1;
+  }
+
+  if (end - p < n) {
+    *code_point = c;
+    return 1;
+  }
+
+  for (int32_t i = 1; i != n; ++i) {
+    if ((p[i] & 0xc0) != 0x80) {
+      *code_point = c;
+      return 1;
+    }
+    cp = (cp << 6) | (p[i] & 0x3f);
+  }
+
+  *code_point = cp;
+  return n;
+}
+
+TextNormalizer::TextNormalizer(
+    const std::vector<std::pair<std::string, std::string>> &replacements,
+    bool merge_spaces /*= false*/)
+    : merge_spaces_(merge_spaces) {
+  ascii_.fill(-1);
+
+  for (const auto &p : replacements) {
+    const auto *begin = reinterpret_cast<const uint8_t *>(p.first.data());
+    const auto *end = begin + p.first.size();
+
+    uint32_t cp = 0;
+    if (p.first.empty() ||
+        DecodeUtf8(begin, end, &cp) != static_cast<int32_t>(p.first.size())) {
+      SHERPA_ONNX_LOGE("'%s' is not a single UTF-8 character. Skip it",
+                       p.first.c_str());
+      continue;
+    }
+
+    int32_t index = replacements_.size();
+    replacements_.push_back(p.second);
+
+    if (cp < 0x80) {
+      ascii_[cp] = index;
+    } else {
+      others_[cp] = index;
+    }
+  }
+}
+
+std::string TextNormalizer::Normalize(const std::string &text) const {
+  const auto *p = reinterpret_cast<const uint8_t *>(text.data());
+  const auto *end = p + text.size();
+
+  std::string ans;
+  ans.reserve(text.size());
+
+  bool in_space = false;
+
+  while (p < end) {
+    uint8_t c = *p;
+
+    if (c < 0x80) {
+      ++p;
+
+      if (merge_spaces_ && IsSpace(c)) {
+        if (!in_space) {
+          ans.push_back(' ');
+          in_space = true;
+        }
+        continue;
+      }
+
+      in_space = false;
+
+      int32_t index = ascii_[c];
+      if (index < 0) {
+        ans.push_back(c);
+      } else {
+        ans.append(replacements_[index]);
+      }
+      continue;
+    }
+
+    in_space = false;
+
+    uint32_t cp = 0;
+    int32_t n = DecodeUtf8(p, end, &cp);
+
+    auto it = n > 1 ? others_.find(cp) : others_.end();
+    if (it == others_.end()) {
+      ans.append(reinterpret_cast<const char *>(p), n);
+    } else {
+      ans.append(replacements_[it->second]);
+    }
+
+    p += n;
+  }
+
+  return ans;
+}
+
+std::vector<TextRun> SplitChineseAndNonChinese(const std::string &text) {
+  const auto *begin = reinterpret_cast<const uint8_t *>(text.data());
+  const auto *end = begin + text.size();
+
+  std::vector<TextRun> ans;
+
+  const uint8_t *run_start = begin;
+  bool run_is_chinese = false;
+
+  for (const uint8_t *p = begin; p < end;) {
+    uint32_t cp = 0;
+    int32_t n = DecodeUtf8(p, end, &cp);
+
+    bool is_chinese = n == 3 && cp >= 0x4e00 && cp <= 0x9fff;
+
+    if (p == run_start) {
+      run_is_chinese = is_chinese;
+    } else if (is_chinese != run_is_chinese) {
+      ans.push_back({std::string(reinterpret_cast<const char *>(run_start),
+                                 p - run_start),
+                     run_is_chinese});
+
+      run_start = p;
+      run_is_chinese = is_chinese;
+    }
+
+    p += n;
+  }
+
+  if (run_start < end) {
+    ans.push_back({std::string(reinterpret_cast<const char *>(run_start),
+                               end - run_start),
+                   run_is_chinese});
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,65 @@
+// sherpa-onnx/csrc/text-normalizer.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_TEXT_NORMALIZER_H_
+#define SHERPA_ONNX_CSRC_TEXT_NORMALIZER_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Replaces characters of a UTF-8 string in a single pass.
+//
+// It is a replacement for a series of std::regex_replace() calls whose
+// patterns are single characters. The mapping is built once in the
+// constructor, so please construct it once, e.g., as a member or a
+// function-local static, and reuse it.
+//
+// Normalize() is thread-safe.
+class TextNormalizer {
+ public:
+  /**
+   * @param replacements Each pair maps a single UTF-8 character to a
+   *                     string. Characters are replaced once, i.e., the
+   *                     result of a replacement is not replaced again.
+   * @param merge_spaces If true, replace each run of ASCII whitespace
+   *                     characters, i.e., \s in std::regex, with a single
+   *                     space.
+   */
+  explicit TextNormalizer(
+      const std::vector<std::pair<std::string, std::string>> &replacements,
+      bool merge_spaces = false);
+
+  std::string Normalize(const std::string &text) const;
+
+ private:
+  // Index into replacements_ for each ASCII character, or -1
+  std::array<int32_t, 128> ascii_;
+
+  // Code point -> index into replacements_ for non-ASCII characters
+  std::unordered_map<uint32_t, int32_t> others_;
+
+  std::vector<std::string> replacements_;
+
+  bool merge_spaces_ = false;
+};
+
+struct TextRun {
+  std::string text;
+  bool is_chinese = false;
+};
+
+// Split a UTF-8 string into maximal runs of Chinese characters,
+// i.e., [一-鿿], and runs of other characters.
+// Invalid UTF-8 bytes belong to runs of other characters.
+std::vector<TextRun> SplitChineseAndNonChinese(const std::string &text);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_TEXT_NORMALIZER_H_
@@ -0,0 +1,125 @@
+// sherpa-onnx/csrc/trace-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/trace.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(TraceStageStats, Percentile) {
+  TraceStageStats s;
+  EXPECT_EQ(s.Percentile(0.5), 0);
+
+  for (int32_t i = 0; i != 90; ++i) {
+    s.Add(100);  // bucket [64, 128)
+  }
+
+  for (int32_t i = 0; i != 10; ++i) {
+    s.Add(3000);  // bucket [2048, 4096)
+  }
+
+  EXPECT_EQ(s.count, 100);
+  EXPECT_EQ(s.total_us, 90 * 100 + 10 * 3000);
+  EXPECT_EQ(s.max_us, 3000);
+
+  EXPECT_EQ(s.Percentile(0.5), 128);
+  EXPECT_EQ(s.Percentile(0.9), 128);
+  // Clipped to max_us
+  EXPECT_EQ(s.Percentile(0.99), 3000);
+}
+
+TEST(Tracer, DisabledByDefault) {
+  Tracer::Get().Reset();
+  {
+    ScopedTrace trace(TraceStage::kEncoder);
+  }
+  EXPECT_EQ(Tracer::Get().GetStats().Get(TraceStage::kEncoder).count, 0);
+}
+
+TEST(Tracer, Request) {
+  Tracer::Get().Reset();
+  Tracer::Get().Enable(true);
+
+  TraceRequest request;
+  {
+    ScopedTraceRequest scoped_request(&request);
+    ScopedTrace trace(TraceStage::kG2P);
+
+    // The request is passed to another thread explicitly
+    std::thread t([&request]() {
+      ScopedTraceRequest scoped_request(&request);
+      ScopedTrace trace(TraceStage::kAcousticModel);
+    });
+    t.join();
+  }
+
+  {
+    // Not counted in the request
+    ScopedTrace trace(TraceStage::kG2P);
+    trace.Stop();
+    trace.Stop();
+  }
+
+  Tracer::Get().Disable();
+
+  TraceStats stats = request.GetStats();
+  EXPECT_EQ(stats.Get(TraceStage::kG2P).count, 1);
+  EXPECT_EQ(stats.Get(TraceStage::kAcousticModel).count, 1);
+  EXPECT_EQ(stats.Get(TraceStage::kEncoder).count, 0);
+
+  stats = Tracer::Get().GetStats();
+  EXPECT_EQ(stats.Get(TraceStage::kG2P).count, 2);
+  EXPECT_EQ(stats.Get(TraceStage::kAcousticModel).count, 1);
+
+  std::string json = request.ToJson();
+  EXPECT_NE(json.find("\"g2p\""), std::string::npos);
+  EXPECT_EQ(json.find("\"encoder\""), std::string::npos);
+
+  std::string trace = Tracer::Get().ToChromeTrace();
+  EXPECT_NE(trace.find("\"name\": \"acoustic_model\""), std::string::npos);
+
+  Tracer::Get().Reset();
+}
+
+TEST(Tracer, ConcurrentThreads) {
+  Tracer::Get().Reset();
+  Tracer::Get().Enable(true);
+
+  // A running thread and exited threads are both counted
+  ScopedTrace trace(TraceStage::kDecoder);
+  trace.Stop();
+
+  int32_t num_threads = 8;
+  int32_t num_records = 1000;
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i != num_threads; ++i) {
+    threads.emplace_back([num_records]() {
+      for (int32_t k = 0; k != num_records; ++k) {
+        ScopedTrace trace(TraceStage::kJoiner);
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  Tracer::Get().Disable();
+
+  TraceStats stats = Tracer::Get().GetStats();
+  EXPECT_EQ(stats.Get(TraceStage::kJoiner).count, num_threads * num_records);
+  EXPECT_EQ(stats.Get(TraceStage::kDecoder).count, 1);
+
+  Tracer::Get().Reset();
+  stats = Tracer::Get().GetStats();
+  EXPECT_EQ(stats.Get(TraceStage::kJoiner).count, 0);
+  EXPECT_EQ(stats.Get(TraceStage::kDecoder).count, 0);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,323 @@
+// sherpa-onnx/csrc/trace.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+constexpr int32_t kMaxNumEvents = 1 << 20;
+
+thread_local TraceRequest *current_request = nullptr;
+
+// A small integer for the calling thread. It is used as tid in the
+// Chrome trace.
+int32_t ThreadIndex() {
+  static std::atomic<int32_t> next{0};
+  thread_local int32_t index = next.fetch_add(1);
+  return index;
+}
+
+}  // namespace
+
+const char *TraceStageName(TraceStage stage) {
+  switch (stage) {
+    case TraceStage::kTextNormalization:
+      return "text_normalization";
+    case TraceStage::kG2P:
+      return "g2p";
+    case TraceStage::kBert:
+      return "bert";
+    case TraceStage::kAcousticModel:
+      return "acoustic_model";
+    case TraceStage::kVocoder:
+      return "vocoder";
+    case TraceStage::kFeatureExtraction:
+      return "feature_extraction";
+    case TraceStage::kEncoder:
+      return "encoder";
+    case TraceStage::kDecoder:
+      return "decoder";
+    case TraceStage::kJoiner:
+      return "joiner";
+    default:
+      return "unknown";
+  }
+}
+
+void TraceStageStats::Add(int64_t us) {
+  count += 1;
+  total_us += us;
+  max_us = std::max(max_us, us);
+
+  int32_t i = 0;
+  while (i + 1 < kNumBuckets && (int64_t{1} << i) <= us) {
+    ++i;
+  }
+  buckets[i] += 1;
+}
+
+void TraceStageStats::Merge(const TraceStageStats &other) {
+  count += other.count;
+  total_us += other.total_us;
+  max_us = std::max(max_us, other.max_us);
+  for (int32_t i = 0; i != kNumBuckets; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+int64_t TraceStageStats::Percentile(float q) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  int64_t target = std::max<int64_t>(1, static_cast<int64_t>(q * count + 0.5));
+  int64_t seen = 0;
+  for (int32_t i = 0; i != kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= target) {
+      return std::min(max_us, int64_t{1} << i);
+    }
+  }
+
+  return max_us;
+}
+
+void TraceStats::Merge(const TraceStats &other) {
+  for (int32_t i = 0; i != kNumTraceStages; ++i) {
+    stages[i].Merge(other.stages[i]);
+  }
+}
+
+std::string TraceStats::ToJson() const {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+
+  os << "{";
+  std::string sep;
+  for (int32_t i = 0; i != kNumTraceStages; ++i) {
+    const auto &s = stages[i];
+    if (s.count == 0) {
+      continue;
+    }
+
+    os << sep << "\"" << TraceStageName(static_cast<TraceStage>(i)) << "\": {";
+    os << "\"count\": " << s.count << ", ";
+    os << "\"total_ms\": " << s.total_us / 1000.0 << ", ";
+    os << "\"mean_ms\": " << s.total_us / 1000.0 / s.count << ", ";
+    os << "\"max_ms\": " << s.max_us / 1000.0 << ", ";
+    os << "\"p50_ms\": " << s.Percentile(0.5) / 1000.0 << ", ";
+    os << "\"p90_ms\": " << s.Percentile(0.9) / 1000.0 << ", ";
+    os << "\"p99_ms\": " << s.Percentile(0.99) / 1000.0 << "}";
+    sep = ", ";
+  }
+  os << "}";
+
+  return os.str();
+}
+
+void TraceRequest::Add(TraceStage stage, int64_t us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.Add(stage, us);
+}
+
+TraceStats TraceRequest::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+ScopedTraceRequest::ScopedTraceRequest(TraceRequest *request)
+    : prev_(current_request) {
+  current_request = request;
+}
+
+ScopedTraceRequest::~ScopedTraceRequest() { current_request = prev_; }
+
+TraceRequest *CurrentTraceRequest() { return current_request; }
+
+namespace {
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+// Owns the buffer of a thread. The buffer is registered in the constructor
+// and unregistered when the thread exits.
+class ThreadBufferHolder {
+ public:
+  explicit ThreadBufferHolder(Tracer *tracer)
+      : tracer_(tracer), buffer_(std::make_unique<Tracer::ThreadBuffer>()) {
+    tracer_->Register(buffer_.get());
+  }
+
+  ~ThreadBufferHolder() { tracer_->Unregister(buffer_.get()); }
+
+  Tracer::ThreadBuffer *Get() const { return buffer_.get(); }
+
+ private:
+  Tracer *tracer_;
+  std::unique_ptr<Tracer::ThreadBuffer> buffer_;
+};
+
+std::atomic<bool> Tracer::enabled_{false};
+
+Tracer::Tracer() : origin_us_(NowUs()) {}
+
+Tracer &Tracer::Get() {
+  static Tracer tracer;
+  return tracer;
+}
+
+Tracer::ThreadBuffer *Tracer::GetThreadBuffer() {
+  thread_local ThreadBufferHolder holder(this);
+  return holder.Get();
+}
+
+void Tracer::Register(ThreadBuffer *buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.push_back(buffer);
+}
+
+void Tracer::Unregister(ThreadBuffer *buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find(buffers_.begin(), buffers_.end(), buffer);
+  if (it == buffers_.end()) {
+    return;
+  }
+  buffers_.erase(it);
+
+  std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+  retired_.stats.Merge(buffer->stats);
+  retired_.events.insert(retired_.events.end(), buffer->events.begin(),
+                         buffer->events.end());
+}
+
+void Tracer::Enable(bool record_events /*= false*/) {
+  record_events_.store(record_events, std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+void Tracer::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  origin_us_.store(NowUs(), std::memory_order_relaxed);
+  num_events_.store(0, std::memory_order_relaxed);
+  num_dropped_events_.store(0, std::memory_order_relaxed);
+
+  for (auto *buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    buffer->stats = {};
+    buffer->events.clear();
+  }
+
+  retired_.stats = {};
+  retired_.events.clear();
+}
+
+TraceStats Tracer::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  TraceStats ans = retired_.stats;
+  for (auto *buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    ans.Merge(buffer->stats);
+  }
+
+  return ans;
+}
+
+std::string Tracer::ToChromeTrace() const {
+  std::vector<Event> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events = retired_.events;
+    for (auto *buffer : buffers_) {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      events.insert(events.end(), buffer->events.begin(),
+                    buffer->events.end());
+    }
+  }
+
+  std::sort(events.begin(), events.end(),
+            [](const Event &a, const Event &b) {
+              return a.begin_us < b.begin_us;
+            });
+
+  std::ostringstream os;
+  os << "{\"traceEvents\": [";
+  std::string sep;
+  for (const auto &e : events) {
+    os << sep << "{\"name\": \"" << TraceStageName(e.stage)
+       << "\", \"cat\": \"sherpa-onnx\", \"ph\": \"X\", \"pid\": 0, "
+       << "\"tid\": " << e.tid << ", \"ts\": " << e.begin_us
+       << ", \"dur\": " << e.duration_us << "}";
+    sep = ",\n";
+  }
+  os << "], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": "
+     << num_dropped_events_.load(std::memory_order_relaxed) << "}}";
+
+  return os.str();
+}
+
+bool Tracer::WriteChromeTrace(const std::string &filename) const {
+  std::ofstream os(filename);
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to open '%s' for writing", filename.c_str());
+    return false;
+  }
+
+  os << ToChromeTrace();
+
+  return static_cast<bool>(os);
+}
+
+void Tracer::Record(TraceStage stage,
+                    std::chrono::steady_clock::time_point begin,
+                    std::chrono::steady_clock::time_point end) {
+  int64_t us =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count();
+
+  if (TraceRequest *request = CurrentTraceRequest()) {
+    request->Add(stage, us);
+  }
+
+  ThreadBuffer *buffer = GetThreadBuffer();
+
+  bool record_event = record_events_.load(std::memory_order_relaxed);
+  if (record_event &&
+      num_events_.fetch_add(1, std::memory_order_relaxed) >= kMaxNumEvents) {
+    num_dropped_events_.fetch_add(1, std::memory_order_relaxed);
+    record_event = false;
+  }
+
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  buffer->stats.Add(stage, us);
+
+  if (record_event) {
+    int64_t begin_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            begin.time_since_epoch())
+            .count() -
+        origin_us_.load(std::memory_order_relaxed);
+    buffer->events.push_back({stage, ThreadIndex(), begin_us, us});
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,242 @@
+// sherpa-onnx/csrc/trace.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_TRACE_H_
+#define SHERPA_ONNX_CSRC_TRACE_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Stages of a TTS or an ASR request that are timed.
+//
+// Stages may nest, e.g., kBert runs inside kG2P for MeloTTS, in which
+// case the time of the inner stage is included in the outer one.
+enum class TraceStage : int32_t {
+  kTextNormalization = 0,
+  kG2P,
+  kBert,
+  kAcousticModel,
+  kVocoder,
+  kFeatureExtraction,
+  kEncoder,
+  kDecoder,
+  kJoiner,
+  kNumStages,  // It must be the last one
+};
+
+constexpr int32_t kNumTraceStages =
+    static_cast<int32_t>(TraceStage::kNumStages);
+
+// e.g., "text_normalization" for TraceStage::kTextNormalization
+const char *TraceStageName(TraceStage stage);
+
+// Durations of one stage.
+//
+// Durations are counted in a histogram with power-of-two buckets in
+// microseconds: bucket 0 is for [0, 1) us and bucket i for
+// [2^(i-1), 2^i) us. The last bucket also holds longer durations.
+struct TraceStageStats {
+  static constexpr int32_t kNumBuckets = 32;
+
+  int64_t count = 0;
+  int64_t total_us = 0;
+  int64_t max_us = 0;
+  int64_t buckets[kNumBuckets] = {};
+
+  void Add(int64_t us);
+  void Merge(const TraceStageStats &other);
+
+  // Return an upper bound in microseconds of the given quantile, which is
+  // in the range [0, 1]. It is never larger than max_us.
+  int64_t Percentile(float q) const;
+};
+
+struct TraceStats {
+  TraceStageStats stages[kNumTraceStages];
+
+  const TraceStageStats &Get(TraceStage stage) const {
+    return stages[static_cast<int32_t>(stage)];
+  }
+
+  void Add(TraceStage stage, int64_t us) {
+    stages[static_cast<int32_t>(stage)].Add(us);
+  }
+
+  void Merge(const TraceStats &other);
+
+  // Return a JSON object with the count, total, mean, max, p50, p90 and
+  // p99 in milliseconds of each stage that has run, e.g.,
+  //
+  //  {"g2p": {"count": 2, "total_ms": 3.1, ...}, "acoustic_model": {...}}
+  std::string ToJson() const;
+};
+
+// Stages run for a single request.
+//
+// Install it with ScopedTraceRequest in each thread that works on the
+// request. It is thread-safe.
+class TraceRequest {
+ public:
+  void Add(TraceStage stage, int64_t us);
+
+  TraceStats GetStats() const;
+
+  std::string ToJson() const { return GetStats().ToJson(); }
+
+ private:
+  mutable std::mutex mutex_;
+  TraceStats stats_;
+};
+
+// Make request the current request of this thread while this object
+// is alive. The previous one is restored in the destructor.
+class ScopedTraceRequest {
+ public:
+  explicit ScopedTraceRequest(TraceRequest *request);
+  ~ScopedTraceRequest();
+
+  ScopedTraceRequest(const ScopedTraceRequest &) = delete;
+  ScopedTraceRequest &operator=(const ScopedTraceRequest &) = delete;
+
+ private:
+  TraceRequest *prev_;
+};
+
+// Return the current request of this thread. It may be nullptr.
+TraceRequest *CurrentTraceRequest();
+
+// The process-wide tracer. It is disabled by default, in which case
+// ScopedTrace costs a single relaxed atomic load.
+//
+// Each thread accumulates its stats and events in its own buffer, so that
+// threads timing stages concurrently do not contend on a lock. The buffers
+// are merged in GetStats() and ToChromeTrace().
+class Tracer {
+ public:
+  static Tracer &Get();
+
+  /** Start to time stages.
+   *
+   * @param record_events If true, each timed stage is also kept as an
+   *                      event for ToChromeTrace(). At most 1M events
+   *                      are kept.
+   */
+  void Enable(bool record_events = false);
+
+  void Disable();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Clear the stats and the events
+  void Reset();
+
+  // Stats of all stages run in this process since the last Reset()
+  TraceStats GetStats() const;
+
+  std::string ToJson() const { return GetStats().ToJson(); }
+
+  // Return recorded events in the Chrome trace event format. It can be
+  // viewed with chrome://tracing or https://ui.perfetto.dev
+  std::string ToChromeTrace() const;
+
+  // Write ToChromeTrace() to the given file. Return false on error.
+  bool WriteChromeTrace(const std::string &filename) const;
+
+  // Called by ScopedTrace
+  void Record(TraceStage stage, std::chrono::steady_clock::time_point begin,
+              std::chrono::steady_clock::time_point end);
+
+  struct Event {
+    TraceStage stage;
+    int32_t tid;
+    int64_t begin_us;  // relative to the last Reset()
+    int64_t duration_us;
+  };
+
+  // Stats and events recorded by one thread. Its mutex is locked by
+  // the owning thread in Record() and by readers, so it is uncontended
+  // unless the stats are being read.
+  struct ThreadBuffer {
+    std::mutex mutex;
+    TraceStats stats;
+    std::vector<Event> events;
+  };
+
+ private:
+  Tracer();
+
+  // Return the buffer of the calling thread. It is created at the first
+  // call in each thread.
+  ThreadBuffer *GetThreadBuffer();
+
+  void Register(ThreadBuffer *buffer);
+
+  // Called when a thread exits. The stats and events of the buffer are
+  // moved to retired_.
+  void Unregister(ThreadBuffer *buffer);
+
+  friend class ThreadBufferHolder;
+
+  static std::atomic<bool> enabled_;
+
+  std::atomic<bool> record_events_{false};
+
+  // steady_clock time of the last Reset() in microseconds
+  std::atomic<int64_t> origin_us_;
+
+  std::atomic<int64_t> num_events_{0};
+  std::atomic<int64_t> num_dropped_events_{0};
+
+  // It protects buffers_ and retired_
+  mutable std::mutex mutex_;
+  std::vector<ThreadBuffer *> buffers_;
+
+  // Stats and events of exited threads
+  ThreadBuffer retired_;
+};
+
+// Time the enclosing scope, or until Stop() is called, as the given stage.
+//
+// Usage:
+//
+//   ScopedTrace trace(TraceStage::kEncoder);
+//   auto encoder_out = model_->RunEncoder(std::move(x));
+//   trace.Stop();
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(TraceStage stage)
+      : stage_(stage), enabled_(Tracer::IsEnabled()) {
+    if (enabled_) {
+      begin_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedTrace() { Stop(); }
+
+  void Stop() {
+    if (enabled_) {
+      Tracer::Get().Record(stage_, begin_, std::chrono::steady_clock::now());
+      enabled_ = false;
+    }
+  }
+
+  ScopedTrace(const ScopedTrace &) = delete;
+  ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+ private:
+  TraceStage stage_;
+  bool enabled_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_TRACE_H_
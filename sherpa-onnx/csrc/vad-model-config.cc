@@ -14,6 +14,7 @@ namespace sherpa_onnx {
 
 void VadModelConfig::Register(ParseOptions *po) {
   silero_vad.Register(po);
+  pre_gate.Register(po);
 
   po->Register("vad-sample-rate", &sample_rate,
                "Sample rate expected by the VAD model");
@@ -48,6 +49,10 @@ bool VadModelConfig::Validate() const {
     }
   }
 
+  if (!pre_gate.Validate()) {
+    return false;
+  }
+
   return silero_vad.Validate();
 }
 
@@ -59,7 +64,8 @@ std::string VadModelConfig::ToString() const {
   os << "sample_rate=" << sample_rate << ", ";
   os << "num_threads=" << num_threads << ", ";
   os << "provider=\"" << provider << "\", ";
-  os << "debug=" << (debug ? "True" : "False") << ")";
+  os << "debug=" << (debug ? "True" : "False") << ", ";
+  os << "pre_gate=" << pre_gate.ToString() << ")";
 
   return os.str();
 }
@@ -8,6 +8,7 @@
 
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/silero-vad-model-config.h"
+#include "sherpa-onnx/csrc/vad-pre-gate-config.h"
 
 namespace sherpa_onnx {
 
@@ -21,6 +22,9 @@ struct VadModelConfig {
   // true to show debug information when loading models
   bool debug = false;
 
+  // Optional. Disabled by default.
+  VadPreGateConfig pre_gate;
+
   VadModelConfig() = default;
 
   VadModelConfig(const SileroVadModelConfig &silero_vad, int32_t sample_rate,
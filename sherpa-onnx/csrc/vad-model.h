@@ -32,6 +32,19 @@ class VadModel {
    */
   virtual bool IsSpeech(const float *samples, int32_t n) = 0;
 
+  /**
+   * Like IsSpeech() but for a window that is known to be non-speech, e.g.,
+   * by VadPreGate. The model is not run; the window is treated as having
+   * a speech probability of 0.
+   *
+   * @param reset_states true to also reset the recurrent states of the
+   *                     model, which are not updated for skipped windows.
+   *
+   * @return Return true if speech is detected. Return false otherwise.
+   *         It can still be true while a segment is ending.
+   */
+  virtual bool SkipWindow(bool reset_states) = 0;
+
   virtual int32_t WindowSize() const = 0;
 
   virtual int32_t WindowShift() const = 0;
@@ -0,0 +1,95 @@
+// sherpa-onnx/csrc/vad-pre-gate-config.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-pre-gate-config.h"
+
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void VadPreGateConfig::Register(ParseOptions *po) {
+  po->Register("vad-pre-gate", &enabled,
+               "true to skip the VAD model for windows that are clearly "
+               "non-speech according to their energy, zero-crossing rate "
+               "and spectral flatness");
+
+  po->Register("vad-pre-gate-silence-db", &silence_db,
+               "Windows with an RMS level (dBFS) below it are non-speech");
+
+  po->Register("vad-pre-gate-noise-db", &noise_db,
+               "Windows with an RMS level (dBFS) below it are non-speech if "
+               "they also look like noise");
+
+  po->Register("vad-pre-gate-flatness-threshold", &flatness_threshold,
+               "Quiet windows with a spectral flatness above it are noise");
+
+  po->Register("vad-pre-gate-zcr-threshold", &zcr_threshold,
+               "Quiet windows with a zero-crossing rate above it are noise");
+
+  po->Register("vad-pre-gate-reset-after-windows", &reset_after_windows,
+               "Reset the states of the VAD model after this many "
+               "consecutive skipped windows");
+}
+
+bool VadPreGateConfig::Validate() const {
+  if (!enabled) {
+    return true;
+  }
+
+  if (noise_db < silence_db) {
+    SHERPA_ONNX_LOGE(
+        "--vad-pre-gate-noise-db (%.3f) should not be less than "
+        "--vad-pre-gate-silence-db (%.3f)",
+        noise_db, silence_db);
+    return false;
+  }
+
+  if (noise_db > 0) {
+    SHERPA_ONNX_LOGE("--vad-pre-gate-noise-db should be <= 0. Given: %.3f",
+                     noise_db);
+    return false;
+  }
+
+  if (flatness_threshold <= 0 || flatness_threshold > 1) {
+    SHERPA_ONNX_LOGE(
+        "--vad-pre-gate-flatness-threshold should be in (0, 1]. Given: %.3f",
+        flatness_threshold);
+    return false;
+  }
+
+  if (zcr_threshold <= 0 || zcr_threshold > 1) {
+    SHERPA_ONNX_LOGE(
+        "--vad-pre-gate-zcr-threshold should be in (0, 1]. Given: %.3f",
+        zcr_threshold);
+    return false;
+  }
+
+  if (reset_after_windows < 1) {
+    SHERPA_ONNX_LOGE(
+        "--vad-pre-gate-reset-after-windows should be positive. Given: %d",
+        reset_after_windows);
+    return false;
+  }
+
+  return true;
+}
+
+std::string VadPreGateConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "VadPreGateConfig(";
+  os << "enabled=" << (enabled ? "True" : "False") << ", ";
+  os << "silence_db=" << silence_db << ", ";
+  os << "noise_db=" << noise_db << ", ";
+  os << "flatness_threshold=" << flatness_threshold << ", ";
+  os << "zcr_threshold=" << zcr_threshold << ", ";
+  os << "reset_after_windows=" << reset_after_windows << ")";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
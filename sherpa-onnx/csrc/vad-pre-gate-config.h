@@ -0,0 +1,60 @@
+// sherpa-onnx/csrc/vad-pre-gate-config.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_VAD_PRE_GATE_CONFIG_H_
+#define SHERPA_ONNX_CSRC_VAD_PRE_GATE_CONFIG_H_
+
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+// A cheap check that runs before the VAD model. Windows that it classifies
+// as non-speech are not fed to the model.
+struct VadPreGateConfig {
+  bool enabled = false;
+
+  // Windows whose RMS level in dBFS is below this value are non-speech,
+  // e.g., digital silence.
+  float silence_db = -60;
+
+  // Windows whose RMS level in dBFS is below this value are non-speech
+  // if they also look like noise, i.e., their spectral flatness is above
+  // flatness_threshold or their zero-crossing rate is above zcr_threshold.
+  float noise_db = -40;
+
+  // Spectral flatness is in [0, 1]. It is 1 for white noise and close
+  // to 0 for voiced speech.
+  float flatness_threshold = 0.5;
+
+  // Zero crossings per sample. It is about 0.5 for white noise.
+  float zcr_threshold = 0.45;
+
+  // Reset the recurrent states of the model after this many consecutive
+  // skipped windows, so that the model starts from a clean state when
+  // speech arrives instead of from a state that saw audio long ago.
+  int32_t reset_after_windows = 16;
+
+  VadPreGateConfig() = default;
+
+  VadPreGateConfig(bool enabled, float silence_db, float noise_db,
+                   float flatness_threshold, float zcr_threshold,
+                   int32_t reset_after_windows)
+      : enabled(enabled),
+        silence_db(silence_db),
+        noise_db(noise_db),
+        flatness_threshold(flatness_threshold),
+        zcr_threshold(zcr_threshold),
+        reset_after_windows(reset_after_windows) {}
+
+  void Register(ParseOptions *po);
+
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_PRE_GATE_CONFIG_H_
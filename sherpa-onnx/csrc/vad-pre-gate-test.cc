@@ -0,0 +1,100 @@
+// sherpa-onnx/csrc/vad-pre-gate-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
+namespace sherpa_onnx {
+
+static std::vector<float> WhiteNoise(int32_t n, float amplitude) {
+  std::mt19937 gen(20250105);
+  std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+
+  std::vector<float> x(n);
+  for (auto &f : x) {
+    f = dist(gen);
+  }
+
+  return x;
+}
+
+// A crude voiced sound: harmonics of 150 Hz with decaying amplitudes
+static std::vector<float> Voiced(int32_t n, float amplitude) {
+  std::vector<float> x(n);
+  for (int32_t i = 0; i != n; ++i) {
+    float t = i / 16000.0f;
+    for (int32_t h = 1; h <= 10; ++h) {
+      x[i] += amplitude / h * std::sin(2 * M_PI * 150 * h * t);
+    }
+  }
+
+  return x;
+}
+
+TEST(VadPreGate, Features) {
+  // odd size to test the scalar tail
+  auto x = WhiteNoise(1003, 0.5);
+
+  double sum = 0;
+  int32_t count = 0;
+  for (size_t i = 0; i != x.size(); ++i) {
+    sum += x[i] * x[i];
+    if (i > 0) {
+      count += (x[i] < 0) != (x[i - 1] < 0);
+    }
+  }
+
+  EXPECT_NEAR(ComputeRmsDb(x.data(), x.size()),
+              10 * std::log10(sum / x.size()), 1e-3);
+  EXPECT_FLOAT_EQ(ComputeZeroCrossingRate(x.data(), x.size()),
+                  count / static_cast<float>(x.size() - 1));
+
+  std::vector<float> zeros(512);
+  EXPECT_EQ(ComputeRmsDb(zeros.data(), zeros.size()), -100);
+  EXPECT_EQ(ComputeZeroCrossingRate(zeros.data(), zeros.size()), 0);
+
+  VadPreGate gate(VadPreGateConfig{});
+  EXPECT_GT(gate.SpectralFlatness(x.data(), x.size()), 0.5);
+
+  auto v = Voiced(576, 0.1);
+  EXPECT_LT(gate.SpectralFlatness(v.data(), v.size()), 0.2);
+  EXPECT_LT(ComputeZeroCrossingRate(v.data(), v.size()), 0.1);
+}
+
+TEST(VadPreGate, IsNonSpeech) {
+  VadPreGateConfig config;
+  config.enabled = true;
+  VadPreGate gate(config);
+
+  // window size of silero VAD v5 at 16 kHz
+  int32_t n = 576;
+
+  std::vector<float> zeros(n);
+  EXPECT_TRUE(gate.IsNonSpeech(zeros.data(), n));
+
+  // about -50 dBFS line noise
+  auto noise = WhiteNoise(n, 0.0055);
+  EXPECT_TRUE(gate.IsNonSpeech(noise.data(), n));
+
+  // Loud noise is left to the model
+  noise = WhiteNoise(n, 0.3);
+  EXPECT_FALSE(gate.IsNonSpeech(noise.data(), n));
+
+  // Quiet and loud voiced sounds are passed to the model
+  for (float amplitude : {0.005f, 0.2f}) {
+    auto v = Voiced(n, amplitude);
+    EXPECT_FALSE(gate.IsNonSpeech(v.data(), n)) << amplitude;
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,187 @@
+// sherpa-onnx/csrc/vad-pre-gate.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHERPA_ONNX_VAD_PRE_GATE_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SHERPA_ONNX_VAD_PRE_GATE_NEON 1
+#endif
+
+#include "kaldi-native-fbank/csrc/rfft.h"
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
+namespace sherpa_onnx {
+
+static float SumOfSquares(const float *samples, int32_t n) {
+  int32_t i = 0;
+  float sum = 0;
+#if defined(SHERPA_ONNX_VAD_PRE_GATE_SSE2)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    __m128 a = _mm_loadu_ps(samples + i);
+    __m128 b = _mm_loadu_ps(samples + i + 4);
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+  }
+  float tmp[4];
+  _mm_storeu_ps(tmp, _mm_add_ps(acc0, acc1));
+  sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+#elif defined(SHERPA_ONNX_VAD_PRE_GATE_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t a = vld1q_f32(samples + i);
+    float32x4_t b = vld1q_f32(samples + i + 4);
+    acc0 = vmlaq_f32(acc0, a, a);
+    acc1 = vmlaq_f32(acc1, b, b);
+  }
+  sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+#endif
+  for (; i < n; ++i) {
+    sum += samples[i] * samples[i];
+  }
+
+  return sum;
+}
+
+float ComputeRmsDb(const float *samples, int32_t n) {
+  if (n <= 0) {
+    return -100;
+  }
+
+  float mean_square = SumOfSquares(samples, n) / n;
+
+  // 10^(-100/10)
+  if (mean_square < 1e-10f) {
+    return -100;
+  }
+
+  // A full-scale square wave has a mean square of 1
+  return 10 * std::log10(mean_square);
+}
+
+float ComputeZeroCrossingRate(const float *samples, int32_t n) {
+  if (n < 2) {
+    return 0;
+  }
+
+  int32_t count = 0;
+
+  // Compare the sign of samples[i] with that of samples[i - 1]
+  int32_t i = 1;
+#if defined(SHERPA_ONNX_VAD_PRE_GATE_SSE2)
+  static const int8_t kPopCount[16] = {0, 1, 1, 2, 1, 2, 2, 3,
+                                       1, 2, 2, 3, 2, 3, 3, 4};
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    int32_t cur =
+        _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(samples + i), zero));
+    int32_t prev =
+        _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(samples + i - 1), zero));
+    count += kPopCount[cur ^ prev];
+  }
+#elif defined(SHERPA_ONNX_VAD_PRE_GATE_NEON)
+  const float32x4_t zero = vdupq_n_f32(0);
+  uint32x4_t acc = vdupq_n_u32(0);
+  for (; i + 4 <= n; i += 4) {
+    uint32x4_t cur = vcltq_f32(vld1q_f32(samples + i), zero);
+    uint32x4_t prev = vcltq_f32(vld1q_f32(samples + i - 1), zero);
+    acc = vaddq_u32(acc, vshrq_n_u32(veorq_u32(cur, prev), 31));
+  }
+  count = vaddvq_u32(acc);
+#endif
+  for (; i < n; ++i) {
+    count += (samples[i] < 0) != (samples[i - 1] < 0);
+  }
+
+  return static_cast<float>(count) / (n - 1);
+}
+
+VadPreGate::VadPreGate(const VadPreGateConfig &config) : config_(config) {}
+
+VadPreGate::~VadPreGate() = default;
+
+bool VadPreGate::IsNonSpeech(const float *samples, int32_t n) {
+  float db = ComputeRmsDb(samples, n);
+  if (db < config_.silence_db) {
+    return true;
+  }
+
+  if (db >= config_.noise_db) {
+    return false;
+  }
+
+  // The zero-crossing rate is cheaper, so check it first
+  if (ComputeZeroCrossingRate(samples, n) > config_.zcr_threshold) {
+    return true;
+  }
+
+  return SpectralFlatness(samples, n) > config_.flatness_threshold;
+}
+
+float VadPreGate::SpectralFlatness(const float *samples, int32_t n) {
+  int32_t fft_size = 1;
+  while (fft_size * 2 <= n) {
+    fft_size *= 2;
+  }
+
+  if (fft_size < 4) {
+    return 0;
+  }
+
+  if (fft_size != fft_size_) {
+    fft_size_ = fft_size;
+    rfft_ = std::make_unique<knf::Rfft>(fft_size);
+
+    // hann window
+    window_.resize(fft_size);
+    for (int32_t i = 0; i != fft_size; ++i) {
+      window_[i] = 0.5 - 0.5 * std::cos(2 * M_PI * i / fft_size);
+    }
+
+    buf_.resize(fft_size);
+  }
+
+  const float *p = samples + n - fft_size;
+  for (int32_t i = 0; i != fft_size; ++i) {
+    buf_[i] = p[i] * window_[i];
+  }
+
+  // buf_[0] is the DC and buf_[1] is the Nyquist component.
+  // The remaining are (real, imag) pairs of bins 1 to fft_size/2 - 1.
+  rfft_->Compute(buf_.data());
+
+  // Skip DC and Nyquist. The small constant avoids log(0).
+  double sum_log = 0;
+  double sum = 0;
+  int32_t num_bins = fft_size / 2 - 1;
+  for (int32_t k = 1; k <= num_bins; ++k) {
+    float re = buf_[2 * k];
+    float im = buf_[2 * k + 1];
+    double power = re * re + im * im + 1e-12;
+
+    sum_log += std::log(power);
+    sum += power;
+  }
+
+  double geometric_mean = std::exp(sum_log / num_bins);
+  double arithmetic_mean = sum / num_bins;
+
+  return std::min<float>(geometric_mean / arithmetic_mean, 1);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,53 @@
+// sherpa-onnx/csrc/vad-pre-gate.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_VAD_PRE_GATE_H_
+#define SHERPA_ONNX_CSRC_VAD_PRE_GATE_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sherpa-onnx/csrc/vad-pre-gate-config.h"
+
+namespace knf {
+class Rfft;
+}
+
+namespace sherpa_onnx {
+
+// RMS level of the samples in dBFS. A full-scale square wave has 0 dB.
+// The result is clamped to -100 dB for digital silence.
+float ComputeRmsDb(const float *samples, int32_t n);
+
+// Fraction of adjacent sample pairs whose signs differ, in [0, 1].
+float ComputeZeroCrossingRate(const float *samples, int32_t n);
+
+// Classifies windows that are clearly non-speech so that the VAD model
+// does not need to run on them. It is designed to have a low miss rate:
+// anything that is not quiet is passed to the model.
+class VadPreGate {
+ public:
+  explicit VadPreGate(const VadPreGateConfig &config);
+  ~VadPreGate();
+
+  // Return true if the window is clearly non-speech.
+  bool IsNonSpeech(const float *samples, int32_t n);
+
+  // Spectral flatness, i.e., the ratio of the geometric mean to the
+  // arithmetic mean of the power spectrum, in [0, 1].
+  // It uses the last N samples, where N is the largest power of 2 <= n.
+  float SpectralFlatness(const float *samples, int32_t n);
+
+ private:
+  VadPreGateConfig config_;
+
+  int32_t fft_size_ = 0;
+  std::unique_ptr<knf::Rfft> rfft_;
+  std::vector<float> window_;
+  std::vector<float> buf_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_PRE_GATE_H_
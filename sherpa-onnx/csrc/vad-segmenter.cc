@@ -0,0 +1,84 @@
+// sherpa-onnx/csrc/vad-segmenter.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-segmenter.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+VadSegmenter::VadSegmenter(int32_t buffer_size, int32_t window_size,
+                           int32_t min_speech_samples)
+    : buffer_(buffer_size),
+      window_size_(window_size),
+      min_speech_samples_(min_speech_samples) {}
+
+void VadSegmenter::Update(bool is_speech, int32_t min_silence_samples) {
+  if (is_speech) {
+    if (start_ == -1) {
+      // beginning of speech
+      start_ = std::max(buffer_.Tail() - 2 * window_size_ - min_speech_samples_,
+                        buffer_.Head());
+    }
+  } else {
+    // non-speech
+    if (start_ != -1 && buffer_.Size()) {
+      // end of speech, save the speech segment
+      int32_t end = buffer_.Tail() - min_silence_samples;
+
+      std::vector<float> s = buffer_.Get(start_, end - start_);
+      SpeechSegment segment;
+
+      segment.start = start_;
+      segment.samples = std::move(s);
+
+      segments_.push(std::move(segment));
+
+      buffer_.Pop(end - buffer_.Head());
+    }
+
+    if (start_ == -1) {
+      int32_t end = buffer_.Tail() - 2 * window_size_ - min_speech_samples_;
+      int32_t n = std::max(0, end - buffer_.Head());
+      if (n > 0) {
+        buffer_.Pop(n);
+      }
+    }
+
+    start_ = -1;
+  }
+}
+
+void VadSegmenter::Flush() {
+  if (start_ == -1 || buffer_.Size() == 0) {
+    return;
+  }
+
+  int32_t end = buffer_.Tail();
+  if (end <= start_) {
+    return;
+  }
+
+  std::vector<float> s = buffer_.Get(start_, end - start_);
+
+  SpeechSegment segment;
+
+  segment.start = start_;
+  segment.samples = std::move(s);
+
+  segments_.push(std::move(segment));
+
+  buffer_.Pop(end - buffer_.Head());
+  start_ = -1;
+}
+
+void VadSegmenter::Reset() {
+  std::queue<SpeechSegment>().swap(segments_);
+  buffer_.Reset();
+  start_ = -1;
+}
+
+}  // namespace sherpa_onnx
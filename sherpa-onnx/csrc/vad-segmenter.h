@@ -0,0 +1,69 @@
+// sherpa-onnx/csrc/vad-segmenter.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_VAD_SEGMENTER_H_
+#define SHERPA_ONNX_CSRC_VAD_SEGMENTER_H_
+
+#include <cstdint>
+#include <queue>
+
+#include "sherpa-onnx/csrc/circular-buffer.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+
+namespace sherpa_onnx {
+
+// It buffers the audio of a stream and cuts speech segments from it
+// given the speech/non-speech decision of each window.
+//
+// It is shared by VoiceActivityDetector and MultiStreamVad.
+class VadSegmenter {
+ public:
+  /**
+   * @param buffer_size Capacity of the audio buffer in samples.
+   * @param window_size Window size of the VAD model in samples.
+   * @param min_speech_samples Minimum speech duration in samples.
+   */
+  VadSegmenter(int32_t buffer_size, int32_t window_size,
+               int32_t min_speech_samples);
+
+  // Append the new samples of the window that is being classified.
+  void Push(const float *samples, int32_t n) { buffer_.Push(samples, n); }
+
+  // Update the state after the windows pushed since the last call have
+  // been classified.
+  //
+  // @param is_speech true if any of the windows contains speech.
+  // @param min_silence_samples Current minimum silence duration in samples.
+  void Update(bool is_speech, int32_t min_silence_samples);
+
+  // Save the last speech segment, if any.
+  void Flush();
+
+  void Reset();
+
+  bool Empty() const { return segments_.empty(); }
+
+  void Pop() { segments_.pop(); }
+
+  void Clear() { std::queue<SpeechSegment>().swap(segments_); }
+
+  const SpeechSegment &Front() const { return segments_.front(); }
+
+  bool IsSpeechDetected() const { return start_ != -1; }
+
+  // Number of samples in the audio buffer
+  int32_t BufferSize() const { return buffer_.Size(); }
+
+ private:
+  std::queue<SpeechSegment> segments_;
+  CircularBuffer buffer_;
+
+  int32_t window_size_;
+  int32_t min_speech_samples_;
+
+  int32_t start_ = -1;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_SEGMENTER_H_
@@ -5,8 +5,8 @@
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
 
 #include <algorithm>
-#include <queue>
 #include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -17,8 +17,9 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
-#include "sherpa-onnx/csrc/circular-buffer.h"
 #include "sherpa-onnx/csrc/vad-model.h"
+#include "sherpa-onnx/csrc/vad-pre-gate.h"
+#include "sherpa-onnx/csrc/vad-segmenter.h"
 
 namespace sherpa_onnx {
 
@@ -27,7 +28,8 @@ class VoiceActivityDetector::Impl {
   explicit Impl(const VadModelConfig &config, float buffer_size_in_seconds = 60)
       : model_(VadModel::Create(config)),
         config_(config),
-        buffer_(buffer_size_in_seconds * config.sample_rate) {
+        segmenter_(buffer_size_in_seconds * config.sample_rate,
+                   model_->WindowSize(), model_->MinSpeechDurationSamples()) {
     Init();
   }
 
@@ -36,12 +38,13 @@ class VoiceActivityDetector::Impl {
        float buffer_size_in_seconds = 60)
       : model_(VadModel::Create(mgr, config)),
         config_(config),
-        buffer_(buffer_size_in_seconds * config.sample_rate) {
+        segmenter_(buffer_size_in_seconds * config.sample_rate,
+                   model_->WindowSize(), model_->MinSpeechDurationSamples()) {
     Init();
   }
 
   void AcceptWaveform(const float *samples, int32_t n) {
-    if (buffer_.Size() > max_utterance_length_) {
+    if (segmenter_.BufferSize() > max_utterance_length_) {
       model_->SetMinSilenceDuration(new_min_silence_duration_s_);
       model_->SetThreshold(new_threshold_);
     } else {
@@ -67,96 +70,59 @@ class VoiceActivityDetector::Impl {
     bool is_speech = false;
 
     for (int32_t i = 0; i < k; ++i, p += window_shift) {
-      buffer_.Push(p, window_shift);
+      segmenter_.Push(p, window_shift);
       // NOTE(fangjun): Please don't use a very large n.
-      bool this_window_is_speech = model_->IsSpeech(p, window_size);
+      bool this_window_is_speech = false;
+      if (pre_gate_ && pre_gate_->IsNonSpeech(p, window_size)) {
+        ++num_skipped_windows_;
+        ++num_consecutive_skipped_;
+
+        // The states of the model are stale after a long gap. Reset them
+        // once so that the next speech starts from a clean state.
+        this_window_is_speech = model_->SkipWindow(
+            num_consecutive_skipped_ == config_.pre_gate.reset_after_windows);
+      } else {
+        num_consecutive_skipped_ = 0;
+        this_window_is_speech = model_->IsSpeech(p, window_size);
+      }
+      ++num_windows_;
+
       is_speech = is_speech || this_window_is_speech;
     }
 
     last_ = std::vector<float>(
         p, static_cast<const float *>(last_.data()) + last_.size());
 
-    if (is_speech) {
-      if (start_ == -1) {
-        // beginning of speech
-        start_ = std::max(buffer_.Tail() - 2 * model_->WindowSize() -
-                              model_->MinSpeechDurationSamples(),
-                          buffer_.Head());
-      }
-    } else {
-      // non-speech
-      if (start_ != -1 && buffer_.Size()) {
-        // end of speech, save the speech segment
-        int32_t end = buffer_.Tail() - model_->MinSilenceDurationSamples();
-
-        std::vector<float> s = buffer_.Get(start_, end - start_);
-        SpeechSegment segment;
-
-        segment.start = start_;
-        segment.samples = std::move(s);
-
-        segments_.push(std::move(segment));
-
-        buffer_.Pop(end - buffer_.Head());
-      }
-
-      if (start_ == -1) {
-        int32_t end = buffer_.Tail() - 2 * model_->WindowSize() -
-                      model_->MinSpeechDurationSamples();
-        int32_t n = std::max(0, end - buffer_.Head());
-        if (n > 0) {
-          buffer_.Pop(n);
-        }
-      }
-
-      start_ = -1;
-    }
+    segmenter_.Update(is_speech, model_->MinSilenceDurationSamples());
   }
 
-  bool Empty() const { return segments_.empty(); }
+  bool Empty() const { return segmenter_.Empty(); }
 
-  void Pop() { segments_.pop(); }
+  void Pop() { segmenter_.Pop(); }
 
-  void Clear() { std::queue<SpeechSegment>().swap(segments_); }
+  void Clear() { segmenter_.Clear(); }
 
-  const SpeechSegment &Front() const { return segments_.front(); }
+  const SpeechSegment &Front() const { return segmenter_.Front(); }
 
   void Reset() {
-    std::queue<SpeechSegment>().swap(segments_);
-
     model_->Reset();
-    buffer_.Reset();
+    segmenter_.Reset();
     last_.clear();
 
-    start_ = -1;
+    num_windows_ = 0;
+    num_skipped_windows_ = 0;
+    num_consecutive_skipped_ = 0;
   }
 
-  void Flush() {
-    if (start_ == -1 || buffer_.Size() == 0) {
-      return;
-    }
-
-    int32_t end = buffer_.Tail();
-    if (end <= start_) {
-      return;
-    }
-
-    std::vector<float> s = buffer_.Get(start_, end - start_);
-
-    SpeechSegment segment;
-
-    segment.start = start_;
-    segment.samples = std::move(s);
+  void Flush() { segmenter_.Flush(); }
 
-    segments_.push(std::move(segment));
+  bool IsSpeechDetected() const { return segmenter_.IsSpeechDetected(); }
 
-    buffer_.Pop(end - buffer_.Head());
-    start_ = -1;
-  }
+  const VadModelConfig &GetConfig() const { return config_; }
 
-  bool IsSpeechDetected() const { return start_ != -1; }
+  int64_t NumWindows() const { return num_windows_; }
 
-  const VadModelConfig &GetConfig() const { return config_; }
+  int64_t NumSkippedWindows() const { return num_skipped_windows_; }
 
  private:
   void Init() {
@@ -165,21 +131,27 @@ class VoiceActivityDetector::Impl {
     // where max_speech_duration is placed.
     max_utterance_length_ =
         config_.sample_rate * config_.silero_vad.max_speech_duration;
+
+    if (config_.pre_gate.enabled) {
+      pre_gate_ = std::make_unique<VadPreGate>(config_.pre_gate);
+    }
   }
 
  private:
-  std::queue<SpeechSegment> segments_;
-
   std::unique_ptr<VadModel> model_;
   VadModelConfig config_;
-  CircularBuffer buffer_;
+  VadSegmenter segmenter_;
   std::vector<float> last_;
 
+  // It is nullptr if the pre-gate is disabled
+  std::unique_ptr<VadPreGate> pre_gate_;
+  int64_t num_windows_ = 0;
+  int64_t num_skipped_windows_ = 0;
+  int32_t num_consecutive_skipped_ = 0;
+
   int max_utterance_length_ = -1;  // in samples
   float new_min_silence_duration_s_ = 0.1;
   float new_threshold_ = 0.90;
-
-  int32_t start_ = -1;
 };
 
 VoiceActivityDetector::VoiceActivityDetector(
@@ -220,6 +192,14 @@ const VadModelConfig &VoiceActivityDetector::GetConfig() const {
   return impl_->GetConfig();
 }
 
+int64_t VoiceActivityDetector::NumWindows() const {
+  return impl_->NumWindows();
+}
+
+int64_t VoiceActivityDetector::NumSkippedWindows() const {
+  return impl_->NumSkippedWindows();
+}
+
 #if __ANDROID_API__ >= 9
 template VoiceActivityDetector::VoiceActivityDetector(
     AAssetManager *mgr, const VadModelConfig &config,
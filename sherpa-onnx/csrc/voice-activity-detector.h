@@ -4,6 +4,7 @@
 #ifndef SHERPA_ONNX_CSRC_VOICE_ACTIVITY_DETECTOR_H_
 #define SHERPA_ONNX_CSRC_VOICE_ACTIVITY_DETECTOR_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -43,6 +44,13 @@ class VoiceActivityDetector {
 
   const VadModelConfig &GetConfig() const;
 
+  // Number of windows processed since the last Reset()
+  int64_t NumWindows() const;
+
+  // Number of windows for which the model was not run because
+  // VadModelConfig::pre_gate classified them as non-speech
+  int64_t NumSkippedWindows() const;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -0,0 +1,170 @@
+// sherpa-onnx/csrc/wave-reader-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+// Write interleaved samples with the given format. Each sample in `data`
+// has bits_per_sample / 8 bytes.
+static void WriteTestWave(const std::string &filename, int16_t audio_format,
+                          int16_t num_channels, int16_t bits_per_sample,
+                          const std::vector<char> &data,
+                          int32_t data_size_in_header) {
+  int32_t sample_rate = 16000;
+  int16_t block_align = num_channels * bits_per_sample / 8;
+  int32_t byte_rate = sample_rate * block_align;
+  int32_t chunk_size = 36 + data.size();
+  int32_t fmt_size = 16;
+
+  std::ofstream os(filename, std::ios::binary);
+  os.write("RIFF", 4);
+  os.write(reinterpret_cast<const char *>(&chunk_size), 4);
+  os.write("WAVE", 4);
+  os.write("fmt ", 4);
+  os.write(reinterpret_cast<const char *>(&fmt_size), 4);
+  os.write(reinterpret_cast<const char *>(&audio_format), 2);
+  os.write(reinterpret_cast<const char *>(&num_channels), 2);
+  os.write(reinterpret_cast<const char *>(&sample_rate), 4);
+  os.write(reinterpret_cast<const char *>(&byte_rate), 4);
+  os.write(reinterpret_cast<const char *>(&block_align), 2);
+  os.write(reinterpret_cast<const char *>(&bits_per_sample), 2);
+  os.write("data", 4);
+  os.write(reinterpret_cast<const char *>(&data_size_in_header), 4);
+  os.write(data.data(), data.size());
+}
+
+static std::vector<char> RandomBytes(int32_t n) {
+  std::mt19937 gen(20250103);
+  std::uniform_int_distribution<int32_t> dist(0, 255);
+
+  std::vector<char> ans(n);
+  for (auto &c : ans) {
+    c = static_cast<char>(dist(gen));
+  }
+
+  return ans;
+}
+
+static void ExpectSameAsReadWave(const std::string &filename,
+                                 int32_t num_channels) {
+  int32_t sample_rate = 0;
+  bool is_ok = false;
+  std::ifstream is(filename, std::ios::binary);
+  auto expected = ReadWaveMultiChannel(is, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+
+  StreamingWaveReader reader(filename);
+  ASSERT_TRUE(reader.IsOk());
+  EXPECT_EQ(reader.SampleRate(), sample_rate);
+  EXPECT_EQ(reader.NumChannels(), num_channels);
+  ASSERT_EQ(reader.NumSamples(), static_cast<int64_t>(expected[0].size()));
+
+  for (int32_t c = 0; c != num_channels; ++c) {
+    std::vector<float> y;
+    // an odd chunk size to test the boundaries
+    for (const auto &chunk : reader.Chunks(1001, c)) {
+      y.insert(y.end(), chunk.begin(), chunk.end());
+    }
+
+    ASSERT_EQ(y.size(), expected[c].size());
+    for (size_t i = 0; i != y.size(); ++i) {
+      EXPECT_EQ(y[i], expected[c][i]) << c << ", " << i;
+    }
+  }
+}
+
+TEST(StreamingWaveReader, Int16) {
+  std::string filename = "./wave-reader-test-int16.wav";
+
+  for (int32_t num_channels : {1, 2}) {
+    auto data = RandomBytes(2 * num_channels * 10007);
+    WriteTestWave(filename, 1, num_channels, 16, data, data.size());
+    ExpectSameAsReadWave(filename, num_channels);
+  }
+
+  remove(filename.c_str());
+}
+
+TEST(StreamingWaveReader, Int24) {
+  std::string filename = "./wave-reader-test-int24.wav";
+
+  for (int32_t num_channels : {1, 2}) {
+    auto data = RandomBytes(3 * num_channels * 10007);
+    WriteTestWave(filename, 1, num_channels, 24, data, data.size());
+    ExpectSameAsReadWave(filename, num_channels);
+
+    StreamingWaveReader reader(filename);
+    float f = 0;
+    reader.ReadAt(5, 1, &f);
+
+    const auto *p =
+        reinterpret_cast<const uint8_t *>(data.data() + 5 * 3 * num_channels);
+    int32_t v = (p[0] | (p[1] << 8) | (p[2] << 16));
+    if (v & 0x800000) {
+      v -= 0x1000000;
+    }
+    EXPECT_EQ(f, v / 8388608.0f);
+  }
+
+  remove(filename.c_str());
+}
+
+TEST(StreamingWaveReader, Float32) {
+  std::string filename = "./wave-reader-test-float32.wav";
+
+  std::vector<float> samples(2 * 5000);
+  for (int32_t i = 0; i != static_cast<int32_t>(samples.size()); ++i) {
+    samples[i] = (i % 200) / 100.0f - 1;
+  }
+
+  std::vector<char> data(samples.size() * sizeof(float));
+  memcpy(data.data(), samples.data(), data.size());
+
+  WriteTestWave(filename, 3, 2, 32, data, data.size());
+  ExpectSameAsReadWave(filename, 2);
+
+  remove(filename.c_str());
+}
+
+TEST(StreamingWaveReader, UnpatchedHeader) {
+  // A streaming writer that was not closed leaves 0 as the data size
+  std::string filename = "./wave-reader-test-unpatched.wav";
+  auto data = RandomBytes(2 * 3000);
+  WriteTestWave(filename, 1, 1, 16, data, 0);
+
+  StreamingWaveReader reader(filename);
+  ASSERT_TRUE(reader.IsOk());
+  EXPECT_EQ(reader.NumSamples(), 3000);
+
+  std::vector<float> buf(2000);
+  EXPECT_EQ(reader.Read(2000, buf.data()), 2000);
+  EXPECT_EQ(reader.Read(2000, buf.data()), 1000);
+  EXPECT_EQ(reader.Read(2000, buf.data()), 0);
+
+  remove(filename.c_str());
+}
+
+TEST(StreamingWaveReader, NonExistentFile) {
+  StreamingWaveReader reader("./a-file-that-does-not-exist.wav");
+  EXPECT_FALSE(reader.IsOk());
+
+  int32_t num_chunks = 0;
+  for (const auto &chunk : reader.Chunks(100)) {
+    (void)chunk;
+    ++num_chunks;
+  }
+  EXPECT_EQ(num_chunks, 0);
+}
+
+}  // namespace sherpa_onnx
@@ -4,12 +4,24 @@
 
 #include "sherpa-onnx/csrc/wave-reader.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <streambuf>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHERPA_ONNX_WAVE_READER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SHERPA_ONNX_WAVE_READER_NEON 1
+#endif
+
 #include "sherpa-onnx/csrc/macros.h"
 
 namespace sherpa_onnx {
@@ -51,6 +63,125 @@ struct WaveHeader {
 };
 static_assert(sizeof(WaveHeader) == 44);
 
+// A read-only std::streambuf over a memory region so that ReadWaveHeader()
+// can parse a memory mapped file.
+class MemoryStreamBuf : public std::streambuf {
+ public:
+  MemoryStreamBuf(const char *data, size_t size) {
+    char *p = const_cast<char *>(data);
+    setg(p, p, p + size);
+  }
+
+ protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode /*which*/) override {
+    char *p = dir == std::ios_base::beg   ? eback()
+              : dir == std::ios_base::cur ? gptr()
+                                          : egptr();
+    if (off < eback() - p || off > egptr() - p) {
+      return pos_type(off_type(-1));
+    }
+
+    p += off;
+    setg(eback(), p, egptr());
+
+    return pos_type(p - eback());
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+
+// Convert n interleaved samples starting at `p` to float. Only every
+// `stride`-th sample is converted, so stride is the number of channels.
+// The input may be unaligned.
+void Int16ToFloat(const char *p, int32_t n, int32_t stride, float *out) {
+  int32_t i = 0;
+  if (stride == 1) {
+#if defined(SHERPA_ONNX_WAVE_READER_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / 32768);
+    for (; i + 8 <= n; i += 8) {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 2 * i));
+      // sign extend to int32
+      __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+      __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+      _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+      _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#elif defined(SHERPA_ONNX_WAVE_READER_NEON)
+    const float scale = 1.0f / 32768;
+    for (; i + 8 <= n; i += 8) {
+      int16x8_t x = vreinterpretq_s16_u8(
+          vld1q_u8(reinterpret_cast<const uint8_t *>(p + 2 * i)));
+      float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+      float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+      vst1q_f32(out + i, vmulq_n_f32(lo, scale));
+      vst1q_f32(out + i + 4, vmulq_n_f32(hi, scale));
+    }
+#endif
+  }
+
+  for (; i < n; ++i) {
+    int16_t v;
+    memcpy(&v, p + 2 * i * stride, sizeof(v));
+    out[i] = v / 32768.0f;
+  }
+}
+
+void Int24ToFloat(const char *p, int32_t n, int32_t stride, float *out) {
+  auto q = reinterpret_cast<const uint8_t *>(p);
+  for (int32_t i = 0; i < n; ++i, q += 3 * stride) {
+    // shift left then right to sign extend
+    int32_t v = static_cast<int32_t>(static_cast<uint32_t>(q[0]) << 8 |
+                                     static_cast<uint32_t>(q[1]) << 16 |
+                                     static_cast<uint32_t>(q[2]) << 24) >>
+                8;
+    out[i] = v / 8388608.0f;
+  }
+}
+
+// Decode n samples of one channel. `p` points to the first sample of the
+// channel in the interleaved data.
+void DecodeSamples(const WaveHeader &header, const char *p, int32_t n,
+                   float *out) {
+  int32_t stride = header.num_channels;
+
+  if (header.audio_format == 3) {
+    if (stride == 1) {
+      memcpy(out, p, n * sizeof(float));
+    } else {
+      for (int32_t i = 0; i != n; ++i) {
+        memcpy(out + i, p + 4 * i * stride, sizeof(float));
+      }
+    }
+    return;
+  }
+
+  switch (header.bits_per_sample) {
+    case 8:
+      for (int32_t i = 0; i != n; ++i) {
+        out[i] = static_cast<uint8_t>(p[i * stride]) / 128.0f - 1;
+      }
+      break;
+    case 16:
+      Int16ToFloat(p, n, stride, out);
+      break;
+    case 24:
+      Int24ToFloat(p, n, stride, out);
+      break;
+    case 32:
+      for (int32_t i = 0; i != n; ++i) {
+        int32_t v;
+        memcpy(&v, p + 4 * i * stride, sizeof(v));
+        out[i] = static_cast<float>(v) / (1u << 31);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
 /*
 sox int16-1-channel-zh.wav -b 8 int8-1-channel-zh.wav
 
@@ -61,20 +192,17 @@ because sox uses WAVE_FORMAT_EXTENSIBLE, which is not easy to support
 in sherpa-onnx.
  */
 
-// Read a wave file of mono-channel.
-// Return its samples normalized to the range [-1, 1).
-std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
-                                             int32_t *sampling_rate,
-                                             bool *is_ok) {
-  WaveHeader header{};
+// Parse the header and seek to the beginning of the data chunk.
+// Return false if the header is invalid or not supported.
+bool ReadWaveHeader(std::istream &is, WaveHeader *p) {
+  WaveHeader &header = *p;
   is.read(reinterpret_cast<char *>(&header.chunk_id), sizeof(header.chunk_id));
 
   //                        F F I R
   if (header.chunk_id != 0x46464952) {
     SHERPA_ONNX_LOGE("Expected chunk_id RIFF. Given: 0x%08x\n",
                      header.chunk_id);
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   is.read(reinterpret_cast<char *>(&header.chunk_size),
@@ -85,8 +213,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
   //                      E V A W
   if (header.format != 0x45564157) {
     SHERPA_ONNX_LOGE("Expected format WAVE. Given: 0x%08x\n", header.format);
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   is.read(reinterpret_cast<char *>(&header.subchunk1_id),
@@ -109,8 +236,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
   if (header.subchunk1_id != 0x20746d66) {
     SHERPA_ONNX_LOGE("Expected subchunk1_id 0x20746d66. Given: 0x%08x\n",
                      header.subchunk1_id);
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   // NAudio uses 18
@@ -119,8 +245,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
       header.subchunk1_size != 18) {  // 16 for PCM
     SHERPA_ONNX_LOGE("Expected subchunk1_size 16. Given: %d\n",
                      header.subchunk1_size);
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   is.read(reinterpret_cast<char *>(&header.audio_format),
@@ -138,8 +263,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
       SHERPA_ONNX_LOGE("We don't support WAVE_FORMAT_EXTENSIBLE files.");
     }
 
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   is.read(reinterpret_cast<char *>(&header.num_channels),
@@ -162,8 +286,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
     SHERPA_ONNX_LOGE("Incorrect byte rate: %d. Expected: %d", header.byte_rate,
                      (header.sample_rate * header.num_channels *
                       header.bits_per_sample / 8));
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   if (header.block_align !=
@@ -171,16 +294,14 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
     SHERPA_ONNX_LOGE("Incorrect block align: %d. Expected: %d\n",
                      header.block_align,
                      (header.num_channels * header.bits_per_sample / 8));
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   if (header.bits_per_sample != 8 && header.bits_per_sample != 16 &&
-      header.bits_per_sample != 32) {
-    SHERPA_ONNX_LOGE("Expected bits_per_sample 8, 16 or 32. Given: %d\n",
+      header.bits_per_sample != 24 && header.bits_per_sample != 32) {
+    SHERPA_ONNX_LOGE("Expected bits_per_sample 8, 16, 24 or 32. Given: %d\n",
                      header.bits_per_sample);
-    *is_ok = false;
-    return {};
+    return false;
   }
 
   if (header.subchunk1_size == 18) {
@@ -195,8 +316,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
           "Extra size should be 0 for wave from NAudio. Current extra size "
           "%d\n",
           extra_size);
-      *is_ok = false;
-      return {};
+      return false;
     }
   }
 
@@ -207,7 +327,17 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
           sizeof(header.subchunk2_size));
 
   header.SeekToDataChunk(is);
-  if (!is) {
+
+  return static_cast<bool>(is);
+}
+
+// Read a wave file of mono-channel.
+// Return its samples normalized to the range [-1, 1).
+std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
+                                             int32_t *sampling_rate,
+                                             bool *is_ok) {
+  WaveHeader header{};
+  if (!ReadWaveHeader(is, &header)) {
     *is_ok = false;
     return {};
   }
@@ -268,6 +398,22 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
         ans[c][k] = samples[i + c] / 128. - 1;
       }
     }
+  } else if (header.bits_per_sample == 24 && header.audio_format == 1) {
+    std::vector<char> samples(header.subchunk2_size);
+
+    is.read(samples.data(), header.subchunk2_size);
+    if (!is) {
+      SHERPA_ONNX_LOGE("Failed to read %d bytes", header.subchunk2_size);
+      *is_ok = false;
+      return {};
+    }
+
+    int32_t num_samples = samples.size() / header.block_align;
+    for (int32_t c = 0; c != header.num_channels; ++c) {
+      ans[c].resize(num_samples);
+      DecodeSamples(header, samples.data() + 3 * c, num_samples,
+                    ans[c].data());
+    }
   } else if (header.bits_per_sample == 32 && header.audio_format == 1) {
     // 32 here is for int32
     //
@@ -321,7 +467,7 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
   } else {
     SHERPA_ONNX_LOGE(
         "Unsupported %d bits per sample and audio format: %d. Supported values "
-        "are: 8, 16, 32.",
+        "are: 8, 16, 24, 32.",
         header.bits_per_sample, header.audio_format);
     *is_ok = false;
     return {};
@@ -365,4 +511,118 @@ std::vector<std::vector<float>> ReadWaveMultiChannel(
   return ReadWaveMultiChannel(is, sampling_rate, is_ok);
 }
 
+StreamingWaveReader::StreamingWaveReader(const std::string &filename)
+    : file_(filename) {
+  if (!file_.IsOk()) {
+    return;
+  }
+
+  MemoryStreamBuf buf(file_.Data(), file_.Size());
+  std::istream is(&buf);
+
+  WaveHeader header{};
+  if (!ReadWaveHeader(is, &header)) {
+    SHERPA_ONNX_LOGE("Failed to parse the header of '%s'", filename.c_str());
+    return;
+  }
+
+  if (header.num_channels <= 0) {
+    SHERPA_ONNX_LOGE("Invalid number of channels %d in '%s'",
+                     header.num_channels, filename.c_str());
+    return;
+  }
+
+  if (header.audio_format == 3 && header.bits_per_sample != 32) {
+    SHERPA_ONNX_LOGE("Unsupported %d bits per sample for float samples",
+                     header.bits_per_sample);
+    return;
+  }
+
+  data_offset_ = static_cast<int64_t>(is.tellg());
+
+  // Files that are still being written, or that are written by a streaming
+  // writer without patching the header, may have a data size of 0 or -1.
+  // Use the rest of the file in that case.
+  int64_t num_bytes = static_cast<int64_t>(file_.Size()) - data_offset_;
+  if (header.subchunk2_size > 0) {
+    num_bytes = std::min<int64_t>(num_bytes,
+                                  static_cast<uint32_t>(header.subchunk2_size));
+  }
+
+  sample_rate_ = header.sample_rate;
+  num_channels_ = header.num_channels;
+  bits_per_sample_ = header.bits_per_sample;
+  audio_format_ = header.audio_format;
+  block_align_ = header.block_align;
+  num_samples_ = num_bytes / block_align_;
+  is_ok_ = true;
+}
+
+int32_t StreamingWaveReader::ReadAt(int64_t start, int32_t n, float *out,
+                                    int32_t channel /*= 0*/) const {
+  if (!is_ok_ || start < 0 || start >= num_samples_ || n <= 0) {
+    return 0;
+  }
+
+  if (channel < 0 || channel >= num_channels_) {
+    SHERPA_ONNX_LOGE("Invalid channel %d. Number of channels: %d", channel,
+                     num_channels_);
+    return 0;
+  }
+
+  n = static_cast<int32_t>(std::min<int64_t>(n, num_samples_ - start));
+
+  WaveHeader header{};
+  header.audio_format = audio_format_;
+  header.num_channels = num_channels_;
+  header.bits_per_sample = bits_per_sample_;
+
+  const char *p = file_.Data() + data_offset_ + start * block_align_ +
+                  channel * (bits_per_sample_ / 8);
+
+  DecodeSamples(header, p, n, out);
+
+  return n;
+}
+
+int32_t StreamingWaveReader::Read(int32_t n, float *out,
+                                  int32_t channel /*= 0*/) {
+  int32_t k = ReadAt(pos_, n, out, channel);
+  pos_ += k;
+  return k;
+}
+
+void StreamingWaveReader::Seek(int64_t sample) {
+  pos_ = std::max<int64_t>(0, std::min(sample, num_samples_));
+}
+
+StreamingWaveReader::ChunkIterator::ChunkIterator(
+    const StreamingWaveReader *reader, int64_t pos, int32_t chunk_size,
+    int32_t channel)
+    : reader_(reader), pos_(pos), chunk_size_(chunk_size), channel_(channel) {
+  Decode();
+}
+
+StreamingWaveReader::ChunkIterator &
+StreamingWaveReader::ChunkIterator::operator++() {
+  pos_ += static_cast<int64_t>(chunk_.size());
+  Decode();
+  return *this;
+}
+
+void StreamingWaveReader::ChunkIterator::Decode() {
+  if (!reader_ || pos_ >= reader_->NumSamples()) {
+    chunk_.clear();
+    return;
+  }
+
+  chunk_.resize(std::min<int64_t>(chunk_size_, reader_->NumSamples() - pos_));
+  reader_->ReadAt(pos_, chunk_.size(), chunk_.data(), channel_);
+}
+
+StreamingWaveReader::ChunkRange StreamingWaveReader::Chunks(
+    int32_t chunk_size, int32_t channel /*= 0*/) const {
+  return ChunkRange(this, std::max(chunk_size, 1), channel);
+}
+
 }  // namespace sherpa_onnx
@@ -5,10 +5,13 @@
 #ifndef SHERPA_ONNX_CSRC_WAVE_READER_H_
 #define SHERPA_ONNX_CSRC_WAVE_READER_H_
 
+#include <cstdint>
 #include <istream>
 #include <string>
 #include <vector>
 
+#include "sherpa-onnx/csrc/file-utils.h"
+
 namespace sherpa_onnx {
 
 /** Read a wave file with expected sample rate.
@@ -33,6 +36,137 @@ std::vector<std::vector<float>> ReadWaveMultiChannel(std::istream &is,
 std::vector<std::vector<float>> ReadWaveMultiChannel(
     const std::string &filename, int32_t *sampling_rate, bool *is_ok);
 
+/** Read a wave file in chunks without loading all of it into memory.
+
+    The file is memory mapped and samples are decoded on demand, so it
+    works for files of several GB. It supports 8/16/24/32-bit integer and
+    32-bit float PCM with any number of channels.
+
+    Usage:
+
+      StreamingWaveReader reader("./foo.wav");
+      if (!reader.IsOk()) { ... }
+
+      for (const auto &chunk : reader.Chunks(reader.SampleRate())) {
+        // chunk is a std::vector<float> containing at most 1 second
+        stream->AcceptWaveformChunk(reader.SampleRate(), chunk.data(),
+                                    chunk.size());
+      }
+      stream->InputFinished();
+ */
+class StreamingWaveReader {
+ public:
+  class ChunkIterator {
+   public:
+    ChunkIterator(const StreamingWaveReader *reader, int64_t pos,
+                  int32_t chunk_size, int32_t channel);
+
+    const std::vector<float> &operator*() const { return chunk_; }
+    const std::vector<float> *operator->() const { return &chunk_; }
+
+    ChunkIterator &operator++();
+
+    bool operator==(const ChunkIterator &other) const {
+      return pos_ == other.pos_;
+    }
+
+    bool operator!=(const ChunkIterator &other) const {
+      return !(*this == other);
+    }
+
+   private:
+    void Decode();
+
+   private:
+    const StreamingWaveReader *reader_ = nullptr;
+    int64_t pos_ = 0;
+    int32_t chunk_size_ = 0;
+    int32_t channel_ = 0;
+
+    // reused across chunks
+    std::vector<float> chunk_;
+  };
+
+  class ChunkRange {
+   public:
+    ChunkRange(const StreamingWaveReader *reader, int32_t chunk_size,
+               int32_t channel)
+        : reader_(reader), chunk_size_(chunk_size), channel_(channel) {}
+
+    ChunkIterator begin() const {
+      return ChunkIterator(reader_, 0, chunk_size_, channel_);
+    }
+
+    ChunkIterator end() const {
+      return ChunkIterator(reader_, reader_->NumSamples(), chunk_size_,
+                           channel_);
+    }
+
+   private:
+    const StreamingWaveReader *reader_;
+    int32_t chunk_size_;
+    int32_t channel_;
+  };
+
+  explicit StreamingWaveReader(const std::string &filename);
+
+  // Return false if the file does not exist or is not a supported wave file
+  bool IsOk() const { return is_ok_; }
+
+  int32_t SampleRate() const { return sample_rate_; }
+
+  int32_t NumChannels() const { return num_channels_; }
+
+  // Number of samples per channel
+  int64_t NumSamples() const { return num_samples_; }
+
+  /** Decode samples [start, start + n) of the given channel.
+
+      It does not change the read position used by Read(), so it can be
+      called from multiple threads.
+
+      @param start Index of the first sample to decode.
+      @param n Number of samples to decode.
+      @param out On return, it contains the decoded samples normalized to
+                 the range [-1, 1). It must have room for n samples.
+      @param channel Index of the channel to decode.
+
+      @return Return the number of decoded samples, which is less than n
+              near the end of the file.
+   */
+  int32_t ReadAt(int64_t start, int32_t n, float *out,
+                 int32_t channel = 0) const;
+
+  // Like ReadAt() but decodes from the current read position and advances
+  // it by the number of returned samples.
+  int32_t Read(int32_t n, float *out, int32_t channel = 0);
+
+  void Seek(int64_t sample);
+
+  int64_t Tell() const { return pos_; }
+
+  // Return a range of chunks of chunk_size samples of the given channel.
+  // The last chunk may be shorter.
+  ChunkRange Chunks(int32_t chunk_size, int32_t channel = 0) const;
+
+ private:
+  MappedFile file_;
+  bool is_ok_ = false;
+
+  int32_t sample_rate_ = 0;
+  int32_t num_channels_ = 0;
+  int32_t bits_per_sample_ = 0;
+  int32_t audio_format_ = 0;
+  int32_t block_align_ = 0;
+
+  // byte offset of the first sample in the file
+  int64_t data_offset_ = 0;
+  int64_t num_samples_ = 0;
+
+  // read position in samples for Read()
+  int64_t pos_ = 0;
+};
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_WAVE_READER_H_
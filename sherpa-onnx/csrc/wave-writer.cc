@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/telephony-encoder.h"
 
 namespace sherpa_onnx {
 namespace {
@@ -35,6 +36,60 @@ struct WaveHeader {
   int32_t subchunk2_size;  // size of subchunk2
 };
 
+void AppendInt32(int32_t v, std::string *s) {
+  // Note: We assume little endian here
+  s->append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void AppendInt16(int16_t v, std::string *s) {
+  s->append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+// Offset of the "fmt " chunk in the header
+constexpr int32_t kFmtChunkOffset = 12;
+
+// A-law and mu-law files use an 18-byte fmt chunk followed by a fact chunk.
+constexpr int32_t kFactSampleOffset = kFmtChunkOffset + 8 + 18 + 8;
+
+std::string BuildStreamingHeader(int32_t sampling_rate, AudioEncoding encoding,
+                                 int32_t num_channels) {
+  bool is_pcm = encoding == AudioEncoding::kPcm16;
+  int32_t bits_per_sample = BytesPerSample(encoding) * 8;
+  int32_t block_align = BytesPerSample(encoding) * num_channels;
+
+  int16_t audio_format = 1;  // PCM
+  if (encoding == AudioEncoding::kAlaw) {
+    audio_format = 6;
+  } else if (encoding == AudioEncoding::kMulaw) {
+    audio_format = 7;
+  }
+
+  std::string h;
+  AppendInt32(0x46464952, &h);  // FFIR
+  AppendInt32(0, &h);           // chunk_size, patched in Close()
+  AppendInt32(0x45564157, &h);  // EVAW
+  AppendInt32(0x20746d66, &h);  // "fmt "
+  AppendInt32(is_pcm ? 16 : 18, &h);
+  AppendInt16(audio_format, &h);
+  AppendInt16(num_channels, &h);
+  AppendInt32(sampling_rate, &h);
+  AppendInt32(sampling_rate * block_align, &h);  // byte_rate
+  AppendInt16(block_align, &h);
+  AppendInt16(bits_per_sample, &h);
+
+  if (!is_pcm) {
+    AppendInt16(0, &h);           // cbSize
+    AppendInt32(0x74636166, &h);  // tcaf
+    AppendInt32(4, &h);
+    AppendInt32(0, &h);  // number of samples, patched in Close()
+  }
+
+  AppendInt32(0x61746164, &h);  // atad
+  AppendInt32(0, &h);           // subchunk2_size, patched in Close()
+
+  return h;
+}
+
 }  // namespace
 
 int64_t WaveFileSize(int32_t n_samples, int32_t num_channels /*= 1*/) {
@@ -123,4 +178,171 @@ void WriteWave(char *buffer, int32_t sampling_rate, const float *samples_ch0,
   }
 }
 
+WaveWriter::~WaveWriter() {
+  if (IsOpen()) {
+    Close();
+  }
+}
+
+bool WaveWriter::Open(const std::string &filename, int32_t sampling_rate) {
+  return Open(filename, sampling_rate, AudioEncoding::kPcm16);
+}
+
+bool WaveWriter::Open(const std::string &filename, int32_t sampling_rate,
+                      AudioEncoding encoding) {
+  return Open(filename, sampling_rate, encoding, 1);
+}
+
+bool WaveWriter::Open(const std::string &filename, int32_t sampling_rate,
+                      AudioEncoding encoding, int32_t num_channels) {
+  if (IsOpen()) {
+    Close();
+  }
+
+  if (num_channels != 1 && num_channels != 2) {
+    SHERPA_ONNX_LOGE("Only 1 or 2 channels are supported. Given: %d",
+                     num_channels);
+    return false;
+  }
+
+  os_.open(filename, std::ios::binary | std::ios::trunc);
+  if (!os_) {
+    SHERPA_ONNX_LOGE("Failed to create '%s'", filename.c_str());
+    return false;
+  }
+
+  std::string header =
+      BuildStreamingHeader(sampling_rate, encoding, num_channels);
+  os_.write(header.data(), header.size());
+  if (!os_) {
+    SHERPA_ONNX_LOGE("Write '%s' failed", filename.c_str());
+    os_.close();
+    return false;
+  }
+
+  filename_ = filename;
+  encoding_ = encoding;
+  num_channels_ = num_channels;
+  header_size_ = header.size();
+  num_bytes_ = 0;
+
+  return true;
+}
+
+bool WaveWriter::Write(const float *samples, int32_t n) {
+  if (!IsOpen()) {
+    SHERPA_ONNX_LOGE("Please call Open() first");
+    return false;
+  }
+
+  if (num_channels_ != 1) {
+    SHERPA_ONNX_LOGE("'%s' has %d channels. Please pass samples of each "
+                     "channel",
+                     filename_.c_str(), num_channels_);
+    return false;
+  }
+
+  // Convert in blocks so that the buffer stays small for long inputs
+  constexpr int32_t kBlockSize = 4096;
+  buffer_.resize(kBlockSize * BytesPerSample(encoding_));
+
+  for (int32_t i = 0; i < n; i += kBlockSize) {
+    int32_t m = std::min(kBlockSize, n - i);
+    EncodeAudio(encoding_, samples + i, m, buffer_.data());
+    if (!WriteEncoded(buffer_.data(), m * BytesPerSample(encoding_))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool WaveWriter::Write(const float *samples_ch0, const float *samples_ch1,
+                       int32_t n) {
+  if (!IsOpen()) {
+    SHERPA_ONNX_LOGE("Please call Open() first");
+    return false;
+  }
+
+  if (num_channels_ != 2) {
+    SHERPA_ONNX_LOGE("'%s' has a single channel", filename_.c_str());
+    return false;
+  }
+
+  constexpr int32_t kBlockSize = 4096;
+  interleaved_.resize(kBlockSize * 2);
+  buffer_.resize(kBlockSize * 2 * BytesPerSample(encoding_));
+
+  for (int32_t i = 0; i < n; i += kBlockSize) {
+    int32_t m = std::min(kBlockSize, n - i);
+    for (int32_t k = 0; k != m; ++k) {
+      interleaved_[2 * k] = samples_ch0[i + k];
+      interleaved_[2 * k + 1] = samples_ch1[i + k];
+    }
+
+    EncodeAudio(encoding_, interleaved_.data(), 2 * m, buffer_.data());
+    if (!WriteEncoded(buffer_.data(), 2 * m * BytesPerSample(encoding_))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool WaveWriter::WriteEncoded(const uint8_t *data, int32_t n) {
+  if (!IsOpen()) {
+    SHERPA_ONNX_LOGE("Please call Open() first");
+    return false;
+  }
+
+  os_.write(reinterpret_cast<const char *>(data), n);
+  if (!os_) {
+    SHERPA_ONNX_LOGE("Write '%s' failed", filename_.c_str());
+    return false;
+  }
+
+  num_bytes_ += n;
+
+  return true;
+}
+
+int64_t WaveWriter::NumSamples() const {
+  return num_bytes_ / (BytesPerSample(encoding_) * num_channels_);
+}
+
+bool WaveWriter::Close() {
+  if (!IsOpen()) {
+    return false;
+  }
+
+  int64_t riff_size = header_size_ - 8 + num_bytes_;
+  if (num_bytes_ % 2) {
+    // RIFF chunks are padded to an even size
+    os_.put(0);
+    riff_size += 1;
+  }
+
+  auto patch = [this](int32_t offset, int32_t value) {
+    os_.seekp(offset);
+    os_.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+
+  patch(4, static_cast<int32_t>(riff_size));
+
+  if (encoding_ != AudioEncoding::kPcm16) {
+    patch(kFactSampleOffset, static_cast<int32_t>(NumSamples()));
+  }
+
+  patch(header_size_ - 4, static_cast<int32_t>(num_bytes_));
+
+  bool ok = static_cast<bool>(os_);
+  os_.close();
+
+  if (!ok) {
+    SHERPA_ONNX_LOGE("Failed to finalize '%s'", filename_.c_str());
+  }
+
+  return ok;
+}
+
 }  // namespace sherpa_onnx
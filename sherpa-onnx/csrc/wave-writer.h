@@ -6,10 +6,15 @@
 #define SHERPA_ONNX_CSRC_WAVE_WRITER_H_
 
 #include <cstdint>
+#include <fstream>
 #include <string>
+#include <vector>
 
 namespace sherpa_onnx {
 
+// See telephony-encoder.h
+enum class AudioEncoding : int32_t;
+
 // Write a single channel wave file.
 // Note that the input samples are in the range [-1, 1]. It will be multiplied
 // by 32767 and saved in int16_t format in the wave file.
@@ -33,6 +38,81 @@ void WriteWave(char *buffer, int32_t sampling_rate, const float *samples_ch0,
 
 int64_t WaveFileSize(int32_t n_samples, int32_t num_channels = 1);
 
+// Write a single channel or a two channel wave file incrementally, e.g.,
+// from the callback of OfflineTts::Generate().
+//
+// The header is written with placeholder sizes in Open() and patched in
+// Close(), so the samples never need to be held in memory.
+//
+// Usage:
+//
+//   WaveWriter writer;
+//   writer.Open("out.wav", 8000, AudioEncoding::kMulaw);
+//   writer.Write(samples1, n1);
+//   writer.Write(samples2, n2);
+//   writer.Close();
+class WaveWriter {
+ public:
+  WaveWriter() = default;
+  WaveWriter(const WaveWriter &) = delete;
+  WaveWriter &operator=(const WaveWriter &) = delete;
+
+  // It calls Close() if the file is still open.
+  ~WaveWriter();
+
+  // Same as Open(filename, sampling_rate, AudioEncoding::kPcm16)
+  bool Open(const std::string &filename, int32_t sampling_rate);
+
+  // @param filename Path to save the samples.
+  // @param sampling_rate Sample rate of the samples.
+  // @param encoding Sample format in the file. For kMulaw and kAlaw,
+  //                 the file uses WAVE_FORMAT_MULAW/WAVE_FORMAT_ALAW.
+  // @return Return true if the file is created successfully.
+  bool Open(const std::string &filename, int32_t sampling_rate,
+            AudioEncoding encoding);
+
+  // Same as the above one, but the file has num_channels channels.
+  // num_channels is either 1 or 2.
+  bool Open(const std::string &filename, int32_t sampling_rate,
+            AudioEncoding encoding, int32_t num_channels);
+
+  // Append samples in the range [-1, 1] to a single channel file.
+  bool Write(const float *samples, int32_t n);
+
+  // Append n samples of each channel to a two channel file.
+  bool Write(const float *samples_ch0, const float *samples_ch1, int32_t n);
+
+  // Append n bytes that are already encoded with the encoding passed
+  // to Open(), e.g., frames from TelephonyEncoder.
+  bool WriteEncoded(const uint8_t *data, int32_t n);
+
+  // Patch the header and close the file.
+  bool Close();
+
+  bool IsOpen() const { return os_.is_open(); }
+
+  // Number of samples per channel written so far
+  int64_t NumSamples() const;
+
+ private:
+  std::ofstream os_;
+  std::string filename_;
+  AudioEncoding encoding_{};  // kPcm16; set in Open()
+  int32_t num_channels_ = 1;
+
+  // size of the header in bytes
+  int32_t header_size_ = 0;
+
+  // number of bytes in the data chunk
+  int64_t num_bytes_ = 0;
+
+  // for converting float samples before writing
+  std::vector<uint8_t> buffer_;
+
+  // for interleaving the samples of two channels
+  std::vector<float> interleaved_;
+};
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_WAVE_WRITER_H_
@@ -45,6 +45,18 @@ public class OfflineTts {
         return new GeneratedAudio(samples, sampleRate);
     }
 
+    // priority: 0 for interactive requests and 1 for batch requests.
+    // timeoutMs: work that has not started within it is dropped. <= 0 means no timeout.
+    // token and callback can be null.
+    public GeneratedAudio generateWithOptions(String text, int sid, float speed, int priority, int timeoutMs,
+                                              OfflineTtsCancellationToken token, OfflineTtsCallback callback) {
+        long tokenPtr = token != null ? token.getPtr() : 0;
+        Object[] arr = generateWithOptionsImpl(ptr, text, sid, speed, priority, timeoutMs, tokenPtr, callback);
+        float[] samples = (float[]) arr[0];
+        int sampleRate = (int) arr[1];
+        return new GeneratedAudio(samples, sampleRate);
+    }
+
     @Override
     protected void finalize() throws Throwable {
         release();
@@ -68,5 +80,8 @@ public class OfflineTts {
 
     private native Object[] generateWithCallbackImpl(long ptr, String text, int sid, float speed, OfflineTtsCallback callback);
 
+    private native Object[] generateWithOptionsImpl(long ptr, String text, int sid, float speed, int priority,
+                                                    int timeoutMs, long token, OfflineTtsCallback callback);
+
     private native long newFromFile(OfflineTtsConfig config);
 }
@@ -0,0 +1,47 @@
+// Copyright 2025 Xiaomi Corporation
+
+package com.k2fsa.sherpa.onnx;
+
+// Cancel a running OfflineTts.generateWithOptions() call from another thread,
+// e.g., when the client disconnects. Queued work of the call is dropped.
+public class OfflineTtsCancellationToken {
+    private long ptr = 0;
+
+    public OfflineTtsCancellationToken() {
+        LibraryLoader.maybeLoad();
+        ptr = newToken();
+    }
+
+    public void cancel() {
+        cancel(ptr);
+    }
+
+    public boolean isCancelled() {
+        return isCancelled(ptr);
+    }
+
+    long getPtr() {
+        return ptr;
+    }
+
+    @Override
+    protected void finalize() throws Throwable {
+        release();
+    }
+
+    public void release() {
+        if (this.ptr == 0) {
+            return;
+        }
+        delete(this.ptr);
+        this.ptr = 0;
+    }
+
+    private native long newToken();
+
+    private native void cancel(long ptr);
+
+    private native boolean isCancelled(long ptr);
+
+    private native void delete(long ptr);
+}
@@ -4,7 +4,10 @@
 
 #include "sherpa-onnx/csrc/offline-tts.h"
 
+#include <memory>
+
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-request.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
 #include "sherpa-onnx/jni/common.h"
@@ -382,6 +385,103 @@ Java_com_k2fsa_sherpa_onnx_OfflineTts_generateWithCallbackImpl(
   return obj_arr;
 }
 
+SHERPA_ONNX_EXTERN_C
+JNIEXPORT jobjectArray JNICALL
+Java_com_k2fsa_sherpa_onnx_OfflineTts_generateWithOptionsImpl(
+    JNIEnv *env, jobject /*obj*/, jlong ptr, jstring text, jint sid,
+    jfloat speed, jint priority, jint timeout_ms, jlong token,
+    jobject callback) {
+  const char *p_text = env->GetStringUTFChars(text, nullptr);
+
+  sherpa_onnx::OfflineTtsRequestOptions options;
+  options.priority = priority == 1
+                         ? sherpa_onnx::OfflineTtsPriority::kBatch
+                         : sherpa_onnx::OfflineTtsPriority::kInteractive;
+  options.SetTimeout(timeout_ms);
+  if (token) {
+    options.cancellation = *reinterpret_cast<
+        std::shared_ptr<sherpa_onnx::OfflineTtsCancellationToken> *>(token);
+  }
+
+  sherpa_onnx::GeneratedAudioCallback callback_wrapper;
+  if (callback) {
+    callback_wrapper = [env, callback](const float *samples, int32_t n,
+                                       float /*progress*/) -> int32_t {
+      jclass cls = env->GetObjectClass(callback);
+      jmethodID mid =
+          env->GetMethodID(cls, "invoke", "([F)Ljava/lang/Integer;");
+      if (mid == nullptr) {
+        SHERPA_ONNX_LOGE("Failed to get the callback. Ignore it.");
+        return 1;
+      }
+
+      jfloatArray samples_arr = env->NewFloatArray(n);
+      env->SetFloatArrayRegion(samples_arr, 0, n, samples);
+
+      jobject should_continue =
+          env->CallObjectMethod(callback, mid, samples_arr);
+      jclass jklass = env->GetObjectClass(should_continue);
+      jmethodID int_value_mid = env->GetMethodID(jklass, "intValue", "()I");
+      return env->CallIntMethod(should_continue, int_value_mid);
+    };
+  }
+
+  auto tts = reinterpret_cast<sherpa_onnx::OfflineTts *>(ptr);
+  auto audio = tts->Generate(p_text, sid, speed, callback_wrapper, options);
+
+  jfloatArray samples_arr = env->NewFloatArray(audio.samples.size());
+  env->SetFloatArrayRegion(samples_arr, 0, audio.samples.size(),
+                           audio.samples.data());
+
+  jobjectArray obj_arr = (jobjectArray)env->NewObjectArray(
+      2, env->FindClass("java/lang/Object"), nullptr);
+
+  env->SetObjectArrayElement(obj_arr, 0, samples_arr);
+  env->SetObjectArrayElement(obj_arr, 1, NewInteger(env, audio.sample_rate));
+
+  env->ReleaseStringUTFChars(text, p_text);
+
+  return obj_arr;
+}
+
+SHERPA_ONNX_EXTERN_C
+JNIEXPORT jlong JNICALL
+Java_com_k2fsa_sherpa_onnx_OfflineTtsCancellationToken_newToken(
+    JNIEnv * /*env*/, jobject /*obj*/) {
+  // A running request holds its own reference, so the token can be deleted
+  // while it is in use
+  auto token = new std::shared_ptr<sherpa_onnx::OfflineTtsCancellationToken>(
+      std::make_shared<sherpa_onnx::OfflineTtsCancellationToken>());
+  return (jlong)token;
+}
+
+SHERPA_ONNX_EXTERN_C
+JNIEXPORT void JNICALL
+Java_com_k2fsa_sherpa_onnx_OfflineTtsCancellationToken_cancel(
+    JNIEnv * /*env*/, jobject /*obj*/, jlong ptr) {
+  (*reinterpret_cast<
+       std::shared_ptr<sherpa_onnx::OfflineTtsCancellationToken> *>(ptr))
+      ->Cancel();
+}
+
+SHERPA_ONNX_EXTERN_C
+JNIEXPORT jboolean JNICALL
+Java_com_k2fsa_sherpa_onnx_OfflineTtsCancellationToken_isCancelled(
+    JNIEnv * /*env*/, jobject /*obj*/, jlong ptr) {
+  return (*reinterpret_cast<
+              std::shared_ptr<sherpa_onnx::OfflineTtsCancellationToken> *>(
+              ptr))
+      ->IsCancelled();
+}
+
+SHERPA_ONNX_EXTERN_C
+JNIEXPORT void JNICALL
+Java_com_k2fsa_sherpa_onnx_OfflineTtsCancellationToken_delete(
+    JNIEnv * /*env*/, jobject /*obj*/, jlong ptr) {
+  delete reinterpret_cast<
+      std::shared_ptr<sherpa_onnx::OfflineTtsCancellationToken> *>(ptr);
+}
+
 SHERPA_ONNX_EXTERN_C
 JNIEXPORT jboolean JNICALL Java_com_k2fsa_sherpa_onnx_GeneratedAudio_saveImpl(
     JNIEnv *env, jobject /*obj*/, jstring filename, jfloatArray samples,
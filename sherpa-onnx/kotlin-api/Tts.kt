@@ -71,6 +71,40 @@ class GeneratedAudio(
     ): Boolean
 }
 
+// Cancel a running generateWithOptions() call from another thread, e.g.,
+// when the client disconnects. Queued work of the call is dropped.
+class OfflineTtsCancellationToken {
+    internal var ptr: Long = newToken()
+
+    fun cancel() = cancel(ptr)
+
+    fun isCancelled() = isCancelled(ptr)
+
+    protected fun finalize() {
+        if (ptr != 0L) {
+            delete(ptr)
+            ptr = 0
+        }
+    }
+
+    fun release() = finalize()
+
+    private external fun newToken(): Long
+    private external fun cancel(ptr: Long)
+    private external fun isCancelled(ptr: Long): Boolean
+    private external fun delete(ptr: Long)
+
+    companion object {
+        init {
+            System.loadLibrary("sherpa-onnx-jni")
+        }
+    }
+}
+
+// Queued work of interactive requests runs before that of batch requests
+const val TTS_PRIORITY_INTERACTIVE = 0
+const val TTS_PRIORITY_BATCH = 1
+
 class OfflineTts(
     assetManager: AssetManager? = null,
     var config: OfflineTtsConfig,
@@ -121,6 +155,35 @@ class OfflineTts(
         )
     }
 
+    // Like generateWithCallback(), but the request has a priority, a
+    // timeout in milliseconds (<= 0 means no timeout) and it can be
+    // cancelled with the given token. The audio generated before the
+    // request is cancelled or times out is returned.
+    fun generateWithOptions(
+        text: String,
+        sid: Int = 0,
+        speed: Float = 1.0f,
+        priority: Int = TTS_PRIORITY_INTERACTIVE,
+        timeoutMs: Int = 0,
+        token: OfflineTtsCancellationToken? = null,
+        callback: ((samples: FloatArray) -> Int)? = null
+    ): GeneratedAudio {
+        val objArray = generateWithOptionsImpl(
+            ptr,
+            text = text,
+            sid = sid,
+            speed = speed,
+            priority = priority,
+            timeoutMs = timeoutMs,
+            token = token?.ptr ?: 0L,
+            callback = callback
+        )
+        return GeneratedAudio(
+            samples = objArray[0] as FloatArray,
+            sampleRate = objArray[1] as Int
+        )
+    }
+
     fun allocate(assetManager: AssetManager? = null) {
         if (ptr == 0L) {
             ptr = if (assetManager != null) {
@@ -179,6 +242,17 @@ class OfflineTts(
         callback: (samples: FloatArray) -> Int
     ): Array<Any>
 
+    private external fun generateWithOptionsImpl(
+        ptr: Long,
+        text: String,
+        sid: Int,
+        speed: Float,
+        priority: Int,
+        timeoutMs: Int,
+        token: Long,
+        callback: ((samples: FloatArray) -> Int)?
+    ): Array<Any>
+
     companion object {
         init {
             System.loadLibrary("sherpa-onnx-jni")
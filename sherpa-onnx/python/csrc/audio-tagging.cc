@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/audio-tagging.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/audio-tagging.h"
 
@@ -82,7 +83,15 @@ void PybindAudioTagging(py::module *m) {
       .def("create_stream", &PyClass::CreateStream,
            py::call_guard<py::gil_scoped_release>())
       .def("compute", &PyClass::Compute, py::arg("s"), py::arg("top_k") = -1,
-           py::call_guard<py::gil_scoped_release>());
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "compute_batch",
+          [](const PyClass &self, std::vector<OfflineStream *> ss,
+             int32_t top_k) {
+            return self.ComputeBatch(ss.data(), ss.size(), top_k);
+          },
+          py::arg("ss"), py::arg("top_k") = -1,
+          py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
@@ -22,6 +22,7 @@ void PybindHomophoneReplacer(py::module *m) {
       .def_readwrite("lexicon", &PyClass::lexicon)
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("debug", &PyClass::debug)
+      .def_readwrite("cache_size", &PyClass::cache_size)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -45,7 +45,9 @@ void PybindOfflinePunctuation(py::module *m) {
       .def(py::init<const OfflinePunctuationConfig &>(), py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
       .def("add_punctuation", &PyClass::AddPunctuation, py::arg("text"),
-           py::call_guard<py::gil_scoped_release>());
+           py::call_guard<py::gil_scoped_release>())
+      .def("add_punctuation_batch", &PyClass::AddPunctuationBatch,
+           py::arg("texts"), py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
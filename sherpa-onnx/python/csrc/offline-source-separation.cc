@@ -18,9 +18,15 @@ static void PybindOfflineSourceSeparationConfig(py::module *m) {
 
   using PyClass = OfflineSourceSeparationConfig;
   py::class_<PyClass>(*m, "OfflineSourceSeparationConfig")
-      .def(py::init<const OfflineSourceSeparationModelConfig &>(),
-           py::arg("model") = OfflineSourceSeparationModelConfig{})
+      .def(py::init<const OfflineSourceSeparationModelConfig &, float, float,
+                    int32_t>(),
+           py::arg("model") = OfflineSourceSeparationModelConfig{},
+           py::arg("chunk_size") = 0, py::arg("chunk_overlap") = 1,
+           py::arg("num_chunk_workers") = 1)
       .def_readwrite("model", &PyClass::model)
+      .def_readwrite("chunk_size", &PyClass::chunk_size)
+      .def_readwrite("chunk_overlap", &PyClass::chunk_overlap)
+      .def_readwrite("num_chunk_workers", &PyClass::num_chunk_workers)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -78,7 +84,10 @@ void PybindOfflineSourceSeparation(py::module *m) {
       .def(
           "process",
           [](const PyClass &self, int32_t sample_rate,
-             const py::array_t<float> &samples) {
+             const py::array_t<float> &samples,
+             std::function<int32_t(const OfflineSourceSeparationOutput &,
+                                   float)>
+                 callback) {
             if (!(C_CONTIGUOUS == (samples.flags() & C_CONTIGUOUS))) {
               throw py::value_error(
                   "input samples should be contiguous. Please use "
@@ -123,11 +132,24 @@ void PybindOfflineSourceSeparation(py::module *m) {
 
             pybind11::gil_scoped_release release;
 
-            return self.Process(input);
+            if (!callback) {
+              return self.Process(input);
+            }
+
+            OfflineSourceSeparationCallback callback_wrapper =
+                [callback](const OfflineSourceSeparationOutput &output,
+                           float progress) {
+                  pybind11::gil_scoped_acquire acquire;
+                  return callback(output, progress);
+                };
+
+            return self.Process(input, callback_wrapper);
           },
           py::arg("sample_rate"), py::arg("samples"),
+          py::arg("callback") = py::none(),
           "samples is of shape (num_channels, num-samples) with dtype "
-          "np.float32");
+          "np.float32. If callback is not None, it is called with each "
+          "piece of separated audio and the returned output is empty.");
 }
 
 }  // namespace sherpa_onnx
@@ -37,6 +37,7 @@ void PybindOfflineTtsModelConfig(py::module *m) {
       .def_readwrite("num_threads", &PyClass::num_threads)
       .def_readwrite("debug", &PyClass::debug)
       .def_readwrite("provider", &PyClass::provider)
+      .def_readwrite("session_config", &PyClass::session_config)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -16,10 +16,12 @@ void PybindOfflineTtsVitsModelConfig(py::module *m) {
   py::class_<PyClass>(*m, "OfflineTtsVitsModelConfig")
       .def(py::init<>())
       .def(py::init<const std::string &, const std::string &,
+                    const std::string &, const std::string &,
                     const std::string &, const std::string &,
                     const std::string &, float, float, float>(),
            py::arg("model"), py::arg("lexicon"), py::arg("tokens"),
            py::arg("data_dir") = "", py::arg("dict_dir") = "",
+           py::arg("ja_bert_model") = "", py::arg("vocab") = "",
            py::arg("noise_scale") = 0.667, py::arg("noise_scale_w") = 0.8,
            py::arg("length_scale") = 1.0)
       .def_readwrite("model", &PyClass::model)
@@ -30,6 +32,8 @@ void PybindOfflineTtsVitsModelConfig(py::module *m) {
       .def_readwrite("noise_scale", &PyClass::noise_scale)
       .def_readwrite("noise_scale_w", &PyClass::noise_scale_w)
       .def_readwrite("length_scale", &PyClass::length_scale)
+      .def_readwrite("ja_bert_model", &PyClass::ja_bert_model)
+      .def_readwrite("vocab", &PyClass::vocab)
       .def("__str__", &PyClass::ToString)
       .def("validate", &PyClass::Validate);
 }
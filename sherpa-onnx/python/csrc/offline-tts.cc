@@ -17,6 +17,7 @@ static void PybindGeneratedAudio(py::module *m) {
       .def(py::init<>())
       .def_readwrite("samples", &PyClass::samples)
       .def_readwrite("sample_rate", &PyClass::sample_rate)
+      .def_readwrite("trace", &PyClass::trace)
       .def("__str__", [](PyClass &self) {
         std::ostringstream os;
         os << "GeneratedAudio(sample_rate=" << self.sample_rate << ", ";
@@ -41,6 +42,8 @@ static void PybindOfflineTtsConfig(py::module *m) {
       .def_readwrite("rule_fars", &PyClass::rule_fars)
       .def_readwrite("max_num_sentences", &PyClass::max_num_sentences)
       .def_readwrite("silence_scale", &PyClass::silence_scale)
+      .def_readwrite("sentence_pipeline", &PyClass::sentence_pipeline)
+      .def_readwrite("coalesce_requests", &PyClass::coalesce_requests)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
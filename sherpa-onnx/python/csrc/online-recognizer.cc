@@ -45,6 +45,10 @@ static void PybindOnlineRecognizerResult(py::module *m) {
           [](PyClass &self) -> std::vector<int32_t> { return self.words; })
       .def_property_readonly(
           "is_final", [](PyClass &self) -> bool { return self.is_final; })
+      .def_property_readonly("num_provisional_tokens",
+                             [](PyClass &self) -> int32_t {
+                               return self.num_provisional_tokens;
+                             })
       .def("__str__", &PyClass::AsJsonString,
            py::call_guard<py::gil_scoped_release>())
       .def("as_json_string", &PyClass::AsJsonString,
@@ -85,6 +89,13 @@ static void PybindOnlineRecognizerConfig(py::module *m) {
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
       .def_readwrite("reset_encoder", &PyClass::reset_encoder)
+      .def_readwrite("speculative_decoding", &PyClass::speculative_decoding)
+      .def_readwrite("speculative_min_frames",
+                     &PyClass::speculative_min_frames)
+      .def_readwrite("decoder_out_cache_size",
+                     &PyClass::decoder_out_cache_size)
+      .def_readwrite("precompute_decoder_out",
+                     &PyClass::precompute_decoder_out)
       .def_readwrite("hr", &PyClass::hr)
       .def("__str__", &PyClass::ToString);
 }
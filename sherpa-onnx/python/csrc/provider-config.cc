@@ -9,6 +9,7 @@
 
 #include "sherpa-onnx/csrc/provider-config.h"
 #include "sherpa-onnx/python/csrc/cuda-config.h"
+#include "sherpa-onnx/python/csrc/session-config.h"
 #include "sherpa-onnx/python/csrc/tensorrt-config.h"
 
 namespace sherpa_onnx {
@@ -16,6 +17,7 @@ namespace sherpa_onnx {
 void PybindProviderConfig(py::module *m) {
   PybindCudaConfig(m);
   PybindTensorrtConfig(m);
+  PybindSessionConfig(m);
 
   using PyClass = ProviderConfig;
   py::class_<PyClass>(*m, "ProviderConfig")
@@ -31,6 +33,7 @@ void PybindProviderConfig(py::module *m) {
            py::arg("device") = 0)
       .def_readwrite("trt_config", &PyClass::trt_config)
       .def_readwrite("cuda_config", &PyClass::cuda_config)
+      .def_readwrite("session_config", &PyClass::session_config)
       .def_readwrite("provider", &PyClass::provider)
       .def_readwrite("device", &PyClass::device)
       .def("__str__", &PyClass::ToString)
@@ -0,0 +1,38 @@
+// sherpa-onnx/python/csrc/session-config.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/session-config.h"
+
+#include <string>
+
+#include "sherpa-onnx/csrc/provider-config.h"
+
+namespace sherpa_onnx {
+
+void PybindSessionConfig(py::module *m) {
+  using PyClass = SessionConfig;
+  py::class_<PyClass>(*m, "SessionConfig")
+      .def(py::init<>())
+      .def(py::init<const std::string &, const std::string &, int32_t,
+                    int32_t, bool, const std::string &, const std::string &>(),
+           py::arg("graph_optimization_level") = "all",
+           py::arg("optimized_model_cache_dir") = "",
+           py::arg("intra_op_num_threads") = 0,
+           py::arg("inter_op_num_threads") = 0,
+           py::arg("allow_spinning") = true, py::arg("thread_affinity") = "",
+           py::arg("profile_prefix") = "")
+      .def_readwrite("graph_optimization_level",
+                     &PyClass::graph_optimization_level)
+      .def_readwrite("optimized_model_cache_dir",
+                     &PyClass::optimized_model_cache_dir)
+      .def_readwrite("intra_op_num_threads", &PyClass::intra_op_num_threads)
+      .def_readwrite("inter_op_num_threads", &PyClass::inter_op_num_threads)
+      .def_readwrite("allow_spinning", &PyClass::allow_spinning)
+      .def_readwrite("thread_affinity", &PyClass::thread_affinity)
+      .def_readwrite("profile_prefix", &PyClass::profile_prefix)
+      .def("__str__", &PyClass::ToString)
+      .def("validate", &PyClass::Validate);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/session-config.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_SESSION_CONFIG_H_
+#define SHERPA_ONNX_PYTHON_CSRC_SESSION_CONFIG_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindSessionConfig(py::module *m);
+
+}
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_SESSION_CONFIG_H_
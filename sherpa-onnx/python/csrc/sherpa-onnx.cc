@@ -29,6 +29,7 @@
 #include "sherpa-onnx/python/csrc/speaker-embedding-extractor.h"
 #include "sherpa-onnx/python/csrc/speaker-embedding-manager.h"
 #include "sherpa-onnx/python/csrc/spoken-language-identification.h"
+#include "sherpa-onnx/python/csrc/trace.h"
 #include "sherpa-onnx/python/csrc/vad-model-config.h"
 #include "sherpa-onnx/python/csrc/vad-model.h"
 #include "sherpa-onnx/python/csrc/voice-activity-detector.h"
@@ -50,6 +51,7 @@ PYBIND11_MODULE(_sherpa_onnx, m) {
   m.doc() = "pybind11 binding of sherpa-onnx";
 
   PybindWaveWriter(&m);
+  PybindTrace(&m);
   PybindAudioTagging(&m);
   PybindOfflinePunctuation(&m);
   PybindOnlinePunctuation(&m);
@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/spoken-language-identification.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
 
@@ -54,7 +55,13 @@ void PybindSpokenLanguageIdentification(py::module *m) {
       .def("create_stream", &PyClass::CreateStream,
            py::call_guard<py::gil_scoped_release>())
       .def("compute", &PyClass::Compute, py::arg("s"),
-           py::call_guard<py::gil_scoped_release>());
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "compute_batch",
+          [](const PyClass &self, std::vector<OfflineStream *> ss) {
+            return self.ComputeBatch(ss.data(), ss.size());
+          },
+          py::arg("ss"), py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
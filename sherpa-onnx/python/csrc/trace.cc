@@ -0,0 +1,36 @@
+// sherpa-onnx/python/csrc/trace.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/trace.h"
+
+#include <string>
+
+#include "sherpa-onnx/csrc/trace.h"
+
+namespace sherpa_onnx {
+
+void PybindTrace(py::module *m) {
+  m->def(
+      "enable_tracing",
+      [](bool record_events) { Tracer::Get().Enable(record_events); },
+      py::arg("record_events") = false);
+
+  m->def("disable_tracing", []() { Tracer::Get().Disable(); });
+
+  m->def("reset_tracing", []() { Tracer::Get().Reset(); });
+
+  // Return a JSON string. Use json.loads() to convert it to a dict
+  m->def("get_trace_stats", []() -> std::string {
+    return Tracer::Get().ToJson();
+  });
+
+  m->def(
+      "write_chrome_trace",
+      [](const std::string &filename) -> bool {
+        return Tracer::Get().WriteChromeTrace(filename);
+      },
+      py::arg("filename"));
+}
+
+}  // namespace sherpa_onnx
@@ -49,6 +49,11 @@ from _sherpa_onnx import (
     VadModel,
     VadModelConfig,
     VoiceActivityDetector,
+    disable_tracing,
+    enable_tracing,
+    get_trace_stats,
+    reset_tracing,
+    write_chrome_trace,
     write_wave,
 )
 